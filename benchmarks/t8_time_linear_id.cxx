@@ -0,0 +1,289 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <sc_flops.h>
+#include <sc_functions.h>
+#include <sc_options.h>
+#include <sc_statistics.h>
+
+#include <t8.h>
+#include <t8_schemes/t8_default/t8_default_tri/t8_dtri_bits.h>
+#include <t8_schemes/t8_default/t8_default_tri/t8_dtri_connectivity.h>
+#include <t8_schemes/t8_default/t8_default_tet/t8_dtet_bits.h>
+#include <t8_schemes/t8_default/t8_default_tet/t8_dtet_connectivity.h>
+#include <t8_schemes/t8_default/t8_default_pyramid/t8_dpyramid_bits.h>
+#include <t8_schemes/t8_default/t8_default_pyramid/t8_dpyramid_connectivity.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+/* This file benchmarks the computation of linear ids of triangles, tetrahedra and pyramids
+ * and the initialization of these elements from their linear ids. The default schemes look up
+ * the local indices, cube-ids and types of several levels at once in multi-level tables.
+ * We compare them to the reference implementations in this file, which traverse
+ * the elements level by level with the single-level connectivity tables.
+ * For pyramids, the reference implementation of the linear id walks through the parents.
+ * All throughputs are reported in million elements per second.
+ */
+
+/* Compute the linear id of a triangle or tetrahedron level by level. */
+template <int dim, typename element_t>
+static t8_linearidx_t
+t8_time_linear_id_reference (const element_t *t, int level, const int maxlevel, const int num_types,
+                             const int *cid_type_to_parenttype, const int *type_cid_to_Iloc)
+{
+  const int num_children = 1 << dim;
+  t8_linearidx_t id = 0;
+  int exponent = 0;
+  int type = t->type;
+  int cid;
+
+  /* Compute the cube-id of the ancestor of t of level i. */
+  auto cube_id = [&] (const int i) {
+    const int h = 1 << (maxlevel - i);
+    int cube_id = ((t->x & h) ? 1 : 0) | ((t->y & h) ? 2 : 0);
+    if constexpr (dim == 3) {
+      cube_id |= (t->z & h) ? 4 : 0;
+    }
+    return cube_id;
+  };
+
+  if (level > t->level) {
+    exponent = (level - t->level) * dim;
+    level = t->level;
+  }
+  /* Compute the type of the ancestor of t of level level */
+  for (int i = t->level; i > level; i--) {
+    type = cid_type_to_parenttype[cube_id (i) * num_types + type];
+  }
+  for (int i = level; i > 0; i--) {
+    cid = cube_id (i);
+    id |= ((t8_linearidx_t) type_cid_to_Iloc[type * num_children + cid]) << exponent;
+    exponent += dim;
+    type = cid_type_to_parenttype[cid * num_types + type];
+  }
+  return id;
+}
+
+/* Initialize a triangle or tetrahedron from its linear id level by level. */
+template <int dim, typename element_t>
+static void
+t8_time_init_linear_id_reference (element_t *t, const t8_linearidx_t id, const int level, const int maxlevel,
+                                  const int *parenttype_Iloc_to_cid, const int *parenttype_Iloc_to_type)
+{
+  const int num_children = 1 << dim;
+  int type = 0;
+
+  t->level = level;
+  t->x = 0;
+  t->y = 0;
+  if constexpr (dim == 3) {
+    t->z = 0;
+  }
+  for (int i = 1; i <= level; i++) {
+    const int offset_coords = maxlevel - i;
+    const int local_index = (id >> (dim * (level - i))) & (num_children - 1);
+    const int cid = parenttype_Iloc_to_cid[type * num_children + local_index];
+    type = parenttype_Iloc_to_type[type * num_children + local_index];
+    t->x |= (cid & 1) ? 1 << offset_coords : 0;
+    t->y |= (cid & 2) ? 1 << offset_coords : 0;
+    if constexpr (dim == 3) {
+      t->z |= (cid & 4) ? 1 << offset_coords : 0;
+    }
+  }
+  t->type = type;
+}
+
+/* Compute the linear id of a pyramid by walking through its parents. */
+static t8_linearidx_t
+t8_time_pyramid_linear_id_reference (const t8_dpyramid_t *p, const int level)
+{
+  t8_linearidx_t id = 0, sum_1 = 1, sum_2 = 1;
+  t8_dpyramid_t parent, copy;
+
+  t8_dpyramid_copy (p, &copy);
+  copy.pyramid.type = t8_dpyramid_type_at_level (p, level);
+  copy.pyramid.level = level;
+  for (int i = level; i > 0; i--) {
+    const t8_linearidx_t pyra_shift = (sum_1 << 1) - sum_2;
+    t8_dpyramid_parent (&copy, &parent);
+    const int local_id = t8_dpyramid_child_id (&copy);
+    int num_pyra = 0;
+    if (t8_dpyramid_shape (&parent) == T8_ECLASS_PYRAMID) {
+      num_pyra = t8_dpyramid_parenttype_iloc_pyra_w_lower_id[parent.pyramid.type - T8_DPYRAMID_FIRST_TYPE][local_id];
+    }
+    id += num_pyra * pyra_shift + (local_id - num_pyra) * sum_1;
+    t8_dpyramid_copy (&parent, &copy);
+    sum_1 <<= 3;
+    sum_2 *= 6;
+  }
+  return id;
+}
+
+/* Measure the throughput of a kernel that is applied to all ids, print it and store it in a statistics entry.
+ * The kernel returns a value that is accumulated into a checksum, such that the computation is not optimized away. */
+template <typename Kernel>
+static void
+t8_time_linear_id_measure (const std::string &name, const size_t num_ids, const int repetitions,
+                           std::vector<sc_statinfo_t> &stats, std::vector<std::string> &names, Kernel &&kernel)
+{
+  sc_flopinfo_t fi, snapshot;
+  uint64_t checksum = 0;
+
+  sc_flops_start (&fi);
+  sc_flops_snap (&fi, &snapshot);
+  for (int irep = 0; irep < repetitions; irep++) {
+    for (size_t iid = 0; iid < num_ids; iid++) {
+      checksum += kernel (iid);
+    }
+  }
+  sc_flops_shot (&fi, &snapshot);
+
+  const double mels_per_second = num_ids * repetitions / snapshot.iwtime * 1e-6;
+  names.push_back (name);
+  stats.emplace_back ();
+  t8_global_productionf ("%-36s %10.2f Mels/s (checksum %llu)\n", name.c_str (), mels_per_second,
+                         (unsigned long long) checksum);
+  sc_stats_set1 (&stats.back (), mels_per_second, names.back ().c_str ());
+}
+
+/* Benchmark triangles or tetrahedra at a given level. */
+template <int dim, typename element_t>
+static void
+t8_time_linear_id_simplex (const char *name, const int level, const int maxlevel, const int num_types,
+                           const std::vector<t8_linearidx_t> &ids, const int repetitions,
+                           std::vector<sc_statinfo_t> &stats, std::vector<std::string> &names,
+                           t8_linearidx_t (*linear_id) (const element_t *, int),
+                           void (*init_linear_id) (element_t *, t8_linearidx_t, int),
+                           const int *cid_type_to_parenttype, const int *type_cid_to_Iloc,
+                           const int *parenttype_Iloc_to_cid, const int *parenttype_Iloc_to_type)
+{
+  const std::string prefix = std::string (name) + " level " + std::to_string (level) + " ";
+  std::vector<element_t> elements (ids.size ());
+
+  t8_time_linear_id_measure (prefix + "init_linear_id", ids.size (), repetitions, stats, names, [&] (size_t iid) {
+    init_linear_id (&elements[iid], ids[iid], level);
+    return (uint64_t) elements[iid].type;
+  });
+  t8_time_linear_id_measure (prefix + "init_linear_id reference", ids.size (), repetitions, stats, names,
+                             [&] (size_t iid) {
+                               t8_time_init_linear_id_reference<dim> (&elements[iid], ids[iid], level, maxlevel,
+                                                                      parenttype_Iloc_to_cid, parenttype_Iloc_to_type);
+                               return (uint64_t) elements[iid].type;
+                             });
+  /* The id at a coarser level additionally requires the type of the ancestor of that level. */
+  for (const int id_level : { level, level / 2 }) {
+    const std::string level_name = id_level == level ? "" : " of ancestor";
+    t8_time_linear_id_measure (prefix + "linear_id" + level_name, ids.size (), repetitions, stats, names,
+                               [&] (size_t iid) { return (uint64_t) linear_id (&elements[iid], id_level); });
+    t8_time_linear_id_measure (prefix + "linear_id" + level_name + " reference", ids.size (), repetitions, stats,
+                               names, [&] (size_t iid) {
+                                 return (uint64_t) t8_time_linear_id_reference<dim> (
+                                   &elements[iid], id_level, maxlevel, num_types, cid_type_to_parenttype,
+                                   type_cid_to_Iloc);
+                               });
+  }
+}
+
+int
+main (int argc, char **argv)
+{
+  int mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  int helpme;
+  int level;
+  int num_ids;
+  int repetitions;
+
+  sc_options_t *opt = sc_options_new (argv[0]);
+  sc_options_add_switch (opt, 'h', "help", &helpme, "Display a short help message.");
+  sc_options_add_int (opt, 'l', "level", &level, 10, "The refinement level of the elements, at most 21.");
+  sc_options_add_int (opt, 'n', "num-ids", &num_ids, 1 << 18, "The number of elements per repetition.");
+  sc_options_add_int (opt, 'r', "repetitions", &repetitions, 10, "The number of repetitions.");
+
+  const int parsed = sc_options_parse (t8_get_package_id (), SC_LP_ERROR, opt, argc, argv);
+  if (parsed < 0 || helpme || level < 0 || level > T8_DTET_MAXLEVEL || num_ids <= 0 || repetitions <= 0) {
+    t8_global_productionf ("Benchmark the linear ids of triangles, tetrahedra and pyramids.\n");
+    sc_options_print_usage (t8_get_package_id (), SC_LP_ERROR, opt, NULL);
+  }
+  else {
+    std::vector<sc_statinfo_t> stats;
+    std::vector<std::string> names;
+    /* Reserve the names, since sc_stats_set1 stores a pointer to them and they must not move. */
+    stats.reserve (32);
+    names.reserve (32);
+    std::mt19937_64 random_engine (5489u);
+    std::vector<t8_linearidx_t> ids (num_ids);
+
+    /* Triangles */
+    std::uniform_int_distribution<t8_linearidx_t> tri_ids (0, ((t8_linearidx_t) 1 << 2 * level) - 1);
+    for (t8_linearidx_t &id : ids) {
+      id = tri_ids (random_engine);
+    }
+    t8_time_linear_id_simplex<2, t8_dtri_t> ("triangle", level, T8_DTRI_MAXLEVEL, T8_DTRI_NUM_TYPES, ids, repetitions,
+                                             stats, names, t8_dtri_linear_id, t8_dtri_init_linear_id,
+                                             &t8_dtri_cid_type_to_parenttype[0][0], &t8_dtri_type_cid_to_Iloc[0][0],
+                                             &t8_dtri_parenttype_Iloc_to_cid[0][0],
+                                             &t8_dtri_parenttype_Iloc_to_type[0][0]);
+
+    /* Tetrahedra */
+    std::uniform_int_distribution<t8_linearidx_t> tet_ids (0, ((t8_linearidx_t) 1 << 3 * level) - 1);
+    for (t8_linearidx_t &id : ids) {
+      id = tet_ids (random_engine);
+    }
+    t8_time_linear_id_simplex<3, t8_dtet_t> ("tetrahedron", level, T8_DTET_MAXLEVEL, T8_DTET_NUM_TYPES, ids,
+                                             repetitions, stats, names, t8_dtet_linear_id, t8_dtet_init_linear_id,
+                                             &t8_dtet_cid_type_to_parenttype[0][0], &t8_dtet_type_cid_to_Iloc[0][0],
+                                             &t8_dtet_parenttype_Iloc_to_cid[0][0],
+                                             &t8_dtet_parenttype_Iloc_to_type[0][0]);
+
+    /* Pyramids */
+    const t8_linearidx_t num_pyramids = 2 * ((t8_linearidx_t) 1 << 3 * level) - sc_intpow64u (6, level);
+    std::uniform_int_distribution<t8_linearidx_t> pyramid_ids (0, num_pyramids - 1);
+    std::vector<t8_dpyramid_t> pyramids (num_ids);
+    for (int iid = 0; iid < num_ids; iid++) {
+      t8_dpyramid_init_linear_id (&pyramids[iid], level, pyramid_ids (random_engine));
+    }
+    const std::string prefix = "pyramid level " + std::to_string (level) + " ";
+    t8_time_linear_id_measure (prefix + "linear_id", num_ids, repetitions, stats, names,
+                               [&] (size_t iid) { return (uint64_t) t8_dpyramid_linear_id (&pyramids[iid], level); });
+    t8_time_linear_id_measure (prefix + "linear_id reference", num_ids, repetitions, stats, names, [&] (size_t iid) {
+      return (uint64_t) t8_time_pyramid_linear_id_reference (&pyramids[iid], level);
+    });
+
+    sc_stats_compute (sc_MPI_COMM_WORLD, stats.size (), stats.data ());
+    sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, stats.size (), stats.data (), 1, 1);
+  }
+
+  sc_options_destroy (opt);
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,237 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <sc_flops.h>
+#include <sc_options.h>
+#include <sc_statistics.h>
+
+#include <t8.h>
+#include <t8_eclass.h>
+#include <t8_element.hxx>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_schemes/t8_default/t8_default_common/t8_default_morton.hxx>
+
+#include <random>
+#include <string>
+#include <vector>
+
+/* This file benchmarks the Morton encoding that computes the linear ids of
+ * quads and hexes. For each implementation of the encoding that the CPU supports,
+ * we measure the throughput of encoding and decoding random coordinates.
+ * Additionally, we measure the linear id computation of the default quad and hex
+ * schemes, which use the implementation that is selected at runtime, and compare it
+ * to the corresponding p4est functions.
+ * All throughputs are reported in million ids per second.
+ */
+
+/* Print the throughput of one measurement and store it in a statistics entry. */
+static void
+t8_time_morton_report (sc_statinfo_t *stats, const char *name, const size_t num_ids, const double time,
+                       const uint64_t checksum)
+{
+  const double mids_per_second = num_ids / time * 1e-6;
+  t8_global_productionf ("%-36s %10.2f Mids/s (checksum %llu)\n", name, mids_per_second,
+                         (unsigned long long) checksum);
+  sc_stats_set1 (stats, mids_per_second, name);
+}
+
+/* Measure the encoding and decoding throughput of one implementation of the Morton encoding
+ * for the coordinates of one element class. */
+static void
+t8_time_morton_kernel (const t8_morton_kernel_t kernel, const t8_eclass_t eclass, const std::vector<uint32_t> &coords,
+                       const int repetitions, std::vector<sc_statinfo_t> &stats, std::vector<std::string> &names)
+{
+  const t8_morton_kernels_t *kernels = t8_morton_get_kernels (kernel);
+  const int dim = t8_eclass_to_dimension[eclass];
+  const size_t num_ids = coords.size () / 3;
+  std::vector<uint64_t> ids (num_ids);
+  sc_flopinfo_t fi, snapshot;
+  uint64_t checksum = 0;
+
+  T8_ASSERT (dim == 2 || dim == 3);
+  sc_flops_start (&fi);
+  sc_flops_snap (&fi, &snapshot);
+  for (int irep = 0; irep < repetitions; irep++) {
+    if (dim == 2) {
+      for (size_t iid = 0; iid < num_ids; iid++) {
+        ids[iid] = kernels->encode_2d (coords[3 * iid], coords[3 * iid + 1]);
+      }
+    }
+    else {
+      for (size_t iid = 0; iid < num_ids; iid++) {
+        ids[iid] = kernels->encode_3d (coords[3 * iid], coords[3 * iid + 1], coords[3 * iid + 2]);
+      }
+    }
+    checksum += ids[irep % num_ids];
+  }
+  sc_flops_shot (&fi, &snapshot);
+  names.push_back (std::string (t8_eclass_to_string[eclass]) + " encode " + t8_morton_kernel_name (kernel));
+  stats.emplace_back ();
+  t8_time_morton_report (&stats.back (), names.back ().c_str (), num_ids * repetitions, snapshot.iwtime, checksum);
+
+  checksum = 0;
+  sc_flops_snap (&fi, &snapshot);
+  for (int irep = 0; irep < repetitions; irep++) {
+    uint32_t x, y, z = 0;
+    for (size_t iid = 0; iid < num_ids; iid++) {
+      if (dim == 2) {
+        kernels->decode_2d (ids[iid], &x, &y);
+      }
+      else {
+        kernels->decode_3d (ids[iid], &x, &y, &z);
+      }
+      checksum += x ^ y ^ z;
+    }
+  }
+  sc_flops_shot (&fi, &snapshot);
+  names.push_back (std::string (t8_eclass_to_string[eclass]) + " decode " + t8_morton_kernel_name (kernel));
+  stats.emplace_back ();
+  t8_time_morton_report (&stats.back (), names.back ().c_str (), num_ids * repetitions, snapshot.iwtime, checksum);
+}
+
+/* Measure the linear id computation of the default scheme of one element class
+ * and of the corresponding p4est function on elements of a given level. */
+static void
+t8_time_morton_scheme (t8_eclass_scheme_c *ts, const int level, const std::vector<uint64_t> &linear_ids,
+                       const int repetitions, std::vector<sc_statinfo_t> &stats, std::vector<std::string> &names)
+{
+  const size_t num_ids = linear_ids.size ();
+  const std::string eclass_name (t8_eclass_to_string[ts->eclass]);
+  t8_element_array_t elements;
+  std::vector<t8_linearidx_t> ids (num_ids);
+  sc_flopinfo_t fi, snapshot;
+  uint64_t checksum = 0;
+
+  t8_element_array_init_size (&elements, ts, num_ids);
+
+  /* Decode: Set the elements from their linear ids. */
+  sc_flops_start (&fi);
+  sc_flops_snap (&fi, &snapshot);
+  for (int irep = 0; irep < repetitions; irep++) {
+    for (size_t iid = 0; iid < num_ids; iid++) {
+      ts->t8_element_set_linear_id (t8_element_array_index_locidx_mutable (&elements, iid), level, linear_ids[iid]);
+    }
+    checksum += ts->t8_element_level (t8_element_array_index_locidx (&elements, irep % num_ids));
+  }
+  sc_flops_shot (&fi, &snapshot);
+  names.push_back (eclass_name + " t8_element_set_linear_id");
+  stats.emplace_back ();
+  t8_time_morton_report (&stats.back (), names.back ().c_str (), num_ids * repetitions, snapshot.iwtime, checksum);
+
+  /* Encode: Compute the linear ids of the elements. */
+  checksum = 0;
+  sc_flops_snap (&fi, &snapshot);
+  for (int irep = 0; irep < repetitions; irep++) {
+    ts->t8_element_linear_ids_of_array (&elements, 0, num_ids, level, ids.data ());
+    checksum += ids[irep % num_ids];
+  }
+  sc_flops_shot (&fi, &snapshot);
+  names.push_back (eclass_name + " t8_element_linear_ids_of_array");
+  stats.emplace_back ();
+  t8_time_morton_report (&stats.back (), names.back ().c_str (), num_ids * repetitions, snapshot.iwtime, checksum);
+
+  /* The same with the p4est functions. */
+  checksum = 0;
+  sc_flops_snap (&fi, &snapshot);
+  for (int irep = 0; irep < repetitions; irep++) {
+    for (size_t iid = 0; iid < num_ids; iid++) {
+      const t8_element_t *element = t8_element_array_index_locidx (&elements, iid);
+      ids[iid] = ts->eclass == T8_ECLASS_QUAD ? p4est_quadrant_linear_id ((const p4est_quadrant_t *) element, level)
+                                              : p8est_quadrant_linear_id ((const p8est_quadrant_t *) element, level);
+    }
+    checksum += ids[irep % num_ids];
+  }
+  sc_flops_shot (&fi, &snapshot);
+  names.push_back (eclass_name + (ts->eclass == T8_ECLASS_QUAD ? " p4est" : " p8est") + "_quadrant_linear_id");
+  stats.emplace_back ();
+  t8_time_morton_report (&stats.back (), names.back ().c_str (), num_ids * repetitions, snapshot.iwtime, checksum);
+
+  t8_element_array_reset (&elements);
+}
+
+int
+main (int argc, char **argv)
+{
+  int mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  int helpme;
+  int num_ids;
+  int repetitions;
+
+  sc_options_t *opt = sc_options_new (argv[0]);
+  sc_options_add_switch (opt, 'h', "help", &helpme, "Display a short help message.");
+  sc_options_add_int (opt, 'n', "num-ids", &num_ids, 1 << 20, "The number of ids that are encoded per repetition.");
+  sc_options_add_int (opt, 'r', "repetitions", &repetitions, 20, "The number of repetitions.");
+
+  const int parsed = sc_options_parse (t8_get_package_id (), SC_LP_ERROR, opt, argc, argv);
+  if (parsed < 0 || helpme || num_ids <= 0 || repetitions <= 0) {
+    t8_global_productionf ("Benchmark the Morton encoding of quad and hex linear ids.\n");
+    sc_options_print_usage (t8_get_package_id (), SC_LP_ERROR, opt, NULL);
+  }
+  else {
+    t8_global_productionf ("Selected Morton implementation: %s\n", t8_morton_kernel_name (t8_morton_kernel_select ()));
+    std::vector<sc_statinfo_t> stats;
+    std::vector<std::string> names;
+    /* Reserve the names, since sc_stats_set1 stores a pointer to them and they must not move. */
+    stats.reserve (32);
+    names.reserve (32);
+
+    t8_scheme_cxx_t *scheme = t8_scheme_new_default_cxx ();
+    const t8_eclass_t eclasses[2] = { T8_ECLASS_QUAD, T8_ECLASS_HEX };
+    for (const t8_eclass_t eclass : eclasses) {
+      /* The finest level whose linear ids are supported by both the quad and hex scheme. */
+      const int level = eclass == T8_ECLASS_QUAD ? P4EST_QMAXLEVEL : P8EST_OLD_QMAXLEVEL;
+      const int dim = t8_eclass_to_dimension[eclass];
+      std::mt19937_64 random_engine (5489u);
+      std::vector<uint32_t> coords (3 * (size_t) num_ids);
+      std::vector<uint64_t> linear_ids (num_ids);
+      for (size_t iid = 0; iid < (size_t) num_ids; iid++) {
+        for (int icoord = 0; icoord < 3; icoord++) {
+          coords[3 * iid + icoord] = icoord < dim ? (uint32_t) random_engine () & ((1u << level) - 1) : 0;
+        }
+        linear_ids[iid] = random_engine () & (((uint64_t) 1 << dim * level) - 1);
+      }
+      for (int ikernel = 0; ikernel < T8_MORTON_KERNEL_COUNT; ikernel++) {
+        const t8_morton_kernel_t kernel = (t8_morton_kernel_t) ikernel;
+        if (t8_morton_kernel_is_supported (kernel)) {
+          t8_time_morton_kernel (kernel, eclass, coords, repetitions, stats, names);
+        }
+      }
+      t8_time_morton_scheme (scheme->eclass_schemes[eclass], level, linear_ids, repetitions, stats, names);
+    }
+    sc_stats_compute (sc_MPI_COMM_WORLD, stats.size (), stats.data ());
+    sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, stats.size (), stats.data (), 1, 1);
+    t8_scheme_cxx_unref (&scheme);
+  }
+
+  sc_options_destroy (opt);
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
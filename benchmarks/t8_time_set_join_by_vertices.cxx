@@ -20,6 +20,7 @@
   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 */
 
+#include <sys/stat.h>
 #include <sc_flops.h>
 #include <sc_options.h>
 #include <sc_statistics.h>
@@ -37,6 +38,11 @@
  * `t8_cmesh_readmshfile` routine. Up to now, the latter is much faster. In the
  * future, `t8_set_join_by_vertices` may be optimized to close up to the reader
  * in terms of speed.
+ * For the reader, we also report the parsing throughput in megabytes and trees per second,
+ * which allows to compare ASCII and binary mesh files.
+ * To measure the scaling of `t8_cmesh_set_join_by_vertices_parallel`, each process
+ * passes an equal share of the trees and the timings are reported for the number
+ * of processes in the communicator.
  */
 
 static void
@@ -90,6 +96,72 @@ test_with_cmesh (t8_cmesh_t cmesh)
   T8_FREE (all_eclasses);
 }
 
+static void
+test_with_cmesh_parallel (t8_cmesh_t cmesh, sc_MPI_Comm comm)
+{
+  const t8_locidx_t ntrees = t8_cmesh_get_num_local_trees (cmesh);
+  int mpirank, mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  /* Each process takes an equal share of the trees. */
+  const t8_gloidx_t first_tree = (t8_gloidx_t) ntrees * mpirank / mpisize;
+  const t8_locidx_t num_local_trees = (t8_gloidx_t) ntrees * (mpirank + 1) / mpisize - first_tree;
+
+  t8_global_productionf ("ntrees = %d, processes = %d.\n", ntrees, mpisize);
+
+  /* Arrays for the face connectivity computations via vertices. */
+  double *local_verts = T8_ALLOC (double, num_local_trees *T8_ECLASS_MAX_CORNERS *T8_ECLASS_MAX_DIM);
+  t8_eclass_t *local_eclasses = T8_ALLOC (t8_eclass_t, num_local_trees);
+
+  /* Retrieve the local tree vertices and element classes and store them into arrays. */
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    t8_eclass_t eclass = t8_cmesh_get_tree_class (cmesh, first_tree + itree);
+    local_eclasses[itree] = eclass;
+
+    const double *vertices = t8_cmesh_get_tree_vertices (cmesh, first_tree + itree);
+
+    const int nverts = t8_eclass_num_vertices[eclass];
+
+    for (int ivert = 0; ivert < nverts; ivert++) {
+      for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+        local_verts[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)]
+          = vertices[T8_2D_TO_1D (nverts, T8_ECLASS_MAX_DIM, ivert, icoord)];
+      }
+    }
+  }
+
+  t8_cmesh_t cmesh_partitioned;
+  t8_cmesh_init (&cmesh_partitioned);
+
+  sc_flopinfo_t fi, snapshot;
+  sc_statinfo_t stats[2];
+
+  /* Start timer */
+  sc_flops_start (&fi);
+  sc_flops_snap (&fi, &snapshot);
+
+  /* Compute face connectivity. */
+  t8_cmesh_set_join_by_vertices_parallel (cmesh_partitioned, first_tree, num_local_trees, local_eclasses, local_verts,
+                                          comm);
+
+  /* Measure passed time. */
+  sc_flops_shot (&fi, &snapshot);
+  sc_stats_set1 (&stats[0], snapshot.iwtime, "t8_cmesh_set_join_by_vertices_parallel");
+  sc_stats_set1 (&stats[1], num_local_trees / snapshot.iwtime, "t8_cmesh_set_join_by_vertices_parallel trees/s");
+
+  /* Print stats. */
+  sc_stats_compute (comm, 2, stats);
+  sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, 2, stats, 1, 1);
+
+  t8_cmesh_destroy (&cmesh_partitioned);
+  T8_FREE (local_verts);
+  T8_FREE (local_eclasses);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -118,6 +190,7 @@ main (int argc, char **argv)
   t8_init (SC_LP_DEFAULT);
 
   int helpme;
+  int skip_serial;
 
   const char *meshfile;
 
@@ -125,6 +198,8 @@ main (int argc, char **argv)
   sc_options_t *opt = sc_options_new (argv[0]);
   sc_options_add_switch (opt, 'h', "help", &helpme, "Display a short help message.");
   sc_options_add_string (opt, 'f', "fileprefix", &meshfile, NULL, "File prefix of the mesh file (without .msh)");
+  sc_options_add_switch (opt, 's', "skip-serial", &skip_serial,
+                         "Only run the parallel version. Use this for large meshes and many processes.");
 
   int parsed = sc_options_parse (t8_get_package_id (), SC_LP_ERROR, opt, argc, argv);
 
@@ -140,7 +215,9 @@ main (int argc, char **argv)
 
     {
       sc_flopinfo_t fi, snapshot;
-      sc_statinfo_t stats[1];
+      sc_statinfo_t stats[3];
+      char filename[BUFSIZ];
+      struct stat file_stat;
 
       /* Start timer */
       sc_flops_start (&fi);
@@ -150,13 +227,27 @@ main (int argc, char **argv)
 
       /* Measure passed time. */
       sc_flops_shot (&fi, &snapshot);
+      SC_CHECK_ABORT (cmesh != NULL, "Could not read the mesh file.");
+
+      /* Compute the parsing throughput */
+      snprintf (filename, BUFSIZ, "%s.msh", meshfile);
+      const double megabytes = stat (filename, &file_stat) == 0 ? file_stat.st_size / (1024. * 1024.) : 0;
+      const double num_trees = t8_cmesh_get_num_trees (cmesh);
+      t8_global_productionf ("Read %.2f MB with %.0f trees in %f s: %.2f MB/s, %.0f trees/s\n", megabytes, num_trees,
+                             snapshot.iwtime, megabytes / snapshot.iwtime, num_trees / snapshot.iwtime);
+
       sc_stats_set1 (&stats[0], snapshot.iwtime, "t8_cmesh_from_msh_file");
+      sc_stats_set1 (&stats[1], megabytes / snapshot.iwtime, "t8_cmesh_from_msh_file MB/s");
+      sc_stats_set1 (&stats[2], num_trees / snapshot.iwtime, "t8_cmesh_from_msh_file trees/s");
       /* Print stats. */
-      sc_stats_compute (sc_MPI_COMM_WORLD, 1, stats);
-      sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, 1, stats, 1, 1);
+      sc_stats_compute (sc_MPI_COMM_WORLD, 3, stats);
+      sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, 3, stats, 1, 1);
     }
 
-    test_with_cmesh (cmesh);
+    if (!skip_serial) {
+      test_with_cmesh (cmesh);
+    }
+    test_with_cmesh_parallel (cmesh, sc_MPI_COMM_WORLD);
 
     t8_cmesh_unref (&cmesh);
   }
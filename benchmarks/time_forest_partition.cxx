@@ -283,7 +283,7 @@ t8_time_forest_cmesh_mshfile (t8_cmesh_t cmesh, const char *vtu_prefix, sc_MPI_C
 #undef USE_CMESH_PARTITION
 
 /* Construct a cmesh either from a .msh mesh file or from a
- * collection of cmesh files constructed with t8_cmesh_save.
+ * cmesh file constructed with t8_cmesh_save.
  * If msh_file is NULL, the cmesh is loaded from the cmesh_file and num_files
  * must be specified. If cmesh_file is NULL, the cmesh is loaded from the .msh
  * file and mesh_dim must be specified. */
@@ -312,11 +312,11 @@ t8_time_forest_create_cmesh (const char *msh_file, int mesh_dim, const char *cme
   else {
     T8_ASSERT (cmesh_file != NULL);
     SC_CHECK_ABORT (num_files > 0, "Must specify valid number of files.\n");
-    /* Load the cmesh from the stored files and evenly distribute it
+    /* Load the cmesh from the stored file and evenly distribute it
      * among all ranks */
     cmesh = t8_cmesh_load_and_distribute (cmesh_file, num_files, comm, T8_LOAD_STRIDE, stride);
-    /* Partition only if more than 1 input file */
-    partition = num_files > 1;
+    /* The loaded cmesh is partitioned by trees, we repartition it for the initial level */
+    partition = 1;
   }
   SC_CHECK_ABORT (cmesh != NULL, "Error when creating cmesh.\n");
 
@@ -373,11 +373,11 @@ main (int argc, char *argv[])
                          "The files must end in .msh and be created with gmsh.");
   sc_options_add_int (opt, 'd', "dim", &dim, 2, "Together with -f: The dimension of the coarse mesh. 2 or 3.");
   sc_options_add_string (opt, 'c', "cmeshfile", &cmeshfileprefix, NULL,
-                         "If specified, the cmesh is constructed from a collection of cmesh files. "
-                         "Created with t8_cmesh_save. The number of files must then be specified with the -n option.");
+                         "If specified, the cmesh is loaded from the file <cmeshfile>.cmesh created with "
+                         "t8_cmesh_save. The -n option must then be specified as well.");
   sc_options_add_int (opt, 'n', "nfiles", &num_files, -1,
-                      "If the -c option is used, the number of cmesh files must be specified as an argument here. "
-                      "If n=1 then the cmesh will be replicated throughout the test.");
+                      "If the -c option is used, this argument must be specified. "
+                      "If n=1 then the cmesh will be replicated throughout the test, otherwise it is partitioned.");
   sc_options_add_int (opt, 's', "stride", &stride, 16,
                       "If -c and -n are used, only every s-th MPI rank will read a .cmesh file (file number: rank/s)."
                       "Default is 16.");
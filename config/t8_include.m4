@@ -51,6 +51,9 @@ T8_CHECK_NETCDF([$1])
 T8_CHECK_VTK([$1])
 T8_CHECK_OCC([$1])
 T8_CHECK_CPPSTDLIB([$1])
+dnl The threaded adaptation uses std::thread
+AC_SEARCH_LIBS([pthread_create], [pthread], [],
+               [AC_MSG_ERROR([Unable to find a library providing pthread_create])])
 ])
 AC_DEFUN([T8_CHECK_CPPSTD],[AX_CXX_COMPILE_STDCXX([17],[noext],[mandatory])])
 
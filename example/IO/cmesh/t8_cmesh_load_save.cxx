@@ -38,7 +38,7 @@ t8_cmesh_load_distribute (const char *fileprefix, int num_files, int no_vtk)
     return;
   }
   else {
-    t8_debugf ("Successfully loaded cmesh from %s files\n", fileprefix);
+    t8_debugf ("Successfully loaded cmesh from %s.cmesh\n", fileprefix);
     if (!no_vtk) {
       t8_cmesh_vtk_write_file (cmesh, "cmesh_dist_loaded");
     }
@@ -73,12 +73,12 @@ t8_cmesh_save_cmesh (const char *mshfile, int dim)
   }
   mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
   SC_CHECK_MPI (mpiret);
-  ret = t8_cmesh_save (cmesh, "cmesh_saved");
+  ret = t8_cmesh_save (cmesh, "cmesh_saved", sc_MPI_COMM_WORLD);
   if (ret == 0) {
     t8_errorf ("Error when writing to file\n");
   }
   else {
-    t8_debugf ("Saved cmesh to %s\n", "cmesh_saved_RANK.cmesh");
+    t8_debugf ("Saved cmesh to %s\n", "cmesh_saved.cmesh");
   }
   t8_cmesh_destroy (&cmesh);
 }
@@ -99,9 +99,9 @@ main (int argc, char **argv)
             basename (argv[0]), basename (argv[0]));
   sreturn = snprintf (help, BUFSIZ,
                       "This program has two modes. With argument -f <file> -d <dim> it creates a cmesh, from the "
-                      "file <file>.msh, saves it to a collection of files and loads it again.\n If the -l <string> and"
-                      " -n <num> arguments are given, the cmesh stored in the num files string_0000.cmesh,... ,"
-                      "string_num-1.cmesh are read on n processes and distributed among all processes.\n\n%s\n",
+                      "file <file>.msh and saves it to the file cmesh_saved.cmesh.\n If the -l <string> and"
+                      " -n <num> arguments are given, the cmesh stored in the file string.cmesh is read by all "
+                      "processes. It is replicated if num is 1 and partitioned otherwise.\n\n%s\n",
                       usage);
 
   if (sreturn >= BUFSIZ) {
@@ -120,7 +120,8 @@ main (int argc, char **argv)
   opt = sc_options_new (argv[0]);
   sc_options_add_switch (opt, 'h', "help", &helpme, "Display a short help message.");
   sc_options_add_string (opt, 'l', "load", &loadfile, "", "The prefix of the .cmesh file to load.");
-  sc_options_add_int (opt, 'n', "num-files", &n, -1, "The total number of .cmesh files.");
+  sc_options_add_int (opt, 'n', "num-files", &n, -1,
+                      "1 to load a replicated cmesh, greater 1 to load a partitioned cmesh.");
   sc_options_add_switch (opt, 'o', "no-vtk", &no_vtk, "Do not write vtk output.");
   sc_options_add_string (opt, 'f', "msh-file", &meshfile, "", "The prefix of the .msh file.");
   sc_options_add_int (opt, 'd', "dim", &dim, 2, "The dimension of the msh file.");
@@ -132,6 +132,9 @@ typedef enum {
   T8_MPI_PARTITION_FOREST,              /**< Used for forest partitioning */
   T8_MPI_GHOST_FOREST,                  /**< Used for for ghost layer creation */
   T8_MPI_GHOST_EXC_FOREST,              /**< Used for ghost data exchange */
+  T8_MPI_CMESH_READ_MSH,                /**< Used for the parallel msh file reader */
+  T8_MPI_CMESH_JOIN_BY_VERTICES,        /**< Used for finding face connections by vertices */
+  T8_MPI_BALANCE_FOREST,                /**< Used for exchanging refinements during forest balance */
   T8_MPI_TEST_ELEMENT_PACK_TAG,         /**< Used for testing mpi pack and unpack functionality */
   T8_MPI_TAG_LAST
 } t8_MPI_tag_t;
@@ -419,18 +419,49 @@ t8_cmesh_set_tree_geometry (t8_cmesh_t cmesh, t8_gloidx_t gtreeid, const t8_geom
 void
 t8_cmesh_commit (t8_cmesh_t cmesh, sc_MPI_Comm comm);
 
-/* TODO: Document */
-/* Currently, it is only legal to save cmeshes that use the linear geometry. */
+/** Save a committed cmesh to the file fileprefix.cmesh.
+ * The file is written collectively with MPI I/O and does not depend on the
+ * number of processes or the partition of the cmesh.
+ * The tree classes, face connections, vertices and all attributes except
+ * the geometry are stored. This function is collective.
+ * \param [in] cmesh       A committed cmesh.
+ * \param [in] fileprefix  The prefix of the output file.
+ * \param [in] comm        The communicator the cmesh was committed with.
+ * \return                 True on all processes if the file was written successfully.
+ * \note Currently, it is only legal to save cmeshes that use the linear geometry.
+ */
 int
-t8_cmesh_save (t8_cmesh_t cmesh, const char *fileprefix);
+t8_cmesh_save (t8_cmesh_t cmesh, const char *fileprefix, sc_MPI_Comm comm);
 
-/* TODO: Document */
+/** Load a replicated cmesh from a file written by \ref t8_cmesh_save.
+ * All processes read all trees. This function is collective.
+ * \param [in] filename    The name of the file, i.e. fileprefix.cmesh.
+ * \param [in] comm        The communicator of the new cmesh.
+ * \return                 The committed cmesh, or NULL if the file could not be opened
+ *                         or is not a cmesh file of the current format.
+ */
 t8_cmesh_t
 t8_cmesh_load (const char *filename, sc_MPI_Comm comm);
 
-/* TODO: Document */
-/* procs_per_node is only relevant in mode==JUQUEEN.
- *  num_files = 1 => replicated cmesh is constructed */
+/** Load a cmesh from the file fileprefix.cmesh written by \ref t8_cmesh_save
+ * with any number of processes and partition it uniformly among all processes of \a comm.
+ * A subset of the processes, selected by \a num_files, \a mode and \a procs_per_node,
+ * reads equally sized ranges of trees with collective MPI I/O. If not all processes read,
+ * the trees are then distributed to all processes. The result is always partitioned,
+ * use \ref t8_cmesh_load for a replicated cmesh.
+ * Files written in the old per process format fileprefix_0000.cmesh, ... are rejected
+ * with an error.
+ * This function is collective.
+ * \param [in] fileprefix  The prefix of the file.
+ * \param [in] num_files   The number of processes that read the file, at least 1.
+ *                         The name is kept from the per process format, in which each reading
+ *                         process opened one file.
+ * \param [in] comm        The communicator of the new cmesh.
+ * \param [in] mode        Selects the reading processes, see \ref t8_load_mode_t.
+ * \param [in] procs_per_node The stride between the reading processes in mode \ref T8_LOAD_STRIDE.
+ *                         If not positive, 16 is used. Ignored in the other modes.
+ * \return                 The committed cmesh, or NULL if the file could not be read.
+ */
 t8_cmesh_t
 t8_cmesh_load_and_distribute (const char *fileprefix, int num_files, sc_MPI_Comm comm, t8_load_mode_t mode,
                               int procs_per_node);
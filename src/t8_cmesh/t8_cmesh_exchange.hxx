@@ -0,0 +1,119 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_cmesh_exchange.hxx
+ * Point-to-point exchange of arrays and distribution of face connections, shared by the
+ * algorithms that build partitioned cmeshes without a global view of the trees, such as the
+ * parallel .msh reader and \ref t8_cmesh_set_join_by_vertices_parallel.
+ */
+
+#ifndef T8_CMESH_EXCHANGE_HXX
+#define T8_CMESH_EXCHANGE_HXX
+
+#include <t8_cmesh.h>
+#include <vector>
+
+/** A face connection between two trees, as it is exchanged between the processes. */
+typedef struct
+{
+  t8_gloidx_t gtree_id[2]; /**< The global ids of the two trees. */
+  int32_t iface[2];        /**< The face number of the connection in each tree. */
+  int32_t eclass[2];       /**< The class of each tree. */
+  int32_t rank[2];         /**< The process that owns each tree. */
+  int32_t orientation;     /**< The orientation of the face connection. */
+  int32_t padding;         /**< Unused, keeps the struct free of uninitialized bytes. */
+} t8_cmesh_exchange_join_t;
+
+/** Send a vector of items to each process and receive the items that the other processes send to us.
+ * The items are sent as raw bytes, thus \a T must be trivially copyable.
+ * This function is collective.
+ * \param [in]  send        For each process of \a comm the items that we send to it.
+ * \param [in]  comm        The communicator.
+ * \param [in]  tag         The MPI tag of the messages.
+ * \param [out] recv_counts If not NULL, filled with the number of items received from each process.
+ * \return                  The received items, ordered by the rank of the sender.
+ */
+template <typename T>
+std::vector<T>
+t8_cmesh_exchange (const std::vector<std::vector<T>> &send, sc_MPI_Comm comm, const int tag,
+                   std::vector<int> *recv_counts = NULL)
+{
+  const int mpisize = send.size ();
+  std::vector<int> send_bytes (mpisize), recv_bytes (mpisize);
+  std::vector<size_t> recv_offsets (mpisize + 1, 0);
+  std::vector<sc_MPI_Request> requests;
+  int mpiret;
+
+  for (int iproc = 0; iproc < mpisize; iproc++) {
+    send_bytes[iproc] = send[iproc].size () * sizeof (T);
+  }
+  mpiret = sc_MPI_Alltoall (send_bytes.data (), 1, sc_MPI_INT, recv_bytes.data (), 1, sc_MPI_INT, comm);
+  SC_CHECK_MPI (mpiret);
+  for (int iproc = 0; iproc < mpisize; iproc++) {
+    recv_offsets[iproc + 1] = recv_offsets[iproc] + recv_bytes[iproc] / sizeof (T);
+  }
+  std::vector<T> recv (recv_offsets[mpisize]);
+  requests.reserve (2 * mpisize);
+  for (int iproc = 0; iproc < mpisize; iproc++) {
+    if (recv_bytes[iproc] > 0) {
+      requests.emplace_back ();
+      mpiret = sc_MPI_Irecv (recv.data () + recv_offsets[iproc], recv_bytes[iproc], sc_MPI_BYTE, iproc, tag, comm,
+                             &requests.back ());
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  for (int iproc = 0; iproc < mpisize; iproc++) {
+    if (send_bytes[iproc] > 0) {
+      requests.emplace_back ();
+      mpiret = sc_MPI_Isend (send[iproc].data (), send_bytes[iproc], sc_MPI_BYTE, iproc, tag, comm, &requests.back ());
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  mpiret = sc_MPI_Waitall (requests.size (), requests.data (), sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+  if (recv_counts != NULL) {
+    recv_counts->resize (mpisize);
+    for (int iproc = 0; iproc < mpisize; iproc++) {
+      (*recv_counts)[iproc] = recv_offsets[iproc + 1] - recv_offsets[iproc];
+    }
+  }
+  return recv;
+}
+
+/** Add face connections that were found by a distributed matching to a partitioned cmesh.
+ * Each process passes the connections that involve at least one of its local trees.
+ * The connections of the local trees and the classes of the ghost trees are set.
+ * Afterwards the connections of each local tree are forwarded to the processes that have
+ * it as a ghost, such that they also know the connections between their ghosts.
+ * This function is collective.
+ * \param [in,out] cmesh           The initialized, not yet committed cmesh.
+ * \param [in]     first_tree      The global id of the first local tree.
+ * \param [in]     num_local_trees The number of local trees.
+ * \param [in]     joins           The connections of the local trees.
+ * \param [in]     comm            The communicator of the cmesh.
+ * \param [in]     tag             The MPI tag of the messages.
+ */
+void
+t8_cmesh_exchange_set_joins (t8_cmesh_t cmesh, const t8_gloidx_t first_tree, const t8_locidx_t num_local_trees,
+                             const std::vector<t8_cmesh_exchange_join_t> &joins, sc_MPI_Comm comm, const int tag);
+
+#endif /* !T8_CMESH_EXCHANGE_HXX */
@@ -31,8 +31,158 @@
 #include <t8_cmesh/t8_cmesh_types.h>
 #include <t8_cmesh/t8_cmesh_stash.h>
 #include <t8_cmesh/t8_cmesh_helpers.h>
-#include <vector>
+#include <t8_cmesh/t8_cmesh_exchange.hxx>
+#include <algorithm>
+#include <cfloat>
 #include <map>
+#include <set>
+#include <vector>
+
+/* `T8_JOIN_NUM_BINS` should be more than enough for (almost) all cases.
+ * I.e., 2^P4EST_QMAXLEVEL =~ 1.073e9.
+ */
+#define T8_JOIN_NUM_BINS 1e9
+
+/* The maximum number of hash samples that are gathered on one process to compute the splitters
+ * in t8_cmesh_set_join_by_vertices_parallel. */
+#define T8_JOIN_MAX_SAMPLES (1 << 16)
+
+/* Copy the coordinates of the vertices of a tree face in face vertex order into face_coords,
+ * which has space for T8_ECLASS_MAX_CORNERS_2D * T8_ECLASS_MAX_DIM doubles.
+ * tree_vertices are the T8_ECLASS_MAX_CORNERS * T8_ECLASS_MAX_DIM coordinates of the tree.
+ * Returns the number of face vertices. */
+static int
+t8_cmesh_get_face_coords (const t8_eclass_t eclass, const int iface, const double *tree_vertices, double *face_coords)
+{
+  /* Get the number of vertices per face of this element. */
+  const int nface_verts = t8_eclass_num_vertices[t8_eclass_face_types[eclass][iface]];
+
+  for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
+    /* Map from a face vertex id to the element vertex id. */
+    const int ivert = t8_face_vertex_to_tree_vertex[eclass][iface][iface_vert];
+    for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+      face_coords[T8_2D_TO_1D (nface_verts, T8_ECLASS_MAX_DIM, iface_vert, icoord)]
+        = tree_vertices[T8_2D_TO_1D (T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, ivert, icoord)];
+    }
+  }
+  return nface_verts;
+}
+
+/* Compute the hash key of a tree face. The idea is to convert the rescaled vertices of a tree face to
+ * long integers and add them up. We apply a bit of seeding by also adding `icoord`.
+ * Since the hash does not depend on the order of the vertices, matching faces have the same hash. */
+static uint64_t
+t8_cmesh_face_hash (const double *face_coords, const int nface_verts, const double min_coord,
+                    const double inverse_bin_size)
+{
+  uint64_t hash = 0;
+
+  for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
+    for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+      const double rescaled
+        = (face_coords[T8_2D_TO_1D (nface_verts, T8_ECLASS_MAX_DIM, iface_vert, icoord)] - min_coord)
+          * inverse_bin_size;
+
+      /* Simple hash function. */
+      hash = hash + icoord + static_cast<uint64_t> (rescaled + 0.5);
+    }
+  }
+  return hash;
+}
+
+/* Compare the vertices of two tree faces given by t8_cmesh_get_face_coords.
+ * If all vertices match, return the orientation of the face-to-face connection, otherwise -1. */
+static int
+t8_cmesh_face_orientation_by_coords (const t8_eclass_t eclass, const int iface, const double *face_coords,
+                                     const t8_eclass_t neigh_eclass, const int neigh_iface,
+                                     const double *neigh_face_coords)
+{
+  const int nface_verts = t8_eclass_num_vertices[t8_eclass_face_types[eclass][iface]];
+
+  /* Get the number of vertices per face of potentially neighboring element. */
+  const int neigh_nface_verts = t8_eclass_num_vertices[t8_eclass_face_types[neigh_eclass][neigh_iface]];
+
+  /* If the number of face vertices do not match we can skip. */
+  if (nface_verts != neigh_nface_verts) {
+    return -1;
+  }
+
+  /* The order of the encountered face vertices is needed for computing
+   * the orientation later on. Prepare the array for that here. */
+  int face_vert_order[T8_ECLASS_MAX_EDGES_2D];
+  for (int i = 0; i < T8_ECLASS_MAX_EDGES_2D; i++) {
+    face_vert_order[i] = -1;
+  }
+
+  int match_count = 0; /* This tracks the number of matching vertices. */
+  /* Loop over the vertices of the current element's face. */
+  for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
+    /* Loop over the vertices of the potentially neighboring element's face. */
+    for (int neigh_iface_vert = 0; neigh_iface_vert < neigh_nface_verts; neigh_iface_vert++) {
+      int match_count_per_coord = 0; /* Tracks the matching of x, y and z coordinates of two vertices. */
+      for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+        /* Retrieve the x, y or z component of the face vertex coordinates. */
+        const double face_vert = face_coords[T8_2D_TO_1D (nface_verts, T8_ECLASS_MAX_DIM, iface_vert, icoord)];
+        const double neigh_face_vert
+          = neigh_face_coords[T8_2D_TO_1D (neigh_nface_verts, T8_ECLASS_MAX_DIM, neigh_iface_vert, icoord)];
+
+        /* Compare the coordinates with some tolerance. */
+        if (fabs (face_vert - neigh_face_vert) < 10.0 * T8_PRECISION_EPS) {
+          match_count_per_coord++;
+        }
+      }
+
+      /* In case all x, y and z components match we increase the match_count variable. */
+      if (match_count_per_coord == T8_ECLASS_MAX_DIM) {
+        match_count++;
+        /* Store the encountered face vertex order for later use. */
+        face_vert_order[iface_vert] = neigh_iface_vert;
+        continue;
+      }
+    }
+  }
+
+  /* If the number of matching face vertices is equal to the actual number of the face's vertices
+   * we interpret this as a face-to-face connection between two elements. */
+  if (match_count != nface_verts) {
+    return -1;
+  }
+
+  /* Compute the orientation of the face-to-face connection.
+   * Face corner 0 of the face with the lower face direction connects
+   * to a corner of the other face. The number of this corner is the
+   * orientation code. */
+  int orientation = -1;
+  int smaller_bigger_face_condition = -1;
+
+  const int compare = t8_eclass_compare (eclass, neigh_eclass);
+  if (compare < 0) {
+    /* This tree class is smaller than neigh. tree class. */
+    smaller_bigger_face_condition = 1;
+  }
+  else if (compare > 0) {
+    /* This tree class is bigger than neigh. tree class. */
+    smaller_bigger_face_condition = 0;
+  }
+  else {
+    /* This tree class is the same as the neigh. tree class. 
+       Then the face with the smaller face id is the smaller one. */
+    smaller_bigger_face_condition = iface < neigh_iface;
+  }
+
+  if (smaller_bigger_face_condition) {
+    orientation = face_vert_order[0];
+  }
+  else {
+    for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
+      if (0 == face_vert_order[iface_vert]) {
+        orientation = iface_vert;
+        break;
+      }
+    }
+  }
+  return orientation;
+}
 
 void
 t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const t8_eclass_t *eclasses,
@@ -70,42 +220,23 @@ t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const
   }
 
   /* Setup hash table `faces` mapping a hash key to a pair containing `(itree, iface)`. */
-  std::multimap<unsigned long, std::pair<int, int>> faces;
+  std::multimap<uint64_t, std::pair<int, int>> faces;
 
-  /* `num_bins` should be more than enough for (almost) all cases.
-   * I.e., 2^P4EST_QMAXLEVEL =~ 1.073e9.
-   */
-  const double num_bins = 1e9; /* Number of bins. */
-  const double inverse_bin_size = num_bins / (max_coord - min_coord);
+  const double inverse_bin_size = T8_JOIN_NUM_BINS / (max_coord - min_coord);
 
   for (int itree = 0; itree < ntrees; itree++) {
     const t8_eclass_t eclass = eclasses[itree];
+    const double *tree_vertices
+      = vertices + T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, 0, 0);
 
     /* Get the number of faces of this element. */
     const int nfaces = t8_eclass_num_faces[eclass];
 
     /* Loop over all faces of the current cmesh element. */
     for (int iface = 0; iface < nfaces; iface++) {
-      /* Get the number of vertices per face of this element. */
-      const int nface_verts = t8_eclass_num_vertices[t8_eclass_face_types[eclass][iface]];
-
-      /* Compute the hash key. The idea is to convert the rescaled vertices of a tree face to
-       * long integers and add them up. We apply a bit of seeding by also adding `icoord`. See below. */
-      unsigned long hash = 0;
-
-      /* Loop over the vertices of the current element's face. */
-      for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
-        /* Map from a face vertex id to the element vertex id. */
-        const int ivert = t8_face_vertex_to_tree_vertex[eclass][iface][iface_vert];
-
-        for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
-          const int index = T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord);
-          const double rescaled = (vertices[index] - min_coord) * inverse_bin_size;
-
-          /* Simple hash function. */
-          hash = hash + icoord + static_cast<unsigned long> (rescaled + 0.5);
-        }
-      }
+      double face_coords[T8_ECLASS_MAX_CORNERS_2D * T8_ECLASS_MAX_DIM];
+      const int nface_verts = t8_cmesh_get_face_coords (eclass, iface, tree_vertices, face_coords);
+      const uint64_t hash = t8_cmesh_face_hash (face_coords, nface_verts, min_coord, inverse_bin_size);
 
       /* Loop over all pre-registered faces with the same hash. */
       auto range = faces.equal_range (hash);
@@ -114,98 +245,17 @@ t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const
         const int neigh_itree = std::get<0> (it->second);
         const int neigh_iface = std::get<1> (it->second);
 
-        /* Retrieve the potentially neighboring element class. */
+        /* Retrieve the potentially neighboring element class and face vertices. */
         const t8_eclass_t neigh_eclass = eclasses[neigh_itree];
-
-        /* Get the number of vertices per face of potentially neighboring element. */
-        const int neigh_nface_verts = t8_eclass_num_vertices[t8_eclass_face_types[neigh_eclass][neigh_iface]];
-
-        /* If the number of face vertices do not match we can skip. */
-        if (nface_verts != neigh_nface_verts) {
-          continue;
-        }
-
-        /* The order of the encountered face vertices is needed for computing
-         * the orientation later on. Prepare the array for that here. */
-        int face_vert_order[T8_ECLASS_MAX_EDGES_2D];
-        for (int i = 0; i < T8_ECLASS_MAX_EDGES_2D; i++) {
-          face_vert_order[i] = -1;
-        }
-
-        int match_count = 0; /* This tracks the number of matching vertices. */
-        /* Loop over the vertices of the current element's face. */
-        for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
-          /* Map from a face vertex id to the element vertex id. */
-          const int ivert = t8_face_vertex_to_tree_vertex[eclass][iface][iface_vert];
-
-          /* Loop over the vertices of the potentially neighboring element's face. */
-          for (int neigh_iface_vert = 0; neigh_iface_vert < neigh_nface_verts; neigh_iface_vert++) {
-            /* Map from a face vertex id to the element vertex id. */
-            const int neigh_ivert = t8_face_vertex_to_tree_vertex[neigh_eclass][neigh_iface][neigh_iface_vert];
-
-            int match_count_per_coord = 0; /* Tracks the matching of x, y and z coordinates of two vertices. */
-            for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
-              /* Retrieve the x, y or z component of the face vertex
-               * coordinate from the vertices array. */
-
-              const double face_vert
-                = vertices[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)];
-              const double neigh_face_vert = vertices[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM,
-                                                                   neigh_itree, neigh_ivert, icoord)];
-
-              /* Compare the coordinates with some tolerance. */
-              if (fabs (face_vert - neigh_face_vert) < 10.0 * T8_PRECISION_EPS) {
-                match_count_per_coord++;
-              }
-            }
-
-            /* In case all x, y and z components match we increase the match_count variable. */
-            if (match_count_per_coord == T8_ECLASS_MAX_DIM) {
-              match_count++;
-              /* Store the encountered face vertex order for later use. */
-              face_vert_order[iface_vert] = neigh_iface_vert;
-              continue;
-            }
-          }
-        }
-
-        /* If the number of matching face vertices is equal to the actual number of the face's vertices
-         * we interpret this as a face-to-face connection between two elements. */
-        if (match_count == nface_verts) {
-          /* Compute the orientation of the face-to-face connection.
-           * Face corner 0 of the face with the lower face direction connects
-           * to a corner of the other face. The number of this corner is the
-           * orientation code. */
-          int orientation = -1;
-          int smaller_bigger_face_condition = -1;
-
-          const int compare = t8_eclass_compare (eclass, neigh_eclass);
-          if (compare < 0) {
-            /* This tree class is smaller than neigh. tree class. */
-            smaller_bigger_face_condition = 1;
-          }
-          else if (compare > 0) {
-            /* This tree class is bigger than neigh. tree class. */
-            smaller_bigger_face_condition = 0;
-          }
-          else {
-            /* This tree class is the same as the neigh. tree class. 
-               Then the face with the smaller face id is the smaller one. */
-            smaller_bigger_face_condition = iface < neigh_iface;
-          }
-
-          if (smaller_bigger_face_condition) {
-            orientation = face_vert_order[0];
-          }
-          else {
-            for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
-              if (0 == face_vert_order[iface_vert]) {
-                orientation = iface_vert;
-                break;
-              }
-            }
-          }
-
+        double neigh_face_coords[T8_ECLASS_MAX_CORNERS_2D * T8_ECLASS_MAX_DIM];
+        (void) t8_cmesh_get_face_coords (
+          neigh_eclass, neigh_iface,
+          vertices + T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, neigh_itree, 0, 0),
+          neigh_face_coords);
+
+        const int orientation = t8_cmesh_face_orientation_by_coords (eclass, iface, face_coords, neigh_eclass,
+                                                                     neigh_iface, neigh_face_coords);
+        if (orientation >= 0) {
           /* Store the results. */
           conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, itree, iface, 0)] = neigh_itree;
           conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, itree, iface, 1)] = neigh_iface;
@@ -284,3 +334,242 @@ t8_cmesh_set_join_by_stash (t8_cmesh_t cmesh, int **connectivity, const int do_b
   /* Let t8_cmesh_set_join_by_vertices join the trees */
   t8_cmesh_set_join_by_vertices (cmesh, ntrees, eclasses.data (), vertices.data (), connectivity, do_both_directions);
 }
+
+/* A tree face that is sent to the process that owns its hash in t8_cmesh_set_join_by_vertices_parallel. */
+typedef struct
+{
+  uint64_t hash;                                               /* The hash key of the face vertices. */
+  t8_gloidx_t gtree_id;                                        /* The global id of the tree. */
+  double coords[T8_ECLASS_MAX_CORNERS_2D * T8_ECLASS_MAX_DIM]; /* The face vertex coordinates in face order. */
+  int32_t iface;                                               /* The face number within the tree. */
+  int32_t eclass;                                              /* The class of the tree. */
+  int32_t rank;                                                /* The process that owns the tree. */
+  int32_t padding;
+} t8_cmesh_join_face_t;
+
+/* Compute splitters of the face hashes with a sample sort, such that process p
+ * owns the hashes h with splitters[p - 1] <= h < splitters[p].
+ * The samples are gathered on process zero, which chooses the splitters and broadcasts them.
+ * The local hashes must be sorted. Returns mpisize - 1 splitters. */
+static std::vector<uint64_t>
+t8_cmesh_join_hash_splitters (const std::vector<t8_cmesh_join_face_t> &faces, sc_MPI_Comm comm)
+{
+  int mpirank, mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  /* Each process contributes regularly spaced samples of its sorted hashes.
+   * We limit their total number, such that process zero holds at most T8_JOIN_MAX_SAMPLES samples. */
+  const int max_samples = SC_MIN (mpisize - 1, SC_MAX (T8_JOIN_MAX_SAMPLES / mpisize, 1));
+  const int num_samples = faces.empty () ? 0 : max_samples;
+  std::vector<uint64_t> samples (num_samples);
+  for (int isample = 0; isample < num_samples; isample++) {
+    samples[isample] = faces[(isample + 1) * faces.size () / (num_samples + 1)].hash;
+  }
+  std::vector<int> counts, displacements;
+  std::vector<uint64_t> all_samples;
+  if (mpirank == 0) {
+    counts.resize (mpisize);
+    displacements.resize (mpisize + 1, 0);
+  }
+  mpiret = sc_MPI_Gather (&num_samples, 1, sc_MPI_INT, counts.data (), 1, sc_MPI_INT, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  if (mpirank == 0) {
+    for (int iproc = 0; iproc < mpisize; iproc++) {
+      displacements[iproc + 1] = displacements[iproc] + counts[iproc];
+    }
+    all_samples.resize (displacements[mpisize]);
+  }
+  mpiret = sc_MPI_Gatherv (samples.data (), num_samples, T8_MPI_LINEARIDX, all_samples.data (), counts.data (),
+                           displacements.data (), T8_MPI_LINEARIDX, 0, comm);
+  SC_CHECK_MPI (mpiret);
+
+  /* Choose evenly spaced splitters among all samples */
+  std::vector<uint64_t> splitters (mpisize - 1, UINT64_MAX);
+  if (mpirank == 0 && !all_samples.empty ()) {
+    std::sort (all_samples.begin (), all_samples.end ());
+    for (int iproc = 1; iproc < mpisize; iproc++) {
+      splitters[iproc - 1] = all_samples[(size_t) iproc * all_samples.size () / mpisize];
+    }
+  }
+  mpiret = sc_MPI_Bcast (splitters.data (), mpisize - 1, T8_MPI_LINEARIDX, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  return splitters;
+}
+
+void
+t8_cmesh_set_join_by_vertices_parallel (t8_cmesh_t cmesh, const t8_gloidx_t first_tree,
+                                        const t8_locidx_t num_local_trees, const t8_eclass_t *eclasses,
+                                        const double *vertices, sc_MPI_Comm comm)
+{
+  int mpirank, mpisize, mpiret;
+
+  T8_ASSERT (cmesh != NULL);
+  T8_ASSERT (t8_cmesh_is_initialized (cmesh));
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  /* Compute minimum and maximum of the cmesh domain. */
+  double local_range[2] = { DBL_MAX, DBL_MAX }; /* The minimum and the negated maximum */
+  double global_range[2];
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_eclass_t eclass = eclasses[itree];
+    const int nverts = t8_eclass_num_vertices[eclass];
+    const int edim = t8_eclass_to_dimension[eclass];
+
+    for (int ivert = 0; ivert < nverts; ivert++) {
+      for (int icoord = 0; icoord < edim; icoord++) {
+        const double coord
+          = vertices[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)];
+        local_range[0] = SC_MIN (local_range[0], coord);
+        local_range[1] = SC_MIN (local_range[1], -coord);
+      }
+    }
+  }
+  mpiret = sc_MPI_Allreduce (local_range, global_range, 2, sc_MPI_DOUBLE, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  const double min_coord = global_range[0];
+  const double inverse_bin_size = T8_JOIN_NUM_BINS / (-global_range[1] - min_coord);
+
+  /* Hash the local faces and sort them by their hash. */
+  std::vector<t8_cmesh_join_face_t> faces;
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_eclass_t eclass = eclasses[itree];
+    const double *tree_vertices
+      = vertices + T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, 0, 0);
+
+    for (int iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      t8_cmesh_join_face_t face;
+      const int nface_verts = t8_cmesh_get_face_coords (eclass, iface, tree_vertices, face.coords);
+      face.hash = t8_cmesh_face_hash (face.coords, nface_verts, min_coord, inverse_bin_size);
+      face.gtree_id = first_tree + itree;
+      face.iface = iface;
+      face.eclass = eclass;
+      face.rank = mpirank;
+      face.padding = 0;
+      faces.push_back (face);
+    }
+  }
+  const auto face_compare = [] (const t8_cmesh_join_face_t &face_a, const t8_cmesh_join_face_t &face_b) {
+    return face_a.hash < face_b.hash
+           || (face_a.hash == face_b.hash
+               && (face_a.gtree_id < face_b.gtree_id
+                   || (face_a.gtree_id == face_b.gtree_id && face_a.iface < face_b.iface)));
+  };
+  std::sort (faces.begin (), faces.end (), face_compare);
+
+  /* Route the faces to the owners of their hashes. Since the faces are sorted,
+   * the faces of each owner are contiguous. */
+  const std::vector<uint64_t> splitters = t8_cmesh_join_hash_splitters (faces, comm);
+  std::vector<std::vector<t8_cmesh_join_face_t>> send_faces (mpisize);
+  for (const auto &face : faces) {
+    const int owner = std::upper_bound (splitters.begin (), splitters.end (), face.hash) - splitters.begin ();
+    send_faces[owner].push_back (face);
+  }
+  faces = t8_cmesh_exchange (send_faces, comm, T8_MPI_CMESH_JOIN_BY_VERTICES);
+  send_faces.clear ();
+  std::sort (faces.begin (), faces.end (), face_compare);
+
+  /* Match the faces with the same hash and send each face connection to the owners of both trees. */
+  std::vector<std::vector<t8_cmesh_exchange_join_t>> send_joins (mpisize);
+  std::vector<char> matched (faces.size (), 0);
+  for (size_t begin = 0, end; begin < faces.size (); begin = end) {
+    for (end = begin + 1; end < faces.size () && faces[end].hash == faces[begin].hash; end++) {
+    }
+    for (size_t iface = begin; iface < end; iface++) {
+      for (size_t ineigh = iface + 1; ineigh < end && !matched[iface]; ineigh++) {
+        const t8_cmesh_join_face_t &face = faces[iface];
+        const t8_cmesh_join_face_t &neigh = faces[ineigh];
+        if (matched[ineigh]) {
+          continue;
+        }
+        const int orientation
+          = t8_cmesh_face_orientation_by_coords ((t8_eclass_t) face.eclass, face.iface, face.coords,
+                                                 (t8_eclass_t) neigh.eclass, neigh.iface, neigh.coords);
+        if (orientation < 0) {
+          continue;
+        }
+        matched[iface] = matched[ineigh] = 1;
+        t8_cmesh_exchange_join_t join;
+        join.gtree_id[0] = face.gtree_id;
+        join.gtree_id[1] = neigh.gtree_id;
+        join.iface[0] = face.iface;
+        join.iface[1] = neigh.iface;
+        join.eclass[0] = face.eclass;
+        join.eclass[1] = neigh.eclass;
+        join.rank[0] = face.rank;
+        join.rank[1] = neigh.rank;
+        join.orientation = orientation;
+        join.padding = 0;
+        send_joins[face.rank].push_back (join);
+        if (neigh.rank != face.rank) {
+          send_joins[neigh.rank].push_back (join);
+        }
+      }
+    }
+  }
+  faces.clear ();
+  const std::vector<t8_cmesh_exchange_join_t> joins
+    = t8_cmesh_exchange (send_joins, comm, T8_MPI_CMESH_JOIN_BY_VERTICES);
+
+  /* Set the face connections of the local trees and of their ghosts */
+  t8_cmesh_exchange_set_joins (cmesh, first_tree, num_local_trees, joins, comm, T8_MPI_CMESH_JOIN_BY_VERTICES);
+}
+
+void
+t8_cmesh_exchange_set_joins (t8_cmesh_t cmesh, const t8_gloidx_t first_tree, const t8_locidx_t num_local_trees,
+                             const std::vector<t8_cmesh_exchange_join_t> &joins, sc_MPI_Comm comm, const int tag)
+{
+  int mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  /* Set the face connections of the local trees and the classes of the ghosts.
+   * We also remember which processes have our trees as ghosts. */
+  const t8_gloidx_t last_tree = first_tree + num_local_trees - 1;
+  std::set<std::pair<t8_gloidx_t, int>> joined_faces;
+  std::set<std::pair<t8_gloidx_t, int>> ghosts;
+  std::vector<std::set<int>> ghost_ranks (num_local_trees);
+  for (const auto &join : joins) {
+    t8_cmesh_set_join (cmesh, join.gtree_id[0], join.gtree_id[1], join.iface[0], join.iface[1], join.orientation);
+    joined_faces.emplace (join.gtree_id[0], join.iface[0]);
+    joined_faces.emplace (join.gtree_id[1], join.iface[1]);
+    for (int iside = 0; iside < 2; iside++) {
+      const t8_gloidx_t gtree = join.gtree_id[iside];
+      const t8_gloidx_t neighbor = join.gtree_id[1 - iside];
+      if (first_tree <= gtree && gtree <= last_tree && (neighbor < first_tree || neighbor > last_tree)) {
+        ghosts.emplace (neighbor, join.eclass[1 - iside]);
+        ghost_ranks[gtree - first_tree].insert (join.rank[1 - iside]);
+      }
+    }
+  }
+  for (const auto &ghost : ghosts) {
+    t8_cmesh_set_tree_class (cmesh, ghost.first, (t8_eclass_t) ghost.second);
+  }
+
+  /* Send the face connections of each local tree to the processes that have it as a ghost,
+   * such that they also know the connections between their ghosts. */
+  std::vector<std::vector<t8_cmesh_exchange_join_t>> send_ghost_joins (mpisize);
+  for (const auto &join : joins) {
+    for (int iside = 0; iside < 2; iside++) {
+      const t8_gloidx_t gtree = join.gtree_id[iside];
+      if (first_tree <= gtree && gtree <= last_tree) {
+        for (const int rank : ghost_ranks[gtree - first_tree]) {
+          send_ghost_joins[rank].push_back (join);
+        }
+      }
+    }
+  }
+  const std::vector<t8_cmesh_exchange_join_t> ghost_joins = t8_cmesh_exchange (send_ghost_joins, comm, tag);
+  for (const auto &join : ghost_joins) {
+    if (joined_faces.insert (std::make_pair (join.gtree_id[0], join.iface[0])).second) {
+      t8_cmesh_set_join (cmesh, join.gtree_id[0], join.gtree_id[1], join.iface[0], join.iface[1], join.orientation);
+      joined_faces.emplace (join.gtree_id[1], join.iface[1]);
+    }
+  }
+}
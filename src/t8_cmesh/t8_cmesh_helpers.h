@@ -78,6 +78,29 @@ t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const
 void
 t8_cmesh_set_join_by_stash (t8_cmesh_t cmesh, int **connectivity, const int do_both_directions);
 
+/** Sets the face connectivity information of an un-committed, partitioned \a cmesh based on the vertices of
+ * the local trees. In contrast to \ref t8_cmesh_set_join_by_vertices, each process only knows the vertices
+ * of its own trees. The faces are hashed locally and routed with a sample sort of their hashes, such that
+ * matching faces meet on the same process. The face connections of the local trees and between their ghosts
+ * as well as the classes of the ghosts are set in the cmesh.
+ * This function is collective on \a comm.
+ * \param[in,out]   cmesh               An uncommitted cmesh whose local trees are \a first_tree, ...,
+ *                                      \a first_tree + \a num_local_trees - 1, for example set via
+ *                                      \ref t8_cmesh_set_partition_range.
+ * \param[in]       first_tree          The global id of the first local tree.
+ * \param[in]       num_local_trees     The number of local trees.
+ * \param[in]       eclasses            List of element classes of the local trees of length [num_local_trees].
+ * \param[in]       vertices            List of per element vertices of the local trees with dimensions
+ *                                      [num_local_trees,T8_ECLASS_MAX_CORNERS,T8_ECLASS_MAX_DIM].
+ * \param[in]       comm                The MPI communicator of the cmesh.
+ *
+ * \note This routine does not detect periodic boundaries.
+ */
+void
+t8_cmesh_set_join_by_vertices_parallel (t8_cmesh_t cmesh, const t8_gloidx_t first_tree,
+                                        const t8_locidx_t num_local_trees, const t8_eclass_t *eclasses,
+                                        const double *vertices, sc_MPI_Comm comm);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_CMESH_HELPERS_H */
@@ -28,9 +28,18 @@
 #include <t8_geometry/t8_geometry_implementations/t8_geometry_cad.h>
 #include "t8_cmesh_types.h"
 #include "t8_cmesh_stash.h"
+#include "t8_cmesh_exchange.hxx"
+#include <algorithm>
+#include <cctype>
+#include <vector>
 
 #ifdef _WIN32
 #include "t8_windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 /* The supported number of gmesh tree classes.
@@ -159,9 +168,10 @@ t8_msh_file_node_compare (const void *node_a, const void *node_b, const void *u_
   return Node_a->index == Node_b->index;
 }
 
-/* Reads an open msh-file and checks whether the MeshFormat-Version is supported by t8code or not. */
+/* Reads an open msh-file and checks whether the MeshFormat-Version is supported by t8code or not.
+ * On output, is_binary is true if the file is a binary file. Binary files are supported for version 4.1. */
 static int
-t8_cmesh_check_version_of_msh_file (FILE *fp)
+t8_cmesh_check_version_of_msh_file (FILE *fp, int *is_binary)
 {
   char *line = (char *) malloc (1024);
   char first_word[2048] = "\0";
@@ -200,8 +210,10 @@ t8_cmesh_check_version_of_msh_file (FILE *fp)
   }
 
   /* Checks if the file is of Binary-type. */
-  if (check_format) {
-    t8_global_errorf ("Incompatible file-type. t8code works with ASCII-type msh-files with the versions:\n");
+  *is_binary = check_format;
+  if (check_format && (version_number != 4 || sub_version_number < 1)) {
+    t8_global_errorf ("Incompatible file-type. t8code works with binary msh-files of version 4.1 and "
+                      "ASCII-type msh-files with the versions:\n");
     for (int n_versions = 0; n_versions < T8_CMESH_N_SUPPORTED_MSH_FILE_VERSIONS; ++n_versions) {
       t8_global_errorf ("%d.X\n", t8_cmesh_supported_msh_file_versions[n_versions]);
     }
@@ -1753,6 +1765,1056 @@ t8_cmesh_msh_file_find_neighbors (t8_cmesh_t cmesh, const sc_array_t *vertex_ind
   t8_debugf ("Done finding tree neighbors.\n");
 }
 
+/* The parallel reader for .msh files of version 4.
+ * The lines of the file are distributed among the processes by the position of their first byte
+ * and each process parses the node and element lines that it owns.
+ * The coordinates of the nodes are sent to the process that owns the range of node tags and are
+ * fetched from there by the processes whose trees reference them.
+ * Face neighbors are found with a distributed face hash: each face is sent to the process
+ * given by the hash value of its vertices, which matches it with the face of the neighbor tree.
+ */
+
+/* The lines of a .msh file that a process reads in the parallel reader. */
+typedef struct
+{
+  std::vector<char> buffer;          /* The bytes of the local lines. Each line is terminated by '\0'. */
+  std::vector<size_t> line_starts;   /* The position of each local line in buffer. */
+  std::vector<int64_t> line_offsets; /* The global index of the first line of each process, mpisize + 1 entries. */
+  sc_MPI_Comm comm;
+  int mpirank;
+  int mpisize;
+} t8_msh_parallel_file_t;
+
+/* A block of nodes or elements in a .msh file of version 4. */
+typedef struct
+{
+  int64_t header_line; /* The global line index of the block header. */
+  int64_t num_entries; /* The number of nodes or elements in the block. */
+  int64_t offset;      /* The global index of the first node or tree of the block. */
+  t8_eclass_t eclass;  /* The class of the elements, T8_ECLASS_COUNT for nodes and skipped elements. */
+} t8_msh_parallel_block_t;
+
+/* The coordinates of a node, identified by its tag or its position in the nodes section. */
+typedef struct
+{
+  int64_t id;
+  double coordinates[3];
+} t8_msh_parallel_node_t;
+
+/* The tag of the node at a position in the nodes section. */
+typedef struct
+{
+  int64_t position;
+  int64_t tag;
+} t8_msh_parallel_node_tag_t;
+
+/* A tree face that is sent to the process that matches it with its neighbor face. */
+typedef struct
+{
+  int64_t sorted_vertices[T8_ECLASS_MAX_CORNERS_2D]; /* The vertex tags in ascending order. Unused entries are -1. */
+  int64_t vertices[T8_ECLASS_MAX_CORNERS_2D];        /* The vertex tags in the order of the face. */
+  int64_t gtree_id;                                  /* The global id of the tree. */
+  int32_t face_number;                               /* The face number within the tree. */
+  int32_t eclass;                                    /* The class of the tree. */
+  int32_t num_vertices;                              /* The number of vertices of the face. */
+  int32_t rank;                                      /* The process that owns the tree. */
+} t8_msh_parallel_face_t;
+
+/* Read the lines of a file that start in the byte range of this process.
+ * Returns true on all processes if the file could be read. */
+static int
+t8_msh_parallel_file_read (const char *filename, sc_MPI_Comm comm, t8_msh_parallel_file_t *file)
+{
+  int success = 1, global_success, mpiret;
+  int64_t file_size = 0;
+  FILE *fp;
+
+  file->comm = comm;
+  mpiret = sc_MPI_Comm_rank (comm, &file->mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (comm, &file->mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  fp = fopen (filename, "rb");
+  if (fp == NULL || fseeko (fp, 0, SEEK_END) != 0 || (file_size = ftello (fp)) < 0) {
+    t8_errorf ("Could not open file %s\n", filename);
+    success = 0;
+  }
+  if (success) {
+    /* Read our byte range. Rank > 0 also reads the byte before to know whether a line starts at its first byte. */
+    const int64_t begin = file_size * file->mpirank / file->mpisize;
+    const int64_t end = file_size * (file->mpirank + 1) / file->mpisize;
+    const int64_t start = file->mpirank == 0 ? 0 : begin - 1;
+    file->buffer.resize (end - start);
+    success = fseeko (fp, start, SEEK_SET) == 0
+              && fread (file->buffer.data (), 1, end - start, fp) == (size_t) (end - start);
+    /* Complete the last line that starts in our range */
+    size_t search = end > start ? end - start - 1 : 0;
+    while (success && memchr (file->buffer.data () + search, '\n', file->buffer.size () - search) == NULL) {
+      const size_t old_size = file->buffer.size ();
+      file->buffer.resize (old_size + BUFSIZ);
+      const size_t num_read = fread (file->buffer.data () + old_size, 1, BUFSIZ, fp);
+      file->buffer.resize (old_size + num_read);
+      if (num_read == 0) {
+        break;
+      }
+      search = old_size;
+    }
+    file->buffer.push_back ('\n');
+    /* Find the lines that start in our range and terminate them */
+    size_t pos = 0;
+    if (file->mpirank > 0) {
+      pos = (char *) memchr (file->buffer.data (), '\n', file->buffer.size ()) - file->buffer.data () + 1;
+    }
+    while (success && pos < file->buffer.size () && start + (int64_t) pos < end) {
+      const size_t line_end = (char *) memchr (file->buffer.data () + pos, '\n', file->buffer.size () - pos)
+                              - file->buffer.data ();
+      file->buffer[line_end] = '\0';
+      file->line_starts.push_back (pos);
+      pos = line_end + 1;
+    }
+  }
+  if (fp != NULL) {
+    fclose (fp);
+  }
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    return 0;
+  }
+
+  /* Compute the global index of the first line of each process */
+  int64_t num_lines = file->line_starts.size ();
+  file->line_offsets.resize (file->mpisize + 1);
+  file->line_offsets[0] = 0;
+  mpiret = sc_MPI_Allgather (&num_lines, 1, T8_MPI_GLOIDX, file->line_offsets.data () + 1, 1,
+                             T8_MPI_GLOIDX, comm);
+  SC_CHECK_MPI (mpiret);
+  for (int iproc = 0; iproc < file->mpisize; iproc++) {
+    file->line_offsets[iproc + 1] += file->line_offsets[iproc];
+  }
+  return 1;
+}
+
+/* Return the local line with a given global index. It must be owned by this process. */
+static const char *
+t8_msh_parallel_file_line (const t8_msh_parallel_file_t *file, const int64_t global_line)
+{
+  const int64_t local_line = global_line - file->line_offsets[file->mpirank];
+  T8_ASSERT (0 <= local_line && local_line < (int64_t) file->line_starts.size ());
+  return file->buffer.data () + file->line_starts[local_line];
+}
+
+/* Find the global index of the first line that starts with a given section name.
+ * Returns -1 if there is no such line. */
+static int64_t
+t8_msh_parallel_find_section (const t8_msh_parallel_file_t *file, const char *section)
+{
+  const size_t length = strlen (section);
+  int64_t local_line = INT64_MAX, global_line;
+  int mpiret;
+
+  for (size_t iline = 0; iline < file->line_starts.size (); iline++) {
+    const char *line = file->buffer.data () + file->line_starts[iline];
+    if (line[0] == '$' && !strncmp (line, section, length) && (line[length] == '\0' || isspace (line[length]))) {
+      local_line = file->line_offsets[file->mpirank] + iline;
+      break;
+    }
+  }
+  mpiret = sc_MPI_Allreduce (&local_line, &global_line, 1, T8_MPI_GLOIDX, sc_MPI_MIN, file->comm);
+  SC_CHECK_MPI (mpiret);
+  return global_line == INT64_MAX ? -1 : global_line;
+}
+
+/* Parse up to four integers from a line with given global index on the process that owns
+ * it and broadcast them to all processes. Returns the number of parsed integers. */
+static int
+t8_msh_parallel_line_values (const t8_msh_parallel_file_t *file, const int64_t global_line, long values[4])
+{
+  long buffer[5] = { 0, 0, 0, 0, -1 };
+  int mpiret;
+
+  if (global_line < 0 || global_line >= file->line_offsets[file->mpisize]) {
+    return -1;
+  }
+  const int owner = std::upper_bound (file->line_offsets.begin (), file->line_offsets.end (), global_line)
+                    - file->line_offsets.begin () - 1;
+  if (owner == file->mpirank) {
+    buffer[4] = sscanf (t8_msh_parallel_file_line (file, global_line), "%li %li %li %li", buffer, buffer + 1,
+                        buffer + 2, buffer + 3);
+  }
+  mpiret = sc_MPI_Bcast (buffer, 5, sc_MPI_LONG, owner, file->comm);
+  SC_CHECK_MPI (mpiret);
+  memcpy (values, buffer, 4 * sizeof (long));
+  return buffer[4];
+}
+
+/* Read the block headers of the nodes or elements section starting at a given line.
+ * For elements, only the elements of dimension dim are counted as trees and the other blocks get
+ * the class T8_ECLASS_COUNT. Returns the total number of nodes or trees, or -1 on error. */
+static int64_t
+t8_msh_parallel_read_blocks (const t8_msh_parallel_file_t *file, const int64_t section_line, const int is_elements,
+                             const int dim, std::vector<t8_msh_parallel_block_t> &blocks, long *min_tag,
+                             long *max_tag)
+{
+  long values[4];
+  int64_t offset = 0;
+
+  /* The first line holds the number of blocks, of entries and the minimal and maximal tag */
+  if (t8_msh_parallel_line_values (file, section_line + 1, values) != 4) {
+    t8_global_errorf ("Premature end of line while reading num blocks.\n");
+    return -1;
+  }
+  const long num_blocks = values[0];
+  *min_tag = values[2];
+  *max_tag = values[3];
+  int64_t header_line = section_line + 2;
+  for (long iblock = 0; iblock < num_blocks; iblock++) {
+    t8_msh_parallel_block_t block;
+    /* The block header looks like entityDim entityTag parametric/elementType numEntriesInBlock */
+    if (t8_msh_parallel_line_values (file, header_line, values) != 4) {
+      t8_global_errorf ("Error while reading block information.\n");
+      return -1;
+    }
+    block.header_line = header_line;
+    block.num_entries = values[3];
+    block.offset = offset;
+    block.eclass = T8_ECLASS_COUNT;
+    if (is_elements) {
+      const long ele_type = values[2];
+      if (ele_type > T8_NUM_GMSH_ELEM_CLASSES || ele_type < 0
+          || t8_msh_tree_type_to_eclass[ele_type] == T8_ECLASS_COUNT) {
+        t8_global_errorf ("tree type %li is not supported by t8code.\n", ele_type);
+        return -1;
+      }
+      const t8_eclass_t eclass = t8_msh_tree_type_to_eclass[ele_type];
+      if (t8_eclass_to_dimension[eclass] > dim) {
+        t8_global_errorf (
+          "Warning: Encountered element which dimension is greater than %d. Did you set the correct dimension?\n",
+          dim);
+      }
+      if (t8_eclass_to_dimension[eclass] == dim) {
+        block.eclass = eclass;
+        offset += block.num_entries;
+      }
+      header_line += 1 + block.num_entries;
+    }
+    else {
+      /* A node block consists of the node tags followed by their coordinates */
+      offset += block.num_entries;
+      header_line += 1 + 2 * block.num_entries;
+    }
+    blocks.push_back (block);
+  }
+  return offset;
+}
+
+/* Given a block of lines starting at global index first_line, compute the range of
+ * these lines that is local to this process as indices relative to first_line. */
+static void
+t8_msh_parallel_local_range (const t8_msh_parallel_file_t *file, const int64_t first_line,
+                             const int64_t num_lines, int64_t *begin, int64_t *end)
+{
+  *begin = SC_MAX (file->line_offsets[file->mpirank] - first_line, 0);
+  *end = SC_MIN (file->line_offsets[file->mpirank + 1] - first_line, num_lines);
+  if (*end < *begin) {
+    *end = *begin;
+  }
+}
+
+/* The process that owns the node with a given tag */
+static int
+t8_msh_parallel_tag_owner (const int64_t tag, const long min_tag, const long max_tag, const int mpisize)
+{
+  return (tag - min_tag) * mpisize / (max_tag - min_tag + 1);
+}
+
+/* Parse the nodes section and distribute the node coordinates by their tags.
+ * On output, coordinates holds the coordinates of all nodes with tags in the range
+ * of this process, indexed by the tag minus the first tag of this process.
+ * Returns true on all processes if successful. */
+static int
+t8_msh_parallel_read_nodes (const t8_msh_parallel_file_t *file, const std::vector<t8_msh_parallel_block_t> &blocks,
+                            const int64_t num_nodes, const long min_tag, const long max_tag,
+                            std::vector<t8_msh_parallel_node_t> &coordinates)
+{
+  const int mpisize = file->mpisize;
+  std::vector<std::vector<t8_msh_parallel_node_tag_t>> send_tags (mpisize);
+  std::vector<std::vector<t8_msh_parallel_node_t>> send_coords (mpisize);
+  int success = 1, global_success, mpiret;
+
+  /* Parse the tag and coordinate lines that we own and send them to the process
+   * that owns the node's position in the nodes section. */
+  for (const auto &block : blocks) {
+    int64_t begin, end;
+    t8_msh_parallel_local_range (file, block.header_line + 1, 2 * block.num_entries, &begin, &end);
+    for (int64_t iline = begin; iline < end && success; iline++) {
+      const char *line = t8_msh_parallel_file_line (file, block.header_line + 1 + iline);
+      const int64_t position = block.offset + iline % block.num_entries;
+      const int owner = position * mpisize / num_nodes;
+      if (iline < block.num_entries) {
+        t8_msh_parallel_node_tag_t node_tag;
+        node_tag.position = position;
+        char *next;
+        node_tag.tag = strtoll (line, &next, 10);
+        success = next != line;
+        send_tags[owner].push_back (node_tag);
+      }
+      else {
+        t8_msh_parallel_node_t node;
+        node.id = position;
+        success = sscanf (line, "%lf %lf %lf", node.coordinates, node.coordinates + 1, node.coordinates + 2) == 3;
+        send_coords[owner].push_back (node);
+      }
+    }
+  }
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, file->comm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_global_errorf ("Error reading the nodes of the msh file.\n");
+    return 0;
+  }
+  std::vector<t8_msh_parallel_node_tag_t> tags = t8_cmesh_exchange (send_tags, file->comm, T8_MPI_CMESH_READ_MSH);
+  std::vector<t8_msh_parallel_node_t> coords = t8_cmesh_exchange (send_coords, file->comm, T8_MPI_CMESH_READ_MSH);
+
+  /* Combine the tags and coordinates of our positions and send them to the owner of the tag */
+  const int64_t first_position = (num_nodes * file->mpirank + mpisize - 1) / mpisize;
+  const int64_t num_positions = (num_nodes * (file->mpirank + 1) + mpisize - 1) / mpisize - first_position;
+  std::vector<int64_t> position_tags (num_positions);
+  for (const auto &node_tag : tags) {
+    position_tags[node_tag.position - first_position] = node_tag.tag;
+  }
+  std::vector<std::vector<t8_msh_parallel_node_t>> send_nodes (mpisize);
+  for (auto &node : coords) {
+    node.id = position_tags[node.id - first_position];
+    send_nodes[t8_msh_parallel_tag_owner (node.id, min_tag, max_tag, mpisize)].push_back (node);
+  }
+  std::vector<t8_msh_parallel_node_t> nodes = t8_cmesh_exchange (send_nodes, file->comm, T8_MPI_CMESH_READ_MSH);
+
+  /* Store the nodes by their tag */
+  const int64_t first_tag = min_tag + ((max_tag - min_tag + 1) * file->mpirank + mpisize - 1) / mpisize;
+  const int64_t end_tag = min_tag + ((max_tag - min_tag + 1) * (file->mpirank + 1) + mpisize - 1) / mpisize;
+  coordinates.resize (end_tag - first_tag);
+  for (auto &node : coordinates) {
+    node.id = -1;
+  }
+  for (const auto &node : nodes) {
+    coordinates[node.id - first_tag] = node;
+  }
+  return 1;
+}
+
+/* Fetch the coordinates of a sorted list of unique node tags from the owners of these tags. */
+static std::vector<t8_msh_parallel_node_t>
+t8_msh_parallel_fetch_nodes (const t8_msh_parallel_file_t *file, const std::vector<int64_t> &tags,
+                             const long min_tag, const long max_tag,
+                             const std::vector<t8_msh_parallel_node_t> &coordinates)
+{
+  const int mpisize = file->mpisize;
+  std::vector<std::vector<int64_t>> send_requests (mpisize);
+  std::vector<int> request_counts;
+
+  for (const auto tag : tags) {
+    send_requests[t8_msh_parallel_tag_owner (tag, min_tag, max_tag, mpisize)].push_back (tag);
+  }
+  std::vector<int64_t> requests
+    = t8_cmesh_exchange (send_requests, file->comm, T8_MPI_CMESH_READ_MSH, &request_counts);
+
+  /* Answer the requests in the order in which we received them */
+  const int64_t first_tag = min_tag + ((max_tag - min_tag + 1) * file->mpirank + mpisize - 1) / mpisize;
+  std::vector<std::vector<t8_msh_parallel_node_t>> send_nodes (mpisize);
+  size_t irequest = 0;
+  for (int iproc = 0; iproc < mpisize; iproc++) {
+    for (int icount = 0; icount < request_counts[iproc]; icount++, irequest++) {
+      const int64_t index = requests[irequest] - first_tag;
+      T8_ASSERT (0 <= index && index < (int64_t) coordinates.size ());
+      send_nodes[iproc].push_back (coordinates[index]);
+    }
+  }
+  /* Since the tags are sorted, the owners are ascending and the answers are in the order of tags */
+  return t8_cmesh_exchange (send_nodes, file->comm, T8_MPI_CMESH_READ_MSH);
+}
+
+/* The vertices that we switch to correct a tree with negative volume.
+ * Vertex i is switched with switch_indices[i] for i < the returned number of switches. */
+static int
+t8_msh_file_negative_volume_switches (const t8_eclass_t eclass, int switch_indices[4])
+{
+  switch (eclass) {
+  case T8_ECLASS_TRIANGLE:
+  case T8_ECLASS_QUAD:
+    /* We switch vertex 1 and vertex 2. */
+    switch_indices[0] = 0;
+    switch_indices[1] = 2;
+    return 2;
+  case T8_ECLASS_TET:
+    /* We switch vertex 0 and vertex 3. */
+    switch_indices[0] = 3;
+    return 1;
+  case T8_ECLASS_PRISM:
+    switch_indices[0] = 3;
+    switch_indices[1] = 4;
+    switch_indices[2] = 5;
+    return 3;
+  case T8_ECLASS_HEX:
+    switch_indices[0] = 4;
+    switch_indices[1] = 5;
+    switch_indices[2] = 6;
+    switch_indices[3] = 7;
+    return 4;
+  case T8_ECLASS_PYRAMID:
+    switch_indices[0] = 4;
+    return 1;
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+}
+
+/* Find the face neighbors of the local trees with a distributed face hash and add the
+ * face connections of the local trees and of their ghosts to the cmesh. */
+static void
+t8_msh_parallel_find_neighbors (t8_cmesh_t cmesh, const t8_msh_parallel_file_t *file, const t8_gloidx_t first_tree,
+                                const std::vector<t8_eclass_t> &tree_classes, const std::vector<int64_t> &tree_tags)
+{
+  const int mpisize = file->mpisize;
+  const t8_locidx_t num_local_trees = tree_classes.size ();
+  std::vector<std::vector<t8_msh_parallel_face_t>> send_faces (mpisize);
+
+  /* Send each face to the process given by the hash of its vertices */
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_eclass_t eclass = tree_classes[itree];
+    const int64_t *vertices = tree_tags.data () + itree * T8_ECLASS_MAX_CORNERS;
+    for (int iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      t8_msh_parallel_face_t face;
+      const t8_eclass_t face_class = (t8_eclass_t) t8_eclass_face_types[eclass][iface];
+      face.num_vertices = t8_eclass_num_vertices[face_class];
+      for (int ivertex = 0; ivertex < T8_ECLASS_MAX_CORNERS_2D; ivertex++) {
+        face.vertices[ivertex]
+          = ivertex < face.num_vertices ? vertices[t8_face_vertex_to_tree_vertex[eclass][iface][ivertex]] : -1;
+        face.sorted_vertices[ivertex] = face.vertices[ivertex];
+      }
+      std::sort (face.sorted_vertices, face.sorted_vertices + face.num_vertices);
+      face.gtree_id = first_tree + itree;
+      face.face_number = iface;
+      face.eclass = eclass;
+      face.rank = file->mpirank;
+      uint64_t hash = 0;
+      for (int ivertex = 0; ivertex < face.num_vertices; ivertex++) {
+        hash = hash * 0x9E3779B97F4A7C15ull + (uint64_t) face.sorted_vertices[ivertex];
+      }
+      send_faces[(hash ^ (hash >> 32)) % mpisize].push_back (face);
+    }
+  }
+  std::vector<t8_msh_parallel_face_t> faces = t8_cmesh_exchange (send_faces, file->comm, T8_MPI_CMESH_READ_MSH);
+
+  /* Match the faces with the same vertices and send the connection to the owners of both trees */
+  std::sort (faces.begin (), faces.end (),
+             [] (const t8_msh_parallel_face_t &face_a, const t8_msh_parallel_face_t &face_b) {
+               return std::lexicographical_compare (face_a.sorted_vertices,
+                                                    face_a.sorted_vertices + T8_ECLASS_MAX_CORNERS_2D,
+                                                    face_b.sorted_vertices,
+                                                    face_b.sorted_vertices + T8_ECLASS_MAX_CORNERS_2D);
+             });
+  std::vector<std::vector<t8_cmesh_exchange_join_t>> send_joins (mpisize);
+  for (size_t iface = 0; iface + 1 < faces.size (); iface++) {
+    const t8_msh_parallel_face_t &face_a = faces[iface];
+    const t8_msh_parallel_face_t &face_b = faces[iface + 1];
+    if (memcmp (face_a.sorted_vertices, face_b.sorted_vertices, sizeof (face_a.sorted_vertices))) {
+      continue;
+    }
+    /* Compute the orientation with the face struct of the serial reader */
+    long vertices_a[T8_ECLASS_MAX_CORNERS_2D], vertices_b[T8_ECLASS_MAX_CORNERS_2D];
+    t8_msh_file_face_t Face_a, Face_b;
+    for (int ivertex = 0; ivertex < T8_ECLASS_MAX_CORNERS_2D; ivertex++) {
+      vertices_a[ivertex] = face_a.vertices[ivertex];
+      vertices_b[ivertex] = face_b.vertices[ivertex];
+    }
+    Face_a.face_number = face_a.face_number;
+    Face_a.num_vertices = face_a.num_vertices;
+    Face_a.vertices = vertices_a;
+    Face_b.face_number = face_b.face_number;
+    Face_b.num_vertices = face_b.num_vertices;
+    Face_b.vertices = vertices_b;
+    t8_cmesh_exchange_join_t join;
+    join.gtree_id[0] = face_a.gtree_id;
+    join.gtree_id[1] = face_b.gtree_id;
+    join.iface[0] = face_a.face_number;
+    join.iface[1] = face_b.face_number;
+    join.eclass[0] = face_a.eclass;
+    join.eclass[1] = face_b.eclass;
+    join.rank[0] = face_a.rank;
+    join.rank[1] = face_b.rank;
+    join.orientation = t8_msh_file_face_orientation (&Face_a, &Face_b, (t8_eclass_t) face_a.eclass,
+                                                     (t8_eclass_t) face_b.eclass);
+    join.padding = 0;
+    send_joins[face_a.rank].push_back (join);
+    if (face_b.rank != face_a.rank) {
+      send_joins[face_b.rank].push_back (join);
+    }
+    /* Skip the matched face */
+    iface++;
+  }
+  const std::vector<t8_cmesh_exchange_join_t> joins = t8_cmesh_exchange (send_joins, file->comm, T8_MPI_CMESH_READ_MSH);
+
+  /* Add the connections of the local trees and of their ghosts */
+  t8_cmesh_exchange_set_joins (cmesh, first_tree, num_local_trees, joins, file->comm, T8_MPI_CMESH_READ_MSH);
+}
+
+/* Read a .msh file of version 4 in parallel on all processes of comm and create a
+ * partitioned cmesh from it. Each process gets the trees whose element lines start in its
+ * byte range of the file. Since the lines differ in length, the number of trees per process
+ * is not balanced. Returns NULL on all processes if reading failed. */
+static t8_cmesh_t
+t8_cmesh_from_msh_file_parallel (const char *filename, sc_MPI_Comm comm, const int dim,
+                                 const t8_geometry_c *linear_geometry, t8_cmesh_t cmesh)
+{
+  t8_msh_parallel_file_t file;
+  std::vector<t8_msh_parallel_block_t> node_blocks, element_blocks;
+  std::vector<t8_msh_parallel_node_t> coordinates;
+  long min_tag, max_tag, min_element_tag, max_element_tag;
+  int success = 1, global_success, mpiret;
+
+  if (!t8_msh_parallel_file_read (filename, comm, &file)) {
+    t8_cmesh_destroy (&cmesh);
+    return NULL;
+  }
+
+  /* Read the structure of the nodes and elements sections */
+  const int64_t nodes_line = t8_msh_parallel_find_section (&file, "$Nodes");
+  const int64_t elements_line = t8_msh_parallel_find_section (&file, "$Elements");
+  if (nodes_line < 0 || elements_line < 0) {
+    t8_global_errorf ("Could not find the nodes or elements section of the msh file.\n");
+    t8_cmesh_destroy (&cmesh);
+    return NULL;
+  }
+  const int64_t num_nodes = t8_msh_parallel_read_blocks (&file, nodes_line, 0, dim, node_blocks, &min_tag, &max_tag);
+  const int64_t num_trees = t8_msh_parallel_read_blocks (&file, elements_line, 1, dim, element_blocks,
+                                                         &min_element_tag, &max_element_tag);
+  if (num_nodes <= 0 || num_trees < 0) {
+    t8_cmesh_destroy (&cmesh);
+    return NULL;
+  }
+  if (num_trees == 0) {
+    t8_global_errorf ("Warning: No %iD elements found in msh file.\n", dim);
+  }
+  if (!t8_msh_parallel_read_nodes (&file, node_blocks, num_nodes, min_tag, max_tag, coordinates)) {
+    t8_cmesh_destroy (&cmesh);
+    return NULL;
+  }
+
+  /* Parse the element lines that we own. Since the lines of a process are contiguous,
+   * so are its trees. */
+  std::vector<t8_eclass_t> tree_classes;
+  std::vector<int64_t> tree_tags;
+  t8_gloidx_t first_tree = -1;
+  for (const auto &block : element_blocks) {
+    int64_t begin, end;
+    if (block.eclass == T8_ECLASS_COUNT) {
+      continue;
+    }
+    t8_msh_parallel_local_range (&file, block.header_line + 1, block.num_entries, &begin, &end);
+    const int num_vertices = t8_eclass_num_vertices[block.eclass];
+    for (int64_t iline = begin; iline < end && success; iline++) {
+      const char *line = t8_msh_parallel_file_line (&file, block.header_line + 1 + iline);
+      char *next;
+      if (first_tree < 0) {
+        first_tree = block.offset + iline;
+      }
+      T8_ASSERT (first_tree + (t8_gloidx_t) tree_classes.size () == block.offset + iline);
+      tree_classes.push_back (block.eclass);
+      /* The line looks like element_tag node_1 ... node_m, we ignore the element tag */
+      (void) strtoll (line, &next, 10);
+      for (int ivertex = 0; ivertex < T8_ECLASS_MAX_CORNERS; ivertex++) {
+        int64_t tag = -1;
+        if (ivertex < num_vertices) {
+          const char *number = next;
+          tag = strtoll (number, &next, 10);
+          success = success && next != number && min_tag <= tag && tag <= max_tag;
+        }
+        tree_tags.push_back (tag);
+      }
+    }
+  }
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_global_errorf ("Error reading the elements of the msh file.\n");
+    t8_cmesh_destroy (&cmesh);
+    return NULL;
+  }
+  const t8_locidx_t num_local_trees = tree_classes.size ();
+  t8_gloidx_t tree_offset;
+  const t8_gloidx_t local_num_trees = num_local_trees;
+  mpiret = sc_MPI_Scan (&local_num_trees, &tree_offset, 1, T8_MPI_GLOIDX, sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+  T8_ASSERT (first_tree < 0 || first_tree == tree_offset - num_local_trees);
+  first_tree = tree_offset - num_local_trees;
+
+  /* Fetch the coordinates of the vertices of our trees */
+  std::vector<int64_t> needed_tags;
+  for (const auto tag : tree_tags) {
+    if (tag >= 0) {
+      needed_tags.push_back (tag);
+    }
+  }
+  std::sort (needed_tags.begin (), needed_tags.end ());
+  needed_tags.erase (std::unique (needed_tags.begin (), needed_tags.end ()), needed_tags.end ());
+  std::vector<t8_msh_parallel_node_t> nodes
+    = t8_msh_parallel_fetch_nodes (&file, needed_tags, min_tag, max_tag, coordinates);
+  coordinates.clear ();
+
+  /* Add the trees to the cmesh. The vertex tags are converted to t8code order. */
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_eclass_t eclass = tree_classes[itree];
+    const int num_vertices = t8_eclass_num_vertices[eclass];
+    int64_t *tags = tree_tags.data () + itree * T8_ECLASS_MAX_CORNERS;
+    int64_t msh_tags[T8_ECLASS_MAX_CORNERS];
+    double tree_vertices[T8_ECLASS_MAX_CORNERS * 3];
+
+    memcpy (msh_tags, tags, sizeof (msh_tags));
+    for (int ivertex = 0; ivertex < num_vertices; ivertex++) {
+      const int t8_vertex_num = t8_msh_tree_vertex_to_t8_vertex_num[eclass][ivertex];
+      const size_t inode
+        = std::lower_bound (needed_tags.begin (), needed_tags.end (), msh_tags[ivertex]) - needed_tags.begin ();
+      if (nodes[inode].id != msh_tags[ivertex]) {
+        success = 0;
+      }
+      tags[t8_vertex_num] = msh_tags[ivertex];
+      memcpy (tree_vertices + 3 * t8_vertex_num, nodes[inode].coordinates, 3 * sizeof (double));
+    }
+    /* Detect and correct negative volumes */
+    if (t8_cmesh_tree_vertices_negative_volume (eclass, tree_vertices, num_vertices)) {
+      int switch_indices[4] = { 0 };
+      const int num_switches = t8_msh_file_negative_volume_switches (eclass, switch_indices);
+      t8_debugf ("Correcting negative volume of tree %li\n", static_cast<long> (first_tree + itree));
+      for (int iswitch = 0; iswitch < num_switches; ++iswitch) {
+        for (int icoord = 0; icoord < 3; icoord++) {
+          std::swap (tree_vertices[3 * iswitch + icoord], tree_vertices[3 * switch_indices[iswitch] + icoord]);
+        }
+        std::swap (tags[iswitch], tags[switch_indices[iswitch]]);
+      }
+      T8_ASSERT (!t8_cmesh_tree_vertices_negative_volume (eclass, tree_vertices, num_vertices));
+    }
+    t8_cmesh_set_tree_class (cmesh, first_tree + itree, eclass);
+    t8_cmesh_set_tree_vertices (cmesh, first_tree + itree, tree_vertices, num_vertices);
+    t8_cmesh_set_tree_geometry (cmesh, first_tree + itree, linear_geometry);
+  }
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_global_errorf ("Elements of the msh file reference nodes that do not exist.\n");
+    t8_cmesh_destroy (&cmesh);
+    return NULL;
+  }
+
+  t8_msh_parallel_find_neighbors (cmesh, &file, first_tree, tree_classes, tree_tags);
+  t8_cmesh_set_partition_range (cmesh, 3, first_tree, first_tree + num_local_trees - 1);
+  t8_cmesh_commit (cmesh, comm);
+  return cmesh;
+}
+
+/* The reader for binary .msh files of version 4.1.
+ * The file is mapped into memory and the node and element blocks are decoded
+ * directly from it into an array of node coordinates and the tree vertices. */
+
+/* A .msh file mapped into memory. */
+typedef struct
+{
+  const char *data; /* The contents of the file. */
+  size_t size;      /* The size of the file in bytes. */
+  size_t pos;       /* The current read position. */
+#ifndef _WIN32
+  int is_mapped; /* True if data is mapped with mmap, false if it is allocated. */
+#endif
+} t8_msh_file_mapped_t;
+
+/* A node of a binary .msh file with sparse node tags. */
+typedef struct
+{
+  uint64_t tag;      /* The tag of the node. */
+  double coords[3];  /* Its coordinates. */
+} t8_msh_file_bin_node_t;
+
+/* The nodes of a binary .msh file, found by their tags.
+ * The node tags are usually contiguous, so we store the nodes in a dense array indexed by their tag.
+ * If the tags are sparse, for example after entities were removed or meshes were merged, the range
+ * of tags may be much larger than the number of nodes. Then we store the nodes sorted by their tags. */
+typedef struct
+{
+  uint64_t min_tag;                                  /* The smallest node tag. */
+  int dense;                                         /* True if the nodes are stored in the dense arrays. */
+  std::vector<double> coordinates;                   /* The coordinates of the node with tag t at 3 * (t - min_tag). */
+  std::vector<char> node_found;                      /* node_found[t - min_tag] is true if tag t exists. */
+  std::vector<t8_msh_file_bin_node_t> sorted_nodes;  /* The nodes sorted by tag, if they are not dense. */
+} t8_msh_file_bin_nodes_t;
+
+/* We store the nodes densely if the range of their tags is at most this factor times the number of nodes. */
+#define T8_MSH_FILE_BIN_MAX_TAG_RANGE_FACTOR 2
+
+/* Map a file into memory. On systems without mmap the file is read into a buffer.
+ * Returns true if successful. */
+static int
+t8_msh_file_map (const char *filename, t8_msh_file_mapped_t *file)
+{
+  file->data = NULL;
+  file->size = 0;
+  file->pos = 0;
+#ifndef _WIN32
+  struct stat file_stat;
+  const int fd = open (filename, O_RDONLY);
+
+  file->is_mapped = 1;
+  if (fd < 0) {
+    t8_global_errorf ("Could not open file %s\n", filename);
+    return 0;
+  }
+  if (fstat (fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    t8_global_errorf ("Could not determine the size of file %s\n", filename);
+    close (fd);
+    return 0;
+  }
+  file->size = file_stat.st_size;
+  void *data = mmap (NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED) {
+    t8_global_errorf ("Could not map file %s into memory\n", filename);
+    return 0;
+  }
+  /* We read the file once from the beginning to the end */
+  (void) madvise (data, file->size, MADV_SEQUENTIAL);
+  file->data = (const char *) data;
+#else
+  FILE *fp = fopen (filename, "rb");
+  long size;
+
+  if (fp == NULL || fseek (fp, 0, SEEK_END) != 0 || (size = ftell (fp)) <= 0 || fseek (fp, 0, SEEK_SET) != 0) {
+    t8_global_errorf ("Could not read file %s\n", filename);
+    if (fp != NULL) {
+      fclose (fp);
+    }
+    return 0;
+  }
+  file->size = size;
+  char *data = T8_ALLOC (char, file->size);
+  if (fread (data, 1, file->size, fp) != file->size) {
+    t8_global_errorf ("Could not read file %s\n", filename);
+    T8_FREE (data);
+    fclose (fp);
+    return 0;
+  }
+  fclose (fp);
+  file->data = data;
+#endif
+  return 1;
+}
+
+/* Release the memory of a mapped file. */
+static void
+t8_msh_file_unmap (t8_msh_file_mapped_t *file)
+{
+  if (file->data == NULL) {
+    return;
+  }
+#ifndef _WIN32
+  if (file->is_mapped) {
+    munmap ((void *) file->data, file->size);
+  }
+#else
+  T8_FREE ((char *) file->data);
+#endif
+  file->data = NULL;
+}
+
+/* Copy num_bytes bytes at the current position of a mapped file to dest and advance the position.
+ * Since the binary values in the file are not aligned, we always copy them.
+ * Returns true if the file contained enough bytes. */
+static inline int
+t8_msh_file_bin_read (t8_msh_file_mapped_t *file, void *dest, const size_t num_bytes)
+{
+  if (file->size - file->pos < num_bytes) {
+    return 0;
+  }
+  memcpy (dest, file->data + file->pos, num_bytes);
+  file->pos += num_bytes;
+  return 1;
+}
+
+/* Move the position of a mapped file to the line after the next line that starts with
+ * section, for example "$Nodes". Returns true if the section was found. */
+static int
+t8_msh_file_bin_find_section (t8_msh_file_mapped_t *file, const char *section)
+{
+  const size_t length = strlen (section);
+  const char *begin = file->data + file->pos;
+  const char *end = file->data + file->size;
+
+  while (begin < end) {
+    /* Sections start at the beginning of a line */
+    if ((begin == file->data || begin[-1] == '\n') && (size_t) (end - begin) > length
+        && !memcmp (begin, section, length) && (begin[length] == '\n' || begin[length] == '\r')) {
+      const char *line_end = (const char *) memchr (begin, '\n', end - begin);
+      file->pos = line_end - file->data + 1;
+      return 1;
+    }
+    const char *next = (const char *) memchr (begin, '\n', end - begin);
+    if (next == NULL) {
+      break;
+    }
+    begin = next + 1;
+  }
+  return 0;
+}
+
+/* The number of parametric coordinates stored for a node on an entity of dimension entity_dim. */
+static int
+t8_msh_file_bin_num_parameters (const int entity_dim, const int parametric)
+{
+  return parametric && (entity_dim == 1 || entity_dim == 2) ? entity_dim : 0;
+}
+
+/* Return the coordinates of the node with a tag, or NULL if there is no such node. */
+static const double *
+t8_msh_file_bin_find_node (const t8_msh_file_bin_nodes_t *nodes, const uint64_t tag)
+{
+  if (tag < nodes->min_tag) {
+    return NULL;
+  }
+  if (nodes->dense) {
+    const uint64_t index = tag - nodes->min_tag;
+    if (index >= nodes->node_found.size () || !nodes->node_found[index]) {
+      return NULL;
+    }
+    return nodes->coordinates.data () + 3 * index;
+  }
+  const auto node = std::lower_bound (
+    nodes->sorted_nodes.begin (), nodes->sorted_nodes.end (), tag,
+    [] (const t8_msh_file_bin_node_t &lhs, const uint64_t rhs) { return lhs.tag < rhs; });
+  if (node == nodes->sorted_nodes.end () || node->tag != tag) {
+    return NULL;
+  }
+  return node->coords;
+}
+
+/* Decode the nodes section of a binary .msh file of version 4.1 into nodes.
+ * Returns true if successful. */
+static int
+t8_msh_file_4_bin_read_nodes (t8_msh_file_mapped_t *file, t8_msh_file_bin_nodes_t *nodes)
+{
+  uint64_t header[4]; /* numEntityBlocks numNodes minNodeTag maxNodeTag */
+  std::vector<uint64_t> tags;
+
+  if (!t8_msh_file_bin_find_section (file, "$Nodes")) {
+    t8_global_errorf ("Could not find the nodes section of the msh file.\n");
+    return 0;
+  }
+  if (!t8_msh_file_bin_read (file, header, sizeof (header))) {
+    t8_global_errorf ("Premature end of file while reading num nodes.\n");
+    return 0;
+  }
+  const uint64_t num_blocks = header[0];
+  const uint64_t num_nodes_total = header[1];
+  nodes->min_tag = header[2];
+  if (num_nodes_total == 0 || header[3] < header[2]) {
+    t8_global_errorf ("The msh file does not contain any nodes.\n");
+    return 0;
+  }
+  const uint64_t tag_range = header[3] - header[2] + 1;
+  nodes->dense = tag_range / T8_MSH_FILE_BIN_MAX_TAG_RANGE_FACTOR <= num_nodes_total;
+  if (nodes->dense) {
+    nodes->coordinates.resize (3 * tag_range);
+    nodes->node_found.assign (tag_range, 0);
+  }
+  else {
+    t8_debugf ("The node tags of the msh file are sparse, %llu nodes in a range of %llu tags.\n",
+               (unsigned long long) num_nodes_total, (unsigned long long) tag_range);
+    nodes->sorted_nodes.reserve (num_nodes_total);
+  }
+
+  for (uint64_t iblock = 0; iblock < num_blocks; iblock++) {
+    /* The block header is entityDim entityTag parametric numNodesInBlock */
+    int32_t block_info[3];
+    uint64_t num_nodes;
+    if (!t8_msh_file_bin_read (file, block_info, sizeof (block_info))
+        || !t8_msh_file_bin_read (file, &num_nodes, sizeof (num_nodes))) {
+      t8_global_errorf ("Premature end of file while reading node block information.\n");
+      return 0;
+    }
+    const int num_values = 3 + t8_msh_file_bin_num_parameters (block_info[0], block_info[2]);
+    /* The block consists of the tags of all nodes followed by their coordinates */
+    tags.resize (num_nodes);
+    if (!t8_msh_file_bin_read (file, tags.data (), num_nodes * sizeof (uint64_t))
+        || file->size - file->pos < num_nodes * num_values * sizeof (double)) {
+      t8_global_errorf ("Premature end of file while reading nodes.\n");
+      return 0;
+    }
+    for (uint64_t inode = 0; inode < num_nodes; inode++) {
+      const uint64_t index = tags[inode] - nodes->min_tag;
+      if (tags[inode] < nodes->min_tag || index >= tag_range) {
+        t8_global_errorf ("Node tag %llu is out of range.\n", (unsigned long long) tags[inode]);
+        return 0;
+      }
+      double *coords;
+      if (nodes->dense) {
+        coords = nodes->coordinates.data () + 3 * index;
+        nodes->node_found[index] = 1;
+      }
+      else {
+        nodes->sorted_nodes.emplace_back ();
+        nodes->sorted_nodes.back ().tag = tags[inode];
+        coords = nodes->sorted_nodes.back ().coords;
+      }
+      memcpy (coords, file->data + file->pos, 3 * sizeof (double));
+      file->pos += num_values * sizeof (double);
+    }
+  }
+  if (!nodes->dense) {
+    std::sort (nodes->sorted_nodes.begin (), nodes->sorted_nodes.end (),
+               [] (const t8_msh_file_bin_node_t &lhs, const t8_msh_file_bin_node_t &rhs) { return lhs.tag < rhs.tag; });
+  }
+  return 1;
+}
+
+/* Decode the elements section of a binary .msh file of version 4.1 and add the trees of
+ * dimension dim to the cmesh. The node indices of each tree are stored in vertex_indices
+ * in t8code order as in t8_cmesh_msh_file_4_read_eles.
+ * Returns true if successful. */
+static int
+t8_cmesh_msh_file_4_bin_read_eles (t8_cmesh_t cmesh, t8_msh_file_mapped_t *file,
+                                   const t8_msh_file_bin_nodes_t *nodes, sc_array_t *vertex_indices, const int dim,
+                                   const t8_geometry_c *linear_geometry_base)
+{
+  uint64_t header[4]; /* numEntityBlocks numElements minElementTag maxElementTag */
+  uint64_t element[T8_ECLASS_MAX_CORNERS + 1];
+  double tree_vertices[T8_ECLASS_MAX_CORNERS * 3];
+  t8_gloidx_t tree_count = 0;
+
+  if (!t8_msh_file_bin_find_section (file, "$Elements")) {
+    t8_global_errorf ("Could not find the elements section of the msh file.\n");
+    return 0;
+  }
+  if (!t8_msh_file_bin_read (file, header, sizeof (header))) {
+    t8_global_errorf ("Premature end of file while reading num trees and num blocks.\n");
+    return 0;
+  }
+  const uint64_t num_blocks = header[0];
+  for (uint64_t iblock = 0; iblock < num_blocks; iblock++) {
+    /* The block header is entityDim entityTag elementType numElementsInBlock */
+    int32_t block_info[3];
+    uint64_t num_elements;
+    if (!t8_msh_file_bin_read (file, block_info, sizeof (block_info))
+        || !t8_msh_file_bin_read (file, &num_elements, sizeof (num_elements))) {
+      t8_global_errorf ("Premature end of file while reading element block information.\n");
+      return 0;
+    }
+    const int ele_type = block_info[2];
+    /* Check if the tree type is supported */
+    if (ele_type > T8_NUM_GMSH_ELEM_CLASSES || ele_type < 0
+        || t8_msh_tree_type_to_eclass[ele_type] == T8_ECLASS_COUNT) {
+      t8_global_errorf ("tree type %i is not supported by t8code.\n", ele_type);
+      return 0;
+    }
+    const t8_eclass_t eclass = t8_msh_tree_type_to_eclass[ele_type];
+    const int num_nodes = t8_eclass_num_vertices[eclass];
+    /* Each element is stored as its tag followed by the tags of its nodes */
+    const size_t element_bytes = (num_nodes + 1) * sizeof (uint64_t);
+    if ((file->size - file->pos) / element_bytes < num_elements) {
+      t8_global_errorf ("Premature end of file while reading trees.\n");
+      return 0;
+    }
+    if (t8_eclass_to_dimension[eclass] > dim) {
+      t8_errorf (
+        "Warning: Encountered element which dimension is greater than %d. Did you set the correct dimension?\n", dim);
+    }
+    if (t8_eclass_to_dimension[eclass] != dim) {
+      /* The trees in this block are not of the correct dimension. Thus, we skip them. */
+      file->pos += num_elements * element_bytes;
+      continue;
+    }
+    for (uint64_t ielement = 0; ielement < num_elements; ielement++, tree_count++) {
+      long *stored_indices = T8_ALLOC (long, num_nodes);
+
+      (void) t8_msh_file_bin_read (file, element, element_bytes);
+      /* Get the coordinates of the nodes and store the node indices in t8code order */
+      for (int inode = 0; inode < num_nodes; inode++) {
+        const double *coords = t8_msh_file_bin_find_node (nodes, element[inode + 1]);
+        if (coords == NULL) {
+          t8_global_errorf ("Tree %li references node %llu that does not exist.\n", static_cast<long> (tree_count),
+                            (unsigned long long) element[inode + 1]);
+          T8_FREE (stored_indices);
+          return 0;
+        }
+        const int t8_vertex_num = t8_msh_tree_vertex_to_t8_vertex_num[eclass][inode];
+        memcpy (tree_vertices + 3 * t8_vertex_num, coords, 3 * sizeof (double));
+        stored_indices[t8_vertex_num] = element[inode + 1];
+      }
+      /* Detect and correct negative volumes */
+      if (t8_cmesh_tree_vertices_negative_volume (eclass, tree_vertices, num_nodes)) {
+        int switch_indices[4] = { 0 };
+        const int num_switches = t8_msh_file_negative_volume_switches (eclass, switch_indices);
+        t8_debugf ("Correcting negative volume of tree %li\n", static_cast<long> (tree_count));
+        for (int iswitch = 0; iswitch < num_switches; ++iswitch) {
+          for (int icoord = 0; icoord < 3; icoord++) {
+            std::swap (tree_vertices[3 * iswitch + icoord], tree_vertices[3 * switch_indices[iswitch] + icoord]);
+          }
+          std::swap (stored_indices[iswitch], stored_indices[switch_indices[iswitch]]);
+        }
+        T8_ASSERT (!t8_cmesh_tree_vertices_negative_volume (eclass, tree_vertices, num_nodes));
+      }
+      t8_cmesh_set_tree_class (cmesh, tree_count, eclass);
+      t8_cmesh_set_tree_vertices (cmesh, tree_count, tree_vertices, num_nodes);
+      t8_cmesh_set_tree_geometry (cmesh, tree_count, linear_geometry_base);
+      *(long **) sc_array_push (vertex_indices) = stored_indices;
+    }
+  }
+  return 1;
+}
+
+/* Read a binary .msh file of version 4.1 and add its trees of dimension dim to the cmesh.
+ * vertex_indices is allocated and stores the node indices of each tree.
+ * Returns true if successful. */
+static int
+t8_cmesh_msh_file_4_bin_read (t8_cmesh_t cmesh, const char *filename, sc_array_t **vertex_indices, const int dim,
+                              const t8_geometry_c *linear_geometry_base)
+{
+  t8_msh_file_mapped_t file;
+  t8_msh_file_bin_nodes_t nodes;
+  int32_t one = 0;
+  int success;
+
+  *vertex_indices = sc_array_new (sizeof (long *));
+  if (!t8_msh_file_map (filename, &file)) {
+    return 0;
+  }
+  /* The format line looks like "4.1 1 8", where 8 is the size of the size_t values in the file.
+   * It is followed by the integer 1 to detect the endianness of the file. */
+  if (t8_msh_file_bin_find_section (&file, "$MeshFormat")) {
+    char format_line[64];
+    int version_number, sub_version_number, is_binary, data_size;
+    const size_t line_length = SC_MIN (sizeof (format_line) - 1, file.size - file.pos);
+    memcpy (format_line, file.data + file.pos, line_length);
+    format_line[line_length] = '\0';
+    const char *line_end = (const char *) memchr (file.data + file.pos, '\n', file.size - file.pos);
+    success = sscanf (format_line, "%d.%d %d %d", &version_number, &sub_version_number, &is_binary, &data_size) == 4
+              && data_size == sizeof (uint64_t) && line_end != NULL;
+    if (success) {
+      file.pos = line_end - file.data + 1;
+      success = t8_msh_file_bin_read (&file, &one, sizeof (one)) && one == 1;
+    }
+  }
+  else {
+    success = 0;
+  }
+  if (!success) {
+    t8_global_errorf ("The binary msh file %s has an unsupported data size or endianness.\n", filename);
+    t8_msh_file_unmap (&file);
+    return 0;
+  }
+  success = t8_msh_file_4_bin_read_nodes (&file, &nodes)
+            && t8_cmesh_msh_file_4_bin_read_eles (cmesh, &file, &nodes, *vertex_indices, dim, linear_geometry_base);
+  t8_msh_file_unmap (&file);
+  return success;
+}
+
 /* This part should be callable from C */
 T8_EXTERN_C_BEGIN ();
 
@@ -1798,6 +2860,7 @@ t8_cmesh_from_msh_file (const char *fileprefix, const int partition, sc_MPI_Comm
   t8_gloidx_t num_trees, first_tree, last_tree = -1;
   int main_proc_read_successful = 0;
   int msh_version;
+  int is_binary = 0;
   const t8_geometry_c *cad_geometry = NULL;
   const t8_geometry_c *linear_geometry = NULL;
 
@@ -1806,10 +2869,7 @@ t8_cmesh_from_msh_file (const char *fileprefix, const int partition, sc_MPI_Comm
   mpiret = sc_MPI_Comm_rank (comm, &mpirank);
   SC_CHECK_MPI (mpiret);
 
-  /* TODO: implement partitioned input using gmesh's
-   * partitioned files.
-   * Or using a single file and computing the partition on the run. */
-  T8_ASSERT (partition == 0 || (main_proc >= 0 && main_proc < mpisize));
+  T8_ASSERT (partition == 0 || main_proc < mpisize);
 
   /* initialize cmesh structure */
   t8_cmesh_init (&cmesh);
@@ -1828,6 +2888,32 @@ t8_cmesh_from_msh_file (const char *fileprefix, const int partition, sc_MPI_Comm
     return NULL;
   }
 
+  if (partition && main_proc < 0) {
+    /* All processes read the file in parallel. This is only supported for msh files of version 4
+     * without cad geometry, otherwise we fall back to reading the file on process 0. */
+    msh_version = 0;
+    if (mpirank == 0) {
+      snprintf (current_file, BUFSIZ, "%s.msh", fileprefix);
+      file = fopen (current_file, "r");
+      if (file != NULL) {
+        msh_version = t8_cmesh_check_version_of_msh_file (file, &is_binary);
+        fclose (file);
+      }
+      if (is_binary) {
+        /* Binary files are read on process 0 */
+        msh_version = 0;
+      }
+    }
+    mpiret = sc_MPI_Bcast (&msh_version, 1, sc_MPI_INT, 0, comm);
+    SC_CHECK_MPI (mpiret);
+    if (msh_version == 4 && !use_cad_geometry) {
+      snprintf (current_file, BUFSIZ, "%s.msh", fileprefix);
+      return t8_cmesh_from_msh_file_parallel (current_file, comm, dim, linear_geometry, cmesh);
+    }
+    t8_cmesh_destroy (&cmesh);
+    return t8_cmesh_from_msh_file (fileprefix, partition, comm, dim, 0, use_cad_geometry);
+  }
+
   if (!partition || mpirank == main_proc) {
     snprintf (current_file, BUFSIZ, "%s.msh", fileprefix);
     /* Open the file */
@@ -1845,7 +2931,7 @@ t8_cmesh_from_msh_file (const char *fileprefix, const int partition, sc_MPI_Comm
       return NULL;
     }
     /* Check if msh-file version is compatible. */
-    msh_version = t8_cmesh_check_version_of_msh_file (file);
+    msh_version = t8_cmesh_check_version_of_msh_file (file, &is_binary);
     if (msh_version < 1) {
       /* If reading the MeshFormat-number failed or the version is incompatible, close the file */
       fclose (file);
@@ -1878,6 +2964,32 @@ t8_cmesh_from_msh_file (const char *fileprefix, const int partition, sc_MPI_Comm
       break;
 
     case 4:
+      if (is_binary) {
+        /* Binary files are decoded from memory, we do not need the stream anymore */
+        fclose (file);
+        file = NULL;
+        if (use_cad_geometry
+            || !t8_cmesh_msh_file_4_bin_read (cmesh, current_file, &vertex_indices, dim, linear_geometry)) {
+          if (use_cad_geometry) {
+            t8_errorf ("WARNING: The cad geometry is not supported for binary msh files\n");
+          }
+          t8_cmesh_destroy (&cmesh);
+          if (vertex_indices != NULL) {
+            while (vertex_indices->elem_count > 0) {
+              indices_entry = *(long **) sc_array_pop (vertex_indices);
+              T8_FREE (indices_entry);
+            }
+            sc_array_destroy (vertex_indices);
+          }
+          if (partition) {
+            /* Communicate to the other processes that reading failed. */
+            main_proc_read_successful = 0;
+            sc_MPI_Bcast (&main_proc_read_successful, 1, sc_MPI_INT, main_proc, comm);
+          }
+          return NULL;
+        }
+        break;
+      }
       vertices = t8_msh_file_4_read_nodes (file, &num_vertices, &node_mempool);
       t8_cmesh_msh_file_4_read_eles (cmesh, file, vertices, &vertex_indices, dim, linear_geometry, use_cad_geometry,
                                      cad_geometry);
@@ -1887,12 +2999,16 @@ t8_cmesh_from_msh_file (const char *fileprefix, const int partition, sc_MPI_Comm
       break;
     }
     /* close the file and free the memory for the nodes */
-    fclose (file);
+    if (file != NULL) {
+      fclose (file);
+    }
     t8_cmesh_msh_file_find_neighbors (cmesh, vertex_indices);
     if (vertices != NULL) {
       sc_hash_destroy (vertices);
     }
-    sc_mempool_destroy (node_mempool);
+    if (node_mempool != NULL) {
+      sc_mempool_destroy (node_mempool);
+    }
     while (vertex_indices->elem_count > 0) {
       indices_entry = *(long **) sc_array_pop (vertex_indices);
       T8_FREE (indices_entry);
@@ -23,506 +23,137 @@
 /** \file t8_cmesh_save.cxx
  *
  * We define routines to save and load a cmesh to/from the file system.
+ * A cmesh is stored in a single binary file that is written collectively
+ * with MPI I/O. The file consists of the following sections:
  *
- * TODO: document this file
+ * | header | trees | face connections | vertices | attributes |
+ *
+ * The trees, face connections and vertices sections are arrays with one
+ * fixed size entry per global tree. The attribute section stores the
+ * attributes of all trees one after the other. Since each tree is stored
+ * at a position given by its global id, the file does not depend on the
+ * partition of the saved cmesh and can be read by any number of processes.
  */
 
 #include <t8_version.h>
 #include <t8_eclass.h>
+#include <t8_cmesh.hxx>
 #include <t8_cmesh/t8_cmesh_types.h>
 #include <t8_cmesh/t8_cmesh_trees.h>
-#include <t8_cmesh/t8_cmesh_save.h>
-#include <t8_cmesh/t8_cmesh_partition.h>
 #include <t8_cmesh/t8_cmesh_offset.h>
+#include <t8_cmesh/t8_cmesh_save.h>
+#include <t8_data/t8_mpi_file.h>
 #include <t8_geometry/t8_geometry.h>
 #include <t8_geometry/t8_geometry_base.h>
 #include <t8_geometry/t8_geometry_handler.hxx>
-#include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.h>
-
-/* This macro is called to check a condition and if not fulfilled
- * close the file and exit the function */
-#define T8_SAVE_CHECK_CLOSE(x, fp) \
-  if (!(x)) { \
-    t8_errorf ("file i/o error. Condition %s not fulfilled. " \
-               "Line %i in file %s\n", \
-               #x, __LINE__, __FILE__); \
-    fclose (fp); \
-    return 0; \
-  }
-
-/* Write the neighbor data of all ghosts */
-static int
-t8_cmesh_save_ghost_neighbors (const t8_cmesh_t cmesh, FILE *fp)
+#include <t8_geometry/t8_geometry_with_vertices.h>
+#include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.hxx>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/* The header of a cmesh file. */
+typedef struct
 {
-  t8_locidx_t ighost;
-  t8_cghost_t ghost;
-  t8_gloidx_t *face_neigh;
-  int8_t *ttf;
-  int iface, num_faces;
-  int ret;
-  char buffer[BUFSIZ];
-
-  ret = fprintf (fp, "\n--- Ghost neighbor section ---\n\n");
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  for (ighost = 0; ighost < cmesh->num_ghosts; ighost++) {
-    /* Reset the buffer */
-    buffer[0] = '\0';
-    ghost = t8_cmesh_trees_get_ghost_ext (cmesh->trees, ighost, &face_neigh, &ttf);
-    /* Iterate over all faces to write the face neighbor information */
-    num_faces = t8_eclass_num_faces[ghost->eclass];
-    for (iface = 0; iface < num_faces; iface++) {
-      snprintf (buffer + strlen (buffer), BUFSIZ - strlen (buffer), "%lli %i%s", (long long) face_neigh[iface],
-                ttf[iface], iface == num_faces - 1 ? "" : ", ");
-    }
-    ret = fprintf (fp, "%s\n", buffer);
-    T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  }
-  return 1;
-}
-
-static int
-t8_cmesh_load_ghost_attributes (const t8_cmesh_t cmesh, FILE *fp)
+  char magic[8];           /* Always "T8CMESH" */
+  int32_t format;          /* T8_CMESH_FORMAT */
+  int32_t dimension;       /* The dimension of the cmesh */
+  int64_t num_trees;       /* The global number of trees */
+  int64_t attribute_bytes; /* The number of bytes of the attribute section */
+} t8_cmesh_save_header_t;
+
+/* The metadata of a tree. */
+typedef struct
+{
+  int32_t eclass;           /* The element class of the tree */
+  int32_t num_attributes;   /* The number of attributes in the attribute section */
+  int64_t attribute_offset; /* The byte offset of the tree's attributes in the attribute section */
+  int64_t attribute_bytes;  /* The number of bytes of the tree's attributes */
+} t8_cmesh_save_tree_t;
+
+/* The connection of a tree face. Each tree stores T8_ECLASS_MAX_FACES of these,
+ * unused faces have a negative neighbor. */
+typedef struct
+{
+  int64_t neighbor;        /* The global id of the neighbor tree. The tree itself at the domain boundary. */
+  int32_t tree_to_face;    /* The face number and orientation, encoded as in the cmesh trees */
+  int32_t neighbor_eclass; /* The element class of the neighbor tree */
+} t8_cmesh_save_face_t;
+
+/* An entry of the attribute section. It is followed by the data of
+ * the attribute, padded to a multiple of 8 bytes. */
+typedef struct
 {
+  int32_t package_id;
+  int32_t key;
+  int64_t size;
+} t8_cmesh_save_attribute_t;
 
-  t8_locidx_t ighost;
-  t8_cghost_t ghost;
-  t8_gloidx_t *face_neigh;
-  int8_t *ttf;
-  int iface, num_faces, ttf_entry;
-  long long neigh;
-  int ret;
-
-  ret = fscanf (fp, "\n--- Ghost neighbor section ---\n\n");
-  T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-
-  for (ighost = 0; ighost < cmesh->num_ghosts; ighost++) {
-    /* Get a pointer to the ghost */
-    ghost = t8_cmesh_trees_get_ghost_ext (cmesh->trees, ighost, &face_neigh, &ttf);
-    /* Read the neighbor information */
-    num_faces = t8_eclass_num_faces[ghost->eclass];
-    for (iface = 0; iface < num_faces; iface++) {
-      ret = fscanf (fp, "%lli %i%*c", &neigh, &ttf_entry);
-      T8_SAVE_CHECK_CLOSE (ret == 2, fp);
-      ttf[iface] = ttf_entry;
-      face_neigh[iface] = neigh;
-    }
-  }
-  return 1;
-}
+/* The number of vertex coordinates stored per tree */
+#define T8_CMESH_SAVE_NUM_COORDS (3 * T8_ECLASS_MAX_CORNERS)
 
-static int
-t8_cmesh_save_ghosts (const t8_cmesh_t cmesh, FILE *fp)
+/* Byte offsets of the sections of a cmesh file */
+static size_t
+t8_cmesh_save_trees_pos ()
 {
-  t8_locidx_t ighost;
-  t8_cghost_t ghost;
-  int ret;
-
-  ret = fprintf (fp, "\n--- Ghost section ---");
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  ret = fprintf (fp, "\n\nGhosts %li\n\n", (long) cmesh->num_ghosts);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  for (ighost = 0; ighost < cmesh->num_ghosts; ighost++) {
-    ghost = t8_cmesh_trees_get_ghost (cmesh->trees, ighost);
-    ret = fprintf (fp, "treeid %lli\neclass %i\n\n", (long long) ghost->treeid, (int) ghost->eclass);
-    T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  }
-  return 1;
+  return sizeof (t8_cmesh_save_header_t);
 }
 
-static int
-t8_cmesh_load_ghosts (const t8_cmesh_t cmesh, FILE *fp)
+static size_t
+t8_cmesh_save_faces_pos (const t8_cmesh_save_header_t *header)
 {
-  t8_locidx_t ighost;
-  t8_cghost_t ghost;
-  int ret;
-  int eclass;
-  long num_ghosts;
-  long long global_id;
-
-  ret = fscanf (fp, "\n--- Ghost section ---\n");
-  T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-  /* Check whether the number of ghosts is correct */
-  ret = fscanf (fp, "Ghosts %li\n", &num_ghosts);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-  T8_SAVE_CHECK_CLOSE (num_ghosts == cmesh->num_ghosts, fp);
-  for (ighost = 0; ighost < cmesh->num_ghosts; ighost++) {
-    /* Get a pointer to the ghost */
-    ghost = t8_cmesh_trees_get_ghost (cmesh->trees, ighost);
-    /* Read the ghost's global id */
-    ret = fscanf (fp, "treeid %lli\n", &global_id);
-    T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-    T8_SAVE_CHECK_CLOSE (0 <= global_id && global_id < cmesh->num_trees, fp);
-    ghost->treeid = global_id;
-    /* read the ghost's eclass */
-    ret = fscanf (fp, "eclass %i\n", &eclass);
-    T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-    ghost->eclass = (t8_eclass_t) eclass;
-    /* Ignore the neighbor offset */
-    ret = fscanf (fp, "neigh_offset %*i\n");
-    T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-    ret = fscanf (fp, "\n");
-    T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-  }
-  return 1;
+  return t8_cmesh_save_trees_pos () + header->num_trees * sizeof (t8_cmesh_save_tree_t);
 }
 
-/* Load all attributes that were stored in a file */
-static int
-t8_cmesh_load_tree_attributes (const t8_cmesh_t cmesh, FILE *fp)
+static size_t
+t8_cmesh_save_vertices_pos (const t8_cmesh_save_header_t *header)
 {
-  double *vertices = NULL;
-  t8_locidx_t itree;
-  long treeid, neighbor;
-  t8_ctree_t tree;
-  int att, i, num_vertices, num_faces, iface;
-  int ret, ttf_entry;
-  t8_locidx_t *face_neighbors;
-  int8_t *ttf;
-  t8_stash_attribute_struct_t att_struct;
-
-  ret = fscanf (fp, "\n--- Tree attribute section ---\n");
-  T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-  /* loop over all trees */
-  for (itree = 0; itree < cmesh->num_local_trees; itree++) {
-    tree = t8_cmesh_trees_get_tree_ext (cmesh->trees, itree, &face_neighbors, &ttf);
-    /* Allocate memory for the temporary vertices array.
-     * This memory is reused for each tree */
-    num_vertices = t8_eclass_num_vertices[tree->eclass];
-    ret = fscanf (fp, "tree %li\n", &treeid);
-    T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-    /* Load the tree neighbors */
-    num_faces = t8_eclass_num_faces[tree->eclass];
-    ret = fscanf (fp, "Neighbors:");
-    T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-    for (iface = 0; iface < num_faces; iface++) {
-      /* Read the face neighbors tree id and the tree_to_face entry */
-      ret = fscanf (fp, "%li %i%*c", &neighbor, &ttf_entry);
-      T8_SAVE_CHECK_CLOSE (ret == 2, fp);
-      face_neighbors[iface] = neighbor;
-      ttf[iface] = ttf_entry;
-    }
-    vertices = SC_REALLOC (vertices, double, 3 * num_vertices);
-    for (att = 0; att < tree->num_attributes; att++) {
-      /* Loop over all attributes of this tree that we need to read */
-      /* Check whether this attribute really belongs to tree */
-      T8_SAVE_CHECK_CLOSE (treeid == (long) itree, fp);
-      ret = fscanf (fp, "id %i\nkey %i\n", &att_struct.package_id, &att_struct.key);
-      T8_SAVE_CHECK_CLOSE (ret == 2, fp);
-      /* We currently only support vertices as attributes.
-       * Those have t8 package id and key 0 */
-      T8_SAVE_CHECK_CLOSE (att_struct.package_id > 0 && att_struct.key == 0, fp);
-      /* TODO: We set the package id to match the one of t8code manually.
-       * See the comment above. */
-      att_struct.package_id = t8_get_package_id ();
-
-      /* read the size of the attribute */
-      ret = fscanf (fp, "size %zu\n", &att_struct.attr_size);
-      T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-      /* Read the vertices */
-      for (i = 0; i < num_vertices; i++) {
-        ret = fscanf (fp, "%lf %lf %lf\n", vertices + 3 * i, vertices + 3 * i + 1, vertices + 3 * i + 2);
-        T8_SAVE_CHECK_CLOSE (ret == 3, fp);
-      }
-      att_struct.attr_data = vertices;
-      att_struct.is_owned = 0;
-      att_struct.id = itree + cmesh->first_tree;
-      /* Now we read the attribute and can add it to the tree */
-      t8_cmesh_trees_add_attribute (cmesh->trees, 0, &att_struct, itree, 0);
-    }
-  }
-  SC_FREE (vertices);
-  return 1;
+  return t8_cmesh_save_faces_pos (header) + header->num_trees * T8_ECLASS_MAX_FACES * sizeof (t8_cmesh_save_face_t);
 }
 
-static int
-t8_cmesh_save_tree_attribute (const t8_cmesh_t cmesh, FILE *fp)
-{
-  double *vertices;
-  t8_locidx_t itree;
-  t8_ctree_t tree;
-  int num_vertices;
-  int ret, i;
-  size_t att_size;
-  t8_locidx_t *face_neigh;
-  int8_t *ttf;
-  int num_faces;
-  char buffer[BUFSIZ] = "";
-
-  ret = fprintf (fp, "\n--- Tree attribute section ---\n");
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  /* For each tree, write its attribute */
-  for (itree = 0; itree < cmesh->num_local_trees; itree++) {
-    /* TODO: Currently we only support storing of the tree vertices as only attribute.
-     *        This attribute has package id t8_get_package_id() and key 0.
-     */
-    tree = t8_cmesh_trees_get_tree_ext (cmesh->trees, itree, &face_neigh, &ttf);
-    ret = fprintf (fp, "\ntree %li\n", (long) itree);
-    /* Iterate over all faces to write the face neighbor information */
-    num_faces = t8_eclass_num_faces[tree->eclass];
-    for (i = 0; i < num_faces; i++) {
-      snprintf (buffer + strlen (buffer), BUFSIZ - strlen (buffer), "%li %i%s", (long) face_neigh[i], ttf[i],
-                i == num_faces - 1 ? "" : ", ");
-    }
-    ret = fprintf (fp, "Neighbors: %s\n", buffer);
-    /* Clear the buffer such that strlen returns 0 */
-    buffer[0] = '\0';
-    T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-    num_vertices = t8_eclass_num_vertices[tree->eclass];
-    /* Write the attributes that are vertices */
-    vertices = (double *) t8_cmesh_trees_get_attribute (cmesh->trees, itree, t8_get_package_id (), 0, &att_size, 0);
-    if (vertices != NULL) {
-      /* We have an attribute that is stored with key 0, we treat it as tree vertices */
-      num_vertices = t8_eclass_num_vertices[tree->eclass];
-      /* additional check that the attribute has as many bytes as the
-       * coordinates for this tree */
-      if (att_size != num_vertices * 3 * sizeof (double)) {
-        /* TODO: We currently do not support saving of attributes different
-         * to the tree vertices */
-        fclose (fp);
-        t8_errorf ("We do not support saving cmeshes with trees that "
-                   "have attributes different to the tree vertices.\n");
-        return 0;
-      }
-      ret = fprintf (fp, "id %i\nkey %i\n", t8_get_package_id (), 0);
-      T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-      ret = fprintf (fp, "size %zd\n", num_vertices * 3 * sizeof (double));
-      T8_ASSERT (strlen (buffer) == 0);
-      for (i = 0; i < num_vertices; i++) {
-        /* For each vertex, we write its three coordinates in a line */
-        snprintf (buffer + strlen (buffer), BUFSIZ - strlen (buffer), "%e %e %e\n", vertices[3 * i],
-                  vertices[3 * i + 1], vertices[3 * i + 2]);
-      }
-      fprintf (fp, "%s", buffer);
-      /* Clear the buffer such that strlen returns 0 */
-      buffer[0] = '\0';
-    }
-  }
-  return 1;
-}
-
-static int
-t8_cmesh_save_trees (const t8_cmesh_t cmesh, FILE *fp)
+static size_t
+t8_cmesh_save_attributes_pos (const t8_cmesh_save_header_t *header)
 {
-  t8_locidx_t itree;
-  t8_ctree_t tree;
-  int ret;
-
-  T8_ASSERT (fp != NULL);
-  ret = fprintf (fp, "Total bytes for trees and ghosts %zd\n", t8_cmesh_trees_size (cmesh->trees));
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-
-  ret = fprintf (fp, "\n--- Tree section ---");
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  ret = fprintf (fp, "\n\nTrees %li\n\n", (long) cmesh->num_local_trees);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-
-  /* For each tree, write its metadata */
-  for (itree = 0; itree < cmesh->num_local_trees; itree++) {
-    tree = t8_cmesh_trees_get_tree (cmesh->trees, itree);
-    ret = fprintf (fp, "eclass %i\n", (int) tree->eclass);
-    T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-    if (tree->num_attributes != 1) {
-      /* TODO: We currently do not support saving of attributes different
-       * to the tree vertices */
-      fclose (fp);
-      t8_errorf ("We do not support saving cmeshes with trees that have attributes different to the tree vertices.\n");
-      return 0;
-    }
-    ret = fprintf (fp, "num_attributes %i\nSize of attributes %zd\n\n", tree->num_attributes,
-                   t8_cmesh_trees_attribute_size (tree));
-    T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  }
-  return 1;
+  return t8_cmesh_save_vertices_pos (header) + header->num_trees * T8_CMESH_SAVE_NUM_COORDS * sizeof (double);
 }
 
-/* Load all tree data (eclasses, neighbors, vertex coordinates,...)
- * from a cmesh file into a cmesh */
-static int
-t8_cmesh_load_trees (const t8_cmesh_t cmesh, FILE *fp)
+/* The number of bytes an attribute occupies in the attribute section */
+static size_t
+t8_cmesh_save_attribute_bytes (const size_t size)
 {
-  size_t bytes_for_trees, att_bytes;
-  t8_locidx_t itree;
-  int eclass, num_atts;
-  int ret;
-  long num_trees;
-
-  ret = fscanf (fp, "Total bytes for trees and ghosts %zu\n", &bytes_for_trees);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp); /* The bytes_for_trees data is currently not used */
-  ret = fscanf (fp, "\n--- Tree section ---\n");
-  T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-  t8_cmesh_trees_init (&cmesh->trees, 1, cmesh->num_local_trees, cmesh->num_ghosts);
-  t8_cmesh_trees_start_part (cmesh->trees, 0, 0, cmesh->num_local_trees, 0, cmesh->num_ghosts, 1);
-  /* Read the number of trees to come and check for consistency */
-  ret = fscanf (fp, "Trees %li\n", &num_trees);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-  T8_SAVE_CHECK_CLOSE (num_trees == cmesh->num_local_trees, fp);
-  /* Read all the trees from the file and add them to the
-   * trees structure */
-  for (itree = 0; itree < cmesh->num_local_trees; itree++) {
-    ret = fscanf (fp, "eclass %i\n", &eclass);
-    T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-    t8_cmesh_trees_add_tree (cmesh->trees, itree, 0, (t8_eclass_t) eclass);
-
-    /* After adding the tree, we set its face neighbors and face orientation */
-    (void) t8_cmesh_trees_get_tree (cmesh->trees, itree);
-    /* Check whether the number of attribute is really 1 */
-    ret = fscanf (fp, "num_attributes %i\nSize of attributes %zu\n", &num_atts, &att_bytes);
-    T8_SAVE_CHECK_CLOSE (ret == 2, fp);
-    T8_SAVE_CHECK_CLOSE (num_atts == 1, fp);
-    T8_SAVE_CHECK_CLOSE (att_bytes == 3 * sizeof (double) * t8_eclass_num_vertices[eclass], fp);
-    /* If there really is one attribute it must be the trees vertices and thus
-     * we initialize the tree's attribute accordingly */
-    t8_cmesh_trees_init_attributes (cmesh->trees, itree, 1, att_bytes);
-  }
-  return 1;
+  return sizeof (t8_cmesh_save_attribute_t) + (size + 7) / 8 * 8;
 }
 
+/* Whether an attribute is stored in the attribute section. The vertices
+ * have their own section and the geometry is restored on loading. */
 static int
-t8_cmesh_save_header (const t8_cmesh_t cmesh, FILE *fp)
+t8_cmesh_save_attribute_is_stored (const t8_attribute_info_struct_t *info)
 {
-  int ret;
-  int eclass;
-
-  T8_ASSERT (fp != NULL);
-  ret = fprintf (fp, "This is %s, file format version %u.\n\n", t8_get_package_string (), T8_CMESH_FORMAT);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-
-  /* Write 0 for replicated and 1 for partitioned cmesh */
-  ret = fprintf (fp, "Partitioned %i\n", cmesh->set_partition != 0);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-
-  /* Write the rank of this process and the total number pf processes */
-  ret = fprintf (fp, "Rank %i of %i\n", cmesh->mpirank, cmesh->mpisize);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-
-  /* Write the dimension of the cmesh */
-  ret = fprintf (fp, "dim %i\n", cmesh->dimension);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-
-  /* Write the number of global and local trees and the number of ghosts */
-  ret = fprintf (fp, "num_trees %lli\n", (long long) cmesh->num_trees);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  ret = fprintf (fp, "num_local_trees %li\n", (long) cmesh->num_local_trees);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  ret = fprintf (fp, "num_ghosts %li\n", (long) cmesh->num_ghosts);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-
-  /* Write the number of local trees for each eclass */
-  ret = fprintf (fp, "num_local_trees_per_eclass ");
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  for (eclass = T8_ECLASS_ZERO; eclass < T8_ECLASS_COUNT; eclass++) {
-    ret = fprintf (fp, "%li%s", (long) cmesh->num_local_trees_per_eclass[eclass],
-                   eclass == T8_ECLASS_COUNT - 1 ? "\n" : ", ");
-    T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  }
-  /* Write the number of trees for each eclass */
-  ret = fprintf (fp, "num_trees_per_eclass ");
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  for (eclass = T8_ECLASS_ZERO; eclass < T8_ECLASS_COUNT; eclass++) {
-    ret = fprintf (fp, "%lli%s", (long long) cmesh->num_trees_per_eclass[eclass],
-                   eclass == T8_ECLASS_COUNT - 1 ? "\n" : ", ");
-    T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  }
-
-  /* Write the global id of the first local tree and if the first tree is shared */
-  ret = fprintf (fp, "first_tree %lli\n", (long long) cmesh->first_tree);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  ret = fprintf (fp, "first_tree_shared %i\n", cmesh->first_tree_shared);
-  T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-  return 1;
+  return info->package_id != t8_get_package_id ()
+         || (info->key != T8_CMESH_VERTICES_ATTRIBUTE_KEY && info->key != T8_CMESH_GEOMETRY_ATTRIBUTE_KEY);
 }
 
-/* Read the number of trees, dimension, etc. from a saved cmesh file.
- * If anything goes wrong, the file is closed and 0 is returned */
-static int
-t8_cmesh_load_header (const t8_cmesh_t cmesh, FILE *fp)
+/* Return the element class of a local tree or ghost */
+static t8_eclass_t
+t8_cmesh_save_get_eclass (const t8_cmesh_t cmesh, const t8_locidx_t local_id)
 {
-  int file_format, save_rank, save_mpisize;
-  int ieclass;
-  int ret;
-  long long global_num_trees, tree_per_class, first_local_tree;
-  long local_num_trees, local_num_ghosts;
-  int first_shared;
-
-  /* Check whether the file was saved with the current file format */
-  ret = fscanf (fp, "This is %*[^ ] %*[^ ] file format version %i.\n", &file_format);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-  if (file_format != T8_CMESH_FORMAT) {
-    /* The file was saved with an old format and we cannot read it any more */
-    t8_errorf ("Input file is in an old format that we cannot read anymore.\n");
-    fclose (fp);
-    return 0;
-  }
-
-  /* Read whether the cmesh is partitioned, its dimension and the number of
-   * trees. Also read which MPI rank wrote the file */
-  ret = fscanf (fp, "Partitioned %i\n", &cmesh->set_partition);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-  ret = fscanf (fp, "Rank %i of %i\n", &save_rank, &save_mpisize);
-  T8_SAVE_CHECK_CLOSE (ret == 2, fp);
-  /* Check if the rank and mpisize stored were valid */
-  T8_SAVE_CHECK_CLOSE (0 <= save_rank && save_rank < save_mpisize, fp);
-  /* It does not make sense to load a cmesh on a rank smaller than the one that
-   * saved it. */
-  T8_SAVE_CHECK_CLOSE (cmesh->mpirank <= save_rank && cmesh->mpisize <= save_mpisize, fp);
-  ret = fscanf (fp, "dim %i\n", &cmesh->dimension);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-  /* Check if the read dimension is in the correct range */
-  T8_SAVE_CHECK_CLOSE (cmesh->dimension >= 0 && cmesh->dimension <= 3, fp);
-  /* Since t8_gloidx_t and t8_locidx_t are integer datatypes that are not fixed,
-   * we first read the tree numbers into fixed datatypes (long long for gloidx and
-   * long for locidx) */
-  ret = fscanf (fp, "num_trees %lli\nnum_local_trees %li\n", &global_num_trees, &local_num_trees);
-  T8_SAVE_CHECK_CLOSE (ret == 2, fp);
-  T8_SAVE_CHECK_CLOSE (local_num_trees <= global_num_trees, fp);
-  cmesh->num_trees = (t8_gloidx_t) global_num_trees;
-  cmesh->num_local_trees = (t8_locidx_t) local_num_trees;
-  /* Read the number of ghost trees */
-  ret = fscanf (fp, "num_ghosts %li\n", &local_num_ghosts);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-  T8_SAVE_CHECK_CLOSE (0 <= local_num_ghosts && local_num_ghosts < cmesh->num_trees, fp);
-  cmesh->num_ghosts = local_num_ghosts;
-
-  /* Read the number of local trees per eclass */
-  ret = fscanf (fp, "num_local_trees_per_eclass");
-  T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-  for (ieclass = T8_ECLASS_ZERO; ieclass < T8_ECLASS_COUNT; ieclass++) {
-    ret = fscanf (fp, "%lli,", &tree_per_class);
-    T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-    cmesh->num_local_trees_per_eclass[ieclass] = (t8_locidx_t) tree_per_class;
-  }
-  /* Read the number of trees per eclass */
-  ret = fscanf (fp, "\nnum_trees_per_eclass");
-  T8_SAVE_CHECK_CLOSE (ret == 0, fp);
-  for (ieclass = T8_ECLASS_ZERO; ieclass < T8_ECLASS_COUNT; ieclass++) {
-    ret = fscanf (fp, "%lli,", &tree_per_class);
-    T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-    cmesh->num_trees_per_eclass[ieclass] = (t8_gloidx_t) tree_per_class;
+  if (local_id < cmesh->num_local_trees) {
+    return t8_cmesh_get_tree_class (cmesh, local_id);
   }
-  /* Read the first local tree id and whether the first tree is shared */
-  ret = fscanf (fp, "\nfirst_tree %lli\n", &first_local_tree);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-  T8_SAVE_CHECK_CLOSE (0 <= first_local_tree && first_local_tree < global_num_trees, fp);
-  cmesh->first_tree = first_local_tree;
-  ret = fscanf (fp, "first_tree_shared %i\n", &first_shared);
-  T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-  cmesh->first_tree_shared = first_shared;
-  T8_SAVE_CHECK_CLOSE (!cmesh->set_partition || cmesh->first_tree_shared == 0 || cmesh->first_tree_shared == 1, fp);
-  return 1;
+  return t8_cmesh_get_ghost_class (cmesh, local_id - cmesh->num_local_trees);
 }
 
 int
-t8_cmesh_save (const t8_cmesh_t cmesh, const char *fileprefix)
+t8_cmesh_save (const t8_cmesh_t cmesh, const char *fileprefix, sc_MPI_Comm comm)
 {
-  FILE *fp;
+  t8_cmesh_save_header_t header;
+  t8_mpi_file_t file;
   char filename[BUFSIZ];
   int has_linear_geom = 0;
+  int success = 1, global_success, mpiret;
 
   T8_ASSERT (t8_cmesh_is_committed (cmesh));
-  if (!cmesh->set_partition && cmesh->mpirank != 0) {
-    /* If the cmesh is replicated, only rank 0 writes it */
-    return 1;
-  }
+  T8_ASSERT (t8_cmesh_comm_is_valid (cmesh, comm));
 
   /* Check that the only registered geometry is the linear geometry and
    * that this geometry is used for all trees. */
@@ -537,368 +168,491 @@ t8_cmesh_save (const t8_cmesh_t cmesh, const char *fileprefix)
     return 0;
   }
 
-  /* Create the output filename as fileprefix_RANK.cmesh,
-   * where we write RANK with 4 significant figures. */
-  snprintf (filename, BUFSIZ, "%s_%04i.cmesh", fileprefix, cmesh->mpirank);
-
-  /* Open the file in write mode */
-  fp = fopen (filename, "w");
-  if (fp == NULL) {
-    /* Could not open file */
-    t8_errorf ("Error when opening file %s.\n", filename);
-    return 0;
+  /* Determine the trees that this process writes. A tree shared with the
+   * previous process is written by that process. If the cmesh is replicated,
+   * only rank 0 writes. */
+  t8_locidx_t first_ltree = 0;
+  t8_locidx_t num_write = cmesh->num_local_trees;
+  if (cmesh->set_partition) {
+    first_ltree = cmesh->first_tree_shared;
+    num_write -= first_ltree;
+  }
+  else if (cmesh->mpirank != 0) {
+    num_write = 0;
+  }
+  const t8_gloidx_t first_gtree = cmesh->first_tree + first_ltree;
+
+  /* Fill the tree, face and vertex records and count the attribute bytes */
+  t8_cmesh_save_tree_t *trees = T8_ALLOC_ZERO (t8_cmesh_save_tree_t, num_write);
+  t8_cmesh_save_face_t *faces = T8_ALLOC_ZERO (t8_cmesh_save_face_t, num_write * T8_ECLASS_MAX_FACES);
+  double *vertices = T8_ALLOC_ZERO (double, num_write * T8_CMESH_SAVE_NUM_COORDS);
+  int64_t local_attribute_bytes = 0;
+  for (t8_locidx_t iwrite = 0; iwrite < num_write; iwrite++) {
+    const t8_locidx_t itree = first_ltree + iwrite;
+    t8_locidx_t *face_neigh;
+    int8_t *ttf;
+    const t8_ctree_t tree = t8_cmesh_trees_get_tree_ext (cmesh->trees, itree, &face_neigh, &ttf);
+    const int num_faces = t8_eclass_num_faces[tree->eclass];
+
+    trees[iwrite].eclass = tree->eclass;
+    trees[iwrite].attribute_offset = local_attribute_bytes;
+    for (int iface = 0; iface < T8_ECLASS_MAX_FACES; iface++) {
+      t8_cmesh_save_face_t *face = faces + iwrite * T8_ECLASS_MAX_FACES + iface;
+      if (iface < num_faces) {
+        face->neighbor = t8_cmesh_get_global_id (cmesh, face_neigh[iface]);
+        face->tree_to_face = ttf[iface];
+        face->neighbor_eclass = t8_cmesh_save_get_eclass (cmesh, face_neigh[iface]);
+      }
+      else {
+        face->neighbor = -1;
+      }
+    }
+    const double *tree_vertices = t8_cmesh_get_tree_vertices (cmesh, itree);
+    if (tree_vertices == NULL) {
+      t8_errorf ("Error when saving cmesh. Tree %lli has no vertices.\n", (long long) (cmesh->first_tree + itree));
+      success = 0;
+    }
+    else {
+      memcpy (vertices + iwrite * T8_CMESH_SAVE_NUM_COORDS, tree_vertices,
+              3 * t8_eclass_num_vertices[tree->eclass] * sizeof (double));
+    }
+    for (int iatt = 0; iatt < tree->num_attributes; iatt++) {
+      const t8_attribute_info_struct_t *info = T8_TREE_ATTR_INFO (tree, iatt);
+      if (t8_cmesh_save_attribute_is_stored (info)) {
+        trees[iwrite].num_attributes++;
+        local_attribute_bytes += t8_cmesh_save_attribute_bytes (info->attribute_size);
+      }
+    }
+    trees[iwrite].attribute_bytes = local_attribute_bytes - trees[iwrite].attribute_offset;
+  }
+
+  /* Serialize the attributes of the local trees */
+  char *attributes = T8_ALLOC_ZERO (char, local_attribute_bytes);
+  char *attribute_pos = attributes;
+  for (t8_locidx_t iwrite = 0; iwrite < num_write; iwrite++) {
+    const t8_ctree_t tree = t8_cmesh_trees_get_tree (cmesh->trees, first_ltree + iwrite);
+    for (int iatt = 0; iatt < tree->num_attributes; iatt++) {
+      const t8_attribute_info_struct_t *info = T8_TREE_ATTR_INFO (tree, iatt);
+      if (t8_cmesh_save_attribute_is_stored (info)) {
+        t8_cmesh_save_attribute_t entry;
+        entry.package_id = info->package_id;
+        entry.key = info->key;
+        entry.size = info->attribute_size;
+        memcpy (attribute_pos, &entry, sizeof (entry));
+        memcpy (attribute_pos + sizeof (entry), T8_TREE_ATTR (tree, info), info->attribute_size);
+        attribute_pos += t8_cmesh_save_attribute_bytes (info->attribute_size);
+      }
+    }
   }
-  /* Write all metadata of the cmesh */
-  if (!t8_cmesh_save_header (cmesh, fp)) {
+  T8_ASSERT (attribute_pos == attributes + local_attribute_bytes);
+
+  /* Compute the position of our attributes in the attribute section */
+  int64_t attribute_offset;
+  mpiret = sc_MPI_Scan (&local_attribute_bytes, &attribute_offset, 1, sc_MPI_LONG_LONG_INT, sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+  attribute_offset -= local_attribute_bytes;
+  for (t8_locidx_t iwrite = 0; iwrite < num_write; iwrite++) {
+    trees[iwrite].attribute_offset += attribute_offset;
+  }
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, "T8CMESH", 8);
+  header.format = T8_CMESH_FORMAT;
+  header.dimension = cmesh->dimension;
+  header.num_trees = cmesh->num_trees;
+  mpiret = sc_MPI_Allreduce (&local_attribute_bytes, &header.attribute_bytes, 1, sc_MPI_LONG_LONG_INT, sc_MPI_SUM,
+                             comm);
+  SC_CHECK_MPI (mpiret);
+
+  /* Create the output filename as fileprefix.cmesh and write the sections */
+  snprintf (filename, BUFSIZ, "%s.cmesh", fileprefix);
+  if (!t8_mpi_file_open (comm, filename, 1, &file)) {
     t8_errorf ("Error when opening file %s.\n", filename);
+    T8_FREE (trees);
+    T8_FREE (faces);
+    T8_FREE (vertices);
+    T8_FREE (attributes);
     return 0;
   }
-  /* Write all metadata of the trees */
-  if (!t8_cmesh_save_trees (cmesh, fp)) {
-    t8_errorf ("Error when opening file %s.\n", filename);
-    return 0;
+  if (cmesh->mpirank == 0) {
+    success = t8_mpi_file_write_at (&file, 0, &header, 1, sizeof (header)) && success;
+  }
+  const size_t trees_pos = t8_cmesh_save_trees_pos () + first_gtree * sizeof (t8_cmesh_save_tree_t);
+  success = t8_mpi_file_write_at_all (&file, trees_pos, trees, num_write, sizeof (t8_cmesh_save_tree_t)) && success;
+  const size_t faces_pos
+    = t8_cmesh_save_faces_pos (&header) + first_gtree * T8_ECLASS_MAX_FACES * sizeof (t8_cmesh_save_face_t);
+  success = t8_mpi_file_write_at_all (&file, faces_pos, faces, num_write * T8_ECLASS_MAX_FACES,
+                                      sizeof (t8_cmesh_save_face_t))
+            && success;
+  const size_t vertices_pos
+    = t8_cmesh_save_vertices_pos (&header) + first_gtree * T8_CMESH_SAVE_NUM_COORDS * sizeof (double);
+  success = t8_mpi_file_write_at_all (&file, vertices_pos, vertices, num_write * T8_CMESH_SAVE_NUM_COORDS,
+                                      sizeof (double))
+            && success;
+  const size_t attributes_pos = t8_cmesh_save_attributes_pos (&header) + attribute_offset;
+  success = t8_mpi_file_write_at_all (&file, attributes_pos, attributes, local_attribute_bytes, 1) && success;
+  success = t8_mpi_file_close (&file) && success;
+
+  T8_FREE (trees);
+  T8_FREE (faces);
+  T8_FREE (vertices);
+  T8_FREE (attributes);
+
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_errorf ("Error when writing cmesh to file %s.\n", filename);
   }
-  if (cmesh->set_partition) {
-    /* Write all ghost metadata */
-    if (!t8_cmesh_save_ghosts (cmesh, fp)) {
-      t8_errorf ("Error when opening file %s.\n", filename);
-      return 0;
+  return global_success;
+}
+
+/* Read the header of a cmesh file on process zero and broadcast it.
+ * Returns true if the header is valid. */
+static int
+t8_cmesh_load_header (t8_mpi_file_t *file, sc_MPI_Comm comm, t8_cmesh_save_header_t *header)
+{
+  int success = 1, mpirank, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  if (mpirank == 0) {
+    success = t8_mpi_file_read_at (file, 0, header, 1, sizeof (*header));
+    if (success && !memcmp (header->magic, "This is ", 8)) {
+      /* The files of the per process text format start with the package string */
+      t8_errorf ("The file was written by t8_cmesh_save in the old per process text format, "
+                 "which cannot be read anymore. Please save the cmesh again.\n");
+      success = 0;
+    }
+    else if (success && memcmp (header->magic, "T8CMESH", 8)) {
+      t8_errorf ("Not a t8code cmesh file.\n");
+      success = 0;
+    }
+    else if (success && header->format != T8_CMESH_FORMAT) {
+      /* The file was saved with an old format and we cannot read it any more */
+      t8_errorf ("Input file is in an old format that we cannot read anymore.\n");
+      success = 0;
     }
   }
-  if (!t8_cmesh_save_tree_attribute (cmesh, fp)) {
-    /* Write all tree attributes */
-    t8_errorf ("Error when opening file %s.\n", filename);
-    return 0;
+  mpiret = sc_MPI_Bcast (&success, 1, sc_MPI_INT, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  if (success) {
+    mpiret = sc_MPI_Bcast (header, sizeof (*header), sc_MPI_BYTE, 0, comm);
+    SC_CHECK_MPI (mpiret);
   }
-  if (cmesh->set_partition) {
-    /* Write all ghost neighbor data */
-    if (!t8_cmesh_save_ghost_neighbors (cmesh, fp)) {
-      t8_errorf ("Error when opening file %s.\n", filename);
-      return 0;
+  return success;
+}
+
+/* Read the trees first_tree to last_tree (inclusive) from a cmesh file
+ * and add them to the stash of an initialized cmesh.
+ * If partitioned is true, we also add the classes and face connections of all
+ * neighbor trees that are not in this range as ghosts. */
+static void
+t8_cmesh_load_trees (t8_mpi_file_t *file, const t8_cmesh_save_header_t *header, const t8_cmesh_t cmesh,
+                     const t8_gloidx_t first_tree, const t8_gloidx_t last_tree, const int partitioned)
+{
+  const t8_gloidx_t num_trees = SC_MAX (0, last_tree - first_tree + 1);
+  t8_cmesh_save_tree_t *trees = T8_ALLOC (t8_cmesh_save_tree_t, num_trees);
+  t8_cmesh_save_face_t *faces = T8_ALLOC (t8_cmesh_save_face_t, num_trees * T8_ECLASS_MAX_FACES);
+  double *vertices = T8_ALLOC (double, num_trees * T8_CMESH_SAVE_NUM_COORDS);
+  int64_t attribute_range[2] = { 0, 0 };
+
+  const size_t trees_pos = t8_cmesh_save_trees_pos () + first_tree * sizeof (t8_cmesh_save_tree_t);
+  SC_CHECK_ABORT (t8_mpi_file_read_at_all (file, trees_pos, trees, num_trees, sizeof (t8_cmesh_save_tree_t)),
+                  "Could not read the trees of the cmesh file.");
+  const size_t faces_pos
+    = t8_cmesh_save_faces_pos (header) + first_tree * T8_ECLASS_MAX_FACES * sizeof (t8_cmesh_save_face_t);
+  SC_CHECK_ABORT (t8_mpi_file_read_at_all (file, faces_pos, faces, num_trees * T8_ECLASS_MAX_FACES,
+                                           sizeof (t8_cmesh_save_face_t)),
+                  "Could not read the face connections of the cmesh file.");
+  const size_t vertices_pos
+    = t8_cmesh_save_vertices_pos (header) + first_tree * T8_CMESH_SAVE_NUM_COORDS * sizeof (double);
+  SC_CHECK_ABORT (t8_mpi_file_read_at_all (file, vertices_pos, vertices, num_trees * T8_CMESH_SAVE_NUM_COORDS,
+                                           sizeof (double)),
+                  "Could not read the vertices of the cmesh file.");
+  if (num_trees > 0) {
+    attribute_range[0] = trees[0].attribute_offset;
+    attribute_range[1] = trees[num_trees - 1].attribute_offset + trees[num_trees - 1].attribute_bytes;
+  }
+  SC_CHECK_ABORT (0 <= attribute_range[0] && attribute_range[0] <= attribute_range[1]
+                    && attribute_range[1] <= header->attribute_bytes,
+                  "Invalid attribute section in the cmesh file.");
+  char *attributes = T8_ALLOC (char, attribute_range[1] - attribute_range[0]);
+  const size_t attributes_pos = t8_cmesh_save_attributes_pos (header) + attribute_range[0];
+  SC_CHECK_ABORT (t8_mpi_file_read_at_all (file, attributes_pos, attributes, attribute_range[1] - attribute_range[0],
+                                           1),
+                  "Could not read the attributes of the cmesh file.");
+
+  std::vector<std::pair<t8_gloidx_t, t8_eclass_t>> ghosts;
+  for (t8_gloidx_t itree = 0; itree < num_trees; itree++) {
+    const t8_gloidx_t gtree = first_tree + itree;
+    const t8_eclass_t eclass = (t8_eclass_t) trees[itree].eclass;
+    SC_CHECK_ABORT (T8_ECLASS_ZERO <= eclass && eclass < T8_ECLASS_COUNT, "Invalid tree class in the cmesh file.");
+    t8_cmesh_set_tree_class (cmesh, gtree, eclass);
+    t8_cmesh_set_tree_vertices (cmesh, gtree, vertices + itree * T8_CMESH_SAVE_NUM_COORDS,
+                                t8_eclass_num_vertices[eclass]);
+
+    /* Add the face connections. Each connection between two trees that we read is only added once. */
+    const int num_faces = t8_eclass_num_faces[eclass];
+    for (int iface = 0; iface < num_faces; iface++) {
+      const t8_cmesh_save_face_t *face = faces + itree * T8_ECLASS_MAX_FACES + iface;
+      int neigh_face, orientation;
+      t8_cmesh_tree_to_face_decode (header->dimension, face->tree_to_face, &neigh_face, &orientation);
+      const int is_local = first_tree <= face->neighbor && face->neighbor <= last_tree;
+      if (face->neighbor == gtree && neigh_face == iface) {
+        /* This is a domain boundary */
+        continue;
+      }
+      if (!is_local || gtree < face->neighbor || (gtree == face->neighbor && iface < neigh_face)) {
+        t8_cmesh_set_join (cmesh, gtree, face->neighbor, iface, neigh_face, orientation);
+      }
+      if (!is_local && partitioned) {
+        ghosts.emplace_back (face->neighbor, (t8_eclass_t) face->neighbor_eclass);
+      }
+    }
+
+    /* Add the attributes of the tree */
+    const char *attribute_pos = attributes + trees[itree].attribute_offset - attribute_range[0];
+    for (int iatt = 0; iatt < trees[itree].num_attributes; iatt++) {
+      t8_cmesh_save_attribute_t entry;
+      memcpy (&entry, attribute_pos, sizeof (entry));
+      t8_cmesh_set_attribute (cmesh, gtree, entry.package_id, entry.key, (void *) (attribute_pos + sizeof (entry)),
+                              entry.size, 0);
+      attribute_pos += t8_cmesh_save_attribute_bytes (entry.size);
+    }
+  }
+
+  /* Add each ghost tree once */
+  std::sort (ghosts.begin (), ghosts.end ());
+  ghosts.erase (std::unique (ghosts.begin (), ghosts.end ()), ghosts.end ());
+  for (const auto &ghost : ghosts) {
+    t8_cmesh_set_tree_class (cmesh, ghost.first, ghost.second);
+  }
+
+  /* Add the face connections of the ghosts to trees that are not local */
+  t8_cmesh_save_face_t ghost_faces[T8_ECLASS_MAX_FACES];
+  for (const auto &ghost : ghosts) {
+    const t8_gloidx_t gtree = ghost.first;
+    const size_t ghost_faces_pos
+      = t8_cmesh_save_faces_pos (header) + gtree * T8_ECLASS_MAX_FACES * sizeof (t8_cmesh_save_face_t);
+    SC_CHECK_ABORT (t8_mpi_file_read_at (file, ghost_faces_pos, ghost_faces, T8_ECLASS_MAX_FACES,
+                                         sizeof (t8_cmesh_save_face_t)),
+                    "Could not read the face connections of the cmesh file.");
+    for (int iface = 0; iface < t8_eclass_num_faces[ghost.second]; iface++) {
+      const t8_cmesh_save_face_t *face = ghost_faces + iface;
+      int neigh_face, orientation;
+      t8_cmesh_tree_to_face_decode (header->dimension, face->tree_to_face, &neigh_face, &orientation);
+      if ((first_tree <= face->neighbor && face->neighbor <= last_tree)
+          || (face->neighbor == gtree && neigh_face == iface)) {
+        /* Connections to local trees are already added, boundaries need not be added */
+        continue;
+      }
+      const int neighbor_is_ghost = std::binary_search (
+        ghosts.begin (), ghosts.end (), std::make_pair (face->neighbor, (t8_eclass_t) face->neighbor_eclass));
+      if (!neighbor_is_ghost || gtree < face->neighbor || (gtree == face->neighbor && iface < neigh_face)) {
+        t8_cmesh_set_join (cmesh, gtree, face->neighbor, iface, neigh_face, orientation);
+      }
     }
   }
-  /* Close the file */
-  fclose (fp);
-  return 1;
-}
 
-#undef T8_SAVE_CHECK_CLOSE
+  T8_FREE (trees);
+  T8_FREE (faces);
+  T8_FREE (vertices);
+  T8_FREE (attributes);
+}
 
-t8_cmesh_t
-t8_cmesh_load (const char *filename, sc_MPI_Comm comm)
+/* Load a cmesh from a file and commit it. If partitioned is true, the processes with
+ * is_reader true read equally sized contiguous ranges of trees and the other processes
+ * are empty. Otherwise all processes read all trees. */
+static t8_cmesh_t
+t8_cmesh_load_range (const char *filename, sc_MPI_Comm comm, const int partitioned, const int is_reader)
 {
-  FILE *fp;
+  t8_cmesh_save_header_t header;
+  t8_mpi_file_t file;
   t8_cmesh_t cmesh;
-  int mpiret;
+  t8_gloidx_t first_tree, last_tree;
+  int num_readers, reader_index = 0, mpirank, mpiret;
 
-  /* Open the file in read mode */
-  fp = fopen (filename, "r");
-  if (fp == NULL) {
-    /* Could not open file */
-    t8_errorf ("Error when opening file %s.\n", filename);
-    return NULL;
-  }
-  t8_cmesh_init (&cmesh);
-  /* Read all metadata of the cmesh */
-  if (!t8_cmesh_load_header (cmesh, fp)) {
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  if (!t8_mpi_file_open (comm, filename, 0, &file)) {
     t8_errorf ("Error when opening file %s.\n", filename);
-    t8_cmesh_destroy (&cmesh);
     return NULL;
   }
-  /* Read all metadata of the trees */
-  if (!t8_cmesh_load_trees (cmesh, fp)) {
+  if (!t8_cmesh_load_header (&file, comm, &header)) {
     t8_errorf ("Error when opening file %s.\n", filename);
-    t8_cmesh_destroy (&cmesh);
+    t8_mpi_file_close (&file);
     return NULL;
   }
-  if (cmesh->set_partition) {
-    /* Write all ghost metadata */
-    if (!t8_cmesh_load_ghosts (cmesh, fp)) {
-      t8_errorf ("Error when opening file %s.\n", filename);
-      t8_cmesh_destroy (&cmesh);
-      return NULL;
+
+  t8_cmesh_init (&cmesh);
+  t8_cmesh_set_dimension (cmesh, header.dimension);
+  t8_cmesh_register_geometry<t8_geometry_linear> (cmesh, header.dimension);
+  if (partitioned) {
+    /* Each reading process reads an equally sized contiguous range of trees.
+     * The other processes are empty and start at the first tree of the next reader. */
+    mpiret = sc_MPI_Allreduce (&is_reader, &num_readers, 1, sc_MPI_INT, sc_MPI_SUM, comm);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Exscan (&is_reader, &reader_index, 1, sc_MPI_INT, sc_MPI_SUM, comm);
+    SC_CHECK_MPI (mpiret);
+    if (mpirank == 0) {
+      /* The result of the exclusive scan is undefined on rank zero */
+      reader_index = 0;
     }
+    T8_ASSERT (num_readers > 0);
+    first_tree = header.num_trees * reader_index / num_readers;
+    last_tree = is_reader ? header.num_trees * (reader_index + 1) / num_readers - 1 : first_tree - 1;
+    t8_cmesh_set_partition_range (cmesh, 3, first_tree, last_tree);
   }
-  t8_cmesh_trees_finish_part (cmesh->trees, 0);
-  if (!t8_cmesh_load_tree_attributes (cmesh, fp)) {
-    t8_errorf ("Error when opening file %s.\n", filename);
-    t8_cmesh_destroy (&cmesh);
-    return NULL;
-  }
-  if (cmesh->set_partition) {
-    /* Write all ghost metadata */
-    if (!t8_cmesh_load_ghost_attributes (cmesh, fp)) {
-      t8_errorf ("Error when opening file %s.\n", filename);
-      t8_cmesh_destroy (&cmesh);
-      return NULL;
-    }
+  else {
+    first_tree = 0;
+    last_tree = header.num_trees - 1;
   }
-  /* Close the file */
-  fclose (fp);
-
-  cmesh->committed = 1;
-  mpiret = sc_MPI_Comm_rank (comm, &cmesh->mpirank);
-  SC_CHECK_MPI (mpiret);
-  mpiret = sc_MPI_Comm_size (comm, &cmesh->mpisize);
-  SC_CHECK_MPI (mpiret);
-  t8_stash_destroy (&cmesh->stash);
+  t8_cmesh_load_trees (&file, &header, cmesh, first_tree, last_tree, partitioned);
+  t8_mpi_file_close (&file);
+  t8_cmesh_commit (cmesh, comm);
   return cmesh;
 }
 
-/* Query whether a given process will open a cmesh saved file.
- * This depends on the number of processes, the number of files and
- * the load mode.
- * In load mode simple, if rank i is smaller than the number of files,
- * rank i opens file number i.
- * In load mode bgq, there must be at leas num_files compute nodes
- * and on the i-th node exactly one process opens file i.
- * This function returns true, if the given rank will load a file and
- * it stores the number of the file in file_to_load.
- */
+t8_cmesh_t
+t8_cmesh_load (const char *filename, sc_MPI_Comm comm)
+{
+  return t8_cmesh_load_range (filename, comm, 0, 1);
+}
+
+/* Return true if this process reads a range of trees in t8_cmesh_load_and_distribute.
+ * The processes are selected as described in t8_load_mode_t. */
 static int
-t8_cmesh_load_proc_loads (const int mpirank, const int mpisize, const int num_files, sc_MPI_Comm comm,
-                          const t8_load_mode_t mode, int *file_to_load, int num_procs_per_node)
+t8_cmesh_load_is_reader (sc_MPI_Comm comm, const int num_readers, const t8_load_mode_t mode, int procs_per_node)
 {
-  sc_MPI_Comm inter = sc_MPI_COMM_NULL, intra = sc_MPI_COMM_NULL;
-  int mpiret, interrank, intrarank, intersize;
+  sc_MPI_Comm intra = sc_MPI_COMM_NULL, inter = sc_MPI_COMM_NULL;
+  int mpirank, interrank, intrarank, mpiret;
 
-  if (num_procs_per_node <= 0 && mode == T8_LOAD_STRIDE) {
-    t8_global_infof ("number of processes per node set to 16\n");
-    num_procs_per_node = 16;
-  }
-  /* Fill with invalid value */
-  *file_to_load = -1;
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
   switch (mode) {
   case T8_LOAD_SIMPLE:
-    /* In simple mode, process i opens file i, if i < num_files */
-    if (mpirank < num_files) {
-      /* Open file mpirank */
-      *file_to_load = mpirank;
-      return 1;
-    }
-    else {
-      /* Do not open any files */
-      return 0;
-    }
-    break;
+    /* The first num_readers processes read */
+    return mpirank < num_readers;
   case T8_LOAD_BGQ:
-    /* In bgq mode on each shared memory node is one process that
-     * opens a file. */
-    /* Compute internode and intranode communicator */
+    /* The first process on each of the first num_readers compute nodes reads */
     sc_mpi_comm_attach_node_comms (comm, 0);
-    /* Store internode and intranode communicator */
     sc_mpi_comm_get_node_comms (comm, &intra, &inter);
-    /* Abort if we could not compute these communicators */
-    SC_CHECK_ABORT (intra != sc_MPI_COMM_NULL && inter != sc_MPI_COMM_NULL, "Could not get proper internode "
-                                                                            "and intranode communicators.\n");
-    mpiret = sc_MPI_Comm_size (inter, &intersize);
-    SC_CHECK_MPI (mpiret);
-    /* Check if the number of nodes is at least as big as the number of files */
-    SC_CHECK_ABORTF (intersize <= num_files,
-                     "Must have more compute nodes "
-                     "than files. %i nodes and %i fields are given.\n",
-                     intersize, num_files);
+    if (intra == sc_MPI_COMM_NULL || inter == sc_MPI_COMM_NULL) {
+      t8_global_errorf ("WARNING: Could not compute the node communicators. Loading in simple mode.\n");
+      return mpirank < num_readers;
+    }
     mpiret = sc_MPI_Comm_rank (inter, &interrank);
     SC_CHECK_MPI (mpiret);
     mpiret = sc_MPI_Comm_rank (intra, &intrarank);
     SC_CHECK_MPI (mpiret);
-    /* If the current node number i is smaller than the number of files
-     * than the first process on this node loads the file i */
-    if (interrank < num_files && intrarank == 0) {
-      *file_to_load = interrank;
-      return 1;
-    }
-    else {
-      return 0;
-    }
-    break;
+    return intrarank == 0 && interrank < num_readers;
   case T8_LOAD_STRIDE:
-    /* In Juqueen mode, every 16-th process loads a file. The user should
-     * control, that these processes reside on different compute nodes to
-     * gain maximal efficiency. */
-    SC_CHECK_ABORT (ceil (mpisize / (double) num_procs_per_node) >= num_files,
-                    "Too many files for too few processes.\n");
-    if (mpirank % num_procs_per_node == 0 && mpirank / num_procs_per_node < num_files) {
-      *file_to_load = mpirank / num_procs_per_node;
-      return 1;
-    }
-    else {
-      return 0;
+    /* Every procs_per_node-th process reads */
+    if (procs_per_node <= 0) {
+      t8_global_infof ("number of processes per node set to 16\n");
+      procs_per_node = 16;
     }
+    return mpirank % procs_per_node == 0 && mpirank / procs_per_node < num_readers;
   default:
     SC_ABORT_NOT_REACHED ();
   }
-  SC_ABORT_NOT_REACHED ();
+  return 0;
 }
 
-/* After we loaded a cmesh on a part of the processes, we have to correctly
- * set the first tree on the other, empty, cmeshes.
- * In load mode simple, the first tree is just the global number of trees.
- * In Load mode BGQ and JUQUEEN, we have to figure out the first tree of
- * the next bigger nonloading process.
- */
-static int
-t8_cmesh_load_bigger_nonloading (const int mpirank, const int mpisize, const int num_files, const t8_load_mode_t mode,
-                                 sc_MPI_Comm comm, const int num_procs_per_node)
+/* Create a partition table that distributes num_trees trees uniformly among the processes of comm. */
+static t8_shmem_array_t
+t8_cmesh_load_offset_uniform (sc_MPI_Comm comm, const t8_gloidx_t num_trees)
 {
-  int next_bigger_nonloading;
-  sc_MPI_Comm inter = sc_MPI_COMM_NULL, intra = sc_MPI_COMM_NULL;
-  sc_MPI_Group intragroup, commgroup;
-  int mpiret, interrank, intrarank, intrasize, commrank;
-  int rankzero;
+  t8_shmem_array_t shmem_array;
+  int mpisize, mpiret;
 
-  switch (mode) {
-  case T8_LOAD_SIMPLE:
-    /* In simple mode, the first num_files processes load the cmesh and
-     * the rest is empty, this the next bigger nonloading rank is always
-     * rank mpisize. */
-    next_bigger_nonloading = mpisize;
-    break;
-  case T8_LOAD_BGQ:
-    /* In BGQ mode, on the compute nodes with node-id bigger num_files,
-     * the first rank on a node opens the file. */
-    /* Get the inter and intra comms and our rank within these comms. */
-    sc_mpi_comm_get_node_comms (comm, &intra, &inter);
-    mpiret = sc_MPI_Comm_rank (inter, &interrank);
-    SC_CHECK_MPI (mpiret);
-    mpiret = sc_MPI_Comm_rank (intra, &intrarank);
-    SC_CHECK_MPI (mpiret);
-
-    if (interrank >= num_files - 1) {
-      /* We are beyond all processes that loaded */
-      next_bigger_nonloading = mpisize;
-    }
-    else {
-      /* We need to get the rank in comm of the first process
-       * on the next compute node. This is the process with rank 0 in our
-       * intra communicator plus the mpisize in the intracommunicator. */
-      /* First we get the groups from the communicators */
-      mpiret = sc_MPI_Comm_group (intra, &intragroup);
-      SC_CHECK_MPI (mpiret);
-      mpiret = sc_MPI_Comm_group (comm, &commgroup);
-      SC_CHECK_MPI (mpiret);
-      /* We can now transform the rank 0 of the intragroup to get
-       * the correct rank in the commgroup */
-      rankzero = 0;
-      mpiret = sc_MPI_Group_translate_ranks (intragroup, 1, &rankzero, commgroup, &commrank);
-      SC_CHECK_MPI (mpiret);
-      /* We get the size of the intracommunicator */
-      mpiret = sc_MPI_Group_size (intragroup, &intrasize);
-      SC_CHECK_MPI (mpiret);
-      next_bigger_nonloading = commrank + intrasize;
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  shmem_array = t8_cmesh_alloc_offsets (mpisize, comm);
+  if (t8_shmem_array_start_writing (shmem_array)) {
+    t8_gloidx_t *offsets = t8_shmem_array_get_gloidx_array_for_writing (shmem_array);
+    for (int iproc = 0; iproc <= mpisize; iproc++) {
+      offsets[iproc] = num_trees * iproc / mpisize;
     }
-    break;
-  case T8_LOAD_STRIDE:
-    /* In Juqueen mode, every 16-th process has opened the file. */
-    if (mpirank / num_procs_per_node < num_files - 1) {
-      /* If we are in a multiple of 16, where a file was loaded,
-       * the first process in the next group did load it. */
-      next_bigger_nonloading
-        = mpirank - mpirank % num_procs_per_node + num_procs_per_node; /* This is the next number divisible by
-                                                                                                   num_procs_per_node */
+  }
+  t8_shmem_array_end_writing (shmem_array);
+  T8_ASSERT (t8_offset_consistent (mpisize, shmem_array, num_trees));
+  return shmem_array;
+}
+
+/* Return true on all processes if the file fileprefix_0000.cmesh of the old per process
+ * format exists, but fileprefix.cmesh does not. */
+static int
+t8_cmesh_load_is_old_format (const char *fileprefix, sc_MPI_Comm comm)
+{
+  char filename[BUFSIZ];
+  int is_old = 0, mpirank, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  if (mpirank == 0) {
+    FILE *fp;
+    snprintf (filename, BUFSIZ, "%s.cmesh", fileprefix);
+    if ((fp = fopen (filename, "rb")) != NULL) {
+      fclose (fp);
     }
     else {
-      /* Every rank that loaded a file is smaller than ours. */
-      next_bigger_nonloading = mpisize;
+      snprintf (filename, BUFSIZ, "%s_%04d.cmesh", fileprefix, 0);
+      if ((fp = fopen (filename, "rb")) != NULL) {
+        fclose (fp);
+        is_old = 1;
+      }
     }
-    break;
-  default:
-    SC_ABORT_NOT_REACHED ();
   }
-  return next_bigger_nonloading;
+  mpiret = sc_MPI_Bcast (&is_old, 1, sc_MPI_INT, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  return is_old;
 }
 
-/* Load the files fileprefix_0000.cmesh, ... , fileprefix_N.cmesh
- * (N = num_files - 1)
- * on N processes and repartition the cmesh to all calling processes.
- * If N = 1, the cmesh is broadcasted and not partitioned.
- */
 t8_cmesh_t
 t8_cmesh_load_and_distribute (const char *fileprefix, const int num_files, sc_MPI_Comm comm, const t8_load_mode_t mode,
                               const int procs_per_node)
 {
+  char filename[BUFSIZ];
   t8_cmesh_t cmesh;
-  char buffer[BUFSIZ];
-  int mpiret, mpirank, mpisize;
-  int file_to_load;
-  int next_bigger_nonloading;
-  int did_load;
+  int is_reader, num_readers, mpisize, mpiret;
+
+  T8_ASSERT (fileprefix != NULL);
+  T8_ASSERT (num_files >= 1);
+  T8_ASSERT (T8_LOAD_FIRST <= mode && mode < T8_LOAD_COUNT);
 
-  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
-  SC_CHECK_MPI (mpiret);
   mpiret = sc_MPI_Comm_size (comm, &mpisize);
   SC_CHECK_MPI (mpiret);
-
-  T8_ASSERT (mpisize >= num_files);
+  if (t8_cmesh_load_is_old_format (fileprefix, comm)) {
+    t8_global_errorf ("The cmesh %s was saved in the old per process format as %s_0000.cmesh, ..., "
+                      "which cannot be read anymore. Please save the cmesh again with t8_cmesh_save.\n",
+                      fileprefix, fileprefix);
+    return NULL;
+  }
 
   /* Try to set the comm type */
   t8_shmem_init (comm);
   t8_shmem_set_type (comm, T8_SHMEM_BEST_TYPE);
 
-  /* Use cmesh_bcast, if only one process loads the cmesh: */
-  if (num_files == 1) {
-    cmesh = NULL;
-    if (mpirank == 0) {
-      snprintf (buffer, BUFSIZ, "%s_%04d.cmesh", fileprefix, 0);
-      cmesh = t8_cmesh_load (buffer, comm);
-    }
-    cmesh = t8_cmesh_bcast (cmesh, 0, comm);
+  snprintf (filename, BUFSIZ, "%s.cmesh", fileprefix);
+  t8_global_productionf ("Loading cmesh from file %s\n", filename);
+  is_reader = t8_cmesh_load_is_reader (comm, num_files, mode, procs_per_node);
+  cmesh = t8_cmesh_load_range (filename, comm, 1, is_reader);
+  if (cmesh == NULL) {
+    return NULL;
   }
-  else {
-    /* More than one process loads a file */
-
-    if (t8_cmesh_load_proc_loads (mpirank, mpisize, num_files, comm, mode, &file_to_load, procs_per_node)) {
-      T8_ASSERT (fileprefix != NULL);
-      T8_ASSERT (0 <= file_to_load && file_to_load < num_files);
-      snprintf (buffer, BUFSIZ, "%s_%04d.cmesh", fileprefix, file_to_load);
-      t8_infof ("Opening file %s\n", buffer);
-      cmesh = t8_cmesh_load (buffer, comm);
-      if (num_files == mpisize) {
-        /* Each process has loaded the cmesh and we can return */
-        return cmesh;
-      }
-      did_load = 1;
-    }
-    else {
-      did_load = 0;
-      /* On the processes that do not load the cmesh, initialize it
-       * with zero local trees and ghosts */
-      t8_cmesh_init (&cmesh);
-      t8_cmesh_trees_init (&cmesh->trees, 0, 0, 0);
-      cmesh->mpirank = mpirank;
-      cmesh->mpisize = mpisize;
-      t8_stash_destroy (&cmesh->stash);
-      /* There are no faces, so we know all about them */
-      cmesh->face_knowledge = 3;
-      /* There are no tree, thus the first tree is not shared */
-      cmesh->first_tree_shared = 0;
-      cmesh->committed = 1;
-      cmesh->set_partition = 1;
-      cmesh->num_local_trees = 0;
-    }
-    /* The cmeshes on the processes that did not load have to
-     * know the global number of trees */
-    sc_MPI_Bcast (&cmesh->num_trees, 1, T8_MPI_GLOIDX, 0, comm);
-    /* And the dimension */
-    sc_MPI_Bcast (&cmesh->dimension, 1, sc_MPI_INT, 0, comm);
-    t8_cmesh_gather_trees_per_eclass (cmesh, comm);
-    T8_ASSERT (t8_cmesh_is_committed (cmesh));
-    /* We now create the cmeshs offset in order to properly
-     * set the first tree for the empty processes */
-    t8_cmesh_gather_treecount (cmesh, comm);
-    if (!did_load) {
-      /* Calculate the next bigger nonloading rank. */
-      next_bigger_nonloading
-        = t8_cmesh_load_bigger_nonloading (mpirank, mpisize, num_files, mode, comm, procs_per_node);
-      /* Set the first tree of this process to the first tree of the next nonloading
-       * rank */
-      cmesh->first_tree
-        = t8_offset_first (next_bigger_nonloading, t8_shmem_array_get_gloidx_array (cmesh->tree_offsets));
-    }
-    /* Since we changed the first tree on some processes, we have to
-     * regather the first trees on each process */
-    t8_cmesh_gather_treecount (cmesh, comm);
+  mpiret = sc_MPI_Allreduce (&is_reader, &num_readers, 1, sc_MPI_INT, sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+  if (num_readers < mpisize) {
+    /* Distribute the trees uniformly to all processes */
+    t8_cmesh_t cmesh_uniform;
+    t8_cmesh_init (&cmesh_uniform);
+    t8_cmesh_set_derive (cmesh_uniform, cmesh);
+    t8_cmesh_set_partition_offsets (cmesh_uniform,
+                                    t8_cmesh_load_offset_uniform (comm, t8_cmesh_get_num_trees (cmesh)));
+    t8_cmesh_commit (cmesh_uniform, comm);
+    cmesh = cmesh_uniform;
   }
-  T8_ASSERT (t8_cmesh_is_committed (cmesh));
   return cmesh;
 }
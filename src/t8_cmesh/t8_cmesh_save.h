@@ -23,8 +23,7 @@
 /** \file t8_cmesh_save.h
  *
  * We define routines to save and load a cmesh to/from the file system.
- *
- * TODO: document this file
+ * A cmesh is stored in a single binary file that is written and read with MPI I/O.
  */
 
 #ifndef T8_CMESH_SAVE_H
@@ -34,22 +33,23 @@
 
 /** Increment this constant each time the file format changes.
  *  We can only read files that were written in the same format. */
-#define T8_CMESH_FORMAT 0x0002
+#define T8_CMESH_FORMAT 0x0003
 
-/** This enumeration contains all modes in which we can open a saved cmesh.
- * The cmesh can be loaded with more processes than it was saved and the
- * mode controls, which of the processes open files and distribute the data.
+/** This enumeration contains all modes in which we can load a saved cmesh
+ * with \ref t8_cmesh_load_and_distribute. The mode controls which of the
+ * processes read a range of trees of the file. The number n of reading
+ * processes is passed to \ref t8_cmesh_load_and_distribute.
  */
 typedef enum t8_load_mode {
   T8_LOAD_FIRST = 0,
-  /** In simple mode, the first n processes load the file */
+  /** In simple mode, the first n processes read the file */
   T8_LOAD_SIMPLE = T8_LOAD_FIRST,
-  /** In BGQ mode, the file is loaded on n nodes and from one process of each node.
+  /** In BGQ mode, the file is read on n nodes by one process of each node.
     * This needs MPI Version 3.1 or higher. */
   T8_LOAD_BGQ,
-  /** Every n-th process loads a file. Handle with care, we introduce
-   * it, since on Juqueen MPI-3 was not available.
-   * The parameter n has to be passed as an extra parameter.
+  /** Every k-th process reads, up to n processes. We introduced it,
+   * since on Juqueen MPI-3 was not available.
+   * The stride k has to be passed as an extra parameter.
    * \see t8_cmesh_load_and_distribute */
   T8_LOAD_STRIDE,
   T8_LOAD_COUNT
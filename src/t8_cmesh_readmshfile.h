@@ -75,6 +75,8 @@ T8_EXTERN_C_BEGIN ();
 /* put declarations here */
 
 /** Read a .msh file and create a cmesh from it.
+ * ASCII files of version 2 and 4 and binary files of version 4.1 are supported.
+ * Binary files are mapped into memory and decoded directly, cad geometry is not supported for them.
  * \param [in]    fileprefix        The prefix of the mesh file.
  *                                  The file fileprefix.msh is read.
  * \param [in]    partition         If true the file is only opened on one process
@@ -87,6 +89,12 @@ T8_EXTERN_C_BEGIN ();
  *                                  dimension to read has to be set manually.
  * \param [in]    master            If partition is true, a valid MPI rank that will
  *                                  read the file and store all the trees alone.
+ *                                  If partition is true and \a master is negative, all processes
+ *                                  read a part of the file in parallel. The file is split into
+ *                                  byte ranges of equal size and each process gets the trees whose
+ *                                  element lines start in its range, so the number of trees per
+ *                                  process may vary. This is supported for ASCII files of version 4
+ *                                  without cad geometry, otherwise process 0 reads the file.
  * \param [in]    use_cad_geometry  Read the parameters of a parametric msh file and use the
  *                                  cad geometry.
  * \return        A committed cmesh holding the mesh of dimension \a dim in the
@@ -0,0 +1,147 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_data/t8_mpi_file.h>
+
+int
+t8_mpi_file_open (sc_MPI_Comm comm, const char *filename, int for_writing, t8_mpi_file_t *file)
+{
+  int success, global_success, mpiret;
+
+#if T8_ENABLE_MPIIO
+  const int amode = for_writing ? MPI_MODE_WRONLY | MPI_MODE_CREATE : MPI_MODE_RDONLY;
+  success = MPI_File_open (comm, (char *) filename, amode, MPI_INFO_NULL, &file->fh) == MPI_SUCCESS;
+  if (success && for_writing) {
+    /* Truncate a possibly existing file */
+    success = MPI_File_set_size (file->fh, 0) == MPI_SUCCESS;
+  }
+#else
+  if (for_writing) {
+    int mpirank;
+
+    /* Process zero creates or truncates the file, afterwards all processes open it */
+    mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+    SC_CHECK_MPI (mpiret);
+    if (mpirank == 0) {
+      FILE *fp = fopen (filename, "wb");
+      if (fp != NULL) {
+        fclose (fp);
+      }
+    }
+    mpiret = sc_MPI_Barrier (comm);
+    SC_CHECK_MPI (mpiret);
+  }
+  file->fp = fopen (filename, for_writing ? "r+b" : "rb");
+  success = file->fp != NULL;
+#endif
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_errorf ("Error when opening file %s.\n", filename);
+#if T8_ENABLE_MPIIO
+    if (success) {
+      MPI_File_close (&file->fh);
+    }
+#else
+    if (success) {
+      fclose (file->fp);
+    }
+#endif
+  }
+  return global_success;
+}
+
+int
+t8_mpi_file_close (t8_mpi_file_t *file)
+{
+#if T8_ENABLE_MPIIO
+  return MPI_File_close (&file->fh) == MPI_SUCCESS;
+#else
+  return fclose (file->fp) == 0;
+#endif
+}
+
+/* Read or write count items of item_size bytes at a byte offset of the file. */
+static int
+t8_mpi_file_access (t8_mpi_file_t *file, int do_write, int collective, size_t offset, void *buffer, size_t count,
+                    size_t item_size)
+{
+  T8_ASSERT (count <= (size_t) INT_MAX);
+  T8_ASSERT (item_size > 0 && item_size <= (size_t) INT_MAX);
+#if T8_ENABLE_MPIIO
+  {
+    MPI_Datatype item_type;
+    int mpiret;
+
+    /* We use a contiguous type per item, such that large data still has an int count */
+    mpiret = MPI_Type_contiguous ((int) item_size, MPI_BYTE, &item_type);
+    SC_CHECK_MPI (mpiret);
+    mpiret = MPI_Type_commit (&item_type);
+    SC_CHECK_MPI (mpiret);
+    if (do_write) {
+      mpiret = collective ? MPI_File_write_at_all (file->fh, offset, buffer, count, item_type, MPI_STATUS_IGNORE)
+                          : MPI_File_write_at (file->fh, offset, buffer, count, item_type, MPI_STATUS_IGNORE);
+    }
+    else {
+      mpiret = collective ? MPI_File_read_at_all (file->fh, offset, buffer, count, item_type, MPI_STATUS_IGNORE)
+                          : MPI_File_read_at (file->fh, offset, buffer, count, item_type, MPI_STATUS_IGNORE);
+    }
+    MPI_Type_free (&item_type);
+    return mpiret == MPI_SUCCESS;
+  }
+#else
+  if (count == 0) {
+    return 1;
+  }
+  if (fseek (file->fp, offset, SEEK_SET) != 0) {
+    return 0;
+  }
+  if (do_write) {
+    return fwrite (buffer, item_size, count, file->fp) == count;
+  }
+  return fread (buffer, item_size, count, file->fp) == count;
+#endif
+}
+
+int
+t8_mpi_file_write_at (t8_mpi_file_t *file, size_t offset, const void *buffer, size_t count, size_t item_size)
+{
+  return t8_mpi_file_access (file, 1, 0, offset, (void *) buffer, count, item_size);
+}
+
+int
+t8_mpi_file_write_at_all (t8_mpi_file_t *file, size_t offset, const void *buffer, size_t count, size_t item_size)
+{
+  return t8_mpi_file_access (file, 1, 1, offset, (void *) buffer, count, item_size);
+}
+
+int
+t8_mpi_file_read_at (t8_mpi_file_t *file, size_t offset, void *buffer, size_t count, size_t item_size)
+{
+  return t8_mpi_file_access (file, 0, 0, offset, buffer, count, item_size);
+}
+
+int
+t8_mpi_file_read_at_all (t8_mpi_file_t *file, size_t offset, void *buffer, size_t count, size_t item_size)
+{
+  return t8_mpi_file_access (file, 0, 1, offset, buffer, count, item_size);
+}
@@ -0,0 +1,102 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_mpi_file.h
+ * We define a thin layer for reading and writing a single binary file
+ * from all processes of a communicator.
+ * If MPI I/O is enabled, all processes share one MPI file handle. Otherwise
+ * each process opens the file with the C standard library and accesses
+ * its own byte range.
+ */
+
+#ifndef T8_MPI_FILE_H
+#define T8_MPI_FILE_H
+
+#include <t8.h>
+
+/** A file that is opened on all processes of a communicator. */
+typedef struct
+{
+#if T8_ENABLE_MPIIO
+  sc_MPI_File fh; /**< The MPI file handle. */
+#else
+  FILE *fp; /**< The process local file pointer. */
+#endif
+} t8_mpi_file_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Open a file on all processes of a communicator.
+ * This function is collective.
+ * \param [in]  comm        The MPI communicator.
+ * \param [in]  filename    The name of the file.
+ * \param [in]  for_writing If true, the file is created or truncated and opened for writing.
+ *                          Otherwise, it is opened for reading.
+ * \param [out] file        On success, the opened file.
+ * \return True on all processes if the file could be opened on all processes, false otherwise.
+ */
+int
+t8_mpi_file_open (sc_MPI_Comm comm, const char *filename, int for_writing, t8_mpi_file_t *file);
+
+/** Close a file opened with \ref t8_mpi_file_open.
+ * This function is collective.
+ * \param [in,out] file     The file.
+ * \return True if successful.
+ */
+int
+t8_mpi_file_close (t8_mpi_file_t *file);
+
+/** Write items to a file at a given byte offset from this process only.
+ * \param [in]  file        The file.
+ * \param [in]  offset      The byte offset in the file.
+ * \param [in]  buffer      The data to write.
+ * \param [in]  count       The number of items to write. Must fit into an int.
+ * \param [in]  item_size   The number of bytes of one item.
+ * \return True if successful.
+ */
+int
+t8_mpi_file_write_at (t8_mpi_file_t *file, size_t offset, const void *buffer, size_t count, size_t item_size);
+
+/** Collective version of \ref t8_mpi_file_write_at. Must be called on all processes,
+ * possibly with \a count zero. */
+int
+t8_mpi_file_write_at_all (t8_mpi_file_t *file, size_t offset, const void *buffer, size_t count, size_t item_size);
+
+/** Read items from a file at a given byte offset on this process only.
+ * \param [in]  file        The file.
+ * \param [in]  offset      The byte offset in the file.
+ * \param [out] buffer      Memory for \a count items.
+ * \param [in]  count       The number of items to read. Must fit into an int.
+ * \param [in]  item_size   The number of bytes of one item.
+ * \return True if successful.
+ */
+int
+t8_mpi_file_read_at (t8_mpi_file_t *file, size_t offset, void *buffer, size_t count, size_t item_size);
+
+/** Collective version of \ref t8_mpi_file_read_at. Must be called on all processes,
+ * possibly with \a count zero. */
+int
+t8_mpi_file_read_at_all (t8_mpi_file_t *file, size_t offset, void *buffer, size_t count, size_t item_size);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_MPI_FILE_H */
@@ -22,6 +22,7 @@
 
 #include <t8_element.hxx>
 #include <t8_element.h>
+#include <vector>
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
@@ -97,4 +98,73 @@ t8_eclass_scheme::t8_element_size () const
   return element_size;
 }
 
+/* Default implementations of the element operations on ranges of element arrays.
+ * They call the single element version for each element. */
+
+void
+t8_eclass_scheme::t8_element_levels_of_array (const t8_element_array_t *elements, const size_t first,
+                                              const size_t count, int *levels) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    levels[ielem] = t8_element_level (t8_element_array_index_locidx (elements, (t8_locidx_t) (first + ielem)));
+  }
+}
+
+void
+t8_eclass_scheme::t8_element_child_ids_of_array (const t8_element_array_t *elements, const size_t first,
+                                                 const size_t count, int *child_ids) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    child_ids[ielem] = t8_element_child_id (t8_element_array_index_locidx (elements, (t8_locidx_t) (first + ielem)));
+  }
+}
+
+void
+t8_eclass_scheme::t8_element_linear_ids_of_array (const t8_element_array_t *elements, const size_t first,
+                                                  const size_t count, const int level, t8_linearidx_t *ids) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    const t8_element_t *element = t8_element_array_index_locidx (elements, (t8_locidx_t) (first + ielem));
+    ids[ielem] = t8_element_get_linear_id (element, level);
+  }
+}
+
+void
+t8_eclass_scheme::t8_element_parents_of_array (const t8_element_array_t *elements, const size_t first,
+                                               const size_t count, t8_element_array_t *parents) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (count <= t8_element_array_get_count (parents));
+  T8_ASSERT (parents != elements);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    t8_element_parent (t8_element_array_index_locidx (elements, (t8_locidx_t) (first + ielem)),
+                       t8_element_array_index_locidx_mutable (parents, (t8_locidx_t) ielem));
+  }
+}
+
+void
+t8_eclass_scheme::t8_element_children_of_array (const t8_element_array_t *elements, const size_t first,
+                                                const size_t count, t8_element_array_t *children) const
+{
+  std::vector<t8_element_t *> child_pointers;
+
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (children != elements);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    const t8_element_t *element = t8_element_array_index_locidx (elements, (t8_locidx_t) (first + ielem));
+    const int num_children = t8_element_num_children (element);
+    const size_t first_child = t8_element_array_get_count (children);
+
+    child_pointers.resize (num_children);
+    t8_element_array_push_count (children, num_children);
+    for (int ichild = 0; ichild < num_children; ichild++) {
+      child_pointers[ichild] = t8_element_array_index_locidx_mutable (children, (t8_locidx_t) (first_child + ichild));
+    }
+    t8_element_children (element, num_children, child_pointers.data ());
+  }
+}
+
 T8_EXTERN_C_END ();
@@ -32,6 +32,7 @@
 #include <sc_refcount.h>
 #include <t8_eclass.h>
 #include <t8_element.h>
+#include <t8_data/t8_containers.h>
 
 T8_EXTERN_C_BEGIN ();
 
@@ -730,6 +731,66 @@ struct t8_eclass_scheme
   t8_element_root (t8_element_t *elem) const
     = 0;
 
+  /* The following functions apply an element operation to a range of elements of an element array.
+   * A whole range needs only one virtual function call, such that the loop over the elements
+   * can be inlined by an implementation. The default implementations call the corresponding
+   * function for each single element. */
+
+  /** Compute the levels of a range of elements.
+   * \param [in] elements   An element array of this scheme.
+   * \param [in] first      The index of the first element of the range in \a elements.
+   * \param [in] count      The number of elements of the range.
+   * \param [out] levels    An array of length \a count. On output the levels of the elements.
+   */
+  virtual void
+  t8_element_levels_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                              int *levels) const;
+
+  /** Compute the child ids of a range of elements.
+   * \param [in] elements   An element array of this scheme.
+   * \param [in] first      The index of the first element of the range in \a elements.
+   * \param [in] count      The number of elements of the range.
+   * \param [out] child_ids An array of length \a count. On output the child ids of the elements.
+   */
+  virtual void
+  t8_element_child_ids_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                 int *child_ids) const;
+
+  /** Compute the linear ids of a range of elements in a hypothetical uniform refinement of a given level.
+   * \param [in] elements   An element array of this scheme.
+   * \param [in] first      The index of the first element of the range in \a elements.
+   * \param [in] count      The number of elements of the range.
+   * \param [in] level      The level of the uniform refinement to consider.
+   * \param [out] ids       An array of length \a count. On output the linear ids of the elements.
+   */
+  virtual void
+  t8_element_linear_ids_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                  const int level, t8_linearidx_t *ids) const;
+
+  /** Compute the parents of a range of elements.
+   * \param [in] elements    An element array of this scheme.
+   * \param [in] first       The index of the first element of the range in \a elements.
+   * \param [in] count       The number of elements of the range. Each element must have level > 0.
+   * \param [in,out] parents An element array of this scheme with at least \a count elements,
+   *                         different from \a elements. On output its first \a count elements are
+   *                         the parents of the elements of the range.
+   */
+  virtual void
+  t8_element_parents_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                               t8_element_array_t *parents) const;
+
+  /** Compute the children of a range of elements.
+   * \param [in] elements     An element array of this scheme.
+   * \param [in] first        The index of the first element of the range in \a elements.
+   * \param [in] count        The number of elements of the range.
+   * \param [in,out] children An element array of this scheme, different from \a elements.
+   *                          On output the children of each element of the range are appended to it in
+   *                          the order of the elements and, for each element, in the order of their child ids.
+   */
+  virtual void
+  t8_element_children_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                t8_element_array_t *children) const;
+
   /** Pack multiple elements into contiguous memory, so they can be sent via MPI.
    * \param [in] elements Array of elements that are to be packed
    * \param [in] count Number of elements to pack
@@ -37,6 +37,8 @@
 #include <t8_forest/t8_forest_profiling.h>
 #include <t8_forest/t8_forest_io.h>
 #include <t8_forest/t8_forest_adapt.h>
+#include <t8_forest/t8_forest_face_connectivity.h>
+#include <t8_forest/t8_forest_compact.h>
 #include <t8_vtk/t8_vtk_writer.h>
 #include <t8_geometry/t8_geometry_base.hxx>
 #if T8_ENABLE_DEBUG
@@ -1212,6 +1214,7 @@ t8_forest_populate (t8_forest_t forest)
       tree = (t8_tree_t) t8_sc_array_index_locidx (forest->trees, jt - forest->first_local_tree);
       tree_class = tree->eclass = t8_cmesh_get_tree_class (forest->cmesh, jt - first_ctree);
       tree->elements_offset = count_elements;
+      tree->num_compact_elements = 0;
       eclass_scheme = forest->scheme_cxx->eclass_schemes[tree_class];
       T8_ASSERT (eclass_scheme != NULL);
       telements = &tree->elements;
@@ -1410,6 +1413,7 @@ t8_forest_copy_trees (t8_forest_t forest, t8_forest_t from, int copy_elements)
     tree = (t8_tree_t) t8_sc_array_index_locidx (forest->trees, jt);
     fromtree = (t8_tree_t) t8_sc_array_index_locidx (from->trees, jt);
     tree->eclass = fromtree->eclass;
+    tree->num_compact_elements = 0;
     eclass_scheme = forest->scheme_cxx->eclass_schemes[tree->eclass];
     num_tree_elements = t8_element_array_get_count (&fromtree->elements);
     t8_element_array_init_size (&tree->elements, eclass_scheme, num_tree_elements);
@@ -1438,13 +1442,8 @@ t8_forest_copy_trees (t8_forest_t forest, t8_forest_t from, int copy_elements)
   }
 }
 
-/* Search for a linear element id (at forest->maxlevel) in a sorted array of
- * elements. If the element does not exist, return the largest index i
- * such that the element at position i has a smaller id than the given one.
- * If no such i exists, return -1.
- */
 /* TODO: should return t8_locidx_t */
-static t8_locidx_t
+t8_locidx_t
 t8_forest_bin_search_lower (const t8_element_array_t *elements, const t8_linearidx_t element_id, const int maxlevel)
 {
   t8_linearidx_t query_id;
@@ -1485,23 +1484,24 @@ t8_forest_bin_search_lower (const t8_element_array_t *elements, const t8_lineari
 }
 
 t8_eclass_t
-t8_forest_element_neighbor_eclass (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *elem, int face)
+t8_forest_element_neighbor_eclass_cmesh (t8_forest_t forest, t8_locidx_t lctreeid, const t8_element_t *elem, int face)
 {
   t8_eclass_scheme_c *ts;
-  t8_tree_t tree;
   t8_ctree_t coarse_tree;
   t8_eclass_t eclass;
   int tree_face;
   t8_locidx_t lcoarse_neighbor;
   t8_cmesh_t cmesh;
 
-  /* Get a pointer to the tree to read its element class */
-  tree = t8_forest_get_tree (forest, ltreeid);
-  eclass = tree->eclass;
+  cmesh = t8_forest_get_cmesh (forest);
+  T8_ASSERT (0 <= lctreeid && lctreeid < t8_cmesh_get_num_local_trees (cmesh));
+  /* Get the coarse tree to read its element class */
+  coarse_tree = t8_cmesh_get_tree (cmesh, lctreeid);
+  eclass = coarse_tree->eclass;
   ts = t8_forest_get_eclass_scheme (forest, eclass);
   if (!ts->t8_element_is_root_boundary (elem, face)) {
     /* The neighbor element is inside the current tree. */
-    return tree->eclass;
+    return eclass;
   }
   else {
     /* The neighbor is in a neighbor tree */
@@ -1509,9 +1509,6 @@ t8_forest_element_neighbor_eclass (t8_forest_t forest, t8_locidx_t ltreeid, cons
      * face and the tree's face neighbor along that face. */
     tree_face = ts->t8_element_tree_face (elem, face);
 
-    cmesh = t8_forest_get_cmesh (forest);
-    /* Get the coarse tree corresponding to tree */
-    coarse_tree = t8_forest_get_coarse_tree (forest, ltreeid);
     /* Get the (coarse) local id of the tree neighbor */
     lcoarse_neighbor = t8_cmesh_trees_get_face_neighbor (coarse_tree, tree_face);
     T8_ASSERT (0 <= lcoarse_neighbor);
@@ -1527,21 +1524,28 @@ t8_forest_element_neighbor_eclass (t8_forest_t forest, t8_locidx_t ltreeid, cons
   }
 }
 
+t8_eclass_t
+t8_forest_element_neighbor_eclass (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *elem, int face)
+{
+  return t8_forest_element_neighbor_eclass_cmesh (forest, t8_forest_ltreeid_to_cmesh_ltreeid (forest, ltreeid), elem,
+                                                  face);
+}
+
 t8_gloidx_t
-t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *elem, t8_element_t *neigh,
-                                 t8_eclass_scheme_c *neigh_scheme, int face, int *neigh_face)
+t8_forest_element_face_neighbor_cmesh (t8_forest_t forest, t8_locidx_t lctreeid, const t8_element_t *elem,
+                                       t8_element_t *neigh, t8_eclass_scheme_c *neigh_scheme, int face,
+                                       int *neigh_face)
 {
   t8_eclass_scheme_c *ts;
-  t8_tree_t tree;
   t8_eclass_t eclass;
 
-  /* Get a pointer to the tree to read its element class */
-  tree = t8_forest_get_tree (forest, ltreeid);
-  eclass = tree->eclass;
+  T8_ASSERT (0 <= lctreeid && lctreeid < t8_cmesh_get_num_local_trees (forest->cmesh));
+  /* Get the element class of the coarse tree */
+  eclass = t8_cmesh_get_tree_class (forest->cmesh, lctreeid);
   ts = t8_forest_get_eclass_scheme (forest, eclass);
   if (neigh_scheme == ts && ts->t8_element_face_neighbor_inside (elem, neigh, face, neigh_face)) {
     /* The neighbor was constructed and is inside the current tree. */
-    return ltreeid + t8_forest_get_first_local_tree_id (forest);
+    return lctreeid + t8_cmesh_get_first_treeid (forest->cmesh);
   }
   else {
     /* The neighbor does not lie inside the current tree. The content of neigh is undefined right now. */
@@ -1549,7 +1553,7 @@ t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const
     t8_eclass_t neigh_eclass, boundary_class;
     t8_element_t *face_element;
     t8_cmesh_t cmesh;
-    t8_locidx_t lctree_id, lcneigh_id;
+    t8_locidx_t lcneigh_id;
     t8_locidx_t *face_neighbor;
     t8_gloidx_t global_neigh_id;
     t8_cghost_t ghost;
@@ -1562,9 +1566,7 @@ t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const
     /* Get the scheme associated to the element class of the boundary element. */
     /* Compute the face of elem_tree at which the face connection is. */
     tree_face = ts->t8_element_tree_face (elem, face);
-    /* compute coarse tree id */
-    lctree_id = t8_forest_ltreeid_to_cmesh_ltreeid (forest, ltreeid);
-    if (t8_cmesh_tree_face_is_boundary (cmesh, lctree_id, tree_face)) {
+    if (t8_cmesh_tree_face_is_boundary (cmesh, lctreeid, tree_face)) {
       /* This face is a domain boundary. We do not need to continue */
       return -1;
     }
@@ -1577,7 +1579,7 @@ t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const
     ts->t8_element_boundary_face (elem, face, face_element, boundary_scheme);
     /* Get the coarse tree that contains elem.
      * Also get the face neighbor information of the coarse tree. */
-    (void) t8_cmesh_trees_get_tree_ext (cmesh->trees, lctree_id, &face_neighbor, &ttf);
+    (void) t8_cmesh_trees_get_tree_ext (cmesh->trees, lctreeid, &face_neighbor, &ttf);
     /* Compute the local id of the face neighbor tree. */
     lcneigh_id = face_neighbor[tree_face];
     /* F is needed to compute the neighbor face number and the orientation.
@@ -1587,7 +1589,7 @@ t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const
     F = t8_eclass_max_num_faces[cmesh->dimension];
     /* compute the neighbor face */
     tree_neigh_face = ttf[tree_face] % F;
-    if (lcneigh_id == lctree_id && tree_face == tree_neigh_face) {
+    if (lcneigh_id == lctreeid && tree_face == tree_neigh_face) {
       /* This face is a domain boundary and there is no neighbor */
       return -1;
     }
@@ -1640,6 +1642,14 @@ t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const
   }
 }
 
+t8_gloidx_t
+t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *elem, t8_element_t *neigh,
+                                 t8_eclass_scheme_c *neigh_scheme, int face, int *neigh_face)
+{
+  return t8_forest_element_face_neighbor_cmesh (forest, t8_forest_ltreeid_to_cmesh_ltreeid (forest, ltreeid), elem,
+                                                neigh, neigh_scheme, face, neigh_face);
+}
+
 t8_gloidx_t
 t8_forest_element_half_face_neighbors (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *elem,
                                        t8_element_t *neighs[], t8_eclass_scheme_c *neigh_scheme, int face,
@@ -1722,6 +1732,279 @@ t8_forest_leaf_face_orientation (t8_forest_t forest, const t8_locidx_t ltreeid,
   return orientation;
 }
 
+/* Search an element array for leaves inside of an element whose descendants
+ * have linear ids in [first_desc_id, last_desc_id].
+ * If such leaves exist, return the index of the last one, otherwise return -1.
+ * The element must not have a leaf ancestor in the array. */
+static t8_locidx_t
+t8_forest_leaf_face_neighbors_search_range (const t8_element_array_t *elements, const t8_eclass_scheme_c *neigh_scheme,
+                                            const t8_linearidx_t first_desc_id, const t8_linearidx_t last_desc_id,
+                                            const int maxlevel)
+{
+  if (elements == NULL || t8_element_array_get_count (elements) == 0) {
+    return -1;
+  }
+  const t8_locidx_t index = t8_forest_bin_search_lower (elements, last_desc_id, maxlevel);
+  if (index < 0) {
+    return -1;
+  }
+  const t8_element_t *found = t8_element_array_index_locidx (elements, index);
+  if (neigh_scheme->t8_element_get_linear_id (found, maxlevel) < first_desc_id) {
+    /* The leaf found lies before the element */
+    return -1;
+  }
+  return index;
+}
+
+/* Return count scratch elements starting at position first of the scratch stack of a descent.
+ * The stack stores element pointers and is enlarged with new elements if needed. Since this may
+ * reallocate the stack, the returned pointer is only valid until the next call. */
+static t8_element_t **
+t8_forest_leaf_face_neighbors_scratch (const t8_eclass_scheme_c *neigh_scheme, sc_array_t *scratch, const size_t first,
+                                       const size_t count)
+{
+  const size_t old_count = scratch->elem_count;
+  if (old_count < first + count) {
+    sc_array_resize (scratch, first + count);
+    neigh_scheme->t8_element_new (first + count - old_count, (t8_element_t **) sc_array_index (scratch, old_count));
+  }
+  return (t8_element_t **) sc_array_index (scratch, first);
+}
+
+void
+t8_forest_leaf_search_tree_init (const t8_forest_t forest, const t8_gloidx_t gtreeid,
+                                 const t8_eclass_scheme_c *scheme, t8_forest_leaf_search_tree_t *search_tree)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (0 <= gtreeid && gtreeid < forest->global_num_trees);
+
+  search_tree->scheme = scheme;
+  search_tree->maxlevel = forest->maxlevel;
+  search_tree->local_elements = search_tree->ghost_elements = NULL;
+  search_tree->local_offset = search_tree->ghost_offset = 0;
+  const t8_locidx_t ltreeid = t8_forest_get_local_id (forest, gtreeid);
+  if (ltreeid >= 0) {
+    search_tree->local_elements = t8_forest_get_tree_element_array (forest, ltreeid);
+    search_tree->local_offset = t8_forest_get_tree_element_offset (forest, ltreeid);
+  }
+  if (forest->ghosts != NULL) {
+    const t8_locidx_t lghost_treeid = t8_forest_ghost_get_ghost_treeid (forest, gtreeid);
+    if (lghost_treeid >= 0) {
+      search_tree->ghost_elements = t8_forest_ghost_get_tree_elements (forest, lghost_treeid);
+      search_tree->ghost_offset
+        = t8_forest_ghost_get_tree_element_offset (forest, lghost_treeid) + t8_forest_get_local_num_elements (forest);
+    }
+  }
+}
+
+t8_locidx_t
+t8_forest_leaf_search_ancestor (const t8_forest_leaf_search_tree_t *search_tree, const t8_element_t *element,
+                                t8_element_t *last_desc, const t8_element_t **leaf)
+{
+  const t8_eclass_scheme_c *scheme = search_tree->scheme;
+  const int maxlevel = search_tree->maxlevel;
+  const int level = scheme->t8_element_level (element);
+  const t8_linearidx_t id = scheme->t8_element_get_linear_id (element, maxlevel);
+
+  /* Since leaves do not overlap, the only candidate in each array is the last leaf
+   * whose linear id is smaller than or equal to the id of element. */
+  for (int iarray = 0; iarray < 2; iarray++) {
+    const t8_element_array_t *elements = iarray == 0 ? search_tree->local_elements : search_tree->ghost_elements;
+    if (elements == NULL || t8_element_array_get_count (elements) == 0) {
+      continue;
+    }
+    const t8_locidx_t index = t8_forest_bin_search_lower (elements, id, maxlevel);
+    if (index < 0) {
+      continue;
+    }
+    const t8_element_t *candidate = t8_element_array_index_locidx (elements, index);
+    if (scheme->t8_element_level (candidate) > level) {
+      continue;
+    }
+    /* The candidate is an ancestor if element lies in its descendant range */
+    scheme->t8_element_last_descendant (candidate, last_desc, maxlevel);
+    if (id <= scheme->t8_element_get_linear_id (last_desc, maxlevel)) {
+      *leaf = candidate;
+      return index + (iarray == 0 ? search_tree->local_offset : search_tree->ghost_offset);
+    }
+  }
+  return -1;
+}
+
+void
+t8_forest_leaf_search_face_descendants (const t8_forest_leaf_search_tree_t *search_tree, const t8_element_t *element,
+                                        const int face, sc_array_t *scratch, const size_t scratch_top,
+                                        t8_forest_leaf_found_fn found_fn, void *user_data)
+{
+  const t8_eclass_scheme_c *scheme = search_tree->scheme;
+  const int maxlevel = search_tree->maxlevel;
+  const int level = scheme->t8_element_level (element);
+
+  /* Compute the range of linear ids of the descendants of element */
+  t8_element_t *last_desc = t8_forest_leaf_face_neighbors_scratch (scheme, scratch, scratch_top, 1)[0];
+  scheme->t8_element_last_descendant (element, last_desc, maxlevel);
+  const t8_linearidx_t first_desc_id = scheme->t8_element_get_linear_id (element, maxlevel);
+  const t8_linearidx_t last_desc_id = scheme->t8_element_get_linear_id (last_desc, maxlevel);
+
+  for (int iarray = 0; iarray < 2; iarray++) {
+    const t8_element_array_t *elements = iarray == 0 ? search_tree->local_elements : search_tree->ghost_elements;
+    const t8_locidx_t index
+      = t8_forest_leaf_face_neighbors_search_range (elements, scheme, first_desc_id, last_desc_id, maxlevel);
+    if (index < 0) {
+      continue;
+    }
+    const t8_element_t *found = t8_element_array_index_locidx (elements, index);
+    if (scheme->t8_element_level (found) == level) {
+      /* element is a leaf */
+      found_fn (found, index + (iarray == 0 ? search_tree->local_offset : search_tree->ghost_offset), face,
+                user_data);
+      return;
+    }
+    /* element is refined, we continue with its children at face */
+    T8_ASSERT (level < maxlevel);
+    const int num_face_children = scheme->t8_element_num_face_children (element, face);
+    scheme->t8_element_children_at_face (
+      element, face, t8_forest_leaf_face_neighbors_scratch (scheme, scratch, scratch_top, num_face_children),
+      num_face_children, NULL);
+    for (int ichild = 0; ichild < num_face_children; ichild++) {
+      const int child_face = scheme->t8_element_face_child_face (element, face, ichild);
+      const t8_element_t *child = *(t8_element_t **) sc_array_index (scratch, scratch_top + ichild);
+      t8_forest_leaf_search_face_descendants (search_tree, child, child_face, scratch, scratch_top + num_face_children,
+                                              found_fn, user_data);
+    }
+    return;
+  }
+  /* Neither a local leaf nor a ghost leaf lies inside element */
+}
+
+/* A leaf found by t8_forest_leaf_search_face_descendants in t8_forest_leaf_face_neighbors_unbalanced. */
+typedef struct
+{
+  const t8_element_t *leaf; /* The leaf. */
+  t8_locidx_t index;        /* Its index as in t8_forest_leaf_face_neighbors_ext. */
+  int face;                 /* Its dual face. */
+} t8_forest_found_leaf_t;
+
+/* Append a found leaf to the sc_array of t8_forest_found_leaf_t in user_data. */
+static void
+t8_forest_leaf_face_neighbors_push (const t8_element_t *leaf, const t8_locidx_t index, const int face,
+                                    void *user_data)
+{
+  t8_forest_found_leaf_t *found = (t8_forest_found_leaf_t *) sc_array_push ((sc_array_t *) user_data);
+  found->leaf = leaf;
+  found->index = index;
+  found->face = face;
+}
+
+/* Compute the leaf face neighbors of a leaf in a forest that does not need to be balanced.
+ * We compute the same level face neighbor of leaf. If it or one of its ancestors is a
+ * leaf of the forest, this is the only neighbor leaf. Otherwise, the neighbor leaves
+ * are the descendants of the same level neighbor that touch its face. We find them with
+ * a descendant range search over the local and ghost elements of the neighbor tree.
+ * The parameters are the same as for \ref t8_forest_leaf_face_neighbors_ext. */
+static void
+t8_forest_leaf_face_neighbors_unbalanced (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *leaf,
+                                          t8_element_t **pneighbor_leaves[], int face, int *dual_faces[],
+                                          int *num_neighbors, t8_locidx_t **pelement_indices,
+                                          t8_eclass_scheme_c **pneigh_scheme, t8_gloidx_t *gneigh_tree,
+                                          int *orientation)
+{
+  t8_element_t *same_level_neighbor;
+  t8_forest_leaf_search_tree_t search_tree;
+  int neigh_face;
+
+  const t8_eclass_t eclass = t8_forest_get_tree_class (forest, ltreeid);
+  t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
+
+  if (orientation) {
+    *orientation = t8_forest_leaf_face_orientation (forest, ltreeid, ts, leaf, face);
+  }
+
+  /* Compute the same level face neighbor of leaf and the global id of its tree */
+  const t8_eclass_t neigh_class = t8_forest_element_neighbor_eclass (forest, ltreeid, leaf, face);
+  t8_eclass_scheme_c *neigh_scheme = *pneigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
+  neigh_scheme->t8_element_new (1, &same_level_neighbor);
+  const t8_gloidx_t gneigh_treeid
+    = t8_forest_element_face_neighbor (forest, ltreeid, leaf, same_level_neighbor, neigh_scheme, face, &neigh_face);
+  if (gneigh_tree) {
+    *gneigh_tree = gneigh_treeid;
+  }
+  if (gneigh_treeid < 0) {
+    /* There exists no face neighbor across this face, we return with this info */
+    neigh_scheme->t8_element_destroy (1, &same_level_neighbor);
+    *dual_faces = NULL;
+    *num_neighbors = 0;
+    *pelement_indices = NULL;
+    *pneighbor_leaves = NULL;
+    return;
+  }
+  T8_ASSERT (gneigh_treeid >= 0 && gneigh_treeid < forest->global_num_trees);
+
+  /* Search the local and the ghost elements of the neighbor tree */
+  t8_forest_leaf_search_tree_init (forest, gneigh_treeid, neigh_scheme, &search_tree);
+
+  /* Check whether the same level neighbor or one of its ancestors is a leaf. */
+  const t8_element_t *ancestor = NULL;
+  t8_element_t *last_desc;
+  neigh_scheme->t8_element_new (1, &last_desc);
+  const t8_locidx_t ancestor_index
+    = t8_forest_leaf_search_ancestor (&search_tree, same_level_neighbor, last_desc, &ancestor);
+  neigh_scheme->t8_element_destroy (1, &last_desc);
+
+  if (ancestor_index >= 0) {
+    /* The neighbor leaf is the same level neighbor or one of its ancestors.
+     * We compute its dual face by moving the face of the neighbor up to the ancestor. */
+    while (neigh_scheme->t8_element_level (same_level_neighbor) > neigh_scheme->t8_element_level (ancestor)) {
+      neigh_face = neigh_scheme->t8_element_face_parent_face (same_level_neighbor, neigh_face);
+      T8_ASSERT (neigh_face >= 0);
+      neigh_scheme->t8_element_parent (same_level_neighbor, same_level_neighbor);
+    }
+    T8_ASSERT (neigh_scheme->t8_element_equal (same_level_neighbor, ancestor));
+    *num_neighbors = 1;
+    *pneighbor_leaves = T8_ALLOC (t8_element_t *, 1);
+    (*pneighbor_leaves)[0] = same_level_neighbor;
+    *dual_faces = T8_ALLOC (int, 1);
+    (*dual_faces)[0] = neigh_face;
+    *pelement_indices = T8_ALLOC (t8_locidx_t, 1);
+    (*pelement_indices)[0] = ancestor_index;
+    return;
+  }
+
+  /* The same level neighbor is refined. We collect all of its descendants that are leaves
+   * and touch its face. */
+  sc_array_t found_leaves, scratch;
+  sc_array_init (&found_leaves, sizeof (t8_forest_found_leaf_t));
+  sc_array_init (&scratch, sizeof (t8_element_t *));
+  t8_forest_leaf_search_face_descendants (&search_tree, same_level_neighbor, neigh_face, &scratch, 0,
+                                          t8_forest_leaf_face_neighbors_push, &found_leaves);
+  neigh_scheme->t8_element_destroy (1, &same_level_neighbor);
+
+  *num_neighbors = found_leaves.elem_count;
+  if (*num_neighbors == 0) {
+    /* The neighbor leaves are neither local nor ghost elements */
+    *dual_faces = NULL;
+    *pelement_indices = NULL;
+    *pneighbor_leaves = NULL;
+  }
+  else {
+    *pneighbor_leaves = T8_ALLOC (t8_element_t *, *num_neighbors);
+    neigh_scheme->t8_element_new (*num_neighbors, *pneighbor_leaves);
+    *dual_faces = T8_ALLOC (int, *num_neighbors);
+    *pelement_indices = T8_ALLOC (t8_locidx_t, *num_neighbors);
+    for (int ineigh = 0; ineigh < *num_neighbors; ineigh++) {
+      const t8_forest_found_leaf_t *found = (const t8_forest_found_leaf_t *) sc_array_index_int (&found_leaves, ineigh);
+      neigh_scheme->t8_element_copy (found->leaf, (*pneighbor_leaves)[ineigh]);
+      (*dual_faces)[ineigh] = found->face;
+      (*pelement_indices)[ineigh] = found->index;
+    }
+  }
+  sc_array_reset (&found_leaves);
+  if (scratch.elem_count > 0) {
+    neigh_scheme->t8_element_destroy (scratch.elem_count, (t8_element_t **) scratch.array);
+  }
+  sc_array_reset (&scratch);
+}
+
 void
 t8_forest_leaf_face_neighbors_ext (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *leaf,
                                    t8_element_t **pneighbor_leaves[], int face, int *dual_faces[], int *num_neighbors,
@@ -1742,8 +2025,6 @@ t8_forest_leaf_face_neighbors_ext (t8_forest_t forest, t8_locidx_t ltreeid, cons
   T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (t8_forest_element_is_leaf (forest, leaf, ltreeid));
   T8_ASSERT (!forest_is_balanced || t8_forest_is_balanced (forest));
-  SC_CHECK_ABORT (forest_is_balanced, "leaf face neighbors is not implemented "
-                                      "for unbalanced forests.\n"); /* TODO: write version for unbalanced forests */
   SC_CHECK_ABORT (forest->mpisize == 1 || forest->ghosts != NULL,
                   "Ghost structure is needed for t8_forest_leaf_face_neighbors "
                   "but was not found in forest.\n");
@@ -1957,8 +2238,10 @@ t8_forest_leaf_face_neighbors_ext (t8_forest_t forest, t8_locidx_t ltreeid, cons
     T8_FREE (owners);
   }
   else {
-    /* TODO: implement unbalanced version */
-    SC_ABORT_NOT_REACHED ();
+    /* The forest is not known to be balanced, we search for the neighbor leaves
+     * in the descendant range of the same level face neighbor. */
+    t8_forest_leaf_face_neighbors_unbalanced (forest, ltreeid, leaf, pneighbor_leaves, face, dual_faces, num_neighbors,
+                                              pelement_indices, pneigh_scheme, gneigh_tree, orientation);
   }
 }
 
@@ -2929,6 +3212,16 @@ t8_forest_set_partition (t8_forest_t forest, const t8_forest_t set_from, int set
   }
 }
 
+void
+t8_forest_set_partition_weights (t8_forest_t forest, t8_forest_partition_weight_fn weight_fn, const double *weights)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest));
+  T8_ASSERT ((weight_fn == NULL) != (weights == NULL));
+
+  forest->set_partition_weight_fn = weight_fn;
+  forest->set_partition_weights = weights;
+}
+
 void
 t8_forest_set_balance (t8_forest_t forest, const t8_forest_t set_from, int no_repartition)
 {
@@ -3018,6 +3311,27 @@ t8_forest_set_adapt (t8_forest_t forest, const t8_forest_t set_from, t8_forest_a
   }
 }
 
+void
+t8_forest_set_adapt_num_threads (t8_forest_t forest, int num_threads)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest));
+  T8_ASSERT (num_threads >= 0);
+
+  forest->set_adapt_num_threads = num_threads;
+}
+
+void
+t8_forest_set_load (t8_forest_t forest, const char *filename)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest));
+  T8_ASSERT (forest->set_from == NULL);
+  T8_ASSERT (filename != NULL);
+
+  T8_FREE (forest->set_load_filename);
+  forest->set_load_filename = T8_ALLOC (char, strlen (filename) + 1);
+  strcpy (forest->set_load_filename, filename);
+}
+
 void
 t8_forest_set_user_data (t8_forest_t forest, void *data)
 {
@@ -3192,16 +3506,22 @@ t8_forest_commit (t8_forest_t forest)
     /* Compute the maximum allowed refinement level */
     t8_forest_compute_maxlevel (forest);
     T8_ASSERT (forest->set_level <= forest->maxlevel);
+    forest->global_num_trees = t8_cmesh_get_num_trees (forest->cmesh);
     /* populate a new forest with tree and quadrant objects */
-    if (t8_forest_refines_irregular (forest) && forest->set_level > 0) {
-      /* On root level we will also use the normal algorithm */
-      t8_forest_populate_irregular (forest);
+    if (forest->set_load_filename != NULL) {
+      /* Read the elements from a file written with t8_forest_save */
+      t8_forest_load_populate (forest);
     }
     else {
-      t8_forest_populate (forest);
+      if (t8_forest_refines_irregular (forest) && forest->set_level > 0) {
+        /* On root level we will also use the normal algorithm */
+        t8_forest_populate_irregular (forest);
+      }
+      else {
+        t8_forest_populate (forest);
+      }
+      forest->incomplete_trees = 0;
     }
-    forest->global_num_trees = t8_cmesh_get_num_trees (forest->cmesh);
-    forest->incomplete_trees = 0;
   }
   else {                                        /* set_from != NULL */
     t8_forest_t forest_from = forest->set_from; /* temporarily store set_from, since we may overwrite it */
@@ -3212,6 +3532,12 @@ t8_forest_commit (t8_forest_t forest)
     T8_ASSERT (!forest->do_dup);
     T8_ASSERT (forest->from_method >= T8_FOREST_FROM_FIRST && forest->from_method < T8_FOREST_FROM_LAST);
     T8_ASSERT (forest->set_from->incomplete_trees > -1);
+    T8_ASSERT (forest->set_load_filename == NULL);
+
+    /* The algorithms below work on the element arrays of the trees. If set_from is compact, we expand it
+     * here and compact it again once the new forest is built, since the caller may still reference it. */
+    const int from_was_compact = t8_forest_is_compact (forest->set_from);
+    t8_forest_expand (forest->set_from);
 
     /* TODO: optimize all this when forest->set_from has reference count one */
     /* TODO: Get rid of duping the communicator */
@@ -3251,6 +3577,8 @@ t8_forest_commit (t8_forest_t forest)
     /* T8_ASSERT (forest->from_method == T8_FOREST_FROM_COPY); */
     if (forest->from_method & T8_FOREST_FROM_ADAPT) {
       SC_CHECK_ABORT (forest->set_adapt_fn != NULL, "No adapt function specified");
+      SC_CHECK_ABORT (forest->set_partition_weights == NULL,
+                      "Partition weight arrays cannot be combined with adapt. Use a weight function instead.");
       forest->from_method -= T8_FOREST_FROM_ADAPT;
       if (forest->from_method > 0) {
         /* The forest should also be partitioned/balanced.
@@ -3264,6 +3592,7 @@ t8_forest_commit (t8_forest_t forest)
         t8_forest_set_user_data (forest_adapt, t8_forest_get_user_data (forest));
         /* Construct an intermediate, adapted forest */
         t8_forest_set_adapt (forest_adapt, forest->set_from, forest->set_adapt_fn, forest->set_adapt_recursive);
+        t8_forest_set_adapt_num_threads (forest_adapt, forest->set_adapt_num_threads);
         /* Set profiling if enabled */
         t8_forest_set_profiling (forest_adapt, forest->profile != NULL);
         t8_forest_commit (forest_adapt);
@@ -3297,6 +3626,10 @@ t8_forest_commit (t8_forest_t forest)
           t8_forest_ref (forest->set_from);
         }
         t8_forest_set_partition (forest_partition, forest->set_from, forest->set_for_coarsening);
+        if (forest->set_partition_weight_fn != NULL || forest->set_partition_weights != NULL) {
+          t8_forest_set_partition_weights (forest_partition, forest->set_partition_weight_fn,
+                                           forest->set_partition_weights);
+        }
         /* activate profiling, if this forest has profiling */
         t8_forest_set_profiling (forest_partition, forest->profile != NULL);
         /* Commit the partitioned forest */
@@ -3344,6 +3677,10 @@ t8_forest_commit (t8_forest_t forest)
     }
     /* reset forest->set_from */
     forest->set_from = forest_from;
+    if (from_was_compact && forest_from->rc.refcount > 1) {
+      /* The input forest survives the unref below, restore its compact storage */
+      t8_forest_compact (forest_from);
+    }
     /* decrease reference count of input forest, possibly destroying it */
     t8_forest_unref (&forest->set_from);
   } /* end set_from != NULL */
@@ -3357,7 +3694,12 @@ t8_forest_commit (t8_forest_t forest)
   /* we do not need the set parameters anymore */
   forest->set_level = 0;
   forest->set_for_coarsening = 0;
+  forest->set_partition_weight_fn = NULL;
+  forest->set_partition_weights = NULL;
+  forest->set_adapt_num_threads = 0;
   forest->set_from = NULL;
+  T8_FREE (forest->set_load_filename);
+  forest->set_load_filename = NULL;
   forest->committed = 1;
   t8_debugf ("Committed forest with %li local elements and %lli "
              "global elements.\n\tTree range is from %lli to %lli.\n",
@@ -3581,6 +3923,7 @@ t8_forest_tree_get_leaves (const t8_forest_t forest, const t8_locidx_t ltree_id)
 {
   T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (0 <= ltree_id && ltree_id < t8_forest_get_num_local_trees (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_tree_get_leaves");
 
   return &t8_forest_get_tree (forest, ltree_id)->elements;
 }
@@ -3627,6 +3970,7 @@ t8_forest_get_element (t8_forest_t forest, t8_locidx_t lelement_id, t8_locidx_t
 #endif
 
   T8_ASSERT (t8_forest_is_committed (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_get_element");
   T8_ASSERT (lelement_id >= 0);
   if (lelement_id >= t8_forest_get_local_num_elements (forest)) {
     return NULL;
@@ -3682,6 +4026,7 @@ t8_forest_get_element_in_tree (t8_forest_t forest, t8_locidx_t ltreeid, t8_locid
 {
   t8_tree_t tree;
   T8_ASSERT (t8_forest_is_committed (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_get_element_in_tree");
   T8_ASSERT (0 <= ltreeid && ltreeid < t8_forest_get_num_local_trees (forest));
 
   tree = t8_forest_get_tree (forest, ltreeid);
@@ -3704,6 +4049,11 @@ t8_forest_get_tree_element_count (t8_tree_t tree)
   t8_locidx_t element_count;
 
   T8_ASSERT (tree != NULL);
+  if (tree->num_compact_elements > 0) {
+    /* The elements of the tree are stored as keys */
+    T8_ASSERT (t8_element_array_get_count (&tree->elements) == 0);
+    return tree->num_compact_elements;
+  }
   element_count = t8_element_array_get_count (&tree->elements);
   /* check for type conversion errors */
   T8_ASSERT ((size_t) element_count == t8_element_array_get_count (&tree->elements));
@@ -3716,6 +4066,9 @@ t8_forest_get_tree_num_elements (t8_forest_t forest, t8_locidx_t ltreeid)
   T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (0 <= ltreeid && ltreeid < t8_forest_get_num_local_trees (forest));
 
+  if (forest->compact_trees != NULL) {
+    return t8_forest_compact_get_tree_num_elements (forest, ltreeid);
+  }
   return t8_forest_get_tree_element_count (t8_forest_get_tree (forest, ltreeid));
 }
 
@@ -3939,6 +4292,7 @@ t8_forest_compute_profile (t8_forest_t forest)
     sc_stats_set1 (&forest->stats[11], profile->ghost_waittime, "forest: Ghost waittime.");
     sc_stats_set1 (&forest->stats[12], profile->balance_runtime, "forest: Balance runtime.");
     sc_stats_set1 (&forest->stats[13], profile->balance_rounds, "forest: Balance rounds.");
+    sc_stats_set1 (&forest->stats[14], profile->balance_rounds_saved, "forest: Balance rounds saved.");
     /* compute stats */
     sc_stats_compute (sc_MPI_COMM_WORLD, T8_PROFILE_NUM_STATS, forest->stats);
     forest->stats_computed = 1;
@@ -4014,6 +4368,15 @@ t8_forest_profile_get_balance_rounds_stats (t8_forest_t forest)
   return &forest->stats[13];
 }
 
+const sc_statinfo_t *
+t8_forest_profile_get_balance_rounds_saved_stats (t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (forest->profile != NULL);
+  T8_ASSERT (forest->stats_computed);
+  return &forest->stats[14];
+}
+
 double
 t8_forest_profile_get_adapt_time (t8_forest_t forest)
 {
@@ -4069,6 +4432,16 @@ t8_forest_profile_get_ghostexchange_waittime (t8_forest_t forest)
   return 0;
 }
 
+double
+t8_forest_profile_get_ghostexchange_overlaptime (t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  if (forest->profile != NULL) {
+    return forest->profile->ghost_overlaptime;
+  }
+  return 0;
+}
+
 double
 t8_forest_profile_get_balance (t8_forest_t forest, int *balance_rounds)
 {
@@ -4204,7 +4577,7 @@ t8_forest_free_trees (t8_forest_t forest)
   number_of_trees = forest->trees->elem_count;
   for (jt = 0; jt < number_of_trees; jt++) {
     tree = (t8_tree_t) t8_sc_array_index_locidx (forest->trees, jt);
-    if (t8_forest_get_tree_element_count (tree) >= 1) {
+    if (t8_forest_get_tree_num_elements (forest, jt) >= 1) {
       /* destroy first and last descendant */
       const t8_eclass_t eclass = t8_forest_get_tree_class (forest, jt);
       const t8_eclass_scheme_c *scheme = forest->scheme_cxx->eclass_schemes[eclass];
@@ -4216,6 +4589,7 @@ t8_forest_free_trees (t8_forest_t forest)
     }
     t8_element_array_reset (&tree->elements);
   }
+  t8_forest_compact_reset (forest);
   sc_array_destroy (forest->trees);
 }
 
@@ -4252,10 +4626,14 @@ t8_forest_reset (t8_forest_t *pforest)
     t8_forest_free_trees (forest);
   }
 
+  /* Free the name of the file to load, if it was set but not committed */
+  T8_FREE (forest->set_load_filename);
   /* Destroy the ghost layer if it exists */
   if (forest->ghosts != NULL) {
     t8_forest_ghost_unref (&forest->ghosts);
   }
+  /* Destroy the cached face connectivity if it exists */
+  t8_forest_invalidate_face_connectivity (forest);
   /* we have taken ownership on calling t8_forest_set_* */
   if (forest->scheme_cxx != NULL) {
     t8_scheme_cxx_unref (&forest->scheme_cxx);
@@ -26,9 +26,11 @@
 #include <t8_forest/t8_forest_general.h>
 #include <t8_data/t8_containers.h>
 #include <t8_element.hxx>
-
-/* We want to export the whole implementation to be callable from "C" */
-T8_EXTERN_C_BEGIN ();
+#include <t8_schemes/t8_default/t8_default_traits.hxx>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #if T8_ENABLE_DEBUG
 /** Return zero if the first \a num_elements in \a elements are not a (sub)family.
@@ -362,35 +364,508 @@ t8_forest_adapt_refine_recursive (t8_forest_t forest, t8_locidx_t ltreeid, t8_lo
   } /* End while loop */
 }
 
-/* TODO: optimize this when we own forest_from */
-void
-t8_forest_adapt (t8_forest_t forest)
+/** The output of \ref t8_forest_adapt_tree_range that appends the new elements to an element array
+ * of the new forest. This is used by the serial adaptation. */
+class t8_forest_adapt_array_output {
+ public:
+  explicit t8_forest_adapt_array_output (t8_element_array_t *telements): telements (telements)
+  {
+  }
+
+  /** The number of elements appended so far. */
+  size_t
+  size () const
+  {
+    return t8_element_array_get_count (telements);
+  }
+
+  /** Append \a count initialized elements and return the first one. */
+  t8_element_t *
+  push_count (const size_t count)
+  {
+    return t8_element_array_push_count (telements, count);
+  }
+
+  /** Return the element at position \a index. */
+  t8_element_t *
+  index (const t8_locidx_t index)
+  {
+    return t8_element_array_index_locidx_mutable (telements, index);
+  }
+
+  t8_element_array_t *telements; /**< The array to which the new elements are appended. */
+};
+
+/** The output of \ref t8_forest_adapt_tree_range used by the worker threads of the threaded adaptation.
+ * The new elements are appended to a std::vector owned by the chunk. libsc counts its allocations
+ * without a lock unless it was built with pthread support, so worker threads must not allocate
+ * through libsc, and thus cannot grow a t8_element_array_t. */
+class t8_forest_adapt_buffer_output {
+ public:
+  t8_forest_adapt_buffer_output (const t8_eclass_scheme_c *tscheme, std::vector<char> *buffer)
+    : tscheme (tscheme), element_size (tscheme->t8_element_size ()), buffer (buffer)
+  {
+  }
+
+  size_t
+  size () const
+  {
+    return buffer->size () / element_size;
+  }
+
+  t8_element_t *
+  push_count (const size_t count)
+  {
+    const size_t old_size = buffer->size ();
+    buffer->resize (old_size + count * element_size);
+    t8_element_t *new_elements = (t8_element_t *) (buffer->data () + old_size);
+    tscheme->t8_element_init (count, new_elements);
+    return new_elements;
+  }
+
+  t8_element_t *
+  index (const t8_locidx_t index)
+  {
+    return (t8_element_t *) (buffer->data () + index * element_size);
+  }
+
+  const t8_eclass_scheme_c *tscheme; /**< The scheme of the elements. */
+  const size_t element_size;         /**< The size of an element of \a tscheme. */
+  std::vector<char> *buffer;         /**< The buffer to which the new elements are appended. */
+};
+
+/** Adapt a range of elements of a local tree of forest->set_from and append the
+ * new elements to an output.
+ * The element functions that do not call back into the user code are called through the scheme
+ * traits, such that they can be inlined for the default schemes.
+ * \tparam Traits             The scheme traits, \see t8_scheme_traits.
+ * \tparam output_t           \ref t8_forest_adapt_array_output or \ref t8_forest_adapt_buffer_output.
+ * \param [in,out] forest   The new forest currently in construction.
+ * \param [in] ltree_id     The local tree.
+ * \param [in] traits       The scheme traits of the tree.
+ * \param [in] el_first     The index of the first element of the range in the tree of forest->set_from.
+ * \param [in] el_last      One past the index of the last element of the range.
+ *                          Unless \a el_first and \a el_last span the whole tree, neither may split
+ *                          a family, see \ref t8_forest_adapt_find_chunk_end.
+ * \param [in,out] output   The output to which the new elements are appended.
+ * \param [in,out] refine_list A list to buffer elements for recursive refinement.
+ *                          Only required if forest->set_adapt_recursive is true.
+ * \param [out] element_removed Set to 1 if an element was removed, unchanged otherwise.
+ * \return                  The number of elements appended to \a output.
+ * \note The scratch buffers of this function are std::vectors, since it runs on worker threads
+ *       for the threaded adaptation, where we must not allocate through libsc.
+ */
+template <class Traits, class output_t>
+static t8_locidx_t
+t8_forest_adapt_tree_range (t8_forest_t forest, const t8_locidx_t ltree_id, const Traits &traits,
+                            const t8_locidx_t el_first, const t8_locidx_t el_last, output_t &output,
+                            sc_list_t *refine_list, int *element_removed)
 {
-  t8_forest_t forest_from;
+  t8_forest_t forest_from = forest->set_from;
   t8_eclass_scheme_c *tscheme;
-  t8_element_array_t *telements;
+  t8_tree_t tree_from;
   t8_element_array_t *telements_from;
-  t8_element_t **elements;
-  t8_element_t **elements_from;
-  t8_locidx_t ltree_id;
-  t8_locidx_t num_trees;
-  t8_locidx_t num_el_from;
   t8_locidx_t el_considered;
   t8_locidx_t el_inserted;
   t8_locidx_t el_coarsen;
-  t8_locidx_t el_offset;
-  t8_tree_t tree;
-  t8_tree_t tree_from;
-  sc_list_t *refine_list = NULL; /* This is only needed when we adapt recursively */
   int num_children;
   int num_siblings;
-  int curr_size_elements_from;
-  int curr_size_elements;
   int num_elements_to_adapt_callback;
   int zz;
-  int ci;
   int refine;
   int is_family;
+
+  T8_ASSERT (0 <= el_first && el_first < el_last);
+  T8_ASSERT (!forest->set_adapt_recursive || refine_list != NULL);
+  T8_ASSERT (!forest->set_adapt_recursive || (std::is_same_v<output_t, t8_forest_adapt_array_output>));
+
+  tree_from = t8_forest_get_tree (forest_from, ltree_id);
+  telements_from = &tree_from->elements;
+  T8_ASSERT (el_last <= (t8_locidx_t) t8_element_array_get_count (telements_from));
+  T8_ASSERT (output.size () == 0);
+  const t8_element_t *first_element_from = t8_element_array_index_locidx (telements_from, el_first);
+  /* Get the element scheme for this tree */
+  tscheme = t8_forest_get_eclass_scheme (forest_from, tree_from->eclass);
+  T8_ASSERT (traits.ts == tscheme);
+  /* Index of the element we currently consider for refinement/coarsening. */
+  el_considered = el_first;
+  /* Index into the newly inserted elements */
+  el_inserted = 0;
+  /* el_coarsen is the index of the first element in the new element
+   * array which could be coarsened recursively. */
+  el_coarsen = 0;
+  num_children = traits.t8_element_num_children (first_element_from);
+  /* Buffer for a family of new elements */
+  std::vector<t8_element_t *> elements (num_children);
+  /* Buffer for a family of old elements */
+  std::vector<t8_element_t *> elements_from (traits.t8_element_num_siblings (first_element_from));
+  /* Compute the levels and, for complete trees, the child ids of all elements of the range at once,
+   * such that the family checks below do not need a scheme call per element. */
+  const size_t num_elements_from = (size_t) (el_last - el_first);
+  std::vector<int> levels_from (num_elements_from);
+  std::vector<int> child_ids_from;
+  tscheme->t8_element_levels_of_array (telements_from, el_first, num_elements_from, levels_from.data ());
+  if (!forest_from->incomplete_trees) {
+    child_ids_from.resize (num_elements_from);
+    tscheme->t8_element_child_ids_of_array (telements_from, el_first, num_elements_from, child_ids_from.data ());
+  }
+  /* We now iterate over all elements in this range and check them for refinement/coarsening. */
+  while (el_considered < el_last) {
+    /* Load the current element and at most num_siblings-1 many others into
+     * the elements_from buffer. Stop when we are certain that they cannot from
+     * a family.
+     * At the end is_family will be true, if these elements form a family.
+     */
+
+    num_siblings = traits.t8_element_num_siblings (t8_element_array_index_locidx (telements_from, el_considered));
+
+    if ((size_t) num_siblings > elements_from.size ()) {
+      /* Enlarge the elements_from buffer if required */
+      elements_from.resize (num_siblings);
+    }
+#if T8_ENABLE_DEBUG
+    for (zz = 0; zz < num_siblings; zz++) {
+      elements_from[zz] = NULL;
+    }
+#endif
+    for (zz = 0; zz < num_siblings && el_considered + (t8_locidx_t) zz < el_last; zz++) {
+      /* TODO: In a future version elements_from[zz] should be const and we should call t8_element_array_index_locidx (the const version). */
+      elements_from[zz] = t8_element_array_index_locidx_mutable (telements_from, el_considered + (t8_locidx_t) zz);
+      /* This is a quick check whether we build up a family here and could
+       * abort early if not.
+       * If the child id of the current element is not zz, then it cannot
+       * be part of a family (Since we can only have a family if child ids
+       * are 0, 1, 2, ... zz, ... num_siblings-1).
+       * This check is however not sufficient - therefore, we call is_family later. */
+      if (!forest_from->incomplete_trees && child_ids_from[el_considered - el_first + zz] != zz) {
+        break;
+      }
+    }
+
+    /* We assume that the elements do not form a family.
+     * So we will only pass the first element to the adapt callback. */
+    is_family = 0;
+    num_elements_to_adapt_callback = 1;
+    if (forest_from->incomplete_trees) {
+      is_family
+        = t8_forest_is_incomplete_family (forest_from, ltree_id, el_considered, tscheme, elements_from.data (), zz);
+      if (is_family > 0) {
+        /* We will pass a (in)complete family to the adapt callback */
+        num_elements_to_adapt_callback = is_family;
+        is_family = 1;
+      }
+    }
+    else if (zz == num_siblings && traits.t8_element_is_family (elements_from.data ())) {
+      /* We will pass a full family to the adapt callback */
+      is_family = 1;
+      num_elements_to_adapt_callback = num_siblings;
+    }
+    T8_ASSERT (num_elements_to_adapt_callback <= num_siblings);
+#if T8_ENABLE_DEBUG
+    if (forest_from->incomplete_trees) {
+      T8_ASSERT (forest_from->incomplete_trees == 1);
+      T8_ASSERT (!is_family
+                 || t8_forest_is_family_callback (tscheme, num_elements_to_adapt_callback, elements_from.data ()));
+    }
+    else {
+      T8_ASSERT (forest_from->incomplete_trees == 0);
+      T8_ASSERT (!is_family || traits.t8_element_is_family (elements_from.data ()));
+    }
+#endif
+    /* Pass the element, or the family to the adapt callback.
+     * The output will be  1 if the element should be refined
+     *                     0 if the element should remain as is
+     *                    -1 if we passed a family and it should get coarsened
+     *                    -2 if the element should be removed.
+     */
+    refine = forest->set_adapt_fn (forest, forest->set_from, ltree_id, el_considered, tscheme, is_family,
+                                   num_elements_to_adapt_callback, elements_from.data ());
+
+    T8_ASSERT (is_family || refine != -1);
+    if (refine > 0 && levels_from[el_considered - el_first] >= forest->maxlevel) {
+      /* Only refine an element if it does not exceed the maximum level */
+      refine = 0;
+    }
+    if (refine == 1) {
+      /* The first element is to be refined */
+      num_children = traits.t8_element_num_children (elements_from[0]);
+      if ((size_t) num_children > elements.size ()) {
+        elements.resize (num_children);
+      }
+      if constexpr (std::is_same_v<output_t, t8_forest_adapt_array_output>) {
+        if (forest->set_adapt_recursive) {
+          /* Create the children of this element */
+          tscheme->t8_element_new (num_children, elements.data ());
+          traits.t8_element_children (elements_from[0], num_children, elements.data ());
+          for (int ci = num_children - 1; ci >= 0; ci--) {
+            /* Prepend the children to the refine_list.
+             * These should now be the only elements in the list.
+             */
+            (void) sc_list_prepend (refine_list, elements[ci]);
+          }
+          /* We now recursively check the newly created elements for refinement. */
+          t8_forest_adapt_refine_recursive (forest, ltree_id, el_considered, tscheme, refine_list, output.telements,
+                                            &el_inserted, elements.data (), element_removed);
+          el_coarsen = el_inserted;
+        }
+      }
+      if (!forest->set_adapt_recursive) {
+        (void) output.push_count (num_children);
+        for (zz = 0; zz < num_children; zz++) {
+          elements[zz] = output.index (el_inserted + zz);
+        }
+        traits.t8_element_children (elements_from[0], num_children, elements.data ());
+        el_inserted += (t8_locidx_t) num_children;
+      }
+      el_considered++;
+    }
+    else if (refine == -1) {
+      /* The elements form a family and are to be coarsened. */
+      /* Make room for one more new element. */
+      elements[0] = output.push_count (1);
+      /* Compute the parent of the current family.
+       * This parent is now inserted in telements. */
+      T8_ASSERT (levels_from[el_considered - el_first] > 0);
+      traits.t8_element_parent (elements_from[0], elements[0]);
+      /* num_siblings is now equivalent to the number of children of elements[0],
+       * as num_siblings is always associated with elements_from*/
+      num_children = num_siblings;
+      el_inserted++;
+      if ((size_t) num_children > elements.size ()) {
+        elements.resize (num_children);
+      }
+      if constexpr (std::is_same_v<output_t, t8_forest_adapt_array_output>) {
+        if (forest->set_adapt_recursive) {
+          /* Adaptation is recursive.
+           * We check whether the just generated parent is the last in its
+           * family (and not the only one).
+           * If so, we check this family for recursive coarsening. */
+          const int child_id = traits.t8_element_child_id (elements[0]);
+          if (child_id > 0 && child_id == num_children - 1) {
+            t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered, tscheme, output.telements, el_coarsen,
+                                               &el_inserted, elements.data ());
+          }
+        }
+      }
+      el_considered += (t8_locidx_t) num_elements_to_adapt_callback;
+    }
+    else if (refine == 0) {
+      /* The considered elements are neither to be coarsened nor is the first
+       * one to be refined.
+       * We copy the element to the new element array. */
+      elements[0] = output.push_count (1);
+      tscheme->t8_element_copy (elements_from[0], elements[0]);
+      el_inserted++;
+      if constexpr (std::is_same_v<output_t, t8_forest_adapt_array_output>) {
+        if (forest->set_adapt_recursive) {
+          /* Adaptation is recursive.
+           * If adaptation is recursive and this was the last element in its family
+           * (and not the only one), we need to check for recursive coarsening. */
+          const int child_id = traits.t8_element_child_id (elements[0]);
+          if (child_id > 0 && child_id == num_children - 1) {
+            t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered, tscheme, output.telements, el_coarsen,
+                                               &el_inserted, elements.data ());
+          }
+        }
+      }
+      el_considered++;
+    }
+    else {
+      /* Remove the element */
+      T8_ASSERT (refine == -2);
+      *element_removed = 1;
+      el_considered++;
+    }
+  } /* End element loop */
+
+  /* Check that if we had recursive adaptation, the refine list is now empty. */
+  T8_ASSERT (!forest->set_adapt_recursive || refine_list->elem_count == 0);
+
+  return el_inserted;
+}
+
+/** Finish the adaptation of a local tree after all its new elements were inserted.
+ * Sets the element offset of the tree and adds its elements to the local number of elements.
+ * \param [in,out] forest      The new forest currently in construction.
+ * \param [in]     ltree_id    The local tree.
+ * \param [in]     el_inserted The number of new elements in the tree.
+ * \param [in,out] el_offset   On input the element offset of the tree, on output the offset of the next tree.
+ */
+static void
+t8_forest_adapt_finish_tree (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_locidx_t el_inserted,
+                             t8_locidx_t *el_offset)
+{
+  t8_tree_t tree = t8_forest_get_tree (forest, ltree_id);
+
+  /* Set the new element offset of this tree */
+  tree->elements_offset = *el_offset;
+  *el_offset += el_inserted;
+  /* Add to the new number of local elements. */
+  forest->local_num_elements += el_inserted;
+  /* Possibly shrink the telements array to the correct size */
+  t8_element_array_resize (&tree->elements, el_inserted);
+
+  /* It is not supported to delete all elements from a tree.
+   * In this case, we will abort. */
+  SC_CHECK_ABORTF (el_inserted != 0,
+                   "ERROR: All elements of tree %i were removed. Removing all elements of a tree "
+                   "is currently not supported. See also https://github.com/DLR-AMR/t8code/issues/1137.",
+                   ltree_id);
+}
+
+/** Given a proposed end of a chunk of elements in a tree, find the first index at or
+ * after it at which the chunk can end. Since the serial adaptation considers the elements
+ * of a complete tree family by family, a chunk may only end in front of an element with
+ * child id 0. Then the adaptation of the chunks yields the same elements as the adaptation
+ * of the whole tree.
+ * \param [in] tscheme       The scheme of the tree.
+ * \param [in] telements     The elements of the tree. The tree must be complete.
+ * \param [in] el_proposed   The proposed end of the chunk.
+ * \return                   The smallest index >= \a el_proposed of an element with child id 0,
+ *                           or the number of elements in the tree if there is none.
+ */
+static t8_locidx_t
+t8_forest_adapt_find_chunk_end (const t8_eclass_scheme_c *tscheme, const t8_element_array_t *telements,
+                                t8_locidx_t el_proposed)
+{
+  const t8_locidx_t num_elements = (t8_locidx_t) t8_element_array_get_count (telements);
+
+  while (el_proposed < num_elements
+         && tscheme->t8_element_child_id (t8_element_array_index_locidx (telements, el_proposed)) != 0) {
+    el_proposed++;
+  }
+  return el_proposed;
+}
+
+/** A contiguous range of elements of a local tree that is adapted by one thread. */
+typedef struct
+{
+  t8_locidx_t ltree_id;         /**< The local tree of the chunk. */
+  t8_locidx_t el_first;         /**< The first element of the chunk in the tree of forest->set_from. */
+  t8_locidx_t el_last;          /**< One past the last element of the chunk. */
+  std::vector<char> elements;   /**< The new elements of the chunk. The worker threads must not allocate
+                                     through libsc, so the chunks do not use a t8_element_array_t. */
+  t8_locidx_t el_inserted;      /**< The number of new elements of the chunk. */
+  int element_removed;          /**< True if an element of the chunk was removed. */
+} t8_forest_adapt_chunk_t;
+
+/** The minimum number of elements per chunk. Smaller chunks do not pay off the overhead. */
+#define T8_FOREST_ADAPT_MIN_CHUNK_SIZE 1024
+/** The number of chunks per thread that we aim for, to balance trees of different cost. */
+#define T8_FOREST_ADAPT_CHUNKS_PER_THREAD 4
+
+/** Adapt all local trees of a forest with multiple threads.
+ * The local trees are split into chunks that are adapted concurrently.
+ * Afterwards, the new elements of the chunks are merged into the trees in order.
+ * \param [in,out] forest        The new forest currently in construction.
+ * \param [in]     num_threads   The number of threads to use.
+ * \param [out]    element_removed Set to 1 if an element was removed, unchanged otherwise.
+ * \note The adaptation must not be recursive and forest->set_from must not have incomplete trees.
+ */
+static void
+t8_forest_adapt_threaded (t8_forest_t forest, const int num_threads, int *element_removed)
+{
+  const t8_forest_t forest_from = forest->set_from;
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+  std::vector<t8_forest_adapt_chunk_t> chunks;
+  std::atomic<size_t> next_chunk (0);
+
+  T8_ASSERT (num_threads > 1);
+  T8_ASSERT (!forest->set_adapt_recursive);
+  T8_ASSERT (!forest_from->incomplete_trees);
+
+  /* Split the local trees into chunks. */
+  const t8_locidx_t chunk_size
+    = SC_MAX (T8_FOREST_ADAPT_MIN_CHUNK_SIZE, t8_forest_get_local_num_elements (forest_from)
+                                                / (T8_FOREST_ADAPT_CHUNKS_PER_THREAD * num_threads));
+  for (t8_locidx_t ltree_id = 0; ltree_id < num_trees; ltree_id++) {
+    const t8_tree_t tree_from = t8_forest_get_tree (forest_from, ltree_id);
+    const t8_locidx_t num_el_from = (t8_locidx_t) t8_element_array_get_count (&tree_from->elements);
+    const t8_eclass_scheme_c *tscheme = t8_forest_get_eclass_scheme (forest_from, tree_from->eclass);
+    t8_locidx_t el_first = 0;
+    while (el_first < num_el_from) {
+      t8_forest_adapt_chunk_t chunk = {};
+      chunk.ltree_id = ltree_id;
+      chunk.el_first = el_first;
+      chunk.el_last = el_first + chunk_size < num_el_from
+                        ? t8_forest_adapt_find_chunk_end (tscheme, &tree_from->elements, el_first + chunk_size)
+                        : num_el_from;
+      chunks.push_back (chunk);
+      el_first = chunk.el_last;
+    }
+  }
+  t8_debugf ("Adapting %zu chunks with %i threads.\n", chunks.size (), num_threads);
+
+  /* Each thread adapts chunks until none is left. */
+  auto adapt_chunks = [&] () {
+    size_t ichunk;
+    while ((ichunk = next_chunk.fetch_add (1)) < chunks.size ()) {
+      t8_forest_adapt_chunk_t *chunk = &chunks[ichunk];
+      const t8_eclass_t eclass = t8_forest_get_tree (forest_from, chunk->ltree_id)->eclass;
+      const t8_eclass_scheme_c *tscheme = t8_forest_get_eclass_scheme (forest_from, eclass);
+      t8_forest_adapt_buffer_output output (tscheme, &chunk->elements);
+      chunk->el_inserted = t8_scheme_traits_dispatch (tscheme, [&] (const auto &traits) {
+        return t8_forest_adapt_tree_range (forest, chunk->ltree_id, traits, chunk->el_first, chunk->el_last, output,
+                                           NULL, &chunk->element_removed);
+      });
+    }
+  };
+  std::vector<std::thread> threads;
+  const int num_spawned = (int) SC_MIN ((size_t) num_threads, chunks.size ()) - 1;
+  for (int ithread = 0; ithread < num_spawned; ithread++) {
+    threads.emplace_back (adapt_chunks);
+  }
+  /* The calling thread takes part in the work. */
+  adapt_chunks ();
+  for (auto &thread : threads) {
+    thread.join ();
+  }
+
+  /* Merge the chunks into their trees, in order. */
+  t8_locidx_t el_offset = 0;
+  size_t ichunk = 0;
+  for (t8_locidx_t ltree_id = 0; ltree_id < num_trees; ltree_id++) {
+    if (ichunk == chunks.size () || chunks[ichunk].ltree_id != ltree_id) {
+      /* The tree of forest_from is empty */
+      continue;
+    }
+    t8_element_array_t *telements = &t8_forest_get_tree (forest, ltree_id)->elements;
+    T8_ASSERT (chunks[ichunk].el_first == 0);
+    T8_ASSERT (t8_element_array_get_count (telements) == 0);
+    /* Allocate the tree's elements at once and copy the elements of its chunks. */
+    t8_locidx_t el_inserted = 0;
+    for (size_t jchunk = ichunk; jchunk < chunks.size () && chunks[jchunk].ltree_id == ltree_id; jchunk++) {
+      el_inserted += chunks[jchunk].el_inserted;
+    }
+    t8_element_array_resize (telements, el_inserted);
+    char *dest = (char *) t8_element_array_get_data_mutable (telements);
+    for (; ichunk < chunks.size () && chunks[ichunk].ltree_id == ltree_id; ichunk++) {
+      t8_forest_adapt_chunk_t *chunk = &chunks[ichunk];
+      memcpy (dest, chunk->elements.data (), chunk->elements.size ());
+      dest += chunk->elements.size ();
+      *element_removed |= chunk->element_removed;
+      std::vector<char> ().swap (chunk->elements);
+    }
+    t8_forest_adapt_finish_tree (forest, ltree_id, el_inserted, &el_offset);
+  }
+  T8_ASSERT (ichunk == chunks.size ());
+}
+
+/* We want to export the adaptation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* TODO: optimize this when we own forest_from */
+void
+t8_forest_adapt (t8_forest_t forest)
+{
+  t8_forest_t forest_from;
+  t8_locidx_t ltree_id;
+  t8_locidx_t num_trees;
+  t8_locidx_t num_el_from;
+  t8_locidx_t el_inserted;
+  t8_locidx_t el_offset;
+  sc_list_t *refine_list = NULL; /* This is only needed when we adapt recursively */
+  int num_threads;
   int element_removed = 0;
 
   T8_ASSERT (forest != NULL);
@@ -417,234 +892,46 @@ t8_forest_adapt (t8_forest_t forest)
    * Will we do this here or in an extra function? */
   T8_ASSERT (forest->trees->elem_count == forest_from->trees->elem_count);
 
-  if (forest->set_adapt_recursive) {
-    refine_list = sc_list_new (NULL);
-  }
   forest->local_num_elements = 0;
-  el_offset = 0;
-  num_trees = t8_forest_get_num_local_trees (forest);
-  /* Iterate over the trees and build the new element arrays for each one. */
-  for (ltree_id = 0; ltree_id < num_trees; ltree_id++) {
-    /* Get the new and old tree and the new and old element arrays */
-    tree = t8_forest_get_tree (forest, ltree_id);
-    tree_from = t8_forest_get_tree (forest_from, ltree_id);
-    telements = &tree->elements;
-    telements_from = &tree_from->elements;
-    /* Number of elements in the old tree */
-    num_el_from = (t8_locidx_t) t8_element_array_get_count (telements_from);
-    T8_ASSERT (num_el_from == t8_forest_get_tree_num_elements (forest_from, ltree_id));
-    /* Continue only if tree_from is not empty.
-     * Otherwise there is nothing to adapt, since elements can't be inserted. */
-    if (num_el_from > 0) {
-      const t8_element_t *first_element_from = t8_element_array_index_locidx (telements_from, 0);
-      /* Get the element scheme for this tree */
-      tscheme = t8_forest_get_eclass_scheme (forest_from, tree->eclass);
-      /* Index of the element we currently consider for refinement/coarsening. */
-      el_considered = 0;
-      /* Index into the newly inserted elements */
-      el_inserted = 0;
-      /* el_coarsen is the index of the first element in the new element
-       * array which could be coarsened recursively. */
-      el_coarsen = 0;
-      num_children = tscheme->t8_element_num_children (first_element_from);
-      curr_size_elements = num_children;
-      curr_size_elements_from = tscheme->t8_element_num_siblings (first_element_from);
-      /* Buffer for a family of new elements */
-      elements = T8_ALLOC (t8_element_t *, num_children);
-      /* Buffer for a family of old elements */
-      elements_from = T8_ALLOC (t8_element_t *, curr_size_elements_from);
-      /* We now iterate over all elements in this tree and check them for refinement/coarsening. */
-      while (el_considered < num_el_from) {
-        /* Load the current element and at most num_siblings-1 many others into
-         * the elements_from buffer. Stop when we are certain that they cannot from
-         * a family.
-         * At the end is_family will be true, if these elements form a family.
-         */
-
-        num_siblings = tscheme->t8_element_num_siblings (t8_element_array_index_locidx (telements_from, el_considered));
-
-        if (num_siblings > curr_size_elements_from) {
-          /* Enlarge the elements_from buffer if required */
-          elements_from = T8_REALLOC (elements_from, t8_element_t *, num_siblings);
-          curr_size_elements_from = num_siblings;
-        }
-#if T8_ENABLE_DEBUG
-        for (zz = 0; zz < num_siblings; zz++) {
-          elements_from[zz] = NULL;
-        }
-#endif
-        for (zz = 0; zz < num_siblings && el_considered + (t8_locidx_t) zz < num_el_from; zz++) {
-          /* TODO: In a future version elements_from[zz] should be const and we should call t8_element_array_index_locidx (the const version). */
-          elements_from[zz] = t8_element_array_index_locidx_mutable (telements_from, el_considered + (t8_locidx_t) zz);
-          /* This is a quick check whether we build up a family here and could
-           * abort early if not.
-           * If the child id of the current element is not zz, then it cannot
-           * be part of a family (Since we can only have a family if child ids
-           * are 0, 1, 2, ... zz, ... num_siblings-1).
-           * This check is however not sufficient - therefore, we call is_family later. */
-          if (!forest_from->incomplete_trees && tscheme->t8_element_child_id (elements_from[zz]) != zz) {
-            break;
-          }
-        }
-
-        /* We assume that the elements do not form a family.
-         * So we will only pass the first element to the adapt callback. */
-        is_family = 0;
-        num_elements_to_adapt_callback = 1;
-        if (forest_from->incomplete_trees) {
-          is_family = t8_forest_is_incomplete_family (forest_from, ltree_id, el_considered, tscheme, elements_from, zz);
-          if (is_family > 0) {
-            /* We will pass a (in)complete family to the adapt callback */
-            num_elements_to_adapt_callback = is_family;
-            is_family = 1;
-          }
-        }
-        else if (zz == num_siblings && tscheme->t8_element_is_family (elements_from)) {
-          /* We will pass a full family to the adapt callback */
-          is_family = 1;
-          num_elements_to_adapt_callback = num_siblings;
-        }
-        T8_ASSERT (num_elements_to_adapt_callback <= num_siblings);
-#if T8_ENABLE_DEBUG
-        if (forest_from->incomplete_trees) {
-          T8_ASSERT (forest_from->incomplete_trees == 1);
-          T8_ASSERT (!is_family
-                     || t8_forest_is_family_callback (tscheme, num_elements_to_adapt_callback, elements_from));
-        }
-        else {
-          T8_ASSERT (forest_from->incomplete_trees == 0);
-          T8_ASSERT (!is_family || tscheme->t8_element_is_family (elements_from));
-        }
-#endif
-        /* Pass the element, or the family to the adapt callback.
-         * The output will be  1 if the element should be refined
-         *                     0 if the element should remain as is
-         *                    -1 if we passed a family and it should get coarsened
-         *                    -2 if the element should be removed.
-         */
-        refine = forest->set_adapt_fn (forest, forest->set_from, ltree_id, el_considered, tscheme, is_family,
-                                       num_elements_to_adapt_callback, elements_from);
-
-        T8_ASSERT (is_family || refine != -1);
-        if (refine > 0 && tscheme->t8_element_level (elements_from[0]) >= forest->maxlevel) {
-          /* Only refine an element if it does not exceed the maximum level */
-          refine = 0;
-        }
-        if (refine == 1) {
-          /* The first element is to be refined */
-          num_children = tscheme->t8_element_num_children (elements_from[0]);
-          if (num_children > curr_size_elements) {
-            elements = T8_REALLOC (elements, t8_element_t *, num_children);
-            curr_size_elements = num_children;
-          }
-          if (forest->set_adapt_recursive) {
-            /* Create the children of this element */
-            tscheme->t8_element_new (num_children, elements);
-            tscheme->t8_element_children (elements_from[0], num_children, elements);
-            for (ci = num_children - 1; ci >= 0; ci--) {
-              /* Prepend the children to the refine_list.
-               * These should now be the only elements in the list.
-               */
-              (void) sc_list_prepend (refine_list, elements[ci]);
-            }
-            /* We now recursively check the newly created elements for refinement. */
-            t8_forest_adapt_refine_recursive (forest, ltree_id, el_considered, tscheme, refine_list, telements,
-                                              &el_inserted, elements, &element_removed);
-            el_coarsen = el_inserted;
-          }
-          else {
-            (void) t8_element_array_push_count (telements, num_children);
-            for (zz = 0; zz < num_children; zz++) {
-              /* TODO: In a future version elements_from[zz] should be const and we should call t8_element_array_index_locidx (the const version). */
-              elements[zz] = t8_element_array_index_locidx_mutable (telements, el_inserted + zz);
-            }
-            tscheme->t8_element_children (elements_from[0], num_children, elements);
-            el_inserted += (t8_locidx_t) num_children;
-          }
-          el_considered++;
-        }
-        else if (refine == -1) {
-          /* The elements form a family and are to be coarsened. */
-          /* Make room for one more new element. */
-          elements[0] = t8_element_array_push (telements);
-          /* Compute the parent of the current family.
-           * This parent is now inserted in telements. */
-          T8_ASSERT (tscheme->t8_element_level (elements_from[0]) > 0);
-          tscheme->t8_element_parent (elements_from[0], elements[0]);
-          /* num_siblings is now equivalent to the number of children of elements[0],
-           * as num_siblings is always associated with elements_from*/
-          num_children = num_siblings;
-          el_inserted++;
-          if (num_children > curr_size_elements) {
-            elements = T8_REALLOC (elements, t8_element_t *, num_children);
-            curr_size_elements = num_children;
-          }
-          if (forest->set_adapt_recursive) {
-            /* Adaptation is recursive.
-             * We check whether the just generated parent is the last in its
-             * family (and not the only one).
-             * If so, we check this family for recursive coarsening. */
-            const int child_id = tscheme->t8_element_child_id (elements[0]);
-            if (child_id > 0 && child_id == num_children - 1) {
-              t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered, tscheme, telements, el_coarsen,
-                                                 &el_inserted, elements);
-            }
-          }
-          el_considered += (t8_locidx_t) num_elements_to_adapt_callback;
-        }
-        else if (refine == 0) {
-          /* The considered elements are neither to be coarsened nor is the first
-           * one to be refined.
-           * We copy the element to the new element array. */
-          elements[0] = t8_element_array_push (telements);
-          tscheme->t8_element_copy (elements_from[0], elements[0]);
-          el_inserted++;
-          if (forest->set_adapt_recursive) {
-            /* Adaptation is recursive.
-             * If adaptation is recursive and this was the last element in its family
-             * (and not the only one), we need to check for recursive coarsening. */
-            const int child_id = tscheme->t8_element_child_id (elements[0]);
-            if (child_id > 0 && child_id == num_children - 1) {
-              t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered, tscheme, telements, el_coarsen,
-                                                 &el_inserted, elements);
-            }
-          }
-          el_considered++;
-        }
-        else {
-          /* Remove the element */
-          T8_ASSERT (refine == -2);
-          element_removed = 1;
-          el_considered++;
-        }
-      } /* End element loop */
-
-      /* Check that if we had recursive adaptation, the refine list is now empty. */
-      T8_ASSERT (!forest->set_adapt_recursive || refine_list->elem_count == 0);
-
-      /* Set the new element offset of this tree */
-      tree->elements_offset = el_offset;
-      el_offset += el_inserted;
-      /* Add to the new number of local elements. */
-      forest->local_num_elements += el_inserted;
-      /* Possibly shrink the telements array to the correct size */
-      t8_element_array_resize (telements, el_inserted);
-
-      /* It is not supported to delete all elements from a tree.
-       * In this case, we will abort. */
-      SC_CHECK_ABORTF (el_inserted != 0,
-                       "ERROR: All elements of tree %i were removed. Removing all elements of a tree "
-                       "is currently not supported. See also https://github.com/DLR-AMR/t8code/issues/1137.",
-                       ltree_id);
-
+  num_threads = forest->set_adapt_num_threads;
+  if (num_threads > 1 && (forest->set_adapt_recursive || forest_from->incomplete_trees)) {
+    /* Recursive adaptation and the adaptation of incomplete trees allocate elements
+     * from the (not thread-safe) memory pools of the schemes. */
+    t8_debugf ("Threaded adaptation is not supported for recursive adaptation or incomplete trees. "
+               "Adapting serially.\n");
+    num_threads = 1;
+  }
+  if (num_threads > 1) {
+    t8_forest_adapt_threaded (forest, num_threads, &element_removed);
+  }
+  else {
+    if (forest->set_adapt_recursive) {
+      refine_list = sc_list_new (NULL);
+    }
+    el_offset = 0;
+    num_trees = t8_forest_get_num_local_trees (forest);
+    /* Iterate over the trees and build the new element arrays for each one. */
+    for (ltree_id = 0; ltree_id < num_trees; ltree_id++) {
+      /* Number of elements in the old tree */
+      num_el_from = t8_forest_get_tree_num_elements (forest_from, ltree_id);
+      /* Continue only if tree_from is not empty.
+       * Otherwise there is nothing to adapt, since elements can't be inserted. */
+      if (num_el_from > 0) {
+        t8_forest_adapt_array_output output (&t8_forest_get_tree (forest, ltree_id)->elements);
+        const t8_eclass_scheme_c *tscheme
+          = t8_forest_get_eclass_scheme (forest_from, t8_forest_get_tree_class (forest_from, ltree_id));
+        /* We dispatch the scheme once per tree, such that the adaptation is instantiated per element class. */
+        el_inserted = t8_scheme_traits_dispatch (tscheme, [&] (const auto &traits) {
+          return t8_forest_adapt_tree_range (forest, ltree_id, traits, 0, num_el_from, output, refine_list,
+                                             &element_removed);
+        });
+        t8_forest_adapt_finish_tree (forest, ltree_id, el_inserted, &el_offset);
+      }
+    } /* End tree loop */
+    if (forest->set_adapt_recursive) {
       /* clean up */
-      T8_FREE (elements);
-      T8_FREE (elements_from);
-    } /* End if (num_el_from > 0) */
-  }   /* End tree loop */
-  if (forest->set_adapt_recursive) {
-    /* clean up */
-    sc_list_destroy (refine_list);
+      sc_list_destroy (refine_list);
+    }
   }
 
   /* We now adapted all local trees */
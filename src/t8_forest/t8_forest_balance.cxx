@@ -29,17 +29,14 @@
 #include <t8_forest/t8_forest_profiling.h>
 #include <t8_element.hxx>
 
-/* We want to export the whole implementation to be callable from "C" */
-T8_EXTERN_C_BEGIN ();
-
-/* This is the adapt function called during one round of balance.
- * We refine an element if it has any face neighbor with a level larger
- * than the element's level + 1.
- */
-/* TODO: We currently do not adapt recursively since some functions such
- * as half neighbor computation require the forest to be committed. Thus,
- * we pass forest_from as a parameter. But doing so is not valid anymore
- * if we refine recursively. */
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* Check whether an element violates the balance condition with respect to the
+ * leaves of forest_from, that is, whether it has any face neighbor with a level larger
+ * than the element's level + 1. This is used by t8_forest_is_balanced. */
 static int
 t8_forest_balance_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t ltree_id, t8_locidx_t lelement_id,
                          t8_eclass_scheme_c *ts, const int is_family, const int num_elements, t8_element_t *elements[])
@@ -98,214 +95,470 @@ t8_forest_balance_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_
   return 0;
 }
 
-/* Collective function to compute the maximum occurring refinement level in a forest */
-static void
-t8_forest_compute_max_element_level (t8_forest_t forest)
+/* An element that has to be refined in the balanced forest, identified by its tree,
+ * its level and its linear id at its level. This is also the format in which refined
+ * elements are exchanged between processes. */
+typedef struct
+{
+  t8_gloidx_t gtreeid; /* The global id of the tree of the element. */
+  t8_linearidx_t id;   /* The linear id of the element at its level. */
+  int32_t level;       /* The refinement level of the element. */
+  int32_t eclass;      /* The element class of the tree. */
+  int32_t depth;       /* The number of ripple steps from a refined element of the input forest. */
+  int32_t open;        /* True if the face neighbors of the element still have to be refined. */
+} t8_forest_balance_seed_t;
+
+/* Hash a refined element by its tree, level and linear id. */
+struct t8_forest_balance_seed_hash
 {
-  t8_locidx_t ielement, elem_in_tree;
-  t8_locidx_t itree, num_trees;
-  t8_eclass_scheme_c *scheme;
-  int local_max_level = 0, elem_level;
+  size_t
+  operator() (const t8_forest_balance_seed_t &seed) const
+  {
+    return std::hash<t8_linearidx_t> () (seed.id) ^ (std::hash<t8_gloidx_t> () (seed.gtreeid) << 1)
+           ^ ((size_t) seed.level << 58);
+  }
+};
 
-  /* Iterate over all local trees and all local elements and comupte the maximum occurring level */
-  num_trees = t8_forest_get_num_local_trees (forest);
-  for (itree = 0; itree < num_trees; itree++) {
-    elem_in_tree = t8_forest_get_tree_num_elements (forest, itree);
-    scheme = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
-    for (ielement = 0; ielement < elem_in_tree; ielement++) {
-      /* Get the element and compute its level */
-      const t8_element_t *elem = t8_forest_get_element_in_tree (forest, itree, ielement);
-      elem_level = scheme->t8_element_level (elem);
-      local_max_level = SC_MAX (local_max_level, elem_level);
+/* Compare two refined elements by their tree, level and linear id. */
+struct t8_forest_balance_seed_equal
+{
+  bool
+  operator() (const t8_forest_balance_seed_t &seed_a, const t8_forest_balance_seed_t &seed_b) const
+  {
+    return seed_a.gtreeid == seed_b.gtreeid && seed_a.level == seed_b.level && seed_a.id == seed_b.id;
+  }
+};
+
+/* The elements that have to be refined to balance a forest.
+ * A forest is balanced if and only if for each refined element the face neighbors of the
+ * same level exist in the forest, that is, the parents of these face neighbors are refined as well.
+ * The refined elements of the balanced forest are thus the closure of the refined elements of the input
+ * forest under this rule. We compute the closure directly from the elements instead of refining the
+ * forest level by level:
+ * Each process applies the rule to the refined elements of the input forest whose first leaf it owns.
+ * It continues with each newly refined element in a tree that is local in the cmesh, even if the element
+ * lies in the partition of another process. Thus, each process also computes the insulation layer
+ * around its partition that its own refinements cause. Newly refined elements in the partition of other
+ * processes are sent to their owners in a single exchange.
+ * Only for elements in trees that are not local in the cmesh, the owners have to continue with the
+ * rule, which requires another round. */
+class t8_forest_balance_closure {
+ public:
+  t8_forest_balance_closure (t8_forest_t forest_from): forest (forest_from), send (forest_from->mpisize)
+  {
+    T8_ASSERT (t8_forest_is_committed (forest_from));
+    for (auto &slot : scratch) {
+      slot.fill (NULL);
+    }
+  }
+
+  ~t8_forest_balance_closure ()
+  {
+    for (auto &slot : scratch) {
+      for (int iclass = T8_ECLASS_ZERO; iclass < T8_ECLASS_COUNT; iclass++) {
+        if (slot[iclass] != NULL) {
+          t8_forest_get_eclass_scheme (forest, (t8_eclass_t) iclass)->t8_element_destroy (1, &slot[iclass]);
+        }
+      }
+    }
+  }
+
+  /* Apply the rule to all refined elements of the input forest whose first leaf is a local element. */
+  void
+  add_input_refinements ()
+  {
+    const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+
+    for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+      const t8_eclass_t eclass = t8_forest_get_tree_class (forest, itree);
+      t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
+      const t8_locidx_t lctreeid = t8_forest_ltreeid_to_cmesh_ltreeid (forest, itree);
+      const t8_locidx_t num_elements = t8_forest_get_tree_num_elements (forest, itree);
+      for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+        const t8_element_t *leaf = t8_forest_get_element_in_tree (forest, itree, ielement);
+        if (ts->t8_element_level (leaf) == 0) {
+          continue;
+        }
+        /* Walk up the ancestors of leaf as long as leaf is their first leaf */
+        const t8_linearidx_t first_desc_id = ts->t8_element_get_linear_id (leaf, forest->maxlevel);
+        t8_element_t *ancestor = get_scratch (T8_BALANCE_SLOT_ELEMENT, eclass);
+        t8_element_t *next_ancestor = get_scratch (T8_BALANCE_SLOT_ANCESTOR, eclass);
+        ts->t8_element_parent (leaf, ancestor);
+        while (ts->t8_element_level (ancestor) > 0
+               && ts->t8_element_get_linear_id (ancestor, forest->maxlevel) == first_desc_id) {
+          add_neighbor_refinements (lctreeid, eclass, ancestor, 0);
+          ts->t8_element_parent (ancestor, next_ancestor);
+          std::swap (ancestor, next_ancestor);
+        }
+      }
+    }
+  }
+
+  /* Apply the rule to all newly refined elements until no new refinement occurs. */
+  void
+  propagate ()
+  {
+    /* The queue grows while we process it. We process it in order, such that each element
+     * is reached with the smallest number of ripple steps first. */
+    for (size_t iseed = 0; iseed < queue.size (); iseed++) {
+      const t8_forest_balance_seed_t seed = queue[iseed];
+      if (seed.level == 0 || refined.at (seed) < seed.depth) {
+        /* Level 0 elements do not constrain their neighbors and
+         * elements that we reached on a shorter path later are queued again. */
+        continue;
+      }
+      const t8_eclass_t eclass = (t8_eclass_t) seed.eclass;
+      t8_element_t *element = get_scratch (T8_BALANCE_SLOT_ELEMENT, eclass);
+      t8_forest_get_eclass_scheme (forest, eclass)->t8_element_set_linear_id (element, seed.level, seed.id);
+      add_neighbor_refinements (t8_cmesh_get_local_id (t8_forest_get_cmesh (forest), seed.gtreeid), eclass, element,
+                                seed.depth);
+    }
+    queue.clear ();
+  }
+
+  /* Send the refined elements in the partition of other processes to their owners
+   * and receive the refined elements in our partition from the other processes. */
+  void
+  exchange ()
+  {
+    const int mpisize = forest->mpisize;
+    std::vector<int> send_bytes (mpisize), recv_bytes (mpisize);
+    std::vector<size_t> recv_offsets (mpisize + 1, 0);
+    std::vector<sc_MPI_Request> requests;
+    int mpiret;
+
+    for (int iproc = 0; iproc < mpisize; iproc++) {
+      send_bytes[iproc] = send[iproc].size () * sizeof (t8_forest_balance_seed_t);
+    }
+    mpiret = sc_MPI_Alltoall (send_bytes.data (), 1, sc_MPI_INT, recv_bytes.data (), 1, sc_MPI_INT, forest->mpicomm);
+    SC_CHECK_MPI (mpiret);
+    for (int iproc = 0; iproc < mpisize; iproc++) {
+      recv_offsets[iproc + 1] = recv_offsets[iproc] + recv_bytes[iproc] / sizeof (t8_forest_balance_seed_t);
+    }
+    std::vector<t8_forest_balance_seed_t> recv (recv_offsets[mpisize]);
+    requests.reserve (2 * mpisize);
+    for (int iproc = 0; iproc < mpisize; iproc++) {
+      if (recv_bytes[iproc] > 0) {
+        requests.emplace_back ();
+        mpiret = sc_MPI_Irecv (recv.data () + recv_offsets[iproc], recv_bytes[iproc], sc_MPI_BYTE, iproc,
+                               T8_MPI_BALANCE_FOREST, forest->mpicomm, &requests.back ());
+        SC_CHECK_MPI (mpiret);
+      }
+    }
+    for (int iproc = 0; iproc < mpisize; iproc++) {
+      if (send_bytes[iproc] > 0) {
+        requests.emplace_back ();
+        mpiret = sc_MPI_Isend (send[iproc].data (), send_bytes[iproc], sc_MPI_BYTE, iproc, T8_MPI_BALANCE_FOREST,
+                               forest->mpicomm, &requests.back ());
+        SC_CHECK_MPI (mpiret);
+      }
+    }
+    mpiret = sc_MPI_Waitall (requests.size (), requests.data (), sc_MPI_STATUSES_IGNORE);
+    SC_CHECK_MPI (mpiret);
+    for (auto &seeds : send) {
+      seeds.clear ();
+    }
+    num_seeds_to_send = num_open_seeds_to_send = 0;
+
+    for (const t8_forest_balance_seed_t &seed : recv) {
+      T8_ASSERT (t8_forest_get_local_id (forest, seed.gtreeid) >= 0);
+      if (seed.open) {
+        /* The sender could not apply the rule to this element, we continue */
+        const t8_eclass_t eclass = (t8_eclass_t) seed.eclass;
+        t8_element_t *element = get_scratch (T8_BALANCE_SLOT_PARENT, eclass);
+        t8_forest_get_eclass_scheme (forest, eclass)->t8_element_set_linear_id (element, seed.level, seed.id);
+        refine (seed.gtreeid, eclass, element, get_scratch (T8_BALANCE_SLOT_NEIGHBOR, eclass), seed.depth);
+      }
+      else {
+        /* The sender already applied the rule to this element and its ancestors */
+        auto found = refined.emplace (seed, seed.depth).first;
+        found->second = SC_MIN (found->second, seed.depth);
+      }
+    }
+  }
+
+  /* Return true if a leaf of the input forest has to be refined.
+   * Also record the largest number of ripple steps of all refined leaves. */
+  int
+  is_refined (t8_gloidx_t gtreeid, const t8_element_t *element, t8_eclass_scheme_c *ts)
+  {
+    t8_forest_balance_seed_t seed;
+
+    seed.gtreeid = gtreeid;
+    seed.level = ts->t8_element_level (element);
+    seed.id = ts->t8_element_get_linear_id (element, seed.level);
+    auto found = refined.find (seed);
+    if (found == refined.end ()) {
+      return 0;
+    }
+    max_depth = SC_MAX (max_depth, found->second);
+    return 1;
+  }
+
+  /* The number of refined elements that we send to other processes in the next exchange. */
+  int num_seeds_to_send = 0;
+  /* The number of those elements to which the receiver still has to apply the rule. */
+  int num_open_seeds_to_send = 0;
+  /* The largest number of ripple steps that led to the refinement of a local leaf. */
+  int max_depth = 0;
+
+ private:
+  /* The scratch elements that we allocate per element class. */
+  enum {
+    T8_BALANCE_SLOT_ELEMENT,
+    T8_BALANCE_SLOT_ANCESTOR,
+    T8_BALANCE_SLOT_NEIGHBOR,
+    T8_BALANCE_SLOT_PARENT,
+    T8_BALANCE_SLOT_COUNT
+  };
+
+  t8_element_t *
+  get_scratch (int slot, t8_eclass_t eclass)
+  {
+    if (scratch[slot][eclass] == NULL) {
+      t8_forest_get_eclass_scheme (forest, eclass)->t8_element_new (1, &scratch[slot][eclass]);
+    }
+    return scratch[slot][eclass];
+  }
+
+  /* Refine the parents of the same level face neighbors of a refined element.
+   * The element must lie in a local tree of the cmesh and its level must be positive. */
+  void
+  add_neighbor_refinements (t8_locidx_t lctreeid, t8_eclass_t eclass, const t8_element_t *element, int depth)
+  {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
+    const int num_faces = ts->t8_element_num_faces (element);
+    int dual_face;
+
+    T8_ASSERT (ts->t8_element_level (element) > 0);
+    for (int iface = 0; iface < num_faces; iface++) {
+      const t8_eclass_t neigh_class = t8_forest_element_neighbor_eclass_cmesh (forest, lctreeid, element, iface);
+      t8_eclass_scheme_c *neigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
+      t8_element_t *neigh = get_scratch (T8_BALANCE_SLOT_NEIGHBOR, neigh_class);
+      const t8_gloidx_t gneigh_tree
+        = t8_forest_element_face_neighbor_cmesh (forest, lctreeid, element, neigh, neigh_scheme, iface, &dual_face);
+      if (gneigh_tree < 0) {
+        /* This face is a domain boundary */
+        continue;
+      }
+      t8_element_t *parent = get_scratch (T8_BALANCE_SLOT_PARENT, neigh_class);
+      neigh_scheme->t8_element_parent (neigh, parent);
+      refine (gneigh_tree, neigh_class, parent, neigh, depth + 1);
+    }
+  }
+
+  /* Mark an element and its ancestors as refined, unless they are refined in the input forest.
+   * Newly refined elements in local trees of the cmesh are queued, those in the partition of
+   * another process are sent to their owner.
+   * The contents of element and scratch_element are overwritten. */
+  void
+  refine (t8_gloidx_t gtreeid, t8_eclass_t eclass, t8_element_t *element, t8_element_t *scratch_element, int depth)
+  {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
+    const t8_cmesh_t cmesh = t8_forest_get_cmesh (forest);
+    const t8_locidx_t lctreeid = t8_cmesh_get_local_id (cmesh, gtreeid);
+    const int is_cmesh_local = 0 <= lctreeid && lctreeid < t8_cmesh_get_num_local_trees (cmesh);
+    t8_forest_balance_seed_t seed;
+
+    seed.gtreeid = gtreeid;
+    seed.eclass = eclass;
+    seed.depth = depth;
+    seed.open = !is_cmesh_local;
+    for (;;) {
+      int owner = forest->mpirank;
+      if (forest->mpisize > 1) {
+        int upper = forest->mpisize - 1;
+        owner = 0;
+        t8_forest_element_owners_bounds (forest, gtreeid, element, eclass, &owner, &upper);
+        if (owner < upper) {
+          /* The element is shared by several processes, thus it is refined in the input forest.
+           * The owner of its first leaf applies the rule to it. */
+          return;
+        }
+      }
+      seed.level = ts->t8_element_level (element);
+      seed.id = ts->t8_element_get_linear_id (element, seed.level);
+      auto found = refined.find (seed);
+      if (found == refined.end ()) {
+        if (owner == forest->mpirank && t8_forest_element_has_leaf_desc (forest, gtreeid, element, ts)) {
+          /* The element is refined in the input forest. We apply the rule to it as the owner of its first leaf. */
+          return;
+        }
+        refined.emplace (seed, depth);
+      }
+      else if (found->second <= depth) {
+        /* The element and its ancestors are already refined */
+        return;
+      }
+      else {
+        /* We reached the element on a shorter path */
+        found->second = depth;
+      }
+      if (is_cmesh_local) {
+        queue.push_back (seed);
+      }
+      if (owner != forest->mpirank) {
+        send[owner].push_back (seed);
+        num_seeds_to_send++;
+        num_open_seeds_to_send += seed.open;
+      }
+      if (!is_cmesh_local || seed.level == 0) {
+        /* If the tree is not local in the cmesh, the owner refines the ancestors */
+        return;
+      }
+      ts->t8_element_parent (element, scratch_element);
+      std::swap (element, scratch_element);
     }
   }
-  /* Communicate the local maximum levels */
-  sc_MPI_Allreduce (&local_max_level, &forest->maxlevel_existing, 1, sc_MPI_INT, sc_MPI_MAX, forest->mpicomm);
+
+  t8_forest_t forest; /* The input forest. */
+  /* The refined elements that are not refined in the input forest, with their number of ripple steps. */
+  std::unordered_map<t8_forest_balance_seed_t, int, t8_forest_balance_seed_hash, t8_forest_balance_seed_equal> refined;
+  /* The refined elements to which we still have to apply the rule. */
+  std::vector<t8_forest_balance_seed_t> queue;
+  /* For each process the refined elements that we send to it. */
+  std::vector<std::vector<t8_forest_balance_seed_t>> send;
+  std::array<std::array<t8_element_t *, T8_ECLASS_COUNT>, T8_BALANCE_SLOT_COUNT> scratch;
+};
+
+/* The adapt callback that builds the balanced forest.
+ * The user data of forest is the closure of the refined elements. */
+static int
+t8_forest_balance_refine (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                          t8_eclass_scheme_c *ts, const int is_family, const int num_elements, t8_element_t *elements[])
+{
+  t8_forest_balance_closure *closure = (t8_forest_balance_closure *) t8_forest_get_user_data (forest);
+
+  return closure->is_refined (t8_forest_global_tree_id (forest_from, which_tree), elements[0], ts);
 }
 
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
 void
 t8_forest_balance (t8_forest_t forest, int repartition)
 {
-  t8_forest_t forest_temp, forest_from, forest_partition;
-  int done = 0, done_global = 0;
-  int count_rounds = 0;
+  t8_forest_t forest_from = forest->set_from;
+  t8_forest_t forest_balanced, forest_partition;
+  int num_rounds = 0;
+  int num_seeds[2], num_seeds_global[2];
+  int max_depth = 0;
+  int mpiret;
   /* The following variables are only required if profiling is
    * enabled. */
-  int num_stats_allocated, istats;
-  const int stat_alloc_chunk_size = 10; /* How many stats we allocate (and add if we need more) */
-  int count_adapt_stats = 0, count_ghost_stats = 0;
-  int count_partition_stats = 0;
-  double ada_time, ghost_time, part_time;
-  sc_statinfo_t *adap_stats, *ghost_stats, *partition_stats;
+  double ripple_time = 0, exchange_time = 0, adapt_time = 0, part_time = 0;
+  sc_statinfo_t stats[4];
 
   t8_global_productionf ("Into t8_forest_balance with %lli global elements.\n",
-                         (long long) t8_forest_get_global_num_elements (forest->set_from));
+                         (long long) t8_forest_get_global_num_elements (forest_from));
   t8_log_indent_push ();
 
-  /* Set default value to prevent compiler warning */
-  adap_stats = ghost_stats = partition_stats = NULL;
-
   if (forest->profile != NULL) {
     /* Profiling is enable, so we measure the runtime of balance */
     forest->profile->balance_runtime = -sc_MPI_Wtime ();
-    /* We store the individual adapt, ghost, and partition runtimes */
-    /* We reserve memory for stat_alloc_chunk_size - 1 many balance rounds
-     * (the extra entry is required for the total sum).
-     * We will grow the statistics arrays dynamically if more rounds are required. */
-    T8_ASSERT (stat_alloc_chunk_size > 0);
-    num_stats_allocated = stat_alloc_chunk_size;
-    adap_stats = T8_ALLOC_ZERO (sc_statinfo_t, num_stats_allocated);
-    ghost_stats = T8_ALLOC_ZERO (sc_statinfo_t, num_stats_allocated);
-    if (repartition) {
-      partition_stats = T8_ALLOC_ZERO (sc_statinfo_t, num_stats_allocated);
-    }
   }
 
-  /* Compute the maximum occurring refinement level in the forest */
-  t8_forest_compute_max_element_level (forest->set_from);
-  t8_global_productionf ("Computed maximum occurring level:\t%i\n", forest->set_from->maxlevel_existing);
-  /* Use set_from as the first forest to adapt */
-  forest_from = forest->set_from;
-  /* This function is reference neutral regarding forest_from */
-  t8_forest_ref (forest_from);
-
-  if (forest->set_from->ghosts == NULL) {
-    forest->set_from->ghost_type = T8_GHOST_FACES;
-    t8_forest_ghost_create_topdown (forest->set_from);
-  }
+  {
+    t8_forest_balance_closure closure (forest_from);
 
-  while (!done_global) {
-    done = 1;
-
-    T8_ASSERT (forest_from->maxlevel_existing >= 0);
-    /* Initialize the temp forest to be adapted from forest_from */
-    t8_forest_init (&forest_temp);
-    /* Update the maximum occurring level */
-    forest_temp->maxlevel_existing = forest_from->maxlevel_existing;
-    /* Adapt the forest */
-    t8_forest_set_adapt (forest_temp, forest_from, t8_forest_balance_adapt, 0);
-    if (!repartition) {
-      t8_forest_set_ghost (forest_temp, 1, T8_GHOST_FACES);
-    }
-    forest_temp->t8code_data = &done;
-    /* If profiling is enabled, measure ghost/adapt rumtimes */
+    /* Compute the elements that have to be refined. In each round, we apply the balance rule
+     * to all refined elements that we know of and exchange the refined elements in the partitions
+     * of other processes once. Another round is only needed if a process received elements
+     * to which it has to apply the rule. */
     if (forest->profile != NULL) {
-      t8_forest_set_profiling (forest_temp, 1);
+      ripple_time -= sc_MPI_Wtime ();
     }
-    t8_global_productionf ("Profiling: %i\n", forest->profile != NULL);
-    /* Adapt the forest */
-    t8_forest_commit (forest_temp);
-    /* Store the runtimes of adapt and ghost */
+    closure.add_input_refinements ();
     if (forest->profile != NULL) {
-      if (count_rounds > num_stats_allocated - 2) {
-        T8_ASSERT (count_adapt_stats <= count_rounds);
-        T8_ASSERT (count_ghost_stats <= count_rounds);
-        T8_ASSERT (count_partition_stats <= count_rounds);
-        /* re-allocate memory for stats */
-        num_stats_allocated += stat_alloc_chunk_size;
-        adap_stats = T8_REALLOC (adap_stats, sc_statinfo_t, num_stats_allocated);
-        ghost_stats = T8_REALLOC (ghost_stats, sc_statinfo_t, num_stats_allocated);
-        if (repartition) {
-          partition_stats = T8_REALLOC (partition_stats, sc_statinfo_t, num_stats_allocated);
-        }
+      ripple_time += sc_MPI_Wtime ();
+    }
+    do {
+      num_rounds++;
+      if (forest->profile != NULL) {
+        ripple_time -= sc_MPI_Wtime ();
       }
-      sc_stats_set1 (&adap_stats[count_adapt_stats], forest_temp->profile->adapt_runtime, "forest balance: Adapt time");
-      count_adapt_stats++;
-      if (!repartition) {
-        sc_stats_set1 (&ghost_stats[count_ghost_stats], forest_temp->profile->ghost_runtime,
-                       "forest balance: Ghost time");
-        count_ghost_stats++;
+      closure.propagate ();
+      if (forest->profile != NULL) {
+        ripple_time += sc_MPI_Wtime ();
+      }
+      if (forest->mpisize == 1) {
+        /* On a single process there are no remote refinements */
+        break;
+      }
+      num_seeds[0] = closure.num_seeds_to_send;
+      num_seeds[1] = closure.num_open_seeds_to_send;
+      mpiret = sc_MPI_Allreduce (num_seeds, num_seeds_global, 2, sc_MPI_INT, sc_MPI_SUM, forest->mpicomm);
+      SC_CHECK_MPI (mpiret);
+      if (num_seeds_global[0] == 0) {
+        break;
       }
-    }
-
-    /* Compute the logical and of all process local done values, if this results
-     * in 1 then all processes are finished */
-    sc_MPI_Allreduce (&done, &done_global, 1, sc_MPI_INT, sc_MPI_LAND, forest->mpicomm);
-
-    if (repartition && !done_global) {
-      /* If repartitioning is used, we partition the forest */
-      t8_forest_init (&forest_partition);
-      /* Update the maximum occurring level */
-      forest_partition->maxlevel_existing = forest_temp->maxlevel_existing;
-      t8_forest_set_partition (forest_partition, forest_temp, 0);
-      t8_forest_set_ghost (forest_partition, 1, T8_GHOST_FACES);
-      /* If profiling is enabled, measure partition rumtimes */
       if (forest->profile != NULL) {
-        t8_forest_set_profiling (forest_partition, 1);
+        exchange_time -= sc_MPI_Wtime ();
       }
-      t8_forest_commit (forest_partition);
-
-      /* Store the runtimes of partition */
+      closure.exchange ();
       if (forest->profile != NULL) {
-        sc_stats_set1 (&partition_stats[count_partition_stats], forest_partition->profile->partition_runtime,
-                       "forest balance: Partition time");
-        count_partition_stats++;
-        sc_stats_set1 (&ghost_stats[count_ghost_stats], forest_partition->profile->ghost_runtime,
-                       "forest balance: Ghost time");
-        count_ghost_stats++;
+        exchange_time += sc_MPI_Wtime ();
       }
+    } while (num_seeds_global[1] > 0);
+
+    /* Build the balanced forest by refining the input forest recursively once */
+    t8_forest_ref (forest_from);
+    t8_forest_init (&forest_balanced);
+    t8_forest_set_adapt (forest_balanced, forest_from, t8_forest_balance_refine, 1);
+    t8_forest_set_user_data (forest_balanced, &closure);
+    if (forest->profile != NULL) {
+      t8_forest_set_profiling (forest_balanced, 1);
+    }
+    t8_forest_commit (forest_balanced);
+    if (forest->profile != NULL) {
+      adapt_time = forest_balanced->profile->adapt_runtime;
+    }
+    max_depth = closure.max_depth;
+  }
+  T8_ASSERT (t8_forest_is_balanced (forest_balanced));
 
-      forest_temp = forest_partition;
-      forest_partition = NULL;
+  if (repartition) {
+    /* Partition the balanced forest once */
+    t8_forest_init (&forest_partition);
+    t8_forest_set_partition (forest_partition, forest_balanced, 0);
+    if (forest->profile != NULL) {
+      t8_forest_set_profiling (forest_partition, 1);
+    }
+    t8_forest_commit (forest_partition);
+    if (forest->profile != NULL) {
+      part_time = forest_partition->profile->partition_runtime;
     }
-    /* Adapt forest_temp in the next round */
-    forest_from = forest_temp;
-    count_rounds++;
+    forest_balanced = forest_partition;
   }
 
-  T8_ASSERT (t8_forest_is_balanced (forest_temp));
-  /* Forest_temp is now balanced, we copy its trees and elements to forest */
-  t8_forest_copy_trees (forest, forest_temp, 1);
+  /* forest_balanced is now balanced, we copy its trees and elements to forest */
+  t8_forest_copy_trees (forest, forest_balanced, 1);
   /* TODO: Also copy ghost elements if ghost creation is set */
 
   t8_log_indent_pop ();
   t8_global_productionf ("Done t8_forest_balance with %lli global elements.\n",
-                         (long long) t8_forest_get_global_num_elements (forest_temp));
-  t8_debugf ("t8_forest_balance needed %i rounds.\n", count_rounds);
+                         (long long) t8_forest_get_global_num_elements (forest_balanced));
+  t8_debugf ("t8_forest_balance needed %i rounds.\n", num_rounds);
   /* clean-up */
-  t8_forest_unref (&forest_temp);
+  t8_forest_unref (&forest_balanced);
 
   if (forest->profile != NULL) {
     /* Profiling is enabled, so we measure the runtime of balance. */
     forest->profile->balance_runtime += sc_MPI_Wtime ();
-    forest->profile->balance_rounds = count_rounds;
-    /* Print the runtime of adapt/ghost/partition */
-    /* Compute the overall runtime and store in last entry */
-    ada_time = ghost_time = part_time = 0;
-    for (istats = 0; istats < count_adapt_stats; istats++) {
-      ada_time += adap_stats[istats].sum_values;
-    }
-    for (istats = 0; istats < count_ghost_stats; istats++) {
-      ghost_time += ghost_stats[istats].sum_values;
-    }
-    if (repartition) {
-      for (istats = 0; istats < count_partition_stats; istats++) {
-        part_time += partition_stats[istats].sum_values;
-      }
-    }
-    sc_stats_set1 (&adap_stats[count_adapt_stats], ada_time, "forest balance: Total adapt time");
-    sc_stats_set1 (&ghost_stats[count_ghost_stats], ghost_time, "forest balance: Total ghost time");
-    if (repartition) {
-      sc_stats_set1 (&partition_stats[count_partition_stats], part_time, "forest balance: Total partition time");
-    }
-
-    /* Compute and print the intermediate stats */
-    T8_ASSERT (count_rounds + 1 <= num_stats_allocated);
-    sc_stats_compute (forest->mpicomm, count_adapt_stats + 1, adap_stats);
-    sc_stats_compute (forest->mpicomm, count_ghost_stats + 1, ghost_stats);
-    if (repartition) {
-      sc_stats_compute (forest->mpicomm, count_partition_stats + 1, partition_stats);
-    }
-    sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, count_adapt_stats + 1, adap_stats, 1, 1);
-    sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, count_ghost_stats + 1, ghost_stats, 1, 1);
-    if (repartition) {
-      sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, count_partition_stats + 1, partition_stats, 1, 1);
-    }
-    T8_FREE (adap_stats);
-    T8_FREE (ghost_stats);
-    if (repartition) {
-      T8_FREE (partition_stats);
-    }
+    forest->profile->balance_rounds = num_rounds;
+    /* An element that was refined after k ripple steps is refined in round k or later
+     * by the adapt based algorithm, which needs one more round to detect that it is done. */
+    mpiret = sc_MPI_Allreduce (&max_depth, &forest->profile->balance_rounds_saved, 1, sc_MPI_INT, sc_MPI_MAX,
+                               forest->mpicomm);
+    SC_CHECK_MPI (mpiret);
+    forest->profile->balance_rounds_saved += 1 - num_rounds;
+    /* Print the runtime of ripple/exchange/adapt/partition */
+    sc_stats_set1 (&stats[0], ripple_time, "forest balance: Total ripple time");
+    sc_stats_set1 (&stats[1], exchange_time, "forest balance: Total exchange time");
+    sc_stats_set1 (&stats[2], adapt_time, "forest balance: Total adapt time");
+    sc_stats_set1 (&stats[3], part_time, "forest balance: Total partition time");
+    sc_stats_compute (forest->mpicomm, repartition ? 4 : 3, stats);
+    sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, repartition ? 4 : 3, stats, 1, 1);
   }
 }
 
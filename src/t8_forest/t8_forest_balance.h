@@ -35,8 +35,17 @@
 
 T8_EXTERN_C_BEGIN ();
 
-/* TODO: document
- * only temporary and will be replaced in future */
+/** Balance forest->set_from and store the result in forest.
+ * The refined elements of the balanced forest are computed directly as the closure of the
+ * refined elements of forest->set_from: If an element is refined, the parents of its face neighbors
+ * of the same level are refined as well. Each process computes this closure for its own refinements,
+ * including the insulation layer around its partition, and sends the refinements in the partition of
+ * other processes to their owners once. A further round is only required if the closure reaches trees
+ * that are not local in the cmesh. Afterwards, forest->set_from is refined recursively in one adapt step.
+ * \param [in,out] forest      The forest that is currently committed.
+ * \param [in]     repartition If true, the balanced forest is partitioned before it is
+ *                             stored in \a forest.
+ */
 void
 t8_forest_balance (t8_forest_t forest, int repartition);
 
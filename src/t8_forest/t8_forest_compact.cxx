@@ -0,0 +1,251 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest/t8_forest_compact.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_private.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_element.hxx>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* The mask of the linear id bits of a key. */
+#define T8_FOREST_COMPACT_ID_MASK ((((t8_linearidx_t) 1) << T8_FOREST_COMPACT_ID_BITS) - 1)
+
+/* Pack the level and the linear id of an element into a key. */
+static inline t8_linearidx_t
+t8_forest_compact_key (const int level, const t8_linearidx_t id)
+{
+  T8_ASSERT ((id & ~T8_FOREST_COMPACT_ID_MASK) == 0);
+  return (((t8_linearidx_t) level) << T8_FOREST_COMPACT_ID_BITS) | id;
+}
+
+/* Set an element from a key. */
+static inline void
+t8_forest_compact_decode (const t8_eclass_scheme_c *ts, const t8_linearidx_t key, t8_element_t *element)
+{
+  ts->t8_element_set_linear_id (element, (int) (key >> T8_FOREST_COMPACT_ID_BITS), key & T8_FOREST_COMPACT_ID_MASK);
+}
+
+/* Return the keys of a local tree if the tree is stored in compact form and NULL otherwise. */
+static const sc_array_t *
+t8_forest_compact_get_keys (const t8_forest_t forest, const t8_locidx_t ltreeid)
+{
+  if (forest->compact_trees == NULL) {
+    return NULL;
+  }
+  const sc_array_t *keys = (const sc_array_t *) t8_sc_array_index_locidx (forest->compact_trees, ltreeid);
+  /* Trees in full storage, and empty trees, have no keys. */
+  return keys->elem_count > 0 ? keys : NULL;
+}
+
+/* Try to encode the elements of a tree into keys.
+ * Return true if the tree fits into compact storage. Otherwise, keys is empty on output. */
+static int
+t8_forest_compact_tree (const t8_eclass_scheme_c *ts, const t8_tree_t tree, sc_array_t *keys)
+{
+  const size_t num_elements = t8_element_array_get_count (&tree->elements);
+
+  if (ts->t8_element_size () <= sizeof (t8_linearidx_t) || num_elements == 0) {
+    /* The elements are not larger than a key, compacting would not save memory. */
+    sc_array_init (keys, sizeof (t8_linearidx_t));
+    return 0;
+  }
+  /* Allocate the exact number of keys, since we want to save memory. */
+  sc_array_init_size (keys, sizeof (t8_linearidx_t), num_elements);
+  t8_linearidx_t *key = (t8_linearidx_t *) keys->array;
+  for (size_t ielem = 0; ielem < num_elements; ielem++) {
+    const t8_element_t *element = t8_element_array_index_locidx (&tree->elements, ielem);
+    const int level = ts->t8_element_level (element);
+    const t8_linearidx_t id = ts->t8_element_get_linear_id (element, level);
+    if ((id & ~T8_FOREST_COMPACT_ID_MASK) != 0) {
+      /* This id does not fit into a key, the tree keeps its full storage. */
+      sc_array_reset (keys);
+      return 0;
+    }
+    key[ielem] = t8_forest_compact_key (level, id);
+  }
+  return 1;
+}
+
+void
+t8_forest_compact (t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  /* The level must fit into the upper bits of a key. */
+  T8_ASSERT (forest->maxlevel < (1 << (64 - T8_FOREST_COMPACT_ID_BITS)));
+
+  if (t8_forest_is_compact (forest)) {
+    return;
+  }
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  forest->compact_trees = sc_array_new_count (sizeof (sc_array_t), num_local_trees);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_tree_t tree = t8_forest_get_tree (forest, itree);
+    const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, tree->eclass);
+    sc_array_t *keys = (sc_array_t *) t8_sc_array_index_locidx (forest->compact_trees, itree);
+
+    if (t8_forest_compact_tree (ts, tree, keys)) {
+      /* Free the elements. The array stays initialized with its scheme and count zero. */
+      t8_element_array_reset (&tree->elements);
+      tree->num_compact_elements = (t8_locidx_t) keys->elem_count;
+    }
+  }
+}
+
+void
+t8_forest_expand (t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+
+  if (!t8_forest_is_compact (forest)) {
+    return;
+  }
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    sc_array_t *keys = (sc_array_t *) t8_sc_array_index_locidx (forest->compact_trees, itree);
+    const size_t num_elements = keys->elem_count;
+    if (num_elements > 0) {
+      const t8_tree_t tree = t8_forest_get_tree (forest, itree);
+      t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, tree->eclass);
+      T8_ASSERT (t8_element_array_get_count (&tree->elements) == 0);
+
+      t8_element_array_init_size (&tree->elements, ts, num_elements);
+      const t8_linearidx_t *key = (const t8_linearidx_t *) keys->array;
+      for (size_t ielem = 0; ielem < num_elements; ielem++) {
+        t8_forest_compact_decode (ts, key[ielem], t8_element_array_index_locidx_mutable (&tree->elements, ielem));
+      }
+      tree->num_compact_elements = 0;
+    }
+    sc_array_reset (keys);
+  }
+  sc_array_destroy (forest->compact_trees);
+  forest->compact_trees = NULL;
+}
+
+int
+t8_forest_is_compact (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  return forest->compact_trees != NULL;
+}
+
+t8_locidx_t
+t8_forest_compact_get_tree_num_elements (const t8_forest_t forest, const t8_locidx_t ltreeid)
+{
+  const sc_array_t *keys = t8_forest_compact_get_keys (forest, ltreeid);
+  if (keys != NULL) {
+    return (t8_locidx_t) keys->elem_count;
+  }
+  return t8_forest_get_tree_element_count (t8_forest_get_tree (forest, ltreeid));
+}
+
+void
+t8_forest_decode_element_in_tree (const t8_forest_t forest, const t8_locidx_t ltreeid, const t8_locidx_t leid_in_tree,
+                                  t8_element_t *element)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (0 <= ltreeid && ltreeid < t8_forest_get_num_local_trees (forest));
+
+  const t8_tree_t tree = t8_forest_get_tree (forest, ltreeid);
+  const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, tree->eclass);
+  const sc_array_t *keys = t8_forest_compact_get_keys (forest, ltreeid);
+  if (keys != NULL) {
+    T8_ASSERT (0 <= leid_in_tree && (size_t) leid_in_tree < keys->elem_count);
+    t8_forest_compact_decode (ts, *(const t8_linearidx_t *) t8_sc_array_index_locidx (keys, leid_in_tree), element);
+  }
+  else {
+    ts->t8_element_copy (t8_forest_get_tree_element (tree, leid_in_tree), element);
+  }
+}
+
+void
+t8_forest_decode_elements_in_tree (const t8_forest_t forest, const t8_locidx_t ltreeid, const t8_locidx_t first,
+                                   const t8_locidx_t count, t8_element_array_t *elements)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (0 <= ltreeid && ltreeid < t8_forest_get_num_local_trees (forest));
+  T8_ASSERT (0 <= first && 0 <= count);
+  T8_ASSERT (first + count <= t8_forest_compact_get_tree_num_elements (forest, ltreeid));
+  T8_ASSERT ((size_t) count <= t8_element_array_get_count (elements));
+
+  const t8_tree_t tree = t8_forest_get_tree (forest, ltreeid);
+  const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, tree->eclass);
+  T8_ASSERT (t8_element_array_get_scheme (elements) == ts);
+  const sc_array_t *keys = t8_forest_compact_get_keys (forest, ltreeid);
+  if (keys != NULL) {
+    /* The keys of the range are contiguous, so a sweep over a tree reads 8 bytes per element. */
+    const t8_linearidx_t *key = (const t8_linearidx_t *) t8_sc_array_index_locidx (keys, first);
+    for (t8_locidx_t ielem = 0; ielem < count; ielem++) {
+      t8_forest_compact_decode (ts, key[ielem], t8_element_array_index_locidx_mutable (elements, ielem));
+    }
+  }
+  else {
+    for (t8_locidx_t ielem = 0; ielem < count; ielem++) {
+      ts->t8_element_copy (t8_forest_get_tree_element (tree, first + ielem),
+                           t8_element_array_index_locidx_mutable (elements, ielem));
+    }
+  }
+}
+
+void
+t8_forest_compact_check_expanded (const t8_forest_t forest, const char *function)
+{
+  SC_CHECK_ABORTF (forest->compact_trees == NULL,
+                   "%s needs the elements of the forest, but the forest is compact. Call t8_forest_expand first.\n",
+                   function);
+}
+
+size_t
+t8_forest_get_element_memory (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+
+  size_t memory = 0;
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_tree_t tree = t8_forest_get_tree (forest, itree);
+    memory += t8_element_array_get_count (&tree->elements) * t8_element_array_get_size (&tree->elements);
+    if (forest->compact_trees != NULL) {
+      const sc_array_t *keys = (const sc_array_t *) t8_sc_array_index_locidx (forest->compact_trees, itree);
+      memory += keys->elem_count * keys->elem_size;
+    }
+  }
+  return memory;
+}
+
+void
+t8_forest_compact_reset (t8_forest_t forest)
+{
+  if (forest->compact_trees == NULL) {
+    return;
+  }
+  const t8_locidx_t num_local_trees = (t8_locidx_t) forest->compact_trees->elem_count;
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    sc_array_reset ((sc_array_t *) t8_sc_array_index_locidx (forest->compact_trees, itree));
+  }
+  sc_array_destroy (forest->compact_trees);
+  forest->compact_trees = NULL;
+}
+
+T8_EXTERN_C_END ();
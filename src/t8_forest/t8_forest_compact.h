@@ -0,0 +1,100 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_compact.h
+ * We define a compact storage mode for the local elements of a committed forest.
+ * In compact mode each element is stored as a single 64-bit key that packs its
+ * refinement level and its linear id on that level. Elements are decoded through
+ * the scheme when they are accessed.
+ */
+
+#ifndef T8_FOREST_COMPACT_H
+#define T8_FOREST_COMPACT_H
+
+#include <t8.h>
+#include <t8_forest/t8_forest_general.h>
+
+/** The number of bits of a compact key that store the linear id of an element.
+ * The remaining upper bits store the level. */
+#define T8_FOREST_COMPACT_ID_BITS 59
+
+T8_EXTERN_C_BEGIN ();
+
+/** Store the local elements of a committed forest in compact form.
+ * Each element is replaced by a key of 8 bytes packing its level and its linear id on this level.
+ * A tree that contains an element whose linear id needs more than \ref T8_FOREST_COMPACT_ID_BITS bits
+ * keeps its full element storage.
+ * While a forest is compact, its elements must be accessed via \ref t8_forest_decode_element_in_tree
+ * or \ref t8_forest_decode_elements_in_tree. Functions that work on the element arrays of the trees,
+ * such as \ref t8_forest_get_element, creating ghosts, searching, saving or writing, require
+ * \ref t8_forest_expand. They abort if the forest is compact.
+ * A compact forest can be used as the source of a new forest, \ref t8_forest_commit expands it first.
+ * \param [in,out] forest   A committed forest. If it is already compact, nothing happens.
+ */
+void
+t8_forest_compact (t8_forest_t forest);
+
+/** Restore the full element storage of a compact forest.
+ * \param [in,out] forest   A committed forest. If it is not compact, nothing happens.
+ */
+void
+t8_forest_expand (t8_forest_t forest);
+
+/** Query whether a forest stores its elements in compact form.
+ * \param [in] forest       A committed forest.
+ * \return                  True if \a forest is compact, false otherwise.
+ */
+int
+t8_forest_is_compact (const t8_forest_t forest);
+
+/** Decode an element of a local tree. This works for compact and non-compact forests.
+ * \param [in]  forest        A committed forest.
+ * \param [in]  ltreeid       The local id of a local tree of \a forest.
+ * \param [in]  leid_in_tree  The index of a leaf element in the tree.
+ * \param [out] element       An allocated element of the tree's scheme. On output the leaf element.
+ */
+void
+t8_forest_decode_element_in_tree (const t8_forest_t forest, const t8_locidx_t ltreeid, const t8_locidx_t leid_in_tree,
+                                  t8_element_t *element);
+
+/** Decode a range of consecutive elements of a local tree. This works for compact and non-compact forests.
+ * \param [in]     forest     A committed forest.
+ * \param [in]     ltreeid    The local id of a local tree of \a forest.
+ * \param [in]     first      The index of the first leaf element of the range in the tree.
+ * \param [in]     count      The number of elements of the range.
+ * \param [in,out] elements   An element array of the tree's scheme with at least \a count elements.
+ *                            On output its first \a count elements are the leaf elements of the range.
+ */
+void
+t8_forest_decode_elements_in_tree (const t8_forest_t forest, const t8_locidx_t ltreeid, const t8_locidx_t first,
+                                   const t8_locidx_t count, t8_element_array_t *elements);
+
+/** Return the number of bytes used to store the local elements of a forest.
+ * \param [in] forest       A committed forest.
+ * \return                  The number of bytes of all element and key arrays of the local trees.
+ */
+size_t
+t8_forest_get_element_memory (const t8_forest_t forest);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_COMPACT_H */
@@ -0,0 +1,394 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest/t8_forest_face_connectivity.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_private.h>
+#include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_balance.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_element.hxx>
+#include <vector>
+
+/** Builds the CSR face connectivity of a forest in a single traversal of its local leaves.
+ * The neighbors of each face are written directly into the arrays of the connectivity,
+ * which grow geometrically. All elements needed to compute the neighbors are scratch
+ * elements that are allocated once per element class and reused for all faces. */
+class t8_forest_face_connectivity_builder {
+ public:
+  t8_forest_face_connectivity_builder (t8_forest_t forest, t8_forest_face_connectivity_t *connectivity)
+    : forest (forest), connectivity (connectivity), maxlevel (forest->maxlevel)
+  {
+    for (int eclass = 0; eclass < T8_ECLASS_COUNT; eclass++) {
+      sc_array_init (&descend_scratch[eclass], sizeof (t8_element_t *));
+    }
+  }
+
+  ~t8_forest_face_connectivity_builder ()
+  {
+    for (int eclass = 0; eclass < T8_ECLASS_COUNT; eclass++) {
+      t8_eclass_scheme_c *scheme = forest->scheme_cxx->eclass_schemes[eclass];
+      for (auto &slot : scratch_slots[eclass]) {
+        if (!slot.empty ()) {
+          scheme->t8_element_destroy (slot.size (), slot.data ());
+        }
+      }
+      sc_array_t *stack = &descend_scratch[eclass];
+      if (stack->elem_count > 0) {
+        scheme->t8_element_destroy (stack->elem_count, (t8_element_t **) stack->array);
+      }
+      sc_array_reset (stack);
+    }
+  }
+
+  /** Traverse all local leaves and fill the connectivity. */
+  void
+  build ()
+  {
+    const t8_locidx_t num_local_elements = connectivity->num_local_elements;
+    t8_locidx_t lelement_id = 0;
+    const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+
+    connectivity->face_offsets = T8_ALLOC (t8_locidx_t, num_local_elements + 1);
+    for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+      const t8_eclass_t eclass = t8_forest_get_tree_class (forest, itree);
+      const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
+      const t8_locidx_t num_elements_in_tree = t8_forest_get_tree_num_elements (forest, itree);
+      for (t8_locidx_t ielement = 0; ielement < num_elements_in_tree; ielement++, lelement_id++) {
+        const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+        const int num_faces = ts->t8_element_num_faces (element);
+        connectivity->face_offsets[lelement_id] = num_face_slots;
+        for (int iface = 0; iface < num_faces; iface++) {
+          /* Open the face slot */
+          reserve (&connectivity->neighbor_offsets, &face_slot_capacity, num_face_slots + 2);
+          reserve (&connectivity->orientations, &orientation_capacity, num_face_slots + 1);
+          connectivity->neighbor_offsets[num_face_slots] = num_neighbors;
+          connectivity->orientations[num_face_slots]
+            = t8_forest_leaf_face_orientation (forest, itree, ts, element, iface);
+          num_face_slots++;
+          if (connectivity->forest_is_balanced) {
+            add_neighbors_balanced (itree, eclass, element, iface);
+          }
+          else {
+            add_neighbors_unbalanced (itree, element, iface);
+          }
+        }
+      }
+    }
+    T8_ASSERT (lelement_id == num_local_elements);
+    connectivity->face_offsets[num_local_elements] = num_face_slots;
+    reserve (&connectivity->neighbor_offsets, &face_slot_capacity, num_face_slots + 1);
+    connectivity->neighbor_offsets[num_face_slots] = num_neighbors;
+
+    /* Shrink the arrays to their final sizes */
+    connectivity->num_face_slots = num_face_slots;
+    connectivity->num_neighbors = num_neighbors;
+    connectivity->neighbor_offsets = T8_REALLOC (connectivity->neighbor_offsets, t8_locidx_t, num_face_slots + 1);
+    connectivity->orientations = T8_REALLOC (connectivity->orientations, int, SC_MAX (num_face_slots, 1));
+    connectivity->neighbor_indices
+      = T8_REALLOC (connectivity->neighbor_indices, t8_locidx_t, SC_MAX (num_neighbors, 1));
+    connectivity->dual_faces = T8_REALLOC (connectivity->dual_faces, int, SC_MAX (num_neighbors, 1));
+  }
+
+ private:
+  /** The scratch slots of an element class. */
+  enum {
+    T8_FACE_CONN_SLOT_FACE_CHILDREN = 0, /**< The children of a leaf at a face. */
+    T8_FACE_CONN_SLOT_NEIGHBORS,         /**< The (half) face neighbors of a leaf. */
+    T8_FACE_CONN_SLOT_LAST_DESC          /**< A last descendant for range checks. */
+  };
+
+  /** Enlarge an array of the connectivity such that it can store at least \a needed entries. */
+  template <typename T>
+  static void
+  reserve (T **array, t8_locidx_t *capacity, const t8_locidx_t needed)
+  {
+    if (needed > *capacity) {
+      *capacity = SC_MAX (needed, 2 * *capacity);
+      *array = T8_REALLOC (*array, T, *capacity);
+    }
+  }
+
+  /** Return at least \a count scratch elements of an element class in a slot. */
+  t8_element_t **
+  scratch (const t8_eclass_t eclass, const size_t islot, const size_t count)
+  {
+    std::vector<std::vector<t8_element_t *>> &slots = scratch_slots[eclass];
+    if (slots.size () <= islot) {
+      slots.resize (islot + 1);
+    }
+    std::vector<t8_element_t *> &slot = slots[islot];
+    if (slot.size () < count) {
+      const size_t old_count = slot.size ();
+      slot.resize (count);
+      forest->scheme_cxx->eclass_schemes[eclass]->t8_element_new (count - old_count, slot.data () + old_count);
+    }
+    return slot.data ();
+  }
+
+  /** Append a neighbor to the current face slot. */
+  void
+  append_neighbor (const t8_locidx_t index, const int dual_face)
+  {
+    reserve (&connectivity->neighbor_indices, &neighbor_capacity, num_neighbors + 1);
+    reserve (&connectivity->dual_faces, &dual_face_capacity, num_neighbors + 1);
+    connectivity->neighbor_indices[num_neighbors] = index;
+    connectivity->dual_faces[num_neighbors] = dual_face;
+    num_neighbors++;
+  }
+
+  /** Append a leaf found by \ref t8_forest_leaf_search_face_descendants to the current face slot. */
+  static void
+  append_found (const t8_element_t *leaf, const t8_locidx_t index, const int face, void *user_data)
+  {
+    ((t8_forest_face_connectivity_builder *) user_data)->append_neighbor (index, face);
+  }
+
+  /** Set the local and ghost leaves of the neighbor tree with global id \a gneigh_treeid. */
+  void
+  set_neighbor_tree (const t8_eclass_t neigh_class, const t8_gloidx_t gneigh_treeid)
+  {
+    neigh_eclass = neigh_class;
+    neigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
+    t8_forest_leaf_search_tree_init (forest, gneigh_treeid, neigh_scheme, &neigh_tree);
+  }
+
+  /** Find the leaf of the neighbor tree that is equal to or an ancestor of \a element.
+   * \return The index of the leaf as in \ref t8_forest_face_connectivity_t, or -1 if there is none.
+   *         If not -1, \a leaf_level is the level of the leaf. */
+  t8_locidx_t
+  find_leaf (const t8_element_t *element, int *leaf_level)
+  {
+    const t8_element_t *leaf;
+    t8_element_t *last_desc = scratch (neigh_eclass, T8_FACE_CONN_SLOT_LAST_DESC, 1)[0];
+    const t8_locidx_t index = t8_forest_leaf_search_ancestor (&neigh_tree, element, last_desc, &leaf);
+    if (index >= 0) {
+      *leaf_level = neigh_scheme->t8_element_level (leaf);
+    }
+    return index;
+  }
+
+  /** Append the leaf \a index that is an ancestor (or equal) of \a neighbor. The dual face of \a neighbor
+   * is moved up to the leaf. \a neighbor is modified. */
+  void
+  append_ancestor (t8_element_t *neighbor, int dual_face, const t8_locidx_t index, const int leaf_level)
+  {
+    while (neigh_scheme->t8_element_level (neighbor) > leaf_level) {
+      dual_face = neigh_scheme->t8_element_face_parent_face (neighbor, dual_face);
+      T8_ASSERT (dual_face >= 0);
+      neigh_scheme->t8_element_parent (neighbor, neighbor);
+    }
+    append_neighbor (index, dual_face);
+  }
+
+  /** Add the neighbors of a leaf in a balanced forest. The neighbor leaves are the same level neighbor,
+   * its parent, or the half face neighbors. They are found in the same order as by
+   * \ref t8_forest_leaf_face_neighbors_ext. */
+  void
+  add_neighbors_balanced (const t8_locidx_t ltreeid, const t8_eclass_t eclass, const t8_element_t *leaf,
+                          const int face)
+  {
+    const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
+    const t8_eclass_t neigh_class = t8_forest_element_neighbor_eclass (forest, ltreeid, leaf, face);
+    t8_eclass_scheme_c *scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
+    t8_gloidx_t gneigh_treeid = -1;
+    int num_half_neighbors;
+    t8_element_t **neighbors;
+
+    if (ts->t8_element_level (leaf) == maxlevel) {
+      /* At the maximum level we compute the same level neighbor instead of the half neighbors */
+      num_half_neighbors = 1;
+      neighbors = scratch (neigh_class, T8_FACE_CONN_SLOT_NEIGHBORS, 1);
+      dual_faces.resize (1);
+      gneigh_treeid
+        = t8_forest_element_face_neighbor (forest, ltreeid, leaf, neighbors[0], scheme, face, dual_faces.data ());
+    }
+    else {
+      /* Compute the neighbors of the children of leaf at face */
+      num_half_neighbors = ts->t8_element_num_face_children (leaf, face);
+      t8_element_t **children = scratch (eclass, T8_FACE_CONN_SLOT_FACE_CHILDREN, num_half_neighbors);
+      neighbors = scratch (neigh_class, T8_FACE_CONN_SLOT_NEIGHBORS, num_half_neighbors);
+      dual_faces.resize (num_half_neighbors);
+      ts->t8_element_children_at_face (leaf, face, children, num_half_neighbors, NULL);
+      for (int ichild = 0; ichild < num_half_neighbors; ichild++) {
+        const int child_face = ts->t8_element_face_child_face (leaf, face, ichild);
+        gneigh_treeid = t8_forest_element_face_neighbor (forest, ltreeid, children[ichild], neighbors[ichild], scheme,
+                                                         child_face, &dual_faces[ichild]);
+      }
+    }
+    if (gneigh_treeid < 0) {
+      /* There is no neighbor across this face */
+      return;
+    }
+    set_neighbor_tree (neigh_class, gneigh_treeid);
+
+    int leaf_level;
+    const t8_locidx_t index = find_leaf (neighbors[0], &leaf_level);
+    T8_ASSERT (index >= 0);
+    if (leaf_level < neigh_scheme->t8_element_level (neighbors[0])) {
+      /* The neighbor leaf is the same level neighbor of leaf or its parent */
+      append_ancestor (neighbors[0], dual_faces[0], index, leaf_level);
+      return;
+    }
+    /* The half neighbors are leaves */
+    append_neighbor (index, dual_faces[0]);
+    for (int ineigh = 1; ineigh < num_half_neighbors; ineigh++) {
+      const t8_locidx_t neigh_index = find_leaf (neighbors[ineigh], &leaf_level);
+      T8_ASSERT (neigh_index >= 0 && leaf_level == neigh_scheme->t8_element_level (neighbors[ineigh]));
+      append_neighbor (neigh_index, dual_faces[ineigh]);
+    }
+  }
+
+  /** Add the neighbors of a leaf in a forest that does not need to be balanced.
+   * If the same level neighbor of leaf or one of its ancestors is a leaf, it is the only neighbor.
+   * Otherwise, we descend into the children of the same level neighbor at its face, as
+   * \ref t8_forest_leaf_face_neighbors_ext does. */
+  void
+  add_neighbors_unbalanced (const t8_locidx_t ltreeid, const t8_element_t *leaf, const int face)
+  {
+    const t8_eclass_t neigh_class = t8_forest_element_neighbor_eclass (forest, ltreeid, leaf, face);
+    t8_eclass_scheme_c *scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
+    t8_element_t *same_level_neighbor = scratch (neigh_class, T8_FACE_CONN_SLOT_NEIGHBORS, 1)[0];
+    int neigh_face;
+
+    const t8_gloidx_t gneigh_treeid
+      = t8_forest_element_face_neighbor (forest, ltreeid, leaf, same_level_neighbor, scheme, face, &neigh_face);
+    if (gneigh_treeid < 0) {
+      /* There is no neighbor across this face */
+      return;
+    }
+    set_neighbor_tree (neigh_class, gneigh_treeid);
+
+    int leaf_level;
+    const t8_locidx_t index = find_leaf (same_level_neighbor, &leaf_level);
+    if (index >= 0) {
+      append_ancestor (same_level_neighbor, neigh_face, index, leaf_level);
+      return;
+    }
+    t8_forest_leaf_search_face_descendants (&neigh_tree, same_level_neighbor, neigh_face,
+                                            &descend_scratch[neigh_eclass], 0, append_found, this);
+  }
+
+  t8_forest_t forest;                           /**< The forest. */
+  t8_forest_face_connectivity_t *connectivity;  /**< The connectivity that is built. */
+  const int maxlevel;                           /**< The maximum level of the forest. */
+  t8_locidx_t num_face_slots = 0;               /**< The number of face slots so far. */
+  t8_locidx_t num_neighbors = 0;                /**< The number of neighbors so far. */
+  t8_locidx_t face_slot_capacity = 0;           /**< The allocated length of neighbor_offsets. */
+  t8_locidx_t orientation_capacity = 0;         /**< The allocated length of orientations. */
+  t8_locidx_t neighbor_capacity = 0;            /**< The allocated length of neighbor_indices. */
+  t8_locidx_t dual_face_capacity = 0;           /**< The allocated length of dual_faces. */
+  std::vector<int> dual_faces;                  /**< The dual faces of the half neighbors of the current face. */
+  std::vector<std::vector<t8_element_t *>> scratch_slots[T8_ECLASS_COUNT]; /**< Scratch elements per class. */
+  sc_array_t descend_scratch[T8_ECLASS_COUNT]; /**< The scratch stacks of the descents per class. */
+  /* The neighbor tree of the current face */
+  t8_eclass_t neigh_eclass = T8_ECLASS_ZERO;         /**< Its element class. */
+  t8_eclass_scheme_c *neigh_scheme = NULL;           /**< Its scheme. */
+  t8_forest_leaf_search_tree_t neigh_tree;           /**< Its local and ghost leaves. */
+};
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+const t8_forest_face_connectivity_t *
+t8_forest_build_face_connectivity (t8_forest_t forest, int forest_is_balanced)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (!forest_is_balanced || t8_forest_is_balanced (forest));
+  SC_CHECK_ABORT (forest->mpisize == 1 || forest->ghosts != NULL,
+                  "Ghost structure is needed for t8_forest_build_face_connectivity "
+                  "but was not found in forest.\n");
+
+  forest_is_balanced = forest_is_balanced != 0;
+  if (forest->face_connectivity != NULL) {
+    if (forest->face_connectivity->forest_is_balanced == forest_is_balanced) {
+      /* The connectivity was already built. */
+      return forest->face_connectivity;
+    }
+    /* The connectivity was built with the other algorithm, whose neighbors may be in a different order. */
+    t8_forest_invalidate_face_connectivity (forest);
+  }
+
+  t8_forest_face_connectivity_t *connectivity = T8_ALLOC_ZERO (t8_forest_face_connectivity_t, 1);
+  connectivity->num_local_elements = t8_forest_get_local_num_elements (forest);
+  connectivity->num_ghosts = t8_forest_get_num_ghosts (forest);
+  connectivity->forest_is_balanced = forest_is_balanced;
+  {
+    t8_forest_face_connectivity_builder builder (forest, connectivity);
+    builder.build ();
+  }
+
+  t8_debugf ("Built face connectivity with %li face slots and %li neighbors.\n", (long) connectivity->num_face_slots,
+             (long) connectivity->num_neighbors);
+  forest->face_connectivity = connectivity;
+  return connectivity;
+}
+
+const t8_forest_face_connectivity_t *
+t8_forest_get_face_connectivity (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  return forest->face_connectivity;
+}
+
+t8_locidx_t
+t8_forest_face_connectivity_get_neighbors (const t8_forest_face_connectivity_t *connectivity,
+                                           const t8_locidx_t lelement_id, const int face,
+                                           const t8_locidx_t **neighbor_indices, const int **dual_faces,
+                                           int *orientation)
+{
+  T8_ASSERT (connectivity != NULL);
+  T8_ASSERT (0 <= lelement_id && lelement_id < connectivity->num_local_elements);
+
+  const t8_locidx_t face_slot = connectivity->face_offsets[lelement_id] + face;
+  T8_ASSERT (0 <= face && face_slot < connectivity->face_offsets[lelement_id + 1]);
+  const t8_locidx_t first_neighbor = connectivity->neighbor_offsets[face_slot];
+
+  *neighbor_indices = connectivity->neighbor_indices + first_neighbor;
+  if (dual_faces != NULL) {
+    *dual_faces = connectivity->dual_faces + first_neighbor;
+  }
+  if (orientation != NULL) {
+    *orientation = connectivity->orientations[face_slot];
+  }
+  return connectivity->neighbor_offsets[face_slot + 1] - first_neighbor;
+}
+
+void
+t8_forest_invalidate_face_connectivity (t8_forest_t forest)
+{
+  T8_ASSERT (forest != NULL);
+
+  t8_forest_face_connectivity_t *connectivity = forest->face_connectivity;
+  if (connectivity == NULL) {
+    return;
+  }
+  T8_FREE (connectivity->face_offsets);
+  T8_FREE (connectivity->neighbor_offsets);
+  T8_FREE (connectivity->neighbor_indices);
+  T8_FREE (connectivity->dual_faces);
+  T8_FREE (connectivity->orientations);
+  T8_FREE (connectivity);
+  forest->face_connectivity = NULL;
+}
+
+T8_EXTERN_C_END ();
@@ -0,0 +1,110 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_face_connectivity.h
+ * Precomputed face connectivity of the leaves of a forest.
+ * The face neighbors of all local leaves are computed once and stored in
+ * compressed sparse row (CSR) format, such that numerical solvers can read
+ * them in their inner loops instead of calling \ref t8_forest_leaf_face_neighbors.
+ */
+
+#ifndef T8_FOREST_FACE_CONNECTIVITY_H
+#define T8_FOREST_FACE_CONNECTIVITY_H
+
+#include <t8.h>
+#include <t8_forest/t8_forest_general.h>
+
+/** The face neighbors of all local leaves of a forest in CSR format.
+ * Each face of each local leaf has a face slot. The face slots of the leaf with local index
+ * i are face_offsets[i], ..., face_offsets[i + 1] - 1, face f of the leaf has slot face_offsets[i] + f.
+ * The neighbors across the face with slot s are stored at the positions
+ * neighbor_offsets[s], ..., neighbor_offsets[s + 1] - 1 of \a neighbor_indices and \a dual_faces.
+ */
+typedef struct t8_forest_face_connectivity
+{
+  t8_locidx_t num_local_elements; /**< The number of local leaves of the forest. */
+  t8_locidx_t num_ghosts;         /**< The number of ghost leaves of the forest. */
+  t8_locidx_t num_face_slots;     /**< The number of faces of all local leaves together. */
+  t8_locidx_t num_neighbors;      /**< The number of entries in \a neighbor_indices. */
+  t8_locidx_t *face_offsets;      /**< For each local leaf its first face slot, length num_local_elements + 1. */
+  t8_locidx_t *neighbor_offsets;  /**< For each face slot its first neighbor, length num_face_slots + 1. */
+  t8_locidx_t *neighbor_indices;  /**< The indices of the neighbor leaves. 0, ..., num_local_elements - 1 for
+                                       local leaves and num_local_elements, ..., num_local_elements + num_ghosts - 1
+                                       for ghosts. */
+  int *dual_faces;                /**< For each neighbor the face of the neighbor leaf that touches the face. */
+  int *orientations;              /**< For each face slot the face orientation,
+                                       see \ref t8_forest_leaf_face_orientation. */
+  int forest_is_balanced;         /**< True if the connectivity was built with the algorithm for balanced forests. */
+} t8_forest_face_connectivity_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Build the face connectivity of the local leaves of a forest.
+ * The connectivity is cached on the forest. Further calls with the same \a forest_is_balanced
+ * value return the cached connectivity until the forest is destroyed or its ghost layer is recomputed.
+ * A call with a different \a forest_is_balanced value rebuilds the connectivity, which invalidates
+ * the previously returned one. The neighbors of each face are stored in the same order as
+ * \ref t8_forest_leaf_face_neighbors_ext returns them with the same \a forest_is_balanced value.
+ * \param [in,out] forest  A committed forest. If run with more than one process the
+ *                         forest must have a ghost layer.
+ * \param [in] forest_is_balanced True if we know that \a forest is balanced, false otherwise.
+ * \return                 The face connectivity of \a forest. It is owned by \a forest.
+ * \note Forests with more than one process must have a ghost layer.
+ */
+const t8_forest_face_connectivity_t *
+t8_forest_build_face_connectivity (t8_forest_t forest, int forest_is_balanced);
+
+/** Return the cached face connectivity of a forest.
+ * \param [in] forest  A committed forest.
+ * \return             The face connectivity built by \ref t8_forest_build_face_connectivity,
+ *                     or NULL if it was not built or was invalidated.
+ */
+const t8_forest_face_connectivity_t *
+t8_forest_get_face_connectivity (const t8_forest_t forest);
+
+/** Return the face neighbors of a local leaf from a face connectivity.
+ * \param [in] connectivity  The face connectivity of a forest.
+ * \param [in] lelement_id   The local index of a leaf of the forest.
+ * \param [in] face          A face of the leaf.
+ * \param [out] neighbor_indices On output the indices of the neighbor leaves, see
+ *                           \ref t8_forest_face_connectivity_t.
+ * \param [out] dual_faces   On output the faces of the neighbor leaves that touch \a face.
+ *                           May be NULL.
+ * \param [out] orientation  On output the face orientation. May be NULL.
+ * \return                   The number of face neighbors. 0 for a domain boundary.
+ * \note The returned arrays are owned by the connectivity and must not be freed.
+ */
+t8_locidx_t
+t8_forest_face_connectivity_get_neighbors (const t8_forest_face_connectivity_t *connectivity,
+                                           const t8_locidx_t lelement_id, const int face,
+                                           const t8_locidx_t **neighbor_indices, const int **dual_faces,
+                                           int *orientation);
+
+/** Free the cached face connectivity of a forest, if it exists.
+ * \param [in,out] forest  A forest.
+ */
+void
+t8_forest_invalidate_face_connectivity (t8_forest_t forest);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_FACE_CONNECTIVITY_H */
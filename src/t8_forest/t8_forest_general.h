@@ -35,6 +35,22 @@
 
 /** Opaque pointer to a forest implementation. */
 typedef struct t8_forest *t8_forest_t;
+
+/** Opaque handle of a ghost data exchange that is in progress.
+ * \see t8_forest_ghost_exchange_begin */
+typedef struct t8_ghost_exchange_plan *t8_ghost_exchange_t;
+
+/** Describes one field of user defined element data for a ghost data exchange.
+ * The entry of the local element or ghost with index i (0 <= i < num_local_elements + num_ghosts)
+ * is stored at (char *) data + i * stride and has elem_size bytes.
+ * \see t8_forest_ghost_exchange_fields */
+typedef struct
+{
+  void *data;       /**< Pointer to the entry of the first local element. */
+  size_t stride;    /**< The number of bytes between the entries of two consecutive elements. */
+  size_t elem_size; /**< The number of bytes of one entry. */
+} t8_ghost_exchange_field_t;
+
 typedef struct t8_tree *t8_tree_t;
 
 /** This type controls, which neighbors count as ghost elements.
@@ -115,6 +131,19 @@ typedef int (*t8_forest_adapt_t) (t8_forest_t forest, t8_forest_t forest_from, t
                                   t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
                                   const int num_elements, t8_element_t *elements[]);
 
+/** Callback function prototype to compute the weight of an element for partitioning.
+ * The weights are used by \ref t8_forest_partition to distribute the elements such
+ * that each process obtains approximately the same sum of weights.
+ * \param [in] forest       The forest that is partitioned. It is committed.
+ * \param [in] ltreeid      The local tree containing \a element.
+ * \param [in] element      An element of the tree \a ltreeid.
+ * \param [in] lelement_id  The local index of \a element in \a forest (not in the tree).
+ * \return                  The (non-negative) weight of \a element.
+ * \see t8_forest_set_partition_weights
+ */
+typedef double (*t8_forest_partition_weight_fn) (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *element,
+                                                 t8_locidx_t lelement_id);
+
 /** Create a new forest with reference count one.
  * This forest needs to be specialized with the t8_forest_set_* calls.
  * Currently it is manatory to either call the functions \ref
@@ -255,6 +284,27 @@ t8_forest_set_copy (t8_forest_t forest, const t8_forest_t from);
 void
 t8_forest_set_adapt (t8_forest_t forest, const t8_forest_t set_from, t8_forest_adapt_t adapt_fn, int recursive);
 
+/** Set the number of threads that are used to adapt the forest on committing.
+ * Local trees, and chunks of large local trees, are then adapted concurrently.
+ * The resulting elements are identical to the ones of the serial adaptation and
+ * stored in the same order.
+ * \param [in,out] forest      The forest.
+ * \param [in]     num_threads The number of threads to use. 0 and 1 (default) disable threading.
+ * \note The adapt callback is called concurrently from different threads and must
+ * therefore be thread-safe. In particular, it must not allocate elements with
+ * \ref t8_element_new, since the element memory pools of the schemes are not thread-safe.
+ * It must also not allocate memory through libsc, that is with T8_ALLOC, T8_REALLOC, T8_FREE,
+ * sc_array_t or other sc containers. Unless libsc is built with pthread support, it counts
+ * these allocations without a lock. t8code itself does not allocate through libsc on the
+ * worker threads: they store the new elements in std::vector buffers that are merged into
+ * the trees by the calling thread.
+ * \note Threading is only used for non-recursive adaptation of forests with complete trees.
+ * Otherwise, the forest is adapted serially.
+ * \note This setting only has an effect in combination with \ref t8_forest_set_adapt.
+ */
+void
+t8_forest_set_adapt_num_threads (t8_forest_t forest, int num_threads);
+
 /** Set the user data of a forest. This can i.e. be used to pass user defined
  * arguments to the adapt routine.
  * \param [in,out] forest   The forest
@@ -319,6 +369,28 @@ t8_forest_get_user_function (const t8_forest_t forest);
 void
 t8_forest_set_partition (t8_forest_t forest, const t8_forest_t set_from, int set_for_coarsening);
 
+/** Set element weights that are used when \a forest is partitioned during commit.
+ * Without weights each element counts the same and each rank is assigned the same
+ * (maybe +1) number of elements. With weights, the new element offsets are computed
+ * from a parallel prefix sum over the element weights, such that each rank is
+ * assigned approximately the same total weight.
+ * Exactly one of \a weight_fn and \a weights must be non-NULL.
+ * \param [in, out] forest  The forest. Must be initialized and not committed.
+ * \param [in]      weight_fn If not NULL, a callback that is evaluated for each
+ *                          element of the forest that is partitioned.
+ * \param [in]      weights  If not NULL, an array of non-negative weights, one for
+ *                          each local element of the forest that is partitioned.
+ *                          Since this forest must be known in advance, \a weights
+ *                          may not be used if partition is combined with \ref t8_forest_set_adapt.
+ *                          The array must stay valid until \ref t8_forest_commit returns.
+ * \note This setting only has an effect if combined with \ref t8_forest_set_partition.
+ * \note The element offsets of the partitioned forest are stored with it, hence
+ * \ref t8_forest_partition_data can be used to repartition element data accordingly.
+ * \note If the sum of all weights is zero, the elements are distributed evenly.
+ */
+void
+t8_forest_set_partition_weights (t8_forest_t forest, t8_forest_partition_weight_fn weight_fn, const double *weights);
+
 /** Set a source forest to be balanced during commit.
  * A forest is said to be balanced if each element has face neighbors of level
  * at most +1 or -1 of the element's level.
@@ -367,8 +439,17 @@ t8_forest_set_ghost (t8_forest_t forest, int do_ghost, t8_ghost_type_t ghost_typ
 void
 t8_forest_set_ghost_ext (t8_forest_t forest, int do_ghost, t8_ghost_type_t ghost_type, int ghost_version);
 
-/* TODO: use assertions and document that the forest_set (..., from) and
- *       set_load are mutually exclusive. */
+/** Set a forest to be loaded from a file written with \ref t8_forest_save during commit.
+ * The forest must have a coarse mesh and a scheme set with \ref t8_forest_set_cmesh
+ * and \ref t8_forest_set_scheme that match the ones of the saved forest.
+ * If the number of processes equals the one used for saving, the saved partition
+ * is restored. Otherwise the elements are distributed evenly among the processes.
+ * \param [in, out] forest      The forest.
+ * \param [in]      filename    The name of the file to load.
+ * \note This setting cannot be combined with \ref t8_forest_set_copy, \ref t8_forest_set_adapt,
+ *       \ref t8_forest_set_partition or \ref t8_forest_set_balance.
+ * \see t8_forest_load_data to read the saved element data.
+ */
 void
 t8_forest_set_load (t8_forest_t forest, const char *filename);
 
@@ -548,11 +629,12 @@ t8_forest_leaf_face_orientation (t8_forest_t forest, const t8_locidx_t ltreeid,
  *                        num_local_el , ... , num_local_el + num_ghosts - 1 for ghosts.
  * \param [out]   pneigh_scheme On output the eclass scheme of the neighbor elements.
  * \param [in]    forest_is_balanced True if we know that \a forest is balanced, false
- *                        otherwise.
+ *                        otherwise. If false, the neighbor leaves are found with a search
+ *                        in the descendant range of the same level face neighbor, which also
+ *                        works for forests that are not balanced.
  * \param [out]   orientation If a pointer to an integer variable is given the face orientation is computed and stored there.
  * \note If there are no face neighbors, then *neighbor_leaves = NULL, num_neighbors = 0,
  * and *pelement_indices = NULL on output.
- * \note Currently \a forest must be balanced.
  * \note \a forest must be committed before calling this function.
  *
  * \note Important! This routine allocates memory which must be freed. Do it like this:
@@ -586,13 +668,82 @@ t8_forest_leaf_face_neighbors_ext (t8_forest_t forest, t8_locidx_t ltreeid, cons
  *                         the corresponding owning process.
  * \note This function is collective and hence must be called by all processes in the forest's
  *       MPI Communicator.
+ * \note At the first call, an exchange plan with the send lists of all remote processes is
+ *       built and stored in the ghost layer. Buffers and persistent MPI requests are created once
+ *       for each element size of \a element_data and reused by all later calls.
+ * \see t8_forest_ghost_exchange_begin for a non-blocking version.
  */
-/* TODO: In \ref t8_forest_ghost_cxx we already implemented a begin and end function
- *       that allow for overlapping communication and computation. We will make them
- *       available in this interface in the future. */
 void
 t8_forest_ghost_exchange_data (t8_forest_t forest, sc_array_t *element_data);
 
+/** Exchange ghost information of several fields of user defined element data at once.
+ * In contrast to calling \ref t8_forest_ghost_exchange_data for each field, the data of all
+ * fields for a remote process is packed into a single message.
+ * Fields may be stored in separate arrays (structure of arrays) or interleaved in one array
+ * (array of structures) by choosing the stride accordingly.
+ * \param[in] forest       The forest. Must be committed.
+ * \param[in] num_fields   The number of fields. Must be positive.
+ * \param[in] fields       Array of \a num_fields field descriptors. After calling this function
+ *                         the ghost entries of each field are updated with the entries of the
+ *                         corresponding owning process.
+ * \note This function is collective and hence must be called by all processes in the forest's
+ *       MPI Communicator. All processes must pass the same fields with the same element sizes.
+ */
+void
+t8_forest_ghost_exchange_fields (t8_forest_t forest, int num_fields, const t8_ghost_exchange_field_t *fields);
+
+/** Start a ghost data exchange of several fields of user defined element data.
+ * This is the non-blocking version of \ref t8_forest_ghost_exchange_fields.
+ * The exchange is finished with \ref t8_forest_ghost_exchange_end.
+ * \param[in] forest       The forest. Must be committed.
+ * \param[in] num_fields   The number of fields. Must be positive.
+ * \param[in] fields       Array of \a num_fields field descriptors. The array is copied,
+ *                         but the data of the fields must stay valid until the exchange is finished.
+ * \return                 The handle of the exchange. NULL if \a forest has no ghost layer.
+ * \see t8_forest_ghost_exchange_begin
+ */
+t8_ghost_exchange_t
+t8_forest_ghost_exchange_fields_begin (t8_forest_t forest, int num_fields, const t8_ghost_exchange_field_t *fields);
+
+/** Start a ghost data exchange of user defined element data.
+ * The exchange is finished with \ref t8_forest_ghost_exchange_end.
+ * In between, computations that do not need the ghost entries of \a element_data
+ * can overlap with the communication.
+ * \param[in] forest       The forest. Must be committed.
+ * \param[in] element_data An array of length num_local_elements + num_ghosts
+ *                         storing one value for each local element and ghost in \a forest.
+ *                         The local entries are copied when this function is called.
+ *                         The ghost entries are updated in \ref t8_forest_ghost_exchange_end.
+ * \return                 The handle of the exchange. NULL if \a forest has no ghost layer.
+ * \note This function is collective and hence must be called by all processes in the forest's
+ *       MPI Communicator.
+ * \note Only one exchange per forest can be in progress at a time.
+ */
+t8_ghost_exchange_t
+t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t *element_data);
+
+/** Check whether a ghost data exchange has finished communicating.
+ * This function does not block. It can be called repeatedly to drive the
+ * communication progress.
+ * \param[in] exchange     The handle returned by \ref t8_forest_ghost_exchange_begin.
+ * \return                 True if all messages of the exchange were sent and received.
+ *                         In this case, \ref t8_forest_ghost_exchange_end will not block.
+ */
+int
+t8_forest_ghost_exchange_test (t8_ghost_exchange_t exchange);
+
+/** Finish a ghost data exchange. Wait until all messages were sent and received
+ * and write the received data to the ghost entries of the element data.
+ * \param[in,out] pexchange The handle returned by \ref t8_forest_ghost_exchange_begin.
+ *                         Set to NULL on output.
+ * \note If profiling is enabled, the time spent waiting in this function is reported by
+ *       \ref t8_forest_profile_get_ghostexchange_waittime and the time during which the
+ *       communication was hidden behind computation by
+ *       \ref t8_forest_profile_get_ghostexchange_overlaptime.
+ */
+void
+t8_forest_ghost_exchange_end (t8_ghost_exchange_t *pexchange);
+
 /** Print the ghost structure of a forest. Only used for debugging. */
 void
 t8_forest_ghost_print (t8_forest_t forest);
@@ -735,6 +886,7 @@ t8_forest_get_tree_element_offset (const t8_forest_t forest, const t8_locidx_t l
 /** Return the number of elements of a tree.
  * \param [in]      tree       A tree in a forest.
  * \return                     The number of elements of that tree.
+ * \note For a tree in compact storage this is the number of its keys. \see t8_forest_compact
  */
 t8_locidx_t
 t8_forest_get_tree_element_count (t8_tree_t tree);
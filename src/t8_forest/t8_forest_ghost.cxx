@@ -26,6 +26,7 @@
 #include <t8_forest/t8_forest_private.h>
 #include <t8_forest/t8_forest_iterate.h>
 #include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_face_connectivity.h>
 #include <t8_cmesh/t8_cmesh_trees.h>
 #include <t8_element.hxx>
 #include <t8_data/t8_containers.h>
@@ -151,21 +152,56 @@ t8_ghost_remote_equal_function (const void *remote_dataa, const void *remote_dat
   return remotea->remote_rank == remoteb->remote_rank;
 }
 
-/** This struct is used during a ghost data exchange.
- * Since we use asynchronuous communication, we store the
- * send buffers and mpi requests until we end the communication.
+/** The buffers and persistent MPI requests of a ghost exchange plan
+ * for one fixed number of bytes per element.
  */
 typedef struct
 {
+  /** The number of bytes per element */
+  size_t data_size;
+  /** The packed data of all elements that we send, ordered by remote rank */
+  char *send_buffer;
+  /** The received data of all ghost elements, ordered by remote rank */
+  char *recv_buffer;
+  /** The persistent receive requests of all remotes followed by their persistent send requests */
+  sc_MPI_Request *requests;
+} t8_ghost_exchange_channel_t;
+
+/** A ghost exchange plan is built once for a ghost layer at the first data exchange.
+ * It stores for each remote process the local indices of the elements to send and
+ * the offsets of its ghost elements. For each element data size that is exchanged
+ * it stores a channel with preallocated buffers and persistent MPI requests.
+ * Thus, each data exchange only needs to pack, start, wait and unpack.
+ */
+typedef struct t8_ghost_exchange_plan
+{
+  /** The communicator of the forest */
+  sc_MPI_Comm comm;
+  /** The number of processes, we send to and receive from */
   int num_remotes;
-  /** The number of processes, we send to */
-  char **send_buffers;
-  /** For each remote the send buffer */
-  sc_MPI_Request *send_requests;
-  /** For each process we send to, the MPI request used */
-  sc_MPI_Request *recv_requests;
-  /** For each process we receive from, the MPI request used */
-} t8_ghost_data_exchange_t;
+  /** The ranks of the remote processes, not owned by the plan */
+  const int *remote_ranks;
+  /** For each remote the position of its first element in send_indices, num_remotes + 1 entries */
+  t8_locidx_t *send_offsets;
+  /** The local indices of the elements that we send, ordered by remote */
+  t8_locidx_t *send_indices;
+  /** For each remote the index of its first ghost element, num_remotes + 1 entries */
+  t8_locidx_t *recv_offsets;
+  /** The channels of this plan, one for each element data size */
+  sc_array_t channels;
+  /** The channel used by the exchange that is currently in progress, NULL if none */
+  t8_ghost_exchange_channel_t *active_channel;
+  /** The t8_ghost_exchange_field_t descriptors of the exchange that is currently in progress */
+  sc_array_t active_fields;
+  /** The forest of the exchange that is currently in progress */
+  t8_forest_t active_forest;
+  /** True if the requests of the exchange in progress are known to be completed */
+  int active_completed;
+  /** The time at which the exchange in progress was started, if profiling is enabled */
+  double begin_time;
+  /** The time at which the exchange in progress was first known to be completed, if profiling is enabled */
+  double complete_time;
+} t8_ghost_exchange_plan_t;
 
 void
 t8_forest_ghost_init (t8_forest_ghost_t *pghost, t8_ghost_type_t ghost_type)
@@ -1391,9 +1427,13 @@ t8_forest_ghost_create_ext (t8_forest_t forest, int unbalanced_version)
   int create_element_array = 0;
 
   T8_ASSERT (t8_forest_is_committed (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_ghost_create");
 
   t8_global_productionf ("Into t8_forest_ghost with %i local elements.\n", t8_forest_get_local_num_elements (forest));
 
+  /* A face connectivity that was built with the previous ghost layer is no longer valid. */
+  t8_forest_invalidate_face_connectivity (forest);
+
   /* In parallel, check forest for deleted elements. The ghost algorithm currently
   * does not work on forests with deleted elements.
   * See also: https://github.com/DLR-AMR/t8code/issues/825
@@ -1582,123 +1622,64 @@ t8_forest_ghost_remote_first_elem (t8_forest_t forest, int remote)
   return proc_entry->ghost_offset;
 }
 
-/* Fill the send buffer for a ghost data exchange for on remote rank.
- * returns the number of bytes in the buffer. */
-static size_t
-t8_forest_ghost_exchange_fill_send_buffer (t8_forest_t forest, int remote, char **pbuffer, sc_array_t *element_data)
+/* Build the ghost exchange plan of a forest's ghost layer.
+ * We precompute for each remote the local indices of the elements that
+ * we send to it and the offsets of the ghost elements that we receive. */
+static t8_ghost_exchange_plan_t *
+t8_forest_ghost_exchange_plan_build (t8_forest_t forest)
 {
-  char *buffer;
+  t8_forest_ghost_t ghost = forest->ghosts;
   t8_ghost_remote_t lookup_rank, *remote_entry;
-  t8_ghost_remote_tree_t *remote_tree;
-  t8_forest_ghost_t ghost;
-  size_t index, element_index, data_size;
-  size_t elements_inserted, byte_count;
-  t8_tree_t local_tree;
+  t8_ghost_process_hash_t lookup_proc, **pfound;
+  size_t index;
+  t8_locidx_t num_send_elements = 0;
 #ifdef T8_ENABLE_DEBUG
   int ret;
 #endif
-  t8_locidx_t itree, ielement, element_pos;
-  t8_locidx_t ltreeid;
-  size_t elem_count;
-
-  ghost = forest->ghosts;
-  data_size = element_data->elem_size;
-  elements_inserted = 0;
-  lookup_rank.remote_rank = remote;
 
-  /* Lookup the remote entry of this remote process */
+  t8_ghost_exchange_plan_t *plan = T8_ALLOC_ZERO (t8_ghost_exchange_plan_t, 1);
+  plan->comm = forest->mpicomm;
+  plan->num_remotes = ghost->remote_processes->elem_count;
+  plan->remote_ranks = (const int *) ghost->remote_processes->array;
+  plan->send_offsets = T8_ALLOC (t8_locidx_t, plan->num_remotes + 1);
+  plan->recv_offsets = T8_ALLOC (t8_locidx_t, plan->num_remotes + 1);
+  plan->send_indices = T8_ALLOC (t8_locidx_t, ghost->num_remote_elements);
+  sc_array_init (&plan->channels, sizeof (t8_ghost_exchange_channel_t));
+  sc_array_init (&plan->active_fields, sizeof (t8_ghost_exchange_field_t));
+
+  for (int iremote = 0; iremote < plan->num_remotes; iremote++) {
+    const int remote_rank = plan->remote_ranks[iremote];
+    /* Lookup the remote entry of this remote process */
+    lookup_rank.remote_rank = remote_rank;
 #ifdef T8_ENABLE_DEBUG
-  ret =
+    ret =
 #else
-  (void)
-#endif
-    sc_hash_array_lookup (ghost->remote_ghosts, &lookup_rank, &index);
-  T8_ASSERT (ret != 0);
-  remote_entry = (t8_ghost_remote_t *) sc_array_index (&ghost->remote_ghosts->a, index);
-  T8_ASSERT (remote_entry->remote_rank == remote);
-
-  /* allocate memory for the send buffer */
-  byte_count = data_size * remote_entry->num_elements;
-  buffer = *pbuffer = T8_ALLOC (char, byte_count);
-
-  /* We now iterate over the remote trees and their elements to find the
-   * local element indices of the remote elements */
-  for (itree = 0; itree < (t8_locidx_t) remote_entry->remote_trees.elem_count; itree++) {
-    /* tree loop */
-    remote_tree = (t8_ghost_remote_tree_t *) t8_sc_array_index_locidx (&remote_entry->remote_trees, itree);
-    /* Get the local id of this tree */
-    /* TODO: Why does remote_tree store the global id? could be local instead */
-    ltreeid = t8_forest_get_local_id (forest, remote_tree->global_id);
-    /* Get a pointer to the forest tree */
-    local_tree = t8_forest_get_tree (forest, ltreeid);
-    elem_count = t8_element_array_get_count (&remote_tree->elements);
-    for (ielement = 0; ielement < (t8_locidx_t) elem_count; ielement++) {
-      /* element loop */
-      /* Get the index of this remote element in its local tree */
-      element_pos = *(t8_locidx_t *) t8_sc_array_index_locidx (&remote_tree->element_indices, ielement);
-      T8_ASSERT (0 <= element_pos);
-      /* Compute the index of this element in the element_data array */
-      element_index = local_tree->elements_offset + element_pos;
-      /* Copy the data of this element from the element_data array to the send buffer */
-      memcpy (buffer + elements_inserted * data_size, sc_array_index (element_data, element_index), data_size);
-      elements_inserted++;
-    }
-  }
-  return byte_count;
-}
-
-static t8_ghost_data_exchange_t *
-t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t *element_data)
-{
-  t8_ghost_data_exchange_t *data_exchange;
-  t8_forest_ghost_t ghost;
-  size_t bytes_to_send, ghost_start;
-  int iremote, remote_rank;
-  int mpiret, recv_rank, bytes_recv;
-#ifdef T8_ENABLE_DEBUG
-  int ret;
+    (void)
 #endif
-  char **send_buffers;
-  t8_ghost_process_hash_t lookup_proc, *process_entry, **pfound;
-  t8_locidx_t remote_offset, next_offset;
-
-  T8_ASSERT (t8_forest_is_committed (forest));
-  T8_ASSERT (element_data != NULL);
-  T8_ASSERT (forest->ghosts != NULL);
-
-  ghost = forest->ghosts;
+      sc_hash_array_lookup (ghost->remote_ghosts, &lookup_rank, &index);
+    T8_ASSERT (ret != 0);
+    remote_entry = (t8_ghost_remote_t *) sc_array_index (&ghost->remote_ghosts->a, index);
+    T8_ASSERT (remote_entry->remote_rank == remote_rank);
 
-  /* Allocate the new exchange context */
-  data_exchange = T8_ALLOC (t8_ghost_data_exchange_t, 1);
-  /* The number of processes we need to send to */
-  data_exchange->num_remotes = ghost->remote_processes->elem_count;
-  /* Allocate MPI requests */
-  data_exchange->send_requests = T8_ALLOC (sc_MPI_Request, data_exchange->num_remotes);
-  data_exchange->recv_requests = T8_ALLOC (sc_MPI_Request, data_exchange->num_remotes);
-  /* Allocate pointers to send buffers */
-  send_buffers = data_exchange->send_buffers = T8_ALLOC (char *, data_exchange->num_remotes);
-
-  for (iremote = 0; iremote < data_exchange->num_remotes; iremote++) {
-    /* Iterate over all remote processes and fill their send buffers */
-    remote_rank = *(int *) sc_array_index_int (ghost->remote_processes, iremote);
-    /* Fill the send buffers and compute the number of bytes to send */
-    bytes_to_send
-      = t8_forest_ghost_exchange_fill_send_buffer (forest, remote_rank, send_buffers + iremote, element_data);
-
-    /* Post the asynchronuos send */
-    mpiret = sc_MPI_Isend (send_buffers[iremote], bytes_to_send, sc_MPI_BYTE, remote_rank, T8_MPI_GHOST_EXC_FOREST,
-                           forest->mpicomm, data_exchange->send_requests + iremote);
-    SC_CHECK_MPI (mpiret);
-  }
+    /* Store the local element indices of the remote elements of this process */
+    plan->send_offsets[iremote] = num_send_elements;
+    for (size_t itree = 0; itree < remote_entry->remote_trees.elem_count; itree++) {
+      t8_ghost_remote_tree_t *remote_tree
+        = (t8_ghost_remote_tree_t *) sc_array_index (&remote_entry->remote_trees, itree);
+      const t8_locidx_t ltreeid = t8_forest_get_local_id (forest, remote_tree->global_id);
+      const t8_locidx_t tree_offset = t8_forest_get_tree_element_offset (forest, ltreeid);
+      const size_t elem_count = t8_element_array_get_count (&remote_tree->elements);
+      for (size_t ielement = 0; ielement < elem_count; ielement++) {
+        const t8_locidx_t element_pos = *(t8_locidx_t *) sc_array_index (&remote_tree->element_indices, ielement);
+        T8_ASSERT (0 <= element_pos);
+        T8_ASSERT (num_send_elements < ghost->num_remote_elements);
+        plan->send_indices[num_send_elements++] = tree_offset + element_pos;
+      }
+    }
+    T8_ASSERT (num_send_elements - plan->send_offsets[iremote] == remote_entry->num_elements);
 
-  /* The index in element_data at which the ghost elements start */
-  ghost_start = t8_forest_get_local_num_elements (forest);
-  /* Receive the incoming messages */
-  for (iremote = 0; iremote < data_exchange->num_remotes; iremote++) {
-    /* We need to compute the offset in element_data to which we can receive the message */
-    /* Search for this processes' entry in the ghost struct */
-    recv_rank = *(int *) sc_array_index_int (ghost->remote_processes, iremote);
-    lookup_proc.mpirank = recv_rank;
+    /* Store the offset of the ghost elements of this process */
+    lookup_proc.mpirank = remote_rank;
 #ifdef T8_ENABLE_DEBUG
     ret =
 #else
@@ -1706,88 +1687,259 @@ t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t *element_data)
 #endif
       sc_hash_lookup (ghost->process_offsets, &lookup_proc, (void ***) &pfound);
     T8_ASSERT (ret);
-    process_entry = *pfound;
-    /* In process_entry we stored the offset of this ranks ghosts under all
-     * ghosts. Thus in element_data we look at the position
-     *  ghost_start + offset
-     */
-    remote_offset = process_entry->ghost_offset;
-    /* Compute the offset of the next remote rank */
-    if (iremote + 1 < data_exchange->num_remotes) {
-      lookup_proc.mpirank = *(int *) sc_array_index_int (ghost->remote_processes, iremote + 1);
-#ifdef T8_ENABLE_DEBUG
-      ret =
+    plan->recv_offsets[iremote] = (*pfound)->ghost_offset;
+    T8_ASSERT (iremote == 0 || plan->recv_offsets[iremote - 1] <= plan->recv_offsets[iremote]);
+  }
+  plan->send_offsets[plan->num_remotes] = num_send_elements;
+  plan->recv_offsets[plan->num_remotes] = ghost->num_ghosts_elements;
+  return plan;
+}
+
+/* Return the channel of a ghost exchange plan for a given element data size.
+ * If it does not exist yet, we allocate its buffers and initialize its persistent requests. */
+static t8_ghost_exchange_channel_t *
+t8_forest_ghost_exchange_plan_get_channel (t8_ghost_exchange_plan_t *plan, const size_t data_size)
+{
+  t8_ghost_exchange_channel_t *channel;
+
+  for (size_t ichannel = 0; ichannel < plan->channels.elem_count; ichannel++) {
+    channel = (t8_ghost_exchange_channel_t *) sc_array_index (&plan->channels, ichannel);
+    if (channel->data_size == data_size) {
+      return channel;
+    }
+  }
+
+  /* Create a new channel */
+  channel = (t8_ghost_exchange_channel_t *) sc_array_push (&plan->channels);
+  channel->data_size = data_size;
+  channel->send_buffer = T8_ALLOC (char, plan->send_offsets[plan->num_remotes] * data_size);
+  channel->recv_buffer = T8_ALLOC (char, plan->recv_offsets[plan->num_remotes] * data_size);
+  channel->requests = T8_ALLOC (sc_MPI_Request, 2 * plan->num_remotes);
+#if T8_ENABLE_MPI
+  for (int iremote = 0; iremote < plan->num_remotes; iremote++) {
+    const int remote_rank = plan->remote_ranks[iremote];
+    const t8_locidx_t num_recv = plan->recv_offsets[iremote + 1] - plan->recv_offsets[iremote];
+    const t8_locidx_t num_send = plan->send_offsets[iremote + 1] - plan->send_offsets[iremote];
+    int mpiret
+      = MPI_Recv_init (channel->recv_buffer + plan->recv_offsets[iremote] * data_size, num_recv * data_size,
+                       sc_MPI_BYTE, remote_rank, T8_MPI_GHOST_EXC_FOREST, plan->comm, channel->requests + iremote);
+    SC_CHECK_MPI (mpiret);
+    mpiret = MPI_Send_init (channel->send_buffer + plan->send_offsets[iremote] * data_size, num_send * data_size,
+                            sc_MPI_BYTE, remote_rank, T8_MPI_GHOST_EXC_FOREST, plan->comm,
+                            channel->requests + plan->num_remotes + iremote);
+    SC_CHECK_MPI (mpiret);
+  }
 #else
-      (void)
+  /* Without MPI there cannot be any remote processes */
+  T8_ASSERT (plan->num_remotes == 0);
 #endif
-        sc_hash_lookup (ghost->process_offsets, &lookup_proc, (void ***) &pfound);
-      T8_ASSERT (ret);
-      process_entry = *pfound;
-      next_offset = process_entry->ghost_offset;
+  return channel;
+}
+
+/* Free all buffers and persistent requests of a ghost exchange plan. */
+static void
+t8_forest_ghost_exchange_plan_destroy (t8_ghost_exchange_plan_t **pplan)
+{
+  t8_ghost_exchange_plan_t *plan = *pplan;
+
+  T8_ASSERT (plan->active_channel == NULL);
+  for (size_t ichannel = 0; ichannel < plan->channels.elem_count; ichannel++) {
+    t8_ghost_exchange_channel_t *channel = (t8_ghost_exchange_channel_t *) sc_array_index (&plan->channels, ichannel);
+#if T8_ENABLE_MPI
+    for (int irequest = 0; irequest < 2 * plan->num_remotes; irequest++) {
+      const int mpiret = MPI_Request_free (channel->requests + irequest);
+      SC_CHECK_MPI (mpiret);
     }
-    else {
-      /* We are the last rank, the next offset is the total number of ghosts */
-      next_offset = ghost->num_ghosts_elements;
+#endif
+    T8_FREE (channel->requests);
+    T8_FREE (channel->send_buffer);
+    T8_FREE (channel->recv_buffer);
+  }
+  sc_array_reset (&plan->channels);
+  sc_array_reset (&plan->active_fields);
+  T8_FREE (plan->send_offsets);
+  T8_FREE (plan->send_indices);
+  T8_FREE (plan->recv_offsets);
+  T8_FREE (plan);
+  *pplan = NULL;
+}
+
+t8_ghost_exchange_t
+t8_forest_ghost_exchange_fields_begin (t8_forest_t forest, int num_fields, const t8_ghost_exchange_field_t *fields)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (num_fields > 0);
+  T8_ASSERT (fields != NULL);
+
+  if (forest->ghosts == NULL) {
+    /* This process has no ghosts */
+    return NULL;
+  }
+
+  t8_forest_ghost_t ghost = forest->ghosts;
+  if (ghost->exchange_plan == NULL) {
+    /* This is the first exchange on this ghost layer, we build the plan */
+    ghost->exchange_plan = t8_forest_ghost_exchange_plan_build (forest);
+  }
+  t8_ghost_exchange_plan_t *plan = ghost->exchange_plan;
+  T8_ASSERT (plan->comm == forest->mpicomm);
+  SC_CHECK_ABORT (plan->active_channel == NULL, "Another ghost exchange on this forest is still in progress.\n");
+
+  /* Store the fields and compute the number of bytes per element of all fields together */
+  size_t data_size = 0;
+  sc_array_resize (&plan->active_fields, num_fields);
+  for (int ifield = 0; ifield < num_fields; ifield++) {
+    T8_ASSERT (fields[ifield].data != NULL || fields[ifield].elem_size == 0);
+    T8_ASSERT (fields[ifield].stride >= fields[ifield].elem_size);
+    *(t8_ghost_exchange_field_t *) sc_array_index_int (&plan->active_fields, ifield) = fields[ifield];
+    data_size += fields[ifield].elem_size;
+  }
+  t8_ghost_exchange_channel_t *channel = t8_forest_ghost_exchange_plan_get_channel (plan, data_size);
+  plan->active_channel = channel;
+  plan->active_forest = forest;
+  plan->active_completed = plan->num_remotes == 0;
+
+  /* Pack the data of the remote elements. For each element we store the entries
+   * of all fields one after the other. */
+  const t8_locidx_t num_send_elements = plan->send_offsets[plan->num_remotes];
+  char *send_pos = channel->send_buffer;
+  for (t8_locidx_t ielement = 0; ielement < num_send_elements; ielement++) {
+    const size_t lelement_id = plan->send_indices[ielement];
+    for (int ifield = 0; ifield < num_fields; ifield++) {
+      memcpy (send_pos, (const char *) fields[ifield].data + lelement_id * fields[ifield].stride,
+              fields[ifield].elem_size);
+      send_pos += fields[ifield].elem_size;
     }
-    /* Calculate the number of bytes to receive */
-    bytes_recv = (next_offset - remote_offset) * element_data->elem_size;
-    /* receive the message */
-    mpiret = sc_MPI_Irecv (sc_array_index (element_data, ghost_start + remote_offset), bytes_recv, sc_MPI_BYTE,
-                           recv_rank, T8_MPI_GHOST_EXC_FOREST, forest->mpicomm, data_exchange->recv_requests + iremote);
+  }
+#if T8_ENABLE_MPI
+  /* Start the receives and then the sends */
+  if (plan->num_remotes > 0) {
+    const int mpiret = MPI_Startall (2 * plan->num_remotes, channel->requests);
     SC_CHECK_MPI (mpiret);
   }
-  return data_exchange;
+#endif
+  if (forest->profile != NULL) {
+    plan->begin_time = plan->complete_time = sc_MPI_Wtime ();
+  }
+  return plan;
 }
 
-static void
-t8_forest_ghost_exchange_end (t8_ghost_data_exchange_t *data_exchange)
+t8_ghost_exchange_t
+t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t *element_data)
 {
-  int iproc;
+  t8_ghost_exchange_field_t field;
 
-  T8_ASSERT (data_exchange != NULL);
-  /* Wait for all communications to end */
-  sc_MPI_Waitall (data_exchange->num_remotes, data_exchange->recv_requests, sc_MPI_STATUSES_IGNORE);
-  sc_MPI_Waitall (data_exchange->num_remotes, data_exchange->send_requests, sc_MPI_STATUSES_IGNORE);
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (element_data != NULL);
+  T8_ASSERT (forest->ghosts == NULL
+             || (t8_locidx_t) element_data->elem_count
+                  == t8_forest_get_local_num_elements (forest) + t8_forest_get_num_ghosts (forest));
+
+  field.data = element_data->array;
+  field.stride = element_data->elem_size;
+  field.elem_size = element_data->elem_size;
+  return t8_forest_ghost_exchange_fields_begin (forest, 1, &field);
+}
 
-  /* Free the send buffers */
-  for (iproc = 0; iproc < data_exchange->num_remotes; iproc++) {
-    T8_FREE (data_exchange->send_buffers[iproc]);
+int
+t8_forest_ghost_exchange_test (t8_ghost_exchange_t exchange)
+{
+  if (exchange == NULL) {
+    /* There is nothing to exchange */
+    return 1;
   }
-  T8_FREE (data_exchange->send_buffers);
-  /* free requests */
-  T8_FREE (data_exchange->send_requests);
-  T8_FREE (data_exchange->recv_requests);
-  T8_FREE (data_exchange);
+  T8_ASSERT (exchange->active_channel != NULL);
+#if T8_ENABLE_MPI
+  if (!exchange->active_completed) {
+    const int mpiret = MPI_Testall (2 * exchange->num_remotes, exchange->active_channel->requests,
+                                    &exchange->active_completed, sc_MPI_STATUSES_IGNORE);
+    SC_CHECK_MPI (mpiret);
+    if (exchange->active_completed && exchange->active_forest->profile != NULL) {
+      /* Record when we first noticed that the communication finished */
+      exchange->complete_time = sc_MPI_Wtime ();
+    }
+  }
+#endif
+  return exchange->active_completed;
 }
 
 void
-t8_forest_ghost_exchange_data (t8_forest_t forest, sc_array_t *element_data)
+t8_forest_ghost_exchange_end (t8_ghost_exchange_t *pexchange)
 {
-  t8_ghost_data_exchange_t *data_exchange;
+  T8_ASSERT (pexchange != NULL);
+  t8_ghost_exchange_plan_t *plan = *pexchange;
+  if (plan == NULL) {
+    /* There is nothing to exchange */
+    return;
+  }
+  T8_ASSERT (plan->active_channel != NULL);
+
+  t8_ghost_exchange_channel_t *channel = plan->active_channel;
+  t8_profile_t *profile = plan->active_forest->profile;
+  double end_time = 0;
+  if (profile != NULL) {
+    /* The time between begin and end was available for computations */
+    end_time = sc_MPI_Wtime ();
+  }
+  /* Wait for all communications to end */
+  if (!plan->active_completed) {
+    const int mpiret = sc_MPI_Waitall (2 * plan->num_remotes, channel->requests, sc_MPI_STATUSES_IGNORE);
+    SC_CHECK_MPI (mpiret);
+    if (profile != NULL) {
+      plan->complete_time = sc_MPI_Wtime ();
+    }
+  }
+  if (profile != NULL) {
+    /* Measure the time that we had to wait for the communication to finish */
+    profile->ghost_waittime = SC_MAX (plan->complete_time - end_time, 0);
+    /* The communication was hidden behind the computations until it finished
+     * or until the computations ended, whichever came first. */
+    profile->ghost_overlaptime = SC_MIN (plan->complete_time, end_time) - plan->begin_time;
+  }
+  /* Unpack the received data. The ghosts of all remotes are stored consecutively
+   * after the local elements. */
+  const t8_locidx_t num_ghosts = plan->recv_offsets[plan->num_remotes];
+  const size_t ghost_start = t8_forest_get_local_num_elements (plan->active_forest);
+  const int num_fields = plan->active_fields.elem_count;
+  const t8_ghost_exchange_field_t *fields = (const t8_ghost_exchange_field_t *) plan->active_fields.array;
+  if (num_fields == 1 && fields[0].stride == fields[0].elem_size) {
+    /* The ghost entries are contiguous, we copy them in one go */
+    memcpy ((char *) fields[0].data + ghost_start * fields[0].stride, channel->recv_buffer,
+            num_ghosts * channel->data_size);
+  }
+  else {
+    const char *recv_pos = channel->recv_buffer;
+    for (t8_locidx_t ighost = 0; ighost < num_ghosts; ighost++) {
+      for (int ifield = 0; ifield < num_fields; ifield++) {
+        memcpy ((char *) fields[ifield].data + (ghost_start + ighost) * fields[ifield].stride, recv_pos,
+                fields[ifield].elem_size);
+        recv_pos += fields[ifield].elem_size;
+      }
+    }
+  }
+  plan->active_channel = NULL;
+  plan->active_forest = NULL;
+  *pexchange = NULL;
+}
 
-  t8_debugf ("Entering ghost_exchange_data\n");
+void
+t8_forest_ghost_exchange_fields (t8_forest_t forest, int num_fields, const t8_ghost_exchange_field_t *fields)
+{
   T8_ASSERT (t8_forest_is_committed (forest));
 
-  if (forest->ghosts == NULL) {
-    /* This process has no ghosts */
-    return;
-  }
+  t8_ghost_exchange_t data_exchange = t8_forest_ghost_exchange_fields_begin (forest, num_fields, fields);
+  t8_forest_ghost_exchange_end (&data_exchange);
+}
 
-  T8_ASSERT (forest->ghosts != NULL);
+void
+t8_forest_ghost_exchange_data (t8_forest_t forest, sc_array_t *element_data)
+{
+  t8_debugf ("Entering ghost_exchange_data\n");
+  T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (element_data != NULL);
-  T8_ASSERT ((t8_locidx_t) element_data->elem_count
-             == t8_forest_get_local_num_elements (forest) + t8_forest_get_num_ghosts (forest));
 
-  data_exchange = t8_forest_ghost_exchange_begin (forest, element_data);
-  if (forest->profile != NULL) {
-    /* Measure the time for ghost_exchange_end */
-    forest->profile->ghost_waittime = -sc_MPI_Wtime ();
-  }
-  t8_forest_ghost_exchange_end (data_exchange);
-  if (forest->profile != NULL) {
-    /* Measure the time for ghost_exchange_end */
-    forest->profile->ghost_waittime += sc_MPI_Wtime ();
-  }
+  t8_ghost_exchange_t data_exchange = t8_forest_ghost_exchange_begin (forest, element_data);
+  t8_forest_ghost_exchange_end (&data_exchange);
   t8_debugf ("Finished ghost_exchange_data\n");
 }
 
@@ -1888,6 +2040,10 @@ t8_forest_ghost_reset (t8_forest_ghost_t *pghost)
     sc_array_reset (&remote_entry->remote_trees);
   }
   sc_hash_array_destroy (ghost->remote_ghosts);
+  /* Clean-up the ghost exchange plan */
+  if (ghost->exchange_plan != NULL) {
+    t8_forest_ghost_exchange_plan_destroy (&ghost->exchange_plan);
+  }
 
   /* Clean-up the memory pools for the data inside
    * the hash tables */
@@ -32,9 +32,34 @@
 #include <t8_vtk.h>
 T8_EXTERN_C_BEGIN ();
 
-/* TODO: implement */
-void
-t8_forest_save (t8_forest_t forest);
+/** Save a forest and optionally one data entry per element to a single binary file.
+ * The file is written collectively with MPI I/O. Each element is stored as its tree,
+ * linear id and level, such that the forest can be restored with \ref t8_forest_set_load
+ * on any number of processes.
+ * This function is collective and must be called on each process.
+ * \param [in]      forest        The committed forest to save.
+ * \param [in]      filename      The name of the file to write.
+ * \param [in]      element_data  If not NULL, an array with one entry per local element
+ *                                that is saved along with the forest.
+ * \return          True if successful, false if not (on all processes).
+ * \note The coarse mesh is not saved. It must be provided again when loading the forest.
+ */
+int
+t8_forest_save (t8_forest_t forest, const char *filename, const sc_array_t *element_data);
+
+/** Read the element data that was saved with \ref t8_forest_save.
+ * The forest must consist of the same elements as the saved forest, for example
+ * since it was loaded from the file, but may be partitioned differently.
+ * This function is collective and must be called on each process.
+ * \param [in]      forest        The committed forest.
+ * \param [in]      filename      The name of the file written by \ref t8_forest_save.
+ * \param [in,out]  element_data  An array with one entry per local element of \a forest and
+ *                                the same element size as the saved data. On output it
+ *                                holds the saved data of the local elements.
+ * \return          True if successful, false if not (on all processes).
+ */
+int
+t8_forest_load_data (t8_forest_t forest, const char *filename, sc_array_t *element_data);
 
 /** Write the forest in a parallel vtu format. Extended version.
  * See \ref t8_forest_write_vtk for the standard version of this function.
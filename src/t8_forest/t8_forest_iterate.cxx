@@ -22,55 +22,68 @@
 
 #include <t8_forest/t8_forest_iterate.h>
 #include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_private.h>
 #include <t8_forest/t8_forest_general.h>
 #include <t8_element.hxx>
+#include <t8_schemes/t8_default/t8_default_traits.hxx>
+
+/** Split the leaves of an element into the portions belonging to the children of the element.
+ * For each child C of \a element, the indices i, j are computed such that all leaves that
+ * are descendants of C are leaf_elements[i], ..., leaf_elements[j-1].
+ * \tparam Traits             The scheme traits, \see t8_scheme_traits.
+ * \param [in] traits         The scheme traits of the tree.
+ * \param [in] element        An element.
+ * \param [in] leaf_elements  Leaves that are proper descendants of \a element, in SFC order.
+ * \param [out] offsets       Array of length num_children + 1. On output the leaves of the
+ *                            i-th child are leaf_elements[offsets[i]], ..., leaf_elements[offsets[i+1]-1].
+ */
+template <class Traits>
+static void
+t8_forest_split_array_traits (const Traits &traits, const t8_element_t *element,
+                              const t8_element_array_t *leaf_elements, size_t *offsets)
+{
+  const int num_children = traits.t8_element_num_children (element);
+  const int child_level = traits.t8_element_level (element) + 1;
+  const size_t count = t8_element_array_get_count (leaf_elements);
+
+  offsets[0] = 0;
+  offsets[num_children] = count;
+  if (count == 0) {
+    for (int ichild = 1; ichild < num_children; ichild++) {
+      offsets[ichild] = 0;
+    }
+    return;
+  }
+  const char *leaves = (const char *) t8_element_array_get_data (leaf_elements);
+  const size_t element_size = t8_element_array_get_size (leaf_elements);
+  /* Since the leaves are sorted, their ancestor ids at the level of the children of element
+   * are non-decreasing. We find the first leaf of each child by bisection. */
+  for (int ichild = 1; ichild < num_children; ichild++) {
+    size_t low = offsets[ichild - 1];
+    size_t high = count;
+    while (low < high) {
+      const size_t mid = low + (high - low) / 2;
+      const t8_element_t *leaf = (const t8_element_t *) (leaves + mid * element_size);
+      T8_ASSERT (child_level <= traits.t8_element_level (leaf));
+      if (traits.t8_element_ancestor_id (leaf, child_level) < ichild) {
+        low = mid + 1;
+      }
+      else {
+        high = mid;
+      }
+    }
+    offsets[ichild] = low;
+  }
+}
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
 
-typedef struct
-{
-  const t8_eclass_scheme_c *ts;
-  int level;
-  int num_children;
-} t8_forest_child_type_query_t;
-
-/* This is the function that we call in sc_split_array to determine for an
- * element E that is a descendant of an element e, of which of e's children, E is a descendant. */
-static size_t
-t8_forest_determine_child_type (sc_array_t *leaf_elements, size_t index, void *data)
-{
-  t8_forest_child_type_query_t *query_data = (t8_forest_child_type_query_t *) data;
-  t8_element_t *element;
-
-  /* Get a pointer to the element */
-  element = (t8_element_t *) t8_sc_array_index_locidx (leaf_elements, index);
-  T8_ASSERT (query_data->level < query_data->ts->t8_element_level (element));
-  /* Compute the element's ancestor id at the stored level and return it as the element's type */
-  return query_data->ts->t8_element_ancestor_id (element, query_data->level + 1);
-}
-
 void
 t8_forest_split_array (const t8_element_t *element, t8_element_array_t *leaf_elements, size_t *offsets)
 {
-  sc_array_t offset_view;
-  t8_forest_child_type_query_t query_data;
-
   const t8_eclass_scheme_c *ts = t8_element_array_get_scheme (leaf_elements);
-  /* Store the number of children and the level of element */
-  query_data.num_children = ts->t8_element_num_children (element);
-  query_data.level = ts->t8_element_level (element);
-  query_data.ts = ts;
-
-  sc_array_t *element_array = t8_element_array_get_array_mutable (leaf_elements);
-  /* Split the elements array according to the elements' ancestor id at
-   * the given level. In other words for each child C of element, find
-   * the indices i, j such that all descendants of C are
-   * elements[i], ..., elements[j-1]
-   */
-  sc_array_init_data (&offset_view, offsets, sizeof (size_t), query_data.num_children + 1);
-  sc_array_split (element_array, &offset_view, query_data.num_children, t8_forest_determine_child_type,
-                  (void *) &query_data);
+  t8_forest_split_array_traits (t8_scheme_traits_virtual (ts), element, leaf_elements, offsets);
 }
 
 void
@@ -156,42 +169,114 @@ t8_forest_iterate_faces (t8_forest_t forest, t8_locidx_t ltreeid, const t8_eleme
   }
 }
 
-/* The recursion that is called from t8_forest_search_tree
- * Input is an element and an array of all leaf elements of this element.
- * The callback function is called on element and if it returns true,
- * the search continues with the children of the element.
+T8_EXTERN_C_END ();
+
+/* The search in t8_forest_search is a top-down traversal of each tree.
+ * Starting from the nearest common ancestor of the leaves of a tree, the callback
+ * function is called on an element and if it returns true, the search continues
+ * with the children of the element.
  * Additionally a query function and a set of queries can be given.
- * In this case the recursion stops when either the search_fn function
+ * In this case the traversal stops when either the search_fn function
  * returns false or the query_fn function returns false for all active queries.
- * (Thus, if there are no active queries left, the recursion also stops.)
+ * (Thus, if there are no active queries left, the traversal also stops.)
  * A query is active for an element if the query_fn callback returned true
  * for the parent element.
  * If the callback function (search_fn) returns false for an element,
  * the query function is not called for this element.
+ *
+ * Instead of recursing, we traverse each tree depth-first with an explicit stack
+ * that holds one frame per refinement level below the starting element.
+ * The scratch memory of the frames (children, split offsets, active queries)
+ * is allocated once per search and reused for all elements and trees, such that
+ * the traversal itself does not allocate memory.
+ * The traversal of a tree is a template over the scheme traits of the tree, such that
+ * the element functions of the default schemes can be inlined.
  */
+
+/** One level of the explicit traversal stack of t8_forest_search. */
+typedef struct
+{
+  const t8_element_t *element;               /**< The element that is searched on this level. */
+  t8_element_array_t leaf_elements;          /**< View of the leaves that are descendants of \a element. */
+  t8_locidx_t tree_lindex_of_first_leaf;     /**< Index of the first leaf of \a leaf_elements in the tree. */
+  int num_children;                          /**< The number of children of \a element. */
+  int next_child;                            /**< The next child of \a element that is searched. */
+  t8_element_t *children;                    /**< Storage for the children of \a element. */
+  t8_element_t **child_pointers;             /**< Pointers to the children in \a children. */
+  int children_capacity;                     /**< The number of elements that fit into \a children. */
+  const t8_eclass_scheme_c *children_scheme; /**< The scheme with which \a children was initialized. */
+  size_t *split_offsets;                     /**< Offsets of the leaves of the children in \a leaf_elements. */
+  sc_array_t active_queries;                 /**< The indices of the queries that are active for the children. */
+} t8_forest_search_frame_t;
+
+/** The scratch memory of t8_forest_search. */
+typedef struct
+{
+  t8_forest_search_frame_t *frames; /**< The stack, one frame per level below the root element. */
+  int num_frames;                   /**< The number of frames in \a frames. */
+  int *query_matches;               /**< Buffer for the results of the query function. */
+} t8_forest_search_workspace_t;
+
+/** Make sure that the children storage of a frame can hold a given number of
+ * elements of a given scheme. Only allocates if the storage is too small or
+ * was initialized for a different scheme. */
 static void
-t8_forest_search_recursion (t8_forest_t forest, const t8_locidx_t ltreeid, t8_element_t *element,
-                            const t8_eclass_scheme_c *ts, t8_element_array_t *leaf_elements,
-                            const t8_locidx_t tree_lindex_of_first_leaf, t8_forest_search_fn search_fn,
-                            t8_forest_query_fn query_fn, sc_array_t *queries, sc_array_t *active_queries)
+t8_forest_search_frame_reserve_children (t8_forest_search_frame_t *frame, const t8_eclass_scheme_c *ts,
+                                         const int num_children)
 {
-  /* Assertions to check for necessary requirements */
-  /* The forest must be committed */
-  T8_ASSERT (t8_forest_is_committed (forest));
-  /* The tree must be local */
-  T8_ASSERT (0 <= ltreeid && ltreeid < t8_forest_get_num_local_trees (forest));
-  /* If we have queries, we also must have a query function */
-  T8_ASSERT ((queries == NULL) == (query_fn == NULL));
+  if (frame->children_scheme == ts && num_children <= frame->children_capacity) {
+    return;
+  }
+  if (frame->children_scheme != NULL) {
+    frame->children_scheme->t8_element_deinit (frame->children_capacity, frame->children);
+  }
+  const size_t element_size = ts->t8_element_size ();
+  frame->children_capacity = SC_MAX (num_children, frame->children_capacity);
+  frame->children
+    = (t8_element_t *) T8_REALLOC ((char *) frame->children, char, frame->children_capacity * element_size);
+  ts->t8_element_init (frame->children_capacity, frame->children);
+  frame->children_scheme = ts;
+  frame->child_pointers = T8_REALLOC (frame->child_pointers, t8_element_t *, frame->children_capacity);
+  for (int ichild = 0; ichild < frame->children_capacity; ichild++) {
+    frame->child_pointers[ichild] = (t8_element_t *) ((char *) frame->children + ichild * element_size);
+  }
+  frame->split_offsets = T8_REALLOC (frame->split_offsets, size_t, frame->children_capacity + 1);
+}
+
+/** Process one element of the search.
+ * Calls the search and query functions for the element of \a frame and, if the
+ * search continues below the element, computes its children, the split offsets
+ * of its leaves and the queries that are active for its children.
+ * \param [in] forest          The forest.
+ * \param [in] ltreeid         The local tree of the element.
+ * \param [in] traits          The scheme traits of the tree.
+ * \param [in,out] frame       The frame of the element. On input the element, its leaves and
+ *                             the index of its first leaf must be set.
+ * \param [in] search_fn       The search function.
+ * \param [in] query_fn        The query function, NULL if and only if \a queries is NULL.
+ * \param [in] queries         The queries.
+ * \param [in] active_queries  The indices of the queries that are active for the element.
+ * \param [in,out] query_matches Buffer for at least as many ints as there are \a active_queries.
+ * \return                     True if and only if the search continues with the children of the element.
+ */
+template <class Traits>
+static int
+t8_forest_search_element (t8_forest_t forest, const t8_locidx_t ltreeid, const Traits &traits,
+                          t8_forest_search_frame_t *frame, t8_forest_search_fn search_fn, t8_forest_query_fn query_fn,
+                          sc_array_t *queries, sc_array_t *active_queries, int *query_matches)
+{
+  const t8_element_t *element = frame->element;
+  t8_element_array_t *leaf_elements = &frame->leaf_elements;
 
   const size_t elem_count = t8_element_array_get_count (leaf_elements);
   if (elem_count == 0) {
     /* There are no leaves left, so we have nothing to do */
-    return;
+    return 0;
   }
   const size_t num_active = queries == NULL ? 0 : active_queries->elem_count;
   if (queries != NULL && num_active == 0) {
-    /* There are no queries left. We stop the recursion */
-    return;
+    /* There are no queries left. We stop the search */
+    return 0;
   }
 
   int is_leaf = 0;
@@ -199,128 +284,147 @@ t8_forest_search_recursion (t8_forest_t forest, const t8_locidx_t ltreeid, t8_el
     /* There is only one leaf left, we check whether it is the same as element and if so call the callback function */
     const t8_element_t *leaf = t8_element_array_index_locidx (leaf_elements, 0);
 
-    SC_CHECK_ABORT (ts->t8_element_level (element) <= ts->t8_element_level (leaf),
+    SC_CHECK_ABORT (traits.t8_element_level (element) <= traits.t8_element_level (leaf),
                     "Search: element level greater than leaf level\n");
-    if (ts->t8_element_level (element) == ts->t8_element_level (leaf)) {
+    if (traits.t8_element_level (element) == traits.t8_element_level (leaf)) {
       T8_ASSERT (t8_forest_element_is_leaf (forest, leaf, ltreeid));
-      T8_ASSERT (ts->t8_element_equal (element, leaf));
+      T8_ASSERT (traits.t8_element_equal (element, leaf));
       /* The element is the leaf */
       is_leaf = 1;
     }
   }
   /* Call the callback function for the element */
-  const int ret = search_fn (forest, ltreeid, element, is_leaf, leaf_elements, tree_lindex_of_first_leaf);
+  const int ret = search_fn (forest, ltreeid, element, is_leaf, leaf_elements, frame->tree_lindex_of_first_leaf);
 
   if (!ret) {
-    /* The function returned false. We abort the recursion */
-    return;
+    /* The function returned false. We abort the search below this element */
+    return 0;
   }
 
   /* Check the queries.
    * If the current element is not a leaf, we store the queries that
    * return true in order to pass them on to the children of the element. */
-  sc_array_t *new_active_queries = NULL;
+  sc_array_truncate (&frame->active_queries);
   if (num_active > 0) {
-    if (!is_leaf) {
-      /* Initialize the new active query array */
-      new_active_queries = sc_array_new (sizeof (size_t));
-    }
-    int *active_queries_matches = T8_ALLOC (int, num_active);
     T8_ASSERT (query_fn != NULL);
-    query_fn (forest, ltreeid, element, is_leaf, leaf_elements, tree_lindex_of_first_leaf, queries, active_queries,
-              active_queries_matches, num_active);
+    query_fn (forest, ltreeid, element, is_leaf, leaf_elements, frame->tree_lindex_of_first_leaf, queries,
+              active_queries, query_matches, num_active);
 
-    for (size_t iactive = 0; iactive < num_active; iactive++) {
-      if (!is_leaf && active_queries_matches[iactive]) {
-        size_t query_index = *(size_t *) sc_array_index (active_queries, iactive);
-        *(size_t *) sc_array_push (new_active_queries) = query_index;
+    if (!is_leaf) {
+      for (size_t iactive = 0; iactive < num_active; iactive++) {
+        if (query_matches[iactive]) {
+          const size_t query_index = *(size_t *) sc_array_index (active_queries, iactive);
+          *(size_t *) sc_array_push (&frame->active_queries) = query_index;
+        }
       }
     }
-    T8_FREE (active_queries_matches);
   }
 
   if (is_leaf) {
-    /* The element was a leaf. We abort the recursion. */
-    return;
+    /* The element was a leaf. We abort the search below this element. */
+    return 0;
   }
 
-  if (num_active > 0 && new_active_queries->elem_count == 0) {
-    /* No queries returned true for this element. We abort the recursion */
-    sc_array_destroy (new_active_queries);
-    return;
+  if (num_active > 0 && frame->active_queries.elem_count == 0) {
+    /* No queries returned true for this element. We abort the search below this element */
+    return 0;
   }
 
-  /* Enter the recursion (the element is definitely not a leaf at this point) */
-  /* We compute all children of E, compute their leaf arrays and call search_recursion */
-  /* allocate the memory to store the children */
-  const int num_children = ts->t8_element_num_children (element);
-  t8_element_t **children = T8_ALLOC (t8_element_t *, num_children);
-  ts->t8_element_new (num_children, children);
-  /* Memory for the indices that split the leaf_elements array */
-  size_t *split_offsets = T8_ALLOC (size_t, num_children + 1);
-  /* Compute the children */
-  ts->t8_element_children (element, num_children, children);
-  /* Split the leaves array in portions belonging to the children of element */
-  t8_forest_split_array (element, leaf_elements, split_offsets);
-  for (int ichild = 0; ichild < num_children; ichild++) {
-    /* Check if there are any leaf elements for this child */
-    const size_t indexa = split_offsets[ichild];     /* first leaf of this child */
-    const size_t indexb = split_offsets[ichild + 1]; /* first leaf of next child */
-    if (indexa < indexb) {
-      t8_element_array_t child_leaves;
-      /* There exist leaves of this child in leaf_elements,
-       * we construct an array of these leaves */
-      t8_element_array_init_view (&child_leaves, leaf_elements, indexa, indexb - indexa);
-      /* Enter the recursion */
-      t8_forest_search_recursion (forest, ltreeid, children[ichild], ts, &child_leaves,
-                                  indexa + tree_lindex_of_first_leaf, search_fn, query_fn, queries, new_active_queries);
-    }
-  }
-  /* clean-up */
-  ts->t8_element_destroy (num_children, children);
-  T8_FREE (children);
-  T8_FREE (split_offsets);
-  if (num_active > 0) {
-    sc_array_destroy (new_active_queries);
-  }
+  /* The element is definitely not a leaf at this point.
+   * We compute all children of the element and split the leaf array into
+   * the portions belonging to the children. */
+  frame->num_children = traits.t8_element_num_children (element);
+  t8_forest_search_frame_reserve_children (frame, traits.ts, frame->num_children);
+  traits.t8_element_children (element, frame->num_children, frame->child_pointers);
+  t8_forest_split_array_traits (traits, element, leaf_elements, frame->split_offsets);
+  frame->next_child = 0;
+  return 1;
 }
 
 /* Perform a top-down search in one tree of the forest */
+template <class Traits>
 static void
-t8_forest_search_tree (t8_forest_t forest, t8_locidx_t ltreeid, t8_forest_search_fn search_fn,
-                       t8_forest_query_fn query_fn, sc_array_t *queries, sc_array_t *active_queries)
+t8_forest_search_tree (t8_forest_t forest, t8_locidx_t ltreeid, const Traits &traits, t8_forest_search_fn search_fn,
+                       t8_forest_query_fn query_fn, sc_array_t *queries, sc_array_t *active_queries,
+                       t8_forest_search_workspace_t *workspace)
 {
-
-  /* Get the element class, scheme and leaf elements of this tree */
-  const t8_eclass_t eclass = t8_forest_get_eclass (forest, ltreeid);
-  const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
+  /* Get the leaf elements of this tree */
   t8_element_array_t *leaf_elements = t8_forest_tree_get_leaves (forest, ltreeid);
+  const size_t num_leaves = t8_element_array_get_count (leaf_elements);
 
-  /* assert for empty tree */
-  T8_ASSERT (t8_element_array_get_count (leaf_elements) >= 0);
+  if (num_leaves == 0) {
+    /* There is nothing to search in an empty tree */
+    return;
+  }
   /* Get the first and last leaf of this tree */
   const t8_element_t *first_el = t8_element_array_index_locidx (leaf_elements, 0);
-  const t8_element_t *last_el
-    = t8_element_array_index_locidx (leaf_elements, t8_element_array_get_count (leaf_elements) - 1);
-  /* Compute their nearest common ancestor */
-  t8_element_t *nca;
-  ts->t8_element_new (1, &nca);
-  ts->t8_element_nca (first_el, last_el, nca);
+  const t8_element_t *last_el = t8_element_array_index_locidx (leaf_elements, num_leaves - 1);
+  /* Compute their nearest common ancestor. We store it as the only
+   * child of an extra frame on top of the stack. */
+  t8_forest_search_frame_t *root_frame = &workspace->frames[0];
+  t8_forest_search_frame_reserve_children (root_frame, traits.ts, 1);
+  traits.ts->t8_element_nca (first_el, last_el, root_frame->children);
 
   /* Start the top-down search */
-  t8_forest_search_recursion (forest, ltreeid, nca, ts, leaf_elements, 0, search_fn, query_fn, queries, active_queries);
-
-  ts->t8_element_destroy (1, &nca);
+  t8_forest_search_frame_t *frame = &workspace->frames[1];
+  frame->element = root_frame->children;
+  t8_element_array_init_view (&frame->leaf_elements, leaf_elements, 0, num_leaves);
+  frame->tree_lindex_of_first_leaf = 0;
+  if (!t8_forest_search_element (forest, ltreeid, traits, frame, search_fn, query_fn, queries, active_queries,
+                                 workspace->query_matches)) {
+    return;
+  }
+  int depth = 1;
+  while (depth > 0) {
+    frame = &workspace->frames[depth];
+    /* Find the next child that has leaves */
+    while (frame->next_child < frame->num_children
+           && frame->split_offsets[frame->next_child] == frame->split_offsets[frame->next_child + 1]) {
+      frame->next_child++;
+    }
+    if (frame->next_child == frame->num_children) {
+      /* All children were searched, we go back up */
+      depth--;
+      continue;
+    }
+    const int ichild = frame->next_child++;
+    const size_t indexa = frame->split_offsets[ichild];     /* first leaf of this child */
+    const size_t indexb = frame->split_offsets[ichild + 1]; /* first leaf of next child */
+    SC_CHECK_ABORT (depth + 1 < workspace->num_frames, "Search: element level greater than leaf level\n");
+    t8_forest_search_frame_t *child_frame = &workspace->frames[depth + 1];
+    child_frame->element = frame->child_pointers[ichild];
+    /* There exist leaves of this child in leaf_elements,
+     * we construct an array of these leaves */
+    t8_element_array_init_view (&child_frame->leaf_elements, &frame->leaf_elements, indexa, indexb - indexa);
+    child_frame->tree_lindex_of_first_leaf = frame->tree_lindex_of_first_leaf + indexa;
+    if (t8_forest_search_element (forest, ltreeid, traits, child_frame, search_fn, query_fn, queries,
+                                  &frame->active_queries, workspace->query_matches)) {
+      /* Continue with the children of the child */
+      depth++;
+    }
+  }
 }
 
+T8_EXTERN_C_BEGIN ();
+
 void
 t8_forest_search (t8_forest_t forest, t8_forest_search_fn search_fn, t8_forest_query_fn query_fn, sc_array_t *queries)
 {
+  t8_forest_search_workspace_t workspace;
+
+  /* Assertions to check for necessary requirements */
+  /* The forest must be committed */
+  T8_ASSERT (t8_forest_is_committed (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_search");
+  /* If we have queries, we also must have a query function */
+  T8_ASSERT ((queries == NULL) == (query_fn == NULL));
+
   /* If we have queries build a list of all active queries,
    * thus all queries in the array */
   sc_array_t *active_queries = NULL;
+  size_t num_queries = 0;
   if (queries != NULL) {
-    const size_t num_queries = queries->elem_count;
+    num_queries = queries->elem_count;
     /* build an array and write 0, 1, 2, 3,... into it */
     active_queries = sc_array_new_count (sizeof (size_t), num_queries);
     for (size_t iquery = 0; iquery < num_queries; ++iquery) {
@@ -328,11 +432,37 @@ t8_forest_search (t8_forest_t forest, t8_forest_search_fn search_fn, t8_forest_q
     }
   }
 
+  /* Allocate the scratch memory. We need one frame per level that an element can have,
+   * plus one to store the starting element of a tree. */
+  workspace.num_frames = t8_forest_get_maxlevel (forest) + 2;
+  workspace.frames = T8_ALLOC_ZERO (t8_forest_search_frame_t, workspace.num_frames);
+  for (int iframe = 0; iframe < workspace.num_frames; iframe++) {
+    sc_array_init (&workspace.frames[iframe].active_queries, sizeof (size_t));
+  }
+  workspace.query_matches = T8_ALLOC (int, SC_MAX (num_queries, 1));
+
   const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
   for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
-    t8_forest_search_tree (forest, itree, search_fn, query_fn, queries, active_queries);
+    const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_eclass (forest, itree));
+    /* We dispatch the scheme once per tree, such that the traversal is instantiated per element class. */
+    t8_scheme_traits_dispatch (ts, [&] (const auto &traits) {
+      t8_forest_search_tree (forest, itree, traits, search_fn, query_fn, queries, active_queries, &workspace);
+    });
   }
 
+  /* clean-up */
+  for (int iframe = 0; iframe < workspace.num_frames; iframe++) {
+    t8_forest_search_frame_t *frame = &workspace.frames[iframe];
+    if (frame->children_scheme != NULL) {
+      frame->children_scheme->t8_element_deinit (frame->children_capacity, frame->children);
+    }
+    T8_FREE (frame->children);
+    T8_FREE (frame->child_pointers);
+    T8_FREE (frame->split_offsets);
+    sc_array_reset (&frame->active_queries);
+  }
+  T8_FREE (workspace.frames);
+  T8_FREE (workspace.query_matches);
   if (active_queries != NULL) {
     sc_array_destroy (active_queries);
   }
@@ -344,6 +474,8 @@ t8_forest_iterate_replace (t8_forest_t forest_new, t8_forest_t forest_old, t8_fo
   t8_global_productionf ("Into t8_forest_iterate_replace\n");
   T8_ASSERT (t8_forest_is_committed (forest_old));
   T8_ASSERT (t8_forest_is_committed (forest_new));
+  t8_forest_compact_check_expanded (forest_old, "t8_forest_iterate_replace");
+  t8_forest_compact_check_expanded (forest_new, "t8_forest_iterate_replace");
 
   const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest_new);
   T8_ASSERT (num_local_trees == t8_forest_get_num_local_trees (forest_old));
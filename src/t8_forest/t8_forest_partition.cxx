@@ -26,6 +26,7 @@
 #include <t8_forest/t8_forest_general.h>
 #include <t8_cmesh/t8_cmesh_offset.h>
 #include <t8_element.hxx>
+#include <vector>
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
@@ -119,12 +120,10 @@ t8_forest_partition_create_offsets (t8_forest_t forest)
 static void
 t8_forest_partition_test_desc (t8_forest_t forest)
 {
-  t8_element_t *elem_desc;
   t8_linearidx_t first_desc_id;
   t8_locidx_t ielem;
   t8_eclass_scheme_c *ts;
   t8_tree_t tree;
-  int level;
 
   if (t8_forest_get_num_local_trees (forest) == 0) {
     /* This forest is empty, nothing to do */
@@ -135,18 +134,15 @@ t8_forest_partition_test_desc (t8_forest_t forest)
   ts = t8_forest_get_eclass_scheme (forest, tree->eclass);
   /* Get the first descendant id of this rank */
   first_desc_id = *(t8_linearidx_t *) t8_shmem_array_index (forest->global_first_desc, forest->mpirank);
-  ts->t8_element_new (1, &elem_desc);
-  for (ielem = 0; ielem < t8_forest_get_tree_element_count (tree); ielem++) {
-    /* Iterate over elems, for each one create the first descendant and check
-     * its linear id versus the linear id of first_desc. */
-    const t8_element_t *element = t8_element_array_index_locidx (&tree->elements, ielem);
-    ts->t8_element_first_descendant (element, elem_desc, forest->maxlevel);
-    level = ts->t8_element_level (elem_desc);
-    T8_ASSERT (level == ts->t8_element_level (elem_desc));
-    T8_ASSERT (level == forest->maxlevel);
-    T8_ASSERT (ts->t8_element_get_linear_id (elem_desc, level) >= first_desc_id);
-  }
-  ts->t8_element_destroy (1, &elem_desc);
+  /* The linear id of an element at the maximum level is the linear id of its first descendant,
+   * so we compute the ids of the first descendants of all elements at once. */
+  const t8_locidx_t num_elements = t8_forest_get_tree_element_count (tree);
+  std::vector<t8_linearidx_t> desc_ids (num_elements);
+  ts->t8_element_linear_ids_of_array (&tree->elements, 0, num_elements, forest->maxlevel, desc_ids.data ());
+  for (ielem = 0; ielem < num_elements; ielem++) {
+    /* Check the linear id of each first descendant versus the linear id of first_desc. */
+    T8_ASSERT (desc_ids[ielem] >= first_desc_id);
+  }
 }
 #endif
 
@@ -446,6 +442,147 @@ t8_forest_partition_compute_new_offset (t8_forest_t forest)
   t8_shmem_array_end_writing (forest->element_offsets);
 }
 
+/* Compute the exclusive prefix sum of the element weights of forest->set_from.
+ * On output, weights_prefix[i] is the sum of the weights of the local elements 0, ..., i - 1
+ * and weights_prefix[num_local_elements] the sum over all local elements.
+ * Either the weight function or the weight array of forest must be set. */
+static void
+t8_forest_partition_local_weights_prefix (t8_forest_t forest, double *weights_prefix)
+{
+  t8_forest_t forest_from = forest->set_from;
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest_from);
+  t8_locidx_t ielement = 0;
+  double weight;
+
+  T8_ASSERT (forest->set_partition_weight_fn != NULL || forest->set_partition_weights != NULL);
+
+  weights_prefix[0] = 0;
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_tree_t tree = t8_forest_get_tree (forest_from, itree);
+    const t8_locidx_t num_elements_in_tree = t8_forest_get_tree_element_count (tree);
+    for (t8_locidx_t ielem_in_tree = 0; ielem_in_tree < num_elements_in_tree; ielem_in_tree++, ielement++) {
+      if (forest->set_partition_weights != NULL) {
+        weight = forest->set_partition_weights[ielement];
+      }
+      else {
+        const t8_element_t *element = t8_element_array_index_locidx (&tree->elements, ielem_in_tree);
+        weight = forest->set_partition_weight_fn (forest_from, itree, element, ielement);
+      }
+      SC_CHECK_ABORTF (weight >= 0, "Partition weight of element %li is negative.", (long) ielement);
+      weights_prefix[ielement + 1] = weights_prefix[ielement] + weight;
+    }
+  }
+  T8_ASSERT (ielement == forest_from->local_num_elements);
+}
+
+/* Count the local elements whose exclusive global weight prefix is smaller than a given target.
+ * \param [in] weights_prefix   The local exclusive weight prefix of length num_elements + 1.
+ * \param [in] num_elements     The number of local elements.
+ * \param [in] weight_first     The sum of the weights on all smaller ranks.
+ * \param [in] target           The weight at which a new process begins.
+ */
+static t8_locidx_t
+t8_forest_partition_count_below_weight (const double *weights_prefix, const t8_locidx_t num_elements,
+                                        const double weight_first, const double target)
+{
+  t8_locidx_t low = 0;
+  t8_locidx_t high = num_elements;
+
+  /* Binary search for the first element whose prefix is >= target. */
+  while (low < high) {
+    const t8_locidx_t mid = low + (high - low) / 2;
+    if (weight_first + weights_prefix[mid] < target) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/* Calculate the new element_offset for forest from the elements in forest->set_from
+ * with element weights. Process p gets all elements whose exclusive global weight
+ * prefix lies in [p * W / P, (p + 1) * W / P), where W is the total weight.
+ * Each process counts how many of its elements lie below each process boundary
+ * and the counts are summed up. Returns false if the total weight is zero,
+ * in which case no offsets are computed. */
+static int
+t8_forest_partition_compute_new_offset_weighted (t8_forest_t forest)
+{
+  t8_forest_t forest_from = forest->set_from;
+  sc_MPI_Comm comm = forest->mpicomm;
+  const t8_locidx_t num_local_elements = forest_from->local_num_elements;
+  const int mpisize = forest->mpisize;
+  double local_weight, weight_first, global_weight;
+  int mpiret;
+
+  T8_ASSERT (t8_forest_is_committed (forest_from));
+  T8_ASSERT (forest->element_offsets == NULL);
+
+  double *weights_prefix = T8_ALLOC (double, num_local_elements + 1);
+  t8_forest_partition_local_weights_prefix (forest, weights_prefix);
+  local_weight = weights_prefix[num_local_elements];
+
+  /* The total weight of all elements. */
+  mpiret = sc_MPI_Allreduce (&local_weight, &global_weight, 1, sc_MPI_DOUBLE, sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+  if (global_weight <= 0) {
+    T8_FREE (weights_prefix);
+    return 0;
+  }
+  /* The weight on all processes before this one. MPI_Scan is inclusive,
+   * thus we subtract our own weight. */
+  mpiret = sc_MPI_Scan (&local_weight, &weight_first, 1, sc_MPI_DOUBLE, sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+  weight_first -= local_weight;
+
+  /* For each process boundary count the local elements before it.
+   * Since the counts are monotonous in the boundary, so is their sum. */
+  t8_gloidx_t *local_counts = T8_ALLOC_ZERO (t8_gloidx_t, mpisize + 1);
+  t8_gloidx_t *global_counts = T8_ALLOC_ZERO (t8_gloidx_t, mpisize + 1);
+  for (int iproc = 1; iproc < mpisize; iproc++) {
+    const double target = (double) iproc * (global_weight / mpisize);
+    if (num_local_elements == 0 || target <= weight_first) {
+      /* All of our elements belong to later processes. */
+      local_counts[iproc] = 0;
+    }
+    else if (weight_first + weights_prefix[num_local_elements - 1] < target) {
+      /* All of our elements belong to earlier processes. */
+      local_counts[iproc] = num_local_elements;
+    }
+    else {
+      local_counts[iproc]
+        = t8_forest_partition_count_below_weight (weights_prefix, num_local_elements, weight_first, target);
+    }
+  }
+  mpiret = sc_MPI_Allreduce (local_counts, global_counts, mpisize + 1, T8_MPI_GLOIDX, sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+
+  /* Set the shmem array type to comm */
+  t8_shmem_init (comm);
+  t8_shmem_set_type (comm, T8_SHMEM_BEST_TYPE);
+  /* Initialize the shmem array */
+  t8_shmem_array_init (&forest->element_offsets, sizeof (t8_gloidx_t), mpisize + 1, comm);
+  if (t8_shmem_array_start_writing (forest->element_offsets)) {
+    t8_gloidx_t *element_offsets = t8_shmem_array_get_gloidx_array_for_writing (forest->element_offsets);
+    element_offsets[0] = 0;
+    for (int iproc = 1; iproc < mpisize; iproc++) {
+      element_offsets[iproc] = global_counts[iproc];
+      T8_ASSERT (element_offsets[iproc - 1] <= element_offsets[iproc]);
+      T8_ASSERT (element_offsets[iproc] <= forest_from->global_num_elements);
+    }
+    /* Elements with zero weight at the end of the forest are assigned to the last process. */
+    element_offsets[mpisize] = forest_from->global_num_elements;
+  }
+  t8_shmem_array_end_writing (forest->element_offsets);
+
+  T8_FREE (local_counts);
+  T8_FREE (global_counts);
+  T8_FREE (weights_prefix);
+  return 1;
+}
+
 /* Find the owner of a given element.
  */
 static int
@@ -659,20 +796,34 @@ t8_forest_partition_fill_buffer (t8_forest_t forest_from, char **send_buffer, in
  * \param [out] buffer_alloc    The number of bytes in the send buffer
  * \param [in]  first_element_send The local id of the first element that we need to send.
  * \param [in]  last_element_send The local id of the last element that we need to send.
+ * \param [in]  data            The data to send.
+ * \param [in]  data_offsets    If NULL, \a data holds one entry per element.
+ *                              Otherwise, the data of element i are the bytes
+ *                              data_offsets[i] to data_offsets[i + 1] - 1 of \a data.
  */
 static void
 t8_forest_partition_fill_buffer_data (t8_forest_t forest_from, char **send_buffer, int *buffer_alloc,
                                       t8_locidx_t first_element_send, t8_locidx_t last_element_send,
-                                      const sc_array_t *data)
+                                      const sc_array_t *data, const size_t *data_offsets)
 {
-  void *data_entry;
+  size_t first_byte, num_bytes;
 
   /* Check dimensions of data. */
   T8_ASSERT (data != NULL);
-  T8_ASSERT (data->elem_count == (size_t) forest_from->local_num_elements);
+  T8_ASSERT (data_offsets != NULL || data->elem_count == (size_t) forest_from->local_num_elements);
 
-  /* Calculate the byte count */
-  *buffer_alloc = (last_element_send - first_element_send + 1) * data->elem_size;
+  /* Calculate the byte range */
+  if (data_offsets == NULL) {
+    first_byte = first_element_send * data->elem_size;
+    num_bytes = (last_element_send - first_element_send + 1) * data->elem_size;
+  }
+  else {
+    first_byte = data_offsets[first_element_send];
+    num_bytes = data_offsets[last_element_send + 1] - first_byte;
+  }
+  /* MPI counts are int */
+  T8_ASSERT (num_bytes <= (size_t) INT_MAX);
+  *buffer_alloc = (int) num_bytes;
 
   /* Allocate a multiple of the padding size capable of holding all bytes that will be sent. */
   const int internal_buffer_alloc = *buffer_alloc + T8_ADD_PADDING (*buffer_alloc);
@@ -688,18 +839,22 @@ t8_forest_partition_fill_buffer_data (t8_forest_t forest_from, char **send_buffe
   *send_buffer = T8_ALLOC (char, internal_buffer_alloc);
 
   /* Copy the data to the send_buffer. */
-  data_entry = t8_sc_array_index_locidx ((sc_array_t *) data, first_element_send);
-  memcpy (*send_buffer, data_entry, *buffer_alloc);
+  if (num_bytes > 0) {
+    memcpy (*send_buffer, data->array + first_byte, num_bytes);
+  }
 }
 
 /* Carry out all sending of elements */
 /* If send_data is true, the elements are not send but element data
  * stored in an sc_array of length forest->set_from->num_local_elements.
+ * If additionally data_offsets is not NULL, the data of each element has
+ * variable size and data_offsets holds the byte offset of each element's data
+ * in data_in (with num_local_elements + 1 entries).
  * Returns true if we sent to ourselves. */
 static int
 t8_forest_partition_sendloop (t8_forest_t forest, const int send_first, const int send_last, sc_MPI_Request **requests,
                               int *num_request_alloc, char ***send_buffer, const int send_data,
-                              const sc_array_t *data_in, size_t *byte_to_self)
+                              const sc_array_t *data_in, const size_t *data_offsets, size_t *byte_to_self)
 {
   int iproc, mpiret;
   t8_gloidx_t gfirst_element_send, glast_element_send;
@@ -722,7 +877,7 @@ t8_forest_partition_sendloop (t8_forest_t forest, const int send_first, const in
   T8_ASSERT (t8_forest_is_committed (forest_from));
   /* If send data is true, data_in must be non-zero and of length num_local_elements */
   T8_ASSERT (!send_data || data_in != NULL);
-  T8_ASSERT (!send_data || data_in->elem_count == (size_t) forest_from->local_num_elements);
+  T8_ASSERT (!send_data || data_offsets != NULL || data_in->elem_count == (size_t) forest_from->local_num_elements);
 
   comm = forest->mpicomm;
   /* Determine the number of requests for MPI communication. */
@@ -789,7 +944,7 @@ t8_forest_partition_sendloop (t8_forest_t forest, const int send_first, const in
         T8_ASSERT (send_data);
         /* We are in send data mode. Fill the send buffer with the data */
         t8_forest_partition_fill_buffer_data (forest_from, buffer, &buffer_alloc, first_element_send, last_element_send,
-                                              data_in);
+                                              data_in, data_offsets);
       }
       /* Post the MPI Send.
        * TODO: This will also send to ourselves if proc==mpirank */
@@ -830,8 +985,8 @@ t8_forest_partition_sendloop (t8_forest_t forest, const int send_first, const in
  * \param [in]  comm        The MPI communicator.
  * \param [in]  proc        The rank from which we receive.
  * \param [in]  status      MPI status with which we probed for the message.
- * \param [in,out] last_loc_elem_recv On input the local index of the last element
- *                          that was received by this rank. Updated on output.
+ * \param [in,out] recv_byte_cursor On input the number of bytes of \a data_out
+ *                          that were already received by this rank. Updated on output.
  * \param [out] data_out    The received data.
  * \param [in]  sent_to_self If proc equals the rank of this process, the message
  *                          should be passed as this parameter.
@@ -842,16 +997,13 @@ t8_forest_partition_sendloop (t8_forest_t forest, const int send_first, const in
  */
 static void
 t8_forest_partition_recv_message_data (t8_forest_t forest, sc_MPI_Comm comm, int proc, sc_MPI_Status *status,
-                                       t8_locidx_t *last_loc_elem_recvd, sc_array_t *data_out, char *sent_to_self,
+                                       size_t *recv_byte_cursor, sc_array_t *data_out, char *sent_to_self,
                                        size_t byte_to_self)
 {
   int mpiret, recv_bytes;
   char *recv_buffer;
-  size_t data_offset;
 
-  /* data_out must have the correct dimensions */
   T8_ASSERT (data_out != NULL);
-  T8_ASSERT (data_out->elem_count == (size_t) forest->local_num_elements);
 
   /* TODO: The next part is duplicated in t8_forest_partition_recv_message.
    *       Put duplicated code in function */
@@ -877,14 +1029,15 @@ t8_forest_partition_recv_message_data (t8_forest_t forest, sc_MPI_Comm comm, int
     recv_bytes = byte_to_self;
   }
 
-  /* Compute the place where to insert the data */
-  data_offset = data_out->elem_size * *last_loc_elem_recvd;
-  /* Copy the data */
-  memcpy (data_out->array + data_offset, recv_buffer, recv_bytes);
-
-  /* update the last element received */
+  /* data_out must be large enough to hold the message */
   T8_ASSERT (recv_bytes % data_out->elem_size == 0);
-  *last_loc_elem_recvd += recv_bytes / data_out->elem_size;
+  T8_ASSERT (*recv_byte_cursor + recv_bytes <= data_out->elem_count * data_out->elem_size);
+  /* Copy the data behind the data received so far */
+  if (recv_bytes > 0) {
+    memcpy (data_out->array + *recv_byte_cursor, recv_buffer, recv_bytes);
+  }
+  /* update the number of bytes received */
+  *recv_byte_cursor += recv_bytes;
 
   if (proc != forest->mpirank) {
     /* free the receive buffer */
@@ -969,6 +1122,7 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm, int proc
       /* We will insert a new tree in the forest */
       tree = (t8_tree_t) sc_array_push (forest->trees);
       tree->eclass = tree_info->eclass;
+      tree->num_compact_elements = 0;
       /* Calculate the element offset of the new tree */
       if (forest->last_local_tree >= forest->first_local_tree) {
         /* If there is a previous tree, we read it */
@@ -1039,13 +1193,16 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm, int proc
 /* Receive the elements from all processes, we receive from.
  * The message are received in order of the sending rank,
  * since then we can easily build up the new trees array.
+ * If recv_data is true, we receive element data into data_out instead.
+ * If additionally recv_variable is true, the data has variable size per element
+ * and data_out must hold exactly the total number of entries that we receive.
  */
 static void
 t8_forest_partition_recvloop (t8_forest_t forest, int recv_first, int recv_last, const int recv_data,
-                              sc_array_t *data_out, char *sent_to_self, size_t byte_to_self)
+                              const int recv_variable, sc_array_t *data_out, char *sent_to_self, size_t byte_to_self)
 {
   int iproc, prev_recvd;
-  t8_locidx_t last_received_local_element = 0;
+  size_t recv_byte_cursor = 0;
   t8_forest_t forest_from;
   int mpiret;
   sc_MPI_Comm comm;
@@ -1054,7 +1211,7 @@ t8_forest_partition_recvloop (t8_forest_t forest, int recv_first, int recv_last,
   /* Initial checks and inits */
   T8_ASSERT (recv_data || t8_forest_is_initialized (forest));
   T8_ASSERT (!recv_data || t8_forest_is_committed (forest));
-  T8_ASSERT (!recv_data || data_out->elem_count == (size_t) forest->local_num_elements);
+  T8_ASSERT (!recv_data || recv_variable || data_out->elem_count == (size_t) forest->local_num_elements);
   forest_from = forest->set_from;
   T8_ASSERT (t8_forest_is_committed (forest_from));
   const t8_gloidx_t *offset_from = t8_shmem_array_get_gloidx_array (forest_from->element_offsets);
@@ -1085,19 +1242,24 @@ t8_forest_partition_recvloop (t8_forest_t forest, int recv_first, int recv_last,
       }
       else {
         T8_ASSERT (data_out != NULL);
-        T8_ASSERT (data_out->elem_count == (size_t) forest->local_num_elements);
-        t8_forest_partition_recv_message_data (forest, comm, iproc, &status, &last_received_local_element, data_out,
-                                               sent_to_self, byte_to_self);
+        t8_forest_partition_recv_message_data (forest, comm, iproc, &status, &recv_byte_cursor, data_out, sent_to_self,
+                                               byte_to_self);
       }
       prev_recvd++;
     }
   }
+  /* In data mode we must have filled data_out completely */
+  T8_ASSERT (!recv_data || recv_byte_cursor == data_out->elem_count * data_out->elem_size);
 }
 
 /* Partition a forest from forest->set_from and the element offsets set in forest->element_offsets
+ * If send_data is true, we partition data_in into data_out instead of the elements.
+ * If additionally data_offsets is not NULL, the data has variable size per element,
+ * see t8_forest_partition_sendloop.
  */
 static void
-t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_array_t *data_in, sc_array_t *data_out)
+t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_array_t *data_in, sc_array_t *data_out,
+                           const size_t *data_offsets)
 {
   int send_first, send_last, recv_first, recv_last;
   sc_MPI_Request *requests = NULL;
@@ -1119,7 +1281,7 @@ t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_arr
 
   /* Send all elements to other ranks */
   to_self = t8_forest_partition_sendloop (forest, send_first, send_last, &requests, &num_request_alloc, &send_buffer,
-                                          send_data, data_in, &byte_to_self);
+                                          send_data, data_in, data_offsets, &byte_to_self);
   if (to_self) {
     /* We have sent data to ourselves. */
     sent_to_self = *(send_buffer + forest->mpirank - send_first);
@@ -1140,7 +1302,8 @@ t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_arr
   if (num_new_elements > 0) {
     /* Receive all element from other ranks */
     t8_forest_partition_recvrange (forest, &recv_first, &recv_last);
-    t8_forest_partition_recvloop (forest, recv_first, recv_last, send_data, data_out, sent_to_self, byte_to_self);
+    t8_forest_partition_recvloop (forest, recv_first, recv_last, send_data, data_offsets != NULL, data_out,
+                                  sent_to_self, byte_to_self);
   }
   else if (!send_data) {
     /* This forest is empty, set first and last local tree such
@@ -1164,7 +1327,7 @@ t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_arr
 }
 
 /* Populate a forest with the partitioned elements of forest->set_from.
- * Currently the elements are distributed evenly (each element has the same weight).
+ * If no element weights are set, the elements are distributed evenly (each element has the same weight).
  */
 void
 t8_forest_partition (t8_forest_t forest)
@@ -1197,8 +1360,16 @@ t8_forest_partition (t8_forest_t forest)
   /* TODO: if offsets already exist on forest_from, check it for consistency */
 
   /* We now calculate the new element offsets */
-  t8_forest_partition_compute_new_offset (forest);
-  t8_forest_partition_given (forest, 0, NULL, NULL);
+  if (forest->set_partition_weight_fn != NULL || forest->set_partition_weights != NULL) {
+    if (!t8_forest_partition_compute_new_offset_weighted (forest)) {
+      /* All weights are zero, we fall back to a partition without weights. */
+      t8_forest_partition_compute_new_offset (forest);
+    }
+  }
+  else {
+    t8_forest_partition_compute_new_offset (forest);
+  }
+  t8_forest_partition_given (forest, 0, NULL, NULL, NULL);
 
   T8_ASSERT ((size_t) t8_forest_get_num_local_trees (forest_from) == forest_from->trees->elem_count);
   T8_ASSERT ((size_t) t8_forest_get_num_local_trees (forest) == forest->trees->elem_count);
@@ -1257,11 +1428,75 @@ t8_forest_partition_data (t8_forest_t forest_from, t8_forest_t forest_to, const
   /* perform the actual partitioning */
   save_set_from = forest_to->set_from;
   forest_to->set_from = forest_from;
-  t8_forest_partition_given (forest_to, 1, data_in, data_out);
+  t8_forest_partition_given (forest_to, 1, data_in, data_out, NULL);
   forest_to->set_from = save_set_from;
 
   t8_log_indent_pop ();
   t8_global_productionf ("Done forest partition data.\n");
 }
 
+void
+t8_forest_partition_data_variable (t8_forest_t forest_from, t8_forest_t forest_to, const sc_array_t *sizes_in,
+                                   const sc_array_t *data_in, sc_array_t *sizes_out, sc_array_t *data_out)
+{
+  t8_forest_t save_set_from;
+  size_t *data_offsets;
+  size_t num_entries_out;
+  t8_locidx_t ielement;
+
+  t8_global_productionf ("Enter forest partition variable data.\n");
+  t8_log_indent_push ();
+
+  /* Assertions */
+  T8_ASSERT (t8_forest_is_committed (forest_from));
+  T8_ASSERT (t8_forest_is_committed (forest_to));
+  T8_ASSERT (sizes_in != NULL && sizes_out != NULL);
+  T8_ASSERT (data_in != NULL && data_out != NULL);
+  T8_ASSERT (sizes_in->elem_size == sizeof (size_t) && sizes_out->elem_size == sizeof (size_t));
+  T8_ASSERT (data_in->elem_size == data_out->elem_size);
+  T8_ASSERT (sizes_in->elem_count == (size_t) forest_from->local_num_elements);
+  T8_ASSERT (sizes_out->elem_count == (size_t) forest_to->local_num_elements);
+
+  /* Create partition tables if not existent yet */
+  if (forest_from->element_offsets == NULL) {
+    t8_forest_partition_create_offsets (forest_from);
+  }
+  if (forest_to->element_offsets == NULL) {
+    t8_forest_partition_create_offsets (forest_to);
+  }
+
+  save_set_from = forest_to->set_from;
+  forest_to->set_from = forest_from;
+
+  /* At first, we partition the sizes. These have a fixed size per element. */
+  t8_forest_partition_given (forest_to, 1, sizes_in, sizes_out, NULL);
+
+  /* Compute the byte offset of each element's data in data_in. Since the
+   * elements that we send to one process are contiguous, the message to it
+   * is the byte range between the offsets of its first and last element. */
+  data_offsets = T8_ALLOC (size_t, forest_from->local_num_elements + 1);
+  data_offsets[0] = 0;
+  for (ielement = 0; ielement < forest_from->local_num_elements; ielement++) {
+    const size_t num_entries = *(size_t *) t8_sc_array_index_locidx ((sc_array_t *) sizes_in, ielement);
+    data_offsets[ielement + 1] = data_offsets[ielement] + num_entries * data_in->elem_size;
+  }
+  T8_ASSERT (data_offsets[forest_from->local_num_elements] == data_in->elem_count * data_in->elem_size);
+
+  /* The new sizes tell us how many entries we receive in total */
+  num_entries_out = 0;
+  for (ielement = 0; ielement < forest_to->local_num_elements; ielement++) {
+    num_entries_out += *(size_t *) t8_sc_array_index_locidx (sizes_out, ielement);
+  }
+  sc_array_resize (data_out, num_entries_out);
+
+  /* Partition the packed data, only the actual payload is communicated. */
+  t8_forest_partition_given (forest_to, 1, data_in, data_out, data_offsets);
+  forest_to->set_from = save_set_from;
+
+  T8_FREE (data_offsets);
+
+  t8_log_indent_pop ();
+  t8_global_productionf ("Done forest partition variable data.\n");
+}
+
 T8_EXTERN_C_END ();
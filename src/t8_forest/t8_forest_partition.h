@@ -85,6 +85,27 @@ void
 t8_forest_partition_data (t8_forest_t forest_from, t8_forest_t forest_to, const sc_array_t *data_in,
                           sc_array_t *data_out);
 
+/** \brief Re-Partition data with a variable number of entries per element accordingly to a partitioned forest.
+ *
+ * The data of all local elements is stored packed in \a data_in, element after element.
+ * Only the actual entries are communicated, without padding to a maximum size.
+ *
+ * \param[in] forest_from The forest before the partitioning step.
+ * \param[in] forest_to The partitioned forest of \a forest_from.
+ * \param[in] sizes_in An sc_array_t of size_t holding the number of entries of \a data_in for each
+ *                     local element of \a forest_from.
+ * \param[in] data_in The packed data of all local elements of \a forest_from.
+ * \param[in,out] sizes_out An already allocated sc_array_t of size_t with one value per local element of
+ *                     \a forest_to. On output the number of entries of \a data_out for each element.
+ * \param[in,out] data_out An sc_array_t with the same element size as \a data_in. On output it is resized
+ *                     to and filled with the packed data of all local elements of \a forest_to.
+ *
+ * \note \a data_in must hold exactly the sum of \a sizes_in entries.
+ */
+void
+t8_forest_partition_data_variable (t8_forest_t forest_from, t8_forest_t forest_to, const sc_array_t *sizes_in,
+                                   const sc_array_t *data_in, sc_array_t *sizes_out, sc_array_t *data_out);
+
 /** Test if the last descendant of the last element of current rank has
  * a smaller linear id than the stored first descendant of rank+1.
  * If this is not the case, elements overlap.
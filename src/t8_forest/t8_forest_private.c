@@ -43,6 +43,7 @@ t8_forest_get_tree_element_array (const t8_forest_t forest, t8_locidx_t ltreeid)
 {
   T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (0 <= ltreeid && ltreeid < t8_forest_get_num_local_trees (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_get_tree_element_array");
 
   return &t8_forest_get_tree (forest, ltreeid)->elements;
 }
@@ -68,6 +68,11 @@ t8_forest_compute_desc (t8_forest_t forest);
 void
 t8_forest_populate (t8_forest_t forest);
 
+/* Create the elements on this process by reading them from the
+ * file set with t8_forest_set_load. */
+void
+t8_forest_load_populate (t8_forest_t forest);
+
 /** Return the eclass scheme of a given element class associated to a forest.
  * This function does not check whether the given forest is committed, use with
  * caution and only if you are sure that the eclass_scheme was set.
@@ -403,7 +408,6 @@ t8_forest_element_half_face_neighbors (t8_forest_t forest, t8_locidx_t ltreeid,
  * leaves with \ref t8_forest_leaf_face_neighbors and print their local element ids.
  * This function is meant for debugging only.
  * \param [in]    forest The forest.
- * \note Currently \a forest must be balanced.
  * \note \a forest must be committed before calling this function.
  */
 void
@@ -424,6 +428,131 @@ int
 t8_forest_element_has_leaf_desc (t8_forest_t forest, t8_gloidx_t gtreeid, const t8_element_t *element,
                                  t8_eclass_scheme_c *ts);
 
+/** Return the eclass of the face neighbor of an element in a local tree of the cmesh.
+ * This is \ref t8_forest_element_neighbor_eclass for trees that are local in the cmesh
+ * of \a forest, but not necessarily local in \a forest.
+ * \param [in] forest    A committed forest.
+ * \param [in] lctreeid  The local id of a tree in the cmesh of \a forest.
+ * \param [in] elem      An element in the tree \a lctreeid.
+ * \param [in] face      A face number of \a elem.
+ * \return               The eclass of the tree in which the face neighbor of \a elem across \a face lies.
+ */
+t8_eclass_t
+t8_forest_element_neighbor_eclass_cmesh (t8_forest_t forest, t8_locidx_t lctreeid, const t8_element_t *elem, int face);
+
+/** Construct the face neighbor of an element in a local tree of the cmesh, possibly across tree boundaries.
+ * This is \ref t8_forest_element_face_neighbor for trees that are local in the cmesh
+ * of \a forest, but not necessarily local in \a forest.
+ * \param [in] forest    A committed forest.
+ * \param [in] lctreeid  The local id of a tree in the cmesh of \a forest.
+ * \param [in] elem      An element in the tree \a lctreeid.
+ * \param [in,out] neigh On input an allocated element of the scheme of the face neighbor's eclass.
+ *                       On output the face neighbor of \a elem across \a face.
+ * \param [in] neigh_scheme The eclass scheme of \a neigh.
+ * \param [in] face      The face of \a elem along which the neighbor is constructed.
+ * \param [out] neigh_face The number of the face viewed from perspective of \a neigh.
+ * \return               The global id of the tree in which \a neigh lies, -1 if there is no neighbor.
+ */
+t8_gloidx_t
+t8_forest_element_face_neighbor_cmesh (t8_forest_t forest, t8_locidx_t lctreeid, const t8_element_t *elem,
+                                       t8_element_t *neigh, t8_eclass_scheme_c *neigh_scheme, int face,
+                                       int *neigh_face);
+
+/** Search for a linear element id (at forest->maxlevel) in a sorted array of
+ * elements. If the element does not exist, return the largest index i
+ * such that the element at position i has a smaller id than the given one.
+ * \param [in] elements    A sorted array of elements.
+ * \param [in] element_id  A linear id at level \a maxlevel.
+ * \param [in] maxlevel    The maximum level of the forest.
+ * \return                 The index found, or -1 if no element has an id smaller than or equal to \a element_id.
+ */
+t8_locidx_t
+t8_forest_bin_search_lower (const t8_element_array_t *elements, const t8_linearidx_t element_id, const int maxlevel);
+
+/** The leaves of a tree in which face neighbors are searched. These are its local leaves if the tree is
+ * local and its ghost leaves if it is a ghost tree. */
+typedef struct
+{
+  const t8_eclass_scheme_c *scheme;         /**< The scheme of the tree. */
+  const t8_element_array_t *local_elements; /**< The local leaves of the tree, NULL if it is not local. */
+  const t8_element_array_t *ghost_elements; /**< The ghost leaves of the tree, NULL if it is no ghost tree. */
+  t8_locidx_t local_offset;                 /**< The local index of the first local leaf. */
+  t8_locidx_t ghost_offset;                 /**< The index of the first ghost leaf, counted after all local leaves. */
+  int maxlevel;                             /**< The maximum level of the forest. */
+} t8_forest_leaf_search_tree_t;
+
+/** Callback of \ref t8_forest_leaf_search_face_descendants for each leaf found.
+ * \param [in] leaf       The leaf.
+ * \param [in] index      The index of \a leaf, local leaves first, then ghosts.
+ * \param [in] face       The face of \a leaf that lies on the face of the searched element.
+ * \param [in] user_data  The user data passed to \ref t8_forest_leaf_search_face_descendants.
+ */
+typedef void (*t8_forest_leaf_found_fn) (const t8_element_t *leaf, t8_locidx_t index, int face, void *user_data);
+
+/** Prepare the search for leaves in a tree of a forest.
+ * \param [in]  forest       A committed forest.
+ * \param [in]  gtreeid      The global id of a tree of \a forest. If it is neither local nor a ghost tree,
+ *                           no leaves are found in it.
+ * \param [in]  scheme       The eclass scheme of the tree.
+ * \param [out] search_tree  The leaves of the tree.
+ */
+void
+t8_forest_leaf_search_tree_init (const t8_forest_t forest, const t8_gloidx_t gtreeid,
+                                 const t8_eclass_scheme_c *scheme, t8_forest_leaf_search_tree_t *search_tree);
+
+/** Find the leaf of a tree that is equal to or an ancestor of an element.
+ * \param [in]  search_tree  The leaves of the tree.
+ * \param [in]  element      An element of the tree.
+ * \param [in,out] last_desc An allocated scratch element.
+ * \param [out] leaf         The leaf found, unchanged if there is none.
+ * \return                   The index of the leaf, local leaves first, then ghosts. -1 if there is none.
+ */
+t8_locidx_t
+t8_forest_leaf_search_ancestor (const t8_forest_leaf_search_tree_t *search_tree, const t8_element_t *element,
+                                t8_element_t *last_desc, const t8_element_t **leaf);
+
+/** Find all leaves of a tree that are descendants of an element (or the element itself) and touch one
+ * of its faces. In each step, we look up the descendant range of the element with a binary search
+ * and only descend into its children at the face if the element is not a leaf itself.
+ * This finds the face neighbors of a leaf in a forest that does not need to be balanced.
+ * \param [in]  search_tree  The leaves of the tree.
+ * \param [in]  element      An element of the tree that does not have a leaf ancestor.
+ * \param [in]  face         A face of \a element.
+ * \param [in,out] scratch   An array of element pointers used as stack of scratch elements. It is enlarged
+ *                           with new elements of the scheme of the tree as needed. The caller destroys them.
+ * \param [in]  scratch_top  The first position of \a scratch that may be used, 0 for the initial call.
+ * \param [in]  found_fn     Called in linear order for each leaf found.
+ * \param [in]  user_data    Passed to \a found_fn.
+ */
+void
+t8_forest_leaf_search_face_descendants (const t8_forest_leaf_search_tree_t *search_tree, const t8_element_t *element,
+                                        const int face, sc_array_t *scratch, const size_t scratch_top,
+                                        t8_forest_leaf_found_fn found_fn, void *user_data);
+
+/** Return the number of leaf elements of a local tree of a compact forest.
+ * \param [in]  forest   A committed forest.
+ * \param [in]  ltreeid  The local id of a local tree.
+ * \return      The number of elements of the tree, whether it is stored in compact form or not.
+ * \see t8_forest_compact
+ */
+t8_locidx_t
+t8_forest_compact_get_tree_num_elements (const t8_forest_t forest, const t8_locidx_t ltreeid);
+
+/** Abort if a forest is compact. The element arrays of compact trees are empty, thus every function that
+ * accesses them directly calls this, in debugging and in release mode.
+ * \param [in]  forest    A committed forest.
+ * \param [in]  function  The name of the calling function, used in the error message.
+ * \see t8_forest_compact
+ */
+void
+t8_forest_compact_check_expanded (const t8_forest_t forest, const char *function);
+
+/** Free the compact element storage of a forest without restoring the elements.
+ * \param [in,out] forest  A forest that is destroyed. If it is not compact, nothing happens.
+ */
+void
+t8_forest_compact_reset (t8_forest_t forest);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_FOREST_PRIVATE_H */
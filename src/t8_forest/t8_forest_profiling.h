@@ -60,6 +60,8 @@ const sc_statinfo_t *
 t8_forest_profile_get_balance_stats (t8_forest_t forest);
 const sc_statinfo_t *
 t8_forest_profile_get_balance_rounds_stats (t8_forest_t forest);
+const sc_statinfo_t *
+t8_forest_profile_get_balance_rounds_saved_stats (t8_forest_t forest);
 
 /** Print the collected statistics from a forest profile.
  * \param [in]    forest        The forest.
@@ -121,7 +123,8 @@ t8_forest_profile_get_balance_time (t8_forest_t forest, int *balance_rounds);
 double
 t8_forest_profile_get_ghost_time (t8_forest_t forest, t8_locidx_t *ghosts_sent);
 
-/** Get the waittime of the last call to \ref t8_forest_ghost_exchange_data.
+/** Get the waittime of the last call to \ref t8_forest_ghost_exchange_data
+ * or \ref t8_forest_ghost_exchange_end.
  * \param [in]   forest         The forest.
  * \return                      The time of ghost_exchange_data that was spent waiting
  *                              for other MPI processes, if profiling was activated.
@@ -132,6 +135,22 @@ t8_forest_profile_get_ghost_time (t8_forest_t forest, t8_locidx_t *ghosts_sent);
  */
 double
 t8_forest_profile_get_ghostexchange_waittime (t8_forest_t forest);
+
+/** Get the time of the last ghost data exchange during which the communication was hidden behind
+ * computation. This is the minimum of the time between \ref t8_forest_ghost_exchange_begin and
+ * \ref t8_forest_ghost_exchange_end and the time until the communication was completed.
+ * The completion is detected by \ref t8_forest_ghost_exchange_test or, at the latest, by
+ * \ref t8_forest_ghost_exchange_end. Thus, if the communication finished during the computation,
+ * calling \ref t8_forest_ghost_exchange_test in between gives a more accurate value.
+ * \param [in]   forest         The forest.
+ * \return                      The overlap time of the last ghost data exchange,
+ *                              if profiling was activated. 0 otherwise.
+ * \a forest must be committed before calling this function.
+ * \see t8_forest_set_profiling
+ * \see t8_forest_ghost_exchange_begin
+ */
+double
+t8_forest_profile_get_ghostexchange_overlaptime (t8_forest_t forest);
 T8_EXTERN_C_END ();
 
 #endif /* !T8_FOREST_PROFILING_H */
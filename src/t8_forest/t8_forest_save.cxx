@@ -0,0 +1,418 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_save.cxx
+ * Checkpointing of forests in a single binary file written with MPI I/O.
+ * The file consists of the following sections:
+ *
+ * | header | element offsets of the saving processes | tree runs | elements | element data |
+ *
+ * A tree run stores which contiguous range of global elements belongs to a tree.
+ * Each element is stored as its linear id and level. All processes write their
+ * part of each section at an offset computed from their global element index,
+ * such that the file does not depend on the partition and can be read by
+ * any number of processes.
+ */
+
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_io.h>
+#include <t8_forest/t8_forest_private.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_cmesh.h>
+#include <t8_element.hxx>
+#include <t8_data/t8_mpi_file.h>
+
+T8_EXTERN_C_BEGIN ();
+
+/* The version of the forest file format. Increase when the format changes. */
+#define T8_FOREST_SAVE_VERSION 1
+
+/* The header of a forest file. */
+typedef struct
+{
+  char magic[8];               /* Always "T8FOREST" */
+  int32_t version;             /* T8_FOREST_SAVE_VERSION */
+  int32_t mpisize;             /* The number of processes that saved the forest */
+  int32_t dimension;           /* The dimension of the forest */
+  int32_t incomplete_trees;    /* Whether the forest has incomplete trees */
+  int64_t global_num_trees;    /* The number of trees of the coarse mesh */
+  int64_t global_num_elements; /* The number of elements of the forest */
+  int64_t global_num_runs;     /* The number of tree runs */
+  int64_t data_size;           /* Bytes of user data per element, 0 if no data was saved */
+} t8_forest_save_header_t;
+
+/* A contiguous range of elements of one tree. Trees that are shared between
+ * processes are stored as one run per process. Empty local trees are stored
+ * as runs with zero elements. */
+typedef struct
+{
+  int64_t gtree_id;      /* The global id of the tree */
+  int64_t first_element; /* The global index of the first element in the run */
+  int64_t num_elements;  /* The number of elements in the run */
+  int32_t eclass;        /* The element class of the tree */
+  int32_t padding;
+} t8_forest_save_run_t;
+
+/* An element, stored as its linear id on its level. */
+typedef struct
+{
+  uint64_t linear_id;
+  int32_t level;
+  int32_t padding;
+} t8_forest_save_element_t;
+
+/* Byte offsets of the sections of a forest file */
+static size_t
+t8_forest_save_offsets_pos ()
+{
+  return sizeof (t8_forest_save_header_t);
+}
+
+static size_t
+t8_forest_save_runs_pos (const t8_forest_save_header_t *header)
+{
+  return t8_forest_save_offsets_pos () + (header->mpisize + 1) * sizeof (int64_t);
+}
+
+static size_t
+t8_forest_save_elements_pos (const t8_forest_save_header_t *header)
+{
+  return t8_forest_save_runs_pos (header) + header->global_num_runs * sizeof (t8_forest_save_run_t);
+}
+
+static size_t
+t8_forest_save_data_pos (const t8_forest_save_header_t *header)
+{
+  return t8_forest_save_elements_pos (header) + header->global_num_elements * sizeof (t8_forest_save_element_t);
+}
+
+int
+t8_forest_save (t8_forest_t forest, const char *filename, const sc_array_t *element_data)
+{
+  t8_forest_save_header_t header;
+  t8_mpi_file_t file;
+  t8_forest_save_run_t *runs;
+  t8_forest_save_element_t *elements;
+  t8_gloidx_t *run_counts;
+  t8_gloidx_t num_runs, first_run;
+  int success, global_success, mpiret, iproc;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_save");
+  T8_ASSERT (element_data == NULL || element_data->elem_count == (size_t) forest->local_num_elements);
+
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  const t8_gloidx_t first_element = t8_forest_get_first_local_element_id (forest);
+
+  /* Collect the tree runs and the elements of this process */
+  runs = T8_ALLOC (t8_forest_save_run_t, num_local_trees);
+  elements = T8_ALLOC (t8_forest_save_element_t, forest->local_num_elements);
+  num_runs = 0;
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_tree_t tree = t8_forest_get_tree (forest, itree);
+    const t8_locidx_t num_elements = t8_forest_get_tree_element_count (tree);
+    /* Empty trees of incomplete forests are stored as runs without elements,
+     * such that the local tree indices are restored on loading. */
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, tree->eclass);
+    runs[num_runs].gtree_id = forest->first_local_tree + itree;
+    runs[num_runs].first_element = first_element + tree->elements_offset;
+    runs[num_runs].num_elements = num_elements;
+    runs[num_runs].eclass = tree->eclass;
+    runs[num_runs].padding = 0;
+    num_runs++;
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+      const t8_element_t *element = t8_element_array_index_locidx (&tree->elements, ielement);
+      t8_forest_save_element_t *entry = elements + tree->elements_offset + ielement;
+      entry->level = ts->t8_element_level (element);
+      entry->linear_id = ts->t8_element_get_linear_id (element, entry->level);
+      entry->padding = 0;
+    }
+  }
+
+  /* Compute the global index of our first run */
+  run_counts = T8_ALLOC (t8_gloidx_t, forest->mpisize);
+  mpiret = sc_MPI_Allgather (&num_runs, 1, T8_MPI_GLOIDX, run_counts, 1, T8_MPI_GLOIDX, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  first_run = 0;
+  memset (&header, 0, sizeof (header));
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    if (iproc == forest->mpirank) {
+      first_run = header.global_num_runs;
+    }
+    header.global_num_runs += run_counts[iproc];
+  }
+  T8_FREE (run_counts);
+
+  /* Fill the header */
+  memcpy (header.magic, "T8FOREST", sizeof (header.magic));
+  header.version = T8_FOREST_SAVE_VERSION;
+  header.mpisize = forest->mpisize;
+  header.dimension = forest->dimension;
+  header.incomplete_trees = forest->incomplete_trees;
+  header.global_num_trees = forest->global_num_trees;
+  header.global_num_elements = forest->global_num_elements;
+  header.data_size = element_data != NULL ? element_data->elem_size : 0;
+
+  if (!t8_mpi_file_open (forest->mpicomm, filename, 1, &file)) {
+    T8_FREE (runs);
+    T8_FREE (elements);
+    return 0;
+  }
+  success = 1;
+  if (forest->mpirank == 0) {
+    /* Process zero writes the header and the element offsets */
+    T8_ASSERT (forest->element_offsets != NULL);
+    const t8_gloidx_t *offsets = t8_shmem_array_get_gloidx_array (forest->element_offsets);
+    success = success && t8_mpi_file_write_at (&file, 0, &header, 1, sizeof (header));
+    success = success
+              && t8_mpi_file_write_at (&file, t8_forest_save_offsets_pos (), offsets, forest->mpisize + 1,
+                                       sizeof (int64_t));
+  }
+  /* All processes write their runs, elements and data */
+  const size_t runs_pos = t8_forest_save_runs_pos (&header) + first_run * sizeof (t8_forest_save_run_t);
+  success = t8_mpi_file_write_at_all (&file, runs_pos, runs, num_runs, sizeof (t8_forest_save_run_t)) && success;
+  const size_t elements_pos
+    = t8_forest_save_elements_pos (&header) + first_element * sizeof (t8_forest_save_element_t);
+  success = t8_mpi_file_write_at_all (&file, elements_pos, elements, forest->local_num_elements,
+                                      sizeof (t8_forest_save_element_t))
+            && success;
+  if (element_data != NULL) {
+    const size_t data_pos = t8_forest_save_data_pos (&header) + first_element * element_data->elem_size;
+    success = t8_mpi_file_write_at_all (&file, data_pos, element_data->array, element_data->elem_count,
+                                        element_data->elem_size)
+              && success;
+  }
+  success = t8_mpi_file_close (&file) && success;
+  T8_FREE (runs);
+  T8_FREE (elements);
+
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_errorf ("Error when writing forest to file %s.\n", filename);
+  }
+  return global_success;
+}
+
+/* Read and check the header of a forest file on process zero and broadcast it. */
+static void
+t8_forest_load_header (t8_mpi_file_t *file, sc_MPI_Comm comm, const int mpirank,
+                       t8_forest_save_header_t *header)
+{
+  int success = 1, mpiret;
+
+  if (mpirank == 0) {
+    success = t8_mpi_file_read_at (file, 0, header, 1, sizeof (*header));
+  }
+  mpiret = sc_MPI_Bcast (&success, 1, sc_MPI_INT, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  SC_CHECK_ABORT (success, "Could not read the header of the forest file.");
+  mpiret = sc_MPI_Bcast (header, sizeof (*header), sc_MPI_BYTE, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  SC_CHECK_ABORT (!memcmp (header->magic, "T8FOREST", sizeof (header->magic)), "Not a t8code forest file.");
+  SC_CHECK_ABORT (header->version == T8_FOREST_SAVE_VERSION, "Unsupported version of the forest file format.");
+}
+
+/* Find the first tree run of a forest file whose end, or whose beginning, lies after a given element.
+ * Since the runs are sorted by their elements, we search them with a binary search in the file.
+ * \param [in] file      The forest file.
+ * \param [in] header    The header of \a file.
+ * \param [in] element   A global element index.
+ * \param [in] use_end   If true, compare the index of the element after the run,
+ *                       otherwise the index of the first element of the run.
+ * \return The index of the first run whose end (or beginning) is larger than \a element,
+ *         or the number of runs if there is none. */
+static t8_gloidx_t
+t8_forest_load_find_run (t8_mpi_file_t *file, const t8_forest_save_header_t *header, const int64_t element,
+                         const int use_end)
+{
+  t8_gloidx_t low = 0;
+  t8_gloidx_t high = header->global_num_runs;
+  t8_forest_save_run_t run;
+
+  while (low < high) {
+    const t8_gloidx_t mid = low + (high - low) / 2;
+    SC_CHECK_ABORT (t8_mpi_file_read_at (file, t8_forest_save_runs_pos (header) + mid * sizeof (run), &run, 1,
+                                         sizeof (run)),
+                    "Could not read the trees of the forest file.");
+    if (run.first_element + (use_end ? run.num_elements : 0) <= element) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/* Append a new empty local tree for a tree run to a forest that is being loaded.
+ * \param [in] elements_offset The local index of the first element of the tree. */
+static t8_tree_t
+t8_forest_load_push_tree (t8_forest_t forest, const t8_forest_save_run_t *run, const t8_locidx_t elements_offset)
+{
+  t8_tree_t tree = (t8_tree_t) sc_array_push (forest->trees);
+  tree->eclass = (t8_eclass_t) run->eclass;
+  tree->elements_offset = elements_offset;
+  tree->num_compact_elements = 0;
+  t8_element_array_init (&tree->elements,
+                         t8_forest_get_eclass_scheme_before_commit (forest, (t8_eclass_t) run->eclass));
+  return tree;
+}
+
+void
+t8_forest_load_populate (t8_forest_t forest)
+{
+  t8_forest_save_header_t header;
+  t8_mpi_file_t file;
+  t8_forest_save_run_t *runs;
+  t8_forest_save_element_t *elements;
+  int64_t range[2];
+  t8_tree_t tree = NULL;
+  t8_gloidx_t last_gtree = -1;
+
+  T8_ASSERT (forest->set_load_filename != NULL);
+  T8_ASSERT (forest->cmesh != NULL && forest->scheme_cxx != NULL);
+
+  SC_CHECK_ABORTF (t8_mpi_file_open (forest->mpicomm, forest->set_load_filename, 0, &file),
+                   "Could not open forest file %s.", forest->set_load_filename);
+  t8_forest_load_header (&file, forest->mpicomm, forest->mpirank, &header);
+  SC_CHECK_ABORT (header.dimension == forest->dimension, "Dimension of forest file and cmesh do not match.");
+  SC_CHECK_ABORT (header.global_num_trees == t8_cmesh_get_num_trees (forest->cmesh),
+                  "Number of trees of forest file and cmesh do not match.");
+
+  /* Determine the range of global elements that we read */
+  if (header.mpisize == forest->mpisize) {
+    /* Restore the partition of the saved forest */
+    const size_t offsets_pos = t8_forest_save_offsets_pos () + forest->mpirank * sizeof (int64_t);
+    SC_CHECK_ABORT (t8_mpi_file_read_at_all (&file, offsets_pos, range, 2, sizeof (int64_t)),
+                    "Could not read the element offsets of the forest file.");
+  }
+  else {
+    /* Distribute the elements evenly */
+    const t8_gloidx_t num_per_proc = header.global_num_elements / forest->mpisize;
+    const t8_gloidx_t remainder = header.global_num_elements % forest->mpisize;
+    range[0] = num_per_proc * forest->mpirank + SC_MIN (forest->mpirank, remainder);
+    range[1] = range[0] + num_per_proc + (forest->mpirank < remainder);
+  }
+  T8_ASSERT (0 <= range[0] && range[0] <= range[1] && range[1] <= header.global_num_elements);
+
+  /* Read the tree runs that overlap our range and the elements in our range */
+  t8_gloidx_t first_run = 0, num_runs = 0;
+  if (range[0] < range[1]) {
+    first_run = t8_forest_load_find_run (&file, &header, range[0], 1);
+    num_runs = t8_forest_load_find_run (&file, &header, range[1] - 1, 0) - first_run;
+    T8_ASSERT (num_runs > 0);
+  }
+  runs = T8_ALLOC (t8_forest_save_run_t, num_runs);
+  elements = T8_ALLOC (t8_forest_save_element_t, range[1] - range[0]);
+  const size_t runs_pos = t8_forest_save_runs_pos (&header) + first_run * sizeof (t8_forest_save_run_t);
+  SC_CHECK_ABORT (t8_mpi_file_read_at_all (&file, runs_pos, runs, num_runs, sizeof (t8_forest_save_run_t)),
+                  "Could not read the trees of the forest file.");
+  const size_t elements_pos = t8_forest_save_elements_pos (&header) + range[0] * sizeof (t8_forest_save_element_t);
+  SC_CHECK_ABORT (t8_mpi_file_read_at_all (&file, elements_pos, elements, range[1] - range[0],
+                                           sizeof (t8_forest_save_element_t)),
+                  "Could not read the elements of the forest file.");
+  t8_mpi_file_close (&file);
+
+  /* Build the local trees from the runs that intersect our range */
+  forest->trees = sc_array_new (sizeof (t8_tree_struct_t));
+  forest->local_num_elements = range[1] - range[0];
+  forest->first_local_tree = 0;
+  forest->last_local_tree = -1;
+  /* Empty trees that follow our last tree. They are local if another tree follows. */
+  t8_gloidx_t first_empty_run = -1;
+  for (t8_gloidx_t irun = 0; irun < num_runs; irun++) {
+    const t8_forest_save_run_t *run = runs + irun;
+    if (run->num_elements == 0) {
+      if (tree != NULL && first_empty_run < 0) {
+        first_empty_run = irun;
+      }
+      continue;
+    }
+    const t8_gloidx_t first = SC_MAX (run->first_element, range[0]);
+    const t8_gloidx_t last = SC_MIN (run->first_element + run->num_elements, range[1]);
+    T8_ASSERT (first < last);
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme_before_commit (forest, (t8_eclass_t) run->eclass);
+    if (run->gtree_id != last_gtree) {
+      /* Add the empty trees in between and start a new local tree */
+      T8_ASSERT (run->gtree_id > last_gtree);
+      for (t8_gloidx_t iempty = first_empty_run; 0 <= iempty && iempty < irun; iempty++) {
+        t8_forest_load_push_tree (forest, runs + iempty, first - range[0]);
+      }
+      if (tree == NULL) {
+        forest->first_local_tree = run->gtree_id;
+      }
+      tree = t8_forest_load_push_tree (forest, run, first - range[0]);
+      last_gtree = forest->last_local_tree = run->gtree_id;
+    }
+    first_empty_run = -1;
+    T8_ASSERT (tree->eclass == run->eclass);
+    for (t8_gloidx_t ielement = first; ielement < last; ielement++) {
+      const t8_forest_save_element_t *entry = elements + ielement - range[0];
+      SC_CHECK_ABORT (entry->level <= forest->maxlevel, "Element level in forest file exceeds the maximum level.");
+      ts->t8_element_set_linear_id (t8_element_array_push (&tree->elements), entry->level, entry->linear_id);
+    }
+  }
+  T8_ASSERT (forest->last_local_tree - forest->first_local_tree + 1 == (t8_gloidx_t) forest->trees->elem_count);
+  T8_FREE (runs);
+  T8_FREE (elements);
+
+  forest->global_num_elements = header.global_num_elements;
+  forest->incomplete_trees = header.incomplete_trees;
+}
+
+int
+t8_forest_load_data (t8_forest_t forest, const char *filename, sc_array_t *element_data)
+{
+  t8_forest_save_header_t header;
+  t8_mpi_file_t file;
+  int success, global_success, mpiret;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (element_data != NULL);
+  T8_ASSERT (element_data->elem_count == (size_t) forest->local_num_elements);
+
+  if (!t8_mpi_file_open (forest->mpicomm, filename, 0, &file)) {
+    return 0;
+  }
+  t8_forest_load_header (&file, forest->mpicomm, forest->mpirank, &header);
+  if (header.global_num_elements != forest->global_num_elements
+      || header.data_size != (int64_t) element_data->elem_size) {
+    t8_global_errorf ("Forest file %s does not contain data of this size for this forest.\n", filename);
+    t8_mpi_file_close (&file);
+    return 0;
+  }
+  const t8_gloidx_t first_element = t8_forest_get_first_local_element_id (forest);
+  const size_t data_pos = t8_forest_save_data_pos (&header) + first_element * header.data_size;
+  success = t8_mpi_file_read_at_all (&file, data_pos, element_data->array, element_data->elem_count,
+                                        element_data->elem_size);
+  success = t8_mpi_file_close (&file) && success;
+
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_errorf ("Error when reading element data from file %s.\n", filename);
+  }
+  return global_success;
+}
+
+T8_EXTERN_C_END ();
@@ -62,7 +62,7 @@ typedef int8_t t8_forest_from_t;
 #define T8_FOREST_BALANCE_NO_REPART 2 /**< Value of forest->set_balance if balancing without repartitioning */
 
 /** The number of statistics collected by a profile struct. */
-#define T8_PROFILE_NUM_STATS 14
+#define T8_PROFILE_NUM_STATS 15
 
 /** This structure is private to the implementation. */
 typedef struct t8_forest
@@ -72,6 +72,10 @@ typedef struct t8_forest
   int set_level;          /**< Level to use in new construction. */
   int set_for_coarsening; /**< Change partition to allow
                                                      for one round of coarsening */
+  t8_forest_partition_weight_fn set_partition_weight_fn; /**< If not NULL, callback to compute element weights
+                                                               for partition. \see t8_forest_set_partition_weights */
+  const double *set_partition_weights; /**< If not NULL, array of element weights for partition.
+                                                \see t8_forest_set_partition_weights */
 
   sc_MPI_Comm mpicomm; /**< MPI communicator to use. */
   t8_cmesh_t cmesh;    /**< Coarse mesh to use. */
@@ -88,11 +92,15 @@ typedef struct t8_forest
                                              false on all ranks. */
 
   t8_forest_t set_from;           /**< Temporarily store source forest. */
+  char *set_load_filename;        /**< If not NULL, the file to load the forest from.
+                                             \see t8_forest_set_load */
   t8_forest_from_t from_method;   /**< Method to derive from \b set_from. */
   t8_forest_adapt_t set_adapt_fn; /**< refinement and coarsen function. Called when \b from_method
                                              is set to T8_FOREST_FROM_ADAPT. */
   int set_adapt_recursive;        /**< Flag to decide whether coarsen and refine
                                                 are carried out recursive */
+  int set_adapt_num_threads;      /**< Number of threads used for adaptation.
+                                             \see t8_forest_set_adapt_num_threads */
   int set_balance;                /**< Flag to decide whether to forest will be balance in \ref t8_forest_commit.
                                              See \ref t8_forest_set_balance.
                                              If 0, no balance. If 1 balance with repartitioning, if 2 balance without
@@ -116,7 +124,12 @@ typedef struct t8_forest
                                              -1 if this processor is empty. */
   t8_gloidx_t global_num_trees; /**< The total number of global trees */
   sc_array_t *trees;
+  sc_array_t *compact_trees;          /**< If not NULL, the forest is compact and this array stores for each local
+                                            tree an sc_array_t of keys, each packing level and linear id of an element.
+                                            \see t8_forest_compact */
   t8_forest_ghost_t ghosts;           /**< If not NULL, the ghost elements. \see t8_forest_ghost.h */
+  struct t8_forest_face_connectivity *face_connectivity; /**< If not NULL, the cached face connectivity of the leaves.
+                                                              \see t8_forest_build_face_connectivity */
   t8_shmem_array_t element_offsets;   /**< If partitioned, for each process the global index
                                             of its first element. Since it is memory consuming,
                                             it is usually only constructed when needed and otherwise unallocated. */
@@ -149,6 +162,8 @@ typedef struct t8_tree
   t8_locidx_t elements_offset; /**< cumulative sum over earlier
                                                   trees on this processor
                                                   (locals only) */
+  t8_locidx_t num_compact_elements; /**< The number of elements if the tree is stored in compact form,
+                                         0 otherwise. Then \a elements is empty. \see t8_forest_compact */
 } t8_tree_struct_t;
 
 /** This struct is used to profile forest algorithms.
@@ -158,7 +173,7 @@ typedef struct t8_tree
  */
 
 /** The number of statistics collected by a profile struct. */
-#define T8_PROFILE_NUM_STATS 14
+#define T8_PROFILE_NUM_STATS 15
 typedef struct t8_profile
 {
   t8_locidx_t partition_elements_shipped; /**< The number of elements this process has
@@ -174,13 +189,20 @@ typedef struct t8_profile
                                                   other processes. */
   int ghosts_remotes;                     /**< The number of processes this process have sent ghost elements to
                                                   (and received from). */
-  int balance_rounds;                     /**< The number of iterations during balance. */
+  int balance_rounds;                     /**< The number of exchange rounds during balance. */
+  int balance_rounds_saved;               /**< The number of rounds that the adapt based balance algorithm
+                                                  needs at least in addition: One more than the largest number
+                                                  of ripple steps that led to a refinement, minus
+                                                  \a balance_rounds. */
   double adapt_runtime;     /**< The runtime of the last call to \a t8_forest_adapt (not counting adaptation
                                                   in t8_forest_balance). */
   double partition_runtime; /**< The runtime of the last call to \a t8_cmesh_partition (not count in
                                                   partition in t8_forest_balance). */
   double ghost_runtime;     /**< The runtime of the last call to \a t8_forest_ghost_create. */
   double ghost_waittime;    /**< Amount of synchronisation time in ghost. */
+  double ghost_overlaptime; /**< Time of the last ghost data exchange during which communication was hidden
+                                                  behind computation: the minimum of the time between begin and
+                                                  end and the time until the communication was completed. */
   double balance_runtime;   /**< The runtime of the last call to \a t8_forest_balance. */
   double commit_runtime;    /**< The runtime of the last call to \a t8_cmesh_commit. */
 
@@ -211,6 +233,8 @@ typedef struct t8_forest_ghost
                                                 process. Sorted within each process by linear id. */
   sc_array_t *remote_processes;         /**< The ranks of the processes for which local elements are ghost.
                                                 Array of int's. */
+  struct t8_ghost_exchange_plan *exchange_plan; /**< Precomputed send lists, buffers and persistent requests
+                                                for data exchanges on this ghost layer. Built at the first exchange. */
 
   sc_mempool_t *glo_tree_mempool;
   sc_mempool_t *proc_offset_mempool;
@@ -0,0 +1,296 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <array>
+#include <t8_schemes/t8_default/t8_default_common/t8_default_morton.hxx>
+
+/* We use the BMI2 instructions on x86-64 with compilers that allow to enable them per function.
+ * Whether the CPU supports them is checked at runtime. */
+#if (defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)))
+#define T8_MORTON_ENABLE_BMI2 1
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+
+/* The number of bits of a coordinate that fit into a 64 bit Morton index. */
+#define T8_MORTON_BITS_2D 32
+#define T8_MORTON_BITS_3D 21
+
+/* The reference implementation, interleaving one bit per iteration. */
+
+static uint64_t
+t8_morton_loop_encode_2d (uint32_t x, uint32_t y)
+{
+  uint64_t id = 0;
+  for (int ibit = 0; ibit < T8_MORTON_BITS_2D; ibit++) {
+    id |= (uint64_t) ((x >> ibit) & 1) << (2 * ibit);
+    id |= (uint64_t) ((y >> ibit) & 1) << (2 * ibit + 1);
+  }
+  return id;
+}
+
+static void
+t8_morton_loop_decode_2d (uint64_t id, uint32_t *x, uint32_t *y)
+{
+  *x = *y = 0;
+  for (int ibit = 0; ibit < T8_MORTON_BITS_2D; ibit++) {
+    *x |= (uint32_t) ((id >> (2 * ibit)) & 1) << ibit;
+    *y |= (uint32_t) ((id >> (2 * ibit + 1)) & 1) << ibit;
+  }
+}
+
+static uint64_t
+t8_morton_loop_encode_3d (uint32_t x, uint32_t y, uint32_t z)
+{
+  uint64_t id = 0;
+  for (int ibit = 0; ibit < T8_MORTON_BITS_3D; ibit++) {
+    id |= (uint64_t) ((x >> ibit) & 1) << (3 * ibit);
+    id |= (uint64_t) ((y >> ibit) & 1) << (3 * ibit + 1);
+    id |= (uint64_t) ((z >> ibit) & 1) << (3 * ibit + 2);
+  }
+  return id;
+}
+
+static void
+t8_morton_loop_decode_3d (uint64_t id, uint32_t *x, uint32_t *y, uint32_t *z)
+{
+  *x = *y = *z = 0;
+  for (int ibit = 0; ibit < T8_MORTON_BITS_3D; ibit++) {
+    *x |= (uint32_t) ((id >> (3 * ibit)) & 1) << ibit;
+    *y |= (uint32_t) ((id >> (3 * ibit + 1)) & 1) << ibit;
+    *z |= (uint32_t) ((id >> (3 * ibit + 2)) & 1) << ibit;
+  }
+}
+
+/* The table implementation. The tables are computed at compile time. */
+
+/* Spread the bits of a byte, such that there are dim - 1 zero bits between two bits. */
+template <int dim>
+static constexpr std::array<uint32_t, 256>
+t8_morton_make_spread_table ()
+{
+  std::array<uint32_t, 256> table {};
+  for (uint32_t byte = 0; byte < 256; byte++) {
+    for (int ibit = 0; ibit < 8; ibit++) {
+      table[byte] |= ((byte >> ibit) & 1) << (dim * ibit);
+    }
+  }
+  return table;
+}
+
+/* Split the dim * bits bits of an index into dim coordinates of bits bits each.
+ * Coordinate i is stored at the bits i * bits, ..., (i + 1) * bits - 1 of the table entry. */
+template <int dim, int bits>
+static constexpr std::array<uint16_t, 1 << (dim * bits)>
+t8_morton_make_compact_table ()
+{
+  std::array<uint16_t, 1 << (dim * bits)> table {};
+  for (uint32_t index = 0; index < (1u << (dim * bits)); index++) {
+    for (int ibit = 0; ibit < bits; ibit++) {
+      for (int icoord = 0; icoord < dim; icoord++) {
+        table[index] |= ((index >> (dim * ibit + icoord)) & 1) << (icoord * bits + ibit);
+      }
+    }
+  }
+  return table;
+}
+
+static constexpr std::array<uint32_t, 256> t8_morton_spread_2d = t8_morton_make_spread_table<2> ();
+static constexpr std::array<uint32_t, 256> t8_morton_spread_3d = t8_morton_make_spread_table<3> ();
+/* In 2D we decode 4 bits per coordinate at once, in 3D 3 bits. */
+static constexpr std::array<uint16_t, 256> t8_morton_compact_2d = t8_morton_make_compact_table<2, 4> ();
+static constexpr std::array<uint16_t, 512> t8_morton_compact_3d = t8_morton_make_compact_table<3, 3> ();
+
+static uint64_t
+t8_morton_table_encode_2d (uint32_t x, uint32_t y)
+{
+  uint64_t id = 0;
+  for (int ibyte = 0; ibyte < 4; ibyte++) {
+    const uint64_t spread
+      = t8_morton_spread_2d[(x >> (8 * ibyte)) & 0xff] | t8_morton_spread_2d[(y >> (8 * ibyte)) & 0xff] << 1;
+    id |= spread << (16 * ibyte);
+  }
+  return id;
+}
+
+static void
+t8_morton_table_decode_2d (uint64_t id, uint32_t *x, uint32_t *y)
+{
+  uint32_t cx = 0, cy = 0;
+  for (int ichunk = 0; ichunk < 8; ichunk++) {
+    const uint32_t compact = t8_morton_compact_2d[(id >> (8 * ichunk)) & 0xff];
+    cx |= (compact & 0xf) << (4 * ichunk);
+    cy |= (compact >> 4) << (4 * ichunk);
+  }
+  *x = cx;
+  *y = cy;
+}
+
+static uint64_t
+t8_morton_table_encode_3d (uint32_t x, uint32_t y, uint32_t z)
+{
+  uint64_t id = 0;
+  for (int ibyte = 0; ibyte < 3; ibyte++) {
+    const uint64_t spread = t8_morton_spread_3d[(x >> (8 * ibyte)) & 0xff]
+                            | t8_morton_spread_3d[(y >> (8 * ibyte)) & 0xff] << 1
+                            | t8_morton_spread_3d[(z >> (8 * ibyte)) & 0xff] << 2;
+    id |= spread << (24 * ibyte);
+  }
+  /* Only the lower 21 bits of the coordinates fit into the index. */
+  return id & (T8_MORTON_MASK_3D | T8_MORTON_MASK_3D << 1 | T8_MORTON_MASK_3D << 2);
+}
+
+static void
+t8_morton_table_decode_3d (uint64_t id, uint32_t *x, uint32_t *y, uint32_t *z)
+{
+  uint32_t cx = 0, cy = 0, cz = 0;
+  for (int ichunk = 0; ichunk < 7; ichunk++) {
+    const uint32_t compact = t8_morton_compact_3d[(id >> (9 * ichunk)) & 0x1ff];
+    cx |= (compact & 0x7) << (3 * ichunk);
+    cy |= ((compact >> 3) & 0x7) << (3 * ichunk);
+    cz |= (compact >> 6) << (3 * ichunk);
+  }
+  *x = cx;
+  *y = cy;
+  *z = cz;
+}
+
+#if T8_MORTON_ENABLE_BMI2
+/* The BMI2 implementation. These functions may only be called if the CPU supports BMI2. */
+
+__attribute__ ((target ("bmi2"))) static uint64_t
+t8_morton_bmi2_encode_2d (uint32_t x, uint32_t y)
+{
+  return _pdep_u64 (x, T8_MORTON_MASK_2D) | _pdep_u64 (y, T8_MORTON_MASK_2D << 1);
+}
+
+__attribute__ ((target ("bmi2"))) static void
+t8_morton_bmi2_decode_2d (uint64_t id, uint32_t *x, uint32_t *y)
+{
+  *x = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_2D);
+  *y = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_2D << 1);
+}
+
+__attribute__ ((target ("bmi2"))) static uint64_t
+t8_morton_bmi2_encode_3d (uint32_t x, uint32_t y, uint32_t z)
+{
+  return _pdep_u64 (x, T8_MORTON_MASK_3D) | _pdep_u64 (y, T8_MORTON_MASK_3D << 1)
+         | _pdep_u64 (z, T8_MORTON_MASK_3D << 2);
+}
+
+__attribute__ ((target ("bmi2"))) static void
+t8_morton_bmi2_decode_3d (uint64_t id, uint32_t *x, uint32_t *y, uint32_t *z)
+{
+  *x = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_3D);
+  *y = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_3D << 1);
+  *z = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_3D << 2);
+}
+
+/* Check whether PDEP and PEXT are fast on this CPU. AMD CPUs before Zen 3 (family 19h) support BMI2,
+ * but execute PDEP and PEXT in microcode with a latency that depends on the mask. There, the table
+ * implementation is much faster. */
+static int
+t8_morton_bmi2_is_fast (void)
+{
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid (0, &eax, &ebx, &ecx, &edx)) {
+    return 0;
+  }
+  /* The vendor string "AuthenticAMD" is stored in ebx, edx, ecx. */
+  const int is_amd = ebx == 0x68747541 && edx == 0x69746e65 && ecx == 0x444d4163;
+  if (!is_amd) {
+    return 1;
+  }
+  if (!__get_cpuid (1, &eax, &ebx, &ecx, &edx)) {
+    return 0;
+  }
+  int family = (eax >> 8) & 0xf;
+  if (family == 0xf) {
+    family += (eax >> 20) & 0xff;
+  }
+  return family >= 0x19;
+}
+#endif
+
+/* The functions of all implementations, indexed by t8_morton_kernel_t.
+ * Unsupported implementations fall back to the table implementation. */
+static const t8_morton_kernels_t t8_morton_all_kernels[T8_MORTON_KERNEL_COUNT] = {
+  { t8_morton_loop_encode_2d, t8_morton_loop_decode_2d, t8_morton_loop_encode_3d, t8_morton_loop_decode_3d },
+  { t8_morton_table_encode_2d, t8_morton_table_decode_2d, t8_morton_table_encode_3d, t8_morton_table_decode_3d },
+#if T8_MORTON_ENABLE_BMI2
+  { t8_morton_bmi2_encode_2d, t8_morton_bmi2_decode_2d, t8_morton_bmi2_encode_3d, t8_morton_bmi2_decode_3d }
+#else
+  { t8_morton_table_encode_2d, t8_morton_table_decode_2d, t8_morton_table_encode_3d, t8_morton_table_decode_3d }
+#endif
+};
+
+T8_EXTERN_C_BEGIN ();
+
+int
+t8_morton_kernel_is_supported (t8_morton_kernel_t kernel)
+{
+  T8_ASSERT (0 <= kernel && kernel < T8_MORTON_KERNEL_COUNT);
+  if (kernel != T8_MORTON_KERNEL_BMI2) {
+    return 1;
+  }
+#if T8_MORTON_ENABLE_BMI2
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("bmi2");
+#else
+  return 0;
+#endif
+}
+
+t8_morton_kernel_t
+t8_morton_kernel_select (void)
+{
+#if T8_MORTON_ENABLE_BMI2
+  if (t8_morton_kernel_is_supported (T8_MORTON_KERNEL_BMI2) && t8_morton_bmi2_is_fast ()) {
+    return T8_MORTON_KERNEL_BMI2;
+  }
+#endif
+  return T8_MORTON_KERNEL_TABLE;
+}
+
+const t8_morton_kernels_t *
+t8_morton_get_kernels (t8_morton_kernel_t kernel)
+{
+  T8_ASSERT (t8_morton_kernel_is_supported (kernel));
+  return &t8_morton_all_kernels[kernel];
+}
+
+const char *
+t8_morton_kernel_name (t8_morton_kernel_t kernel)
+{
+  switch (kernel) {
+  case T8_MORTON_KERNEL_LOOP:
+    return "loop";
+  case T8_MORTON_KERNEL_TABLE:
+    return "table";
+  case T8_MORTON_KERNEL_BMI2:
+    return "bmi2";
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+}
+
+T8_EXTERN_C_END ();
@@ -0,0 +1,238 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_default_morton.hxx
+ * Interleaving of coordinate bits to Morton indices and back.
+ * The default quad and hex schemes use these functions to compute linear ids.
+ * There are several implementations of the interleaving. If the compiler targets BMI2,
+ * the PDEP and PEXT instructions are inlined. Otherwise, the fastest implementation that
+ * the CPU supports is selected at runtime when a scheme is constructed: The PDEP and PEXT
+ * instructions if the CPU supports BMI2 and lookup tables otherwise.
+ */
+
+#pragma once
+
+#include <t8.h>
+#include <p4est_bits.h>
+#include <p8est_bits.h>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+/* The bits of the Morton index that belong to the x coordinate. The bits of the y
+ * and z coordinates are these masks shifted by one and two. */
+#define T8_MORTON_MASK_2D 0x5555555555555555ULL
+#define T8_MORTON_MASK_3D 0x1249249249249249ULL
+
+/** The implementations of the Morton encoding. */
+typedef enum {
+  T8_MORTON_KERNEL_LOOP = 0, /**< Interleave one bit per iteration. This is the reference implementation. */
+  T8_MORTON_KERNEL_TABLE,    /**< Interleave eight bits per iteration with lookup tables. */
+  T8_MORTON_KERNEL_BMI2,     /**< Interleave with the PDEP and PEXT instructions of the BMI2 extension. */
+  T8_MORTON_KERNEL_COUNT     /**< The number of implementations. */
+} t8_morton_kernel_t;
+
+/** The functions of one implementation of the Morton encoding.
+ * In 2D the coordinates may have up to 32 bits, in 3D up to 21 bits.
+ * Bit i of x is bit dim * i of the Morton index, bit i of y is bit dim * i + 1
+ * and bit i of z is bit 3 * i + 2.
+ */
+typedef struct
+{
+  uint64_t (*encode_2d) (uint32_t x, uint32_t y);                         /**< Interleave two coordinates. */
+  void (*decode_2d) (uint64_t id, uint32_t *x, uint32_t *y);              /**< Inverse of encode_2d. */
+  uint64_t (*encode_3d) (uint32_t x, uint32_t y, uint32_t z);             /**< Interleave three coordinates. */
+  void (*decode_3d) (uint64_t id, uint32_t *x, uint32_t *y, uint32_t *z); /**< Inverse of encode_3d. */
+} t8_morton_kernels_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Query whether an implementation of the Morton encoding is supported by the CPU.
+ * \param [in] kernel   An implementation.
+ * \return              True if and only if \a kernel can be used on this CPU.
+ */
+int
+t8_morton_kernel_is_supported (t8_morton_kernel_t kernel);
+
+/** Return the fastest implementation of the Morton encoding that is supported by the CPU.
+ * This is the BMI2 implementation, unless the CPU does not support BMI2 or executes PDEP and PEXT
+ * in microcode, as AMD CPUs before Zen 3 do. Then it is the table implementation.
+ * \return              The implementation that is used by the default schemes.
+ */
+t8_morton_kernel_t
+t8_morton_kernel_select (void);
+
+/** Return the functions of an implementation of the Morton encoding.
+ * \param [in] kernel   An implementation that is supported by the CPU.
+ * \return              The functions of \a kernel.
+ */
+const t8_morton_kernels_t *
+t8_morton_get_kernels (t8_morton_kernel_t kernel);
+
+/** Return the name of an implementation of the Morton encoding.
+ * \param [in] kernel   An implementation.
+ * \return              A human readable name of \a kernel.
+ */
+const char *
+t8_morton_kernel_name (t8_morton_kernel_t kernel);
+
+T8_EXTERN_C_END ();
+
+/** Interleave two coordinates with an implementation of the Morton encoding.
+ * If the compiler targets BMI2, the PDEP instruction is used directly and \a kernels is ignored.
+ * \param [in] kernels  The implementation, selected with \ref t8_morton_kernel_select.
+ * \param [in] x        The first coordinate.
+ * \param [in] y        The second coordinate.
+ * \return              The Morton index of \a x and \a y.
+ */
+inline uint64_t
+t8_morton_encode_2d (const t8_morton_kernels_t *kernels, const uint32_t x, const uint32_t y)
+{
+#ifdef __BMI2__
+  return _pdep_u64 (x, T8_MORTON_MASK_2D) | _pdep_u64 (y, T8_MORTON_MASK_2D << 1);
+#else
+  return kernels->encode_2d (x, y);
+#endif
+}
+
+/** Inverse of \ref t8_morton_encode_2d. */
+inline void
+t8_morton_decode_2d (const t8_morton_kernels_t *kernels, const uint64_t id, uint32_t *x, uint32_t *y)
+{
+#ifdef __BMI2__
+  *x = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_2D);
+  *y = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_2D << 1);
+#else
+  kernels->decode_2d (id, x, y);
+#endif
+}
+
+/** Interleave three coordinates of at most 21 bits with an implementation of the Morton encoding.
+ * If the compiler targets BMI2, the PDEP instruction is used directly and \a kernels is ignored.
+ * \param [in] kernels  The implementation, selected with \ref t8_morton_kernel_select.
+ * \param [in] x        The first coordinate.
+ * \param [in] y        The second coordinate.
+ * \param [in] z        The third coordinate.
+ * \return              The Morton index of \a x, \a y and \a z.
+ */
+inline uint64_t
+t8_morton_encode_3d (const t8_morton_kernels_t *kernels, const uint32_t x, const uint32_t y, const uint32_t z)
+{
+#ifdef __BMI2__
+  return _pdep_u64 (x, T8_MORTON_MASK_3D) | _pdep_u64 (y, T8_MORTON_MASK_3D << 1)
+         | _pdep_u64 (z, T8_MORTON_MASK_3D << 2);
+#else
+  return kernels->encode_3d (x, y, z);
+#endif
+}
+
+/** Inverse of \ref t8_morton_encode_3d. */
+inline void
+t8_morton_decode_3d (const t8_morton_kernels_t *kernels, const uint64_t id, uint32_t *x, uint32_t *y, uint32_t *z)
+{
+#ifdef __BMI2__
+  *x = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_3D);
+  *y = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_3D << 1);
+  *z = (uint32_t) _pext_u64 (id, T8_MORTON_MASK_3D << 2);
+#else
+  kernels->decode_3d (id, x, y, z);
+#endif
+}
+
+/** Compute the linear id of a quad of the default scheme.
+ * Equivalent to p4est_quadrant_linear_id, but uses the Morton encoding.
+ * \param [in] kernels The implementation of the Morton encoding, usually the one stored in the scheme.
+ * \param [in] q       A quadrant. Quadrants outside of the root are passed on to p4est.
+ * \param [in] level   A level of at most P4EST_QMAXLEVEL. If it is larger than the level of \a q,
+ *                     the linear id of the first descendant of \a q at \a level is returned.
+ * \return             The linear id of \a q in a uniform refinement of \a level.
+ */
+inline uint64_t
+t8_morton_quad_linear_id (const t8_morton_kernels_t *kernels, const p4est_quadrant_t *q, const int level)
+{
+  if (((q->x | q->y) & ~(P4EST_ROOT_LEN - 1)) != 0) {
+    return p4est_quadrant_linear_id (q, level);
+  }
+  const int shift = P4EST_MAXLEVEL - level;
+  return t8_morton_encode_2d (kernels, (uint32_t) q->x >> shift, (uint32_t) q->y >> shift);
+}
+
+/** Set a quad of the default scheme from its linear id.
+ * Equivalent to p4est_quadrant_set_morton for quadrants inside the root.
+ * \param [in] kernels The implementation of the Morton encoding, usually the one stored in the scheme.
+ * \param [out] q      The quadrant whose coordinates and level are set.
+ * \param [in] level   The level of the uniform refinement.
+ * \param [in] id      A linear id smaller than 4^level.
+ */
+inline void
+t8_morton_quad_set_linear_id (const t8_morton_kernels_t *kernels, p4est_quadrant_t *q, const int level,
+                              const uint64_t id)
+{
+  uint32_t x, y;
+  const int shift = P4EST_MAXLEVEL - level;
+  T8_ASSERT (0 <= level && level <= P4EST_QMAXLEVEL);
+  T8_ASSERT (id < (uint64_t) 1 << P4EST_DIM * level);
+  t8_morton_decode_2d (kernels, id, &x, &y);
+  q->x = (p4est_qcoord_t) (x << shift);
+  q->y = (p4est_qcoord_t) (y << shift);
+  q->level = (int8_t) level;
+}
+
+/** Compute the linear id of a hex of the default scheme.
+ * Equivalent to p8est_quadrant_linear_id, but uses the Morton encoding.
+ * \param [in] kernels The implementation of the Morton encoding, usually the one stored in the scheme.
+ * \param [in] q       An octant. Octants outside of the root are passed on to p8est.
+ * \param [in] level   A level of at most 21. If it is larger than the level of \a q,
+ *                     the linear id of the first descendant of \a q at \a level is returned.
+ * \return             The linear id of \a q in a uniform refinement of \a level.
+ */
+inline uint64_t
+t8_morton_hex_linear_id (const t8_morton_kernels_t *kernels, const p8est_quadrant_t *q, const int level)
+{
+  if (((q->x | q->y | q->z) & ~(P8EST_ROOT_LEN - 1)) != 0) {
+    return p8est_quadrant_linear_id (q, level);
+  }
+  const int shift = P8EST_MAXLEVEL - level;
+  return t8_morton_encode_3d (kernels, (uint32_t) q->x >> shift, (uint32_t) q->y >> shift, (uint32_t) q->z >> shift);
+}
+
+/** Set a hex of the default scheme from its linear id.
+ * Equivalent to p8est_quadrant_set_morton for octants inside the root.
+ * \param [in] kernels The implementation of the Morton encoding, usually the one stored in the scheme.
+ * \param [out] q      The octant whose coordinates and level are set.
+ * \param [in] level   The level of the uniform refinement, at most 21.
+ * \param [in] id      A linear id smaller than 8^level.
+ */
+inline void
+t8_morton_hex_set_linear_id (const t8_morton_kernels_t *kernels, p8est_quadrant_t *q, const int level,
+                             const uint64_t id)
+{
+  uint32_t x, y, z;
+  const int shift = P8EST_MAXLEVEL - level;
+  T8_ASSERT (0 <= level && level <= SC_MIN (P8EST_QMAXLEVEL, 21));
+  T8_ASSERT (id < (uint64_t) 1 << P8EST_DIM * level);
+  t8_morton_decode_3d (kernels, id, &x, &y, &z);
+  q->x = (p4est_qcoord_t) (x << shift);
+  q->y = (p4est_qcoord_t) (y << shift);
+  q->z = (p4est_qcoord_t) (z << shift);
+  q->level = (int8_t) level;
+}
@@ -23,7 +23,9 @@
 #include <p8est_bits.h>
 #include <p4est_bits.h>
 #include <t8_schemes/t8_default/t8_default_common/t8_default_common.hxx>
+#include <t8_schemes/t8_default/t8_default_common/t8_default_morton.hxx>
 #include <t8_schemes/t8_default/t8_default_hex/t8_default_hex.hxx>
+#include <t8_schemes/t8_default/t8_default_traits.hxx>
 
 #define HEX_LINEAR_MAXLEVEL P8EST_OLD_QMAXLEVEL
 #define HEX_REFINE_MAXLEVEL P8EST_OLD_QMAXLEVEL
@@ -482,7 +484,7 @@ t8_default_scheme_hex_c::t8_element_set_linear_id (t8_element_t *elem, int level
   T8_ASSERT (0 <= level && level <= HEX_LINEAR_MAXLEVEL);
   T8_ASSERT (0 <= id && id < ((t8_linearidx_t) 1) << P8EST_DIM * level);
 
-  p8est_quadrant_set_morton ((p8est_quadrant_t *) elem, level, id);
+  t8_morton_hex_set_linear_id (morton_kernels, (p8est_quadrant_t *) elem, level, id);
 }
 
 t8_linearidx_t
@@ -491,7 +493,7 @@ t8_default_scheme_hex_c::t8_element_get_linear_id (const t8_element_t *elem, int
   T8_ASSERT (t8_element_is_valid (elem));
   T8_ASSERT (0 <= level && level <= HEX_LINEAR_MAXLEVEL);
 
-  return p8est_quadrant_linear_id ((p8est_quadrant_t *) elem, level);
+  return t8_morton_hex_linear_id (morton_kernels, (const p8est_quadrant_t *) elem, level);
 }
 
 void
@@ -638,6 +640,7 @@ t8_default_scheme_hex_c::t8_default_scheme_hex_c (void)
   eclass = T8_ECLASS_HEX;
   element_size = sizeof (t8_phex_t);
   ts_context = sc_mempool_new (element_size);
+  morton_kernels = t8_morton_get_kernels (t8_morton_kernel_select ());
 }
 
 t8_default_scheme_hex_c::~t8_default_scheme_hex_c ()
@@ -656,6 +659,94 @@ t8_default_scheme_hex_c::t8_element_root (t8_element_t *elem) const
   T8_ASSERT (p8est_quadrant_is_extended (hex));
 }
 
+/* The functions on ranges of element arrays call the element functions of t8_scheme_traits<T8_ECLASS_HEX>,
+ * such that the compiler can inline them and vectorize the loops over the octants. */
+
+void
+t8_default_scheme_hex_c::t8_element_levels_of_array (const t8_element_array_t *elements, const size_t first,
+                                                     const size_t count, int *levels) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_HEX> traits (this);
+  const p8est_quadrant_t *q = (const p8est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    levels[ielem] = traits.t8_element_level ((const t8_element_t *) (q + ielem));
+  }
+}
+
+void
+t8_default_scheme_hex_c::t8_element_child_ids_of_array (const t8_element_array_t *elements, const size_t first,
+                                                        const size_t count, int *child_ids) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_HEX> traits (this);
+  const p8est_quadrant_t *q = (const p8est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    child_ids[ielem] = traits.t8_element_child_id ((const t8_element_t *) (q + ielem));
+  }
+}
+
+void
+t8_default_scheme_hex_c::t8_element_linear_ids_of_array (const t8_element_array_t *elements, const size_t first,
+                                                         const size_t count, const int level, t8_linearidx_t *ids) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (0 <= level && level <= HEX_LINEAR_MAXLEVEL);
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_HEX> traits (this);
+  const p8est_quadrant_t *q = (const p8est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    ids[ielem] = traits.t8_element_get_linear_id ((const t8_element_t *) (q + ielem), level);
+  }
+}
+
+void
+t8_default_scheme_hex_c::t8_element_parents_of_array (const t8_element_array_t *elements, const size_t first,
+                                                      const size_t count, t8_element_array_t *parents) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (count <= t8_element_array_get_count (parents));
+  T8_ASSERT (parents != elements);
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_HEX> traits (this);
+  const p8est_quadrant_t *q = (const p8est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  p8est_quadrant_t *r = (p8est_quadrant_t *) t8_element_array_get_data_mutable (parents);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    traits.t8_element_parent ((const t8_element_t *) (q + ielem), (t8_element_t *) (r + ielem));
+  }
+}
+
+void
+t8_default_scheme_hex_c::t8_element_children_of_array (const t8_element_array_t *elements, const size_t first,
+                                                       const size_t count, t8_element_array_t *children) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (children != elements);
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_HEX> traits (this);
+  p8est_quadrant_t *c = (p8est_quadrant_t *) t8_element_array_push_count (children, count * P8EST_CHILDREN);
+  const p8est_quadrant_t *q = (const p8est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  t8_element_t *family[P8EST_CHILDREN];
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    for (int ichild = 0; ichild < P8EST_CHILDREN; ichild++) {
+      family[ichild] = (t8_element_t *) (c + ielem * P8EST_CHILDREN + ichild);
+    }
+    traits.t8_element_children ((const t8_element_t *) (q + ielem), P8EST_CHILDREN, family);
+  }
+}
+
 /* each hex is packed as x,y,z coordinates and the level */
 void
 t8_default_scheme_hex_c::t8_element_MPI_Pack (t8_element_t **const elements, const unsigned int count,
@@ -544,44 +544,54 @@ t8_linearidx_t
 t8_dpyramid_linear_id (const t8_dpyramid_t *p, const int level)
 {
   T8_ASSERT (0 <= p->pyramid.level && p->pyramid.level <= T8_DPYRAMID_MAXLEVEL);
+  T8_ASSERT (0 <= level && level <= T8_DPYRAMID_MAXLEVEL);
   t8_linearidx_t id = 0, sum_1 = 1, sum_2 = 1;
-  t8_dpyramid_t parent, copy;
-
-  t8_dpyramid_copy (p, &copy);
-  copy.pyramid.type = t8_dpyramid_type_at_level (p, level);
-  copy.pyramid.level = level;
-  t8_dpyramid_cut_coordinates (&copy, T8_DPYRAMID_MAXLEVEL - level);
+  t8_dpyramid_type_t type;
+  int i = level;
+
+  if (t8_dpyramid_shape (p) == T8_ECLASS_TET && level > p->switch_shape_at_level) {
+    /* The ancestors of p between the level where the shape switches and level have tetrahedral parents.
+     * Their local indices are the ones of a tetrahedron in the subtree of the ancestor at the switch level. */
+    t8_dtet_type_t tet_type;
+    id = t8_dtet_linear_id_with_level (&(p->pyramid), level, p->switch_shape_at_level + 1, &tet_type);
+    type = tet_type;
+    i = p->switch_shape_at_level;
+    sum_1 <<= 3 * (level - i);
+    sum_2 = sc_intpow64u (6, level - i);
+  }
+  else {
+    type = t8_dpyramid_type_at_level (p, level);
+  }
 
-  for (int i = level; i > 0; i--) {
+  /* All remaining ancestors have a pyramidal parent. */
+  for (; i > 0; i--) {
     /* Compute the number of pyramids with level maxlvl that are in a pyramid
      * of level i*/
     const t8_linearidx_t pyra_shift = (sum_1 << 1) - sum_2;
+    const t8_dpyramid_cube_id_t cube_id = compute_cubeid (p, i);
 
-    /*Compute the parent and the local id of the current element */
-    t8_dpyramid_parent (&copy, &parent);
-    const t8_linearidx_t local_id = t8_dpyramid_child_id (&copy);
-
-    /* Compute the number of predecessors within the parent that have the
-     * shape of a pyramid or a tet*/
-    int num_pyra;
-    if (t8_dpyramid_shape (&parent) == T8_ECLASS_TET) {
-      /* If the parent is a tet, no predecessors are pyramids */
-      num_pyra = 0;
+    /*Compute the local id of the current element and the type of its parent */
+    const int local_id = t8_dpyramid_type_cid_to_Iloc[type][cube_id];
+    if (type < T8_DPYRAMID_FIRST_TYPE) {
+      type = t8_dtet_type_cid_to_pyramid_parenttype[type][cube_id];
     }
     else {
-      /* The number of pyramid-predecessors */
-      num_pyra = t8_dpyramid_parenttype_iloc_pyra_w_lower_id[parent.pyramid.type - T8_DPYRAMID_FIRST_TYPE][local_id];
+      type = t8_dpyramid_cid_type_to_parenttype[cube_id][type];
     }
+    T8_ASSERT (0 <= local_id && type >= T8_DPYRAMID_FIRST_TYPE);
+
+    /* Compute the number of predecessors within the parent that have the
+     * shape of a pyramid or a tet*/
+    const int num_pyra = t8_dpyramid_parenttype_iloc_pyra_w_lower_id[type - T8_DPYRAMID_FIRST_TYPE][local_id];
     /* The number of tets is the local-id minus the number of pyramid-predecessors */
     const int num_tet = local_id - num_pyra;
     /* The Id shifts by the number of predecessor elements */
     id += num_pyra * pyra_shift + num_tet * sum_1;
-    t8_dpyramid_copy (&parent, &copy);
     /* Update the shift */
     sum_1 = sum_1 << 3;
     sum_2 *= 6;
   }
-  T8_ASSERT (p->pyramid.level >= 0);
+  T8_ASSERT (type == T8_DPYRAMID_ROOT_TYPE);
   return id;
 }
 
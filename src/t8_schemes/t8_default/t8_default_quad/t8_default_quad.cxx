@@ -23,7 +23,9 @@
 #include <p4est_bits.h>
 #include <t8_schemes/t8_default/t8_default_line/t8_dline_bits.h>
 #include <t8_schemes/t8_default/t8_default_common/t8_default_common.hxx>
+#include <t8_schemes/t8_default/t8_default_common/t8_default_morton.hxx>
 #include <t8_schemes/t8_default/t8_default_quad/t8_default_quad.hxx>
+#include <t8_schemes/t8_default/t8_default_traits.hxx>
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
@@ -247,7 +249,7 @@ t8_default_scheme_quad_c::t8_element_set_linear_id (t8_element_t *elem, int leve
   T8_ASSERT (0 <= level && level <= P4EST_QMAXLEVEL);
   T8_ASSERT (0 <= id && id < ((t8_linearidx_t) 1) << P4EST_DIM * level);
 
-  p4est_quadrant_set_morton ((p4est_quadrant_t *) elem, level, id);
+  t8_morton_quad_set_linear_id (morton_kernels, (p4est_quadrant_t *) elem, level, id);
   T8_QUAD_SET_TDIM ((p4est_quadrant_t *) elem, 2);
 }
 
@@ -257,7 +259,7 @@ t8_default_scheme_quad_c::t8_element_get_linear_id (const t8_element_t *elem, in
   T8_ASSERT (t8_element_is_valid (elem));
   T8_ASSERT (0 <= level && level <= P4EST_QMAXLEVEL);
 
-  return p4est_quadrant_linear_id ((p4est_quadrant_t *) elem, level);
+  return t8_morton_quad_linear_id (morton_kernels, (const p4est_quadrant_t *) elem, level);
 }
 
 void
@@ -769,6 +771,7 @@ t8_default_scheme_quad_c::t8_default_scheme_quad_c (void)
   eclass = T8_ECLASS_QUAD;
   element_size = sizeof (t8_pquad_t);
   ts_context = sc_mempool_new (element_size);
+  morton_kernels = t8_morton_get_kernels (t8_morton_kernel_select ());
 }
 
 t8_default_scheme_quad_c::~t8_default_scheme_quad_c ()
@@ -786,6 +789,96 @@ t8_default_scheme_quad_c::t8_element_root (t8_element_t *elem) const
   p4est_quadrant_set_morton (quad, 0, 0);
   T8_ASSERT (p4est_quadrant_is_extended (quad));
 }
+
+/* The functions on ranges of element arrays call the element functions of t8_scheme_traits<T8_ECLASS_QUAD>,
+ * such that the compiler can inline them and vectorize the loops over the quadrants. */
+
+void
+t8_default_scheme_quad_c::t8_element_levels_of_array (const t8_element_array_t *elements, const size_t first,
+                                                      const size_t count, int *levels) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_QUAD> traits (this);
+  const p4est_quadrant_t *q = (const p4est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    levels[ielem] = traits.t8_element_level ((const t8_element_t *) (q + ielem));
+  }
+}
+
+void
+t8_default_scheme_quad_c::t8_element_child_ids_of_array (const t8_element_array_t *elements, const size_t first,
+                                                         const size_t count, int *child_ids) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_QUAD> traits (this);
+  const p4est_quadrant_t *q = (const p4est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    child_ids[ielem] = traits.t8_element_child_id ((const t8_element_t *) (q + ielem));
+  }
+}
+
+void
+t8_default_scheme_quad_c::t8_element_linear_ids_of_array (const t8_element_array_t *elements, const size_t first,
+                                                          const size_t count, const int level,
+                                                          t8_linearidx_t *ids) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (0 <= level && level <= P4EST_QMAXLEVEL);
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_QUAD> traits (this);
+  const p4est_quadrant_t *q = (const p4est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    ids[ielem] = traits.t8_element_get_linear_id ((const t8_element_t *) (q + ielem), level);
+  }
+}
+
+void
+t8_default_scheme_quad_c::t8_element_parents_of_array (const t8_element_array_t *elements, const size_t first,
+                                                       const size_t count, t8_element_array_t *parents) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (count <= t8_element_array_get_count (parents));
+  T8_ASSERT (parents != elements);
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_QUAD> traits (this);
+  const p4est_quadrant_t *q = (const p4est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  p4est_quadrant_t *r = (p4est_quadrant_t *) t8_element_array_get_data_mutable (parents);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    traits.t8_element_parent ((const t8_element_t *) (q + ielem), (t8_element_t *) (r + ielem));
+  }
+}
+
+void
+t8_default_scheme_quad_c::t8_element_children_of_array (const t8_element_array_t *elements, const size_t first,
+                                                        const size_t count, t8_element_array_t *children) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (children != elements);
+  if (count == 0) {
+    return;
+  }
+  const t8_scheme_traits<T8_ECLASS_QUAD> traits (this);
+  p4est_quadrant_t *c = (p4est_quadrant_t *) t8_element_array_push_count (children, count * P4EST_CHILDREN);
+  const p4est_quadrant_t *q = (const p4est_quadrant_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  t8_element_t *family[P4EST_CHILDREN];
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    for (int ichild = 0; ichild < P4EST_CHILDREN; ichild++) {
+      family[ichild] = (t8_element_t *) (c + ielem * P4EST_CHILDREN + ichild);
+    }
+    traits.t8_element_children ((const t8_element_t *) (q + ielem), P4EST_CHILDREN, family);
+  }
+}
+
 /* each quad is packed as x,y coordinates and the level */
 void
 t8_default_scheme_quad_c::t8_element_MPI_Pack (t8_element_t **const elements, const unsigned int count,
@@ -36,6 +36,7 @@
 #include <t8_schemes/t8_default/t8_default_quad/t8_dquad_bits.h>
 #include <t8_schemes/t8_default/t8_default_line/t8_default_line.hxx>
 #include <t8_schemes/t8_default/t8_default_common/t8_default_common.hxx>
+#include <t8_schemes/t8_default/t8_default_common/t8_default_morton.hxx>
 
 /** The structure holding a quadrilateral element in the default scheme.
  * We make this definition public for interoperability of element classes.
@@ -622,6 +623,36 @@ struct t8_default_scheme_quad_c: public t8_default_scheme_common_c
   void
   t8_element_root (t8_element_t *elem) const;
 
+  /** Compute the levels of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_levels_of_array */
+  virtual void
+  t8_element_levels_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                              int *levels) const;
+
+  /** Compute the child ids of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_child_ids_of_array */
+  virtual void
+  t8_element_child_ids_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                 int *child_ids) const;
+
+  /** Compute the linear ids of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_linear_ids_of_array */
+  virtual void
+  t8_element_linear_ids_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                  const int level, t8_linearidx_t *ids) const;
+
+  /** Compute the parents of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_parents_of_array */
+  virtual void
+  t8_element_parents_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                               t8_element_array_t *parents) const;
+
+  /** Compute the children of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_children_of_array */
+  virtual void
+  t8_element_children_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                t8_element_array_t *children) const;
+
   /** Pack multiple elements into contiguous memory, so they can be sent via MPI.
    * \param [in] elements Array of elements that are to be packed
    * \param [in] count Number of elements to pack
@@ -653,4 +684,8 @@ struct t8_default_scheme_quad_c: public t8_default_scheme_common_c
   virtual void
   t8_element_MPI_Unpack (void *recvbuf, const int buffer_size, int *position, t8_element_t **elements,
                          const unsigned int count, sc_MPI_Comm comm) const;
+
+  /** The implementation of the Morton encoding that computes the linear ids.
+   * It is selected for this CPU when the scheme is constructed. */
+  const t8_morton_kernels_t *morton_kernels;
 };
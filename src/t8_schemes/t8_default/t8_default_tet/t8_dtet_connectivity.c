@@ -145,4 +145,69 @@ const int t8_dtet_parent_type_type_to_face[6][6] = {
   { 2, -1, 1, 3, -1, 0 }, 
   { 3, 1, -1, 2, 0, -1 } 
 };
+/* The multi-level versions of t8_dtet_type_cid_to_Iloc and t8_dtet_cid_type_to_parenttype.
+ * Line b, row c gives the local indices of the ancestors of levels l to l - 1
+ * of an element with type b at level l and the type of its ancestor of level l - 2.
+ * The row c contains the bits of the cube-ids of these levels: First the x-bits, then
+ * the y-bits and the z-bits, each with level l in the lowest bit. The entry stores the local index
+ * of level l - i in its digit i and the type above these digits. */
+const int t8_dtet_type_cids_to_Ilocs_type[6][64] = {
+  {   0,   1,   8,   9, 129,  68,  81,  76, 136, 137,  96,  97, 153, 148, 161, 108,
+    321,   4,  25,  12, 260,   7,  20,  15, 217, 140, 113, 100, 212, 143, 180, 103,
+    328, 329,  32,  33, 265, 340,  49,  44, 288, 289,  56,  57, 233, 228, 185, 124,
+    345, 332, 369,  36, 284, 335, 364,  39, 305, 292, 377,  60, 300, 295, 316,  63 },
+  {  64,  65,  72,  73, 130,  69,  82,  77, 144, 145, 104, 105, 154, 149, 162, 109,
+    322,   5,  26,  13, 196,  71,  92,  79, 218, 141, 114, 101, 204, 151, 172, 111,
+    336, 337,  40,  41, 266, 341,  50,  45, 224, 225, 120, 121, 234, 229, 186, 125,
+    346, 333, 370,  37, 276, 343, 356,  47, 306, 293, 378,  61, 244, 231, 252, 127 },
+  { 128,  66,  80,  74, 131, 132,  83,  84, 152, 146, 160, 106, 155, 156, 163, 164,
+    257,   6,  17,  14, 197, 135,  93,  87, 209, 142, 177, 102, 205, 159, 173, 167,
+    264, 338,  48,  42, 267, 268,  51,  52, 232, 226, 184, 122, 235, 236, 187, 188,
+    281, 334, 361,  38, 277, 271, 357,  55, 297, 294, 313,  62, 245, 239, 253, 191 },
+  { 192,  67,  88,  75, 193, 133,  89,  85, 200, 147, 168, 107, 201, 157, 169, 165,
+    258, 324,  18,  28, 198, 199,  94,  95, 210, 220, 178, 116, 206, 207, 174, 175,
+    272, 339, 352,  43, 273, 269, 353,  53, 240, 227, 248, 123, 241, 237, 249, 189,
+    282, 348, 362, 372, 278, 279, 358, 359, 298, 308, 314, 380, 246, 247, 254, 255 },
+  { 256,   2,  16,  10, 194, 134,  90,  86, 208, 138, 176,  98, 202, 158, 170, 166,
+    259, 325,  19,  29, 261, 263,  21,  23, 211, 221, 179, 117, 213, 215, 181, 183,
+    280, 330, 360,  34, 274, 270, 354,  54, 296, 290, 312,  58, 242, 238, 250, 190,
+    283, 349, 363, 373, 285, 287, 365, 367, 299, 309, 315, 381, 301, 303, 317, 319 },
+  { 320,   3,  24,  11, 195,  70,  91,  78, 216, 139, 112,  99, 203, 150, 171, 110,
+    323, 326,  27,  30, 262, 327,  22,  31, 219, 222, 115, 118, 214, 223, 182, 119,
+    344, 331, 368,  35, 275, 342, 355,  46, 304, 291, 376,  59, 243, 230, 251, 126,
+    347, 350, 371, 374, 286, 351, 366, 375, 307, 310, 379, 382, 302, 311, 318, 383 }
+};
+
+/* The multi-level versions of t8_dtet_parenttype_Iloc_to_cid and t8_dtet_parenttype_Iloc_to_type.
+ * Line b, row I gives the cube-ids of the descendants of levels l + 1 to l + 2 and the type
+ * of the descendant of level l + 2 of an element with type b at level l, where I contains the
+ * local indices of these descendants with level l + 2 in its lowest digit. The cube-ids are
+ * stored as in t8_dtet_type_cids_to_Ilocs_type, but with level l + 2 in the lowest bit. */
+const int t8_dtet_parenttype_Ilocs_to_cids_type[6][64] = {
+  {   0,   1, 257, 321,  17,  81, 145,  21,   2,   3, 259, 323,  19,  83, 147,  23,
+    258, 146, 210, 274,  22, 278, 342, 279, 322,  18,  82, 338, 211, 275, 339, 343,
+     34,  35, 291, 355,  51, 115, 179,  55,  98,  99, 163, 227,  39, 103, 359, 119,
+    162,  38, 102, 166, 167, 231, 295, 183,  42,  43, 299, 363,  59, 123, 187,  63 },
+  {  64,  65, 129, 193,   5,  69, 325,  85,  66,  67, 131, 195,   7,  71, 327,  87,
+    130,   6,  70, 134, 135, 199, 263, 151, 194, 198, 262, 326,  86, 150, 214, 215,
+     10,  11, 267, 331,  27,  91, 155,  31,  74,  75, 139, 203,  15,  79, 335,  95,
+    330,  26,  90, 346, 219, 283, 347, 351, 106, 107, 171, 235,  47, 111, 367, 127 },
+  { 128,   4,  68, 132, 133, 197, 261, 149,   8,   9, 265, 329,  25,  89, 153,  29,
+     72,  73, 137, 201,  13,  77, 333,  93, 136,  12,  76, 140, 141, 205, 269, 157,
+    138,  14,  78, 142, 143, 207, 271, 159, 202, 206, 270, 334,  94, 158, 222, 223,
+    266, 154, 218, 282,  30, 286, 350, 287, 170,  46, 110, 174, 175, 239, 303, 191 },
+  { 192, 196, 260, 324,  84, 148, 212, 213, 200, 204, 268, 332,  92, 156, 220, 221,
+    264, 152, 216, 280,  28, 284, 348, 285, 328,  24,  88, 344, 217, 281, 345, 349,
+    104, 105, 169, 233,  45, 109, 365, 125, 168,  44, 108, 172, 173, 237, 301, 189,
+    232, 236, 300, 364, 124, 188, 252, 253, 234, 238, 302, 366, 126, 190, 254, 255 },
+  { 256, 144, 208, 272,  20, 276, 340, 277, 160,  36, 100, 164, 165, 229, 293, 181,
+    224, 228, 292, 356, 116, 180, 244, 245, 288, 176, 240, 304,  52, 308, 372, 309,
+     40,  41, 297, 361,  57, 121, 185,  61, 296, 184, 248, 312,  60, 316, 380, 317,
+    360,  56, 120, 376, 249, 313, 377, 381, 298, 186, 250, 314,  62, 318, 382, 319 },
+  { 320,  16,  80, 336, 209, 273, 337, 341,  32,  33, 289, 353,  49, 113, 177,  53,
+     96,  97, 161, 225,  37, 101, 357, 117, 352,  48, 112, 368, 241, 305, 369, 373,
+    226, 230, 294, 358, 118, 182, 246, 247, 290, 178, 242, 306,  54, 310, 374, 311,
+    354,  50, 114, 370, 243, 307, 371, 375, 362,  58, 122, 378, 251, 315, 379, 383 }
+};
+
 /* clang-format on */
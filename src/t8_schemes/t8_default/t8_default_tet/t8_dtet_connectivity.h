@@ -34,6 +34,9 @@ T8_EXTERN_C_BEGIN ();
 /** The spatial dimension */
 #define T8_DTET_DIM (3)
 
+/** The number of levels that are traversed with one look-up in the multi-level tables. */
+#define T8_DTET_LOOKUP_LEVELS (2)
+
 /** Store the type of parent for each (cube-id,type) combination. */
 extern const int t8_dtet_cid_type_to_parenttype[8][6];
 
@@ -69,6 +72,14 @@ extern const int t8_dtet_parenttype_Iloc_to_type[6][8];
 /** Store the cube-id for each (parenttype,local Index) combination. */
 extern const int t8_dtet_parenttype_Iloc_to_cid[6][8];
 
+/** Store the local indices of the ancestors of 2 consecutive levels and the type above them
+ * for each (type,cube-ids) combination. \see t8_dtet_type_cid_to_Iloc */
+extern const int t8_dtet_type_cids_to_Ilocs_type[6][64];
+
+/** Store the cube-ids of the descendants of 2 consecutive levels and the type below them
+ * for each (parenttype,local indices) combination. \see t8_dtet_parenttype_Iloc_to_cid */
+extern const int t8_dtet_parenttype_Ilocs_to_cids_type[6][64];
+
 /** Store for each (type, face_index) the combination (category, type)
  *  of the respective boundary triangle.
  * I.e. {2, 1} means the boundary triangle is of category 2 and type 1.
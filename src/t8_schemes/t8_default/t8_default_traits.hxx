@@ -0,0 +1,538 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_default_traits.hxx
+ * Compile time access to the element functions of the default schemes.
+ * An algorithm that is written as a template over the traits of a scheme can be
+ * instantiated for each element class. If the forest uses the default scheme, the
+ * element functions are then called without the virtual function table and can be
+ * inlined by the compiler. The element class of a tree is dispatched once per tree
+ * with \ref t8_scheme_traits_dispatch.
+ */
+
+#pragma once
+
+#include <typeinfo>
+#include <p4est_bits.h>
+#include <p8est_bits.h>
+#include <t8_element.hxx>
+#include <t8_schemes/t8_default/t8_default_common/t8_default_common.hxx>
+#include <t8_schemes/t8_default/t8_default_common/t8_default_morton.hxx>
+#include <t8_schemes/t8_default/t8_default_quad/t8_default_quad.hxx>
+#include <t8_schemes/t8_default/t8_default_hex/t8_default_hex.hxx>
+#include <t8_schemes/t8_default/t8_default_tri/t8_default_tri.hxx>
+#include <t8_schemes/t8_default/t8_default_tri/t8_dtri_bits.h>
+#include <t8_schemes/t8_default/t8_default_tet/t8_default_tet.hxx>
+#include <t8_schemes/t8_default/t8_default_tet/t8_dtet_bits.h>
+
+/** The element functions of an arbitrary scheme.
+ * All functions call the virtual functions of the scheme.
+ * This is the fallback for schemes that do not have a specialization of \ref t8_scheme_traits.
+ * The specializations derive from this class, such that all functions that they do not
+ * implement themselves are still available.
+ */
+struct t8_scheme_traits_virtual
+{
+  explicit t8_scheme_traits_virtual (const t8_eclass_scheme_c *scheme): ts (scheme)
+  {
+  }
+
+  inline int
+  t8_element_level (const t8_element_t *elem) const
+  {
+    return ts->t8_element_level (elem);
+  }
+
+  inline t8_element_shape_t
+  t8_element_shape (const t8_element_t *elem) const
+  {
+    return ts->t8_element_shape (elem);
+  }
+
+  inline int
+  t8_element_num_children (const t8_element_t *elem) const
+  {
+    return ts->t8_element_num_children (elem);
+  }
+
+  inline int
+  t8_element_num_siblings (const t8_element_t *elem) const
+  {
+    return ts->t8_element_num_siblings (elem);
+  }
+
+  inline int
+  t8_element_is_family (t8_element_t *const *fam) const
+  {
+    return ts->t8_element_is_family (fam);
+  }
+
+  inline int
+  t8_element_child_id (const t8_element_t *elem) const
+  {
+    return ts->t8_element_child_id (elem);
+  }
+
+  inline int
+  t8_element_ancestor_id (const t8_element_t *elem, const int level) const
+  {
+    return ts->t8_element_ancestor_id (elem, level);
+  }
+
+  inline void
+  t8_element_parent (const t8_element_t *elem, t8_element_t *parent) const
+  {
+    ts->t8_element_parent (elem, parent);
+  }
+
+  inline void
+  t8_element_children (const t8_element_t *elem, const int length, t8_element_t *children[]) const
+  {
+    ts->t8_element_children (elem, length, children);
+  }
+
+  inline int
+  t8_element_equal (const t8_element_t *elem1, const t8_element_t *elem2) const
+  {
+    return ts->t8_element_equal (elem1, elem2);
+  }
+
+  inline t8_linearidx_t
+  t8_element_get_linear_id (const t8_element_t *elem, const int level) const
+  {
+    return ts->t8_element_get_linear_id (elem, level);
+  }
+
+  const t8_eclass_scheme_c *ts; /**< The scheme. Used for all functions that are not specialized. */
+};
+
+/** The element functions of the default scheme of an element class.
+ * Element classes without a specialization use the virtual functions of the scheme.
+ * \tparam eclass The element class of the scheme.
+ */
+template <t8_eclass_t eclass>
+struct t8_scheme_traits: public t8_scheme_traits_virtual
+{
+  using t8_scheme_traits_virtual::t8_scheme_traits_virtual;
+};
+
+/** The element functions of the default quad scheme, computed on the quadrant coordinates. */
+template <>
+struct t8_scheme_traits<T8_ECLASS_QUAD>: public t8_scheme_traits_virtual
+{
+  explicit t8_scheme_traits (const t8_eclass_scheme_c *scheme)
+    : t8_scheme_traits_virtual (scheme),
+      morton_kernels (static_cast<const t8_default_scheme_quad_c *> (scheme)->morton_kernels)
+  {
+  }
+
+  inline int
+  t8_element_level (const t8_element_t *elem) const
+  {
+    return ((const p4est_quadrant_t *) elem)->level;
+  }
+
+  inline t8_element_shape_t
+  t8_element_shape (const t8_element_t *elem) const
+  {
+    return T8_ECLASS_QUAD;
+  }
+
+  inline int
+  t8_element_num_children (const t8_element_t *elem) const
+  {
+    return P4EST_CHILDREN;
+  }
+
+  inline int
+  t8_element_num_siblings (const t8_element_t *elem) const
+  {
+    return P4EST_CHILDREN;
+  }
+
+  inline int
+  t8_element_is_family (t8_element_t *const *fam) const
+  {
+    return p4est_quadrant_is_familypv ((p4est_quadrant_t **) fam);
+  }
+
+  inline int
+  t8_element_ancestor_id (const t8_element_t *elem, const int level) const
+  {
+    const p4est_quadrant_t *q = (const p4est_quadrant_t *) elem;
+    T8_ASSERT (0 <= level && level <= q->level);
+    if (level == 0) {
+      return 0;
+    }
+    const p4est_qcoord_t h = P4EST_QUADRANT_LEN (level);
+    return ((q->x & h) ? 0x01 : 0) | ((q->y & h) ? 0x02 : 0);
+  }
+
+  inline int
+  t8_element_child_id (const t8_element_t *elem) const
+  {
+    return t8_element_ancestor_id (elem, t8_element_level (elem));
+  }
+
+  inline void
+  t8_element_parent (const t8_element_t *elem, t8_element_t *parent) const
+  {
+    const p4est_quadrant_t *q = (const p4est_quadrant_t *) elem;
+    p4est_quadrant_t *r = (p4est_quadrant_t *) parent;
+    T8_ASSERT (q->level > 0);
+    const p4est_qcoord_t h = P4EST_QUADRANT_LEN (q->level);
+    /* Copying the whole quadrant also copies the surround data. */
+    *r = *q;
+    r->x &= ~h;
+    r->y &= ~h;
+    r->level--;
+  }
+
+  inline void
+  t8_element_children (const t8_element_t *elem, const int length, t8_element_t *children[]) const
+  {
+    const p4est_quadrant_t *q = (const p4est_quadrant_t *) elem;
+    T8_ASSERT (length == P4EST_CHILDREN);
+    T8_ASSERT (q->level < P4EST_QMAXLEVEL);
+    const p4est_qcoord_t shift = P4EST_QUADRANT_LEN (q->level + 1);
+    /* Copy the parent first, since elem may be one of the children. */
+    const p4est_quadrant_t parent = *q;
+    for (int ichild = 0; ichild < P4EST_CHILDREN; ichild++) {
+      p4est_quadrant_t *child = (p4est_quadrant_t *) children[ichild];
+      *child = parent;
+      child->x = ichild & 0x01 ? (parent.x | shift) : parent.x;
+      child->y = ichild & 0x02 ? (parent.y | shift) : parent.y;
+      child->level = parent.level + 1;
+    }
+  }
+
+  inline int
+  t8_element_equal (const t8_element_t *elem1, const t8_element_t *elem2) const
+  {
+    return p4est_quadrant_is_equal ((const p4est_quadrant_t *) elem1, (const p4est_quadrant_t *) elem2);
+  }
+
+  inline t8_linearidx_t
+  t8_element_get_linear_id (const t8_element_t *elem, const int level) const
+  {
+    return t8_morton_quad_linear_id (morton_kernels, (const p4est_quadrant_t *) elem, level);
+  }
+
+  const t8_morton_kernels_t *morton_kernels; /**< The Morton encoding that the scheme selected. */
+};
+
+/** The element functions of the default hex scheme, computed on the octant coordinates. */
+template <>
+struct t8_scheme_traits<T8_ECLASS_HEX>: public t8_scheme_traits_virtual
+{
+  explicit t8_scheme_traits (const t8_eclass_scheme_c *scheme)
+    : t8_scheme_traits_virtual (scheme),
+      morton_kernels (static_cast<const t8_default_scheme_hex_c *> (scheme)->morton_kernels)
+  {
+  }
+
+  inline int
+  t8_element_level (const t8_element_t *elem) const
+  {
+    return ((const p8est_quadrant_t *) elem)->level;
+  }
+
+  inline t8_element_shape_t
+  t8_element_shape (const t8_element_t *elem) const
+  {
+    return T8_ECLASS_HEX;
+  }
+
+  inline int
+  t8_element_num_children (const t8_element_t *elem) const
+  {
+    return P8EST_CHILDREN;
+  }
+
+  inline int
+  t8_element_num_siblings (const t8_element_t *elem) const
+  {
+    return P8EST_CHILDREN;
+  }
+
+  inline int
+  t8_element_is_family (t8_element_t *const *fam) const
+  {
+    return p8est_quadrant_is_familypv ((p8est_quadrant_t **) fam);
+  }
+
+  inline int
+  t8_element_ancestor_id (const t8_element_t *elem, const int level) const
+  {
+    const p8est_quadrant_t *q = (const p8est_quadrant_t *) elem;
+    T8_ASSERT (0 <= level && level <= q->level);
+    if (level == 0) {
+      return 0;
+    }
+    const p4est_qcoord_t h = P8EST_QUADRANT_LEN (level);
+    return ((q->x & h) ? 0x01 : 0) | ((q->y & h) ? 0x02 : 0) | ((q->z & h) ? 0x04 : 0);
+  }
+
+  inline int
+  t8_element_child_id (const t8_element_t *elem) const
+  {
+    return t8_element_ancestor_id (elem, t8_element_level (elem));
+  }
+
+  inline void
+  t8_element_parent (const t8_element_t *elem, t8_element_t *parent) const
+  {
+    const p8est_quadrant_t *q = (const p8est_quadrant_t *) elem;
+    p8est_quadrant_t *r = (p8est_quadrant_t *) parent;
+    T8_ASSERT (q->level > 0);
+    const p4est_qcoord_t h = P8EST_QUADRANT_LEN (q->level);
+    *r = *q;
+    r->x &= ~h;
+    r->y &= ~h;
+    r->z &= ~h;
+    r->level--;
+  }
+
+  inline void
+  t8_element_children (const t8_element_t *elem, const int length, t8_element_t *children[]) const
+  {
+    const p8est_quadrant_t *q = (const p8est_quadrant_t *) elem;
+    T8_ASSERT (length == P8EST_CHILDREN);
+    T8_ASSERT (q->level < P8EST_QMAXLEVEL);
+    const p4est_qcoord_t shift = P8EST_QUADRANT_LEN (q->level + 1);
+    /* Copy the parent first, since elem may be one of the children. */
+    const p8est_quadrant_t parent = *q;
+    for (int ichild = 0; ichild < P8EST_CHILDREN; ichild++) {
+      p8est_quadrant_t *child = (p8est_quadrant_t *) children[ichild];
+      *child = parent;
+      child->x = ichild & 0x01 ? (parent.x | shift) : parent.x;
+      child->y = ichild & 0x02 ? (parent.y | shift) : parent.y;
+      child->z = ichild & 0x04 ? (parent.z | shift) : parent.z;
+      child->level = parent.level + 1;
+    }
+  }
+
+  inline int
+  t8_element_equal (const t8_element_t *elem1, const t8_element_t *elem2) const
+  {
+    return p8est_quadrant_is_equal ((const p8est_quadrant_t *) elem1, (const p8est_quadrant_t *) elem2);
+  }
+
+  inline t8_linearidx_t
+  t8_element_get_linear_id (const t8_element_t *elem, const int level) const
+  {
+    return t8_morton_hex_linear_id (morton_kernels, (const p8est_quadrant_t *) elem, level);
+  }
+
+  const t8_morton_kernels_t *morton_kernels; /**< The Morton encoding that the scheme selected. */
+};
+
+/** The element functions of the default triangle scheme, calling the dtri functions directly. */
+template <>
+struct t8_scheme_traits<T8_ECLASS_TRIANGLE>: public t8_scheme_traits_virtual
+{
+  using t8_scheme_traits_virtual::t8_scheme_traits_virtual;
+
+  inline int
+  t8_element_level (const t8_element_t *elem) const
+  {
+    return ((const t8_dtri_t *) elem)->level;
+  }
+
+  inline t8_element_shape_t
+  t8_element_shape (const t8_element_t *elem) const
+  {
+    return T8_ECLASS_TRIANGLE;
+  }
+
+  inline int
+  t8_element_num_children (const t8_element_t *elem) const
+  {
+    return T8_DTRI_CHILDREN;
+  }
+
+  inline int
+  t8_element_num_siblings (const t8_element_t *elem) const
+  {
+    return T8_DTRI_CHILDREN;
+  }
+
+  inline int
+  t8_element_is_family (t8_element_t *const *fam) const
+  {
+    return t8_dtri_is_familypv ((const t8_dtri_t **) fam);
+  }
+
+  inline int
+  t8_element_ancestor_id (const t8_element_t *elem, const int level) const
+  {
+    return t8_dtri_ancestor_id ((const t8_dtri_t *) elem, level);
+  }
+
+  inline int
+  t8_element_child_id (const t8_element_t *elem) const
+  {
+    return t8_dtri_child_id ((const t8_dtri_t *) elem);
+  }
+
+  inline void
+  t8_element_parent (const t8_element_t *elem, t8_element_t *parent) const
+  {
+    t8_dtri_parent ((const t8_dtri_t *) elem, (t8_dtri_t *) parent);
+  }
+
+  inline void
+  t8_element_children (const t8_element_t *elem, const int length, t8_element_t *children[]) const
+  {
+    T8_ASSERT (length == T8_DTRI_CHILDREN);
+    t8_dtri_childrenpv ((const t8_dtri_t *) elem, (t8_dtri_t **) children);
+  }
+
+  inline int
+  t8_element_equal (const t8_element_t *elem1, const t8_element_t *elem2) const
+  {
+    return t8_dtri_is_equal ((const t8_dtri_t *) elem1, (const t8_dtri_t *) elem2);
+  }
+
+  inline t8_linearidx_t
+  t8_element_get_linear_id (const t8_element_t *elem, const int level) const
+  {
+    return t8_dtri_linear_id ((const t8_dtri_t *) elem, level);
+  }
+};
+
+/** The element functions of the default tet scheme, calling the dtet functions directly. */
+template <>
+struct t8_scheme_traits<T8_ECLASS_TET>: public t8_scheme_traits_virtual
+{
+  using t8_scheme_traits_virtual::t8_scheme_traits_virtual;
+
+  inline int
+  t8_element_level (const t8_element_t *elem) const
+  {
+    return ((const t8_dtet_t *) elem)->level;
+  }
+
+  inline t8_element_shape_t
+  t8_element_shape (const t8_element_t *elem) const
+  {
+    return T8_ECLASS_TET;
+  }
+
+  inline int
+  t8_element_num_children (const t8_element_t *elem) const
+  {
+    return T8_DTET_CHILDREN;
+  }
+
+  inline int
+  t8_element_num_siblings (const t8_element_t *elem) const
+  {
+    return T8_DTET_CHILDREN;
+  }
+
+  inline int
+  t8_element_is_family (t8_element_t *const *fam) const
+  {
+    return t8_dtet_is_familypv ((const t8_dtet_t **) fam);
+  }
+
+  inline int
+  t8_element_ancestor_id (const t8_element_t *elem, const int level) const
+  {
+    return t8_dtet_ancestor_id ((const t8_dtet_t *) elem, level);
+  }
+
+  inline int
+  t8_element_child_id (const t8_element_t *elem) const
+  {
+    return t8_dtet_child_id ((const t8_dtet_t *) elem);
+  }
+
+  inline void
+  t8_element_parent (const t8_element_t *elem, t8_element_t *parent) const
+  {
+    t8_dtet_parent ((const t8_dtet_t *) elem, (t8_dtet_t *) parent);
+  }
+
+  inline void
+  t8_element_children (const t8_element_t *elem, const int length, t8_element_t *children[]) const
+  {
+    T8_ASSERT (length == T8_DTET_CHILDREN);
+    t8_dtet_childrenpv ((const t8_dtet_t *) elem, (t8_dtet_t **) children);
+  }
+
+  inline int
+  t8_element_equal (const t8_element_t *elem1, const t8_element_t *elem2) const
+  {
+    return t8_dtet_is_equal ((const t8_dtet_t *) elem1, (const t8_dtet_t *) elem2);
+  }
+
+  inline t8_linearidx_t
+  t8_element_get_linear_id (const t8_element_t *elem, const int level) const
+  {
+    return t8_dtet_linear_id ((const t8_dtet_t *) elem, level);
+  }
+};
+
+/** Call a kernel with the traits of a scheme.
+ * If \a ts is a default scheme for which \ref t8_scheme_traits is specialized, the kernel
+ * is called with this specialization. Otherwise, it is called with \ref t8_scheme_traits_virtual.
+ * We compare the dynamic type of \a ts exactly, such that subclasses of the default schemes that
+ * override element functions are called through the virtual functions.
+ * Thus, the kernel is instantiated once per specialization and the element class is
+ * dispatched only once per call, for example once per tree.
+ * \param [in] ts      A scheme.
+ * \param [in] kernel  A callable object with a templated argument, for example a generic lambda
+ *                     <tt>[&] (const auto &traits) { ... }</tt>.
+ * \return             The return value of \a kernel.
+ */
+template <typename Kernel>
+inline decltype (auto)
+t8_scheme_traits_dispatch (const t8_eclass_scheme_c *ts, Kernel &&kernel)
+{
+  switch (ts->eclass) {
+  case T8_ECLASS_QUAD:
+    if (typeid (*ts) == typeid (t8_default_scheme_quad_c)) {
+      return kernel (t8_scheme_traits<T8_ECLASS_QUAD> (ts));
+    }
+    break;
+  case T8_ECLASS_HEX:
+    if (typeid (*ts) == typeid (t8_default_scheme_hex_c)) {
+      return kernel (t8_scheme_traits<T8_ECLASS_HEX> (ts));
+    }
+    break;
+  case T8_ECLASS_TRIANGLE:
+    if (typeid (*ts) == typeid (t8_default_scheme_tri_c)) {
+      return kernel (t8_scheme_traits<T8_ECLASS_TRIANGLE> (ts));
+    }
+    break;
+  case T8_ECLASS_TET:
+    if (typeid (*ts) == typeid (t8_default_scheme_tet_c)) {
+      return kernel (t8_scheme_traits<T8_ECLASS_TET> (ts));
+    }
+    break;
+  default:
+    break;
+  }
+  return kernel (t8_scheme_traits_virtual (ts));
+}
@@ -569,6 +569,90 @@ t8_default_scheme_tri_c::t8_element_root (t8_element_t *elem) const
   tri->y = 0;
   tri->type = 0;
 }
+
+/* The functions on ranges of element arrays call the triangle functions directly,
+ * such that no virtual function call is needed per element. */
+
+void
+t8_default_scheme_tri_c::t8_element_levels_of_array (const t8_element_array_t *elements, const size_t first,
+                                                     const size_t count, int *levels) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  if (count == 0) {
+    return;
+  }
+  const t8_dtri_t *t = (const t8_dtri_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    levels[ielem] = (int) t[ielem].level;
+  }
+}
+
+void
+t8_default_scheme_tri_c::t8_element_child_ids_of_array (const t8_element_array_t *elements, const size_t first,
+                                                        const size_t count, int *child_ids) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  if (count == 0) {
+    return;
+  }
+  const t8_dtri_t *t = (const t8_dtri_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    child_ids[ielem] = t8_dtri_child_id ((t8_dtri_t *) t + ielem);
+  }
+}
+
+void
+t8_default_scheme_tri_c::t8_element_linear_ids_of_array (const t8_element_array_t *elements, const size_t first,
+                                                         const size_t count, const int level, t8_linearidx_t *ids) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (0 <= level && level <= T8_DTRI_MAXLEVEL);
+  if (count == 0) {
+    return;
+  }
+  const t8_dtri_t *t = (const t8_dtri_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    ids[ielem] = t8_dtri_linear_id ((t8_dtri_t *) t + ielem, level);
+  }
+}
+
+void
+t8_default_scheme_tri_c::t8_element_parents_of_array (const t8_element_array_t *elements, const size_t first,
+                                                      const size_t count, t8_element_array_t *parents) const
+{
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (count <= t8_element_array_get_count (parents));
+  T8_ASSERT (parents != elements);
+  if (count == 0) {
+    return;
+  }
+  const t8_dtri_t *t = (const t8_dtri_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  t8_dtri_t *p = (t8_dtri_t *) t8_element_array_get_data_mutable (parents);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    t8_dtri_parent (t + ielem, p + ielem);
+  }
+}
+
+void
+t8_default_scheme_tri_c::t8_element_children_of_array (const t8_element_array_t *elements, const size_t first,
+                                                       const size_t count, t8_element_array_t *children) const
+{
+  t8_dtri_t *c[T8_DTRI_CHILDREN];
+
+  T8_ASSERT (first + count <= t8_element_array_get_count (elements));
+  T8_ASSERT (children != elements);
+  if (count == 0) {
+    return;
+  }
+  t8_dtri_t *first_child = (t8_dtri_t *) t8_element_array_push_count (children, count * T8_DTRI_CHILDREN);
+  const t8_dtri_t *t = (const t8_dtri_t *) t8_element_array_index_locidx (elements, (t8_locidx_t) first);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    for (int ichild = 0; ichild < T8_DTRI_CHILDREN; ichild++) {
+      c[ichild] = first_child + ielem * T8_DTRI_CHILDREN + ichild;
+    }
+    t8_dtri_childrenpv (t + ielem, c);
+  }
+}
 /* use macro tri functionality */
 void
 t8_default_scheme_tri_c::t8_element_MPI_Pack (t8_element_t **const elements, const unsigned int count,
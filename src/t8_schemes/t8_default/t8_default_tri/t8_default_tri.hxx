@@ -524,6 +524,36 @@ struct t8_default_scheme_tri_c: public t8_default_scheme_common_c
   void
   t8_element_root (t8_element_t *elem) const;
 
+  /** Compute the levels of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_levels_of_array */
+  virtual void
+  t8_element_levels_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                              int *levels) const;
+
+  /** Compute the child ids of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_child_ids_of_array */
+  virtual void
+  t8_element_child_ids_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                 int *child_ids) const;
+
+  /** Compute the linear ids of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_linear_ids_of_array */
+  virtual void
+  t8_element_linear_ids_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                  const int level, t8_linearidx_t *ids) const;
+
+  /** Compute the parents of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_parents_of_array */
+  virtual void
+  t8_element_parents_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                               t8_element_array_t *parents) const;
+
+  /** Compute the children of a range of elements of an element array.
+   * \see t8_eclass_scheme::t8_element_children_of_array */
+  virtual void
+  t8_element_children_of_array (const t8_element_array_t *elements, const size_t first, const size_t count,
+                                t8_element_array_t *children) const;
+
   /** Pack multiple elements into contiguous memory, so they can be sent via MPI.
    * \param [in] elements Array of elements that are to be packed
    * \param [in] count Number of elements to pack
@@ -30,6 +30,11 @@
 
 typedef int8_t t8_dtri_cube_id_t;
 
+/* The number of bits of the cube-ids, resp. local indices, of T8_DTRI_LOOKUP_LEVELS levels
+ * in the multi-level lookup tables. The type is stored above these bits. */
+#define T8_DTRI_LOOKUP_BITS (T8_DTRI_DIM * T8_DTRI_LOOKUP_LEVELS)
+#define T8_DTRI_LOOKUP_MASK ((1 << T8_DTRI_LOOKUP_BITS) - 1)
+
 /* Compute the cube-id of t's ancestor of level "level" in constant time.
  * If "level" is greater then t->level then the cube-id 0 is returned. */
 static t8_dtri_cube_id_t
@@ -56,6 +61,25 @@ compute_cubeid (const t8_dtri_t *t, int level)
   return id;
 }
 
+/* Compute the cube-ids of t's ancestors of the levels "level" down to "level" - T8_DTRI_LOOKUP_LEVELS + 1
+ * as a row index of the multi-level lookup tables, i.e. the bits of the x-coordinate at these levels,
+ * followed by the bits of the y- (and z-) coordinate. */
+static int
+compute_cubeids_lookup (const t8_dtri_t *t, int level)
+{
+  const int shift = T8_DTRI_MAXLEVEL - level;
+  const int mask = (1 << T8_DTRI_LOOKUP_LEVELS) - 1;
+  int cids;
+
+  T8_ASSERT (T8_DTRI_LOOKUP_LEVELS <= level && level <= T8_DTRI_MAXLEVEL);
+  cids = (t->x >> shift) & mask;
+  cids |= ((t->y >> shift) & mask) << T8_DTRI_LOOKUP_LEVELS;
+#ifdef T8_DTRI_TO_DTET
+  cids |= ((t->z >> shift) & mask) << (2 * T8_DTRI_LOOKUP_LEVELS);
+#endif
+  return cids;
+}
+
 /* A routine to compute the type of t's ancestor of level "level", if its type at an intermediate level is already 
  * known. If "level" equals t's level then t's type is returned. It is not allowed to call this function with "level" 
  * greater than t->level. This method runs in O(t->level - level).
@@ -77,7 +101,11 @@ compute_type_ext (const t8_dtri_t *t, int level, t8_dtri_type_t known_type, int
      *       maybe once we want to allow the root tet to have different types */
     return 0;
   }
-  for (i = known_level; i > level; i--) {
+  /* Ascend T8_DTRI_LOOKUP_LEVELS levels with each look-up */
+  for (i = known_level; i - T8_DTRI_LOOKUP_LEVELS >= level; i -= T8_DTRI_LOOKUP_LEVELS) {
+    type = t8_dtri_type_cids_to_Ilocs_type[type][compute_cubeids_lookup (t, i)] >> T8_DTRI_LOOKUP_BITS;
+  }
+  for (; i > level; i--) {
     cid = compute_cubeid (t, i);
     /* compute type as the type of T^{i+1}, that is T's ancestor of level i+1 */
     type = t8_dtri_cid_type_to_parenttype[cid][type];
@@ -95,6 +123,84 @@ compute_type (const t8_dtri_t *t, int level)
   return compute_type_ext (t, level, t->type, t->level);
 }
 
+/* Compute the local indices of t's ancestors of the levels "start_level" to "level". The local index of the
+ * ancestor of level i is stored in the digit "level" - i of the returned index. On input "type" is the type of
+ * t's ancestor of level "level", on output it is the type of t's ancestor of level "start_level" - 1.
+ */
+static t8_linearidx_t
+compute_local_indices (const t8_dtri_t *t, int level, const int start_level, t8_dtri_type_t *type)
+{
+  t8_linearidx_t id = 0;
+  t8_dtri_cube_id_t cid;
+  int lookup;
+  int exponent = 0;
+  int i;
+
+  T8_ASSERT (1 <= start_level && level <= T8_DTRI_MAXLEVEL);
+  /* Add the local indices of T8_DTRI_LOOKUP_LEVELS levels with each look-up */
+  for (i = level; i - T8_DTRI_LOOKUP_LEVELS + 1 >= start_level; i -= T8_DTRI_LOOKUP_LEVELS) {
+    lookup = t8_dtri_type_cids_to_Ilocs_type[*type][compute_cubeids_lookup (t, i)];
+    id |= ((t8_linearidx_t) (lookup & T8_DTRI_LOOKUP_MASK)) << exponent;
+    exponent += T8_DTRI_LOOKUP_BITS;
+    *type = lookup >> T8_DTRI_LOOKUP_BITS;
+  }
+  for (; i >= start_level; i--) {
+    cid = compute_cubeid (t, i);
+    id |= ((t8_linearidx_t) t8_dtri_type_cid_to_Iloc[*type][cid]) << exponent;
+    exponent += T8_DTRI_DIM; /* multiply with 4 (2d) resp. 8  (3d) */
+    *type = t8_dtri_cid_type_to_parenttype[cid][*type];
+  }
+  return id;
+}
+
+/* Set the coordinates of t at the levels "start_level" to "end_level" from the local indices of t's ancestors
+ * of these levels. The local index of the ancestor of level i is stored in the digit "end_level" - i of "id".
+ * "type" is the type of t's ancestor of level "start_level" - 1. Returns the type of t's ancestor of level
+ * "end_level".
+ */
+static t8_dtri_type_t
+set_local_indices (t8_dtri_t *t, t8_linearidx_t id, const int start_level, const int end_level, t8_dtri_type_t type)
+{
+  const int children_m1 = T8_DTRI_CHILDREN - 1;
+  const int mask = (1 << T8_DTRI_LOOKUP_LEVELS) - 1;
+  int i;
+  int offset_coords, offset_index;
+  int lookup;
+  t8_linearidx_t local_index;
+  t8_dtri_cube_id_t cid;
+
+  /* Set the coordinates of T8_DTRI_LOOKUP_LEVELS levels with each look-up */
+  for (i = start_level; i + T8_DTRI_LOOKUP_LEVELS - 1 <= end_level; i += T8_DTRI_LOOKUP_LEVELS) {
+    offset_coords = T8_DTRI_MAXLEVEL - (i + T8_DTRI_LOOKUP_LEVELS - 1);
+    offset_index = end_level - (i + T8_DTRI_LOOKUP_LEVELS - 1);
+    /* Get the local indices of T's ancestors on level i to i + T8_DTRI_LOOKUP_LEVELS - 1 */
+    local_index = (id >> (T8_DTRI_DIM * offset_index)) & T8_DTRI_LOOKUP_MASK;
+    /* Get the type and cube-ids of these ancestors */
+    lookup = t8_dtri_parenttype_Ilocs_to_cids_type[type][local_index];
+    t->x |= (lookup & mask) << offset_coords;
+    t->y |= ((lookup >> T8_DTRI_LOOKUP_LEVELS) & mask) << offset_coords;
+#ifdef T8_DTRI_TO_DTET
+    t->z |= ((lookup >> (2 * T8_DTRI_LOOKUP_LEVELS)) & mask) << offset_coords;
+#endif
+    type = lookup >> T8_DTRI_LOOKUP_BITS;
+  }
+  for (; i <= end_level; i++) {
+    offset_coords = T8_DTRI_MAXLEVEL - i;
+    offset_index = end_level - i;
+    /* Get the local index of T's ancestor on level i */
+    local_index = (id >> (T8_DTRI_DIM * offset_index)) & children_m1;
+    /* Get the type and cube-id of T's ancestor on level i */
+    cid = t8_dtri_parenttype_Iloc_to_cid[type][local_index];
+    type = t8_dtri_parenttype_Iloc_to_type[type][local_index];
+    t->x |= (cid & 1) ? 1 << offset_coords : 0;
+    t->y |= (cid & 2) ? 1 << offset_coords : 0;
+#ifdef T8_DTRI_TO_DTET
+    t->z |= (cid & 4) ? 1 << offset_coords : 0;
+#endif
+  }
+  return type;
+}
+
 void
 t8_dtri_copy (const t8_dtri_t *t, t8_dtri_t *dest)
 {
@@ -1416,32 +1522,46 @@ t8_dtri_linear_id_corner_desc (const t8_dtri_t *t, int corner, int level)
 t8_linearidx_t
 t8_dtri_linear_id (const t8_dtri_t *t, int level)
 {
-  t8_linearidx_t id = 0;
-  int8_t type_temp = 0;
-  t8_dtri_cube_id_t cid;
-  int i;
+  t8_dtri_type_t type_temp;
   int exponent;
-  int my_level;
 
   T8_ASSERT (0 <= level && level <= T8_DTRI_MAXLEVEL);
-  my_level = t->level;
   exponent = 0;
   /* If the given level is bigger than t's level
    * we first fill up with the ids of t's descendants at t's
    * origin with the same type as t */
-  if (level > my_level) {
-    exponent = (level - my_level) * T8_DTRI_DIM;
+  if (level > t->level) {
+    exponent = (level - t->level) * T8_DTRI_DIM;
     type_temp = t->type;
-    level = my_level;
+    level = t->level;
   }
   else {
     type_temp = compute_type (t, level);
   }
-  for (i = level; i > 0; i--) {
-    cid = compute_cubeid (t, i);
-    id |= ((t8_linearidx_t) t8_dtri_type_cid_to_Iloc[type_temp][cid]) << exponent;
-    exponent += T8_DTRI_DIM; /* multiply with 4 (2d) resp. 8  (3d) */
-    type_temp = t8_dtri_cid_type_to_parenttype[cid][type_temp];
+  return compute_local_indices (t, level, 1, &type_temp) << exponent;
+}
+
+t8_linearidx_t
+t8_dtri_linear_id_with_level (const t8_dtri_t *t, int level, const int start_level, t8_dtri_type_t *parenttype)
+{
+  t8_dtri_type_t type_temp;
+  t8_linearidx_t id;
+  int exponent;
+
+  T8_ASSERT (0 <= level && level <= T8_DTRI_MAXLEVEL);
+  T8_ASSERT (1 <= start_level && start_level <= level + 1);
+  exponent = 0;
+  if (level > t->level) {
+    exponent = (level - t->level) * T8_DTRI_DIM;
+    type_temp = t->type;
+    level = t->level;
+  }
+  else {
+    type_temp = compute_type (t, level);
+  }
+  id = compute_local_indices (t, level, start_level, &type_temp) << exponent;
+  if (parenttype != NULL) {
+    *parenttype = type_temp;
   }
   return id;
 }
@@ -1450,46 +1570,18 @@ void
 t8_dtri_init_linear_id_with_level (t8_dtri_t *t, t8_linearidx_t id, const int start_level, const int end_level,
                                    t8_dtri_type_t parenttype)
 {
-  int i;
-  int offset_coords, offset_index;
-  const int children_m1 = T8_DTRI_CHILDREN - 1;
-  t8_linearidx_t local_index;
-  t8_dtri_cube_id_t cid;
-  t8_dtri_type_t type;
   T8_ASSERT (0 <= id && id <= ((t8_linearidx_t) 1) << (T8_DTRI_DIM * end_level));
   /*Ensure, that the function is called with a valid element */
   T8_ASSERT (t->level == start_level);
   T8_ASSERT (t8_dtri_is_valid (t));
 
   t->level = end_level;
-
-  type = parenttype; /* This is the type of the parent triangle */
-  for (i = start_level; i <= end_level; i++) {
-    offset_coords = T8_DTRI_MAXLEVEL - i;
-    offset_index = end_level - i;
-    /* Get the local index of T's ancestor on level i */
-    local_index = (id >> (T8_DTRI_DIM * offset_index)) & children_m1;
-    /* Get the type and cube-id of T's ancestor on level i */
-    cid = t8_dtri_parenttype_Iloc_to_cid[type][local_index];
-    type = t8_dtri_parenttype_Iloc_to_type[type][local_index];
-    t->x |= (cid & 1) ? 1 << offset_coords : 0;
-    t->y |= (cid & 2) ? 1 << offset_coords : 0;
-#ifdef T8_DTRI_TO_DTET
-    t->z |= (cid & 4) ? 1 << offset_coords : 0;
-#endif
-  }
-  t->type = type;
+  t->type = set_local_indices (t, id, start_level, end_level, parenttype);
 }
 
 void
 t8_dtri_init_linear_id (t8_dtri_t *t, t8_linearidx_t id, int level)
 {
-  int i;
-  int offset_coords, offset_index;
-  const int children_m1 = T8_DTRI_CHILDREN - 1;
-  t8_linearidx_t local_index;
-  t8_dtri_cube_id_t cid;
-  t8_dtri_type_t type;
   T8_ASSERT (0 <= id && id <= ((t8_linearidx_t) 1) << (T8_DTRI_DIM * level));
 
   t->level = level;
@@ -1498,22 +1590,8 @@ t8_dtri_init_linear_id (t8_dtri_t *t, t8_linearidx_t id, int level)
 #ifdef T8_DTRI_TO_DTET
   t->z = 0;
 #endif
-  type = 0; /* This is the type of the root triangle */
-  for (i = 1; i <= level; i++) {
-    offset_coords = T8_DTRI_MAXLEVEL - i;
-    offset_index = level - i;
-    /* Get the local index of T's ancestor on level i */
-    local_index = (id >> (T8_DTRI_DIM * offset_index)) & children_m1;
-    /* Get the type and cube-id of T's ancestor on level i */
-    cid = t8_dtri_parenttype_Iloc_to_cid[type][local_index];
-    type = t8_dtri_parenttype_Iloc_to_type[type][local_index];
-    t->x |= (cid & 1) ? 1 << offset_coords : 0;
-    t->y |= (cid & 2) ? 1 << offset_coords : 0;
-#ifdef T8_DTRI_TO_DTET
-    t->z |= (cid & 4) ? 1 << offset_coords : 0;
-#endif
-  }
-  t->type = type;
+  /* 0 is the type of the root triangle */
+  t->type = set_local_indices (t, id, 1, level, 0);
 }
 
 void
@@ -291,6 +291,18 @@ t8_dtri_is_ancestor (const t8_dtri_t *t, const t8_dtri_t *c);
 t8_linearidx_t
 t8_dtri_linear_id (const t8_dtri_t *t, int level);
 
+/**
+ * Same as linear_id, but we only consider the subtree of the ancestor of \a t of level \a start_level - 1.
+ * Used for computing the index of a tetrahedron lying in a pyramid. Inverse of init_linear_id_with_level.
+ * \param [in] t            Triangle whose id will be computed.
+ * \param [in] level        Level of uniform grid to be considered.
+ * \param [in] start_level  The level of the first local index that is considered, at least 1.
+ * \param [out] parenttype  If not NULL, the type of the ancestor of \a t of level \a start_level - 1.
+ * \return                  The local indices of the ancestors of \a t of the levels \a start_level to \a level.
+ */
+t8_linearidx_t
+t8_dtri_linear_id_with_level (const t8_dtri_t *t, int level, const int start_level, t8_dtri_type_t *parenttype);
+
 /**
  * Same as init_linear_id, but we only consider the subtree. Used for computing the index of a tetrahedron lying in a 
  * pyramid
@@ -89,4 +89,37 @@ const int t8_dtri_corner_face[3][2] = {
   { 0, 2 }, 
   { 0, 1 } };
 
+/* The multi-level versions of t8_dtri_type_cid_to_Iloc and t8_dtri_cid_type_to_parenttype.
+ * Line b, row c gives the local indices of the ancestors of levels l to l - 2
+ * of an element with type b at level l and the type of its ancestor of level l - 3.
+ * The row c contains the bits of the cube-ids of these levels: First the x-bits, then
+ * the y-bits, each with level l in the lowest bit. The entry stores the local index
+ * of level l - i in its digit i and the type above these digits. */
+const int t8_dtri_type_cids_to_Ilocs_type[2][64] = {
+  {   0,   1,   4,   5,  16,  17,  20,  21,  65,   3,   9,   7,  33,  19,  25,  23,
+     68,  69,  12,  13,  36,  37,  28,  29,  73,  71,  77,  15,  41,  39,  45,  31,
+     80,  81,  84,  85,  48,  49,  52,  53,  97,  83,  89,  87, 113,  51,  57,  55,
+    100, 101,  92,  93, 116, 117,  60,  61, 105, 103, 109,  95, 121, 119, 125,  63 },
+  {  64,   2,   8,   6,  32,  18,  24,  22,  66,  67,  10,  11,  34,  35,  26,  27,
+     72,  70,  76,  14,  40,  38,  44,  30,  74,  75,  78,  79,  42,  43,  46,  47,
+     96,  82,  88,  86, 112,  50,  56,  54,  98,  99,  90,  91, 114, 115,  58,  59,
+    104, 102, 108,  94, 120, 118, 124,  62, 106, 107, 110, 111, 122, 123, 126, 127 }
+};
+
+/* The multi-level versions of t8_dtri_parenttype_Iloc_to_cid and t8_dtri_parenttype_Iloc_to_type.
+ * Line b, row I gives the cube-ids of the descendants of levels l + 1 to l + 3 and the type
+ * of the descendant of level l + 3 of an element with type b at level l, where I contains the
+ * local indices of these descendants with level l + 3 in its lowest digit. The cube-ids are
+ * stored as in t8_dtri_type_cids_to_Ilocs_type, but with level l + 3 in the lowest bit. */
+const int t8_dtri_parenttype_Ilocs_to_cids_type[2][64] = {
+  {   0,   1,  65,   9,   2,   3,  67,  11,  66,  10,  74,  75,  18,  19,  83,  27,
+      4,   5,  69,  13,   6,   7,  71,  15,  70,  14,  78,  79,  22,  23,  87,  31,
+     68,  12,  76,  77,  20,  21,  85,  29,  84,  28,  92,  93,  86,  30,  94,  95,
+     36,  37, 101,  45,  38,  39, 103,  47, 102,  46, 110, 111,  54,  55, 119,  63 },
+  {  64,   8,  72,  73,  16,  17,  81,  25,  80,  24,  88,  89,  82,  26,  90,  91,
+     32,  33,  97,  41,  34,  35,  99,  43,  98,  42, 106, 107,  50,  51, 115,  59,
+     96,  40, 104, 105,  48,  49, 113,  57, 112,  56, 120, 121, 114,  58, 122, 123,
+    100,  44, 108, 109,  52,  53, 117,  61, 116,  60, 124, 125, 118,  62, 126, 127 }
+};
+
 /* clang-format on*/
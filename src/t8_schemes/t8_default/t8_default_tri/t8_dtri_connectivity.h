@@ -33,6 +33,9 @@ T8_EXTERN_C_BEGIN ();
 /** The spatial dimension */
 #define T8_DTRI_DIM (2)
 
+/** The number of levels that are traversed with one look-up in the multi-level tables. */
+#define T8_DTRI_LOOKUP_LEVELS (3)
+
 /** Store the type of parent for each (cube-id,type) combination. */
 extern const int t8_dtri_cid_type_to_parenttype[4][2];
 
@@ -68,6 +71,14 @@ extern const int t8_dtri_parenttype_Iloc_to_type[2][4];
 /** Store the cube-id for each (parenttype,local Index) combination. */
 extern const int t8_dtri_parenttype_Iloc_to_cid[2][4];
 
+/** Store the local indices of the ancestors of 3 consecutive levels and the type above them
+ * for each (type,cube-ids) combination. \see t8_dtri_type_cid_to_Iloc */
+extern const int t8_dtri_type_cids_to_Ilocs_type[2][64];
+
+/** Store the cube-ids of the descendants of 3 consecutive levels and the type below them
+ * for each (parenttype,local indices) combination. \see t8_dtri_parenttype_Iloc_to_cid */
+extern const int t8_dtri_parenttype_Ilocs_to_cids_type[2][64];
+
 /** Store the indices of the corner of each face of a triangle. */
 extern const int t8_dtri_face_corner[3][2];
 
@@ -0,0 +1,170 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_vtk/t8_vtk_async.h>
+#include <t8_vtk/t8_vtk_write_binary.hxx>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/** The state of an asynchronous output pipeline. All members except io_thread
+ * are protected by the mutex. */
+struct t8_vtk_async
+{
+  int max_queue_depth;                          /**< The maximum number of pending snapshots. */
+  std::thread io_thread;                        /**< The thread that writes the snapshots. */
+  std::mutex mutex;                             /**< Protects the members below. */
+  std::condition_variable changed;              /**< Signalled when the queue or the pending count changes. */
+  std::deque<t8_forest_vtk_snapshot_t *> queue; /**< The snapshots that wait to be written. */
+  int num_pending;                              /**< The number of queued snapshots plus the one being written. */
+  int shutdown;                                 /**< If true, the I/O thread exits once the queue is empty. */
+  int success;                                  /**< False if writing a snapshot failed since the last wait. */
+  int num_written;                              /**< The number of written snapshots. */
+  double write_time;                            /**< The time the I/O thread spent writing. */
+  double blocked_time;                          /**< The time the calling thread waited for the I/O thread. */
+};
+
+/* Return the time in seconds since an arbitrary fixed point.
+ * We do not use sc_MPI_Wtime, since the I/O thread must not call MPI. */
+static double
+t8_vtk_async_time ()
+{
+  return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+/* The main loop of the I/O thread. */
+static void
+t8_vtk_async_run (t8_vtk_async_t async)
+{
+  std::unique_lock<std::mutex> lock (async->mutex);
+
+  for (;;) {
+    async->changed.wait (lock, [async] { return async->shutdown || !async->queue.empty (); });
+    if (async->queue.empty ()) {
+      /* We were shut down and everything is written */
+      return;
+    }
+    t8_forest_vtk_snapshot_t *snapshot = async->queue.front ();
+    async->queue.pop_front ();
+    /* Write without holding the lock, such that the caller can queue further snapshots */
+    lock.unlock ();
+    const double start = t8_vtk_async_time ();
+    const int success = t8_forest_vtk_snapshot_write (snapshot);
+    t8_forest_vtk_snapshot_destroy (&snapshot);
+    const double elapsed = t8_vtk_async_time () - start;
+    lock.lock ();
+    async->write_time += elapsed;
+    async->success = async->success && success;
+    async->num_written++;
+    async->num_pending--;
+    async->changed.notify_all ();
+  }
+}
+
+t8_vtk_async_t
+t8_vtk_async_new (const int max_queue_depth)
+{
+  t8_vtk_async_t async = new t8_vtk_async;
+
+  T8_ASSERT (max_queue_depth > 0);
+  async->max_queue_depth = max_queue_depth;
+  async->num_pending = 0;
+  async->shutdown = 0;
+  async->success = 1;
+  async->num_written = 0;
+  async->write_time = 0;
+  async->blocked_time = 0;
+  async->io_thread = std::thread (t8_vtk_async_run, async);
+  return async;
+}
+
+void
+t8_vtk_async_write_forest (t8_vtk_async_t async, t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                           const int write_mpirank, const int write_level, const int write_element_id,
+                           const int write_ghosts, const int compress, const int num_data, t8_vtk_data_field_t *data)
+{
+  T8_ASSERT (async != NULL);
+  T8_ASSERT (t8_forest_is_committed (forest));
+
+  /* Wait for a free slot before taking the snapshot, such that at most
+   * max_queue_depth snapshots are held in memory. */
+  {
+    const double start = t8_vtk_async_time ();
+    std::unique_lock<std::mutex> lock (async->mutex);
+    async->changed.wait (lock, [async] { return async->num_pending < async->max_queue_depth; });
+    async->blocked_time += t8_vtk_async_time () - start;
+  }
+  t8_forest_vtk_snapshot_t *snapshot
+    = t8_forest_vtk_snapshot_new (forest, fileprefix, write_treeid, write_mpirank, write_level, write_element_id,
+                                  write_ghosts, compress, num_data, data);
+  t8_debugf ("Queueing a vtk snapshot of %zu bytes.\n", t8_forest_vtk_snapshot_num_bytes (snapshot));
+  {
+    std::lock_guard<std::mutex> lock (async->mutex);
+    async->queue.push_back (snapshot);
+    async->num_pending++;
+  }
+  async->changed.notify_all ();
+}
+
+int
+t8_vtk_async_wait (t8_vtk_async_t async)
+{
+  T8_ASSERT (async != NULL);
+  const double start = t8_vtk_async_time ();
+  std::unique_lock<std::mutex> lock (async->mutex);
+  async->changed.wait (lock, [async] { return async->num_pending == 0; });
+  async->blocked_time += t8_vtk_async_time () - start;
+  const int success = async->success;
+  async->success = 1;
+  return success;
+}
+
+double
+t8_vtk_async_get_hidden_time (t8_vtk_async_t async)
+{
+  T8_ASSERT (async != NULL);
+  std::lock_guard<std::mutex> lock (async->mutex);
+  return SC_MAX (async->write_time - async->blocked_time, 0);
+}
+
+void
+t8_vtk_async_destroy (t8_vtk_async_t *pasync)
+{
+  T8_ASSERT (pasync != NULL && *pasync != NULL);
+  t8_vtk_async_t async = *pasync;
+
+  if (!t8_vtk_async_wait (async)) {
+    t8_errorf ("Error when writing asynchronous vtk output.\n");
+  }
+  {
+    std::lock_guard<std::mutex> lock (async->mutex);
+    async->shutdown = 1;
+  }
+  async->changed.notify_all ();
+  async->io_thread.join ();
+  t8_global_productionf ("Asynchronous vtk output: Wrote %i snapshots in %.3f s, %.3f s hidden from the caller.\n",
+                         async->num_written, async->write_time, SC_MAX (async->write_time - async->blocked_time, 0));
+  delete async;
+  *pasync = NULL;
+}
@@ -0,0 +1,101 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_vtk_async.h
+ * An output pipeline that writes forests to .pvtu/.vtu files in the background.
+ * The calling thread takes a snapshot of the point coordinates and the data of
+ * a forest, which is cheap compared to writing the files. A dedicated I/O thread
+ * then encodes, possibly compresses and writes the snapshots, while the caller continues.
+ * The I/O thread does not call MPI, thus no particular MPI thread support level is required.
+ */
+
+#ifndef T8_VTK_ASYNC_H
+#define T8_VTK_ASYNC_H
+
+#include <t8.h>
+#include <t8_vtk.h>
+#include <t8_forest/t8_forest_general.h>
+
+/** Opaque handle of an asynchronous output pipeline. */
+typedef struct t8_vtk_async *t8_vtk_async_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Create an asynchronous output pipeline and start its I/O thread.
+ * \param [in] max_queue_depth  The maximum number of snapshots that are queued or being written.
+ *                              Must be positive. If the queue is full, \ref t8_vtk_async_write_forest
+ *                              blocks until a snapshot has been written.
+ * \return  The pipeline. Must be destroyed with \ref t8_vtk_async_destroy.
+ */
+t8_vtk_async_t
+t8_vtk_async_new (const int max_queue_depth);
+
+/** Queue a forest for writing in the binary .pvtu/.vtu format.
+ * The point coordinates and the user data are copied on the calling thread, so
+ * the forest and \a data may be modified or destroyed as soon as this function returns.
+ * The files are the same as those of \ref t8_forest_vtk_write_file_binary.
+ * \param [in] async       The pipeline.
+ * \param [in] forest      The forest. Must be committed.
+ * \param [in] fileprefix  The prefix of the output files.
+ * \param [in] write_treeid If true, the global tree id is written for each element.
+ * \param [in] write_mpirank If true, the mpirank is written for each element.
+ * \param [in] write_level If true, the refinement level is written for each element.
+ * \param [in] write_element_id If true, the global element id is written for each element.
+ * \param [in] write_ghosts If true, each process additionally writes its ghost elements.
+ * \param [in] compress    If true, the data arrays are zlib compressed on the I/O thread.
+ * \param [in] num_data    Number of user defined double valued data fields to write.
+ * \param [in] data        Array of t8_vtk_data_field_t of length \a num_data.
+ *                         If scalar and vector fields are used, all scalar fields
+ *                         must come first in the array.
+ * \note Errors when writing the files are reported by \ref t8_vtk_async_wait.
+ */
+void
+t8_vtk_async_write_forest (t8_vtk_async_t async, t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                           const int write_mpirank, const int write_level, const int write_element_id,
+                           const int write_ghosts, const int compress, const int num_data, t8_vtk_data_field_t *data);
+
+/** Wait until all queued snapshots have been written.
+ * \param [in] async       The pipeline.
+ * \return  True if all snapshots since the last call to this function were written
+ *          successfully, false if not (process local).
+ */
+int
+t8_vtk_async_wait (t8_vtk_async_t async);
+
+/** Return the time in seconds that the I/O thread spent writing snapshots while the
+ * calling thread was not blocked by the pipeline, that is the time hidden by the overlap.
+ * \param [in] async       The pipeline.
+ * \return  The hidden time in seconds.
+ */
+double
+t8_vtk_async_get_hidden_time (t8_vtk_async_t async);
+
+/** Wait for all queued snapshots, stop the I/O thread and destroy the pipeline.
+ * Prints the number of written snapshots, the writing time and the hidden time.
+ * \param [in,out] pasync  The pipeline. Set to NULL on output.
+ */
+void
+t8_vtk_async_destroy (t8_vtk_async_t *pasync);
+
+T8_EXTERN_C_END ();
+
+#endif /* T8_VTK_ASYNC_H */
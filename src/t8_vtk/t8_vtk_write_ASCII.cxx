@@ -21,79 +21,120 @@
 */
 
 #include "t8_vtk/t8_vtk_write_ASCII.hxx"
+#include "t8_vtk/t8_vtk_write_private.hxx"
 #include "t8_vtk/t8_vtk_writer_helper.hxx"
 #include <t8_vtk.h>
 #include <t8_element.hxx>
+#include <t8_schemes/t8_default/t8_default_traits.hxx>
 #include <t8_forest/t8_forest_ghost.h>
 #include <t8_vec.h>
 #include "t8_forest/t8_forest_types.h"
+#include "t8_forest/t8_forest_private.h"
 #include "t8_cmesh/t8_cmesh_trees.h"
 #include "t8_cmesh/t8_cmesh_types.h"
+#include <string>
+#include <vector>
+
+/* The forest can be written in ASCII mode or in binary mode.
+ * In binary mode the values of each data array are collected in raw form
+ * and all arrays are written in one <AppendedData> section at the end of the file.
+ * The encoding of the appended data lives in t8_vtk_write_binary.cxx and the
+ * collective single file writer in t8_vtk_write_shared.cxx. */
+
+/* Return the binary type of the values of a data array with the given vtk type name. */
+static t8_vtk_value_type_t
+t8_forest_vtk_value_type (const char *datatype)
+{
+  if (!strcmp (datatype, "UInt8")) {
+    return T8_VTK_UINT8;
+  }
+  if (!strcmp (datatype, "Int32")) {
+    return T8_VTK_INT32;
+  }
+  if (!strcmp (datatype, "Int64")) {
+    return T8_VTK_INT64;
+  }
+  if (!strcmp (datatype, "Float32")) {
+    return T8_VTK_FLOAT32;
+  }
+  SC_CHECK_ABORTF (!strcmp (datatype, "Float64"), "Unsupported vtk data type %s.\n", datatype);
+  return T8_VTK_FLOAT64;
+}
 
-/* TODO: Currently we only use ASCII mode and no data compression.
- *       We also do not use sc_io to buffer our output stream. */
-
-/* There are different cell data to write, e.g. connectivity, type, vertices, ...
- * The structure is always the same:
- * Iterate over the trees,
- *      iterate over the elements of that tree
- *          execute an element dependent part to write in the file.
- * In order to simplify writing this code, we put all the parts that are
- * repetitive in the function
- *  t8_forest_vtk_write_cell_data.
- * This function accepts a callback function, which is then executed for
- * each element. The callback function is defined below.
- */
-/* TODO: As soon as we have element iterators we should restructure this concept
- * appropriately. */
-typedef enum { T8_VTK_KERNEL_INIT, T8_VTK_KERNEL_EXECUTE, T8_VTK_KERNEL_CLEANUP } T8_VTK_KERNEL_MODUS;
-
-/** Callback function prototype for writing cell data.
- * The function is executed for each element.
- * The callback can run in three different modi:
- *  INIT    - Called once, to (possibly) initialize the data pointer
- *  EXECUTE - Called for each element, the actual writing happens here.
- *  CLEANUP - Called once after all elements. Used to cleanup any memory
- *            allocated during INIT.
- * \param [in] forest The forest.
- * \param [in] ltree_id   A local treeid.
- * \param [in] tree   The local tree of the forest with id \a ltree_id.
- * \param [in] element_index An index of an element inside \a tree.
- * \param [in] element  A pointer to the current element.
- * \param [in] ts       The eclass scheme of the current element.
- * \param [in] is_ghost Non-zero if the current element is a ghost element.
- *                      In this cas \a tree is NULL.
- *                      All ghost element will be traversed after all elements are
- * \param [in,out] vtufile The open file stream to which we write the forest.
- * \param [in,out] columns An integer counting the number of written columns.
- *                         The callback should increase this value by the number
- *                         of values written to the file.
- * \param [in,out] data    A pointer that the callback can modify at will.
- *                         Between modi INIT and CLEANUP, \a data will not be
- *                         modified outside of this callback.
- * \param [in]     modus   The modus in which the callback is called. See above.
- * \return                 True if successful, false if not (i.e. file i/o error).
- */
-typedef int (*t8_forest_vtk_cell_data_kernel) (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                               const t8_locidx_t element_index, const t8_element_t *element,
-                                               t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                               void **data, T8_VTK_KERNEL_MODUS modus);
+/* Append a value of the output's current value type to the output's buffer. */
+#define T8_VTK_APPEND_VALUE(output, type, value) \
+  do { \
+    const type t8_vtk_value = (type) (value); \
+    memcpy (sc_array_push_count (&(output)->buffer, sizeof (type)), &t8_vtk_value, sizeof (type)); \
+  } while (0)
+
+/* Write an integer value to the output.
+ * In ASCII mode the value is printed with \a format, which must expect a long long.
+ * In binary mode the value is converted to the type of the current data array.
+ * Returns true on success. */
+static int
+t8_forest_vtk_write_int (t8_forest_vtk_output_t *output, const char *format, const long long value)
+{
+  if (!output->binary) {
+    return fprintf (output->vtufile, format, value) > 0;
+  }
+  switch (output->value_type) {
+  case T8_VTK_UINT8:
+    T8_ASSERT (0 <= value && value <= UINT8_MAX);
+    T8_VTK_APPEND_VALUE (output, uint8_t, value);
+    break;
+  case T8_VTK_INT32:
+    T8_ASSERT (INT32_MIN <= value && value <= INT32_MAX);
+    T8_VTK_APPEND_VALUE (output, int32_t, value);
+    break;
+  case T8_VTK_INT64:
+    T8_VTK_APPEND_VALUE (output, int64_t, value);
+    break;
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+  return 1;
+}
+
+/* Write a floating point value to the output.
+ * In ASCII mode the value is printed with \a format, which must expect a double.
+ * In binary mode the value is converted to the type of the current data array.
+ * Returns true on success. */
+static int
+t8_forest_vtk_write_float (t8_forest_vtk_output_t *output, const char *format, const double value)
+{
+  if (!output->binary) {
+    return fprintf (output->vtufile, format, value) > 0;
+  }
+  if (output->value_type == T8_VTK_FLOAT32) {
+    T8_VTK_APPEND_VALUE (output, float, value);
+  }
+  else {
+    T8_ASSERT (output->value_type == T8_VTK_FLOAT64);
+    T8_VTK_APPEND_VALUE (output, double, value);
+  }
+  return 1;
+}
 
-static t8_locidx_t
-t8_forest_num_points (t8_forest_t forest, const int count_ghosts)
+t8_locidx_t
+t8_forest_vtk_num_points (t8_forest_t forest, const int count_ghosts)
 {
   t8_locidx_t num_points = 0;
+  /* Add the number of corners of a tree's elements to num_points */
+  const auto count_tree_points = [&num_points] (const auto &traits, const t8_element_array_t *elements) {
+    const t8_locidx_t num_elements = (t8_locidx_t) t8_element_array_get_count (elements);
+    for (t8_locidx_t ielem = 0; ielem < num_elements; ielem++) {
+      const t8_element_t *elem = t8_element_array_index_locidx (elements, ielem);
+      num_points += t8_eclass_num_vertices[traits.t8_element_shape (elem)];
+    }
+  };
 
   for (t8_locidx_t itree = 0; itree < (t8_locidx_t) forest->trees->elem_count; itree++) {
     /* Get the tree that stores the elements */
     t8_tree_t tree = (t8_tree_t) t8_sc_array_index_locidx (forest->trees, itree);
     /* Get the scheme of the current tree */
-    t8_eclass_scheme *tscheme = t8_forest_get_eclass_scheme (forest, tree->eclass);
-    const size_t num_elements = t8_element_array_get_count (&tree->elements);
-    for (t8_locidx_t ielem = 0; ielem < (t8_locidx_t) num_elements; ielem++) {
-      const t8_element_t *elem = t8_element_array_index_locidx (&tree->elements, ielem);
-      num_points += tscheme->t8_element_num_corners (elem);
-    }
+    const t8_eclass_scheme_c *tscheme = t8_forest_get_eclass_scheme (forest, tree->eclass);
+    t8_scheme_traits_dispatch (tscheme, [&] (const auto &traits) { count_tree_points (traits, &tree->elements); });
   }
   if (count_ghosts) {
     T8_ASSERT (forest->ghosts != NULL);
@@ -102,13 +143,9 @@ t8_forest_num_points (t8_forest_t forest, const int count_ghosts)
     for (t8_locidx_t itree = 0; itree < num_ghosts; itree++) {
       /* Get the element class of the ghost */
       t8_eclass_t ghost_class = t8_forest_ghost_get_tree_class (forest, itree);
-      t8_element_array_t *ghost_elem = t8_forest_ghost_get_tree_elements (forest, itree);
-      const size_t num_elements = t8_forest_ghost_tree_num_elements (forest, itree);
-      t8_eclass_scheme *tscheme = t8_forest_get_eclass_scheme (forest, ghost_class);
-      for (t8_locidx_t ielem = 0; ielem < (t8_locidx_t) num_elements; ielem++) {
-        const t8_element_t *elem = t8_element_array_index_locidx (ghost_elem, ielem);
-        num_points += tscheme->t8_element_num_corners (elem);
-      }
+      const t8_element_array_t *ghost_elem = t8_forest_ghost_get_tree_elements (forest, itree);
+      const t8_eclass_scheme_c *tscheme = t8_forest_get_eclass_scheme (forest, ghost_class);
+      t8_scheme_traits_dispatch (tscheme, [&] (const auto &traits) { count_tree_points (traits, ghost_elem); });
     }
   }
   return num_points;
@@ -117,13 +154,13 @@ t8_forest_num_points (t8_forest_t forest, const int count_ghosts)
 static int
 t8_forest_vtk_cells_vertices_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                      const t8_locidx_t element_index, const t8_element_t *element,
-                                     t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                     void **data, T8_VTK_KERNEL_MODUS modus)
+                                     const t8_element_shape_t element_shape, const int element_level,
+                                     const int is_ghost, t8_forest_vtk_output_t *output, int *columns, void **data,
+                                     T8_VTK_KERNEL_MODUS modus)
 {
   double element_coordinates[3];
   int num_el_vertices, ivertex;
   int freturn;
-  t8_element_shape_t element_shape;
 
   if (modus != T8_VTK_KERNEL_EXECUTE) {
     /* Nothing to do if we are in Init or clean up mode */
@@ -134,20 +171,25 @@ t8_forest_vtk_cells_vertices_kernel (t8_forest_t forest, const t8_locidx_t ltree
    *       does this work too over tree->class or do we need something else?
    */
 
-  element_shape = ts->t8_element_shape (element);
   num_el_vertices = t8_eclass_num_vertices[element_shape];
   for (ivertex = 0; ivertex < num_el_vertices; ivertex++) {
     const double *ref_coords = t8_forest_vtk_point_to_element_ref_coords[element_shape][ivertex];
     t8_forest_element_from_ref_coords (forest, ltree_id, element, ref_coords, 1, element_coordinates);
-    freturn = fprintf (vtufile, "         ");
+    if (output->binary) {
+      for (int icoord = 0; icoord < 3; icoord++) {
+        t8_forest_vtk_write_float (output, NULL, element_coordinates[icoord]);
+      }
+      continue;
+    }
+    freturn = fprintf (output->vtufile, "         ");
     if (freturn <= 0) {
       return 0;
     }
 #ifdef T8_VTK_DOUBLES
-    freturn = fprintf (vtufile, " %24.16e %24.16e %24.16e\n", element_coordinates[0], element_coordinates[1],
+    freturn = fprintf (output->vtufile, " %24.16e %24.16e %24.16e\n", element_coordinates[0], element_coordinates[1],
                        element_coordinates[2]);
 #else
-    freturn = fprintf (vtufile, " %16.8e %16.8e %16.8e\n", element_coordinates[0], element_coordinates[1],
+    freturn = fprintf (output->vtufile, " %16.8e %16.8e %16.8e\n", element_coordinates[0], element_coordinates[1],
                        element_coordinates[2]);
 #endif
     if (freturn <= 0) {
@@ -163,13 +205,13 @@ t8_forest_vtk_cells_vertices_kernel (t8_forest_t forest, const t8_locidx_t ltree
 static int
 t8_forest_vtk_cells_connectivity_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                          const t8_locidx_t element_index, const t8_element_t *element,
-                                         t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                         void **data, T8_VTK_KERNEL_MODUS modus)
+                                         const t8_element_shape_t element_shape, const int element_level,
+                                         const int is_ghost, t8_forest_vtk_output_t *output, int *columns, void **data,
+                                         T8_VTK_KERNEL_MODUS modus)
 {
   int ivertex, num_vertices;
   int freturn;
   t8_locidx_t *count_vertices;
-  t8_element_shape_t element_shape;
 
   if (modus == T8_VTK_KERNEL_INIT) {
     /* We use data to count the number of written vertices */
@@ -183,11 +225,13 @@ t8_forest_vtk_cells_connectivity_kernel (t8_forest_t forest, const t8_locidx_t l
   T8_ASSERT (modus == T8_VTK_KERNEL_EXECUTE);
 
   count_vertices = (t8_locidx_t *) *data;
-  element_shape = ts->t8_element_shape (element);
   num_vertices = t8_eclass_num_vertices[element_shape];
   for (ivertex = 0; ivertex < num_vertices; ++ivertex, (*count_vertices)++) {
-    freturn = fprintf (vtufile, " %ld", (long) *count_vertices);
-    if (freturn <= 0) {
+    /* If each point is written only once, the corners refer to the unique points */
+    const t8_locidx_t point
+      = output->points != NULL ? output->points->corner_points[*count_vertices] : *count_vertices;
+    freturn = t8_forest_vtk_write_int (output, " %lld", point);
+    if (!freturn) {
       return 0;
     }
   }
@@ -197,9 +241,9 @@ t8_forest_vtk_cells_connectivity_kernel (t8_forest_t forest, const t8_locidx_t l
 
 static int
 t8_forest_vtk_cells_offset_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                   const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                   const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                   T8_VTK_KERNEL_MODUS modus)
+                                   const t8_locidx_t element_index, const t8_element_t *element,
+                                   const t8_element_shape_t element_shape, const int element_level, const int is_ghost,
+                                   t8_forest_vtk_output_t *output, int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   long long *offset;
   int freturn;
@@ -217,10 +261,10 @@ t8_forest_vtk_cells_offset_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 
   offset = (long long *) *data;
 
-  num_vertices = t8_eclass_num_vertices[ts->t8_element_shape (element)];
+  num_vertices = t8_eclass_num_vertices[element_shape];
   *offset += num_vertices;
-  freturn = fprintf (vtufile, " %lld", *offset);
-  if (freturn <= 0) {
+  freturn = t8_forest_vtk_write_int (output, " %lld", *offset);
+  if (!freturn) {
     return false;
   }
   *columns += 1;
@@ -230,15 +274,15 @@ t8_forest_vtk_cells_offset_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 
 static int
 t8_forest_vtk_cells_type_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                 const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                 const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                 T8_VTK_KERNEL_MODUS modus)
+                                 const t8_locidx_t element_index, const t8_element_t *element,
+                                 const t8_element_shape_t element_shape, const int element_level, const int is_ghost,
+                                 t8_forest_vtk_output_t *output, int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   int freturn;
   if (modus == T8_VTK_KERNEL_EXECUTE) {
     /* print the vtk type of the element */
-    freturn = fprintf (vtufile, " %d", t8_eclass_vtk_type[ts->t8_element_shape (element)]);
-    if (freturn <= 0) {
+    freturn = t8_forest_vtk_write_int (output, " %lld", t8_eclass_vtk_type[element_shape]);
+    if (!freturn) {
       return 0;
     }
     *columns += 1;
@@ -248,12 +292,12 @@ t8_forest_vtk_cells_type_kernel (t8_forest_t forest, const t8_locidx_t ltree_id,
 
 static int
 t8_forest_vtk_cells_level_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                  const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                  const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                  T8_VTK_KERNEL_MODUS modus)
+                                  const t8_locidx_t element_index, const t8_element_t *element,
+                                  const t8_element_shape_t element_shape, const int element_level, const int is_ghost,
+                                  t8_forest_vtk_output_t *output, int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   if (modus == T8_VTK_KERNEL_EXECUTE) {
-    fprintf (vtufile, "%i ", ts->t8_element_level (element));
+    t8_forest_vtk_write_int (output, "%lli ", element_level);
     *columns += 1;
   }
   return 1;
@@ -261,12 +305,12 @@ t8_forest_vtk_cells_level_kernel (t8_forest_t forest, const t8_locidx_t ltree_id
 
 static int
 t8_forest_vtk_cells_rank_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                 const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                 const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                 T8_VTK_KERNEL_MODUS modus)
+                                 const t8_locidx_t element_index, const t8_element_t *element,
+                                 const t8_element_shape_t element_shape, const int element_level, const int is_ghost,
+                                 t8_forest_vtk_output_t *output, int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   if (modus == T8_VTK_KERNEL_EXECUTE) {
-    fprintf (vtufile, "%i ", forest->mpirank);
+    t8_forest_vtk_write_int (output, "%lli ", forest->mpirank);
     *columns += 1;
   }
   return 1;
@@ -274,9 +318,9 @@ t8_forest_vtk_cells_rank_kernel (t8_forest_t forest, const t8_locidx_t ltree_id,
 
 static int
 t8_forest_vtk_cells_treeid_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                   const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                   const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                   T8_VTK_KERNEL_MODUS modus)
+                                   const t8_locidx_t element_index, const t8_element_t *element,
+                                   const t8_element_shape_t element_shape, const int element_level, const int is_ghost,
+                                   t8_forest_vtk_output_t *output, int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   if (modus == T8_VTK_KERNEL_EXECUTE) {
     long long tree_id;
@@ -288,7 +332,7 @@ t8_forest_vtk_cells_treeid_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
       /* Otherwise the global tree id */
       tree_id = (long long) ltree_id + forest->first_local_tree;
     }
-    fprintf (vtufile, "%lli ", tree_id);
+    t8_forest_vtk_write_int (output, "%lli ", tree_id);
     *columns += 1;
   }
   return 1;
@@ -297,16 +341,18 @@ t8_forest_vtk_cells_treeid_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 static int
 t8_forest_vtk_cells_elementid_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                       const t8_locidx_t element_index, const t8_element_t *element,
-                                      t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                      void **data, T8_VTK_KERNEL_MODUS modus)
+                                      const t8_element_shape_t element_shape, const int element_level,
+                                      const int is_ghost, t8_forest_vtk_output_t *output, int *columns, void **data,
+                                      T8_VTK_KERNEL_MODUS modus)
 {
   if (modus == T8_VTK_KERNEL_EXECUTE) {
     if (!is_ghost) {
-      fprintf (vtufile, "%lli ",
-               element_index + tree->elements_offset + (long long) t8_forest_get_first_local_element_id (forest));
+      t8_forest_vtk_write_int (output, "%lli ",
+                               element_index + tree->elements_offset
+                                 + (long long) t8_forest_get_first_local_element_id (forest));
     }
     else {
-      fprintf (vtufile, "%lli ", (long long) -1);
+      t8_forest_vtk_write_int (output, "%lli ", -1);
     }
     *columns += 1;
   }
@@ -315,9 +361,9 @@ t8_forest_vtk_cells_elementid_kernel (t8_forest_t forest, const t8_locidx_t ltre
 
 static int
 t8_forest_vtk_cells_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                   const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                   const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                   T8_VTK_KERNEL_MODUS modus)
+                                   const t8_locidx_t element_index, const t8_element_t *element,
+                                   const t8_element_shape_t element_shape, const int element_level, const int is_ghost,
+                                   t8_forest_vtk_output_t *output, int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   double element_value = 0;
   t8_locidx_t scalar_index;
@@ -331,7 +377,7 @@ t8_forest_vtk_cells_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
     else {
       element_value = 0;
     }
-    fprintf (vtufile, "%g ", element_value);
+    t8_forest_vtk_write_float (output, "%g ", element_value);
     *columns += 1;
   }
   return 1;
@@ -339,9 +385,9 @@ t8_forest_vtk_cells_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 
 static int
 t8_forest_vtk_cells_vector_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                   const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                   const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                   T8_VTK_KERNEL_MODUS modus)
+                                   const t8_locidx_t element_index, const t8_element_t *element,
+                                   const t8_element_shape_t element_shape, const int element_level, const int is_ghost,
+                                   t8_forest_vtk_output_t *output, int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   double *element_values, null_vec[3] = { 0, 0, 0 };
   int dim, idim;
@@ -360,7 +406,7 @@ t8_forest_vtk_cells_vector_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
       element_values = null_vec;
     }
     for (idim = 0; idim < dim; idim++) {
-      fprintf (vtufile, "%g ", element_values[idim]);
+      t8_forest_vtk_write_float (output, "%g ", element_values[idim]);
     }
     *columns += dim;
   }
@@ -371,15 +417,16 @@ t8_forest_vtk_cells_vector_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 static int
 t8_forest_vtk_vertices_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                       const t8_locidx_t element_index, const t8_element_t *element,
-                                      t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                      void **data, T8_VTK_KERNEL_MODUS modus)
+                                      const t8_element_shape_t element_shape, const int element_level,
+                                      const int is_ghost, t8_forest_vtk_output_t *output, int *columns, void **data,
+                                      T8_VTK_KERNEL_MODUS modus)
 {
   double element_value = 0;
   int num_vertex, ivertex;
   t8_locidx_t scalar_index;
 
   if (modus == T8_VTK_KERNEL_EXECUTE) {
-    num_vertex = ts->t8_element_num_corners (element);
+    num_vertex = t8_eclass_num_vertices[element_shape];
 
     for (ivertex = 0; ivertex < num_vertex; ivertex++) {
       /* For local elements access the data array, for ghosts, write 0 */
@@ -390,7 +437,7 @@ t8_forest_vtk_vertices_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltre
       else {
         element_value = 0;
       }
-      fprintf (vtufile, "%g ", element_value);
+      t8_forest_vtk_write_float (output, "%g ", element_value);
       *columns += 1;
     }
   }
@@ -401,8 +448,9 @@ t8_forest_vtk_vertices_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltre
 static int
 t8_forest_vtk_vertices_vector_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                       const t8_locidx_t element_index, const t8_element_t *element,
-                                      t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                      void **data, T8_VTK_KERNEL_MODUS modus)
+                                      const t8_element_shape_t element_shape, const int element_level,
+                                      const int is_ghost, t8_forest_vtk_output_t *output, int *columns, void **data,
+                                      T8_VTK_KERNEL_MODUS modus)
 {
   double *element_values, null_vec[3] = { 0, 0, 0 };
   int dim, idim;
@@ -410,7 +458,7 @@ t8_forest_vtk_vertices_vector_kernel (t8_forest_t forest, const t8_locidx_t ltre
   t8_locidx_t tree_offset;
 
   if (modus == T8_VTK_KERNEL_EXECUTE) {
-    num_vertex = ts->t8_element_num_corners (element);
+    num_vertex = t8_eclass_num_vertices[element_shape];
     for (ivertex = 0; ivertex < num_vertex; ivertex++) {
       dim = 3;
       T8_ASSERT (forest->dimension <= 3);
@@ -424,7 +472,7 @@ t8_forest_vtk_vertices_vector_kernel (t8_forest_t forest, const t8_locidx_t ltre
         element_values = null_vec;
       }
       for (idim = 0; idim < dim; idim++) {
-        fprintf (vtufile, "%g ", element_values[idim]);
+        t8_forest_vtk_write_float (output, "%g ", element_values[idim]);
       }
       *columns += dim;
     }
@@ -432,29 +480,115 @@ t8_forest_vtk_vertices_vector_kernel (t8_forest_t forest, const t8_locidx_t ltre
   return 1;
 }
 
-/* Iterate over all cells and write cell data to the file using
- * the cell_data_kernel as callback */
+/* Write the xml header of a data array and prepare the output for its values.
+ * In binary mode the header is only written if the output has a file. */
+static int
+t8_forest_vtk_begin_data_array (t8_forest_vtk_output_t *output, const char *dataname, const char *datatype,
+                                const char *component_string)
+{
+  if (output->binary) {
+    output->value_type = t8_forest_vtk_value_type (datatype);
+    if (output->vtufile == NULL) {
+      /* The caller writes the values of the buffer itself */
+      return 1;
+    }
+    /* The offset of the data array refers to the first byte after the '_' of the appended data */
+    return fprintf (output->vtufile,
+                    "        <DataArray type=\"%s\" "
+                    "Name=\"%s\" %s format=\"appended\" offset=\"%llu\"/>\n",
+                    datatype, dataname, component_string, (unsigned long long) output->appended.size ())
+           > 0;
+  }
+  return fprintf (output->vtufile,
+                  "        <DataArray type=\"%s\" "
+                  "Name=\"%s\" %s format=\"ascii\">\n         ",
+                  datatype, dataname, component_string)
+         > 0;
+}
+
+/* Finish a data array after all its values were written.
+ * In binary mode the values are moved to the appended data, if the output has a file. */
+static int
+t8_forest_vtk_end_data_array (t8_forest_vtk_output_t *output)
+{
+  if (output->binary) {
+    return output->vtufile == NULL || t8_forest_vtk_append_buffer (output);
+  }
+  return fprintf (output->vtufile, "\n        </DataArray>\n") > 0;
+}
+
+/* Call a kernel in execution modus for the elements of a local or a ghost tree.
+ * The shape and the level of the elements are computed with the scheme traits of the tree,
+ * such that they are inlined for the default schemes.
+ * In ASCII mode the line is broken after each max_columns values.
+ * \param [in] ltree_id  The local tree id. For a ghost tree, the ghost tree id plus the number of local trees.
+ * \param [in] tree      The local tree, NULL for a ghost tree.
+ * \param [in] elements  The elements of the tree.
+ * \return True if successful, false if not. */
+template <class Traits>
+static int
+t8_forest_vtk_write_tree_cell_data (t8_forest_t forest, const Traits &traits, const t8_locidx_t ltree_id,
+                                    const t8_tree_t tree, const t8_element_array_t *elements, const int is_ghost,
+                                    t8_forest_vtk_output_t *output, const int max_columns,
+                                    t8_forest_vtk_cell_data_kernel kernel, int *countcols, void **data)
+{
+  const t8_locidx_t num_elements = (t8_locidx_t) t8_element_array_get_count (elements);
+
+  for (t8_locidx_t element_index = 0; element_index < num_elements; element_index++) {
+    const t8_element_t *element = t8_element_array_index_locidx (elements, element_index);
+    /* Execute the given callback on each element */
+    if (!kernel (forest, ltree_id, tree, element_index, element, traits.t8_element_shape (element),
+                 traits.t8_element_level (element), is_ghost, output, countcols, data, T8_VTK_KERNEL_EXECUTE)) {
+      return 0;
+    }
+    /* After max_columns we break the line */
+    if (!output->binary && !(*countcols % max_columns) && fprintf (output->vtufile, "\n         ") <= 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Call a kernel in execution modus for a range of selected cells of the output that belong to the same tree.
+ * Each cell refers to the data of its first leaf.
+ * \param [in] first  The first cell of the range.
+ * \param [in] last   One past the last cell of the range.
+ * \return True if successful, false if not. */
+template <class Traits>
 static int
-t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE *vtufile, const char *dataname, const char *datatype,
-                               const char *component_string, const int max_columns,
+t8_forest_vtk_write_selected_cell_data (t8_forest_t forest, const Traits &traits, const t8_tree_t tree,
+                                        const size_t first, const size_t last, t8_forest_vtk_output_t *output,
+                                        const int max_columns, t8_forest_vtk_cell_data_kernel kernel, int *countcols,
+                                        void **data)
+{
+  for (size_t icell = first; icell < last; icell++) {
+    const t8_forest_vtk_cell_t &cell = (*output->cells)[icell];
+    if (!kernel (forest, cell.ltreeid, tree, cell.first_leaf, cell.element, traits.t8_element_shape (cell.element),
+                 traits.t8_element_level (cell.element), 0, output, countcols, data, T8_VTK_KERNEL_EXECUTE)) {
+      return 0;
+    }
+    if (!output->binary && !(*countcols % max_columns) && fprintf (output->vtufile, "\n         ") <= 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Iterate over all cells and write cell data to the file using
+ * the cell_data_kernel as callback.
+ * The element class of each tree is dispatched once with \ref t8_scheme_traits_dispatch.
+ * In binary mode only the xml header of the data array is written to the file
+ * and the values are added to the appended data of the output. */
+int
+t8_forest_vtk_write_cell_data (t8_forest_t forest, t8_forest_vtk_output_t *output, const char *dataname,
+                               const char *datatype, const char *component_string, const int max_columns,
                                t8_forest_vtk_cell_data_kernel kernel, const int write_ghosts, void *udata)
 {
   int freturn;
-  int countcols;
-  t8_tree_t tree;
-  t8_locidx_t itree, ighost;
-  t8_locidx_t element_index, elems_in_tree;
-  t8_locidx_t num_local_trees, num_ghost_trees;
-  t8_element_t *element;
-  t8_eclass_scheme_c *ts;
+  int countcols = 0;
   void *data = NULL;
 
-  /* Write the connectivity information.
-   * Thus for each tree we write the indices of its corner vertices. */
-  freturn = fprintf (vtufile,
-                     "        <DataArray type=\"%s\" "
-                     "Name=\"%s\" %s format=\"ascii\">\n         ",
-                     datatype, dataname, component_string);
+  freturn = t8_forest_vtk_begin_data_array (output, dataname, datatype, component_string);
   if (freturn <= 0) {
     return 0;
   }
@@ -467,90 +601,91 @@ t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE *vtufile, const char *da
 
   /* Call the kernel in initialization modus to possibly initialize the
    * data pointer */
-  kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_INIT);
-  /* We iterate over the trees and count each trees vertices,
-   * we add this to the already counted vertices and write it to the file */
-  /* TODO: replace with an element iterator */
-  num_local_trees = t8_forest_get_num_local_trees (forest);
-  for (itree = 0, countcols = 0; itree < num_local_trees; itree++) {
-    /* Get the tree that stores the elements */
-    tree = t8_forest_get_tree (forest, itree);
-    /* Get the eclass scheme of the tree */
-    ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
-    elems_in_tree = (t8_locidx_t) t8_element_array_get_count (&tree->elements);
-    for (element_index = 0; element_index < elems_in_tree; element_index++) {
-      /* Get a pointer to the element */
-      element = t8_forest_get_element (forest, tree->elements_offset + element_index, NULL);
-      T8_ASSERT (element != NULL);
-      /* Execute the given callback on each element */
-      if (!kernel (forest, itree, tree, element_index, element, ts, 0, vtufile, &countcols, &data,
-                   T8_VTK_KERNEL_EXECUTE)) {
-        /* call the kernel in clean-up modus */
-        kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-        return 0;
+  kernel (NULL, 0, NULL, 0, NULL, T8_ECLASS_INVALID, 0, 0, NULL, NULL, &data, T8_VTK_KERNEL_INIT);
+  freturn = 1;
+  if (output->cells != NULL) {
+    /* Only the selected elements are written. They are sorted by tree,
+     * so we dispatch the scheme once per range of cells of the same tree. */
+    T8_ASSERT (!write_ghosts);
+    const size_t num_cells = output->cells->size ();
+    size_t first = 0;
+    while (freturn && first < num_cells) {
+      const t8_locidx_t ltreeid = (*output->cells)[first].ltreeid;
+      size_t last = first + 1;
+      while (last < num_cells && (*output->cells)[last].ltreeid == ltreeid) {
+        last++;
       }
-      /* After max_columns we break the line */
-      if (!(countcols % max_columns)) {
-        freturn = fprintf (vtufile, "\n         ");
-        if (freturn <= 0) {
-          /* call the kernel in clean-up modus */
-          kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-          return 0;
-        }
+      const t8_tree_t tree = t8_forest_get_tree (forest, ltreeid);
+      const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, tree->eclass);
+      freturn = t8_scheme_traits_dispatch (ts, [&] (const auto &traits) {
+        return t8_forest_vtk_write_selected_cell_data (forest, traits, tree, first, last, output, max_columns, kernel,
+                                                       &countcols, &data);
+      });
+      first = last;
+    }
+  }
+  else {
+    /* We iterate over the trees and call the kernel for each of their elements */
+    const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+    for (t8_locidx_t itree = 0; freturn && itree < num_local_trees; itree++) {
+      const t8_tree_t tree = t8_forest_get_tree (forest, itree);
+      const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+      freturn = t8_scheme_traits_dispatch (ts, [&] (const auto &traits) {
+        return t8_forest_vtk_write_tree_cell_data (forest, traits, itree, tree, &tree->elements, 0, output, max_columns,
+                                                   kernel, &countcols, &data);
+      });
+    }
+    if (write_ghosts) {
+      /* Iterate over the ghost elements */
+      const t8_locidx_t num_ghost_trees = t8_forest_ghost_num_trees (forest);
+      for (t8_locidx_t ighost = 0; freturn && ighost < num_ghost_trees; ighost++) {
+        const t8_eclass_scheme_c *ts
+          = t8_forest_get_eclass_scheme (forest, t8_forest_ghost_get_tree_class (forest, ighost));
+        const t8_element_array_t *ghost_elements = t8_forest_ghost_get_tree_elements (forest, ighost);
+        freturn = t8_scheme_traits_dispatch (ts, [&] (const auto &traits) {
+          return t8_forest_vtk_write_tree_cell_data (forest, traits, ighost + num_local_trees, NULL, ghost_elements, 1,
+                                                     output, max_columns, kernel, &countcols, &data);
+        });
       }
-    } /* element loop ends here */
-    if (freturn <= 0) {
-      /* call the kernel in clean-up modus */
-      kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-      return 0;
     }
-  } /* tree loop ends here */
+  }
+  /* call the kernel in clean-up modus */
+  kernel (NULL, 0, NULL, 0, NULL, T8_ECLASS_INVALID, 0, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
+  return freturn && t8_forest_vtk_end_data_array (output);
+}
 
-  if (write_ghosts) {
-    t8_locidx_t num_ghosts_in_tree;
-    /* Iterate over the ghost elements */
-    /* TODO: replace with an element iterator */
-    num_ghost_trees = t8_forest_ghost_num_trees (forest);
-    for (ighost = 0; ighost < num_ghost_trees; ighost++) {
-      /* Get the eclass scheme of the ghost tree */
-      ts = t8_forest_get_eclass_scheme (forest, t8_forest_ghost_get_tree_class (forest, ighost));
-      /* The number of ghosts in this tree */
-      num_ghosts_in_tree = t8_forest_ghost_tree_num_elements (forest, ighost);
-      for (element_index = 0; element_index < num_ghosts_in_tree; element_index++) {
-        /* Get a pointer to the element */
-        element = t8_forest_ghost_get_element (forest, ighost, element_index);
-        /* Execute the given callback on each element */
-        if (!kernel (forest, ighost + num_local_trees, NULL, element_index, element, ts, 1, vtufile, &countcols, &data,
-                     T8_VTK_KERNEL_EXECUTE)) {
-          /* call the kernel in clean-up modus */
-          kernel (NULL, 0, NULL, 0, NULL, NULL, 1, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-          return 0;
-        }
-        /* After max_columns we break the line */
-        if (!(countcols % max_columns)) {
-          freturn = fprintf (vtufile, "\n         ");
-          if (freturn <= 0) {
-            /* call the kernel in clean-up modus */
-            kernel (NULL, 0, NULL, 0, NULL, NULL, 1, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-            return 0;
-          }
-        }
-      } /* element loop ends here */
-      if (freturn <= 0) {
-        /* call the kernel in clean-up modus */
-        kernel (NULL, 0, NULL, 0, NULL, NULL, 1, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
+/* Write a data array of double values for each unique point of the output.
+ * \param [in,out] output           The output. Its points must not be NULL.
+ * \param [in]     dataname         The name of the data array.
+ * \param [in]     component_string The number of components attribute of the data array.
+ * \param [in]     values           \a num_components values per point.
+ * \param [in]     num_components   The number of values per point.
+ * \return                          True if successful, false if not. */
+static int
+t8_forest_vtk_write_point_values (t8_forest_vtk_output_t *output, const char *dataname, const char *component_string,
+                                  const double *values, const int num_components)
+{
+  const size_t num_points = output->points->coordinates.size () / 3;
+#ifdef T8_VTK_DOUBLES
+  const char *format = " %24.16e";
+#else
+  const char *format = " %16.8e";
+#endif
+
+  if (!t8_forest_vtk_begin_data_array (output, dataname, T8_VTK_FLOAT_NAME, component_string)) {
+    return 0;
+  }
+  for (size_t ipoint = 0; ipoint < num_points; ipoint++) {
+    for (int icomp = 0; icomp < num_components; icomp++) {
+      if (!t8_forest_vtk_write_float (output, format, values[ipoint * num_components + icomp])) {
         return 0;
       }
-    } /* ghost loop ends here */
-  }   /* write_ghosts ends here */
-  /* call the kernel in clean-up modus */
-  kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-  freturn = fprintf (vtufile, "\n        </DataArray>\n");
-  if (freturn <= 0) {
-    return 0;
+    }
+    if (!output->binary && fprintf (output->vtufile, "\n         ") <= 0) {
+      return 0;
+    }
   }
-
-  return 1;
+  return t8_forest_vtk_end_data_array (output);
 }
 
 /* Write the cell data to an open file stream.
@@ -558,24 +693,24 @@ t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE *vtufile, const char *da
  * After completion the file will remain open, whether writing
  * cells was successful or not. */
 static int
-t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_treeid, const int write_mpirank,
-                           const int write_level, const int write_element_id, const int write_ghosts,
-                           const int num_data, t8_vtk_data_field_t *data)
+t8_forest_vtk_write_cells (t8_forest_t forest, t8_forest_vtk_output_t *output, const int write_treeid,
+                           const int write_mpirank, const int write_level, const int write_element_id,
+                           const int write_ghosts, const int num_data, t8_vtk_data_field_t *data)
 {
   int freturn;
   int idata;
 
   T8_ASSERT (t8_forest_is_committed (forest));
-  T8_ASSERT (vtufile != NULL);
+  T8_ASSERT (output->vtufile != NULL);
 
-  freturn = fprintf (vtufile, "      <Cells>\n");
+  freturn = fprintf (output->vtufile, "      <Cells>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
 
   /* Write the connectivity information.
    * Thus for each tree we write the indices of its corner vertices. */
-  freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "connectivity", T8_VTK_LOCIDX, "", 8,
+  freturn = t8_forest_vtk_write_cell_data (forest, output, "connectivity", T8_VTK_LOCIDX, "", 8,
                                            t8_forest_vtk_cells_connectivity_kernel, write_ghosts, NULL);
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
@@ -588,7 +723,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
    * For example if the trees are a square and a triangle, the offsets would
    * be 4 and 7, since indices 0,1,2,3 refer to the vertices of the square
    * and indices 4,5,6 to the indices of the triangle. */
-  freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "offsets", T8_VTK_LOCIDX, "", 8,
+  freturn = t8_forest_vtk_write_cell_data (forest, output, "offsets", T8_VTK_LOCIDX, "", 8,
                                            t8_forest_vtk_cells_offset_kernel, write_ghosts, NULL);
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
@@ -598,19 +733,19 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   /* Write the element types. The type specifies the element class, thus
    * square/triangle/tet etc. */
 
-  freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "types", "Int32", "", 8, t8_forest_vtk_cells_type_kernel,
+  freturn = t8_forest_vtk_write_cell_data (forest, output, "types", "Int32", "", 8, t8_forest_vtk_cells_type_kernel,
                                            write_ghosts, NULL);
 
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
   }
   /* Done with writing the types */
-  freturn = fprintf (vtufile, "      </Cells>\n");
+  freturn = fprintf (output->vtufile, "      </Cells>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
   /* clang-format off */
-  freturn = fprintf (vtufile, "      <CellData Scalars =\"%s%s\">\n", "treeid,mpirank,level",
+  freturn = fprintf (output->vtufile, "      <CellData Scalars =\"%s%s\">\n", "treeid,mpirank,level",
                      (write_element_id ? "id" : ""));
   /* clang-format on */
   if (freturn <= 0) {
@@ -620,7 +755,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   if (write_treeid) {
     /* Write the tree ids. */
 
-    freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "treeid", T8_VTK_GLOIDX, "", 8,
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "treeid", T8_VTK_GLOIDX, "", 8,
                                              t8_forest_vtk_cells_treeid_kernel, write_ghosts, NULL);
     if (!freturn) {
       goto t8_forest_vtk_cell_failure;
@@ -630,7 +765,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   if (write_mpirank) {
     /* Write the mpiranks. */
 
-    freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "mpirank", "Int32", "", 8,
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "mpirank", "Int32", "", 8,
                                              t8_forest_vtk_cells_rank_kernel, write_ghosts, NULL);
     if (!freturn) {
       goto t8_forest_vtk_cell_failure;
@@ -640,7 +775,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   if (write_level) {
     /* Write the element refinement levels. */
 
-    freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "level", "Int32", "", 8, t8_forest_vtk_cells_level_kernel,
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "level", "Int32", "", 8, t8_forest_vtk_cells_level_kernel,
                                              write_ghosts, NULL);
     if (!freturn) {
       goto t8_forest_vtk_cell_failure;
@@ -654,7 +789,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
 
     /* Use 32 bit ints if the global element count fits, 64 bit otherwise. */
     datatype = forest->global_num_elements > T8_LOCIDX_MAX ? T8_VTK_GLOIDX : T8_VTK_LOCIDX;
-    freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "element_id", datatype, "", 8,
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "element_id", datatype, "", 8,
                                              t8_forest_vtk_cells_elementid_kernel, write_ghosts, NULL);
     if (!freturn) {
       goto t8_forest_vtk_cell_failure;
@@ -665,14 +800,14 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   /* Write the user defined data fields per element */
   for (idata = 0; idata < num_data; idata++) {
     if (data[idata].type == T8_VTK_SCALAR) {
-      freturn = t8_forest_vtk_write_cell_data (forest, vtufile, data[idata].description, T8_VTK_FLOAT_NAME, "", 8,
+      freturn = t8_forest_vtk_write_cell_data (forest, output, data[idata].description, T8_VTK_FLOAT_NAME, "", 8,
                                                t8_forest_vtk_cells_scalar_kernel, write_ghosts, data[idata].data);
     }
     else {
       char component_string[BUFSIZ];
       T8_ASSERT (data[idata].type == T8_VTK_VECTOR);
       snprintf (component_string, BUFSIZ, "NumberOfComponents=\"3\"");
-      freturn = t8_forest_vtk_write_cell_data (forest, vtufile, data[idata].description, T8_VTK_FLOAT_NAME,
+      freturn = t8_forest_vtk_write_cell_data (forest, output, data[idata].description, T8_VTK_FLOAT_NAME,
                                                component_string, 8 * forest->dimension,
                                                t8_forest_vtk_cells_vector_kernel, write_ghosts, data[idata].data);
     }
@@ -681,7 +816,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
     }
   }
 
-  freturn = fprintf (vtufile, "      </CellData>\n");
+  freturn = fprintf (output->vtufile, "      </CellData>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
@@ -699,8 +834,8 @@ t8_forest_vtk_cell_failure:
  * After completion the file will remain open, whether writing
  * cells was successful or not. */
 static int
-t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_ghosts, const int num_data,
-                            t8_vtk_data_field_t *data)
+t8_forest_vtk_write_points (t8_forest_t forest, t8_forest_vtk_output_t *output, const int write_ghosts,
+                            const int num_data, t8_vtk_data_field_t *data)
 {
   int freturn;
   int sreturn;
@@ -708,20 +843,28 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
   char description[BUFSIZ];
 
   T8_ASSERT (t8_forest_is_committed (forest));
-  T8_ASSERT (vtufile != NULL);
+  T8_ASSERT (output->vtufile != NULL);
 
   /* Write the vertex coordinates */
 
-  freturn = fprintf (vtufile, "      <Points>\n");
+  freturn = fprintf (output->vtufile, "      <Points>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
-  freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "Position", T8_VTK_FLOAT_NAME, "NumberOfComponents=\"3\"",
-                                           8, t8_forest_vtk_cells_vertices_kernel, write_ghosts, NULL);
+  if (output->points != NULL) {
+    /* Write each point only once */
+    freturn = t8_forest_vtk_write_point_values (output, "Position", "NumberOfComponents=\"3\"",
+                                                output->points->coordinates.data (), 3);
+  }
+  else {
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "Position", T8_VTK_FLOAT_NAME,
+                                             "NumberOfComponents=\"3\"", 8, t8_forest_vtk_cells_vertices_kernel,
+                                             write_ghosts, NULL);
+  }
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
   }
-  freturn = fprintf (vtufile, "      </Points>\n");
+  freturn = fprintf (output->vtufile, "      </Points>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
@@ -729,9 +872,24 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
 
   /* Write the user defined data fields per element */
   if (num_data > 0) {
-    freturn = fprintf (vtufile, "      <PointData>\n");
+    freturn = fprintf (output->vtufile, "      <PointData>\n");
     for (idata = 0; idata < num_data; idata++) {
-      if (data[idata].type == T8_VTK_SCALAR) {
+      if (output->points != NULL) {
+        /* Average the element values at each point */
+        const int num_components = data[idata].type == T8_VTK_SCALAR ? 1 : 3;
+        std::vector<double> point_values;
+
+        sreturn = snprintf (description, BUFSIZ, "%s_%s", data[idata].description, "points");
+        if (sreturn >= BUFSIZ) {
+          /* The output was truncated */
+          t8_debugf ("Warning: Truncated vtk point data description to '%s'\n", description);
+        }
+        t8_forest_vtk_average_point_data (output->points, data[idata].data, num_components, point_values);
+        freturn = t8_forest_vtk_write_point_values (output, description,
+                                                    num_components == 3 ? "NumberOfComponents=\"3\"" : "",
+                                                    point_values.data (), num_components);
+      }
+      else if (data[idata].type == T8_VTK_SCALAR) {
         /* Write the description string. */
         sreturn = snprintf (description, BUFSIZ, "%s_%s", data[idata].description, "points");
 
@@ -739,7 +897,7 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
           /* The output was truncated */
           t8_debugf ("Warning: Truncated vtk point data description to '%s'\n", description);
         }
-        freturn = t8_forest_vtk_write_cell_data (forest, vtufile, description, T8_VTK_FLOAT_NAME, "", 8,
+        freturn = t8_forest_vtk_write_cell_data (forest, output, description, T8_VTK_FLOAT_NAME, "", 8,
                                                  t8_forest_vtk_vertices_scalar_kernel, write_ghosts, data[idata].data);
       }
       else {
@@ -756,7 +914,7 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
           t8_debugf ("Warning: Truncated vtk point data description to '%s'\n", description);
         }
 
-        freturn = t8_forest_vtk_write_cell_data (forest, vtufile, description, T8_VTK_FLOAT_NAME, component_string,
+        freturn = t8_forest_vtk_write_cell_data (forest, output, description, T8_VTK_FLOAT_NAME, component_string,
                                                  8 * forest->dimension, t8_forest_vtk_vertices_vector_kernel,
                                                  write_ghosts, data[idata].data);
       }
@@ -764,7 +922,7 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
         goto t8_forest_vtk_cell_failure;
       }
     }
-    freturn = fprintf (vtufile, "      </PointData>\n");
+    freturn = fprintf (output->vtufile, "      </PointData>\n");
   }
   /* Function completed successfully */
   return 1;
@@ -774,11 +932,22 @@ t8_forest_vtk_cell_failure:
   return 0;
 }
 
+/* Write the forest to one .vtu file per process and a .pvtu file, either in ASCII mode
+ * or in binary mode with the data arrays in a raw appended data section.
+ * If \a compress is true, the appended data arrays are zlib compressed.
+ * If \a unique_points is true, each point is written only once and the point data is averaged.
+ * If \a region is not NULL, only the part of the forest selected by \a region is written. */
 int
-t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
-                           const int write_level, const int write_element_id, int write_ghosts, const int num_data,
-                           t8_vtk_data_field_t *data)
+t8_forest_vtk_write_ext (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                         const int write_level, const int write_element_id, int write_ghosts, const int binary,
+                         int compress, const int unique_points, const t8_vtk_region_t *region, const int num_data,
+                         t8_vtk_data_field_t *data)
 {
+  t8_forest_vtk_output_t output;
+  t8_forest_vtk_points_t points;
+  t8_forest_vtk_cells_t cells;
+  std::vector<t8_vtk_data_field_t> averaged_data;
+  std::vector<std::vector<double>> averaged_values;
   FILE *vtufile = NULL;
   t8_locidx_t num_elements, num_points;
   char vtufilename[BUFSIZ];
@@ -786,12 +955,26 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
 
   T8_ASSERT (forest != NULL);
   T8_ASSERT (t8_forest_is_committed (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_vtk_write");
   T8_ASSERT (fileprefix != NULL);
-  if (forest->ghosts == NULL || forest->ghosts->num_ghosts_elements == 0) {
-    /* Never write ghost elements if there aren't any */
+  T8_ASSERT (binary || !compress);
+  T8_ASSERT (!unique_points || region == NULL);
+  if (forest->ghosts == NULL || forest->ghosts->num_ghosts_elements == 0 || region != NULL) {
+    /* Never write ghost elements if there aren't any or if only a part of the forest is written */
     write_ghosts = 0;
   }
   T8_ASSERT (forest->ghosts != NULL || !write_ghosts);
+#ifndef SC_HAVE_ZLIB
+  if (compress) {
+    t8_global_errorf ("WARNING: libsc was not configured with zlib. Writing uncompressed vtk files instead.\n");
+    compress = 0;
+  }
+#endif
+  output.binary = binary;
+  output.compress = compress;
+  sc_array_init (&output.buffer, sizeof (char));
+  output.points = NULL;
+  output.cells = NULL;
 
   /* process 0 creates the .pvtu file */
   if (forest->mpirank == 0) {
@@ -807,8 +990,38 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
   if (write_ghosts) {
     num_elements += t8_forest_get_num_ghosts (forest);
   }
-  /* The local number of points, counted with multiplicity */
-  num_points = t8_forest_num_points (forest, write_ghosts);
+  if (region != NULL) {
+    /* Select the elements to write */
+    t8_forest_vtk_select_cells (forest, region, cells);
+    output.cells = &cells;
+    num_elements = (t8_locidx_t) cells.size ();
+    num_points = 0;
+    for (const t8_forest_vtk_cell_t &cell : cells) {
+      const t8_eclass_scheme_c *ts
+        = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, cell.ltreeid));
+      num_points += t8_eclass_num_vertices[ts->t8_element_shape (cell.element)];
+    }
+    if (region->max_level >= 0 && num_data > 0) {
+      /* Merged leaves are written with the average of their data */
+      averaged_data.assign (data, data + num_data);
+      averaged_values.resize (num_data);
+      for (int idata = 0; idata < num_data; idata++) {
+        t8_forest_vtk_average_cell_data (forest, cells, &data[idata], averaged_values[idata]);
+        averaged_data[idata].data = averaged_values[idata].data ();
+      }
+      data = averaged_data.data ();
+    }
+  }
+  else if (unique_points) {
+    /* Number the points such that each point is written only once */
+    t8_forest_vtk_compute_points (forest, write_ghosts, &points);
+    output.points = &points;
+    num_points = (t8_locidx_t) (points.coordinates.size () / 3);
+  }
+  else {
+    /* The local number of points, counted with multiplicity */
+    num_points = t8_forest_vtk_num_points (forest, write_ghosts);
+  }
 
   /* The filename for this processes file */
   freturn = snprintf (vtufilename, BUFSIZ, "%s_%04d.vtu", fileprefix, forest->mpirank);
@@ -818,18 +1031,27 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
   }
 
   /* Open the vtufile to write to */
-  vtufile = fopen (vtufilename, "w");
+  vtufile = fopen (vtufilename, binary ? "wb" : "w");
   if (vtufile == NULL) {
     t8_errorf ("Error when opening file %s\n", vtufilename);
     goto t8_forest_vtk_failure;
   }
+  output.vtufile = vtufile;
   /* Write the header information in the .vtu file.
    * xml type, Unstructured grid and number of points and elements. */
   freturn = fprintf (vtufile, "<?xml version=\"1.0\"?>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_failure;
   }
-  freturn = fprintf (vtufile, "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\"");
+  if (binary) {
+    /* The size headers of the appended data arrays are 64 bit integers,
+     * which requires version 1.0 of the file format. */
+    freturn = fprintf (vtufile, "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" header_type=\"UInt64\"%s",
+                       compress ? " compressor=\"vtkZLibDataCompressor\"" : "");
+  }
+  else {
+    freturn = fprintf (vtufile, "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\"");
+  }
   if (freturn <= 0) {
     goto t8_forest_vtk_failure;
   }
@@ -851,20 +1073,37 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
     goto t8_forest_vtk_failure;
   }
   /* write the point data */
-  if (!t8_forest_vtk_write_points (forest, vtufile, write_ghosts, num_data, data)) {
+  if (!t8_forest_vtk_write_points (forest, &output, write_ghosts, num_data, data)) {
     /* writings points was not successful */
     goto t8_forest_vtk_failure;
   }
   /* write the cell data */
-  if (!t8_forest_vtk_write_cells (forest, vtufile, write_treeid, write_mpirank, write_level, write_element_id,
+  if (!t8_forest_vtk_write_cells (forest, &output, write_treeid, write_mpirank, write_level, write_element_id,
                                   write_ghosts, num_data, data)) {
     /* Writing cells was not successful */
     goto t8_forest_vtk_failure;
   }
 
   freturn = fprintf (vtufile, "    </Piece>\n"
-                              "  </UnstructuredGrid>\n"
-                              "</VTKFile>\n");
+                              "  </UnstructuredGrid>\n");
+  if (freturn <= 0) {
+    goto t8_forest_vtk_failure;
+  }
+  if (binary) {
+    /* Write all data arrays with one call. The appended data starts after the '_'. */
+    freturn = fprintf (vtufile, "  <AppendedData encoding=\"raw\">\n   _");
+    if (freturn <= 0) {
+      goto t8_forest_vtk_failure;
+    }
+    if (fwrite (output.appended.data (), 1, output.appended.size (), vtufile) != output.appended.size ()) {
+      goto t8_forest_vtk_failure;
+    }
+    freturn = fprintf (vtufile, "\n  </AppendedData>\n");
+    if (freturn <= 0) {
+      goto t8_forest_vtk_failure;
+    }
+  }
+  freturn = fprintf (vtufile, "</VTKFile>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_failure;
   }
@@ -879,16 +1118,102 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
     t8_global_errorf ("Error when closing file %s\n", vtufilename);
     goto t8_forest_vtk_failure;
   }
+  sc_array_reset (&output.buffer);
+  t8_forest_vtk_destroy_cells (forest, cells);
   /* Writing was successful */
   return 1;
 t8_forest_vtk_failure:
   if (vtufile != NULL) {
     fclose (vtufile);
   }
+  sc_array_reset (&output.buffer);
+  t8_forest_vtk_destroy_cells (forest, cells);
   t8_errorf ("Error when writing vtk file.\n");
   return 0;
 }
 
+int
+t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                           const int write_level, const int write_element_id, int write_ghosts, const int num_data,
+                           t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_ext (forest, fileprefix, write_treeid, write_mpirank, write_level, write_element_id,
+                                  write_ghosts, 0, 0, 0, NULL, num_data, data);
+}
+
+/* Add a data array to a list of arrays. */
+static void
+t8_forest_vtk_add_array (std::vector<t8_forest_vtk_array_t> &arrays, const std::string &name, const char *datatype,
+                         const int num_components, const int per_point, t8_forest_vtk_cell_data_kernel kernel,
+                         void *udata)
+{
+  static const size_t value_sizes[] = { sizeof (uint8_t), sizeof (int32_t), sizeof (int64_t), sizeof (float),
+                                        sizeof (double) };
+  t8_forest_vtk_array_t array;
+
+  array.name = name;
+  array.datatype = datatype;
+  array.value_size = value_sizes[t8_forest_vtk_value_type (datatype)];
+  array.num_components = num_components;
+  array.per_point = per_point;
+  array.point_indices
+    = kernel == t8_forest_vtk_cells_connectivity_kernel || kernel == t8_forest_vtk_cells_offset_kernel;
+  array.kernel = kernel;
+  array.udata = udata;
+  arrays.push_back (array);
+}
+
+/* Collect the data arrays of a .vtu file of the forest, grouped into the sections
+ * Points, Cells, PointData and CellData. The first array of each section is stored
+ * in \a section_begin, with section_begin[4] the number of arrays.
+ * If \a shared is true, the arrays are meant for a file that is shared by all processes.
+ * Then we use 64 bit integers for all indices, since they refer to global points and elements.
+ * Otherwise, the types are the same as in the ASCII files. */
+void
+t8_forest_vtk_collect_arrays (t8_forest_t forest, const int write_treeid, const int write_mpirank,
+                              const int write_level, const int write_element_id, const int num_data,
+                              t8_vtk_data_field_t *data, const int shared, std::vector<t8_forest_vtk_array_t> &arrays,
+                              size_t section_begin[5])
+{
+  const char *index_type = shared ? "Int64" : T8_VTK_LOCIDX;
+
+  section_begin[0] = arrays.size ();
+  t8_forest_vtk_add_array (arrays, "Position", T8_VTK_FLOAT_NAME, 3, 1, t8_forest_vtk_cells_vertices_kernel, NULL);
+  section_begin[1] = arrays.size ();
+  t8_forest_vtk_add_array (arrays, "connectivity", index_type, 1, 1, t8_forest_vtk_cells_connectivity_kernel, NULL);
+  t8_forest_vtk_add_array (arrays, "offsets", index_type, 1, 0, t8_forest_vtk_cells_offset_kernel, NULL);
+  t8_forest_vtk_add_array (arrays, "types", shared ? "UInt8" : "Int32", 1, 0, t8_forest_vtk_cells_type_kernel, NULL);
+  section_begin[2] = arrays.size ();
+  for (int idata = 0; idata < num_data; idata++) {
+    const int is_scalar = data[idata].type == T8_VTK_SCALAR;
+    t8_forest_vtk_add_array (
+      arrays, std::string (data[idata].description) + "_points", T8_VTK_FLOAT_NAME, is_scalar ? 1 : 3, 1,
+      is_scalar ? t8_forest_vtk_vertices_scalar_kernel : t8_forest_vtk_vertices_vector_kernel, data[idata].data);
+  }
+  section_begin[3] = arrays.size ();
+  if (write_treeid) {
+    t8_forest_vtk_add_array (arrays, "treeid", shared ? "Int64" : T8_VTK_GLOIDX, 1, 0,
+                             t8_forest_vtk_cells_treeid_kernel, NULL);
+  }
+  if (write_mpirank) {
+    t8_forest_vtk_add_array (arrays, "mpirank", "Int32", 1, 0, t8_forest_vtk_cells_rank_kernel, NULL);
+  }
+  if (write_level) {
+    t8_forest_vtk_add_array (arrays, "level", "Int32", 1, 0, t8_forest_vtk_cells_level_kernel, NULL);
+  }
+  if (write_element_id) {
+    const char *id_type = shared || forest->global_num_elements > T8_LOCIDX_MAX ? "Int64" : T8_VTK_LOCIDX;
+    t8_forest_vtk_add_array (arrays, "element_id", id_type, 1, 0, t8_forest_vtk_cells_elementid_kernel, NULL);
+  }
+  for (int idata = 0; idata < num_data; idata++) {
+    const int is_scalar = data[idata].type == T8_VTK_SCALAR;
+    t8_forest_vtk_add_array (arrays, data[idata].description, T8_VTK_FLOAT_NAME, is_scalar ? 1 : 3, 0,
+                             is_scalar ? t8_forest_vtk_cells_scalar_kernel : t8_forest_vtk_cells_vector_kernel,
+                             data[idata].data);
+  }
+  section_begin[4] = arrays.size ();
+}
+
 /* Return the local number of vertices in a cmesh.
  * \param [in] cmesh       The cmesh to be considered.
  * \param [in] count_ghosts If true, we also count the vertices of the ghost trees.
@@ -25,6 +25,7 @@
 
 #include "t8_forest/t8_forest_types.h"
 #include "t8_vtk.h"
+#include "t8_vtk/t8_vtk_writer.h"
 
 /** Write the forest in .pvtu file format. Writes one .vtu file per
  * process and a meta .pvtu file.
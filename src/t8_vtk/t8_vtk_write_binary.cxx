@@ -0,0 +1,298 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "t8_vtk/t8_vtk_write_binary.hxx"
+#include "t8_vtk/t8_vtk_write_private.hxx"
+#include "t8_forest/t8_forest_types.h"
+#include "t8_forest/t8_forest_private.h"
+#include <t8_forest/t8_forest_general.h>
+#include <string>
+#include <vector>
+#ifdef SC_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+/* The binary .vtu files store the values of each data array in raw form in one
+ * <AppendedData> section at the end of the file. If libsc was configured with zlib,
+ * the arrays can additionally be compressed. */
+
+/* The uncompressed size in bytes of one zlib block of a compressed data array. */
+#define T8_VTK_ZLIB_BLOCK_SIZE (1 << 16)
+
+/* Encode raw values as a data block of the appended data section.
+ * Uncompressed blocks consist of the number of bytes as UInt64 followed by the raw values.
+ * Compressed blocks are split into chunks of T8_VTK_ZLIB_BLOCK_SIZE bytes that are compressed
+ * separately. The header of the block consists of the number of chunks, the uncompressed
+ * chunk size, the uncompressed size of the last chunk and the compressed size of each chunk.
+ * This function does not allocate via libsc, such that the I/O thread of an asynchronous
+ * writer can call it. */
+static int
+t8_forest_vtk_encode_values (const char *values, const uint64_t num_bytes, const int compress,
+                             std::vector<char> &appended)
+{
+  if (!compress) {
+    const char *size_bytes = (const char *) &num_bytes;
+    appended.insert (appended.end (), size_bytes, size_bytes + sizeof (uint64_t));
+    appended.insert (appended.end (), values, values + num_bytes);
+    return 1;
+  }
+#ifdef SC_HAVE_ZLIB
+  const uint64_t num_chunks = (num_bytes + T8_VTK_ZLIB_BLOCK_SIZE - 1) / T8_VTK_ZLIB_BLOCK_SIZE;
+  const size_t header_offset = appended.size ();
+  uint64_t header[3] = { num_chunks, T8_VTK_ZLIB_BLOCK_SIZE, num_bytes % T8_VTK_ZLIB_BLOCK_SIZE };
+
+  /* Reserve the header, the compressed sizes are filled in below */
+  appended.resize (header_offset + (3 + num_chunks) * sizeof (uint64_t));
+  memcpy (appended.data () + header_offset, header, sizeof (header));
+  for (uint64_t ichunk = 0; ichunk < num_chunks; ichunk++) {
+    const size_t chunk_size = SC_MIN (T8_VTK_ZLIB_BLOCK_SIZE, num_bytes - ichunk * T8_VTK_ZLIB_BLOCK_SIZE);
+    const Bytef *chunk = (const Bytef *) values + ichunk * T8_VTK_ZLIB_BLOCK_SIZE;
+    const size_t chunk_offset = appended.size ();
+    uLongf compressed_size = compressBound (chunk_size);
+
+    appended.resize (chunk_offset + compressed_size);
+    /* We favor speed over compression ratio */
+    if (compress2 ((Bytef *) appended.data () + chunk_offset, &compressed_size, chunk, chunk_size, Z_BEST_SPEED)
+        != Z_OK) {
+      t8_errorf ("Error when compressing vtk data.\n");
+      return 0;
+    }
+    appended.resize (chunk_offset + compressed_size);
+    const uint64_t compressed_bytes = compressed_size;
+    memcpy (appended.data () + header_offset + (3 + ichunk) * sizeof (uint64_t), &compressed_bytes,
+            sizeof (uint64_t));
+  }
+  return 1;
+#else
+  SC_ABORT_NOT_REACHED ();
+  return 0;
+#endif
+}
+
+/* Move the values in the output's buffer to the appended data of the output. */
+int
+t8_forest_vtk_append_buffer (t8_forest_vtk_output_t *output)
+{
+  const int success = t8_forest_vtk_encode_values (output->buffer.array, output->buffer.elem_count,
+                                                   output->compress, output->appended);
+  sc_array_truncate (&output->buffer);
+  return success;
+}
+
+int
+t8_forest_vtk_write_binary (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                            const int write_level, const int write_element_id, int write_ghosts, const int compress,
+                            const int num_data, t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_ext (forest, fileprefix, write_treeid, write_mpirank, write_level, write_element_id,
+                                  write_ghosts, 1, compress, 0, NULL, num_data, data);
+}
+
+/* Build the xml part of a .vtu file up to and including the '_' that starts the appended data.
+ * \a offsets contains the position of each array in the appended data. */
+std::string
+t8_forest_vtk_appended_header (const std::vector<t8_forest_vtk_array_t> &arrays, const size_t section_begin[5],
+                               const t8_gloidx_t num_points, const t8_gloidx_t num_elements, const uint64_t *offsets,
+                               const int compress)
+{
+  static const char *section_names[4] = { "Points", "Cells", "PointData", "CellData" };
+  std::string header;
+  char line[BUFSIZ];
+
+  header += "<?xml version=\"1.0\"?>\n";
+  header += "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" header_type=\"UInt64\"";
+  if (compress) {
+    header += " compressor=\"vtkZLibDataCompressor\"";
+  }
+#ifdef SC_IS_BIGENDIAN
+  header += " byte_order=\"BigEndian\">\n";
+#else
+  header += " byte_order=\"LittleEndian\">\n";
+#endif
+  header += "  <UnstructuredGrid>\n";
+  snprintf (line, BUFSIZ, "    <Piece NumberOfPoints=\"%lld\" NumberOfCells=\"%lld\">\n", (long long) num_points,
+            (long long) num_elements);
+  header += line;
+  for (int isection = 0; isection < 4; isection++) {
+    if (section_begin[isection] == section_begin[isection + 1]) {
+      /* Skip empty sections */
+      continue;
+    }
+    header += std::string ("      <") + section_names[isection] + ">\n";
+    for (size_t iarray = section_begin[isection]; iarray < section_begin[isection + 1]; iarray++) {
+      const t8_forest_vtk_array_t &array = arrays[iarray];
+      snprintf (line, BUFSIZ,
+                "        <DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"%i\" format=\"appended\" "
+                "offset=\"%llu\"/>\n",
+                array.datatype, array.name.c_str (), array.num_components, (unsigned long long) offsets[iarray]);
+      header += line;
+    }
+    header += std::string ("      </") + section_names[isection] + ">\n";
+  }
+  header += "    </Piece>\n"
+            "  </UnstructuredGrid>\n"
+            "  <AppendedData encoding=\"raw\">\n"
+            "   _";
+  return header;
+}
+
+/* The values of all data arrays of the .vtu file of one process. */
+struct t8_forest_vtk_snapshot
+{
+  std::string fileprefix;                    /* The prefix of the output files. */
+  int mpirank;                               /* The rank of this process. */
+  int mpisize;                               /* The number of processes. */
+  int write_treeid, write_mpirank;           /* The flags for the .pvtu file. */
+  int write_level, write_element_id;         /* The flags for the .pvtu file. */
+  std::vector<t8_vtk_data_field_t> fields;   /* The user data fields without their data, for the .pvtu file. */
+  int compress;                              /* True if the arrays are compressed when writing. */
+  t8_locidx_t num_points;                    /* The number of points of the piece. */
+  t8_locidx_t num_elements;                  /* The number of elements of the piece. */
+  std::vector<t8_forest_vtk_array_t> arrays; /* The data arrays. */
+  size_t section_begin[5];                   /* The first array of each section. */
+  std::vector<std::vector<char>> values;     /* The raw values of each array. They are not stored in sc_arrays,
+                                                since the snapshot is written and freed on another thread. */
+};
+
+t8_forest_vtk_snapshot_t *
+t8_forest_vtk_snapshot_new (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                            const int write_level, const int write_element_id, int write_ghosts, int compress,
+                            const int num_data, t8_vtk_data_field_t *data)
+{
+  t8_forest_vtk_snapshot_t *snapshot = new t8_forest_vtk_snapshot_t;
+  t8_forest_vtk_output_t output;
+
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (t8_forest_is_committed (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_vtk_snapshot_new");
+  T8_ASSERT (fileprefix != NULL);
+  if (forest->ghosts == NULL || forest->ghosts->num_ghosts_elements == 0) {
+    /* Never write ghost elements if there aren't any */
+    write_ghosts = 0;
+  }
+#ifndef SC_HAVE_ZLIB
+  if (compress) {
+    t8_global_errorf ("WARNING: libsc was not configured with zlib. Writing uncompressed vtk files instead.\n");
+    compress = 0;
+  }
+#endif
+  snapshot->fileprefix = fileprefix;
+  snapshot->mpirank = forest->mpirank;
+  snapshot->mpisize = forest->mpisize;
+  snapshot->write_treeid = write_treeid;
+  snapshot->write_mpirank = write_mpirank;
+  snapshot->write_level = write_level;
+  snapshot->write_element_id = write_element_id;
+  snapshot->fields.assign (data, data + num_data);
+  for (t8_vtk_data_field_t &field : snapshot->fields) {
+    field.data = NULL;
+  }
+  snapshot->compress = compress;
+  snapshot->num_points = t8_forest_vtk_num_points (forest, write_ghosts);
+  snapshot->num_elements = t8_forest_get_local_num_elements (forest);
+  if (write_ghosts) {
+    snapshot->num_elements += t8_forest_get_num_ghosts (forest);
+  }
+  t8_forest_vtk_collect_arrays (forest, write_treeid, write_mpirank, write_level, write_element_id, num_data, data, 0,
+                                snapshot->arrays, snapshot->section_begin);
+
+  /* Compute the values of all arrays. Afterwards, the snapshot does not refer to the
+   * forest or the user data anymore. */
+  output.vtufile = NULL;
+  output.binary = 1;
+  output.compress = 0;
+  output.points = NULL;
+  output.cells = NULL;
+  sc_array_init (&output.buffer, sizeof (char));
+  for (const t8_forest_vtk_array_t &array : snapshot->arrays) {
+    t8_forest_vtk_write_cell_data (forest, &output, array.name.c_str (), array.datatype, "", 1, array.kernel,
+                                   write_ghosts, array.udata);
+    snapshot->values.emplace_back (output.buffer.array, output.buffer.array + output.buffer.elem_count);
+    sc_array_truncate (&output.buffer);
+  }
+  sc_array_reset (&output.buffer);
+  return snapshot;
+}
+
+size_t
+t8_forest_vtk_snapshot_num_bytes (const t8_forest_vtk_snapshot_t *snapshot)
+{
+  size_t num_bytes = 0;
+
+  for (const std::vector<char> &values : snapshot->values) {
+    num_bytes += values.size ();
+  }
+  return num_bytes;
+}
+
+int
+t8_forest_vtk_snapshot_write (t8_forest_vtk_snapshot_t *snapshot)
+{
+  std::vector<uint64_t> offsets;
+  std::vector<char> appended;
+  char vtufilename[BUFSIZ];
+  FILE *vtufile;
+  int success = 1;
+
+  /* process 0 creates the .pvtu file */
+  if (snapshot->mpirank == 0) {
+    if (t8_write_pvtu (snapshot->fileprefix.c_str (), snapshot->mpisize, snapshot->write_treeid,
+                       snapshot->write_mpirank, snapshot->write_level, snapshot->write_element_id,
+                       (int) snapshot->fields.size (), snapshot->fields.data ())) {
+      t8_errorf ("Error when writing file %s.pvtu\n", snapshot->fileprefix.c_str ());
+      success = 0;
+    }
+  }
+
+  /* Encode the arrays and release their raw values */
+  for (std::vector<char> &values : snapshot->values) {
+    offsets.push_back (appended.size ());
+    success = success && t8_forest_vtk_encode_values (values.data (), values.size (), snapshot->compress, appended);
+    std::vector<char> ().swap (values);
+  }
+  const std::string header
+    = t8_forest_vtk_appended_header (snapshot->arrays, snapshot->section_begin, snapshot->num_points,
+                                     snapshot->num_elements, offsets.data (), snapshot->compress);
+
+  snprintf (vtufilename, BUFSIZ, "%s_%04d.vtu", snapshot->fileprefix.c_str (), snapshot->mpirank);
+  vtufile = success ? fopen (vtufilename, "wb") : NULL;
+  if (vtufile == NULL) {
+    t8_errorf ("Error when writing vtk file %s.\n", vtufilename);
+    return 0;
+  }
+  success = fwrite (header.c_str (), 1, header.size (), vtufile) == header.size ();
+  success = success && fwrite (appended.data (), 1, appended.size (), vtufile) == appended.size ();
+  success = success && fprintf (vtufile, "\n  </AppendedData>\n</VTKFile>\n") > 0;
+  success = fclose (vtufile) == 0 && success;
+  if (!success) {
+    t8_errorf ("Error when writing vtk file %s.\n", vtufilename);
+  }
+  return success;
+}
+
+void
+t8_forest_vtk_snapshot_destroy (t8_forest_vtk_snapshot_t **psnapshot)
+{
+  T8_ASSERT (psnapshot != NULL && *psnapshot != NULL);
+  delete *psnapshot;
+  *psnapshot = NULL;
+}
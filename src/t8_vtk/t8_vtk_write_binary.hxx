@@ -0,0 +1,94 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef T8_VTK_WRITE_BINARY_HXX
+#define T8_VTK_WRITE_BINARY_HXX
+
+#include "t8_forest/t8_forest_types.h"
+#include "t8_vtk.h"
+#include "t8_vtk/t8_vtk_writer.h"
+
+/** Write the forest in .pvtu file format. Writes one .vtu file per
+ * process and a meta .pvtu file.
+ * The data arrays of the .vtu files are stored in binary form in a raw
+ * appended data section, which is considerably faster to write and smaller
+ * than the ASCII output of \ref t8_forest_vtk_write_ASCII.
+ * Does not require the vtk library.
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output files.
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element.
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ * \param [in]  write_ghosts If true, each process additionally writes its ghost elements.
+ *                           For ghost element the treeid is -1.
+ * \param [in]  compress  If true, the data arrays are zlib compressed.
+ *                        Ignored with a warning if libsc was not configured with zlib.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the used defined per element data.
+ *                        If scalar and vector fields are used, all scalar fields
+ *                        must come first in the array.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_vtk_write_binary (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                            const int write_level, const int write_element_id, int write_ghosts, const int compress,
+                            const int num_data, t8_vtk_data_field_t *data);
+
+/** The values of all data arrays of the .vtu file of one process, computed from a forest.
+ * A snapshot can be written to disk without accessing the forest or the user data. */
+typedef struct t8_forest_vtk_snapshot t8_forest_vtk_snapshot_t;
+
+/** Compute the binary values of all data arrays of this process's .vtu file.
+ * The point coordinates are evaluated and the user data is copied, such that
+ * the forest and \a data may be modified or destroyed afterwards.
+ * The parameters are the same as for \ref t8_forest_vtk_write_binary.
+ * \return  The snapshot. Must be destroyed with \ref t8_forest_vtk_snapshot_destroy.
+ */
+t8_forest_vtk_snapshot_t *
+t8_forest_vtk_snapshot_new (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                            const int write_level, const int write_element_id, int write_ghosts, int compress,
+                            const int num_data, t8_vtk_data_field_t *data);
+
+/** Return the number of bytes of the raw values stored in a snapshot. */
+size_t
+t8_forest_vtk_snapshot_num_bytes (const t8_forest_vtk_snapshot_t *snapshot);
+
+/** Write a snapshot to this process's .vtu file and, on process zero, the .pvtu file.
+ * The file layout is the same as for \ref t8_forest_vtk_write_binary.
+ * This function does not call MPI, does not access the forest and does not allocate
+ * via libsc, thus it can be called from any thread. The raw values of the snapshot are
+ * released while writing, so it can be written only once.
+ * \param [in,out] snapshot  The snapshot.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_vtk_snapshot_write (t8_forest_vtk_snapshot_t *snapshot);
+
+/** Destroy a snapshot. Like \ref t8_forest_vtk_snapshot_write, this can be called from any thread.
+ * \param [in,out] psnapshot  The snapshot. Set to NULL on output.
+ */
+void
+t8_forest_vtk_snapshot_destroy (t8_forest_vtk_snapshot_t **psnapshot);
+
+#endif /* T8_VTK_WRITE_BINARY_HXX */
@@ -0,0 +1,257 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_vtk_write_private.hxx
+ * Types and functions that are shared by the vtu writers of a forest
+ * in t8_vtk_write_ASCII.cxx, t8_vtk_write_binary.cxx, t8_vtk_write_shared.cxx,
+ * t8_vtk_write_unique_points.cxx and t8_vtk_write_region.cxx.
+ */
+
+#ifndef T8_VTK_WRITE_PRIVATE_HXX
+#define T8_VTK_WRITE_PRIVATE_HXX
+
+#include <t8_forest/t8_forest_types.h>
+#include <t8_element.hxx>
+#include <t8_vtk.h>
+#include <string>
+#include <vector>
+
+/* There are different cell data to write, e.g. connectivity, type, vertices, ...
+ * The structure is always the same:
+ * Iterate over the trees,
+ *      iterate over the elements of that tree
+ *          execute an element dependent part to write in the file.
+ * In order to simplify writing this code, we put all the parts that are
+ * repetitive in the function
+ *  t8_forest_vtk_write_cell_data.
+ * This function accepts a callback function, which is then executed for
+ * each element. The callback function is defined below.
+ */
+/* TODO: As soon as we have element iterators we should restructure this concept
+ * appropriately. */
+typedef enum { T8_VTK_KERNEL_INIT, T8_VTK_KERNEL_EXECUTE, T8_VTK_KERNEL_CLEANUP } T8_VTK_KERNEL_MODUS;
+
+/** The binary types of the values of a data array. */
+typedef enum { T8_VTK_UINT8, T8_VTK_INT32, T8_VTK_INT64, T8_VTK_FLOAT32, T8_VTK_FLOAT64 } t8_vtk_value_type_t;
+
+/** The unique points of the elements of a forest, if each point is written only once. */
+typedef struct
+{
+  std::vector<t8_locidx_t> corner_points;   /**< For each element corner in vtk order the index of its point. */
+  std::vector<t8_locidx_t> corner_elements; /**< For each element corner the local index of its element,
+                                                 -1 for ghost elements. */
+  std::vector<double> coordinates;          /**< The coordinates of the points, 3 per point. */
+} t8_forest_vtk_points_t;
+
+/** An element that is written if only a part of the forest is written. */
+typedef struct
+{
+  t8_locidx_t ltreeid;    /**< The local tree of the element. */
+  t8_locidx_t first_leaf; /**< The index in the tree of the first leaf of the forest covered by the element. */
+  t8_locidx_t num_leaves; /**< The number of leaves covered by the element. */
+  t8_element_t *element;  /**< The element. Either a leaf of the forest or the ancestor of the leaves. */
+  int is_ancestor;        /**< True if \a element is an ancestor of the leaves, which is owned by the cell. */
+} t8_forest_vtk_cell_t;
+
+/** The elements that are written if only a part of the forest is written. */
+typedef std::vector<t8_forest_vtk_cell_t> t8_forest_vtk_cells_t;
+
+/** The output stream to which the kernels write their values. */
+typedef struct
+{
+  FILE *vtufile;                        /**< The open file stream. The xml structure is always written to it.
+                                             If NULL in binary mode, the values of a data array remain in
+                                             \a buffer for the caller. */
+  int binary;                           /**< If true, the kernels append their values to \a buffer instead of
+                                             printing them to \a vtufile. */
+  int compress;                         /**< If true, the data arrays are zlib compressed in binary mode. */
+  t8_vtk_value_type_t value_type;       /**< The type of the values of the current data array in binary mode. */
+  sc_array_t buffer;                    /**< The raw values of the current data array in binary mode. */
+  std::vector<char> appended;           /**< The encoded data arrays that are written at the end of the file
+                                             in binary mode. */
+  const t8_forest_vtk_points_t *points; /**< If not NULL, each point is written only once and the
+                                             connectivity refers to these points. */
+  const t8_forest_vtk_cells_t *cells;   /**< If not NULL, only these elements are written instead of
+                                             the leaves of the forest. */
+} t8_forest_vtk_output_t;
+
+/** Callback function prototype for writing cell data.
+ * The function is executed for each element.
+ * The callback can run in three different modi:
+ *  INIT    - Called once, to (possibly) initialize the data pointer
+ *  EXECUTE - Called for each element, the actual writing happens here.
+ *  CLEANUP - Called once after all elements. Used to cleanup any memory
+ *            allocated during INIT.
+ * \param [in] forest The forest.
+ * \param [in] ltree_id   A local treeid.
+ * \param [in] tree   The local tree of the forest with id \a ltree_id.
+ * \param [in] element_index An index of an element inside \a tree.
+ * \param [in] element  A pointer to the current element.
+ * \param [in] element_shape The shape of the current element.
+ * \param [in] element_level The level of the current element.
+ * \param [in] is_ghost Non-zero if the current element is a ghost element.
+ *                      In this cas \a tree is NULL.
+ *                      All ghost element will be traversed after all elements are
+ * \param [in,out] output  The output to which we write the forest.
+ *                         The values should be written with \ref t8_forest_vtk_write_int
+ *                         and \ref t8_forest_vtk_write_float.
+ * \param [in,out] columns An integer counting the number of written columns.
+ *                         The callback should increase this value by the number
+ *                         of values written to the file.
+ * \param [in,out] data    A pointer that the callback can modify at will.
+ *                         Between modi INIT and CLEANUP, \a data will not be
+ *                         modified outside of this callback.
+ * \param [in]     modus   The modus in which the callback is called. See above.
+ * \return                 True if successful, false if not (i.e. file i/o error).
+ */
+typedef int (*t8_forest_vtk_cell_data_kernel) (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
+                                               const t8_locidx_t element_index, const t8_element_t *element,
+                                               const t8_element_shape_t element_shape, const int element_level,
+                                               const int is_ghost, t8_forest_vtk_output_t *output, int *columns,
+                                               void **data, T8_VTK_KERNEL_MODUS modus);
+
+/** A data array of a .vtu file with appended data. */
+typedef struct
+{
+  std::string name;                      /**< The name of the array. */
+  const char *datatype;                  /**< The vtk type name of the values. */
+  size_t value_size;                     /**< The number of bytes of one value. */
+  int num_components;                    /**< The number of values per point or element. */
+  int per_point;                         /**< True for point arrays, false for cell arrays. */
+  int point_indices;                     /**< True if the values are process local point indices. */
+  t8_forest_vtk_cell_data_kernel kernel; /**< The kernel that computes the values. */
+  void *udata;                           /**< The user data passed to the kernel. */
+} t8_forest_vtk_array_t;
+
+/** Return the number of points of the local elements of a forest when each element writes its own corners.
+ * \param [in] forest       The forest.
+ * \param [in] count_ghosts If true, the corners of the ghost elements are counted as well.
+ * \return                  The number of points.
+ */
+t8_locidx_t
+t8_forest_vtk_num_points (t8_forest_t forest, const int count_ghosts);
+
+/** Write a data array of the forest to the output by calling a kernel for each element.
+ * In ASCII mode the values are printed to the file of the output.
+ * In binary mode only the xml header of the data array is written to the file
+ * and the values are added to the appended data of the output.
+ * If the output has no file, the raw values remain in the output's buffer.
+ * \return True if successful, false if not.
+ */
+int
+t8_forest_vtk_write_cell_data (t8_forest_t forest, t8_forest_vtk_output_t *output, const char *dataname,
+                               const char *datatype, const char *component_string, const int max_columns,
+                               t8_forest_vtk_cell_data_kernel kernel, const int write_ghosts, void *udata);
+
+/** Collect the data arrays of a .vtu file of the forest, grouped into the sections
+ * Points, Cells, PointData and CellData. The first array of each section is stored
+ * in \a section_begin, with section_begin[4] the number of arrays.
+ * If \a shared is true, the arrays are meant for a file that is shared by all processes.
+ * Then we use 64 bit integers for all indices, since they refer to global points and elements.
+ */
+void
+t8_forest_vtk_collect_arrays (t8_forest_t forest, const int write_treeid, const int write_mpirank,
+                              const int write_level, const int write_element_id, const int num_data,
+                              t8_vtk_data_field_t *data, const int shared, std::vector<t8_forest_vtk_array_t> &arrays,
+                              size_t section_begin[5]);
+
+/** Write the forest in .pvtu file format, either in ASCII mode or in binary mode with
+ * the data arrays in a raw appended data section.
+ * If \a compress is true, the appended data arrays are zlib compressed.
+ * If \a unique_points is true, each point is written only once and the point data is averaged.
+ * If \a region is not NULL, only the part of the forest selected by \a region is written.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_vtk_write_ext (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                         const int write_level, const int write_element_id, int write_ghosts, const int binary,
+                         int compress, const int unique_points, const t8_vtk_region_t *region, const int num_data,
+                         t8_vtk_data_field_t *data);
+
+/** Compute a process local numbering of the points of the local elements and, if \a write_ghosts
+ * is true, of the ghost elements, such that each point that is shared by several elements gets only one index.
+ * \param [in]  forest       The forest.
+ * \param [in]  write_ghosts If true, the points of the ghost elements are numbered as well.
+ * \param [out] points       The unique points and the point of each element corner.
+ */
+void
+t8_forest_vtk_compute_points (t8_forest_t forest, const int write_ghosts, t8_forest_vtk_points_t *points);
+
+/** Average element data over the local elements adjacent to each point.
+ * Points without adjacent local elements get the value 0.
+ * \param [in]  points          The unique points of the forest.
+ * \param [in]  element_values  \a num_components values per local element.
+ * \param [in]  num_components  The number of values per element.
+ * \param [out] point_values    On output \a num_components values per point.
+ */
+void
+t8_forest_vtk_average_point_data (const t8_forest_vtk_points_t *points, const double *element_values,
+                                  const int num_components, std::vector<double> &point_values);
+
+/** Select the elements of a region that are written.
+ * Leaves finer than the maximum level of the region are replaced by their ancestor of that level.
+ * \param [in]  forest The forest.
+ * \param [in]  region The part of the forest to write.
+ * \param [out] cells  The selected elements. Must be destroyed with \ref t8_forest_vtk_destroy_cells.
+ */
+void
+t8_forest_vtk_select_cells (t8_forest_t forest, const t8_vtk_region_t *region, t8_forest_vtk_cells_t &cells);
+
+/** Destroy the ancestors of the selected elements and clear the selection.
+ * \param [in]     forest The forest.
+ * \param [in,out] cells  The selected elements.
+ */
+void
+t8_forest_vtk_destroy_cells (t8_forest_t forest, t8_forest_vtk_cells_t &cells);
+
+/** Copy the values of a data field and replace the values of the first leaf of each selected
+ * element by the average of the values of all its leaves.
+ * \param [in]  forest The forest.
+ * \param [in]  cells  The selected elements.
+ * \param [in]  field  The data field with one entry per local element.
+ * \param [out] values The averaged values.
+ */
+void
+t8_forest_vtk_average_cell_data (t8_forest_t forest, const t8_forest_vtk_cells_t &cells,
+                                 const t8_vtk_data_field_t *field, std::vector<double> &values);
+
+/** Move the values in the output's buffer to the appended data of the output.
+ * \return True if successful, false if not.
+ */
+int
+t8_forest_vtk_append_buffer (t8_forest_vtk_output_t *output);
+
+/** Build the xml part of a .vtu file up to and including the '_' that starts the appended data.
+ * \param [in] arrays        The data arrays of the file.
+ * \param [in] section_begin The first array of each section, see \ref t8_forest_vtk_collect_arrays.
+ * \param [in] num_points    The number of points in the file.
+ * \param [in] num_elements  The number of elements in the file.
+ * \param [in] offsets       The position of each array in the appended data.
+ * \param [in] compress      True if the data arrays are zlib compressed.
+ * \return                   The xml header.
+ */
+std::string
+t8_forest_vtk_appended_header (const std::vector<t8_forest_vtk_array_t> &arrays, const size_t section_begin[5],
+                               const t8_gloidx_t num_points, const t8_gloidx_t num_elements, const uint64_t *offsets,
+                               const int compress);
+
+#endif /* T8_VTK_WRITE_PRIVATE_HXX */
@@ -0,0 +1,185 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "t8_vtk/t8_vtk_write_region.hxx"
+#include "t8_vtk/t8_vtk_write_private.hxx"
+#include "t8_forest/t8_forest_types.h"
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_geometrical.h>
+#include <t8_geometry/t8_geometry.h>
+#include <vector>
+
+/* Return true if the box given by its lower and upper corner intersects the bounding box of a region. */
+static int
+t8_forest_vtk_box_intersects (const double *bounding_box, const double lower[3], const double upper[3])
+{
+  for (int icoord = 0; icoord < 3; icoord++) {
+    if (upper[icoord] < bounding_box[2 * icoord] || lower[icoord] > bounding_box[2 * icoord + 1]) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Return true if a local tree may contain elements of a region.
+ * The bounding box is only checked for trees with linear geometry, since only then
+ * the tree lies inside of the bounding box of its corners. */
+static int
+t8_forest_vtk_tree_in_region (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_vtk_region_t *region)
+{
+  const t8_cmesh_t cmesh = t8_forest_get_cmesh (forest);
+  const t8_gloidx_t gtreeid = t8_forest_global_tree_id (forest, ltreeid);
+  const t8_eclass_t tree_class = t8_forest_get_tree_class (forest, ltreeid);
+  const t8_geometry_type_t geom_type = t8_geometry_get_type (cmesh, gtreeid);
+
+  if (region->bounding_box != NULL
+      && (geom_type == T8_GEOMETRY_TYPE_LINEAR || geom_type == T8_GEOMETRY_TYPE_LINEAR_AXIS_ALIGNED)) {
+    double lower[3], upper[3], coordinates[3];
+    for (int ivertex = 0; ivertex < t8_eclass_num_vertices[tree_class]; ivertex++) {
+      t8_geometry_evaluate (cmesh, gtreeid, t8_element_corner_ref_coords[tree_class][ivertex], 1, coordinates);
+      for (int icoord = 0; icoord < 3; icoord++) {
+        lower[icoord] = ivertex == 0 ? coordinates[icoord] : SC_MIN (lower[icoord], coordinates[icoord]);
+        upper[icoord] = ivertex == 0 ? coordinates[icoord] : SC_MAX (upper[icoord], coordinates[icoord]);
+      }
+    }
+    if (!t8_forest_vtk_box_intersects (region->bounding_box, lower, upper)) {
+      return 0;
+    }
+  }
+  return region->filter == NULL || region->filter (forest, ltreeid, NULL, region->user_data);
+}
+
+/* Return true if an element of a local tree is part of a region. */
+static int
+t8_forest_vtk_element_in_region (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_element_t *element,
+                                 const t8_eclass_scheme_c *ts, const t8_vtk_region_t *region)
+{
+  if (region->bounding_box != NULL) {
+    double lower[3], upper[3], coordinates[3];
+    for (int icorner = 0; icorner < ts->t8_element_num_corners (element); icorner++) {
+      t8_forest_element_coordinate (forest, ltreeid, element, icorner, coordinates);
+      for (int icoord = 0; icoord < 3; icoord++) {
+        lower[icoord] = icorner == 0 ? coordinates[icoord] : SC_MIN (lower[icoord], coordinates[icoord]);
+        upper[icoord] = icorner == 0 ? coordinates[icoord] : SC_MAX (upper[icoord], coordinates[icoord]);
+      }
+    }
+    if (!t8_forest_vtk_box_intersects (region->bounding_box, lower, upper)) {
+      return 0;
+    }
+  }
+  return region->filter == NULL || region->filter (forest, ltreeid, element, region->user_data);
+}
+
+/* Select the elements of a region that are written.
+ * Consecutive leaves of a level finer than the maximum level of the region are replaced by
+ * their common ancestor of the maximum level. Since we only consider local leaves, an ancestor
+ * whose leaves are distributed to several processes is written by each of these processes. */
+void
+t8_forest_vtk_select_cells (t8_forest_t forest, const t8_vtk_region_t *region, t8_forest_vtk_cells_t &cells)
+{
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    if (!t8_forest_vtk_tree_in_region (forest, itree, region)) {
+      continue;
+    }
+    const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    const t8_locidx_t num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    t8_locidx_t ielement = 0;
+
+    while (ielement < num_elements) {
+      const t8_element_t *leaf = t8_forest_get_element_in_tree (forest, itree, ielement);
+      /* Leaves are only referenced, never modified */
+      t8_forest_vtk_cell_t cell = { itree, ielement, 1, (t8_element_t *) leaf, 0 };
+
+      if (region->max_level >= 0 && ts->t8_element_level (leaf) > region->max_level) {
+        /* All following leaves with the same ancestor are merged */
+        const t8_linearidx_t ancestor_id = ts->t8_element_get_linear_id (leaf, region->max_level);
+        while (ielement + cell.num_leaves < num_elements
+               && ts->t8_element_get_linear_id (
+                    t8_forest_get_element_in_tree (forest, itree, ielement + cell.num_leaves), region->max_level)
+                    == ancestor_id) {
+          cell.num_leaves++;
+        }
+        ts->t8_element_new (1, &cell.element);
+        ts->t8_element_set_linear_id (cell.element, region->max_level, ancestor_id);
+        cell.is_ancestor = 1;
+      }
+      ielement += cell.num_leaves;
+      if (t8_forest_vtk_element_in_region (forest, itree, cell.element, ts, region)) {
+        cells.push_back (cell);
+      }
+      else if (cell.is_ancestor) {
+        ts->t8_element_destroy (1, &cell.element);
+      }
+    }
+  }
+}
+
+/* Destroy the ancestors of the selected elements. */
+void
+t8_forest_vtk_destroy_cells (t8_forest_t forest, t8_forest_vtk_cells_t &cells)
+{
+  for (t8_forest_vtk_cell_t &cell : cells) {
+    if (cell.is_ancestor) {
+      const t8_eclass_scheme_c *ts
+        = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, cell.ltreeid));
+      ts->t8_element_destroy (1, &cell.element);
+    }
+  }
+  cells.clear ();
+}
+
+/* Copy the values of a data field and replace the values of the first leaf of each selected
+ * element by the average of the values of all its leaves. */
+void
+t8_forest_vtk_average_cell_data (t8_forest_t forest, const t8_forest_vtk_cells_t &cells,
+                                 const t8_vtk_data_field_t *field, std::vector<double> &values)
+{
+  const int num_components = field->type == T8_VTK_SCALAR ? 1 : 3;
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+
+  values.assign (field->data, field->data + num_elements * num_components);
+  for (const t8_forest_vtk_cell_t &cell : cells) {
+    if (cell.num_leaves == 1) {
+      continue;
+    }
+    const t8_locidx_t first_leaf = t8_forest_get_tree_element_offset (forest, cell.ltreeid) + cell.first_leaf;
+    for (int icomp = 0; icomp < num_components; icomp++) {
+      double sum = 0;
+      for (t8_locidx_t ileaf = first_leaf; ileaf < first_leaf + cell.num_leaves; ileaf++) {
+        sum += field->data[ileaf * num_components + icomp];
+      }
+      values[first_leaf * num_components + icomp] = sum / cell.num_leaves;
+    }
+  }
+}
+
+int
+t8_forest_vtk_write_region (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                            const int write_level, const int write_element_id, const int binary, const int compress,
+                            const t8_vtk_region_t *region, const int num_data, t8_vtk_data_field_t *data)
+{
+  T8_ASSERT (region != NULL);
+  return t8_forest_vtk_write_ext (forest, fileprefix, write_treeid, write_mpirank, write_level, write_element_id, 0,
+                                  binary, compress, 0, region, num_data, data);
+}
@@ -0,0 +1,46 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef T8_VTK_WRITE_REGION_HXX
+#define T8_VTK_WRITE_REGION_HXX
+
+#include "t8_forest/t8_forest_types.h"
+#include "t8_vtk.h"
+#include "t8_vtk/t8_vtk_writer.h"
+
+/** Write the part of the forest selected by a region in .pvtu file format.
+ * Trees and elements outside of the region are skipped and leaves finer than the
+ * maximum level of the region are merged into their ancestors with averaged cell data.
+ * Ghost elements are not written.
+ * \param [in]  binary    If true, the data arrays are written as in \ref t8_forest_vtk_write_binary,
+ *                        otherwise as in \ref t8_forest_vtk_write_ASCII.
+ * \param [in]  compress  If true, the data arrays are zlib compressed. Requires \a binary.
+ * \param [in]  region    The part of the forest to write.
+ * The other parameters are the same as for \ref t8_forest_vtk_write_binary.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_vtk_write_region (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                            const int write_level, const int write_element_id, const int binary, const int compress,
+                            const t8_vtk_region_t *region, const int num_data, t8_vtk_data_field_t *data);
+
+#endif /* T8_VTK_WRITE_REGION_HXX */
@@ -0,0 +1,131 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "t8_vtk/t8_vtk_write_shared.hxx"
+#include "t8_vtk/t8_vtk_write_private.hxx"
+#include "t8_forest/t8_forest_types.h"
+#include "t8_forest/t8_forest_private.h"
+#include <t8_forest/t8_forest_general.h>
+#include <t8_data/t8_mpi_file.h>
+#include <string>
+#include <vector>
+
+int
+t8_forest_vtk_write_shared (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                            const int write_level, const int write_element_id, const int num_data,
+                            t8_vtk_data_field_t *data)
+{
+  std::vector<t8_forest_vtk_array_t> arrays;
+  std::vector<uint64_t> offsets;
+  size_t section_begin[5];
+  t8_forest_vtk_output_t output;
+  t8_mpi_file_t file;
+  char filename[BUFSIZ];
+  t8_gloidx_t local_counts[2], global_counts[2], count_offsets[2];
+  int success, global_success, mpiret;
+
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (t8_forest_is_committed (forest));
+  t8_forest_compact_check_expanded (forest, "t8_forest_vtk_write_shared");
+  T8_ASSERT (fileprefix != NULL);
+
+  /* The global number of points and elements and the position of our points and elements */
+  local_counts[0] = t8_forest_vtk_num_points (forest, 0);
+  local_counts[1] = t8_forest_get_local_num_elements (forest);
+  mpiret = sc_MPI_Scan (local_counts, count_offsets, 2, T8_MPI_GLOIDX, sc_MPI_SUM, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Allreduce (local_counts, global_counts, 2, T8_MPI_GLOIDX, sc_MPI_SUM, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  count_offsets[0] -= local_counts[0];
+  count_offsets[1] -= local_counts[1];
+
+  t8_forest_vtk_collect_arrays (forest, write_treeid, write_mpirank, write_level, write_element_id, num_data, data, 1,
+                                arrays, section_begin);
+  /* All processes know the global sizes and can thus compute the position of each array
+   * in the file and build the header. */
+  offsets.push_back (0);
+  for (const t8_forest_vtk_array_t &array : arrays) {
+    const t8_gloidx_t num_values = array.per_point ? global_counts[0] : global_counts[1];
+    offsets.push_back (offsets.back () + sizeof (uint64_t) + num_values * array.num_components * array.value_size);
+  }
+  const std::string header
+    = t8_forest_vtk_appended_header (arrays, section_begin, global_counts[0], global_counts[1], offsets.data (), 0);
+
+  snprintf (filename, BUFSIZ, "%s.vtu", fileprefix);
+  if (!t8_mpi_file_open (forest->mpicomm, filename, 1, &file)) {
+    return 0;
+  }
+  success = 1;
+  if (forest->mpirank == 0) {
+    success = t8_mpi_file_write_at (&file, 0, header.c_str (), header.size (), sizeof (char));
+  }
+
+  output.vtufile = NULL;
+  output.binary = 1;
+  output.compress = 0;
+  output.points = NULL;
+  output.cells = NULL;
+  sc_array_init (&output.buffer, sizeof (char));
+  for (size_t iarray = 0; iarray < arrays.size (); iarray++) {
+    const t8_forest_vtk_array_t &array = arrays[iarray];
+    const size_t array_pos = header.size () + offsets[iarray];
+    const uint64_t num_bytes = offsets[iarray + 1] - offsets[iarray] - sizeof (uint64_t);
+    const t8_gloidx_t first_value = (array.per_point ? count_offsets[0] : count_offsets[1]) * array.num_components;
+
+    /* Compute our values of this array */
+    success = t8_forest_vtk_write_cell_data (forest, &output, array.name.c_str (), array.datatype, "", 1,
+                                             array.kernel, 0, array.udata)
+              && success;
+    const size_t num_values = output.buffer.elem_count / array.value_size;
+    T8_ASSERT (num_values
+               == (size_t) ((array.per_point ? local_counts[0] : local_counts[1]) * array.num_components));
+    if (array.point_indices) {
+      /* Shift the process local point indices to global indices */
+      int64_t *values = (int64_t *) output.buffer.array;
+      for (size_t ivalue = 0; ivalue < num_values; ivalue++) {
+        values[ivalue] += count_offsets[0];
+      }
+    }
+    /* Process zero writes the size of the array, then all processes write their values */
+    if (forest->mpirank == 0) {
+      success = t8_mpi_file_write_at (&file, array_pos, &num_bytes, 1, sizeof (uint64_t)) && success;
+    }
+    success = t8_mpi_file_write_at_all (&file, array_pos + sizeof (uint64_t) + first_value * array.value_size,
+                                        output.buffer.array, num_values, array.value_size)
+              && success;
+    sc_array_truncate (&output.buffer);
+  }
+  sc_array_reset (&output.buffer);
+  if (forest->mpirank == 0) {
+    const char *footer = "\n  </AppendedData>\n</VTKFile>\n";
+    success = t8_mpi_file_write_at (&file, header.size () + offsets.back (), footer, strlen (footer), sizeof (char))
+              && success;
+  }
+  success = t8_mpi_file_close (&file) && success;
+
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_errorf ("Error when writing vtk file %s.\n", filename);
+  }
+  return global_success;
+}
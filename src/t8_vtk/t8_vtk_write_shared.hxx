@@ -0,0 +1,53 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef T8_VTK_WRITE_SHARED_HXX
+#define T8_VTK_WRITE_SHARED_HXX
+
+#include "t8_forest/t8_forest_types.h"
+#include "t8_vtk.h"
+#include "t8_vtk/t8_vtk_writer.h"
+
+/** Write the forest to a single .vtu file that is shared by all processes.
+ * The header is written by process zero and all processes write their points,
+ * connectivity, offsets, types and cell data with collective MPI I/O at
+ * precomputed global offsets into one raw appended data section.
+ * Thus, the number of files does not grow with the number of processes.
+ * Ghost elements are not written.
+ * This function is collective.
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output file. The file will be named \a fileprefix.vtu .
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element.
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the used defined per element data.
+ * \return  True if successful on all processes, false if not.
+ */
+int
+t8_forest_vtk_write_shared (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                            const int write_level, const int write_element_id, const int num_data,
+                            t8_vtk_data_field_t *data);
+
+#endif /* T8_VTK_WRITE_SHARED_HXX */
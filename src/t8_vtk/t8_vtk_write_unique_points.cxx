@@ -0,0 +1,268 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "t8_vtk/t8_vtk_write_unique_points.hxx"
+#include "t8_vtk/t8_vtk_write_private.hxx"
+#include "t8_vtk/t8_vtk_writer_helper.hxx"
+#include "t8_forest/t8_forest_types.h"
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_geometrical.h>
+#include <t8_forest/t8_forest_ghost.h>
+#include <array>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+/* When writing each point only once, points on tree boundaries are identified if their distance
+ * is below this tolerance relative to the diameter of the bounding box of the boundary points. */
+#define T8_VTK_POINT_TOLERANCE 1e-12
+
+/* Hash function for the integer keys that identify the points of a forest. */
+struct t8_forest_vtk_key_hash
+{
+  template <size_t N>
+  size_t
+  operator() (const std::array<int64_t, N> &key) const
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t ientry = 0; ientry < N; ientry++) {
+      hash = (hash ^ (uint64_t) key[ientry]) * 1099511628211ULL;
+    }
+    return (size_t) hash;
+  }
+};
+
+/* Return true if a point of a tree lies on the boundary of the tree.
+ * \a coords are the reference coordinates of the point in the tree, scaled by 2^maxlevel. */
+static int
+t8_forest_vtk_is_tree_boundary (const t8_eclass_t tree_class, const int64_t coords[3], const int maxlevel)
+{
+  const int dim = t8_eclass_to_dimension[tree_class];
+  const int64_t root_len = (int64_t) 1 << maxlevel;
+
+  if (dim == 0) {
+    /* A vertex tree only consists of its boundary */
+    return 1;
+  }
+  for (int iface = 0; iface < t8_eclass_num_faces[tree_class]; iface++) {
+    /* The first dim vertices of a face determine the plane of the face */
+    int64_t vertices[3][3] = { { 0 } };
+    int64_t normal[3] = { 0, 0, 0 };
+    for (int ivertex = 0; ivertex < dim; ivertex++) {
+      const int tree_vertex = t8_face_vertex_to_tree_vertex[tree_class][iface][ivertex];
+      for (int icoord = 0; icoord < 3; icoord++) {
+        vertices[ivertex][icoord] = (int64_t) t8_element_corner_ref_coords[tree_class][tree_vertex][icoord];
+      }
+    }
+    if (dim == 1) {
+      normal[0] = 1;
+    }
+    else if (dim == 2) {
+      normal[0] = vertices[0][1] - vertices[1][1];
+      normal[1] = vertices[1][0] - vertices[0][0];
+    }
+    else {
+      int64_t edges[2][3];
+      for (int icoord = 0; icoord < 3; icoord++) {
+        edges[0][icoord] = vertices[1][icoord] - vertices[0][icoord];
+        edges[1][icoord] = vertices[2][icoord] - vertices[0][icoord];
+      }
+      normal[0] = edges[0][1] * edges[1][2] - edges[0][2] * edges[1][1];
+      normal[1] = edges[0][2] * edges[1][0] - edges[0][0] * edges[1][2];
+      normal[2] = edges[0][0] * edges[1][1] - edges[0][1] * edges[1][0];
+    }
+    const int64_t face_offset = normal[0] * vertices[0][0] + normal[1] * vertices[0][1] + normal[2] * vertices[0][2];
+    if (normal[0] * coords[0] + normal[1] * coords[1] + normal[2] * coords[2] == face_offset * root_len) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Compute a process local numbering of the points of the local elements and, if \a write_ghosts
+ * is true, of the ghost elements, such that each point that is shared by several elements gets only one index.
+ * The corners are traversed in the same order as in \ref t8_forest_vtk_write_cell_data.
+ * Inside of a tree a point is identified by its tree id and its integer reference coordinates, which also
+ * identifies hanging nodes with the corners of the coarser neighbors.
+ * Points on tree boundaries are shared with neighbor trees, whose reference coordinates are unrelated.
+ * These points are identified by their coordinates up to a tolerance. */
+void
+t8_forest_vtk_compute_points (t8_forest_t forest, const int write_ghosts, t8_forest_vtk_points_t *points)
+{
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  const t8_locidx_t num_trees = num_local_trees + (write_ghosts ? t8_forest_ghost_num_trees (forest) : 0);
+  std::unordered_map<std::array<int64_t, 4>, t8_locidx_t, t8_forest_vtk_key_hash> interior_points;
+  std::vector<size_t> boundary_corners;
+  std::vector<double> boundary_coordinates;
+  t8_locidx_t local_element_id = 0;
+
+  points->corner_points.clear ();
+  points->corner_elements.clear ();
+  points->coordinates.clear ();
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    const int is_ghost = itree >= num_local_trees;
+    const t8_eclass_t tree_class = t8_forest_get_tree_class (forest, itree);
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, tree_class);
+    const t8_gloidx_t gtreeid = t8_forest_global_tree_id (forest, itree);
+    const int maxlevel = ts->t8_element_maxlevel ();
+    const double root_len = (double) ((int64_t) 1 << maxlevel);
+    const t8_locidx_t num_elements = is_ghost ? t8_forest_ghost_tree_num_elements (forest, itree - num_local_trees)
+                                              : t8_forest_get_tree_num_elements (forest, itree);
+
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+      const t8_element_t *element = is_ghost ? t8_forest_ghost_get_element (forest, itree - num_local_trees, ielement)
+                                             : t8_forest_get_element_in_tree (forest, itree, ielement);
+      const t8_element_shape_t element_shape = ts->t8_element_shape (element);
+
+      for (int ivertex = 0; ivertex < t8_eclass_num_vertices[element_shape]; ivertex++) {
+        const double *ref_coords = t8_forest_vtk_point_to_element_ref_coords[element_shape][ivertex];
+        double tree_ref_coords[3] = { 0, 0, 0 };
+        double coordinates[3];
+        std::array<int64_t, 4> key = { gtreeid, 0, 0, 0 };
+
+        ts->t8_element_reference_coords (element, ref_coords, 1, tree_ref_coords);
+        for (int icoord = 0; icoord < 3; icoord++) {
+          key[icoord + 1] = llround (tree_ref_coords[icoord] * root_len);
+        }
+        points->corner_elements.push_back (is_ghost ? -1 : local_element_id);
+        if (!t8_forest_vtk_is_tree_boundary (tree_class, key.data () + 1, maxlevel)) {
+          /* The point is only shared with elements of the same tree */
+          const auto inserted = interior_points.emplace (key, (t8_locidx_t) (points->coordinates.size () / 3));
+          if (inserted.second) {
+            t8_forest_element_from_ref_coords (forest, itree, element, ref_coords, 1, coordinates);
+            points->coordinates.insert (points->coordinates.end (), coordinates, coordinates + 3);
+          }
+          points->corner_points.push_back (inserted.first->second);
+        }
+        else {
+          /* The point is identified below */
+          t8_forest_element_from_ref_coords (forest, itree, element, ref_coords, 1, coordinates);
+          boundary_corners.push_back (points->corner_points.size ());
+          boundary_coordinates.insert (boundary_coordinates.end (), coordinates, coordinates + 3);
+          points->corner_points.push_back (-1);
+        }
+      }
+      if (!is_ghost) {
+        local_element_id++;
+      }
+    }
+  }
+
+  if (boundary_corners.empty ()) {
+    return;
+  }
+  /* Compute the bounding box of the tree boundary points to obtain the tolerance */
+  double lower[3], upper[3], diameter = 0;
+  for (int icoord = 0; icoord < 3; icoord++) {
+    lower[icoord] = upper[icoord] = boundary_coordinates[icoord];
+  }
+  for (size_t ipoint = 0; ipoint < boundary_corners.size (); ipoint++) {
+    for (int icoord = 0; icoord < 3; icoord++) {
+      lower[icoord] = SC_MIN (lower[icoord], boundary_coordinates[3 * ipoint + icoord]);
+      upper[icoord] = SC_MAX (upper[icoord], boundary_coordinates[3 * ipoint + icoord]);
+    }
+  }
+  for (int icoord = 0; icoord < 3; icoord++) {
+    diameter += (upper[icoord] - lower[icoord]) * (upper[icoord] - lower[icoord]);
+  }
+  const double tolerance = T8_VTK_POINT_TOLERANCE * SC_MAX (sqrt (diameter), 1);
+
+  /* We sort the points into a grid with cell width tolerance, such that matching points
+   * lie in the same or in neighboring cells. */
+  std::unordered_map<std::array<int64_t, 3>, std::vector<t8_locidx_t>, t8_forest_vtk_key_hash> grid;
+  for (size_t icorner = 0; icorner < boundary_corners.size (); icorner++) {
+    const double *coordinates = &boundary_coordinates[3 * icorner];
+    std::array<int64_t, 3> cell;
+    t8_locidx_t point = -1;
+
+    for (int icoord = 0; icoord < 3; icoord++) {
+      cell[icoord] = (int64_t) floor ((coordinates[icoord] - lower[icoord]) / tolerance);
+    }
+    for (int ineighbor = 0; ineighbor < 27 && point < 0; ineighbor++) {
+      const std::array<int64_t, 3> neighbor
+        = { cell[0] + ineighbor % 3 - 1, cell[1] + (ineighbor / 3) % 3 - 1, cell[2] + ineighbor / 9 - 1 };
+      const auto found = grid.find (neighbor);
+      if (found == grid.end ()) {
+        continue;
+      }
+      for (const t8_locidx_t candidate : found->second) {
+        const double *candidate_coordinates = &points->coordinates[3 * candidate];
+        if (fabs (candidate_coordinates[0] - coordinates[0]) <= tolerance
+            && fabs (candidate_coordinates[1] - coordinates[1]) <= tolerance
+            && fabs (candidate_coordinates[2] - coordinates[2]) <= tolerance) {
+          point = candidate;
+          break;
+        }
+      }
+    }
+    if (point < 0) {
+      /* This is a new point */
+      point = (t8_locidx_t) (points->coordinates.size () / 3);
+      points->coordinates.insert (points->coordinates.end (), coordinates, coordinates + 3);
+      grid[cell].push_back (point);
+    }
+    points->corner_points[boundary_corners[icorner]] = point;
+  }
+}
+
+/* Average element data over the local elements adjacent to each point.
+ * Points without adjacent local elements get the value 0.
+ * \param [in]  points          The unique points of the forest.
+ * \param [in]  element_values  \a num_components values per local element.
+ * \param [in]  num_components  The number of values per element.
+ * \param [out] point_values    On output \a num_components values per point. */
+void
+t8_forest_vtk_average_point_data (const t8_forest_vtk_points_t *points, const double *element_values,
+                                  const int num_components, std::vector<double> &point_values)
+{
+  const size_t num_points = points->coordinates.size () / 3;
+  std::vector<int> num_adjacent (num_points, 0);
+
+  point_values.assign (num_points * num_components, 0);
+  for (size_t icorner = 0; icorner < points->corner_points.size (); icorner++) {
+    const t8_locidx_t ielement = points->corner_elements[icorner];
+    const t8_locidx_t ipoint = points->corner_points[icorner];
+    if (ielement < 0) {
+      /* Ghost elements do not have data */
+      continue;
+    }
+    for (int icomp = 0; icomp < num_components; icomp++) {
+      point_values[ipoint * num_components + icomp] += element_values[ielement * num_components + icomp];
+    }
+    num_adjacent[ipoint]++;
+  }
+  for (size_t ipoint = 0; ipoint < num_points; ipoint++) {
+    for (int icomp = 0; num_adjacent[ipoint] > 0 && icomp < num_components; icomp++) {
+      point_values[ipoint * num_components + icomp] /= num_adjacent[ipoint];
+    }
+  }
+}
+
+int
+t8_forest_vtk_write_unique_points (t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                   const int write_mpirank, const int write_level, const int write_element_id,
+                                   int write_ghosts, const int binary, const int compress, const int num_data,
+                                   t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_ext (forest, fileprefix, write_treeid, write_mpirank, write_level, write_element_id,
+                                  write_ghosts, binary, compress, 1, NULL, num_data, data);
+}
@@ -21,6 +21,7 @@
 */
 
 #include <t8_vtk/t8_vtk_writer.hxx>
+#include <t8_forest/t8_forest_private.h>
 
 #if T8_WITH_VTK
 #include <vtkUnstructuredGrid.h>
@@ -114,6 +115,7 @@ t8_forest_vtk_write_file_via_API (const t8_forest_t forest, const char *filepref
                                   const int curved_flag, const int write_ghosts, const int num_data,
                                   t8_vtk_data_field_t *data)
 {
+  t8_forest_compact_check_expanded (forest, "t8_forest_vtk_write_file_via_API");
   vtk_writer<t8_forest_t> writer (write_treeid, write_mpirank, write_level, write_element_id, write_ghosts, curved_flag,
                                   std::string (fileprefix), num_data, data, t8_forest_get_mpicomm (forest));
   return writer.write_with_API (forest);
@@ -129,6 +131,45 @@ t8_forest_vtk_write_file (const t8_forest_t forest, const char *fileprefix, cons
   return writer.write_ASCII (forest);
 }
 
+int
+t8_forest_vtk_write_file_binary (const t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                 const int write_mpirank, const int write_level, const int write_element_id,
+                                 int write_ghosts, const int compress, const int num_data, t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_binary (forest, fileprefix, write_treeid, write_mpirank, write_level, write_element_id,
+                                     write_ghosts, compress, num_data, data);
+}
+
+int
+t8_forest_vtk_write_file_unique_points (const t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                        const int write_mpirank, const int write_level, const int write_element_id,
+                                        int write_ghosts, const int binary, const int compress, const int num_data,
+                                        t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_unique_points (forest, fileprefix, write_treeid, write_mpirank, write_level,
+                                            write_element_id, write_ghosts, binary, binary && compress, num_data,
+                                            data);
+}
+
+int
+t8_forest_vtk_write_file_region (const t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                 const int write_mpirank, const int write_level, const int write_element_id,
+                                 const int binary, const int compress, const t8_vtk_region_t *region,
+                                 const int num_data, t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_region (forest, fileprefix, write_treeid, write_mpirank, write_level, write_element_id,
+                                     binary, binary && compress, region, num_data, data);
+}
+
+int
+t8_forest_vtk_write_file_shared (const t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                 const int write_mpirank, const int write_level, const int write_element_id,
+                                 const int num_data, t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_shared (forest, fileprefix, write_treeid, write_mpirank, write_level, write_element_id,
+                                     num_data, data);
+}
+
 int
 t8_cmesh_vtk_write_file_via_API (const t8_cmesh_t cmesh, const char *fileprefix, sc_MPI_Comm comm)
 {
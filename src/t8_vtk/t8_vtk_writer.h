@@ -111,6 +111,141 @@ t8_forest_vtk_write_file (t8_forest_t forest, const char *fileprefix, const int
                           const int write_level, const int write_element_id, int write_ghosts, const int num_data,
                           t8_vtk_data_field_t *data);
 
+/** Write the forest in .pvtu file format. Writes one .vtu file per
+ * process and a meta .pvtu file.
+ * In contrast to \ref t8_forest_vtk_write_file the data arrays are written
+ * in binary form to a raw appended data section of each .vtu file.
+ * This function does not require t8code to be configured with "--with-vtk".
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output files.
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element.
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ * \param [in]  write_ghosts If true, each process additionally writes its ghost elements.
+ *                           For ghost element the treeid is -1.
+ * \param [in]  compress  If true, the data arrays are zlib compressed.
+ *                        This requires libsc to be configured with zlib.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the used defined per element data.
+ *                        If scalar and vector fields are used, all scalar fields
+ *                        must come first in the array.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_vtk_write_file_binary (t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                 const int write_mpirank, const int write_level, const int write_element_id,
+                                 int write_ghosts, const int compress, const int num_data, t8_vtk_data_field_t *data);
+
+/** Write the forest in .pvtu file format such that each point is written only once per process.
+ * Points that are shared by several elements of a process, including hanging nodes and
+ * points on tree boundaries, are written once and referenced by all adjacent elements.
+ * Thus, the point arrays are much smaller than those of \ref t8_forest_vtk_write_file.
+ * The point data fields "<description>_points" are the averages of the data of the adjacent local elements.
+ * This function does not require t8code to be configured with "--with-vtk".
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output files.
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element.
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ * \param [in]  write_ghosts If true, each process additionally writes its ghost elements.
+ *                           For ghost element the treeid is -1.
+ * \param [in]  binary    If true, the data arrays are written as in \ref t8_forest_vtk_write_file_binary.
+ * \param [in]  compress  If true, the data arrays are zlib compressed. Only used if \a binary is true.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the used defined per element data.
+ *                        If scalar and vector fields are used, all scalar fields
+ *                        must come first in the array.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_vtk_write_file_unique_points (t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                        const int write_mpirank, const int write_level, const int write_element_id,
+                                        int write_ghosts, const int binary, const int compress, const int num_data,
+                                        t8_vtk_data_field_t *data);
+
+/** Callback that selects the part of a forest that is written with \ref t8_forest_vtk_write_file_region.
+ * It is called once for each local tree with \a element NULL. If it returns false, no element
+ * of the tree is written. Otherwise, it is called for each element of the tree that would be written.
+ * \param [in]  forest    The forest.
+ * \param [in]  ltreeid   A local tree of \a forest.
+ * \param [in]  element   NULL or an element of the tree. If the output level is limited,
+ *                        this may be an ancestor of several leaves.
+ * \param [in]  user_data The user data of the region.
+ * \return  True if the tree or the element is written.
+ */
+typedef int (*t8_vtk_region_fn) (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_element_t *element,
+                                 void *user_data);
+
+/** The part of a forest that is written with \ref t8_forest_vtk_write_file_region. */
+typedef struct
+{
+  const double *bounding_box; /**< If not NULL, an array of 6 doubles xmin, xmax, ymin, ymax, zmin, zmax.
+                                   Only the elements whose bounding box intersects this box are written. */
+  t8_vtk_region_fn filter;    /**< If not NULL, only the trees and elements for which it returns true are written. */
+  void *user_data;            /**< Passed to \a filter. */
+  int max_level;              /**< If non-negative, leaves of a finer level are merged into their ancestor
+                                   of this level, whose cell data is the average of the leaves' data. */
+} t8_vtk_region_t;
+
+/** Write a part of the forest in .pvtu file format. Writes one .vtu file per
+ * process and a meta .pvtu file.
+ * The trees are first checked against the region as a whole, so that trees outside of the region
+ * are skipped, and then each of their elements is checked.
+ * If the maximum level of the region is limited, leaves that are finer are merged into their
+ * ancestor of that level. Since each process merges its own leaves, an ancestor whose leaves are
+ * distributed to several processes is written by each of them.
+ * Ghost elements are not written.
+ * This function does not require t8code to be configured with "--with-vtk".
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output files.
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element.
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ *                               A merged ancestor gets the id of its first leaf.
+ * \param [in]  binary    If true, the data arrays are written as in \ref t8_forest_vtk_write_file_binary.
+ * \param [in]  compress  If true, the data arrays are zlib compressed. Only used if \a binary is true.
+ * \param [in]  region    The part of the forest to write.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the used defined per element data.
+ *                        If scalar and vector fields are used, all scalar fields
+ *                        must come first in the array.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_vtk_write_file_region (t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                 const int write_mpirank, const int write_level, const int write_element_id,
+                                 const int binary, const int compress, const t8_vtk_region_t *region,
+                                 const int num_data, t8_vtk_data_field_t *data);
+
+/** Write the forest to a single .vtu file that is shared by all processes.
+ * Instead of one .vtu file per process and a meta .pvtu file, all processes
+ * write their part of the forest with collective MPI I/O into the raw appended
+ * data section of one file. ParaView reads the file as a serial unstructured grid.
+ * Ghost elements are not written.
+ * This function does not require t8code to be configured with "--with-vtk".
+ * This function is collective.
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output file. The file will be named \a fileprefix.vtu .
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element.
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the used defined per element data.
+ * \return  True if successful on all processes, false if not.
+ */
+int
+t8_forest_vtk_write_file_shared (t8_forest_t forest, const char *fileprefix, const int write_treeid,
+                                 const int write_mpirank, const int write_level, const int write_element_id,
+                                 const int num_data, t8_vtk_data_field_t *data);
+
 /**
  * Write the cmesh in .pvtu file format. Writes one .vtu file per
  * process and a meta .pvtu file.
@@ -31,6 +31,10 @@
 #include "t8_forest/t8_forest_types.h"
 #include "t8_vtk/t8_vtk_writer_helper.hxx"
 #include "t8_vtk/t8_vtk_write_ASCII.hxx"
+#include "t8_vtk/t8_vtk_write_binary.hxx"
+#include "t8_vtk/t8_vtk_write_shared.hxx"
+#include "t8_vtk/t8_vtk_write_unique_points.hxx"
+#include "t8_vtk/t8_vtk_write_region.hxx"
 
 #include <string>
 #include <t8_vtk.h>
@@ -27,6 +27,10 @@
 #include <t8_schemes/t8_default/t8_default.hxx>
 
 #include <t8_vtk/t8_vtk_writer.h>
+#include <t8_vtk/t8_vtk_async.h>
+#include <fstream>
+#include <iterator>
+#include <string>
 
 /**
  * Create a hybrid forest or a cmesh
@@ -77,6 +81,156 @@ destroy_grid<t8_forest_t> (t8_forest_t *forest)
   t8_forest_unref (forest);
 }
 
+/**
+ * Check whether the header of a .vtu file contains a string.
+ * 
+ * \param[in] filename The name of the file.
+ * \param[in] expected The string to search for in the first lines of the file.
+ * \return True if \a expected was found.
+ */
+static int
+vtu_header_contains (const char *filename, const char *expected)
+{
+  char line[BUFSIZ];
+  int found = 0;
+  FILE *fp = fopen (filename, "rb");
+
+  if (fp == NULL) {
+    return 0;
+  }
+  /* The piece is described in the first lines of the file */
+  for (int iline = 0; iline < 5 && fgets (line, BUFSIZ, fp) != NULL; iline++) {
+    found = found || strstr (line, expected) != NULL;
+  }
+  fclose (fp);
+  return found;
+}
+
+/**
+ * Read a whole .vtu file.
+ * 
+ * \param[in] filename The name of the file.
+ * \param[out] content The content of the file.
+ * \return True if the file could be read.
+ */
+static bool
+vtu_read_file (const char *filename, std::string &content)
+{
+  std::ifstream file (filename, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  content.assign (std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ());
+  return true;
+}
+
+/**
+ * Return the value of a numeric attribute in the xml part of a .vtu file.
+ * 
+ * \param[in] xml The xml text, for example one element.
+ * \param[in] attribute The name of the attribute.
+ * \return The value of the attribute, -1 if it does not exist.
+ */
+static long long
+vtu_attribute (const std::string &xml, const char *attribute)
+{
+  const std::string key = std::string (" ") + attribute + "=\"";
+  const size_t pos = xml.find (key);
+  if (pos == std::string::npos) {
+    return -1;
+  }
+  return atoll (xml.c_str () + pos + key.size ());
+}
+
+/**
+ * Find an appended data array in a binary .vtu file.
+ * 
+ * \param[in] content The content of the file.
+ * \param[in] name The name of the data array.
+ * \param[out] value_size The size in bytes of one value of the array.
+ * \return The position of the data block of the array in \a content, std::string::npos if it was not found.
+ */
+static size_t
+vtu_find_appended_array (const std::string &content, const char *name, size_t *value_size)
+{
+  for (size_t pos = content.find ("<DataArray "); pos != std::string::npos;
+       pos = content.find ("<DataArray ", pos + 1)) {
+    const std::string element = content.substr (pos, content.find ('>', pos) - pos);
+    if (element.find (std::string ("Name=\"") + name + "\"") == std::string::npos) {
+      continue;
+    }
+    if (element.find ("format=\"appended\"") == std::string::npos) {
+      return std::string::npos;
+    }
+    *value_size = element.find ("type=\"Float32\"") != std::string::npos ? 4 : 8;
+    const size_t appended = content.find ("<AppendedData encoding=\"raw\">");
+    if (appended == std::string::npos) {
+      return std::string::npos;
+    }
+    /* The appended data starts after the '_' */
+    return content.find ('_', appended) + 1 + vtu_attribute (element, "offset");
+  }
+  return std::string::npos;
+}
+
+/**
+ * Read a UInt64 of the header of a data block.
+ * 
+ * \param[in] content The content of the file.
+ * \param[in] block The position of the data block.
+ * \param[in] index The index of the UInt64 in the header.
+ * \return The value.
+ */
+static uint64_t
+vtu_block_header (const std::string &content, const size_t block, const int index)
+{
+  uint64_t value;
+  memcpy (&value, content.data () + block + index * sizeof (uint64_t), sizeof (uint64_t));
+  return value;
+}
+
+/**
+ * Check the layout of a binary .vtu file with the points and cells of the local elements.
+ * 
+ * \param[in] filename The name of the file.
+ * \param[in] num_elements The number of cells in the file.
+ * \param[in] compress True if the arrays are zlib compressed.
+ */
+static void
+vtu_check_binary_layout (const char *filename, const t8_locidx_t num_elements, const int compress)
+{
+  std::string content;
+  ASSERT_TRUE (vtu_read_file (filename, content)) << "Could not read " << filename;
+  const std::string xml = content.substr (0, content.find ("<AppendedData"));
+  EXPECT_NE (xml.find ("<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" header_type=\"UInt64\""),
+             std::string::npos);
+  EXPECT_EQ (xml.find ("compressor=\"vtkZLibDataCompressor\"") != std::string::npos, compress != 0);
+  EXPECT_EQ (xml.find ("format=\"ascii\""), std::string::npos);
+  EXPECT_EQ (vtu_attribute (xml, "NumberOfCells"), num_elements);
+
+  /* The first array holds the coordinates of the points */
+  size_t value_size;
+  const size_t block = vtu_find_appended_array (content, "Position", &value_size);
+  ASSERT_NE (block, std::string::npos);
+  ASSERT_LE (block + 4 * sizeof (uint64_t), content.size ());
+  const long long num_points = vtu_attribute (xml, "NumberOfPoints");
+  ASSERT_GT (num_points, 0);
+  const uint64_t num_bytes = 3 * num_points * value_size;
+  if (!compress) {
+    /* The block starts with its size in bytes */
+    EXPECT_EQ (vtu_block_header (content, block, 0), num_bytes);
+  }
+  else {
+    /* The block starts with the number of chunks, the chunk size and the size of the last chunk */
+    const uint64_t num_chunks = vtu_block_header (content, block, 0);
+    const uint64_t chunk_size = vtu_block_header (content, block, 1);
+    const uint64_t last_chunk_size = vtu_block_header (content, block, 2);
+    ASSERT_GT (chunk_size, 0u);
+    EXPECT_EQ (num_chunks, (num_bytes + chunk_size - 1) / chunk_size);
+    EXPECT_EQ ((num_chunks - 1) * chunk_size + (last_chunk_size != 0 ? last_chunk_size : chunk_size), num_bytes);
+  }
+}
+
 template <typename grid_t>
 static int
 use_c_interface (const grid_t grid, const char *fileprefix, const int write_treeid, const int write_mpirank,
@@ -170,3 +324,224 @@ REGISTER_TYPED_TEST_SUITE_P (vtk_writer_test, write_vtk, c_interface);
 using GridTypes = ::testing::Types<t8_cmesh_t, t8_forest_t>;
 
 INSTANTIATE_TYPED_TEST_SUITE_P (Test_vtk_writer, vtk_writer_test, GridTypes, );
+
+/**
+ * Write a forest with user data in the binary format, once uncompressed and once compressed.
+ */
+TEST (vtk_writer_binary, write_forest_binary)
+{
+  t8_forest_t forest = make_grid<t8_forest_t> ();
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  double *scalars = T8_ALLOC (double, num_elements);
+  double *vectors = T8_ALLOC (double, 3 * num_elements);
+  t8_vtk_data_field_t data[2];
+
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+    scalars[ielement] = ielement;
+    for (int icoord = 0; icoord < 3; icoord++) {
+      vectors[3 * ielement + icoord] = icoord * ielement;
+    }
+  }
+  data[0].type = T8_VTK_SCALAR;
+  strcpy (data[0].description, "scalar");
+  data[0].data = scalars;
+  data[1].type = T8_VTK_VECTOR;
+  strcpy (data[1].description, "vector");
+  data[1].data = vectors;
+
+  EXPECT_TRUE (t8_forest_vtk_write_file_binary (forest, "test_vtk_binary", 1, 1, 1, 1, 0, 0, 2, data));
+  EXPECT_TRUE (t8_forest_vtk_write_file_binary (forest, "test_vtk_binary_compressed", 1, 1, 1, 1, 0, 1, 2, data));
+
+  int mpirank;
+  char filename[BUFSIZ];
+  SC_CHECK_MPI (sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank));
+  snprintf (filename, BUFSIZ, "test_vtk_binary_%04d.vtu", mpirank);
+  vtu_check_binary_layout (filename, num_elements, 0);
+#ifdef SC_HAVE_ZLIB
+  snprintf (filename, BUFSIZ, "test_vtk_binary_compressed_%04d.vtu", mpirank);
+  vtu_check_binary_layout (filename, num_elements, 1);
+#endif
+
+  T8_FREE (scalars);
+  T8_FREE (vectors);
+  destroy_grid (&forest);
+}
+
+/**
+ * Write a forest into a single file shared by all processes and check the global cell count in its header.
+ */
+TEST (vtk_writer_shared, write_forest_shared)
+{
+  t8_forest_t forest = make_grid<t8_forest_t> ();
+  char expected[BUFSIZ];
+
+  EXPECT_TRUE (t8_forest_vtk_write_file_shared (forest, "test_vtk_shared", 1, 1, 1, 1, 0, NULL));
+
+  snprintf (expected, BUFSIZ, "NumberOfCells=\"%lld\"", (long long) t8_forest_get_global_num_elements (forest));
+  EXPECT_TRUE (vtu_header_contains ("test_vtk_shared.vtu", expected));
+  destroy_grid (&forest);
+}
+
+/**
+ * Queue several snapshots of a forest in the asynchronous output pipeline.
+ * The user data is modified and freed directly after queueing, which must not affect the output.
+ */
+TEST (vtk_writer_async, write_forest_async)
+{
+  t8_forest_t forest = make_grid<t8_forest_t> ();
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  t8_vtk_async_t async = t8_vtk_async_new (1);
+  t8_vtk_data_field_t data;
+  char fileprefix[BUFSIZ];
+
+  data.type = T8_VTK_SCALAR;
+  strcpy (data.description, "step");
+  for (int istep = 0; istep < 3; istep++) {
+    double *values = T8_ALLOC (double, num_elements);
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+      values[ielement] = istep;
+    }
+    data.data = values;
+    snprintf (fileprefix, BUFSIZ, "test_vtk_async_%i", istep);
+    t8_vtk_async_write_forest (async, forest, fileprefix, 1, 1, 1, 1, 0, istep % 2, 1, &data);
+    /* Overwrite the values before freeing them, such that a snapshot that still refers to them is detected */
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+      values[ielement] = -1;
+    }
+    T8_FREE (values);
+  }
+  EXPECT_TRUE (t8_vtk_async_wait (async));
+  t8_vtk_async_destroy (&async);
+  EXPECT_TRUE (async == NULL);
+
+  int mpirank;
+  char filename[BUFSIZ];
+  SC_CHECK_MPI (sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank));
+  for (int istep = 0; istep < 3; istep++) {
+    const int compress = istep % 2;
+    snprintf (filename, BUFSIZ, "test_vtk_async_%i_%04d.vtu", istep, mpirank);
+#ifndef SC_HAVE_ZLIB
+    if (compress) {
+      /* The snapshot was written uncompressed */
+      continue;
+    }
+#endif
+    vtu_check_binary_layout (filename, num_elements, compress);
+    if (compress) {
+      continue;
+    }
+    /* The uncompressed step data must hold the values at the time of queueing */
+    std::string content;
+    size_t value_size;
+    ASSERT_TRUE (vtu_read_file (filename, content));
+    const size_t block = vtu_find_appended_array (content, "step", &value_size);
+    ASSERT_NE (block, std::string::npos);
+    ASSERT_EQ (vtu_block_header (content, block, 0), num_elements * value_size);
+    ASSERT_LE (block + sizeof (uint64_t) + num_elements * value_size, content.size ());
+    const char *step_values = content.data () + block + sizeof (uint64_t);
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+      double value;
+      if (value_size == sizeof (float)) {
+        float float_value;
+        memcpy (&float_value, step_values + ielement * value_size, sizeof (float));
+        value = float_value;
+      }
+      else {
+        memcpy (&value, step_values + ielement * value_size, sizeof (double));
+      }
+      EXPECT_EQ (value, istep) << "Wrong value of element " << ielement << " in snapshot " << istep;
+    }
+  }
+  destroy_grid (&forest);
+}
+
+/**
+ * Write uniform hypercube forests with unique points. The vertices of the elements
+ * form a regular grid, such that the number of unique points is known.
+ * Each process writes its own forest, which consists of all elements.
+ */
+TEST (vtk_writer_unique_points, write_forest_unique_points)
+{
+  const t8_eclass_t eclasses[5] = { T8_ECLASS_QUAD, T8_ECLASS_TRIANGLE, T8_ECLASS_HEX, T8_ECLASS_TET, T8_ECLASS_PRISM };
+  const int level = 2;
+  int mpirank;
+
+  SC_CHECK_MPI (sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank));
+  for (int iclass = 0; iclass < 5; iclass++) {
+    const int dim = t8_eclass_to_dimension[eclasses[iclass]];
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclasses[iclass], sc_MPI_COMM_SELF, 0, 0, 0);
+    t8_forest_t forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level, 0, sc_MPI_COMM_SELF);
+    char fileprefix[BUFSIZ], filename[BUFSIZ], expected[BUFSIZ];
+    long long num_points = 1;
+
+    for (int idim = 0; idim < dim; idim++) {
+      num_points *= (1 << level) + 1;
+    }
+    snprintf (fileprefix, BUFSIZ, "test_vtk_unique_points_%s_%i", t8_eclass_to_string[eclasses[iclass]], mpirank);
+    EXPECT_TRUE (t8_forest_vtk_write_file_unique_points (forest, fileprefix, 1, 1, 1, 1, 0, iclass % 2, 0, 0, NULL));
+
+    snprintf (filename, BUFSIZ, "%s_0000.vtu", fileprefix);
+    snprintf (expected, BUFSIZ, "NumberOfPoints=\"%lld\"", num_points);
+    EXPECT_TRUE (vtu_header_contains (filename, expected))
+      << "Wrong number of points for " << t8_eclass_to_string[eclasses[iclass]];
+    t8_forest_unref (&forest);
+  }
+}
+
+/* Reject all trees. */
+static int
+t8_test_vtk_reject_trees (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_element_t *element, void *user_data)
+{
+  return element != NULL;
+}
+
+/**
+ * Write parts of a uniform level 3 unit cube forest. The box [0, 0.4]^3 intersects 4^3 elements
+ * of level 3 and one element of level 1.
+ * Each process writes its own forest, which consists of all elements.
+ */
+TEST (vtk_writer_region, write_forest_region)
+{
+  const double bounding_box[6] = { 0, 0.4, 0, 0.4, 0, 0.4 };
+  t8_cmesh_t cmesh = t8_cmesh_new_hypercube (T8_ECLASS_HEX, sc_MPI_COMM_SELF, 0, 0, 0);
+  t8_forest_t forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 3, 0, sc_MPI_COMM_SELF);
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  double *values = T8_ALLOC (double, num_elements);
+  t8_vtk_region_t region;
+  t8_vtk_data_field_t data;
+  char fileprefix[BUFSIZ], filename[BUFSIZ];
+  int mpirank;
+
+  SC_CHECK_MPI (sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank));
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+    values[ielement] = ielement;
+  }
+  data.type = T8_VTK_SCALAR;
+  strcpy (data.description, "values");
+  data.data = values;
+
+  region.bounding_box = bounding_box;
+  region.filter = NULL;
+  region.user_data = NULL;
+  region.max_level = -1;
+  snprintf (fileprefix, BUFSIZ, "test_vtk_region_box_%i", mpirank);
+  snprintf (filename, BUFSIZ, "%s_0000.vtu", fileprefix);
+  EXPECT_TRUE (t8_forest_vtk_write_file_region (forest, fileprefix, 1, 1, 1, 1, 0, 0, &region, 1, &data));
+  EXPECT_TRUE (vtu_header_contains (filename, "NumberOfCells=\"64\""));
+
+  region.max_level = 1;
+  snprintf (fileprefix, BUFSIZ, "test_vtk_region_level_%i", mpirank);
+  snprintf (filename, BUFSIZ, "%s_0000.vtu", fileprefix);
+  EXPECT_TRUE (t8_forest_vtk_write_file_region (forest, fileprefix, 1, 1, 1, 1, 1, 0, &region, 1, &data));
+  EXPECT_TRUE (vtu_header_contains (filename, "NumberOfCells=\"1\""));
+
+  region.bounding_box = NULL;
+  region.filter = t8_test_vtk_reject_trees;
+  snprintf (fileprefix, BUFSIZ, "test_vtk_region_filter_%i", mpirank);
+  snprintf (filename, BUFSIZ, "%s_0000.vtu", fileprefix);
+  EXPECT_TRUE (t8_forest_vtk_write_file_region (forest, fileprefix, 1, 1, 1, 1, 1, 0, &region, 1, &data));
+  EXPECT_TRUE (vtu_header_contains (filename, "NumberOfCells=\"0\""));
+
+  T8_FREE (values);
+  t8_forest_unref (&forest);
+}
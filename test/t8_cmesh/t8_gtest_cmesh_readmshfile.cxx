@@ -29,10 +29,10 @@
 #include "t8_cmesh/t8_cmesh_trees.h"
 
 /* In this file we test the msh file (gmsh) reader of the cmesh.
- * Currently, we support version 2 and 4 ascii.
+ * Currently, we support version 2 and 4 ascii and version 4.1 binary.
  * We read a mesh file and check whether the constructed cmesh is correct.
- * We also try to read version 2 binary and version 4 binary
- * formats. All are not supported and we expect the reader to catch this.
+ * We also try to read the version 2 binary format, which is not supported
+ * and we expect the reader to catch this.
  */
 
 static void
@@ -126,6 +126,54 @@ TEST (t8_cmesh_readmshfile, test_msh_file_vers4_ascii)
   t8_cmesh_destroy (&cmesh);
 }
 
+TEST (t8_cmesh_readmshfile, test_msh_file_vers4_ascii_parallel)
+{
+
+  const char fileprefix[BUFSIZ - 4] = "test/testfiles/test_msh_file_vers4_ascii";
+  char filename[BUFSIZ];
+
+  snprintf (filename, BUFSIZ, "%s.msh", fileprefix);
+
+  t8_debugf ("Checking parallel reading of msh file version 4...\n");
+
+  ASSERT_FALSE (access (filename, R_OK)) << "Could not open file " << filename;
+  /* Read the file once on each process and once in parallel and compare the trees. */
+  t8_cmesh_t cmesh_replicated = t8_cmesh_from_msh_file (fileprefix, 0, sc_MPI_COMM_WORLD, 2, 0, 0);
+  ASSERT_TRUE (cmesh_replicated != NULL) << "Could not read cmesh from ascii version 4, but should be able to.";
+  t8_cmesh_t cmesh = t8_cmesh_from_msh_file (fileprefix, 1, sc_MPI_COMM_WORLD, 2, -1, 0);
+  ASSERT_TRUE (cmesh != NULL) << "Could not read cmesh in parallel from ascii version 4, but should be able to.";
+
+  ASSERT_EQ (t8_cmesh_get_num_trees (cmesh), t8_cmesh_get_num_trees (cmesh_replicated));
+  const t8_locidx_t num_local_trees = t8_cmesh_get_num_local_trees (cmesh);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_gloidx_t gtree = t8_cmesh_get_global_id (cmesh, itree);
+    const t8_locidx_t itree_replicated = gtree;
+    const t8_eclass_t eclass = t8_cmesh_get_tree_class (cmesh, itree);
+    ASSERT_EQ (eclass, t8_cmesh_get_tree_class (cmesh_replicated, itree_replicated));
+    const double *vertices = t8_cmesh_get_tree_vertices (cmesh, itree);
+    const double *vertices_replicated = t8_cmesh_get_tree_vertices (cmesh_replicated, itree_replicated);
+    for (int icoord = 0; icoord < 3 * t8_eclass_num_vertices[eclass]; icoord++) {
+      EXPECT_EQ (vertices[icoord], vertices_replicated[icoord]);
+    }
+    for (int iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      int dual_face, orientation, dual_face_replicated, orientation_replicated;
+      const t8_locidx_t neighbor = t8_cmesh_get_face_neighbor (cmesh, itree, iface, &dual_face, &orientation);
+      const t8_locidx_t neighbor_replicated = t8_cmesh_get_face_neighbor (
+        cmesh_replicated, itree_replicated, iface, &dual_face_replicated, &orientation_replicated);
+      /* Compare the global ids of the neighbors, -1 at the domain boundary */
+      EXPECT_EQ (neighbor < 0 ? -1 : t8_cmesh_get_global_id (cmesh, neighbor),
+                 neighbor_replicated < 0 ? -1 : (t8_gloidx_t) neighbor_replicated);
+      if (neighbor >= 0) {
+        EXPECT_EQ (dual_face, dual_face_replicated);
+        EXPECT_EQ (orientation, orientation_replicated);
+      }
+    }
+  }
+
+  t8_cmesh_destroy (&cmesh);
+  t8_cmesh_destroy (&cmesh_replicated);
+}
+
 TEST (t8_cmesh_readmshfile, test_msh_file_vers2_bin)
 {
 
@@ -155,7 +203,32 @@ TEST (t8_cmesh_readmshfile, test_msh_file_vers4_bin)
 
   ASSERT_FALSE (access (filename, R_OK)) << "Could not open file " << filename;
   t8_cmesh_t cmesh = t8_cmesh_from_msh_file (fileprefix, 1, sc_MPI_COMM_WORLD, 2, 0, 0);
-  ASSERT_TRUE (cmesh == NULL) << "Expected fail of reading binary msh file v.4, but did not fail.";
+  ASSERT_TRUE (cmesh != NULL) << "Could not read cmesh from binary version 4, but should be able to.";
 
-  t8_debugf ("Error handling successful.\n");
+  t8_supported_msh_file (cmesh);
+
+  /* The cmesh was read successfully and we need to destroy it. */
+  t8_cmesh_destroy (&cmesh);
+}
+
+/* The same mesh as test_msh_file_vers4_bin, but the node tags are multiplied by 1000
+ * and the nodes are stored in reverse order. */
+TEST (t8_cmesh_readmshfile, test_msh_file_vers4_bin_sparse)
+{
+
+  const char fileprefix[BUFSIZ - 4] = "test/testfiles/test_msh_file_vers4_bin_sparse";
+  char filename[BUFSIZ];
+
+  snprintf (filename, BUFSIZ, "%s.msh", fileprefix);
+
+  t8_debugf ("Checking msh file version 4 binary with sparse node tags...\n");
+
+  ASSERT_FALSE (access (filename, R_OK)) << "Could not open file " << filename;
+  t8_cmesh_t cmesh = t8_cmesh_from_msh_file (fileprefix, 1, sc_MPI_COMM_WORLD, 2, 0, 0);
+  ASSERT_TRUE (cmesh != NULL) << "Could not read cmesh from binary version 4 with sparse node tags.";
+
+  t8_supported_msh_file (cmesh);
+
+  /* The cmesh was read successfully and we need to destroy it. */
+  t8_cmesh_destroy (&cmesh);
 }
@@ -0,0 +1,202 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh.hxx>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_cmesh/t8_cmesh_trees.h>
+#include <t8_geometry/t8_geometry_with_vertices.h>
+#include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.hxx>
+#include <test/t8_gtest_macros.hxx>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/* In this test we save a cmesh to a file and load it once replicated and
+ * once partitioned among all processes. The replicated cmesh must be equal
+ * to the original one, the local trees of the partitioned cmesh must have the
+ * same classes, vertices and face connections as in the original cmesh. */
+
+/* Remove a file on rank 0 after all processes are done with it. */
+static void
+t8_test_save_load_remove (const std::string &filename)
+{
+  int mpirank;
+  int mpiret = sc_MPI_Barrier (sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  if (mpirank == 0) {
+    std::remove (filename.c_str ());
+  }
+}
+
+/* Check that each local tree of a partitioned cmesh matches the tree
+ * with the same global id in a replicated cmesh. */
+static void
+t8_test_save_load_compare_partitioned (t8_cmesh_t cmesh_partitioned, t8_cmesh_t cmesh_replicated)
+{
+  const t8_locidx_t num_local_trees = t8_cmesh_get_num_local_trees (cmesh_partitioned);
+  for (t8_locidx_t ltree = 0; ltree < num_local_trees; ltree++) {
+    const t8_gloidx_t gtree = t8_cmesh_get_global_id (cmesh_partitioned, ltree);
+    const t8_locidx_t ltree_replicated = (t8_locidx_t) gtree;
+    const t8_eclass_t eclass = t8_cmesh_get_tree_class (cmesh_partitioned, ltree);
+    ASSERT_EQ (eclass, t8_cmesh_get_tree_class (cmesh_replicated, ltree_replicated));
+
+    const double *vertices = t8_cmesh_get_tree_vertices (cmesh_partitioned, ltree);
+    const double *vertices_replicated = t8_cmesh_get_tree_vertices (cmesh_replicated, ltree_replicated);
+    for (int icoord = 0; icoord < 3 * t8_eclass_num_vertices[eclass]; icoord++) {
+      EXPECT_EQ (vertices[icoord], vertices_replicated[icoord]);
+    }
+
+    t8_locidx_t *face_neigh, *face_neigh_replicated;
+    int8_t *ttf, *ttf_replicated;
+    t8_cmesh_trees_get_tree_ext (cmesh_partitioned->trees, ltree, &face_neigh, &ttf);
+    t8_cmesh_trees_get_tree_ext (cmesh_replicated->trees, ltree_replicated, &face_neigh_replicated, &ttf_replicated);
+    for (int iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      EXPECT_EQ (t8_cmesh_get_global_id (cmesh_partitioned, face_neigh[iface]), face_neigh_replicated[iface]);
+      EXPECT_EQ (ttf[iface], ttf_replicated[iface]);
+    }
+  }
+}
+
+class cmesh_save_load: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    fileprefix = std::string ("t8_cmesh_save_load_") + t8_eclass_to_string[eclass];
+    cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  }
+  void
+  TearDown () override
+  {
+    t8_cmesh_unref (&cmesh);
+    t8_test_save_load_remove (fileprefix + ".cmesh");
+  }
+
+  t8_eclass_t eclass;
+  std::string fileprefix;
+  t8_cmesh_t cmesh;
+};
+
+TEST_P (cmesh_save_load, save_replicated)
+{
+  ASSERT_TRUE (t8_cmesh_save (cmesh, fileprefix.c_str (), sc_MPI_COMM_WORLD));
+
+  t8_cmesh_t cmesh_loaded = t8_cmesh_load ((fileprefix + ".cmesh").c_str (), sc_MPI_COMM_WORLD);
+  ASSERT_NE (cmesh_loaded, nullptr);
+  EXPECT_TRUE (t8_cmesh_is_equal (cmesh, cmesh_loaded));
+  t8_cmesh_destroy (&cmesh_loaded);
+
+  cmesh_loaded = t8_cmesh_load_and_distribute (fileprefix.c_str (), 2, sc_MPI_COMM_WORLD, T8_LOAD_SIMPLE, -1);
+  ASSERT_NE (cmesh_loaded, nullptr);
+  EXPECT_TRUE (t8_cmesh_is_partitioned (cmesh_loaded));
+  EXPECT_EQ (t8_cmesh_get_num_trees (cmesh_loaded), t8_cmesh_get_num_trees (cmesh));
+  t8_test_save_load_compare_partitioned (cmesh_loaded, cmesh);
+  t8_cmesh_destroy (&cmesh_loaded);
+}
+
+TEST_P (cmesh_save_load, save_partitioned)
+{
+  t8_cmesh_t cmesh_partitioned = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 1, 0);
+  ASSERT_TRUE (t8_cmesh_save (cmesh_partitioned, fileprefix.c_str (), sc_MPI_COMM_WORLD));
+  t8_cmesh_destroy (&cmesh_partitioned);
+
+  /* A single reading process still yields a cmesh that is partitioned among all processes */
+  t8_cmesh_t cmesh_loaded
+    = t8_cmesh_load_and_distribute (fileprefix.c_str (), 1, sc_MPI_COMM_WORLD, T8_LOAD_SIMPLE, -1);
+  ASSERT_NE (cmesh_loaded, nullptr);
+  EXPECT_TRUE (t8_cmesh_is_partitioned (cmesh_loaded));
+  EXPECT_EQ (t8_cmesh_get_num_trees (cmesh_loaded), t8_cmesh_get_num_trees (cmesh));
+  t8_test_save_load_compare_partitioned (cmesh_loaded, cmesh);
+  t8_cmesh_destroy (&cmesh_loaded);
+
+  cmesh_loaded = t8_cmesh_load_and_distribute (fileprefix.c_str (), 2, sc_MPI_COMM_WORLD, T8_LOAD_STRIDE, 2);
+  ASSERT_NE (cmesh_loaded, nullptr);
+  EXPECT_TRUE (t8_cmesh_is_partitioned (cmesh_loaded));
+  t8_test_save_load_compare_partitioned (cmesh_loaded, cmesh);
+  t8_cmesh_destroy (&cmesh_loaded);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_cmesh_save_load, cmesh_save_load, AllEclasses, print_eclass);
+
+/* Save a cmesh with additional tree attributes and check that they are restored. */
+TEST (cmesh_save_load_attributes, save_attributes)
+{
+  const std::string fileprefix = "t8_cmesh_save_load_attributes";
+  const int key = 42;
+  t8_cmesh_t cmesh;
+
+  t8_cmesh_init (&cmesh);
+  for (t8_gloidx_t itree = 0; itree < 2; itree++) {
+    /* The trees are the unit squares [itree, itree + 1] x [0, 1] */
+    const double vertices[12] = { (double) itree, 0, 0, itree + 1., 0, 0, (double) itree, 1, 0, itree + 1., 1, 0 };
+    t8_cmesh_set_tree_class (cmesh, itree, T8_ECLASS_QUAD);
+    t8_cmesh_set_tree_vertices (cmesh, itree, vertices, 4);
+    const std::string name = "tree" + std::to_string (itree);
+    t8_cmesh_set_attribute_string (cmesh, itree, t8_get_package_id (), key, name.c_str ());
+  }
+  t8_cmesh_set_join (cmesh, 0, 1, 1, 0, 0);
+  t8_cmesh_register_geometry<t8_geometry_linear> (cmesh, 2);
+  t8_cmesh_commit (cmesh, sc_MPI_COMM_WORLD);
+
+  ASSERT_TRUE (t8_cmesh_save (cmesh, fileprefix.c_str (), sc_MPI_COMM_WORLD));
+  t8_cmesh_t cmesh_loaded = t8_cmesh_load ((fileprefix + ".cmesh").c_str (), sc_MPI_COMM_WORLD);
+  ASSERT_NE (cmesh_loaded, nullptr);
+  EXPECT_TRUE (t8_cmesh_is_equal (cmesh, cmesh_loaded));
+  for (t8_locidx_t itree = 0; itree < 2; itree++) {
+    const char *name = (const char *) t8_cmesh_get_attribute (cmesh_loaded, t8_get_package_id (), key, itree);
+    ASSERT_NE (name, nullptr);
+    EXPECT_STREQ (name, ("tree" + std::to_string (itree)).c_str ());
+  }
+  t8_cmesh_destroy (&cmesh_loaded);
+  t8_cmesh_destroy (&cmesh);
+  t8_test_save_load_remove (fileprefix + ".cmesh");
+}
+
+/* Files of the old per process text format must be rejected instead of misread. */
+TEST (cmesh_save_load_old_format, reject_old_format)
+{
+  const std::string fileprefix = "t8_cmesh_save_load_old_format";
+  const std::string filename = fileprefix + "_0000.cmesh";
+  int mpirank;
+
+  int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  if (mpirank == 0) {
+    FILE *fp = fopen (filename.c_str (), "w");
+    ASSERT_NE (fp, nullptr);
+    fprintf (fp, "This is t8 0.0.0, file format version 2.\n\nPartitioned 0\nRank 0 of 1\ndim 2\n");
+    fclose (fp);
+  }
+  mpiret = sc_MPI_Barrier (sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+
+  EXPECT_EQ (t8_cmesh_load (filename.c_str (), sc_MPI_COMM_WORLD), nullptr);
+  EXPECT_EQ (t8_cmesh_load_and_distribute (fileprefix.c_str (), 1, sc_MPI_COMM_WORLD, T8_LOAD_SIMPLE, -1), nullptr);
+  t8_test_save_load_remove (filename);
+}
@@ -0,0 +1,171 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh.hxx>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_cmesh/t8_cmesh_helpers.h>
+#include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.hxx>
+
+/* In this file we test the `t8_cmesh_set_join_by_vertices_parallel` routine.
+ * We retrieve all tree vertices from a replicated example cmesh and compute
+ * the face connectivity with `t8_cmesh_set_join_by_vertices`. Then we build a
+ * partitioned cmesh where each process only sets and passes its own trees,
+ * join the trees in parallel and compare the face neighbors of the local trees
+ * with the serially computed connectivity.
+ */
+
+static void
+test_with_cmesh (t8_cmesh_t cmesh, sc_MPI_Comm comm)
+{
+  const t8_locidx_t ntrees = t8_cmesh_get_num_local_trees (cmesh);
+  const int dim = t8_cmesh_get_dimension (cmesh);
+  int mpirank, mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  /* Arrays for the face connectivity computations via vertices. */
+  double *all_verts = T8_ALLOC_ZERO (double, ntrees *T8_ECLASS_MAX_CORNERS *T8_ECLASS_MAX_DIM);
+  t8_eclass_t *all_eclasses = T8_ALLOC (t8_eclass_t, ntrees);
+
+  /* Retrieve all tree vertices and element classes and store them into arrays. */
+  for (t8_locidx_t itree = 0; itree < ntrees; itree++) {
+    const t8_eclass_t eclass = t8_cmesh_get_tree_class (cmesh, itree);
+    all_eclasses[itree] = eclass;
+
+    const double *vertices = t8_cmesh_get_tree_vertices (cmesh, itree);
+
+    const int nverts = t8_eclass_num_vertices[eclass];
+
+    for (int ivert = 0; ivert < nverts; ivert++) {
+      for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+        all_verts[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)]
+          = vertices[T8_2D_TO_1D (nverts, T8_ECLASS_MAX_DIM, ivert, icoord)];
+      }
+    }
+  }
+
+  /* Compute the reference face connectivity. */
+  int *conn = NULL;
+  const int do_both_directions = 1;
+  t8_cmesh_set_join_by_vertices (NULL, ntrees, all_eclasses, all_verts, &conn, do_both_directions);
+
+  /* Build a partitioned cmesh, each process only knows its own trees. */
+  const t8_gloidx_t first_tree = (t8_gloidx_t) ntrees * mpirank / mpisize;
+  const t8_gloidx_t last_tree = (t8_gloidx_t) ntrees * (mpirank + 1) / mpisize - 1;
+  const t8_locidx_t num_local_trees = last_tree - first_tree + 1;
+  const double *local_verts
+    = all_verts + T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, first_tree, 0, 0);
+  t8_cmesh_t cmesh_partitioned;
+
+  t8_cmesh_init (&cmesh_partitioned);
+  t8_cmesh_set_dimension (cmesh_partitioned, dim);
+  t8_cmesh_register_geometry<t8_geometry_linear> (cmesh_partitioned, dim);
+  for (t8_gloidx_t gtree = first_tree; gtree <= last_tree; gtree++) {
+    const t8_eclass_t eclass = all_eclasses[gtree];
+    t8_cmesh_set_tree_class (cmesh_partitioned, gtree, eclass);
+    t8_cmesh_set_tree_vertices (cmesh_partitioned, gtree,
+                                all_verts + T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, gtree, 0, 0),
+                                t8_eclass_num_vertices[eclass]);
+  }
+  t8_cmesh_set_join_by_vertices_parallel (cmesh_partitioned, first_tree, num_local_trees, all_eclasses + first_tree,
+                                          local_verts, comm);
+  t8_cmesh_set_partition_range (cmesh_partitioned, 3, first_tree, last_tree);
+  t8_cmesh_commit (cmesh_partitioned, comm);
+
+  /* Compare the face neighbors of the local trees with the reference connectivity. */
+  ASSERT_EQ (t8_cmesh_get_num_local_trees (cmesh_partitioned), num_local_trees);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_gloidx_t gtree = first_tree + itree;
+    const t8_eclass_t eclass = all_eclasses[gtree];
+
+    for (int iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      const int conn_dual_itree = conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, gtree, iface, 0)];
+      const int conn_dual_iface = conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, gtree, iface, 1)];
+      const int conn_orientation = conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, gtree, iface, 2)];
+
+      int dual_iface;
+      int orientation;
+      const t8_locidx_t dual_itree
+        = t8_cmesh_get_face_neighbor (cmesh_partitioned, itree, iface, &dual_iface, &orientation);
+
+      if (conn_dual_itree < 0) {
+        EXPECT_LT (dual_itree, 0) << "Found a face connection that does not exist.";
+      }
+      else {
+        ASSERT_GE (dual_itree, 0) << "Missing face connection.";
+        EXPECT_EQ (t8_cmesh_get_global_id (cmesh_partitioned, dual_itree), conn_dual_itree)
+          << "Neighboring trees do not match.";
+        EXPECT_EQ (dual_iface, conn_dual_iface) << "Dual faces do not match.";
+        EXPECT_EQ (orientation, conn_orientation) << "Face orientations do not match.";
+      }
+    }
+  }
+
+  t8_cmesh_destroy (&cmesh_partitioned);
+  T8_FREE (conn);
+  T8_FREE (all_verts);
+  T8_FREE (all_eclasses);
+}
+
+TEST (t8_cmesh_set_join_by_vertices_parallel, test_cmesh_set_join_by_vertices_parallel)
+{
+  sc_MPI_Comm comm = sc_MPI_COMM_WORLD;
+  const int do_partition = 0;
+  const int periodic = 0;
+
+  {
+    t8_cmesh_t cmesh = t8_cmesh_new_brick_2d (5, 7, 0, 0, comm);
+    test_with_cmesh (cmesh, comm);
+    t8_cmesh_destroy (&cmesh);
+  }
+
+  {
+    t8_cmesh_t cmesh = t8_cmesh_new_brick_3d (3, 4, 5, 0, 0, 0, comm);
+    test_with_cmesh (cmesh, comm);
+    t8_cmesh_destroy (&cmesh);
+  }
+
+  {
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube_hybrid (comm, do_partition, periodic);
+    test_with_cmesh (cmesh, comm);
+    t8_cmesh_destroy (&cmesh);
+  }
+
+  {
+    t8_cmesh_t cmesh = t8_cmesh_new_hybrid_gate (comm);
+    test_with_cmesh (cmesh, comm);
+    t8_cmesh_destroy (&cmesh);
+  }
+
+  {
+    t8_cmesh_t cmesh = t8_cmesh_new_full_hybrid (comm);
+    test_with_cmesh (cmesh, comm);
+    t8_cmesh_destroy (&cmesh);
+  }
+}
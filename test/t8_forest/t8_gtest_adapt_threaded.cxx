@@ -0,0 +1,111 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+
+/* In this test we adapt a uniform forest once serially and once with
+ * multiple threads. The uniform level is chosen such that the local trees
+ * are split into several chunks. We check that both forests consist of
+ * the same elements in the same order. */
+
+class forest_adapt_threaded: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    scheme = t8_scheme_new_default_cxx ();
+    cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    /* Choose the level such that each tree has at least 4096 elements */
+    const int dim = t8_eclass_to_dimension[eclass];
+    const int level = dim == 0 ? 0 : 12 / dim;
+    forest = t8_forest_new_uniform (cmesh, scheme, level, 0, sc_MPI_COMM_WORLD);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+  }
+  t8_eclass_t eclass;
+  t8_scheme_cxx_t *scheme;
+  t8_cmesh_t cmesh;
+  t8_forest_t forest;
+};
+
+/* Coarsen, refine and remove elements depending on their index. */
+static int
+t8_test_adapt_threaded_fn (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                           t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                           const int num_elements, t8_element_t *elements[])
+{
+  if (is_family && lelement_id % 5 == 0) {
+    return -1;
+  }
+  const int child_id = ts->t8_element_child_id (elements[0]);
+  if (child_id == 1 && lelement_id % 3 == 0) {
+    return 1;
+  }
+  if (child_id == 2 && lelement_id % 7 == 0) {
+    return -2;
+  }
+  return 0;
+}
+
+static t8_forest_t
+t8_test_adapt_threaded (t8_forest_t forest_from, const int num_threads)
+{
+  t8_forest_t forest_adapt;
+
+  t8_forest_ref (forest_from);
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_adapt (forest_adapt, forest_from, t8_test_adapt_threaded_fn, 0);
+  t8_forest_set_adapt_num_threads (forest_adapt, num_threads);
+  t8_forest_commit (forest_adapt);
+  return forest_adapt;
+}
+
+TEST_P (forest_adapt_threaded, test_adapt_threaded)
+{
+  t8_forest_t forest_serial = t8_test_adapt_threaded (forest, 0);
+
+  for (int num_threads = 2; num_threads <= 4; num_threads++) {
+    t8_forest_t forest_threaded = t8_test_adapt_threaded (forest, num_threads);
+
+    ASSERT_TRUE (t8_forest_is_equal (forest_serial, forest_threaded)) << "The forests are not equal";
+    EXPECT_EQ (t8_forest_get_global_num_elements (forest_serial), t8_forest_get_global_num_elements (forest_threaded));
+    const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest_serial);
+    for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+      EXPECT_EQ (t8_forest_get_tree_element_offset (forest_serial, itree),
+                 t8_forest_get_tree_element_offset (forest_threaded, itree));
+    }
+    t8_forest_unref (&forest_threaded);
+  }
+  t8_forest_unref (&forest_serial);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_adapt_threaded, forest_adapt_threaded, AllEclasses, print_eclass);
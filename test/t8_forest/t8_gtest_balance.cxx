@@ -35,6 +35,8 @@
 #include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.hxx>
 #include <t8_schemes/t8_default/t8_default.hxx>
 #include <t8_forest/t8_forest_balance.h>
+#include <t8_forest/t8_forest_profiling.h>
+#include <t8_forest/t8_forest_private.h>
 
 #include <array>
 #include <vector>
@@ -244,5 +246,179 @@ TEST (gtest_balance, balance_consistency_test)
   t8_forest_unref (&already_balanced_forest);
 }
 
+/**
+ * \brief The refinement criterion of the adapt based balance algorithm: An element is refined
+ * if one of its half face neighbors has a leaf descendant in \a forest_from.
+ * The user data of \a forest is an integer that is set to 1 if an element is refined.
+ */
+static int
+t8_gtest_balance_adapt_round (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                              t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                              const int num_elements, t8_element_t *elements[])
+{
+  int *refined = static_cast<int *> (t8_forest_get_user_data (forest));
+  const int num_faces = ts->t8_element_num_faces (elements[0]);
+
+  for (int iface = 0; iface < num_faces; iface++) {
+    const t8_eclass_t neigh_class = t8_forest_element_neighbor_eclass (forest_from, which_tree, elements[0], iface);
+    t8_eclass_scheme_c *neigh_scheme = t8_forest_get_eclass_scheme (forest_from, neigh_class);
+    const int num_half_neighbors = ts->t8_element_num_face_children (elements[0], iface);
+    std::vector<t8_element_t *> half_neighbors (num_half_neighbors);
+    neigh_scheme->t8_element_new (num_half_neighbors, half_neighbors.data ());
+    const t8_gloidx_t neighbor_tree
+      = t8_forest_element_half_face_neighbors (forest_from, which_tree, elements[0], half_neighbors.data (),
+                                               neigh_scheme, iface, num_half_neighbors, NULL);
+    int refine = 0;
+    for (int ineigh = 0; neighbor_tree >= 0 && ineigh < num_half_neighbors && !refine; ineigh++) {
+      refine = t8_forest_element_has_leaf_desc (forest_from, neighbor_tree, half_neighbors[ineigh], neigh_scheme);
+    }
+    neigh_scheme->t8_element_destroy (num_half_neighbors, half_neighbors.data ());
+    if (refine) {
+      *refined = 1;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * \brief Balance a forest with one adapt round per level of refinement that has to propagate,
+ * as t8_forest_balance did before it computed the refinements directly.
+ * \param [in] forest       The forest to balance. This function takes ownership of \a forest.
+ * \param [out] num_rounds  The number of adapt rounds, including the last round that refines nothing.
+ * \return The balanced forest.
+ */
+static t8_forest_t
+t8_gtest_balance_by_adapt_rounds (t8_forest_t forest, int *num_rounds)
+{
+  int refined_global = 1;
+
+  /* The refinement criterion needs the ghost elements of the forest that we adapt */
+  t8_forest_t forest_from;
+  t8_forest_init (&forest_from);
+  t8_forest_set_copy (forest_from, forest);
+  t8_forest_set_ghost (forest_from, 1, T8_GHOST_FACES);
+  t8_forest_commit (forest_from);
+
+  *num_rounds = 0;
+  while (refined_global) {
+    int refined = 0;
+    t8_forest_t forest_adapt;
+    t8_forest_init (&forest_adapt);
+    t8_forest_set_user_data (forest_adapt, &refined);
+    t8_forest_set_adapt (forest_adapt, forest_from, t8_gtest_balance_adapt_round, 0);
+    t8_forest_set_ghost (forest_adapt, 1, T8_GHOST_FACES);
+    t8_forest_commit (forest_adapt);
+    const int mpiret = sc_MPI_Allreduce (&refined, &refined_global, 1, sc_MPI_INT, sc_MPI_LOR, sc_MPI_COMM_WORLD);
+    SC_CHECK_MPI (mpiret);
+    forest_from = forest_adapt;
+    (*num_rounds)++;
+  }
+  return forest_from;
+}
+
+/**
+ * \brief Balance a forest without repartitioning and with profiling enabled.
+ * \param [in] forest       The forest to balance. This function takes ownership of \a forest.
+ * \param [out] num_rounds  The number of rounds that balance needed.
+ * \param [out] rounds_saved The rounds saved compared to the adapt based algorithm, as reported by the profile.
+ * \return The balanced forest.
+ */
+static t8_forest_t
+t8_gtest_balance_with_profile (t8_forest_t forest, int *num_rounds, int *rounds_saved)
+{
+  t8_forest_t balanced_forest;
+  t8_forest_init (&balanced_forest);
+  t8_forest_set_balance (balanced_forest, forest, 1);
+  t8_forest_set_profiling (balanced_forest, 1);
+  t8_forest_commit (balanced_forest);
+
+  t8_forest_profile_get_balance_time (balanced_forest, num_rounds);
+  t8_forest_compute_profile (balanced_forest);
+  *rounds_saved = t8_forest_profile_get_balance_rounds_saved_stats (balanced_forest)->max;
+  return balanced_forest;
+}
+
+/**
+ * \brief Balances a forest with a large level jump between neighboring trees and checks that
+ * the result equals the one of the adapt based algorithm and that fewer rounds were needed.
+ */
+TEST (gtest_balance, balance_large_level_jump_rounds)
+{
+  const int additional_refinement = 4;
+  std::vector<t8_gloidx_t> trees_to_refine { 0 };
+
+  t8_forest_t forest = t8_gtest_obtain_forest_for_balance_tests (trees_to_refine, additional_refinement);
+  t8_forest_ref (forest);
+
+  int reference_rounds;
+  t8_forest_t reference_forest = t8_gtest_balance_by_adapt_rounds (forest, &reference_rounds);
+  int balance_rounds, rounds_saved;
+  t8_forest_t balanced_forest = t8_gtest_balance_with_profile (forest, &balance_rounds, &rounds_saved);
+
+  EXPECT_TRUE (t8_forest_is_balanced (balanced_forest));
+  EXPECT_TRUE (t8_forest_is_equal (balanced_forest, reference_forest));
+  /* The cmesh is replicated, thus a single round suffices */
+  EXPECT_EQ (balance_rounds, 1);
+  EXPECT_LT (balance_rounds, reference_rounds);
+  /* The reported saved rounds are a lower bound for the rounds actually saved */
+  EXPECT_GT (rounds_saved, 0);
+  EXPECT_LE (balance_rounds + rounds_saved, reference_rounds);
+
+  t8_forest_unref (&balanced_forest);
+  t8_forest_unref (&reference_forest);
+}
+
+/* The parameters of t8_gtest_balance_refine_first_element: Refine all descendants of the first element
+ * of level base_level in tree 0 up to level max_level. */
+struct gtest_balance_first_element_data
+{
+  int base_level;
+  int max_level;
+};
+
+static int
+t8_gtest_balance_refine_first_element (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                                       t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                                       const int num_elements, t8_element_t *elements[])
+{
+  const gtest_balance_first_element_data *adapt_data
+    = static_cast<const gtest_balance_first_element_data *> (t8_forest_get_user_data (forest));
+
+  return t8_forest_global_tree_id (forest_from, which_tree) == 0
+         && ts->t8_element_level (elements[0]) < adapt_data->max_level
+         && ts->t8_element_get_linear_id (elements[0], adapt_data->base_level) == 0;
+}
+
+/**
+ * \brief Balances forests of all element classes, in which one element is refined three levels deeper
+ * than its neighbors, and checks that the result equals the one of the adapt based algorithm.
+ */
+TEST_P (gtest_balance, balance_equals_adapt_rounds)
+{
+  if (ieclass == t8_eclass_t::T8_ECLASS_PYRAMID && ido_periodic == 1)
+    GTEST_SKIP_ ("The pyramid cube mesh cannot be periodic.");
+
+  t8_cmesh_t cmesh = t8_cmesh_new_hypercube (ieclass, sc_MPI_COMM_WORLD, 0, 0, ido_periodic);
+  t8_forest_t uniform_forest
+    = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), ilevel, 0, sc_MPI_COMM_WORLD);
+  gtest_balance_first_element_data adapt_data { ilevel, ilevel + 3 };
+  t8_forest_t forest = t8_forest_new_adapt (uniform_forest, t8_gtest_balance_refine_first_element, 1, 0, &adapt_data);
+  t8_forest_ref (forest);
+
+  int reference_rounds;
+  t8_forest_t reference_forest = t8_gtest_balance_by_adapt_rounds (forest, &reference_rounds);
+  int balance_rounds, rounds_saved;
+  t8_forest_t balanced_forest = t8_gtest_balance_with_profile (forest, &balance_rounds, &rounds_saved);
+
+  EXPECT_TRUE (t8_forest_is_balanced (balanced_forest));
+  EXPECT_TRUE (t8_forest_is_equal (balanced_forest, reference_forest));
+  EXPECT_LE (balance_rounds, reference_rounds);
+  EXPECT_LE (balance_rounds + rounds_saved, reference_rounds);
+
+  t8_forest_unref (&balanced_forest);
+  t8_forest_unref (&reference_forest);
+}
+
 INSTANTIATE_TEST_SUITE_P (t8_gtest_balance, gtest_balance,
                           testing::Combine (AllEclasses, testing::Range (0, 5), testing::Range (0, 2)));
@@ -0,0 +1,231 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_face_connectivity.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+
+/* In this test we build the face connectivity of an adapted and balanced forest,
+ * once with the algorithm for balanced forests and once with the general one,
+ * and compare each entry with the output of t8_forest_leaf_face_neighbors_ext.
+ * We also build the connectivity of a forest that is not balanced, in which leaves
+ * have face neighbors that are several levels finer. */
+
+class forest_face_connectivity: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    t8_scheme_cxx_t *scheme = t8_scheme_new_default_cxx ();
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    t8_forest_t forest_uniform = t8_forest_new_uniform (cmesh, scheme, 2, 0, sc_MPI_COMM_WORLD);
+
+    /* Adapt, balance and partition the forest and create a ghost layer */
+    t8_forest_init (&forest);
+    t8_forest_set_adapt (forest, forest_uniform, t8_test_face_connectivity_adapt, 0);
+    t8_forest_set_balance (forest, NULL, 0);
+    t8_forest_set_partition (forest, NULL, 0);
+    t8_forest_set_ghost (forest, 1, T8_GHOST_FACES);
+    t8_forest_commit (forest);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+  }
+
+  /* Refine every second element. */
+  static int
+  t8_test_face_connectivity_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                                   t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                                   const int num_elements, t8_element_t *elements[])
+  {
+    return lelement_id % 2 == 0;
+  }
+
+  t8_eclass_t eclass;
+  t8_forest_t forest;
+};
+
+/* Compare each entry of a face connectivity with the output of t8_forest_leaf_face_neighbors_ext. */
+static void
+t8_test_face_connectivity_compare (t8_forest_t forest, const t8_forest_face_connectivity_t *connectivity,
+                                   const int forest_is_balanced)
+{
+  ASSERT_TRUE (connectivity != NULL);
+  EXPECT_EQ (connectivity->forest_is_balanced, forest_is_balanced);
+  EXPECT_EQ (connectivity->num_local_elements, t8_forest_get_local_num_elements (forest));
+  EXPECT_EQ (connectivity->num_ghosts, t8_forest_get_num_ghosts (forest));
+
+  t8_locidx_t lelement_id = 0;
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    const t8_locidx_t num_elements_in_tree = t8_forest_get_tree_num_elements (forest, itree);
+    for (t8_locidx_t ielement = 0; ielement < num_elements_in_tree; ielement++, lelement_id++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      const int num_faces = ts->t8_element_num_faces (element);
+      ASSERT_EQ (connectivity->face_offsets[lelement_id + 1] - connectivity->face_offsets[lelement_id], num_faces);
+      for (int iface = 0; iface < num_faces; iface++) {
+        t8_element_t **neighbor_leaves;
+        int *dual_faces;
+        int num_neighbors;
+        t8_locidx_t *element_indices;
+        t8_eclass_scheme_c *neigh_scheme;
+        int orientation;
+        t8_forest_leaf_face_neighbors_ext (forest, itree, element, &neighbor_leaves, iface, &dual_faces, &num_neighbors,
+                                           &element_indices, &neigh_scheme, forest_is_balanced, NULL, &orientation);
+
+        const t8_locidx_t *conn_indices;
+        const int *conn_dual_faces;
+        int conn_orientation;
+        const t8_locidx_t conn_num_neighbors = t8_forest_face_connectivity_get_neighbors (
+          connectivity, lelement_id, iface, &conn_indices, &conn_dual_faces, &conn_orientation);
+        ASSERT_EQ (conn_num_neighbors, num_neighbors);
+        EXPECT_EQ (conn_orientation, orientation);
+        for (int ineigh = 0; ineigh < num_neighbors; ineigh++) {
+          EXPECT_EQ (conn_indices[ineigh], element_indices[ineigh]);
+          EXPECT_EQ (conn_dual_faces[ineigh], dual_faces[ineigh]);
+        }
+        if (num_neighbors > 0) {
+          neigh_scheme->t8_element_destroy (num_neighbors, neighbor_leaves);
+          T8_FREE (neighbor_leaves);
+          T8_FREE (element_indices);
+          T8_FREE (dual_faces);
+        }
+      }
+    }
+  }
+}
+
+TEST_P (forest_face_connectivity, test_face_connectivity)
+{
+  const t8_forest_face_connectivity_t *connectivity = t8_forest_build_face_connectivity (forest, 1);
+
+  /* The connectivity is cached */
+  EXPECT_EQ (connectivity, t8_forest_get_face_connectivity (forest));
+  EXPECT_EQ (connectivity, t8_forest_build_face_connectivity (forest, 1));
+  t8_test_face_connectivity_compare (forest, connectivity, 1);
+}
+
+TEST_P (forest_face_connectivity, test_face_connectivity_unbalanced)
+{
+  /* Building with a different balance flag replaces the cached connectivity */
+  t8_forest_build_face_connectivity (forest, 1);
+  const t8_forest_face_connectivity_t *connectivity = t8_forest_build_face_connectivity (forest, 0);
+  EXPECT_EQ (connectivity, t8_forest_get_face_connectivity (forest));
+  t8_test_face_connectivity_compare (forest, connectivity, 0);
+}
+
+class forest_face_connectivity_not_balanced: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    t8_scheme_cxx_t *scheme = t8_scheme_new_default_cxx ();
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    t8_forest_t forest_uniform = t8_forest_new_uniform (cmesh, scheme, t8_test_coarse_level, 0, sc_MPI_COMM_WORLD);
+
+    /* Refine one element recursively, partition the forest and create a ghost layer */
+    t8_forest_init (&forest);
+    t8_forest_set_adapt (forest, forest_uniform, t8_test_face_connectivity_adapt, 1);
+    t8_forest_set_partition (forest, NULL, 0);
+    t8_forest_set_ghost (forest, 1, T8_GHOST_FACES);
+    t8_forest_commit (forest);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+  }
+
+  /* Refine all descendants of the first coarse element of the first tree up to the fine level.
+   * Its coarse face neighbors are not refined. */
+  static int
+  t8_test_face_connectivity_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                                   t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                                   const int num_elements, t8_element_t *elements[])
+  {
+    return t8_forest_global_tree_id (forest_from, which_tree) == 0
+           && ts->t8_element_level (elements[0]) < t8_test_fine_level
+           && ts->t8_element_get_linear_id (elements[0], t8_test_coarse_level) == 0;
+  }
+
+  static const int t8_test_coarse_level = 2;
+  static const int t8_test_fine_level = 5;
+  t8_eclass_t eclass;
+  t8_forest_t forest;
+};
+
+TEST_P (forest_face_connectivity_not_balanced, test_face_connectivity_not_balanced)
+{
+  const t8_forest_face_connectivity_t *connectivity = t8_forest_build_face_connectivity (forest, 0);
+  t8_test_face_connectivity_compare (forest, connectivity, 0);
+
+  /* Check that there are local face neighbors whose levels differ by more than one,
+   * so that the search descended over several levels */
+  int max_level_difference = 0;
+  const t8_locidx_t num_local_elements = t8_forest_get_local_num_elements (forest);
+  for (t8_locidx_t lelement_id = 0; lelement_id < num_local_elements; lelement_id++) {
+    t8_locidx_t ltreeid;
+    const t8_element_t *element = t8_forest_get_element (forest, lelement_id, &ltreeid);
+    const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, ltreeid));
+    const int num_faces = ts->t8_element_num_faces (element);
+    for (int iface = 0; iface < num_faces; iface++) {
+      const t8_locidx_t *conn_indices;
+      const int *conn_dual_faces;
+      const t8_locidx_t num_neighbors = t8_forest_face_connectivity_get_neighbors (
+        connectivity, lelement_id, iface, &conn_indices, &conn_dual_faces, NULL);
+      for (t8_locidx_t ineigh = 0; ineigh < num_neighbors; ineigh++) {
+        if (conn_indices[ineigh] < num_local_elements) {
+          t8_locidx_t neigh_ltreeid;
+          const t8_element_t *neighbor = t8_forest_get_element (forest, conn_indices[ineigh], &neigh_ltreeid);
+          const t8_eclass_scheme_c *neigh_scheme
+            = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, neigh_ltreeid));
+          const int level_difference = neigh_scheme->t8_element_level (neighbor) - ts->t8_element_level (element);
+          max_level_difference = SC_MAX (max_level_difference, abs (level_difference));
+        }
+      }
+    }
+  }
+  int global_max_level_difference;
+  int mpiret = sc_MPI_Allreduce (&max_level_difference, &global_max_level_difference, 1, sc_MPI_INT, sc_MPI_MAX,
+                                 sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  EXPECT_GT (global_max_level_difference, 1);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_face_connectivity, forest_face_connectivity,
+                          testing::Values (T8_ECLASS_LINE, T8_ECLASS_QUAD, T8_ECLASS_TRIANGLE, T8_ECLASS_HEX,
+                                           T8_ECLASS_TET, T8_ECLASS_PRISM),
+                          print_eclass);
+INSTANTIATE_TEST_SUITE_P (t8_gtest_face_connectivity_not_balanced, forest_face_connectivity_not_balanced,
+                          testing::Values (T8_ECLASS_LINE, T8_ECLASS_QUAD, T8_ECLASS_TRIANGLE, T8_ECLASS_HEX,
+                                           T8_ECLASS_TET, T8_ECLASS_PRISM),
+                          print_eclass);
@@ -0,0 +1,146 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_compact.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+
+/* In this test we store the elements of an adapted forest in compact form.
+ * We check that the decoded elements equal the elements of a copy of the forest,
+ * that the element memory does not grow, that expanding restores the forest and
+ * that a compact forest can be used as the source of a new forest and stays compact. */
+
+class forest_compact: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    scheme = t8_scheme_new_default_cxx ();
+    cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    const int dim = t8_eclass_to_dimension[eclass];
+    const int level = dim == 0 ? 0 : 9 / dim;
+    t8_forest_t forest_uniform = t8_forest_new_uniform (cmesh, scheme, level, 0, sc_MPI_COMM_WORLD);
+    forest = t8_forest_new_adapt (forest_uniform, t8_test_compact_adapt, 0, 0, NULL);
+    /* Keep an uncompressed copy of the forest */
+    t8_forest_ref (forest);
+    t8_forest_init (&forest_copy);
+    t8_forest_set_copy (forest_copy, forest);
+    t8_forest_commit (forest_copy);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+    t8_forest_unref (&forest_copy);
+  }
+
+  /* Refine every third element and coarsen every fifth family. */
+  static int
+  t8_test_compact_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                         t8_eclass_scheme_c *ts, const int is_family, const int num_elements,
+                         t8_element_t *elements[])
+  {
+    if (is_family && lelement_id % 5 == 0) {
+      return -1;
+    }
+    return lelement_id % 3 == 0;
+  }
+
+  t8_eclass_t eclass;
+  t8_scheme_cxx_t *scheme;
+  t8_cmesh_t cmesh;
+  t8_forest_t forest;
+  t8_forest_t forest_copy;
+};
+
+TEST_P (forest_compact, decode_elements)
+{
+  const size_t memory_full = t8_forest_get_element_memory (forest);
+  t8_forest_compact (forest);
+  ASSERT_TRUE (t8_forest_is_compact (forest));
+  EXPECT_LE (t8_forest_get_element_memory (forest), memory_full);
+
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  ASSERT_EQ (num_local_trees, t8_forest_get_num_local_trees (forest_copy));
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_locidx_t num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    ASSERT_EQ (num_elements, t8_forest_get_tree_num_elements (forest_copy, itree));
+    EXPECT_EQ (num_elements, t8_forest_get_tree_element_count (t8_forest_get_tree (forest, itree)));
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    if (num_elements > 0 && ts->t8_element_size () > sizeof (t8_linearidx_t)) {
+      /* The elements are larger than a key, so the tree is stored in compact form. */
+      EXPECT_LT (t8_forest_get_element_memory (forest), memory_full);
+    }
+
+    /* Decode the elements one by one */
+    t8_element_t *element;
+    ts->t8_element_new (1, &element);
+    for (t8_locidx_t ielem = 0; ielem < num_elements; ielem++) {
+      t8_forest_decode_element_in_tree (forest, itree, ielem, element);
+      EXPECT_TRUE (ts->t8_element_equal (element, t8_forest_get_element_in_tree (forest_copy, itree, ielem)))
+        << "Decoded element " << ielem << " differs.";
+    }
+    ts->t8_element_destroy (1, &element);
+
+    /* Decode the elements of the tree as one range */
+    t8_element_array_t elements;
+    t8_element_array_init_size (&elements, ts, num_elements);
+    t8_forest_decode_elements_in_tree (forest, itree, 0, num_elements, &elements);
+    for (t8_locidx_t ielem = 0; ielem < num_elements; ielem++) {
+      EXPECT_TRUE (ts->t8_element_equal (t8_element_array_index_locidx (&elements, ielem),
+                                         t8_forest_get_element_in_tree (forest_copy, itree, ielem)))
+        << "Decoded element " << ielem << " of the range differs.";
+    }
+    t8_element_array_reset (&elements);
+  }
+
+  t8_forest_expand (forest);
+  ASSERT_FALSE (t8_forest_is_compact (forest));
+  EXPECT_TRUE (t8_forest_is_equal (forest, forest_copy)) << "The expanded forest differs from the original.";
+}
+
+TEST_P (forest_compact, adapt_from_compact)
+{
+  t8_forest_compact (forest);
+
+  /* t8_forest_new_adapt takes ownership of the source forests */
+  t8_forest_ref (forest);
+  t8_forest_ref (forest_copy);
+  t8_forest_t forest_adapt = t8_forest_new_adapt (forest, t8_test_compact_adapt, 0, 0, NULL);
+  t8_forest_t forest_adapt_copy = t8_forest_new_adapt (forest_copy, t8_test_compact_adapt, 0, 0, NULL);
+
+  /* We still hold a reference to the source forest, so it must stay compact */
+  EXPECT_TRUE (t8_forest_is_compact (forest));
+  EXPECT_TRUE (t8_forest_is_equal (forest_adapt, forest_adapt_copy)) << "The adapted forests are not equal.";
+  t8_forest_expand (forest);
+  EXPECT_TRUE (t8_forest_is_equal (forest, forest_copy)) << "The source forest changed.";
+  t8_forest_unref (&forest_adapt);
+  t8_forest_unref (&forest_adapt_copy);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_forest_compact, forest_compact, AllEclasses, print_eclass);
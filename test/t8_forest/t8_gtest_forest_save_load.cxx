@@ -0,0 +1,198 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_io.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/* In this test we save an adapted forest together with element data to a file.
+ * We load it once on all processes, where the partition of the saved forest must
+ * be restored, and once on a subset of the processes. In both cases the loaded
+ * forest must consist of the same elements and carry the same data. */
+
+class forest_save_load: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    filename = std::string ("t8_forest_save_load_") + t8_eclass_to_string[eclass] + ".t8f";
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    t8_forest_t forest_uniform = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 1, 0, sc_MPI_COMM_WORLD);
+    forest = t8_forest_new_adapt (forest_uniform, t8_test_save_load_adapt, 1, 0, NULL);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+    int mpirank;
+    int mpiret = sc_MPI_Barrier (sc_MPI_COMM_WORLD);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+    SC_CHECK_MPI (mpiret);
+    if (mpirank == 0) {
+      std::remove (filename.c_str ());
+    }
+  }
+
+  /* Refine some elements up to level 3. */
+  static int
+  t8_test_save_load_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                           t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                           const int num_elements, t8_element_t *elements[])
+  {
+    return ts->t8_element_level (elements[0]) < 3 && lelement_id % 3 == 0;
+  }
+
+  t8_eclass_t eclass;
+  std::string filename;
+  t8_forest_t forest;
+};
+
+/* Compute a checksum of the elements of a forest that does not depend on its partition. */
+static t8_gloidx_t
+t8_test_save_load_checksum (t8_forest_t forest)
+{
+  t8_gloidx_t local_sum = 0, global_sum;
+  t8_gloidx_t ielement = t8_forest_get_first_local_element_id (forest);
+
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    const t8_gloidx_t gtree = t8_forest_global_tree_id (forest, itree);
+    for (t8_locidx_t ielem = 0; ielem < t8_forest_get_tree_num_elements (forest, itree); ielem++, ielement++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielem);
+      const int level = ts->t8_element_level (element);
+      const t8_linearidx_t id = ts->t8_element_get_linear_id (element, level);
+      local_sum += (ielement % 97 + 1) * (gtree + 7 * level + 13 * (t8_gloidx_t) (id % 1009));
+    }
+  }
+  const int mpiret
+    = sc_MPI_Allreduce (&local_sum, &global_sum, 1, T8_MPI_GLOIDX, sc_MPI_SUM, t8_forest_get_mpicomm (forest));
+  SC_CHECK_MPI (mpiret);
+  return global_sum;
+}
+
+/* Load the forest and its data on comm and check that it matches the saved forest. */
+static t8_forest_t
+t8_test_save_load (const char *filename, const t8_eclass_t eclass, sc_MPI_Comm comm)
+{
+  t8_forest_t forest;
+  t8_forest_init (&forest);
+  t8_forest_set_cmesh (forest, t8_cmesh_new_hypercube (eclass, comm, 0, 0, 0), comm);
+  t8_forest_set_scheme (forest, t8_scheme_new_default_cxx ());
+  t8_forest_set_load (forest, filename);
+  t8_forest_commit (forest);
+
+  /* The saved data is the global element index */
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  std::vector<t8_gloidx_t> data (num_elements);
+  sc_array_t *data_array = sc_array_new_data (data.data (), sizeof (t8_gloidx_t), num_elements);
+  EXPECT_TRUE (t8_forest_load_data (forest, filename, data_array));
+  const t8_gloidx_t first_element = t8_forest_get_first_local_element_id (forest);
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+    EXPECT_EQ (data[ielement], first_element + ielement);
+  }
+  sc_array_destroy (data_array);
+  return forest;
+}
+
+/* Save a forest with its global element indices as data, load it on all processes and on
+ * the first half of the processes and compare the loaded forests with the saved one. */
+static void
+t8_test_save_load_check (t8_forest_t forest, const char *filename, const t8_eclass_t eclass)
+{
+  /* Save the forest with its global element indices as data */
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  std::vector<t8_gloidx_t> data (num_elements);
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+    data[ielement] = t8_forest_get_first_local_element_id (forest) + ielement;
+  }
+  sc_array_t *data_array = sc_array_new_data (data.data (), sizeof (t8_gloidx_t), num_elements);
+  ASSERT_TRUE (t8_forest_save (forest, filename, data_array));
+  sc_array_destroy (data_array);
+  const t8_gloidx_t checksum = t8_test_save_load_checksum (forest);
+
+  /* Load on all processes, the partition must be restored */
+  t8_forest_t forest_loaded = t8_test_save_load (filename, eclass, sc_MPI_COMM_WORLD);
+  EXPECT_TRUE (t8_forest_is_equal (forest, forest_loaded));
+  EXPECT_EQ (t8_forest_get_global_num_elements (forest_loaded), t8_forest_get_global_num_elements (forest));
+  EXPECT_EQ (t8_test_save_load_checksum (forest_loaded), checksum);
+  t8_forest_unref (&forest_loaded);
+
+  /* Load on the first half of the processes */
+  int mpirank, mpisize, mpiret;
+  sc_MPI_Comm subcomm;
+  mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  const int in_subcomm = mpirank < (mpisize + 1) / 2;
+  mpiret = sc_MPI_Comm_split (sc_MPI_COMM_WORLD, in_subcomm, mpirank, &subcomm);
+  SC_CHECK_MPI (mpiret);
+  if (in_subcomm) {
+    forest_loaded = t8_test_save_load (filename, eclass, subcomm);
+    EXPECT_EQ (t8_forest_get_global_num_elements (forest_loaded), t8_forest_get_global_num_elements (forest));
+    EXPECT_EQ (t8_test_save_load_checksum (forest_loaded), checksum);
+    t8_forest_unref (&forest_loaded);
+  }
+  mpiret = sc_MPI_Comm_free (&subcomm);
+  SC_CHECK_MPI (mpiret);
+}
+
+/* Remove every fourth element of each tree, but never all elements of a tree. */
+static int
+t8_test_save_load_remove (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                          t8_eclass_scheme_c *ts, const int is_family, const int num_elements,
+                          t8_element_t *elements[])
+{
+  return lelement_id % 4 == 1 ? -2 : 0;
+}
+
+TEST_P (forest_save_load, test_save_load)
+{
+  t8_test_save_load_check (forest, filename.c_str (), eclass);
+}
+
+TEST_P (forest_save_load, test_save_load_incomplete)
+{
+  if (eclass == T8_ECLASS_VERTEX) {
+    /* The trees of the vertex forest consist of a single element, which we cannot remove. */
+    GTEST_SKIP ();
+  }
+  /* Save and load a forest with incomplete trees */
+  t8_forest_ref (forest);
+  t8_forest_t forest_removed = t8_forest_new_adapt (forest, t8_test_save_load_remove, 0, 0, NULL);
+  ASSERT_LT (t8_forest_get_global_num_elements (forest_removed), t8_forest_get_global_num_elements (forest));
+  t8_test_save_load_check (forest_removed, filename.c_str (), eclass);
+  t8_forest_unref (&forest_removed);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_forest_save_load, forest_save_load, AllEclasses, print_eclass);
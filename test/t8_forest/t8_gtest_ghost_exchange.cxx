@@ -29,6 +29,7 @@
 #include <t8_cmesh.h>
 #include "test/t8_cmesh_generator/t8_cmesh_example_sets.hxx"
 #include <test/t8_gtest_macros.hxx>
+#include <vector>
 
 /* TODO: when this test works for all cmeshes remove if statement in test_cmesh_ghost_exchange_all () */
 
@@ -168,6 +169,88 @@ t8_test_ghost_exchange_data_int (t8_forest_t forest)
   sc_array_reset (&element_data);
 }
 
+/* Perform the same exchange as in t8_test_ghost_exchange_data_int, but
+ * with the split-phase interface. While the data is in flight, we
+ * modify the local entries, which must not affect the exchanged data.
+ */
+static void
+t8_test_ghost_exchange_data_split (t8_forest_t forest)
+{
+  sc_array_t element_data;
+
+  t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  t8_locidx_t num_ghosts = t8_forest_get_num_ghosts (forest);
+  sc_array_init_size (&element_data, sizeof (int), num_elements + num_ghosts);
+
+  for (t8_locidx_t ielem = 0; ielem < num_elements; ielem++) {
+    *(int *) t8_sc_array_index_locidx (&element_data, ielem) = 42;
+  }
+  /* Start the ghost data exchange */
+  t8_ghost_exchange_t exchange = t8_forest_ghost_exchange_begin (forest, &element_data);
+  /* Overwrite the local entries while communicating */
+  for (t8_locidx_t ielem = 0; ielem < num_elements; ielem++) {
+    *(int *) t8_sc_array_index_locidx (&element_data, ielem) = 0;
+  }
+  (void) t8_forest_ghost_exchange_test (exchange);
+  t8_forest_ghost_exchange_end (&exchange);
+  ASSERT_TRUE (exchange == NULL);
+
+  for (t8_locidx_t ielem = 0; ielem < num_ghosts; ielem++) {
+    int ghost_int = *(int *) t8_sc_array_index_locidx (&element_data, num_elements + ielem);
+    ASSERT_EQ (ghost_int, 42) << "Error when exchanging ghost data. Received wrong data.\n";
+  }
+  sc_array_reset (&element_data);
+}
+
+/* Exchange two fields in one call. The first field stores the linear id of
+ * each element in a separate array, the second field is an integer member
+ * of an array of structs and thus has a stride larger than its size.
+ */
+static void
+t8_test_ghost_exchange_fields (t8_forest_t forest)
+{
+  struct t8_test_exchange_struct
+  {
+    double unused;
+    int value;
+  };
+  t8_eclass_scheme_c *ts;
+  t8_locidx_t array_pos = 0;
+
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  const t8_locidx_t num_ghosts = t8_forest_get_num_ghosts (forest);
+  std::vector<t8_linearidx_t> ids (num_elements + num_ghosts);
+  std::vector<t8_test_exchange_struct> structs (num_elements + num_ghosts);
+
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    for (t8_locidx_t ielem = 0; ielem < t8_forest_get_tree_num_elements (forest, itree); ielem++, array_pos++) {
+      const t8_element_t *elem = t8_forest_get_element_in_tree (forest, itree, ielem);
+      ids[array_pos] = ts->t8_element_get_linear_id (elem, ts->t8_element_level (elem));
+      structs[array_pos].value = 42;
+    }
+  }
+
+  t8_ghost_exchange_field_t fields[2];
+  fields[0].data = ids.data ();
+  fields[0].stride = sizeof (t8_linearidx_t);
+  fields[0].elem_size = sizeof (t8_linearidx_t);
+  fields[1].data = &structs.data ()->value;
+  fields[1].stride = sizeof (t8_test_exchange_struct);
+  fields[1].elem_size = sizeof (int);
+  t8_forest_ghost_exchange_fields (forest, 2, fields);
+
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_ghost_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest, t8_forest_ghost_get_tree_class (forest, itree));
+    for (t8_locidx_t ielem = 0; ielem < t8_forest_ghost_tree_num_elements (forest, itree); ielem++, array_pos++) {
+      const t8_element_t *elem = t8_forest_ghost_get_element (forest, itree, ielem);
+      const t8_linearidx_t ghost_id = ts->t8_element_get_linear_id (elem, ts->t8_element_level (elem));
+      ASSERT_EQ (ids[array_pos], ghost_id) << "Error when exchanging ghost data. Received wrong element id.\n";
+      ASSERT_EQ (structs[array_pos].value, 42) << "Error when exchanging ghost data. Received wrong data.\n";
+    }
+  }
+}
+
 TEST_P (forest_ghost_exchange, test_ghost_exchange)
 {
 
@@ -185,6 +268,11 @@ TEST_P (forest_ghost_exchange, test_ghost_exchange)
     /* exchange ghost data */
     t8_test_ghost_exchange_data_int (forest);
     t8_test_ghost_exchange_data_id (forest);
+    /* Exchange again, reusing the exchange plan and its buffers */
+    t8_test_ghost_exchange_data_int (forest);
+    t8_test_ghost_exchange_data_id (forest);
+    t8_test_ghost_exchange_data_split (forest);
+    t8_test_ghost_exchange_fields (forest);
     /* Adapt the forest and exchange data again */
     int maxlevel = level + 2;
     t8_forest_t forest_adapt = t8_forest_new_adapt (forest, t8_test_exchange_adapt, 1, 1, &maxlevel);
@@ -0,0 +1,175 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+#include <vector>
+
+/* In this test we compute the leaf face neighbors of forests without assuming
+ * that they are balanced.
+ * For a balanced forest, the result must match the one of the balanced version.
+ * For a forest that is not balanced, we check that the neighbor relation is symmetric. */
+
+/* Recursively refine the first child of each family up to a fixed level,
+ * such that the forest is not balanced. */
+static int
+t8_test_unbalanced_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                          t8_eclass_scheme_c *ts, const int is_family, const int num_elements,
+                          t8_element_t *elements[])
+{
+  const int level = ts->t8_element_level (elements[0]);
+  return level < 5 && ts->t8_element_child_id (elements[0]) == 0;
+}
+
+class forest_leaf_face_neighbors_unbalanced: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    scheme = t8_scheme_new_default_cxx ();
+    cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    t8_forest_t forest_uniform = t8_forest_new_uniform (cmesh, scheme, 1, 0, sc_MPI_COMM_WORLD);
+
+    /* Build an unbalanced forest and a balanced forest from it, both with ghosts */
+    t8_forest_init (&forest_unbalanced);
+    t8_forest_set_adapt (forest_unbalanced, forest_uniform, t8_test_unbalanced_adapt, 1);
+    t8_forest_set_partition (forest_unbalanced, NULL, 0);
+    t8_forest_set_ghost (forest_unbalanced, 1, T8_GHOST_FACES);
+    t8_forest_commit (forest_unbalanced);
+
+    t8_forest_ref (forest_unbalanced);
+    t8_forest_init (&forest_balanced);
+    t8_forest_set_balance (forest_balanced, forest_unbalanced, 0);
+    t8_forest_set_partition (forest_balanced, NULL, 0);
+    t8_forest_set_ghost (forest_balanced, 1, T8_GHOST_FACES);
+    t8_forest_commit (forest_balanced);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest_unbalanced);
+    t8_forest_unref (&forest_balanced);
+  }
+  t8_eclass_t eclass;
+  t8_scheme_cxx_t *scheme;
+  t8_cmesh_t cmesh;
+  t8_forest_t forest_unbalanced;
+  t8_forest_t forest_balanced;
+};
+
+/* Compute the leaf face neighbors of an element and return their indices and dual faces. */
+static void
+t8_test_leaf_face_neighbors (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *element, int face,
+                             int forest_is_balanced, std::vector<t8_locidx_t> &indices, std::vector<int> &faces)
+{
+  t8_element_t **neighbor_leaves;
+  int *dual_faces;
+  int num_neighbors;
+  t8_locidx_t *element_indices;
+  t8_eclass_scheme_c *neigh_scheme;
+
+  t8_forest_leaf_face_neighbors (forest, ltreeid, element, &neighbor_leaves, face, &dual_faces, &num_neighbors,
+                                 &element_indices, &neigh_scheme, forest_is_balanced);
+  indices.assign (element_indices, element_indices + num_neighbors);
+  faces.assign (dual_faces, dual_faces + num_neighbors);
+  if (num_neighbors > 0) {
+    neigh_scheme->t8_element_destroy (num_neighbors, neighbor_leaves);
+    T8_FREE (neighbor_leaves);
+    T8_FREE (element_indices);
+    T8_FREE (dual_faces);
+  }
+}
+
+TEST_P (forest_leaf_face_neighbors_unbalanced, matches_balanced_version)
+{
+  std::vector<t8_locidx_t> indices_balanced, indices_unbalanced;
+  std::vector<int> faces_balanced, faces_unbalanced;
+
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest_balanced);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    t8_eclass_scheme_c *ts
+      = t8_forest_get_eclass_scheme (forest_balanced, t8_forest_get_tree_class (forest_balanced, itree));
+    const t8_locidx_t num_elements_in_tree = t8_forest_get_tree_num_elements (forest_balanced, itree);
+    for (t8_locidx_t ielement = 0; ielement < num_elements_in_tree; ielement++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest_balanced, itree, ielement);
+      const int num_faces = ts->t8_element_num_faces (element);
+      for (int iface = 0; iface < num_faces; iface++) {
+        t8_test_leaf_face_neighbors (forest_balanced, itree, element, iface, 1, indices_balanced, faces_balanced);
+        t8_test_leaf_face_neighbors (forest_balanced, itree, element, iface, 0, indices_unbalanced, faces_unbalanced);
+        EXPECT_EQ (indices_balanced, indices_unbalanced);
+        EXPECT_EQ (faces_balanced, faces_unbalanced);
+      }
+    }
+  }
+}
+
+TEST_P (forest_leaf_face_neighbors_unbalanced, symmetric_neighbors)
+{
+  std::vector<t8_locidx_t> indices, neigh_indices;
+  std::vector<int> faces, neigh_faces;
+
+  const t8_locidx_t num_local_elements = t8_forest_get_local_num_elements (forest_unbalanced);
+  t8_locidx_t lelement_id = 0;
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest_unbalanced);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    t8_eclass_scheme_c *ts
+      = t8_forest_get_eclass_scheme (forest_unbalanced, t8_forest_get_tree_class (forest_unbalanced, itree));
+    const t8_locidx_t num_elements_in_tree = t8_forest_get_tree_num_elements (forest_unbalanced, itree);
+    for (t8_locidx_t ielement = 0; ielement < num_elements_in_tree; ielement++, lelement_id++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest_unbalanced, itree, ielement);
+      const int num_faces = ts->t8_element_num_faces (element);
+      for (int iface = 0; iface < num_faces; iface++) {
+        t8_test_leaf_face_neighbors (forest_unbalanced, itree, element, iface, 0, indices, faces);
+        /* Each local neighbor must have the element as a neighbor across its dual face */
+        for (size_t ineigh = 0; ineigh < indices.size (); ineigh++) {
+          if (indices[ineigh] >= num_local_elements) {
+            continue;
+          }
+          t8_locidx_t neigh_tree;
+          const t8_element_t *neighbor = t8_forest_get_element (forest_unbalanced, indices[ineigh], &neigh_tree);
+          t8_test_leaf_face_neighbors (forest_unbalanced, neigh_tree, neighbor, faces[ineigh], 0, neigh_indices,
+                                       neigh_faces);
+          bool found = false;
+          for (size_t jneigh = 0; jneigh < neigh_indices.size (); jneigh++) {
+            if (neigh_indices[jneigh] == lelement_id) {
+              found = true;
+              EXPECT_EQ (neigh_faces[jneigh], iface);
+            }
+          }
+          EXPECT_TRUE (found) << "Element " << lelement_id << " is not a neighbor of its neighbor "
+                              << indices[ineigh];
+        }
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_leaf_face_neighbors_unbalanced, forest_leaf_face_neighbors_unbalanced,
+                          testing::Values (T8_ECLASS_LINE, T8_ECLASS_QUAD, T8_ECLASS_TRIANGLE, T8_ECLASS_HEX,
+                                           T8_ECLASS_TET, T8_ECLASS_PRISM),
+                          print_eclass);
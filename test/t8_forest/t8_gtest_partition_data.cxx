@@ -34,6 +34,8 @@
 #include <t8_forest/t8_forest_general.h>
 #include <t8_forest/t8_forest_partition.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <numeric>
 #include <type_traits>
@@ -251,3 +253,161 @@ TEST (partition_data, test_partition_data)
   t8_forest_unref (&initial_forest);
   t8_forest_unref (&partitioned_forest);
 }
+
+/**
+ * \brief An examplary partition weight function. Each element is weighted with its refinement level
+ * plus one, such that the refined first tree is more costly than the other trees.
+ */
+static double
+t8_test_partition_data_weight (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t* element,
+                               t8_locidx_t lelement_id)
+{
+  t8_eclass_scheme_c* ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, ltreeid));
+  return 1 + ts->t8_element_level (element);
+}
+
+/**
+ * \brief Check that the local weight of a partitioned forest deviates from the average weight
+ * by at most the maximum element weight.
+ */
+static void
+t8_test_partition_data_check_weights (t8_forest_t forest, const double max_weight)
+{
+  double local_weight = 0;
+  double global_weight;
+  int mpisize;
+  t8_locidx_t ielement = 0;
+
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    for (t8_locidx_t ielem = 0; ielem < t8_forest_get_tree_num_elements (forest, itree); ielem++, ielement++) {
+      const t8_element_t* element = t8_forest_get_element_in_tree (forest, itree, ielem);
+      local_weight += t8_test_partition_data_weight (forest, itree, element, ielement);
+    }
+  }
+  int mpiret = sc_MPI_Allreduce (&local_weight, &global_weight, 1, sc_MPI_DOUBLE, sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  EXPECT_LE (std::abs (local_weight - global_weight / mpisize), max_weight + 1e-10 * global_weight);
+}
+
+/**
+ * \brief Construct a new TEST object for weighted partitioning in combination with t8_forest_partition_data.
+ * The adapted forest of \see test_partition_data is partitioned once with a weight function and once with
+ * the equivalent weight array. Both partitions must agree, balance the weights and the element data must
+ * follow the weighted partition.
+ */
+TEST (partition_data, test_partition_data_weighted)
+{
+  t8_cmesh_t cmesh = t8_cmesh_new_hypercube (T8_ECLASS_TRIANGLE, sc_MPI_COMM_WORLD, 0, 0, 0);
+  t8_scheme_cxx_t* scheme = t8_scheme_new_default_cxx ();
+  t8_forest_t base_forest = t8_forest_new_uniform (cmesh, scheme, 1, 0, sc_MPI_COMM_WORLD);
+  t8_forest_t initial_forest = t8_forest_new_adapt (base_forest, t8_test_partition_data_adapt, 1, 0, NULL);
+
+  /* Compute the weights of the initial forest explicitly for the array version. */
+  std::vector<double> weights (t8_forest_get_local_num_elements (initial_forest));
+  t8_locidx_t ielement = 0;
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (initial_forest); itree++) {
+    for (t8_locidx_t ielem = 0; ielem < t8_forest_get_tree_num_elements (initial_forest, itree); ielem++, ielement++) {
+      weights[ielement] = t8_test_partition_data_weight (
+        initial_forest, itree, t8_forest_get_element_in_tree (initial_forest, itree, ielem), ielement);
+    }
+  }
+
+  /* Partition with the weight function. */
+  t8_forest_ref (initial_forest);
+  t8_forest_t partitioned_forest;
+  t8_forest_init (&partitioned_forest);
+  t8_forest_set_partition (partitioned_forest, initial_forest, 0);
+  t8_forest_set_partition_weights (partitioned_forest, t8_test_partition_data_weight, NULL);
+  t8_forest_commit (partitioned_forest);
+
+  /* Partition with the weight array. */
+  t8_forest_ref (initial_forest);
+  t8_forest_t partitioned_forest_array;
+  t8_forest_init (&partitioned_forest_array);
+  t8_forest_set_partition (partitioned_forest_array, initial_forest, 0);
+  t8_forest_set_partition_weights (partitioned_forest_array, NULL, weights.data ());
+  t8_forest_commit (partitioned_forest_array);
+
+  /* Both partitions must be identical and balance the weights. */
+  EXPECT_TRUE (t8_forest_is_equal (partitioned_forest, partitioned_forest_array));
+  const double local_max_weight = weights.empty () ? 0 : *std::max_element (weights.begin (), weights.end ());
+  double max_weight;
+  const int mpiret
+    = sc_MPI_Allreduce (&local_max_weight, &max_weight, 1, sc_MPI_DOUBLE, sc_MPI_MAX, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  t8_test_partition_data_check_weights (partitioned_forest, max_weight);
+
+  /* The element data must follow the weighted partition. */
+  TestPartitionData<int32_t> (initial_forest, partitioned_forest);
+  TestPartitionData<double> (initial_forest, partitioned_forest);
+  TestPartitionData<t8_test_partition_data_t> (initial_forest, partitioned_forest);
+
+  t8_forest_unref (&initial_forest);
+  t8_forest_unref (&partitioned_forest);
+  t8_forest_unref (&partitioned_forest_array);
+}
+
+/**
+ * \brief Construct a new TEST object for the t8_forest_partition_data_variable functionality.
+ * Each element carries between zero and three entries, depending on its global id. The entries
+ * encode the global element id and their position, such that the packed data and the sizes can
+ * be checked after the partitioning.
+ */
+TEST (partition_data, test_partition_data_variable)
+{
+  t8_cmesh_t cmesh = t8_cmesh_new_hypercube (T8_ECLASS_TRIANGLE, sc_MPI_COMM_WORLD, 0, 0, 0);
+  t8_scheme_cxx_t* scheme = t8_scheme_new_default_cxx ();
+  t8_forest_t base_forest = t8_forest_new_uniform (cmesh, scheme, 1, 0, sc_MPI_COMM_WORLD);
+  t8_forest_t initial_forest = t8_forest_new_adapt (base_forest, t8_test_partition_data_adapt, 1, 0, NULL);
+
+  t8_forest_ref (initial_forest);
+  t8_forest_t partitioned_forest;
+  t8_forest_init (&partitioned_forest);
+  t8_forest_set_partition (partitioned_forest, initial_forest, 0);
+  t8_forest_commit (partitioned_forest);
+
+  /* Fill the sizes and the packed data of the initial forest. */
+  const t8_locidx_t in_num_elements = t8_forest_get_local_num_elements (initial_forest);
+  const t8_gloidx_t in_first_id = t8_forest_get_first_local_element_id (initial_forest);
+  std::vector<size_t> in_sizes (in_num_elements);
+  std::vector<t8_gloidx_t> in_values;
+  for (t8_locidx_t ielement = 0; ielement < in_num_elements; ielement++) {
+    const t8_gloidx_t gid = in_first_id + ielement;
+    in_sizes[ielement] = gid % 4;
+    for (size_t ientry = 0; ientry < in_sizes[ielement]; ientry++) {
+      in_values.push_back (4 * gid + ientry);
+    }
+  }
+  sc_array_t* sizes_in = sc_array_new_data (static_cast<void*> (in_sizes.data ()), sizeof (size_t), in_sizes.size ());
+  sc_array_t* data_in
+    = sc_array_new_data (static_cast<void*> (in_values.data ()), sizeof (t8_gloidx_t), in_values.size ());
+
+  const t8_locidx_t out_num_elements = t8_forest_get_local_num_elements (partitioned_forest);
+  sc_array_t* sizes_out = sc_array_new_count (sizeof (size_t), out_num_elements);
+  sc_array_t* data_out = sc_array_new (sizeof (t8_gloidx_t));
+
+  t8_forest_partition_data_variable (initial_forest, partitioned_forest, sizes_in, data_in, sizes_out, data_out);
+
+  /* Check the sizes and the packed data of the partitioned forest. */
+  const t8_gloidx_t out_first_id = t8_forest_get_first_local_element_id (partitioned_forest);
+  size_t entry = 0;
+  for (t8_locidx_t ielement = 0; ielement < out_num_elements; ielement++) {
+    const t8_gloidx_t gid = out_first_id + ielement;
+    const size_t size = *(size_t*) sc_array_index (sizes_out, ielement);
+    ASSERT_EQ (size, (size_t) (gid % 4));
+    for (size_t ientry = 0; ientry < size; ientry++, entry++) {
+      ASSERT_LT (entry, data_out->elem_count);
+      EXPECT_EQ (*(t8_gloidx_t*) sc_array_index (data_out, entry), (t8_gloidx_t) (4 * gid + ientry));
+    }
+  }
+  EXPECT_EQ (entry, data_out->elem_count);
+
+  sc_array_destroy (sizes_in);
+  sc_array_destroy (data_in);
+  sc_array_destroy (sizes_out);
+  sc_array_destroy (data_out);
+  t8_forest_unref (&initial_forest);
+  t8_forest_unref (&partitioned_forest);
+}
@@ -0,0 +1,141 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_schemes/t8_default/t8_default_traits.hxx>
+#include <test/t8_gtest_custom_assertion.hxx>
+#include <test/t8_gtest_macros.hxx>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* In this test we check that the scheme traits, that are used by templated forest
+ * algorithms, compute the same results as the virtual functions of the scheme. */
+
+class default_traits: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    scheme = t8_scheme_new_default_cxx ();
+    ts = scheme->eclass_schemes[eclass];
+    ts->t8_element_new (1, &element);
+    ts->t8_element_new (1, &parent);
+    ts->t8_element_new (1, &parent_traits);
+  }
+  void
+  TearDown () override
+  {
+    ts->t8_element_destroy (1, &element);
+    ts->t8_element_destroy (1, &parent);
+    ts->t8_element_destroy (1, &parent_traits);
+    t8_scheme_cxx_unref (&scheme);
+  }
+
+  /* Compare the traits with the virtual functions for all elements of a uniform level. */
+  template <class Traits>
+  void
+  check_traits (const Traits &traits)
+  {
+    const int level = eclass == T8_ECLASS_VERTEX ? 1 : 3;
+    const t8_gloidx_t num_elements = ts->t8_element_count_leaves_from_root (level);
+    for (t8_gloidx_t ielem = 0; ielem < num_elements; ielem++) {
+      ts->t8_element_set_linear_id (element, level, ielem);
+      EXPECT_EQ (traits.t8_element_level (element), ts->t8_element_level (element));
+      EXPECT_EQ (traits.t8_element_shape (element), ts->t8_element_shape (element));
+      EXPECT_EQ (traits.t8_element_num_siblings (element), ts->t8_element_num_siblings (element));
+      EXPECT_EQ (traits.t8_element_child_id (element), ts->t8_element_child_id (element));
+      for (int ilevel = 0; ilevel <= level; ilevel++) {
+        EXPECT_EQ (traits.t8_element_ancestor_id (element, ilevel), ts->t8_element_ancestor_id (element, ilevel));
+        EXPECT_EQ (traits.t8_element_get_linear_id (element, ilevel), ts->t8_element_get_linear_id (element, ilevel));
+      }
+      ts->t8_element_parent (element, parent);
+      traits.t8_element_parent (element, parent_traits);
+      EXPECT_ELEM_EQ (ts, parent, parent_traits);
+      EXPECT_TRUE (traits.t8_element_equal (parent, parent_traits));
+
+      const int num_children = traits.t8_element_num_children (element);
+      ASSERT_EQ (num_children, ts->t8_element_num_children (element));
+      std::vector<t8_element_t *> children (num_children);
+      std::vector<t8_element_t *> children_traits (num_children);
+      ts->t8_element_new (num_children, children.data ());
+      ts->t8_element_new (num_children, children_traits.data ());
+      ts->t8_element_children (element, num_children, children.data ());
+      traits.t8_element_children (element, num_children, children_traits.data ());
+      for (int ichild = 0; ichild < num_children; ichild++) {
+        EXPECT_ELEM_EQ (ts, children[ichild], children_traits[ichild]);
+      }
+      EXPECT_TRUE (traits.t8_element_is_family (children_traits.data ()));
+      if (num_children > 1) {
+        /* Swapping the first and the last child destroys the family. */
+        std::swap (children_traits[0], children_traits[num_children - 1]);
+        EXPECT_EQ (traits.t8_element_is_family (children_traits.data ()),
+                   ts->t8_element_is_family (children_traits.data ()));
+        std::swap (children_traits[0], children_traits[num_children - 1]);
+      }
+      ts->t8_element_destroy (num_children, children.data ());
+      ts->t8_element_destroy (num_children, children_traits.data ());
+    }
+  }
+
+  t8_eclass_t eclass;
+  t8_scheme_cxx *scheme;
+  t8_eclass_scheme_c *ts;
+  t8_element_t *element;
+  t8_element_t *parent;
+  t8_element_t *parent_traits;
+};
+
+TEST_P (default_traits, compare_with_scheme)
+{
+  t8_scheme_traits_dispatch (ts, [&] (const auto &traits) { check_traits (traits); });
+}
+
+TEST_P (default_traits, compare_virtual_with_scheme)
+{
+  check_traits (t8_scheme_traits_virtual (ts));
+}
+
+/* A user scheme that derives from the default quad scheme. It may override element functions,
+ * so it must not be dispatched to the traits of the default quad scheme. */
+class t8_test_derived_quad_scheme_c: public t8_default_scheme_quad_c {
+};
+
+TEST (default_traits_dispatch, derived_scheme_is_virtual)
+{
+  t8_default_scheme_quad_c quad_scheme;
+  t8_test_derived_quad_scheme_c derived_scheme;
+
+  const bool quad_is_specialized = t8_scheme_traits_dispatch (&quad_scheme, [] (const auto &traits) {
+    return std::is_same<std::decay_t<decltype (traits)>, t8_scheme_traits<T8_ECLASS_QUAD>>::value;
+  });
+  EXPECT_TRUE (quad_is_specialized);
+  const bool derived_is_virtual = t8_scheme_traits_dispatch (&derived_scheme, [] (const auto &traits) {
+    return std::is_same<std::decay_t<decltype (traits)>, t8_scheme_traits_virtual>::value;
+  });
+  EXPECT_TRUE (derived_is_virtual);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_default_traits, default_traits, AllEclasses, print_eclass);
@@ -0,0 +1,142 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_data/t8_containers.h>
+#include <test/t8_gtest_custom_assertion.hxx>
+#include <test/t8_gtest_macros.hxx>
+#include <vector>
+
+/* In this test we fill an element array with all elements of a uniform refinement
+ * and check that the element operations on ranges of this array compute the same
+ * results as the operations on single elements. */
+
+class element_array_ops: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    scheme = t8_scheme_new_default_cxx ();
+    ts = scheme->eclass_schemes[eclass];
+    level = eclass == T8_ECLASS_VERTEX ? 1 : 3;
+    num_elements = ts->t8_element_count_leaves_from_root (level);
+    t8_element_array_init_size (&elements, ts, num_elements);
+    for (size_t ielem = 0; ielem < num_elements; ielem++) {
+      t8_element_t *element = t8_element_array_index_locidx_mutable (&elements, (t8_locidx_t) ielem);
+      ts->t8_element_set_linear_id (element, level, ielem);
+    }
+    /* We only work on a range of the array to test the offsets. */
+    first = num_elements / 3;
+    count = num_elements - first;
+  }
+  void
+  TearDown () override
+  {
+    t8_element_array_reset (&elements);
+    t8_scheme_cxx_unref (&scheme);
+  }
+  const t8_element_t *
+  range_element (const size_t ielem)
+  {
+    return t8_element_array_index_locidx (&elements, (t8_locidx_t) (first + ielem));
+  }
+  t8_eclass_t eclass;
+  t8_scheme_cxx *scheme;
+  t8_eclass_scheme_c *ts;
+  t8_element_array_t elements;
+  size_t num_elements;
+  size_t first;
+  size_t count;
+  int level;
+};
+
+TEST_P (element_array_ops, levels_and_child_ids)
+{
+  std::vector<int> levels (count);
+  std::vector<int> child_ids (count);
+
+  ts->t8_element_levels_of_array (&elements, first, count, levels.data ());
+  ts->t8_element_child_ids_of_array (&elements, first, count, child_ids.data ());
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    EXPECT_EQ (levels[ielem], ts->t8_element_level (range_element (ielem)));
+    EXPECT_EQ (child_ids[ielem], ts->t8_element_child_id (range_element (ielem)));
+  }
+}
+
+TEST_P (element_array_ops, linear_ids)
+{
+  std::vector<t8_linearidx_t> ids (count);
+
+  for (int id_level = 0; id_level <= level + 1; id_level++) {
+    ts->t8_element_linear_ids_of_array (&elements, first, count, id_level, ids.data ());
+    for (size_t ielem = 0; ielem < count; ielem++) {
+      EXPECT_EQ (ids[ielem], ts->t8_element_get_linear_id (range_element (ielem), id_level));
+    }
+  }
+}
+
+TEST_P (element_array_ops, parents)
+{
+  t8_element_array_t parents;
+  t8_element_t *parent;
+
+  t8_element_array_init_size (&parents, ts, count);
+  ts->t8_element_new (1, &parent);
+  ts->t8_element_parents_of_array (&elements, first, count, &parents);
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    ts->t8_element_parent (range_element (ielem), parent);
+    EXPECT_ELEM_EQ (ts, parent, t8_element_array_index_locidx (&parents, (t8_locidx_t) ielem));
+  }
+  ts->t8_element_destroy (1, &parent);
+  t8_element_array_reset (&parents);
+}
+
+TEST_P (element_array_ops, children)
+{
+  t8_element_array_t children;
+
+  t8_element_array_init (&children, ts);
+  /* The children are appended to the array, so we start with a non-empty one. */
+  ts->t8_element_root (t8_element_array_push (&children));
+  ts->t8_element_children_of_array (&elements, first, count, &children);
+
+  size_t ichild_array = 1;
+  for (size_t ielem = 0; ielem < count; ielem++) {
+    const int num_children = ts->t8_element_num_children (range_element (ielem));
+    std::vector<t8_element_t *> child_elements (num_children);
+    ts->t8_element_new (num_children, child_elements.data ());
+    ts->t8_element_children (range_element (ielem), num_children, child_elements.data ());
+    for (int ichild = 0; ichild < num_children; ichild++, ichild_array++) {
+      ASSERT_LT (ichild_array, t8_element_array_get_count (&children));
+      EXPECT_ELEM_EQ (ts, child_elements[ichild],
+                      t8_element_array_index_locidx (&children, (t8_locidx_t) ichild_array));
+    }
+    ts->t8_element_destroy (num_children, child_elements.data ());
+  }
+  EXPECT_EQ (ichild_array, t8_element_array_get_count (&children));
+  t8_element_array_reset (&children);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_element_array_ops, element_array_ops, AllEclasses, print_eclass);
@@ -0,0 +1,117 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <gtest/gtest.h>
+#include <random>
+#include <t8_schemes/t8_default/t8_default_common/t8_default_morton.hxx>
+
+/* In this test we check that all implementations of the Morton encoding that
+ * the CPU supports agree with the reference implementation and with p4est. */
+
+#ifdef T8_ENABLE_LESS_TESTS
+#define T8_MORTON_TEST_SAMPLES 10000
+#else
+#define T8_MORTON_TEST_SAMPLES 100000
+#endif
+
+class morton_kernels: public testing::TestWithParam<t8_morton_kernel_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    kernel = GetParam ();
+    if (!t8_morton_kernel_is_supported (kernel)) {
+      GTEST_SKIP ();
+    }
+    kernels = t8_morton_get_kernels (kernel);
+    reference = t8_morton_get_kernels (T8_MORTON_KERNEL_LOOP);
+  }
+  t8_morton_kernel_t kernel;
+  const t8_morton_kernels_t *kernels;
+  const t8_morton_kernels_t *reference;
+  std::mt19937_64 random_engine { 5489u };
+};
+
+TEST_P (morton_kernels, encode_decode_2d)
+{
+  for (int isample = 0; isample < T8_MORTON_TEST_SAMPLES; isample++) {
+    const uint32_t x = (uint32_t) random_engine ();
+    const uint32_t y = (uint32_t) random_engine ();
+    const uint64_t id = kernels->encode_2d (x, y);
+    ASSERT_EQ (id, reference->encode_2d (x, y));
+    uint32_t dx, dy;
+    kernels->decode_2d (id, &dx, &dy);
+    ASSERT_EQ (dx, x);
+    ASSERT_EQ (dy, y);
+  }
+}
+
+TEST_P (morton_kernels, encode_decode_3d)
+{
+  const uint32_t mask = (1u << 21) - 1;
+  for (int isample = 0; isample < T8_MORTON_TEST_SAMPLES; isample++) {
+    const uint32_t x = (uint32_t) random_engine () & mask;
+    const uint32_t y = (uint32_t) random_engine () & mask;
+    const uint32_t z = (uint32_t) random_engine () & mask;
+    const uint64_t id = kernels->encode_3d (x, y, z);
+    ASSERT_EQ (id, reference->encode_3d (x, y, z));
+    uint32_t dx, dy, dz;
+    kernels->decode_3d (id, &dx, &dy, &dz);
+    ASSERT_EQ (dx, x);
+    ASSERT_EQ (dy, y);
+    ASSERT_EQ (dz, z);
+  }
+}
+
+/* The linear ids of the default schemes must be the same as the ones of p4est. */
+TEST_P (morton_kernels, linear_id_compare_with_p4est)
+{
+  p4est_quadrant_t quad, quad_p4est;
+  p8est_quadrant_t hex, hex_p8est;
+
+  for (int isample = 0; isample < T8_MORTON_TEST_SAMPLES; isample++) {
+    const int level = (int) (random_engine () % (P4EST_QMAXLEVEL + 1));
+    const uint64_t id = random_engine () & (((uint64_t) 1 << P4EST_DIM * level) - 1);
+    t8_morton_quad_set_linear_id (kernels, &quad, level, id);
+    p4est_quadrant_set_morton (&quad_p4est, level, id);
+    ASSERT_TRUE (p4est_quadrant_is_equal (&quad, &quad_p4est));
+    for (int id_level = 0; id_level <= level; id_level++) {
+      ASSERT_EQ (t8_morton_quad_linear_id (kernels, &quad, id_level), p4est_quadrant_linear_id (&quad, id_level));
+    }
+  }
+  for (int isample = 0; isample < T8_MORTON_TEST_SAMPLES; isample++) {
+    const int level = (int) (random_engine () % (P8EST_OLD_QMAXLEVEL + 1));
+    const uint64_t id = random_engine () & (((uint64_t) 1 << P8EST_DIM * level) - 1);
+    t8_morton_hex_set_linear_id (kernels, &hex, level, id);
+    p8est_quadrant_set_morton (&hex_p8est, level, id);
+    ASSERT_TRUE (p8est_quadrant_is_equal (&hex, &hex_p8est));
+    for (int id_level = 0; id_level <= level; id_level++) {
+      ASSERT_EQ (t8_morton_hex_linear_id (kernels, &hex, id_level), p8est_quadrant_linear_id (&hex, id_level));
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_morton, morton_kernels,
+                          testing::Values (T8_MORTON_KERNEL_LOOP, T8_MORTON_KERNEL_TABLE, T8_MORTON_KERNEL_BMI2),
+                          [] (const testing::TestParamInfo<t8_morton_kernel_t> &info) {
+                            return std::string (t8_morton_kernel_name (info.param));
+                          });
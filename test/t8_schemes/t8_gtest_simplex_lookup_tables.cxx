@@ -0,0 +1,144 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** t8_gtest_simplex_lookup_tables.cxx
+*
+* Test the multi-level look-up tables for triangles and tetrahedra.
+*/
+
+#include <gtest/gtest.h>
+#include <t8_schemes/t8_default/t8_default_tri/t8_dtri_bits.h>
+#include <t8_schemes/t8_default/t8_default_tri/t8_dtri_connectivity.h>
+#include <t8_schemes/t8_default/t8_default_tet/t8_dtet_bits.h>
+#include <t8_schemes/t8_default/t8_default_tet/t8_dtet_connectivity.h>
+
+/**
+ * Ascend the lookup_levels levels of every row of the multi-level table type_cids_to_Ilocs_type
+ * with the single-level tables and compare the local indices and the type to the table entry.
+ */
+static void
+t8_test_ascend_table (const int dim, const int num_types, const int lookup_levels, const int *type_cids_to_Ilocs_type,
+                      const int *type_cid_to_Iloc, const int *cid_type_to_parenttype)
+{
+  const int num_children = 1 << dim;
+  const int lookup_bits = dim * lookup_levels;
+  for (int start_type = 0; start_type < num_types; start_type++) {
+    for (int cids = 0; cids < 1 << lookup_bits; cids++) {
+      int type = start_type;
+      int local_indices = 0;
+      /* The bits of the level l - ilevel are bit ilevel of each coordinate */
+      for (int ilevel = 0; ilevel < lookup_levels; ilevel++) {
+        int cid = 0;
+        for (int icoord = 0; icoord < dim; icoord++) {
+          cid |= ((cids >> (icoord * lookup_levels + ilevel)) & 1) << icoord;
+        }
+        local_indices |= type_cid_to_Iloc[type * num_children + cid] << (dim * ilevel);
+        type = cid_type_to_parenttype[cid * num_types + type];
+      }
+      EXPECT_EQ (type_cids_to_Ilocs_type[start_type * (1 << lookup_bits) + cids], local_indices | type << lookup_bits)
+        << "type " << start_type << " cube-ids " << cids;
+    }
+  }
+}
+
+/**
+ * Descend the lookup_levels levels of every row of the multi-level table parenttype_Ilocs_to_cids_type
+ * with the single-level tables and compare the cube-ids and the type to the table entry.
+ */
+static void
+t8_test_descend_table (const int dim, const int num_types, const int lookup_levels,
+                       const int *parenttype_Ilocs_to_cids_type, const int *parenttype_Iloc_to_cid,
+                       const int *parenttype_Iloc_to_type)
+{
+  const int num_children = 1 << dim;
+  const int lookup_bits = dim * lookup_levels;
+  for (int parenttype = 0; parenttype < num_types; parenttype++) {
+    for (int local_indices = 0; local_indices < 1 << lookup_bits; local_indices++) {
+      int type = parenttype;
+      int cids = 0;
+      /* The local index of level l + ilevel + 1 is stored in the digit lookup_levels - ilevel - 1 */
+      for (int ilevel = 0; ilevel < lookup_levels; ilevel++) {
+        const int bit = lookup_levels - ilevel - 1;
+        const int local_index = (local_indices >> (dim * bit)) & (num_children - 1);
+        const int cid = parenttype_Iloc_to_cid[type * num_children + local_index];
+        type = parenttype_Iloc_to_type[type * num_children + local_index];
+        for (int icoord = 0; icoord < dim; icoord++) {
+          cids |= ((cid >> icoord) & 1) << (icoord * lookup_levels + bit);
+        }
+      }
+      EXPECT_EQ (parenttype_Ilocs_to_cids_type[parenttype * (1 << lookup_bits) + local_indices],
+                 cids | type << lookup_bits)
+        << "parenttype " << parenttype << " local indices " << local_indices;
+    }
+  }
+}
+
+TEST (simplex_lookup_tables, triangle_tables)
+{
+  t8_test_ascend_table (T8_DTRI_DIM, T8_DTRI_NUM_TYPES, T8_DTRI_LOOKUP_LEVELS, &t8_dtri_type_cids_to_Ilocs_type[0][0],
+                        &t8_dtri_type_cid_to_Iloc[0][0], &t8_dtri_cid_type_to_parenttype[0][0]);
+  t8_test_descend_table (T8_DTRI_DIM, T8_DTRI_NUM_TYPES, T8_DTRI_LOOKUP_LEVELS,
+                         &t8_dtri_parenttype_Ilocs_to_cids_type[0][0], &t8_dtri_parenttype_Iloc_to_cid[0][0],
+                         &t8_dtri_parenttype_Iloc_to_type[0][0]);
+}
+
+TEST (simplex_lookup_tables, tetrahedron_tables)
+{
+  t8_test_ascend_table (T8_DTET_DIM, T8_DTET_NUM_TYPES, T8_DTET_LOOKUP_LEVELS, &t8_dtet_type_cids_to_Ilocs_type[0][0],
+                        &t8_dtet_type_cid_to_Iloc[0][0], &t8_dtet_cid_type_to_parenttype[0][0]);
+  t8_test_descend_table (T8_DTET_DIM, T8_DTET_NUM_TYPES, T8_DTET_LOOKUP_LEVELS,
+                         &t8_dtet_parenttype_Ilocs_to_cids_type[0][0], &t8_dtet_parenttype_Iloc_to_cid[0][0],
+                         &t8_dtet_parenttype_Iloc_to_type[0][0]);
+}
+
+/**
+ * Check that the linear id of a tetrahedron in the subtree of one of its ancestors consists of the last digits
+ * of its linear id, that the type of the ancestor is returned and that init_linear_id_with_level is its inverse.
+ */
+TEST (simplex_lookup_tables, tetrahedron_linear_id_with_level)
+{
+#ifdef T8_ENABLE_LESS_TESTS
+  const int level = 5;
+#else
+  const int level = 7;
+#endif
+  const t8_linearidx_t num_tets = (t8_linearidx_t) 1 << (T8_DTET_DIM * level);
+  t8_dtet_t tet, ancestor, check;
+
+  /* Iterate over a subset of the tetrahedra of the uniform refinement */
+  for (t8_linearidx_t id = 0; id < num_tets; id += 97) {
+    t8_dtet_init_linear_id (&tet, id, level);
+    for (int start_level = 1; start_level <= level; start_level++) {
+      const t8_linearidx_t num_subtree_tets = (t8_linearidx_t) 1 << (T8_DTET_DIM * (level - start_level + 1));
+      t8_dtet_type_t parenttype;
+      const t8_linearidx_t subtree_id = t8_dtet_linear_id_with_level (&tet, level, start_level, &parenttype);
+      EXPECT_EQ (subtree_id, id % num_subtree_tets);
+      t8_dtet_ancestor (&tet, start_level - 1, &ancestor);
+      EXPECT_EQ (parenttype, ancestor.type);
+
+      /* Initialize the tetrahedron from its id in the subtree, starting at the first child of the ancestor */
+      t8_dtet_child (&ancestor, 0, &check);
+      t8_dtet_init_linear_id_with_level (&check, subtree_id, start_level, level, parenttype);
+      EXPECT_TRUE (t8_dtet_is_equal (&check, &tet)) << "id " << id << " start level " << start_level;
+    }
+  }
+}